@@ -17,6 +17,8 @@
 //  History:
 //  2024-04-10  1.0  new
 //  2024-05-13  1.1  support H/W rev.A with -DREV_A
+//  2026-10-15  1.2  add vendor request VR_CH_MASK for RF channel mask and
+//                   on-device packing of samples of enabled channels
 //
 #include <stdio.h>
 #include <stdint.h>
@@ -31,7 +33,7 @@
 #include "gpif_conf.h"
 
 // constants and macros --------------------------------------------------------
-#define VER_FW       0x30       // Firmware version
+#define VER_FW       0x31       // Firmware version
 #ifndef F_TCXO
 #define F_TCXO       24000      // TCXO frequency (kHz)
 #endif
@@ -72,6 +74,7 @@
 #define VR_EE_WRITE  0x49       // USB vendor request: Write EEPROM
 #define VR_IO_READ   0x4A       // USB vendor request: Read IO port
 #define VR_IO_WRITE  0x4B       // USB vendor request: Write IO port
+#define VR_CH_MASK   0x4C       // USB vendor request: Set RF channel mask
 
 #define EP_BULK_IN   0x86       // Bulk transfer IN end point
 #define APP_STACK    0x0800     // App thread stack size
@@ -88,6 +91,7 @@
 #define HEAD_REG     0xABC00CBA // MAX2771 settings header
 #define MAX_CH       4          // Number of MAX2771 channels
 #define MAX_ADDR     11         // Number of MAX2771 registers
+#define CH_MASK_ALL  0xF        // RF channel mask of all channels
 
 // external variables (pocket_usb_dscr.c) --------------------------------------
 extern const uint8_t CyFxUSB20DeviceDscr[];
@@ -107,6 +111,9 @@ static CyU3PDmaMultiChannel dma_ch; // DMA channel for bulk transfer
 static uint8_t usb_event = 0;       // USB event state
 static uint8_t app_act = 0;         // application active
 static uint8_t bulk_act = 0;        // bulk transfer active
+static uint8_t ch_mask = CH_MASK_ALL; // RF channel mask
+static uint8_t pack_nch = 0;        // number of packed channels (0:no packing)
+static uint8_t pack_sft[2] = {0};   // bit shifts of packed channels
 static uint8_t EP0BUFF[128] __attribute__ ((aligned (32))); // EP0 data buffer
 
 // IO ports definitions
@@ -340,6 +347,69 @@ static int save_settings(void)
     return 1;
 }
 
+// set RF channel mask (1, 2 or all channels enabled) ---------------------------
+static int set_mask(uint8_t mask)
+{
+    uint8_t nch = 0, sft[MAX_CH];
+    
+    for (uint8_t ch = 0; ch < MAX_CH; ch++) {
+        if (mask & (1 << ch)) sft[nch++] = ch * 4;
+    }
+    if (nch != 1 && nch != 2 && nch != MAX_CH) return 0;
+    ch_mask = mask;
+    pack_nch = (nch == MAX_CH) ? 0 : nch;
+    pack_sft[0] = sft[0];
+    pack_sft[1] = nch >= 2 ? sft[1] : 0;
+    return 1;
+}
+
+// pack 2 samples of 2 channels to 2 x 8 bits ----------------------------------
+static inline uint16_t pack2(uint32_t w)
+{
+    uint32_t x = (w >> pack_sft[0]) & 0x000F000F;
+    uint32_t y = (w >> pack_sft[1]) & 0x000F000F;
+    uint32_t z = x | (y << 4);
+    return (uint16_t)((z & 0xFF) | ((z >> 8) & 0xFF00));
+}
+
+// pack 2 samples of 1 channel to 8 bits ---------------------------------------
+static inline uint8_t pack1(uint32_t w)
+{
+    uint32_t x = (w >> pack_sft[0]) & 0x000F000F;
+    return (uint8_t)(x | (x >> 12));
+}
+
+// pack samples of enabled channels in DMA buffer ------------------------------
+//  The 16 bits samples of 4 channels (4 bits x 4) are packed in place to 8 bits
+//  samples of 2 channels (4 bits x 2, as FE 2CH) or to 4 bits samples of 1
+//  channel (the first sample in the lower 4 bits).
+static uint16_t pack_buff(uint8_t *buff, uint16_t count)
+{
+    uint32_t *p = (uint32_t *)buff, *q = (uint32_t *)buff;
+    uint16_t n = count / 4;
+    
+    if (pack_nch == 2) {
+        for (uint16_t i = 0; i + 1 < n; i += 2, p += 2) {
+            *q++ = pack2(p[0]) | ((uint32_t)pack2(p[1]) << 16);
+        }
+        return count / 2;
+    }
+    for (uint16_t i = 0; i + 3 < n; i += 4, p += 4) {
+        *q++ = pack1(p[0]) | ((uint32_t)pack1(p[1]) << 8) |
+            ((uint32_t)pack1(p[2]) << 16) | ((uint32_t)pack1(p[3]) << 24);
+    }
+    return count / 4;
+}
+
+// DMA callback for packing ----------------------------------------------------
+static void dma_cb(CyU3PDmaMultiChannel *ch, CyU3PDmaCbType_t type,
+    CyU3PDmaCBInput_t *input)
+{
+    if (type != CY_U3P_DMA_CB_PROD_EVENT) return;
+    uint16_t count = pack_buff(input->buffer_p.buffer, input->buffer_p.count);
+    CyU3PDmaMultiChannelCommitBuffer(ch, count, 0);
+}
+
 // stop bulk transfer ----------------------------------------------------------
 static int stop_bulk(void)
 {
@@ -382,17 +452,26 @@ static int app_start(void)
     ecfg.burstLen = burst_len;
     if (CyU3PSetEpConfig(EP_BULK_IN, &ecfg)) return 0;
     
-    // generate DMA channel
+    // DMA buffer size (packed data in multiple of packet size)
+    uint16_t size = burst_len * pckt_size, size0 = size;
+    uint8_t ratio = pack_nch ? MAX_CH / pack_nch : 1;
+    while ((size / ratio) % pckt_size) {
+        size *= 2;
+    }
+    // generate DMA channel (manual with CPU packing for channel mask)
     CyU3PDmaMultiChannelConfig_t dcfg = {0};
-    dcfg.size = burst_len * pckt_size;
-    dcfg.count = (speed == CY_U3P_HIGH_SPEED) ? BUFF_COUNT_HS : BUFF_COUNT_SS;
+    dcfg.size = size;
+    dcfg.count = (speed == CY_U3P_HIGH_SPEED) ?
+        BUFF_COUNT_HS * size0 / size : BUFF_COUNT_SS;
     dcfg.validSckCount = 2;
     dcfg.dmaMode = CY_U3P_DMA_MODE_BYTE;
     dcfg.prodSckId[0] = CY_U3P_PIB_SOCKET_0;
     dcfg.prodSckId[1] = CY_U3P_PIB_SOCKET_1;
     dcfg.consSckId[0] = CY_U3P_UIB_SOCKET_CONS_6; // EP 0x86
     dcfg.notification = CY_U3P_DMA_CB_PROD_EVENT;
-    if (CyU3PDmaMultiChannelCreate(&dma_ch, CY_U3P_DMA_TYPE_AUTO_MANY_TO_ONE,
+    dcfg.cb = pack_nch ? dma_cb : NULL;
+    if (CyU3PDmaMultiChannelCreate(&dma_ch, pack_nch ?
+        CY_U3P_DMA_TYPE_MANUAL_MANY_TO_ONE : CY_U3P_DMA_TYPE_AUTO_MANY_TO_ONE,
         &dcfg)) {
         return 0;
     }
@@ -449,7 +528,7 @@ static int set_dev_desc(void)
 // 
 //  USB vendor request      code dir wValue     bytes data
 //
-//  Get device Info         0x40  I  -             6  Device info and status
+//  Get device Info         0x40  I  -             6  Device info and status **
 //  Read MAX2771 register   0x41  I  CH + addr*    4  Register value
 //  Write MAX2771 register  0x42  O  CH + addr*    4  Register value
 //  Start bulk transfer     0x44  O  -             0  -
@@ -460,8 +539,13 @@ static int set_dev_desc(void)
 //  Write EEPROM            0x49  O  address       n  data (n <= 64)
 //  Read IO port            0x4A  I  IO port       1  0:off, 1:on
 //  Write IO port           0x4B  O  IO port       1  0:off, 1:on
+//  Set RF channel mask     0x4C  O  CH mask***    0  -
 //
 //  * bit15-8= MAX2771 CH (0:CH1,1:CH2,...), bit7-0= MAX2771 register address
+//  ** byte 4 = RF channel mask (0: all channels for older firmware)
+//  *** bit3-0= enabled RF channels (bit0:CH1,bit1:CH2,...), 1, 2 or 4 channels
+//      enabled. The samples of the enabled channels are packed as 8 bits x 2
+//      channels or 4 bits x 1 channel per sample.
 //
 static int handle_req(uint8_t req, uint16_t val, uint16_t len)
 {
@@ -475,7 +559,7 @@ static int handle_req(uint8_t req, uint16_t val, uint16_t len)
         EP0BUFF[1] = (uint8_t)((F_TCXO >> 8) & 0xFF);
         EP0BUFF[2] = (uint8_t)(F_TCXO & 0xFF);
         EP0BUFF[3] = stat;
-        EP0BUFF[4] = 0;
+        EP0BUFF[4] = ch_mask;
         EP0BUFF[5] = 0;
         return !CyU3PUsbSendEP0Data(6, EP0BUFF);
     }
@@ -525,6 +609,11 @@ static int handle_req(uint8_t req, uint16_t val, uint16_t len)
         if (CyU3PUsbGetEP0Data(1, EP0BUFF, NULL)) return 0;
         write_iop(val, EP0BUFF[0]);
     }
+    else if (req == VR_CH_MASK) {
+        if (!app_stop()) return 0;
+        int stat = set_mask((uint8_t)val);
+        if (!app_start() || !stat) return 0;
+    }
     else { // unknown request
         return 0;
     }
@@ -7,6 +7,7 @@
 //  History:
 //  2022-07-05  1.0  port pocket_acq.py to C
 //  2022-08-08  1.1  add option -w, modify option -d
+//  2026-10-14  1.2  search signals of multiple PRNs in batch
 //
 #include "pocket_sdr.h"
 
@@ -15,6 +16,7 @@
 #define THRES_CN0 38.0       // threshold to lock (dB-Hz)
 #define ESC_COL   "\033[34m" // ANSI escape color = blue
 #define ESC_RES   "\033[0m"  // ANSI escape reset
+#define MAX_BATCH 16         // max number of PRNs searched in batch
 #define FFTW_WISDOM "../python/fftw_wisdom.txt"
 
 // show usage ------------------------------------------------------------------
@@ -25,47 +27,53 @@ static void show_usage(void)
     exit(0);
 }
 
-// search signal ---------------------------------------------------------------
-int search_sig(const char *sig, int prn, const sdr_buff_t *buff, double fs,
-    double fi, float ref_dop, float max_dop, const int *opt, double *dop,
-    double *coff, float *cn0)
+// search signals of PRNs in batch ---------------------------------------------
+//  The PRNs without code are skipped with stat[i] = 0 and the others of the
+//  batch are searched.
+static int search_sigs(const char *sig, const int *prns, int nprn,
+    const sdr_buff_t *buff, double fs, double fi, float ref_dop, float max_dop,
+    const int *opt, double *dop, double *coff, float *cn0, int *stat)
 {
+    sdr_cpx_t *code_fft[MAX_BATCH];
+    float *P[MAX_BATCH];
     int8_t *code;
-    int len_code;
+    int len_code, idx[MAX_BATCH], n = 0;
     
-    // generate code
-    if (!(code = sdr_gen_code(sig, prn, &len_code))) {
-        return 0;
-    }
-    // shift IF frequency for GLONASS FDMA
-    fi = sdr_shift_freq(sig, prn, fi);
-    
-    // generate code FFT
+    // generate code FFTs
     double T = sdr_code_cyc(sig);
     int N = (int)(fs * T), Nz = opt[2] ? 0 : N;
-    sdr_cpx_t *code_fft = sdr_cpx_malloc(2 * N);
-    sdr_gen_code_fft(code, len_code, T, 0.0, fs, N, Nz, code_fft);
+    for (int i = 0; i < nprn; i++) {
+        code = sdr_gen_code(sig, prns[i], &len_code);
+        if (!(stat[i] = code != NULL)) continue;
+        code_fft[n] = sdr_cpx_malloc(2 * N);
+        sdr_gen_code_fft(code, len_code, T, 0.0, fs, N, Nz, code_fft[n]);
+        idx[n++] = i;
+    }
+    if (n <= 0) return 0;
     
     // doppler search bins
     int len_fds;
     float *fds = sdr_dop_bins(T, ref_dop, max_dop, &len_fds);
     
     // parallel code search and non-coherent integration
-    float *P = (float *)sdr_malloc(sizeof(float) * (N + Nz) * len_fds);
+    for (int i = 0; i < n; i++) {
+        P[i] = (float *)sdr_malloc(sizeof(float) * (N + Nz) * len_fds);
+    }
     for (int i = 0; i < buff->N - 2 * N + 1; i += N) {
-        sdr_search_code(code_fft, T, buff, i, N + Nz, fs, fi, fds, len_fds, P);
+        sdr_search_code_multi((const sdr_cpx_t *const *)code_fft, n, T, buff,
+            i, N + Nz, fs, fi, fds, len_fds, P);
     }
     // max correlation power and C/N0
-    int ix[2] = {0};
-    *cn0 = sdr_corr_max(P, N + Nz, N, len_fds, T, ix);
-    
-    *dop = sdr_fine_dop(P, N + Nz, fds, len_fds, ix);
-    *coff = ix[1] / fs;
-    
-    sdr_cpx_free(code_fft);
+    for (int i = 0; i < n; i++) {
+        int ix[2] = {0}, j = idx[i];
+        cn0[j] = sdr_corr_max(P[i], N + Nz, N, len_fds, T, ix);
+        dop[j] = sdr_fine_dop(P[i], N + Nz, fds, len_fds, ix);
+        coff[j] = ix[1] / fs;
+        sdr_cpx_free(code_fft[i]);
+        sdr_free(P[i]);
+    }
     sdr_free(fds);
-    sdr_free(P);
-    return 1;
+    return n;
 }
 
 //------------------------------------------------------------------------------
@@ -188,18 +196,27 @@ int main(int argc, char **argv)
     }
     uint32_t tick = sdr_get_tick();
     
-    // search signal
-    for (int i = 0; i < nprn; i++) {
-        double dop, coff;
-        float cn0;
+    // search signals in batch of PRNs with same IF frequency
+    for (int i = 0, n; i < nprn; i += n) {
+        double dop[MAX_BATCH], coff[MAX_BATCH];
+        float cn0[MAX_BATCH];
+        int stat[MAX_BATCH];
         
-        if (!search_sig(sig, prns[i], buff, fs, fi, ref_dop, max_dop, opt, &dop,
-                &coff, &cn0)) {
+        // shift IF frequency for GLONASS FDMA
+        double fi_i = sdr_shift_freq(sig, prns[i], fi);
+        for (n = 1; n < MAX_BATCH && i + n < nprn; n++) {
+            if (sdr_shift_freq(sig, prns[i+n], fi) != fi_i) break;
+        }
+        if (!search_sigs(sig, prns + i, n, buff, fs, fi_i, ref_dop, max_dop,
+                opt, dop, coff, cn0, stat)) {
             continue;
         }
-        printf("%sSIG= %-4s, %s= %3d, COFF= %8.5f ms, DOP= %5.0f Hz, C/N0= %4.1f dB-Hz%s\n",
-            (cn0 >= THRES_CN0) ? ESC_COL : "", sig, "PRN", prns[i], coff * 1e3,
-            dop, cn0, (cn0 >= THRES_CN0) ? ESC_RES : "");
+        for (int j = 0; j < n; j++) {
+            if (!stat[j]) continue;
+            printf("%sSIG= %-4s, %s= %3d, COFF= %8.5f ms, DOP= %5.0f Hz, C/N0= %4.1f dB-Hz%s\n",
+                (cn0[j] >= THRES_CN0) ? ESC_COL : "", sig, "PRN", prns[i+j],
+                coff[j] * 1e3, dop[j], cn0[j], (cn0[j] >= THRES_CN0) ? ESC_RES : "");
+        }
         fflush(stdout);
     }
     printf("TIME = %.3f s\n", (sdr_get_tick() - tick) * 1e-3);
@@ -8,6 +8,7 @@
 //  2021-10-20  0.1  new
 //  2022-01-04  1.0  support C++.
 //  2024-06-29  1.1  support API changes of sdr_conf.c
+//  2026-10-15  1.2  add option -mask
 //
 #include "pocket_sdr.h"
 
@@ -17,14 +18,15 @@
 // show usage ------------------------------------------------------------------
 static void show_usage(void)
 {
-    printf("Usage: %s [-s] [-a] [-h] [conf_file]\n", PROG_NAME);
+    printf("Usage: %s [-s] [-a] [-h] [-p bus[,port]] [-mask ch[,...]] "
+        "[conf_file]\n", PROG_NAME);
     exit(0);
 }
 
 //------------------------------------------------------------------------------
 //  Synopsis
 //
-//    pocket_conf [-s] [-a] [-h] [-p bus[,port]] [conf_file]
+//    pocket_conf [-s] [-a] [-h] [-p bus[,port]] [-mask ch[,...]] [conf_file]
 //
 //  Description
 //
@@ -69,6 +71,13 @@ static void show_usage(void)
 //        USB bus and port number of the Pocket SDR FE device. Without the
 //        option, the command selects the device firstly found.
 //
+//    -mask ch[,...]
+//        Enable only the RF channels (1-4) of the Pocket SDR FE 4CH device. The
+//        samples of 1 or 2 enabled RF channels are packed by the device to
+//        reduce USB bandwidth (4 bits or 8 bits per sample). The RF channels
+//        shall be 1, 2 or all 4 channels. The mask is cleared at power-on of
+//        the device. The option is supported by the firmware v3.1 or later.
+//
 //    conf_file
 //        Path of the configuration file. Without the option, the command shows
 //        current register field settings of the Pocket SDR FE device.
@@ -81,7 +90,7 @@ int main(int argc, char **argv)
 {
     sdr_dev_t *dev;
     const char *file = "";
-    int i, bus = -1, port = -1, opt1 = 0, opt2 = 0;
+    int i, bus = -1, port = -1, opt1 = 0, opt2 = 0, mask = 0;
     
     for (i = 1; i < argc; i++) {
         if (!strcmp(argv[i], "-s")) {
@@ -97,6 +106,12 @@ int main(int argc, char **argv)
         else if (!strcmp(argv[i], "-p") && i + 1 < argc) {
             sscanf(argv[++i], "%d,%d", &bus, &port);
         }
+        else if (!strcmp(argv[i], "-mask") && i + 1 < argc) {
+            int chs[SDR_MAX_NPRN], n = sdr_parse_nums(argv[++i], chs);
+            for (int j = 0; j < n; j++) {
+                if (chs[j] >= 1 && chs[j] <= 4) mask |= 1 << (chs[j] - 1);
+            }
+        }
         else if (!strncmp(argv[i], "-", 1)) {
             show_usage();
         }
@@ -107,6 +122,18 @@ int main(int argc, char **argv)
     if (!(dev = sdr_dev_open(bus, port))) {
         return -1;
     }
+    if (mask) {
+        if (!sdr_dev_set_mask(dev, mask)) {
+            fprintf(stderr, "RF channel mask set error: mask=0x%X\n", mask);
+            sdr_dev_close(dev);
+            return -1;
+        }
+        printf("%s RF channel mask is set to 0x%X.\n", SDR_DEV_NAME, mask);
+        if (!*file) {
+            sdr_dev_close(dev);
+            return 0;
+        }
+    }
     if (*file) {
         if (!sdr_conf_write(dev, file, opt1)) {
             sdr_dev_close(dev);
@@ -17,10 +17,21 @@
 //  2024-04-28  1.6  support Pocket SDR FE 4CH
 //  2024-06-29  1.7  support API change in sdr_dev.c
 //  2024-07-02  1.8  support tag file output
+//  2026-10-14  1.9  support API change in sdr_dev.c
+//                   write output files by writer threads with double buffers
+//                   add option -k for packed output, -d for direct I/O
+//                   add option -z for compressed IF data file output
+//  2026-10-15  1.10 reject device with 1 RF channel enabled by mask
+//                   add option -n for network IF data stream
 //
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // for O_DIRECT
+#endif
 #include <signal.h>
-#ifdef WIN32
+#include <errno.h>
 #include <fcntl.h>
+#ifndef WIN32
+#include <unistd.h>
 #endif
 #include "pocket_sdr.h"
 
@@ -29,8 +40,27 @@
 #define DATA_CYC        10      // data capture cycle (ms)
 #define STAT_CYC        50      // status update cycle (ms)
 #define RATE_CYC        1000    // data rate update cycle (ms)
+#define WBUFF_SIZE      (1<<23) // size of output buffer (bytes)
+#define ALIGN_IO        4096    // alignment of direct I/O (bytes)
 #define F2BIT(buff,ch,IQ) (((buff)>>(4*(ch)+2*(IQ)))&3)
 
+// type definitions ------------------------------------------------------------
+typedef struct {                // output file writer type
+    FILE *fp;                   // output file pointer
+    int direct;                 // direct I/O (0:off,1:on)
+    uint8_t *buff[2];           // double output buffers
+    size_t msize[2];            // mapped sizes of output buffers
+    int len[2];                 // data length of output buffers (bytes)
+    int cur;                    // output buffer filled by capture
+    int busy;                   // the other buffer being written (0:no,1:yes)
+    int state;                  // writer state (0:stop,1:run)
+    int err;                    // number of write errors
+    sdr_ifz_t *ifz;             // compressed IF data encoder (NULL: none)
+    pthread_t thread;           // writer thread
+    pthread_mutex_t mtx;        // lock flag
+    pthread_cond_t cond;        // buffer handoff condition
+} writer_t;
+
 // interrupt flag --------------------------------------------------------------
 static volatile uint8_t intr = 0;
 
@@ -44,8 +74,8 @@ static void sig_func(int sig)
 // print usage -----------------------------------------------------------------
 static void print_usage(void)
 {
-    printf("Usage: %s [-t tsec] [-r] [-p bus[,port]] [-c conf_file] [-q]\n"
-        "    [file [file ...]]\n", PROG_NAME);
+    printf("Usage: %s [-t tsec] [-r] [-k] [-d] [-z] [-p bus[,port]]\n"
+        "    [-c conf_file] [-n path] [-q] [file [file ...]]\n", PROG_NAME);
     exit(0);
 }
 
@@ -61,18 +91,20 @@ static void gen_LUT(int8_t LUT[][256])
     }
 }
 
-// write IF data to file -------------------------------------------------------
-static int write_file(int fmt, const uint8_t *buff, int size, int ch, int IQ,
-    FILE *fp)
+// convert IF data of RF channel ----------------------------------------------
+static int conv_data(int fmt, const uint8_t *buff, int size, int ch, int IQ,
+    int pack, uint8_t *out)
 {
     static int8_t LUT[4][256] = {{0}};
+    int8_t *data = (int8_t *)out;
     
-    
+    if (pack) { // packed 4 bits sample codes
+        sdr_pack_raw(buff, size, fmt, ch, out);
+        return size / 2;
+    }
     if (!LUT[0][0]) {
         gen_LUT(LUT);
     }
-    int8_t data[size * IQ];
-    
     if (fmt == SDR_FMT_RAW8) { // packed 8(4x2) bits raw
         int pos = ch * 2;
         for (int i = 0; i < size; i++) {
@@ -103,7 +135,161 @@ static int write_file(int fmt, const uint8_t *buff, int size, int ch, int IQ,
             data[i] = LUT[pos][buff[j]];
         }
     }
-    return (int)fwrite(data, 1, size * IQ, fp);
+    return size * IQ;
+}
+
+// write data to file ----------------------------------------------------------
+static int write_file(writer_t *w, const uint8_t *data, int len)
+{
+#ifdef WIN32
+    return (int)fwrite(data, 1, len, w->fp) == len;
+#else
+    int fd = fileno(w->fp);
+#ifdef O_DIRECT
+    if (w->direct && len % ALIGN_IO) { // unaligned tail without direct I/O
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_DIRECT);
+        w->direct = 0;
+    }
+#endif
+    for (int n; len > 0; data += n, len -= n) {
+        if ((n = (int)write(fd, data, len)) < 0) {
+            if (errno != EINTR) return 0;
+            n = 0;
+        }
+    }
+    return 1;
+#endif
+}
+
+// output compressed IF data to file -------------------------------------------
+static int write_ifz(void *arg, const uint8_t *data, int len)
+{
+    writer_t *w = (writer_t *)arg;
+    
+    if (!write_file(w, data, len)) {
+        w->err++;
+        return 0;
+    }
+    return len;
+}
+
+// write output buffer to file -------------------------------------------------
+static int write_data(writer_t *w, const uint8_t *data, int len)
+{
+    if (w->ifz) { // compressed by writer thread
+        return sdr_ifz_write(w->ifz, data, len) == len;
+    }
+    return write_file(w, data, len);
+}
+
+// output file writer thread ---------------------------------------------------
+static void *writer_thread(void *arg)
+{
+    writer_t *w = (writer_t *)arg;
+    
+    pthread_mutex_lock(&w->mtx);
+    while (1) {
+        while (w->state && !w->busy) {
+            pthread_cond_wait(&w->cond, &w->mtx);
+        }
+        if (!w->busy) break;
+        int i = w->cur ^ 1;
+        pthread_mutex_unlock(&w->mtx);
+        
+        if (!write_data(w, w->buff[i], w->len[i])) {
+            w->err++;
+        }
+        pthread_mutex_lock(&w->mtx);
+        w->busy = 0;
+        pthread_cond_broadcast(&w->cond);
+    }
+    pthread_mutex_unlock(&w->mtx);
+    return NULL;
+}
+
+// hand off filled output buffer to writer -------------------------------------
+//  For direct I/O, the unaligned tail of the buffer is carried over to the next
+//  buffer to keep the file offset aligned except for the last write.
+static void writer_flush(writer_t *w, int last)
+{
+    pthread_mutex_lock(&w->mtx);
+    while (w->busy) { // wait for the other buffer written
+        pthread_cond_wait(&w->cond, &w->mtx);
+    }
+    int tail = (w->direct && !last) ? w->len[w->cur] % ALIGN_IO : 0;
+    w->len[w->cur] -= tail;
+    memcpy(w->buff[w->cur ^ 1], w->buff[w->cur] + w->len[w->cur], tail);
+    w->busy = 1;
+    w->cur ^= 1;
+    w->len[w->cur] = tail;
+    pthread_cond_broadcast(&w->cond);
+    pthread_mutex_unlock(&w->mtx);
+}
+
+// get output buffer area to write ---------------------------------------------
+static uint8_t *writer_buff(writer_t *w, int size)
+{
+    if (w->len[w->cur] + size > WBUFF_SIZE) {
+        writer_flush(w, 0);
+    }
+    return w->buff[w->cur] + w->len[w->cur];
+}
+
+// open output file writer -----------------------------------------------------
+//  If tag is not NULL, the output file is written as a compressed IF data file
+//  with the tag, the IF data format and the chunk size.
+static writer_t *writer_open(FILE *fp, int direct, const char *tag, int fmt,
+    int chunk)
+{
+    writer_t *w = (writer_t *)sdr_malloc(sizeof(writer_t));
+    
+    w->fp = fp;
+    if (tag) {
+        w->ifz = sdr_ifz_new(tag, fmt, chunk, write_ifz, w);
+        direct = 0;
+    }
+    for (int i = 0; i < 2; i++) { // page-aligned buffers for direct I/O
+        w->buff[i] = (uint8_t *)sdr_malloc_huge(WBUFF_SIZE, 1, -1,
+            w->msize + i);
+    }
+#if !defined(WIN32) && defined(O_DIRECT)
+    int fd = fileno(fp);
+    if (direct && fp != stdout) {
+        w->direct = !fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_DIRECT);
+        if (!w->direct) {
+            fprintf(stderr, "direct I/O not supported. buffered I/O used\n");
+        }
+    }
+#endif
+    w->state = 1;
+    pthread_mutex_init(&w->mtx, NULL);
+    pthread_cond_init(&w->cond, NULL);
+    pthread_create(&w->thread, NULL, writer_thread, w);
+    return w;
+}
+
+// close output file writer ----------------------------------------------------
+static int writer_close(writer_t *w)
+{
+    writer_flush(w, 1);
+    pthread_mutex_lock(&w->mtx);
+    w->state = 0;
+    pthread_cond_broadcast(&w->cond);
+    pthread_mutex_unlock(&w->mtx);
+    pthread_join(w->thread, NULL);
+    sdr_ifz_free(w->ifz);
+    
+    int err = w->err;
+    if (err) {
+        fprintf(stderr, "file write error (%d)\n", err);
+    }
+    for (int i = 0; i < 2; i++) {
+        sdr_free_huge(w->buff[i], w->msize[i]);
+    }
+    pthread_cond_destroy(&w->cond);
+    pthread_mutex_destroy(&w->mtx);
+    sdr_free(w);
+    return !err;
 }
 
 // print header ----------------------------------------------------------------
@@ -131,36 +317,77 @@ static void print_stat(int nch, const int *IQ, FILE **fp, double time,
     fflush(stderr);
 }
 
+// IF data format of output file -----------------------------------------------
+static int file_fmt(int raw, int pack, int fmt, int IQ)
+{
+    if (raw) return fmt;
+    return pack ? SDR_FMT_PACK : (IQ == 1 ? SDR_FMT_INT8 : SDR_FMT_INT8X2);
+}
+
+// generate tags of output files -----------------------------------------------
+static void gen_tags(time_t time, int raw, int pack, int fmt, double fs,
+    const double *fo, const int *IQ, int nfile, char tags[][SDR_MAX_TAG])
+{
+    for (int i = 0; i < nfile; i++) {
+        if (raw) {
+            int nch = fmt == SDR_FMT_RAW8 ? 2 : (fmt == SDR_FMT_RAW16 ? 4 : 8);
+            sdr_rcv_gen_tag(tags[i], SDR_MAX_TAG, PROG_NAME, time, fmt, fs, fo,
+                IQ, nch);
+        }
+        else {
+            sdr_rcv_gen_tag(tags[i], SDR_MAX_TAG, PROG_NAME, time,
+                file_fmt(raw, pack, fmt, IQ[i]), fs, fo + i, IQ + i, 1);
+        }
+    }
+}
+
 // dump digital IF data --------------------------------------------------------
-static void dump_data(sdr_dev_t *dev, double tsec, int quiet, int raw, int fmt,
-    int nfile, const int *IQ, FILE **fp)
+//  The IF data are converted to the output buffers of the files by the capture
+//  thread and written to the files by the writer threads, so the capture is not
+//  blocked by the latency of the file writes. The raw IF data are also sent to
+//  the network IF data stream if opened.
+static void dump_data(sdr_dev_t *dev, double tsec, int quiet, int raw, int pack,
+    int direct, int comp, int fmt, double fs, int nfile, const int *IQ,
+    char tags[][SDR_MAX_TAG], FILE **fp, sdr_net_t *net)
 {
+    writer_t *w[SDR_MAX_RFCH] = {0};
     double time = 0.0, time_p = 0.0, sample = 0.0, sample_p = 0.0;
     double rate = 0.0, byte[SDR_MAX_RFCH] = {0};
     int ns = (fmt == SDR_FMT_RAW8) ? 1 : 2;
-    uint8_t buff[SDR_SIZE_BUFF * ns];
+    uint8_t *buff = (uint8_t *)sdr_malloc(SDR_SIZE_BUFF * ns);
     
     if (!quiet) {
         print_head(nfile, fp);
     }
     uint32_t tick = sdr_get_tick();
     
-    if (!sdr_dev_start(dev)) return;
+    for (int j = 0; j < nfile; j++) {
+        if (!fp[j]) continue;
+        double bps = raw ? ns : (pack ? 0.5 : IQ[j]); // bytes per sample
+        w[j] = writer_open(fp[j], direct, comp ? tags[j] : NULL,
+            file_fmt(raw, pack, fmt, IQ[j]), (int)(SDR_IFZ_CHUNK * fs * bps));
+    }
+    int stat = sdr_dev_start(dev, SDR_MAX_BUFF, SDR_SIZE_BUFF);
     
-    for (int i = 0; !intr && (tsec <= 0.0 || time < tsec); i++) {
+    for (int i = 0; stat && !intr && (tsec <= 0.0 || time < tsec); i++) {
         if (!quiet) {
             time = (sdr_get_tick() - tick) * 1e-3;
         }
         while (sdr_dev_read(dev, buff, SDR_SIZE_BUFF * ns) && !intr) {
+            sdr_net_write(net, buff, SDR_SIZE_BUFF * ns);
             for (int j = 0; j < nfile; j++) {
-                if (!fp[j]) continue;
+                if (!w[j]) continue;
+                uint8_t *out = writer_buff(w[j], SDR_SIZE_BUFF * 2);
+                int len = SDR_SIZE_BUFF * ns;
                 if (raw) {
-                    byte[j] += fwrite(buff, 1, SDR_SIZE_BUFF * ns, fp[j]);
+                    memcpy(out, buff, len);
                 }
                 else {
-                    byte[j] += write_file(fmt, buff, SDR_SIZE_BUFF, j, IQ[j],
-                        fp[j]);
+                    len = conv_data(fmt, buff, SDR_SIZE_BUFF, j, IQ[j], pack,
+                        out);
                 }
+                w[j]->len[w[j]->cur] += len;
+                byte[j] += len;
             }
             sample += SDR_SIZE_BUFF;
         }
@@ -176,75 +403,62 @@ static void dump_data(sdr_dev_t *dev, double tsec, int quiet, int raw, int fmt,
     }
     sdr_dev_stop(dev);
     
+    for (int j = 0; j < nfile; j++) {
+        if (w[j]) writer_close(w[j]);
+    }
+    sdr_free(buff);
+    
     if (!quiet) {
+        int64_t nerr = 0, nover = 0, ndrop = 0;
         rate = time > 0.0 ? sample / time : 0.0;
         print_stat(nfile, IQ, fp, time, byte, rate);
         fprintf(stderr, "\n");
+        sdr_dev_get_stat(dev, &nerr, &nover, &ndrop);
+        if (nerr || nover || ndrop) {
+            fprintf(stderr, "USB transfer errors: %lld, overruns: %lld, "
+                "dropped: %lld bytes\n", (long long)nerr, (long long)nover,
+                (long long)ndrop);
+        }
+        if (net) {
+            int64_t stat[4];
+            sdr_net_stat(net, stat);
+            fprintf(stderr, "net stream: %lld packets sent\n",
+                (long long)stat[0]);
+        }
     }
 }
 
 // write tag for IF data dump file ---------------------------------------------
-static int write_tag(const char *file, const char *prog, time_t time, int fmt,
-    double fs, const double *fo, const int *IQ)
+static int write_tag(const char *file, const char *tag)
 {
-    static const char *fstr[] = {
-        "-", "INT8", "INT8X2", "RAW8", "RAW16", "RAW16I"
-    };
     FILE *fp;
-    char path[1024+4], tstr[32];
+    char path[1024+4];
     
     snprintf(path, sizeof(path), "%s.tag", file);
-    strftime(tstr, sizeof(tstr), "%Y-%m-%dT%H:%M:%SZ", gmtime(&time));
     
     if (!(fp = fopen(path, "w"))) {
         fprintf(stderr, "tag file open error %s\n", path);
         return 0;
     }
-    fprintf(fp, "PROG = %s\n", prog);
-    fprintf(fp, "TIME = %s\n", tstr);
-    fprintf(fp, "FMT  = %s\n", fstr[fmt]);
-    fprintf(fp, "F_S  = %.6g\n", fs * 1e-6);
-    if (fmt >= SDR_FMT_RAW8) {
-        int nch = fmt == SDR_FMT_RAW8 ? 2 : (fmt == SDR_FMT_RAW16 ? 4 : 8);
-        fprintf(fp, "F_LO = ");
-        for (int j = 0; j < nch; j++) {
-            fprintf(fp, "%.6g%s", fo[j] * 1e-6, j < nch - 1 ? "," : "\n");
-        }
-        fprintf(fp, "IQ   = ");
-        for (int j = 0; j < nch; j++) {
-            fprintf(fp, "%d%s", IQ[j], j < nch - 1 ? "," : "\n");
-        }
-    }
-    else {
-        fprintf(fp, "F_LO = %.6g\n", fo[0] * 1e-6);
-        fprintf(fp, "IQ   = %d\n", IQ[0]);
-    }
+    fputs(tag, fp);
     fclose(fp);
     return 1;
 }
 
 // write tag file --------------------------------------------------------------
-static void write_tag_files(time_t time, int raw, int fmt, double fs,
-    const double *fo, const int *IQ, int nch, char **files)
+static void write_tag_files(int nfile, char tags[][SDR_MAX_TAG], char **files)
 {
-    for (int i = 0; i < (raw ? 1 : nch); i++) {
+    for (int i = 0; i < nfile; i++) {
         if (!files[i] || !*files[i] || !strcmp(files[i], "-")) continue;
-        
-        if (raw) {
-            write_tag(files[i], PROG_NAME, time, fmt, fs, fo, IQ);
-        }
-        else {
-            int fmt_i = IQ[i] == 1 ? SDR_FMT_INT8 : SDR_FMT_INT8X2;
-            write_tag(files[i], PROG_NAME, time, fmt_i, fs, fo + i, IQ + i);
-        }
+        write_tag(files[i], tags[i]);
     }
 }
 
 //------------------------------------------------------------------------------
 //  Synopsis
 //
-//    pocket_dump [-t tsec] [-r] [-p bus[,port]] [-c conf_file] [-q]
-//                [file [file ...]]
+//    pocket_dump [-t tsec] [-r] [-k] [-d] [-z] [-p bus[,port]] [-c conf_file]
+//                [-n path] [-q] [file [file ...]]
 //
 //  Description
 //
@@ -259,6 +473,23 @@ static void write_tag_files(time_t time, int raw, int fmt, double fs,
 //        Dump raw data of the Pocket SDR FE device without channel separation
 //        and quantization.
 //
+//    -k
+//        Dump IF data of each channel as packed 4 bits sample codes (2 bits I
+//        and 2 bits Q, 2 samples per byte) instead of int8 or interleaved
+//        int8. The tag files are written with FMT = PACK, which can be read
+//        by pocket_trk.
+//
+//    -d
+//        Write output files by direct I/O (O_DIRECT) bypassing the page cache
+//        (Linux only). If not supported by the file system, buffered I/O is
+//        used.
+//
+//    -z
+//        Write output files as compressed IF data files. The IF data are
+//        losslessly compressed by chunks of 100 ms with the tag and a seek
+//        index in the file. The files can be read by pocket_trk, pocket_acq
+//        and pocket_snap as same as the uncompressed files. -d is ignored.
+//
 //    -p bus[,port]
 //        USB bus and port number of the Pocket SDR FE device. Without the
 //        option, the command selects the device firstly found.
@@ -267,6 +498,14 @@ static void write_tag_files(time_t time, int raw, int fmt, double fs,
 //        Configure the Pocket SDR FE device with a device configuration file
 //        before capturing.
 //
+//    -n path
+//        Send the raw data of the device to a network IF data stream as a
+//        capture node. The path should be tcp://:port (TCP server for multiple
+//        compute nodes), udp://address:port (UDP) or shm://name (shared
+//        memory). The tag of the raw data is sent in the stream, so the
+//        compute nodes (pocket_trk -net) are configured by the tag. Without
+//        output file paths, no file is written.
+//
 //    -q 
 //        Suppress showing data dump status.
 //
@@ -288,11 +527,14 @@ int main(int argc, char **argv)
     FILE *fp[SDR_MAX_RFCH] = {0};
     sdr_dev_t *dev;
     char *files[SDR_MAX_RFCH] = {0}, path[SDR_MAX_RFCH][64];
-    const char *conf_file = "";
+    const char *conf_file = "", *net_path = "";
+    sdr_net_t *net = NULL;
     time_t dump_time;
     double tsec = 0.0, fs, fo[SDR_MAX_RFCH];
-    int n = 0, bus = -1, port = -1, raw = 0, quiet = 0;
+    int n = 0, bus = -1, port = -1, raw = 0, pack = 0, direct = 0, comp = 0;
+    int quiet = 0;
     int nch, fmt, IQ[SDR_MAX_RFCH], nfile;
+    char tags[SDR_MAX_RFCH][SDR_MAX_TAG];
     
     for (int i = 1; i < argc; i++) {
         if (!strcmp(argv[i], "-t") && i + 1 < argc) {
@@ -301,12 +543,24 @@ int main(int argc, char **argv)
         else if (!strcmp(argv[i], "-r")) {
             raw = 1; // raw output
         }
+        else if (!strcmp(argv[i], "-k")) {
+            pack = 1; // packed output
+        }
+        else if (!strcmp(argv[i], "-d")) {
+            direct = 1; // direct I/O
+        }
+        else if (!strcmp(argv[i], "-z")) {
+            comp = 1; // compressed IF data file
+        }
         else if (!strcmp(argv[i], "-p") && i + 1 < argc) {
             sscanf(argv[++i], "%d,%d", &bus, &port);
         }
         else if (!strcmp(argv[i], "-c") && i + 1 < argc) {
             conf_file = argv[++i];
         }
+        else if (!strcmp(argv[i], "-n") && i + 1 < argc) {
+            net_path = argv[++i];
+        }
         else if (!strcmp(argv[i], "-q")) {
             quiet = 1;
         }
@@ -331,10 +585,15 @@ int main(int argc, char **argv)
         sdr_dev_close(dev);
         return -1;
     }
+    if (fmt == SDR_FMT_PACK) { // 1 RF channel enabled by mask
+        fprintf(stderr, "unsupported IF data format: fmt=%d\n", fmt);
+        sdr_dev_close(dev);
+        return -1;
+    }
     nfile = raw ? 1 : nch;
     dump_time = time(NULL);
     
-    if (n == 0) { // set default file paths
+    if (n == 0 && !*net_path) { // set default file paths
         for (int i = 0; i < nfile; i++) {
             char *p = path[i];
             p += sprintf(p, "ch%d_", i + 1);
@@ -358,15 +617,29 @@ int main(int argc, char **argv)
     }
     signal(SIGTERM, sig_func);
     signal(SIGINT, sig_func);
+#ifndef WIN32
+    signal(SIGPIPE, SIG_IGN);
+#endif
+    gen_tags(dump_time, raw, pack, fmt, fs, fo, IQ, nfile, tags);
     
-    dump_data(dev, tsec, quiet, raw, fmt, nfile, IQ, fp);
+    if (*net_path) { // network IF data stream of raw data
+        char tag[SDR_MAX_TAG];
+        gen_tags(dump_time, 1, 0, fmt, fs, fo, IQ, 1, &tag);
+        if (!(net = sdr_net_open(net_path, 0, tag, 0))) {
+            sdr_dev_close(dev);
+            return -1;
+        }
+    }
+    dump_data(dev, tsec, quiet, raw, pack, direct, comp, fmt, fs, nfile, IQ,
+        tags, fp, net);
     
+    sdr_net_close(net);
     for (int i = 0; i < nfile; i++) {
         if (fp[i]) fclose(fp[i]);
     }
     sdr_dev_close(dev);
     
-    write_tag_files(dump_time, raw, fmt, fs, fo, IQ, nch, files);
+    write_tag_files(nfile, tags, files);
     
     return 0;
 }
@@ -8,7 +8,12 @@
 //  2022-08-04  1.0  port pocket_snap.py to C
 //  2024-02-24  1.1  QZSS signal: L1CP -> L1CA
 //                   mask health for QZSS L6
+//  2026-10-14  1.2  search signals without Doppler assist in batch of PRNs
+//  2026-10-15  1.3  add option -cache
+//                   search signals in parallel by threads, add option -th
+//                   add server mode, add options -dir, -port and -job
 //
+#include <sys/stat.h>
 #include "pocket_sdr.h"
 
 // constants --------------------------------------------------------------------
@@ -17,10 +22,19 @@
 #define MAX_DOP    5000.0  // max Doppler freq. to search signal (Hz)
 #define MAX_DFREQ  500.0   // max freq. offset of ref oscillator (Hz)
 #define MAX_SAT    256     // max number of satellites
+#define MAX_BATCH  16      // max number of PRNs searched in batch
+#define MAX_PMEM   (1 << 28) // max memory of correlation powers per batch (bytes)
+#define MAX_TH     64      // max number of signal search threads
+#define MAX_JOB    256     // max number of jobs in queue
+#define MAX_FILE   1024    // max number of files scanned in directory
+#define SCAN_INT   1000    // directory scan interval (ms)
+#define FILE_AGE   2       // min age of file to be a job (s)
 
 #define FFTW_WISDOM "../python/fftw_wisdom.txt"
 
 #define ROUND(x)   floor(x + 0.5)
+#define MIN(x, y)  ((x) < (y) ? (x) : (y))
+#define MAX(x, y)  ((x) > (y) ? (x) : (y))
 
 // function prototype in rtklib_wrap.c ------------------------------------------
 #ifdef __cplusplus
@@ -40,16 +54,66 @@ typedef struct {           // satellite data type
     double coff;           // code offset (s)
 } data_t;
 
+typedef struct {           // signal search task type
+    const char *sig;       // signal ID
+    int sys;               // navigation system
+    int prns[MAX_BATCH];   // PRNs searched in batch
+    double rrates[MAX_BATCH]; // range rates for Doppler assist (0: no assist)
+    int nprn;              // number of PRNs
+    double cost;           // cost of search
+    data_t data[MAX_BATCH]; // satellite data of signals found
+    int nsig;              // number of signals found
+} task_t;
+
+typedef struct {           // signal search tasks type
+    task_t *task;          // signal search tasks
+    int *order;            // order of tasks to search
+    int ntask, next;       // number of tasks and next task to search
+    const sdr_buff_t *dif; // digital IF data
+    double fs, fi;         // sampling and IF frequency (Hz)
+    pthread_mutex_t mtx;   // lock flag
+} tasks_t;
+
+typedef struct {           // snapshot positioning options type
+    gtime_t ts;            // captured start time (0: parsed by file path)
+    double ti, toff;       // time interval and offset (s)
+    double fs, fi;         // sampling and IF frequency (Hz)
+    double tint;           // integration time (s)
+    double rr[3];          // coarse receiver position (ECEF) (m)
+    int ssys;              // navigation systems
+} snapopt_t;
+
+typedef void (*out_func_t)(void *arg, const char *str); // solution output
+
+typedef struct {           // snapshot job server type
+    const snapopt_t *opt;  // positioning options
+    const nav_t *nav;      // navigation data
+    FILE *fp;              // output solution file
+    stream_t str;          // job stream (TCP server)
+    int port;              // job stream port (0: no stream)
+    char buff[1024];       // job stream buffer
+    int nb;                // size of job stream buffer
+    char (*jobs)[1024];    // job queue (IF data files)
+    int head, tail;        // head and tail of job queue
+    char **done;           // files queued in directory
+    int ndone, nmax;       // number and capacity of files queued
+    pthread_mutex_t mtx;   // lock flag
+    pthread_cond_t cond;   // condition variable
+} server_t;
+
 // global variables -------------------------------------------------------------
 static sdr_cpx_t *code_fft[MAX_SAT] = {NULL}; // code FFT caches
+static pthread_mutex_t code_fft_mtx = PTHREAD_MUTEX_INITIALIZER;
 static int VERP = 0;       // verpose display flag
+static int NTH = 0;        // number of signal search threads (0: auto)
 
 // show usage -------------------------------------------------------------------
 static void show_usage(void)
 {
     printf("Usage: pocket_snap.py [-ts time] [-pos lat,lon,hgt] [-ti sec] [-toff toff]\n");
     printf("       [-f freq] [-fi freq] [-tint tint] [-sys sys[,...]] [-v] [-w file]\n");
-    printf("       -nav file [-out file] file\n");
+    printf("       [-cache file] [-th nth] [-dir path] [-port port] [-job njob]\n");
+    printf("       -nav file [-out file] [file]\n");
     exit(0);
 }
 
@@ -112,39 +176,45 @@ static double fine_coff(const char *sig, double fs, const float *P, int N,
     return coff + (L - E) / (L + E) * (T / 2.0 - 1.0 / fs);
 }
 
-// search signal ----------------------------------------------------------------
-static int search_sig(data_t *data, const char *sig, int sys, int prn,
-    const sdr_buff_t *dif, double fs, double fi, double rrate)
+// generate code FFT ------------------------------------------------------------
+//  The code FFTs are generated by the search threads in parallel and cached.
+//
+static const sdr_cpx_t *gen_code_fft(const char *sig, int sat, int prn,
+    double fs)
 {
-    int sat = satno(sys, prn);
     double T = sdr_code_cyc(sig);
     int N = (int)(fs * T), len_code;
     
-    // generate code FFT
+    pthread_mutex_lock(&code_fft_mtx);
+    sdr_cpx_t *fft = code_fft[sat-1];
+    pthread_mutex_unlock(&code_fft_mtx);
+    if (fft) return fft;
+    
+    const sdr_cpx_t *cache = sdr_code_cache_get(sig, prn, fs, N, N);
+    if (cache) return cache;
+    
+    int8_t *code = sdr_gen_code(sig, prn, &len_code);
+    fft = sdr_cpx_malloc(2 * N);
+    sdr_gen_code_fft(code, len_code, T, 0.0, fs, N, N, fft);
+    
+    pthread_mutex_lock(&code_fft_mtx);
     if (!code_fft[sat-1]) {
-        int8_t *code = sdr_gen_code(sig, prn, &len_code);
-        code_fft[sat-1] = sdr_cpx_malloc(2 * N);
-        sdr_gen_code_fft(code, len_code, T, 0.0, fs, N, N, code_fft[sat-1]);
-    }
-    // doppler search bins
-    float *fds;
-    int len_fds;
-    if (rrate == 0.0) {
-        fds = sdr_dop_bins(T, 0.0, MAX_DOP, &len_fds);
+        code_fft[sat-1] = fft;
     }
     else {
-        float dop = -rrate / CLIGHT * sdr_sig_freq(sig);
-        fds = sdr_dop_bins(T, dop, MAX_DFREQ, &len_fds);
+        sdr_cpx_free(fft);
+        fft = code_fft[sat-1];
     }
-    // parallel code search
-    float *P = (float *)sdr_malloc(sizeof(float) * 2 * N * len_fds);
-    
-    for (int i = 0; i < dif->N - 2 * N + 1; i += N) {
-        sdr_search_code(code_fft[sat-1], T, dif, i, 2 * N, fs, fi, fds, len_fds,
-            P);
-    }
-    // max correlation power
-    int ix[2] = {0};
+    pthread_mutex_unlock(&code_fft_mtx);
+    return fft;
+}
+
+// evaluate max correlation power -----------------------------------------------
+static int eval_corr(data_t *data, const char *sig, int sat, const float *P,
+    const float *fds, int len_fds, double fs)
+{
+    double T = sdr_code_cyc(sig);
+    int N = (int)(fs * T), ix[2] = {0};
     float cn0 = sdr_corr_max(P, 2 * N, N, len_fds, T, ix);
     if (cn0 >= THRES_CN0) {
         double dop, rrate, coff;
@@ -162,59 +232,172 @@ static int search_sig(data_t *data, const char *sig, int sys, int prn,
         data->rrate = rrate;
         data->coff = coff;
     }
-    sdr_free(fds);
-    sdr_free(P);
     return cn0 >= THRES_CN0;
 }
 
+// search signal of PRNs in task ------------------------------------------------
+static void search_task(task_t *task, const sdr_buff_t *dif, double fs,
+    double fi)
+{
+    const sdr_cpx_t *codes[MAX_BATCH];
+    float *P[MAX_BATCH];
+    const char *sig = task->sig;
+    double T = sdr_code_cyc(sig);
+    int N = (int)(fs * T), n = task->nprn;
+    
+    // doppler search bins
+    float *fds;
+    int len_fds;
+    if (task->rrates[0] == 0.0) {
+        fds = sdr_dop_bins(T, 0.0, MAX_DOP, &len_fds);
+    }
+    else {
+        float dop = -task->rrates[0] / CLIGHT * sdr_sig_freq(sig);
+        fds = sdr_dop_bins(T, dop, MAX_DFREQ, &len_fds);
+    }
+    // parallel code search
+    for (int j = 0; j < n; j++) {
+        codes[j] = gen_code_fft(sig, satno(task->sys, task->prns[j]),
+            task->prns[j], fs);
+        P[j] = (float *)sdr_malloc(sizeof(float) * 2 * N * len_fds);
+    }
+    for (int j = 0; j < dif->N - 2 * N + 1; j += N) {
+        sdr_search_code_multi(codes, n, T, dif, j, 2 * N, fs, fi, fds,
+            len_fds, P);
+    }
+    // max correlation power
+    task->nsig = 0;
+    for (int j = 0; j < n; j++) {
+        task->nsig += eval_corr(task->data + task->nsig, sig,
+            satno(task->sys, task->prns[j]), P[j], fds, len_fds, fs);
+        sdr_free(P[j]);
+    }
+    sdr_free(fds);
+}
+
+// add signal search tasks of PRNs ----------------------------------------------
+static int add_tasks(task_t *task, const char *sig, int sys, const int *prns,
+    const double *rrates, int nprn, double fs)
+{
+    double T = sdr_code_cyc(sig);
+    int N = (int)(fs * T), ntask = 0, len_fds;
+    
+    // max number of PRNs without Doppler assist in batch
+    sdr_free(sdr_dop_bins(T, 0.0, MAX_DOP, &len_fds));
+    double size = sizeof(float) * 2.0 * N * len_fds;
+    int nmax = (int)MAX(1.0, MIN(MAX_BATCH, MAX_PMEM / size));
+    
+    for (int i = 0, n; i < nprn; i += n, ntask++) {
+        
+        // PRNs without Doppler assist searched in batch with same bins
+        for (n = 1; rrates[i] == 0.0 && n < nmax && i + n < nprn; n++) {
+            if (rrates[i+n] != 0.0) break;
+        }
+        task[ntask].sig = sig;
+        task[ntask].sys = sys;
+        for (int j = 0; j < n; j++) {
+            task[ntask].prns[j] = prns[i+j];
+            task[ntask].rrates[j] = rrates[i+j];
+        }
+        task[ntask].nprn = n;
+        task[ntask].cost = (double)N * n * (rrates[i] == 0.0 ? len_fds : 1);
+        task[ntask].nsig = 0;
+    }
+    return ntask;
+}
+
+// signal search thread ---------------------------------------------------------
+static void *search_thread(void *arg)
+{
+    tasks_t *tasks = (tasks_t *)arg;
+    
+    while (1) {
+        pthread_mutex_lock(&tasks->mtx);
+        int i = tasks->next++;
+        pthread_mutex_unlock(&tasks->mtx);
+        if (i >= tasks->ntask) break;
+        search_task(tasks->task + tasks->order[i], tasks->dif, tasks->fs,
+            tasks->fi);
+    }
+    return NULL;
+}
+
 // search signals ---------------------------------------------------------------
+//  The signals are searched by tasks of PRNs in batch. The tasks are searched
+//  by the threads in descending order of the cost and the results are output
+//  in the order of the signals and PRNs.
+//
 static int search_sigs(gtime_t time, int ssys, const sdr_buff_t *dif, double fs,
     double fi, const double *rr, const nav_t *nav, data_t *data)
 {
+    static const struct {
+        int sys, prn1, prn2;
+        const char *sig;
+    } sigs[] = {
+        {SYS_GPS,   1,  32, "L1CA"},
+        {SYS_GAL,   1,  36, "E1C" },
+        {SYS_CMP,  19,  46, "B1CP"},
+        {SYS_QZS, 193, 199, "L1CA"}
+    };
+    pthread_t thread[MAX_TH];
+    tasks_t tasks;
+    
     if (VERP) {
         printf("search_sigs\n");
     }
-    int n = 0;
-    if (ssys & SYS_GPS) {
-        for (int prn = 1; prn <= 32; prn++) {
+    memset(&tasks, 0, sizeof(tasks));
+    tasks.task = (task_t *)sdr_malloc(sizeof(task_t) * MAX_SAT);
+    tasks.order = (int *)sdr_malloc(sizeof(int) * MAX_SAT);
+    tasks.dif = dif;
+    tasks.fs = fs;
+    tasks.fi = fi;
+    pthread_mutex_init(&tasks.mtx, NULL);
+    
+    for (int i = 0; i < (int)(sizeof(sigs) / sizeof(sigs[0])); i++) {
+        int prns[MAX_SAT], nprn = 0;
+        double rrates[MAX_SAT];
+        if (!(ssys & sigs[i].sys)) continue;
+        for (int prn = sigs[i].prn1; prn <= sigs[i].prn2; prn++) {
             double el, rrate = 0.0;
-            el = sel_sat(time, SYS_GPS, prn, rr, nav, &rrate);
+            el = sel_sat(time, sigs[i].sys, prn, rr, nav, &rrate);
             if (el >= EL_MASK * D2R) {
-                n += search_sig(data + n, "L1CA", SYS_GPS, prn, dif, fs, fi,
-                    rrate);
+                prns[nprn] = prn;
+                rrates[nprn++] = rrate;
             }
         }
+        tasks.ntask += add_tasks(tasks.task + tasks.ntask, sigs[i].sig,
+            sigs[i].sys, prns, rrates, nprn, fs);
     }
-    if (ssys & SYS_GAL) {
-        for (int prn = 1; prn <= 36; prn++) {
-            double el, rrate = 0.0;
-            el = sel_sat(time, SYS_GAL, prn, rr, nav, &rrate);
-            if (el >= EL_MASK * D2R) {
-                n += search_sig(data + n, "E1C", SYS_GAL, prn, dif, fs, fi,
-                    rrate);
-            }
+    // order of tasks by cost (insertion sort)
+    for (int i = 0; i < tasks.ntask; i++) {
+        int j = i;
+        for ( ; j > 0 && tasks.task[tasks.order[j-1]].cost <
+            tasks.task[i].cost; j--) {
+            tasks.order[j] = tasks.order[j-1];
         }
+        tasks.order[j] = i;
     }
-    if (ssys & SYS_CMP) {
-        for (int prn = 19; prn <= 46; prn++) {
-            double el, rrate = 0.0;
-            el = sel_sat(time, SYS_CMP, prn, rr, nav, &rrate);
-            if (el >= EL_MASK * D2R) {
-                n += search_sig(data + n, "B1CP", SYS_CMP, prn, dif, fs, fi,
-                    rrate);
-            }
+    // search signals by threads
+    int nth = MIN(MIN(NTH > 0 ? NTH : sdr_get_ncpu(), tasks.ntask), MAX_TH);
+    for (int i = 1; i < nth; i++) {
+        if (pthread_create(&thread[i], NULL, search_thread, &tasks)) {
+            nth = i;
+            break;
         }
     }
-    if (ssys & SYS_QZS) {
-        for (int prn = 193; prn <= 199; prn++) {
-            double el, rrate = 0.0;
-            el = sel_sat(time, SYS_QZS, prn, rr, nav, &rrate);
-            if (el >= EL_MASK * D2R) {
-                n += search_sig(data + n, "L1CA", SYS_QZS, prn, dif, fs, fi,
-                    rrate);
-            }
+    search_thread(&tasks);
+    for (int i = 1; i < nth; i++) {
+        pthread_join(thread[i], NULL);
+    }
+    int n = 0;
+    for (int i = 0; i < tasks.ntask; i++) {
+        for (int j = 0; j < tasks.task[i].nsig; j++) {
+            data[n++] = tasks.task[i].data[j];
         }
     }
+    pthread_mutex_destroy(&tasks.mtx);
+    sdr_free(tasks.task);
+    sdr_free(tasks.order);
     return n;
 }
 
@@ -424,6 +607,10 @@ static gtime_t path_time(const char *file)
 {
     double epoch[6] = {0};
     const char *p = strchr(file, '_');
+    if (!p) {
+        gtime_t t0 = {0,0};
+        return t0;
+    }
     sscanf(p + 1, "%4lf%2lf%2lf_%2lf%2lf%2lf", epoch, epoch + 1, epoch + 2,
         epoch + 3, epoch + 4, epoch + 5);
     return utc2gpst(epoch2time(epoch));
@@ -444,17 +631,271 @@ static const char *conv_path(const char *path)
 #endif
 }
 
+// snapshot positioning with IF data file --------------------------------------
+static int snap_file(const char *file, const snapopt_t *opt, const nav_t *nav,
+    out_func_t out, void *arg)
+{
+    data_t data[MAX_SAT] = {{0,0,0}};
+    gtime_t ts = opt->ts;
+    double rr[3];
+    int nsol = 0;
+    
+    // get capture time by file path
+    if (ts.time == 0 && (ts = path_time(file)).time == 0) {
+        fprintf(stderr, "no capture time %s\n", file);
+        return 0;
+    }
+    matcpy(rr, opt->rr, 3, 1);
+    
+    for (int i = 0; i < 100000; i++) {
+        gtime_t tt = timeadd(ts, opt->toff + opt->ti * i);
+        
+        if (opt->ti <= 0.0 && i >= 1) { // single snapshot
+            break;
+        }
+        // read DIF data
+        int IQ = (opt->fi > 0) ? 1 : 2;
+        sdr_buff_t *dif = sdr_read_data(file, opt->fs, IQ, opt->tint,
+            opt->toff + opt->ti * i);
+        if (!dif) {
+            break;
+        }
+        // search signals
+        int n = search_sigs(tt, opt->ssys, dif, opt->fs, opt->fi, rr, nav,
+            data);
+        sdr_buff_free(dif);
+        if (n <= 0) {
+            continue;
+        }
+        
+        // satellite position and velocity
+        double spos[MAX_SAT][8];
+        sat_pos(tt, data, n, nav, spos);
+        
+        if (norm(rr, 3) == 0) {
+            // position by doppler
+            if (!pos_dop(data, n, spos, rr)) {
+                continue;
+            }
+            // force height = 0
+            double pos[3];
+            ecef2pos(rr, pos);
+            pos[2] = 0.0;
+            pos2ecef(pos, rr);
+        }
+        // resolve ms ambiguity in code offsets
+        res_coff_amb(data, n, spos, rr);
+        
+        // estimate position by code offsets
+        double dtr = 0.0;
+        int ns = pos_coff(tt, data, n, rr, nav, &dtr);
+        
+        // output solution
+        char tstr[64], str[128], buff[256];
+        time2str(gpst2utc(timeadd(tt, -dtr)), tstr, 3);
+        pos_str(rr, str);
+        snprintf(buff, sizeof(buff), "%s   %s %4d %4d\n", tstr, str, 5, ns);
+        out(arg, buff);
+        nsol++;
+    }
+    return nsol;
+}
+
+// output solution to file ------------------------------------------------------
+static void out_file(void *arg, const char *str)
+{
+    fputs(str, (FILE *)arg);
+    fflush((FILE *)arg);
+}
+
+// output solution of job -------------------------------------------------------
+static void out_job(void *arg, const char *str)
+{
+    server_t *srv = (server_t *)arg;
+    
+    pthread_mutex_lock(&srv->mtx);
+    out_file(srv->fp, str);
+    if (srv->port > 0) {
+        strwrite(&srv->str, (uint8_t *)str, (int)strlen(str));
+    }
+    pthread_mutex_unlock(&srv->mtx);
+}
+
+// add job to queue -------------------------------------------------------------
+static int add_job(server_t *srv, const char *file)
+{
+    pthread_mutex_lock(&srv->mtx);
+    int next = (srv->tail + 1) % MAX_JOB;
+    if (next == srv->head) {
+        pthread_mutex_unlock(&srv->mtx);
+        fprintf(stderr, "job queue overflow %s\n", file);
+        return 0;
+    }
+    snprintf(srv->jobs[srv->tail], 1024, "%s", file);
+    srv->tail = next;
+    pthread_cond_signal(&srv->cond);
+    pthread_mutex_unlock(&srv->mtx);
+    return 1;
+}
+
+// snapshot job thread ----------------------------------------------------------
+//  The code FFTs and the FFTW plans are cached by the first job and shared by
+//  the following jobs.
+//
+static void *job_thread(void *arg)
+{
+    server_t *srv = (server_t *)arg;
+    char file[1024], buff[1200];
+    
+    while (1) {
+        pthread_mutex_lock(&srv->mtx);
+        while (srv->head == srv->tail) {
+            pthread_cond_wait(&srv->cond, &srv->mtx);
+        }
+        snprintf(file, sizeof(file), "%s", srv->jobs[srv->head]);
+        srv->head = (srv->head + 1) % MAX_JOB;
+        pthread_mutex_unlock(&srv->mtx);
+        
+        uint32_t tick = sdr_get_tick();
+        int nsol = snap_file(file, srv->opt, srv->nav, out_job, srv);
+        double t = (sdr_get_tick() - tick) * 1e-3;
+        
+        fprintf(stderr, "job %s: NSOL=%d TIME(s)=%.3f\n", file, nsol, t);
+        snprintf(buff, sizeof(buff), "%% JOB %s NSOL=%d TIME(s)=%.3f\n", file,
+            nsol, t);
+        out_job(srv, buff);
+    }
+    return NULL;
+}
+
+// read jobs from stream --------------------------------------------------------
+//  A job is a line of IF data file path terminated by CR or LF.
+//
+static void read_jobs(server_t *srv)
+{
+    uint8_t buff[1024];
+    int n = strread(&srv->str, buff, (int)sizeof(buff));
+    
+    for (int i = 0; i < n; i++) {
+        if (buff[i] == '\r' || buff[i] == '\n') {
+            srv->buff[srv->nb] = '\0';
+            if (srv->nb > 0) {
+                add_job(srv, srv->buff);
+            }
+            srv->nb = 0;
+        }
+        else if (srv->nb < (int)sizeof(srv->buff) - 1) {
+            srv->buff[srv->nb++] = (char)buff[i];
+        }
+    }
+}
+
+// test file queued in directory ------------------------------------------------
+static int test_done(const server_t *srv, const char *file)
+{
+    for (int i = 0; i < srv->ndone; i++) {
+        if (!strcmp(srv->done[i], file)) return 1;
+    }
+    return 0;
+}
+
+// scan directory for jobs ------------------------------------------------------
+//  The files modified within FILE_AGE s are skipped as being written.
+//
+static void scan_dir(server_t *srv, const char *path)
+{
+    char *paths[MAX_FILE];
+    
+    for (int i = 0; i < MAX_FILE; i++) {
+        paths[i] = (char *)sdr_malloc(1024);
+    }
+    int n = expath(path, paths, MAX_FILE);
+    time_t now = time(NULL);
+    
+    for (int i = 0; i < n; i++) {
+        struct stat st;
+        if (test_done(srv, paths[i]) || stat(paths[i], &st) ||
+            !S_ISREG(st.st_mode) || now - st.st_mtime < FILE_AGE) {
+            continue;
+        }
+        if (!add_job(srv, paths[i])) break;
+        if (srv->ndone >= srv->nmax) {
+            srv->nmax = srv->nmax <= 0 ? 256 : srv->nmax * 2;
+            srv->done = (char **)realloc(srv->done, sizeof(char *) * srv->nmax);
+        }
+        srv->done[srv->ndone] = (char *)sdr_malloc(strlen(paths[i]) + 1);
+        strcpy(srv->done[srv->ndone++], paths[i]);
+    }
+    for (int i = 0; i < MAX_FILE; i++) {
+        sdr_free(paths[i]);
+    }
+}
+
+// run snapshot job server ------------------------------------------------------
+//  The server accepts the jobs by the files in the directory and the lines of
+//  file paths sent to the TCP port, and processes them by the job threads with
+//  the navigation data read at the start. The server runs until killed.
+//
+static void run_server(const char *dir, int port, int njob, const snapopt_t *opt,
+    const nav_t *nav, FILE *fp)
+{
+    static server_t srv;
+    pthread_t thread;
+    
+    srv.opt = opt;
+    srv.nav = nav;
+    srv.fp = fp;
+    srv.port = port;
+    srv.jobs = (char (*)[1024])sdr_malloc(1024 * MAX_JOB);
+    pthread_mutex_init(&srv.mtx, NULL);
+    pthread_cond_init(&srv.cond, NULL);
+    
+    if (port > 0) {
+        char path[32];
+        snprintf(path, sizeof(path), ":%d", port);
+        strinit(&srv.str);
+        if (!stropen(&srv.str, STR_TCPSVR, STR_MODE_RW, path)) {
+            fprintf(stderr, "job stream open error %s\n", path);
+            exit(-1);
+        }
+    }
+    for (int i = 0; i < njob; i++) {
+        if (pthread_create(&thread, NULL, job_thread, &srv)) {
+            fprintf(stderr, "job thread create error\n");
+            exit(-1);
+        }
+        pthread_detach(thread);
+    }
+    for (uint32_t tick = sdr_get_tick() - SCAN_INT; ; sdr_sleep_msec(10)) {
+        if (port > 0) {
+            read_jobs(&srv);
+        }
+        if (*dir && (int)(sdr_get_tick() - tick) >= SCAN_INT) {
+            scan_dir(&srv, conv_path(dir));
+            tick = sdr_get_tick();
+        }
+    }
+}
+
 //-------------------------------------------------------------------------------
 //
 //   Synopsis
 // 
 //     pocket_snap [-ts time] [-pos lat,lon,hgt] [-ti sec] [-toff toff]
 //         [-f freq] [-fi freq] [-tint tint] [-sys sys[,...]] [-v] [-w file]
-//         -nav file [-out file] file
+//         [-cache file] [-th nth] [-dir path] [-port port] [-job njob]
+//         -nav file [-out file] [file]
 // 
 //   Description
 // 
 //     Snapshot positioning with GNSS signals in digitized IF file.
+//
+//     With the option -dir or -port, pocket_snap runs as a server to process
+//     the jobs of the IF data files until killed. The navigation data are read
+//     once at the start, and the code FFTs and the FFTW plans are kept and
+//     shared by the jobs. The solutions of the jobs are output to the output
+//     file and the TCP port followed by the line "% JOB file NSOL=n TIME(s)=t"
+//     with the job latency.
 // 
 //   Options ([]: default)
 //  
@@ -491,6 +932,24 @@ static const char *conv_path(const char *path)
 //     -w file
 //         Specify FFTW wisdowm file. [../python/fftw_wisdom.txt]
 //
+//     -cache file
+//         Specify code FFT cache file generated by code_cache. The code FFTs in
+//         the file are used instead of generated. [no cache]
+//
+//     -th nth
+//         Number of threads to search signals. (0: number of CPUs) [0]
+//
+//     -dir path
+//         Server mode. Scan the files matching the path (wild-card * allowed)
+//         as jobs. The files modified within 2 s are skipped as being written.
+//
+//     -port port
+//         Server mode. Accept jobs by the lines of IF data file paths sent to
+//         the TCP port. The solutions are sent back to the clients.
+//
+//     -job njob
+//         Number of jobs processed concurrently in server mode. [1]
+//
 //     -nav file
 //         RINEX navigation data file.
 //
@@ -498,46 +957,45 @@ static const char *conv_path(const char *path)
 //         Output solution file as RTKLIB solution format.
 //
 //     file
-//         Digitized IF data file.
+//         Digitized IF data file. (not server mode)
 //
 int main(int argc, char **argv)
 {
-    gtime_t ts = {0,0};
     FILE *fp = stdout;
     nav_t nav;
-    data_t data[MAX_SAT] = {{0,0,0}};
-    double ti = 0.0, toff = 0.0, fs = 6e6, fi = 0.0, tint = 0.02, rr[3] = {0};
+    snapopt_t opt = {{0,0}, 0.0, 0.0, 6e6, 0.0, 0.02, {0}, SYS_GPS};
     const char *file = "", *nfile = "", *ofile = "", *fftw_wisdom = FFTW_WISDOM;
-    int ssys = SYS_GPS;
+    const char *cache = "", *dir = "";
+    int port = 0, njob = 1;
     
     for (int i = 1; i < argc; i++) {
         if (!strcmp(argv[i], "-ts") && i + 1 < argc) {
-            ts = parse_time(argv[++i]);
+            opt.ts = parse_time(argv[++i]);
         }
         else if (!strcmp(argv[i], "-pos") && i + 1 < argc) {
             double pos[3] = {0};
             sscanf(argv[++i], "%lf,%lf,%lf", pos, pos + 1, pos + 2);
             pos[0] *= D2R;
             pos[1] *= D2R;
-            pos2ecef(pos, rr);
+            pos2ecef(pos, opt.rr);
         }
         else if (!strcmp(argv[i], "-ti") && i + 1 < argc) {
-            ti = atof(argv[++i]);
+            opt.ti = atof(argv[++i]);
         }
         else if (!strcmp(argv[i], "-toff") && i + 1 < argc) {
-            toff = atof(argv[++i]);
+            opt.toff = atof(argv[++i]);
         }
         else if (!strcmp(argv[i], "-f") && i + 1 < argc) {
-            fs = atof(argv[++i]) * 1e6;
+            opt.fs = atof(argv[++i]) * 1e6;
         }
         else if (!strcmp(argv[i], "-fi") && i + 1 < argc) {
-            fi = atof(argv[++i]) * 1e6;
+            opt.fi = atof(argv[++i]) * 1e6;
         }
         else if (!strcmp(argv[i], "-tint") && i + 1 < argc) {
-            tint = atof(argv[++i]) * 1e-3;
+            opt.tint = atof(argv[++i]) * 1e-3;
         }
         else if (!strcmp(argv[i], "-sys") && i + 1 < argc) {
-            ssys = parse_sys(argv[++i]);
+            opt.ssys = parse_sys(argv[++i]);
         }
         else if (!strcmp(argv[i], "-nav") && i + 1 < argc) {
             nfile = argv[++i];
@@ -551,6 +1009,21 @@ int main(int argc, char **argv)
         else if (!strcmp(argv[i], "-w") && i + 1 < argc) {
             fftw_wisdom = argv[++i];
         }
+        else if (!strcmp(argv[i], "-cache") && i + 1 < argc) {
+            cache = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-th") && i + 1 < argc) {
+            NTH = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-dir") && i + 1 < argc) {
+            dir = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-port") && i + 1 < argc) {
+            port = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-job") && i + 1 < argc) {
+            njob = MAX(1, atoi(argv[++i]));
+        }
         else if (argv[i][0] == '-') {
             show_usage();
         }
@@ -564,73 +1037,27 @@ int main(int argc, char **argv)
         fprintf(stderr, "nav data read error %s\n", nfile);
         exit(-1);
     }
-    // get capture time by file path
-    if (ts.time == 0) {
-        ts = path_time(file);
-    }
     if (*ofile) {
         if (!(fp = fopen(conv_path(ofile), "w"))) {
             fprintf(stderr, "file open error %s\n", ofile);
             freenav(&nav, 0xFF);
             exit(-1);
         }
-        write_head(fp, file, tint, fs);
+        write_head(fp, *dir || port > 0 ? "(server)" : file, opt.tint, opt.fs);
     }
     sdr_func_init(fftw_wisdom);
-    
+    if (*cache) {
+        sdr_code_cache_open(cache);
+    }
+    if (*dir || port > 0) { // server mode
+        run_server(dir, port, njob, &opt, &nav, fp);
+    }
     uint32_t t0 = tickget();
     
-    for (int i = 0; i < 100000; i++) {
-        gtime_t tt = timeadd(ts, toff + ti * i);
-        
-        if (ti <= 0.0 && i >= 1) { // single snapshot
-            break;
-        }
-        // read DIF data
-        int IQ = (fi > 0) ? 1 : 2;
-        sdr_buff_t *dif = sdr_read_data(file, fs, IQ, tint, toff + ti * i);
-        if (!dif) {
-            break;
-        }
-        // search signals
-        int n = search_sigs(tt, ssys, dif, fs, fi, rr, &nav, data);
-        if (n <= 0) {
-            continue;
-        }
-        sdr_buff_free(dif);
-        
-        // satellite position and velocity
-        double spos[MAX_SAT][8];
-        sat_pos(tt, data, n, &nav, spos);
-        
-        if (norm(rr, 3) == 0) {
-            // position by doppler
-            if (!pos_dop(data, n, spos, rr)) {
-                continue;
-            }
-            // force height = 0
-            double pos[3];
-            ecef2pos(rr, pos);
-            pos[2] = 0.0;
-            pos2ecef(pos, rr);
-        }
-        // resolve ms ambiguity in code offsets
-        res_coff_amb(data, n, spos, rr);
-        
-        // estimate position by code offsets
-        double dtr = 0.0;
-        int ns = pos_coff(tt, data, n, rr, &nav, &dtr);
-        
-        // write solution
-        char tstr[64], str[128];
-        time2str(gpst2utc(timeadd(tt, -dtr)), tstr, 3);
-        pos_str(rr, str);
-        fprintf(fp, "%s   %s %4d %4d\n", tstr, str, 5, ns);
-        fflush(fp);
-    }
+    snap_file(file, &opt, &nav, out_file, fp);
+    
     printf("TIME (s) = %.3f\n", (tickget() - t0) * 1e-3);
     freenav(&nav, 0xFF);
     fclose(fp);
     return 0;
 }
-
@@ -0,0 +1,80 @@
+//
+//  Pocket SDR C AP - Generate Code FFT Cache
+//
+//  Author:
+//  T.TAKASU
+//
+//  History:
+//  2026-10-15  1.0  new
+//
+#include "pocket_sdr.h"
+
+// constants --------------------------------------------------------------------
+#define CODE_CACHE "./code_cache.bin"
+
+//-------------------------------------------------------------------------------
+//
+//   Synopsis
+//
+//     code_cache [-f freq] -sig sig -prn prn[,...] ... [file]
+//
+//   Description
+//
+//     Generate code FFT cache. The code FFT cache holds the zero-padded code
+//     FFTs for signal acquisition. It is memory-mapped and shared by the
+//     processes of pocket_trk and pocket_snap with the -cache option instead
+//     of generating the code FFTs at every start. The sampling frequency
+//     shall be as same as the one of the processes.
+//
+//   Options ([]: default)
+//
+//     -f freq
+//         Sampling frequency of digital IF data in MHz. [12.0]
+//
+//     -sig sig -prn prn[,...] ...
+//         A GNSS signal type ID (L1CA, L2CM, ...) and a PRN number list of the
+//         signal as same as pocket_trk.
+//
+//     file
+//         Output code FFT cache file. [code_cache.bin]
+//
+int main(int argc, char **argv)
+{
+    static const char *sigs[SDR_MAX_NCH];
+    static int prns[SDR_MAX_NCH];
+    double fs = 12e6;
+    int n = 0;
+    const char *sig = "L1CA", *file = CODE_CACHE;
+    
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-f") && i + 1 < argc) {
+            fs = atof(argv[++i]) * 1e6;
+        }
+        else if (!strcmp(argv[i], "-sig") && i + 1 < argc) {
+            sig = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-prn") && i + 1 < argc) {
+            int nums[SDR_MAX_NCH];
+            int m = sdr_parse_nums(argv[++i], nums);
+            for (int j = 0; j < m && n < SDR_MAX_NCH; j++) {
+                sigs[n] = sig;
+                prns[n++] = nums[j];
+            }
+        }
+        else {
+            file = argv[i];
+        }
+    }
+    sdr_func_init("");
+    uint32_t tick = sdr_get_tick();
+    
+    int nent = sdr_gen_code_cache(file, sigs, prns, n, fs);
+    if (nent >= 0) {
+        printf("code FFT cache generated as %s (N=%d).\n", file, nent);
+    }
+    else {
+        printf("code FFT cache generation error.\n");
+    }
+    printf("  TIME(s) = %.3f\n", (sdr_get_tick() - tick) * 1e-3);
+    return 0;
+}
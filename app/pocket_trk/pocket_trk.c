@@ -21,6 +21,19 @@
 //                   delete input from stdin
 //  2024-07-02  1.8  add -fo, -raw option, delete -fi option
 //                   support tag file input for auto-configuration
+//  2026-10-14  1.14 support -tscale 0 for fast replay of IF data file
+//                   add -tspan and -seg options
+//                   add -aff option
+//                   fix stream paths of -log, -nmea and -rtcm options
+//                   support multiple devices by repeated -p and -c options
+//                   add -fmt PACK
+//                   add -rawz option, support compressed IF data file
+//  2026-10-15  1.15 add -cache option
+//                   add -gpu option
+//                   print receiver status by status snapshot
+//                   add -bench option
+//                   add -trace option
+//                   add -net and -node options
 //
 #include <math.h>
 #include <signal.h>
@@ -36,17 +49,51 @@
 #define ESC_UCUR   "\033[A"     // ANSI escape cursor up
 #define ESC_VCUR   "\033[?25h"  // ANSI escape show cursor
 #define ESC_HCUR   "\033[?25l"  // ANSI escape hide cursor
+#define SEG_OVL    60.0         // default overlap of time segments (s)
+#define MAX_CMD    8192         // max length of command line
+#define BENCH_TSPAN 30.0        // default time span of benchmark trial (s)
+#define BENCH_BUFF 50.0         // default max peak buffer usage of trial (%)
+#define BENCH_STEP 1.41421356   // step of time scale or channels of trials
+#define MAX_TRIAL  32           // max number of benchmark trials
+
+#define MIN(x, y)  ((x) < (y) ? (x) : (y))
+
+// type definitions ------------------------------------------------------------
+typedef struct {                // time-segmented processing type
+    char cmd[MAX_CMD];          // command line of segment processes
+    const char *log;            // log stream path
+    double toff;                // time offset of the first segment (s)
+    double tseg, tovl;          // time segment length and overlap (s)
+    int nseg;                   // number of segments
+    int next;                   // next segment to process
+} seg_t;
+
+typedef struct {                // benchmark type
+    const char **sigs;          // signal types of channels
+    const int *prns;            // PRN numbers of channels
+    int nch, fmt;               // number of channels and IF data format
+    double fs, fo[SDR_MAX_RFCH]; // sampling and LO frequencies (Hz)
+    int IQ[SDR_MAX_RFCH];       // sampling types
+    double toff;                // time offset (s)
+    double thres;               // max peak buffer usage (%)
+    const char *file;           // IF data file
+    const char **paths;         // output stream paths
+} bench_t;
 
 // usage text ------------------------------------------------------------------
 static const char *usage_text[] = {
     "Usage: pocket_trk [-sig sig -prn prn[,...] ...] [-fmt {INT8|INT8X2|RAW8|RAW16}]",
     "       [-f freq] [-fo freq[,...]] [-IQ {1|2}[,...]] [-toff toff] [-ti tint]",
-    "       [-p bus,[,port] [-c conf_file] [-log path] [-nmea path] [-rtcm path]",
-    "       [-raw path] [-w file] [file]", NULL
+    "       [-tscale scale] [-tspan tspan] [-seg tseg[,tovl[,nproc]]]",
+    "       [-aff thread:cpus[:pri] ...] [-p bus,[,port] [-c conf_file]",
+    "       [-log path] [-nmea path] [-rtcm path]",
+    "       [-raw path] [-rawz path] [-w file] [-cache file] [-gpu dev]",
+    "       [-bench {tscale|nch}[,thres]] [-trace file[,nev]]",
+    "       [-net path [-node k/n]] [file]", NULL
 };
 
-// interrupt flag --------------------------------------------------------------
-static volatile uint8_t intr = 0;
+// interrupt and trace dump flags ----------------------------------------------
+static volatile uint8_t intr = 0, dump = 0;
 
 // signal handler --------------------------------------------------------------
 static void sig_func(int sig)
@@ -55,6 +102,13 @@ static void sig_func(int sig)
     signal(sig, sig_func);
 }
 
+// signal handler of trace dump ------------------------------------------------
+static void sig_dump(int sig)
+{
+    dump = 1;
+    signal(sig, sig_dump);
+}
+
 // show usage ------------------------------------------------------------------
 static void show_usage(void)
 {
@@ -67,14 +121,17 @@ static void show_usage(void)
 // print receiver status -------------------------------------------------------
 static int print_rcv_stat(sdr_rcv_t *rcv, int nrow)
 {
-    char *stat, *p, *q;
+    static sdr_rcv_snap_t snap;
+    static char stat[120 * (MAX_ROW + 3)];
+    char *p, *q;
     int n = 0;
     
     for (int i = 0; i < nrow; i++) {
         printf("%s", ESC_UCUR);
     }
-    // get SDR receiver channel status
-    stat = sdr_rcv_ch_stat(rcv, "ALL", 0);
+    // get SDR receiver channel status by status snapshot
+    sdr_rcv_snapshot(rcv, &snap);
+    sdr_rcv_snap_ch_str(&snap, "ALL", 0, stat, sizeof(stat));
     
     for (p = q = stat; (q = strchr(p, '\n')); p = q + 1) {
         if (n < MAX_ROW) {
@@ -94,14 +151,225 @@ static int print_rcv_stat(sdr_rcv_t *rcv, int nrow)
     return n;
 }
 
+// benchmark trial -------------------------------------------------------------
+static int bench_trial(const bench_t *bench, const char **sigs, int *prns,
+    int nch, double tscale, double *cpu)
+{
+    sdr_rcv_t *rcv = sdr_rcv_open_file(sigs, prns, nch, bench->fmt, bench->fs,
+        bench->fo, bench->IQ, bench->toff, tscale, bench->file, bench->paths);
+    
+    if (!rcv) return -1;
+    
+    while (!intr && rcv->state) { // wait for interrupt or end of trial
+        sdr_sleep_msec(100);
+    }
+    double tdata = rcv->ix * SDR_CYC, buff_peak = rcv->buff_peak;
+    int64_t nlate = rcv->nlate;
+    sdr_rcv_cpu_time(rcv, cpu);
+    sdr_rcv_close(rcv);
+    
+    if (tdata <= 0.0) return -1;
+    double treal = tdata / tscale, cpu_ch = cpu[1] + cpu[2] + cpu[3];
+    int ok = !intr && buff_peak < bench->thres && nlate == 0;
+    printf("%6.2f %4d %6.1f %6lld %7.1f", tscale, nch, buff_peak,
+        (long long)nlate, cpu_ch > 0.0 ? nch * tdata / cpu_ch : 0.0);
+    for (int i = 0; i < 5; i++) {
+        printf(" %7.1f", cpu[i] / treal * 100.0);
+    }
+    printf("  %s\n", ok ? "OK" : "NG");
+    fflush(stdout);
+    return ok;
+}
+
+// benchmark real-time capacity ------------------------------------------------
+static int proc_bench(const bench_t *bench, const char *mode, double tscale)
+{
+    static const char *sigs[SDR_MAX_NCH];
+    static int prns[SDR_MAX_NCH];
+    static const char *stage[] = {"ingest", "track", "acq", "nav", "pvt"};
+    double ts = tscale > 0.0 ? tscale : 1.0, ts_ok = 0.0, cpu[5], cpu_ok[5];
+    int nch = bench->nch, nch_ok = 0, stat;
+    int tsc = !strcmp(mode, "tscale");
+    
+    if (!tsc && strcmp(mode, "nch")) {
+        fprintf(stderr, "unrecognized benchmark: %s\n", mode);
+        return 0;
+    }
+    if (nch <= 0) {
+        fprintf(stderr, "no channel for benchmark\n");
+        return 0;
+    }
+    printf("%6s %4s %6s %6s %7s %7s %7s %7s %7s %7s\n", "TSCALE", "NCH",
+        "BUFF%", "LATE", "CH/CORE", "INGEST%", "TRACK%", "ACQ%", "NAV%",
+        "PVT%");
+    for (int k = 0; k < MAX_TRIAL && !intr; k++) {
+        for (int i = 0; i < nch; i++) { // repeat channels
+            sigs[i] = bench->sigs[i % bench->nch];
+            prns[i] = bench->prns[i % bench->nch];
+        }
+        if ((stat = bench_trial(bench, sigs, prns, nch, ts, cpu)) < 0) {
+            return 0;
+        }
+        if (!stat) break;
+        ts_ok = ts;
+        nch_ok = nch;
+        memcpy(cpu_ok, cpu, sizeof(cpu));
+        if (tsc) {
+            ts *= BENCH_STEP;
+        }
+        else if (nch < SDR_MAX_NCH) {
+            nch = MIN((int)ceil(nch * BENCH_STEP), SDR_MAX_NCH);
+        }
+        else break;
+    }
+    if (nch_ok <= 0) {
+        printf("bench: not sustainable at tscale=%.2f nch=%d\n", ts, nch);
+        return 1;
+    }
+    int nwk = sdr_rcv_defopt()->nwk, ncpu = nwk > 0 ? nwk : sdr_get_ncpu();
+    if (tsc) {
+        printf("bench: max realtime factor = %.2f (nch=%d)\n", ts_ok, nch_ok);
+    }
+    else {
+        printf("bench: max channels = %d (tscale=%.2f), %.1f channels/core "
+            "(%d cores)\n", nch_ok, ts_ok, (double)nch_ok / ncpu, ncpu);
+    }
+    printf("bench: CPU time (s) =");
+    for (int i = 0; i < 5; i++) {
+        printf(" %s %.3f", stage[i], cpu_ok[i]);
+    }
+    printf("\n");
+    return 1;
+}
+
+// time-segmented processing thread --------------------------------------------
+static void *seg_thread(void *arg)
+{
+    seg_t *seg = (seg_t *)arg;
+    int k;
+    
+    while ((k = __atomic_fetch_add(&seg->next, 1, __ATOMIC_SEQ_CST)) <
+        seg->nseg) {
+        char cmd[MAX_CMD + 256];
+        double tovl = MIN(seg->tovl, k * seg->tseg);
+        snprintf(cmd, sizeof(cmd), "%s -toff %.3f -tspan %.3f -log \"%s.seg%d\"",
+            seg->cmd, seg->toff + k * seg->tseg - tovl, seg->tseg + tovl,
+            seg->log, k);
+        if (system(cmd)) {
+            fprintf(stderr, "segment process error: segment=%d\n", k);
+        }
+    }
+    return NULL;
+}
+
+// merge log of time segment ---------------------------------------------------
+static void merge_log(const seg_t *seg, int k, sdr_str_t *str)
+{
+    char path[1024], buff[1024], line[1100];
+    double tovl = MIN(seg->tovl, k * seg->tseg), t;
+    int n;
+    FILE *fp;
+    
+    snprintf(path, sizeof(path), "%s.seg%d", seg->log, k);
+    if (!(fp = fopen(path, "r"))) {
+        fprintf(stderr, "segment log open error: %s\n", path);
+        return;
+    }
+    while (fgets(buff, sizeof(buff), fp)) {
+        char *p = strchr(buff, ',');
+        if (!p || sscanf(p + 1, "%lf%n", &t, &n) < 1) continue;
+        if (t < tovl || t >= tovl + seg->tseg) continue;
+        
+        // time of log relative to the first segment
+        t += k * seg->tseg - tovl;
+        int len = snprintf(line, sizeof(line), "%.*s,%.3f%s", (int)(p - buff),
+            buff, t, p + 1 + n);
+        sdr_str_write(str, (uint8_t *)line, MIN(len, (int)sizeof(line) - 1));
+    }
+    fclose(fp);
+    remove(path);
+}
+
+// process IF data file by time segments ---------------------------------------
+static int proc_seg(int argc, char **argv, const char *file, int fmt, double fs,
+    double toff, double tseg, double tovl, int nproc, const char *log)
+{
+    static const char *opts[] = {"-toff", "-tspan", "-tscale", "-ti", "-seg",
+        "-log", "-nmea", "-rtcm", "-raw", "-rawz", NULL};
+    seg_t *seg = (seg_t *)sdr_malloc(sizeof(seg_t));
+    pthread_t thread[64];
+    double fo[SDR_MAX_RFCH] = {0};
+    int IQ[SDR_MAX_RFCH] = {0}, n = 0;
+    sdr_iff_t *iff;
+    
+    if (!*log) {
+        fprintf(stderr, "no log stream path for -seg option\n");
+        sdr_free(seg);
+        return 0;
+    }
+    if (!(iff = sdr_iff_open(file, 0))) {
+        sdr_free(seg);
+        return 0;
+    }
+    double size = (double)iff->size;
+    sdr_iff_close(iff);
+    sdr_rcv_read_tag(file, &fmt, &fs, fo, IQ);
+    double ns = (fmt == SDR_FMT_INT8 || fmt == SDR_FMT_RAW8) ? 1.0 :
+        (fmt == SDR_FMT_PACK ? 0.5 : 2.0);
+    
+    // command line of segment processes w/o time and output options
+    n += snprintf(seg->cmd + n, MAX_CMD - n, "\"%s\"", argv[0]);
+    for (int i = 1; i < argc && n < MAX_CMD; i++) {
+        int j = 0;
+        while (opts[j] && strcmp(argv[i], opts[j])) j++;
+        if (opts[j]) {
+            i++;
+            continue;
+        }
+        n += snprintf(seg->cmd + n, MAX_CMD - n, " \"%s\"", argv[i]);
+    }
+    if (n >= MAX_CMD) {
+        fprintf(stderr, "command line too long for -seg option\n");
+        sdr_free(seg);
+        return 0;
+    }
+    snprintf(seg->cmd + n, MAX_CMD - n, " -tscale 0 -ti 0");
+    seg->log = log;
+    seg->toff = toff;
+    seg->tseg = tseg;
+    seg->tovl = tovl;
+    seg->nseg = (int)ceil((size / (fs * ns) - toff) / tseg);
+    nproc = MIN(MIN(nproc > 0 ? nproc : sdr_get_ncpu(), seg->nseg), 64);
+    
+    uint32_t tick = sdr_get_tick();
+    for (int i = 0; i < nproc; i++) {
+        pthread_create(&thread[i], NULL, seg_thread, seg);
+    }
+    for (int i = 0; i < nproc; i++) {
+        pthread_join(thread[i], NULL);
+    }
+    sdr_str_t *str = sdr_str_open(log);
+    for (int k = 0; k < seg->nseg; k++) {
+        merge_log(seg, k, str);
+    }
+    sdr_str_close(str);
+    printf("segments: %d x %.1f s, processes: %d, TIME(s) = %.3f\n", seg->nseg,
+        tseg, nproc, (sdr_get_tick() - tick) * 1e-3);
+    sdr_free(seg);
+    return 1;
+}
+
 //------------------------------------------------------------------------------
 //
 //   Synopsis
 //
 //     pocket_trk [-sig sig -prn prn[,...] ...] [-fmt {INT8|INT8X2|RAW8|RAW16}]
 //         [-f freq] [-fo freq[,...]] [-IQ {1|2}[,...]] [-toff toff] [-ti tint]
-//         [-p bus,[,port] [-c conf_file] [-log path] [-nmea path] [-rtcm path]
-//         [-raw path] [-w file] [file]
+//         [-tscale scale] [-tspan tspan] [-seg tseg[,tovl[,nproc]]]
+//         [-aff thread:cpus[:pri] ...] [-p bus,[,port] [-c conf_file]
+//         [-log path] [-nmea path] [-rtcm path] [-raw path] [-rawz path]
+//         [-w file] [-cache file] [-gpu dev] [-bench {tscale|nch}[,thres]]
+//         [-trace file[,nev]] [-net path [-node k/n]] [file]
 //
 //   Description
 //
@@ -122,10 +390,11 @@ static int print_rcv_stat(sdr_rcv_t *rcv, int nrow)
 //         FCN (frequency channel number). The pair of a signal type ID and a PRN
 //         number list can be repeated for multiple GNSS signals to be tracked.
 //
-//     -fmt {INT8|INT8X2|RAW8|RAW16}
+//     -fmt {INT8|INT8X2|RAW8|RAW16|PACK}
 //         Specify IF data format as follows: INT8 = int8 (I-sampling), INT8X2 =
 //         interleaved int8 (IQ-sampling), RAW8 = Pocket SDR FE 2CH raw (packed
-//         8 bits), RAW16 = Pocket SDR FE 4CH raw (packed 16 bits) [INT8X2]
+//         8 bits), RAW16 = Pocket SDR FE 4CH raw (packed 16 bits), PACK =
+//         packed 4 bits sample codes of a RF channel by pocket_dump -k [INT8X2]
 //
 //     -f freq
 //         Specify the sampling frequency of the IF data in MHz. [12.0]
@@ -146,7 +415,31 @@ static int print_rcv_stat(sdr_rcv_t *rcv, int nrow)
 //         Time offset from the start of the IF data in s. [0.0]
 //
 //     -tscale scale
-//         Time scale to replay the IF data file. [1.0]
+//         Time scale to replay the IF data file. If 0 specified, the IF data
+//         file is replayed as fast as possible without loss of the IF data.
+//         [1.0]
+//
+//     -tspan tspan
+//         Time span to process the IF data file in s. If 0 specified, all of
+//         the IF data file after the time offset is processed. [0.0]
+//
+//     -seg tseg[,tovl[,nproc]]
+//         Process the IF data file in parallel by time segments. The IF data
+//         file is split into time segments of tseg s. Each segment is processed
+//         by a child pocket_trk process as fast as possible, starting tovl s
+//         [60] before the segment to acquire and track the signals and to
+//         decode the navigation data. Up to nproc [CPU cores] processes are
+//         run at the same time. The logs of the segments are merged in time
+//         order to the -log stream. -nmea, -rtcm and -raw are not supported.
+//
+//     -aff thread:cpus[:pri] ...
+//         Set CPU affinity and scheduling priority of the receiver threads.
+//         thread: ingest (IF data input and unpacking), track (tracking
+//         workers) or acq (acquisition workers), cpus: CPU numbers and ranges
+//         like 0-3,8, pri: 1-99 for real-time priority or -19 to -1 for lower
+//         priority [0]. If the CPUs of acq specified, the signal searches are
+//         run by the acquisition workers on the CPUs separated from tracking.
+//         The option can be repeated for multiple threads.
 //
 //     -ti tint
 //         Update interval of the signal tracking status in seconds. If 0
@@ -154,11 +447,16 @@ static int print_rcv_stat(sdr_rcv_t *rcv, int nrow)
 //
 //     -p bus[,port]
 //         USB bus and port number of the Pocket SDR FE device in case of IF data
-//         input from the device.
+//         input from the device. The option can be repeated for multiple
+//         devices (max 4) sharing a reference clock to be processed by one
+//         receiver. The RF channels of the devices are numbered in the order
+//         of the options.
 //
 //     -c conf_file
 //         Configure the Pocket SDR FE device with a device configuration file
-//         before signal acquisition and tracking.
+//         before signal acquisition and tracking. The option can be repeated
+//         for the devices in the order of -p options. The last file is applied
+//         to the rest of the devices.
 //
 //     -log path
 //         A stream path to write the signal tracking log. The log includes
@@ -182,9 +480,61 @@ static int print_rcv_stat(sdr_rcv_t *rcv, int nrow)
 //         A stream path to write raw IF data. The stream path is as same as the
 //         -log option.
 //
+//     -rawz path
+//         A stream path to write raw IF data as a compressed IF data file
+//         (losslessly compressed by chunks of 100 ms with the tag and a seek
+//         index). The stream path is as same as the -log option.
+//
 //     -w file
 //         Specify the FFTW wisdowm file. [../python/fftw_wisdom.txt]
 //
+//     -cache file
+//         Specify the code FFT cache file generated by code_cache. The code
+//         FFTs for signal acquisition in the file are used instead of generated.
+//         [no cache]
+//
+//     -gpu dev
+//         Search signals by the GPU backend with the CUDA device number dev.
+//         The library shall be built with the GPU backend (make CUDA=1). If the
+//         GPU is not available, signals are searched by CPU. [CPU only]
+//
+//     -bench {tscale|nch}[,thres]
+//         Benchmark the real-time capacity by the IF data file. Trials of
+//         tspan s [30] of the IF data file are replayed with the time scale
+//         (tscale) or the number of channels (nch) increased from -tscale
+//         or the channels specified by -sig and -prn (repeated) by steps of
+//         x 1.41 until the peak buffer usage reaches thres % [50] or the IF
+//         data input is late to be dropped by the SDR device. The max
+//         sustainable time scale (realtime factor) or number of channels, the
+//         channels per CPU core and the CPU time of the receiver stages
+//         (ingest, tracking, acquisition, nav decoding and PVT) in % of a CPU
+//         core are reported.
+//
+//     -trace file[,nev]
+//         Record the timeline spans of the receiver pipeline (receiver cycles,
+//         IF data buffer writes, channel updates, code searches, nav decodes,
+//         FFTW plan creations and PVT updates) by threads and write the latest
+//         nev spans [65536] of each thread to file as a Chrome trace JSON file
+//         at exit, which can be viewed by Perfetto UI (ui.perfetto.dev) or
+//         chrome://tracing. The trace is also written by a signal SIGUSR1
+//         while running (e.g. kill -USR1 <pid>). [no trace]
+//
+//     -net path
+//         Input IF data from a network IF data stream sent by a capture node
+//         (e.g. pocket_dump -n). The path should be tcp://address:port (TCP
+//         client), udp://:port (UDP server) or shm://name (shared memory).
+//         The format, the sampling frequency, the LO frequencies and the
+//         sampling types are given by the tag in the stream, so the options
+//         -fmt, -f, -fo and -IQ are ignored. Lost packets of the stream are
+//         filled with 0 and reported in the log as IF DATA ERROR. [no]
+//
+//     -node k/n
+//         Process the channel subset of the compute node k (0 to n-1) in n
+//         nodes subscribing to the same network IF data stream. The channels
+//         are assigned to the nodes by the PRN numbers (PRN mod n = k), so the
+//         signals of a satellite are tracked by a node. The logs of the nodes
+//         can be merged in time order downstream. [all channels]
+//
 //     [file]
 //         A file path of the input IF data. The Pocket SDR FE deveice and
 //         pocket_dump can be used to capture such digitized IF data.
@@ -192,7 +542,9 @@ static int print_rcv_stat(sdr_rcv_t *rcv, int nrow)
 //         If the tag file <file>.tag of the input IF data exists, the format,
 //         the sampling frequency, the LO frequencies and the sampling types
 //         are automatically recognized by the tag file and the options -fmt,
-//         -f, -fo, and -IQ are ignored.
+//         -f, -fo, and -IQ are ignored. A compressed IF data file written by
+//         pocket_dump -z or -rawz is recognized and decoded automatically by
+//         the tag in the file.
 //
 //         If the file path omitted, the input is taken from a Pocket SDR FE
 //         device directly. In this case, the sampling frequency, the sampling
@@ -205,12 +557,21 @@ int main(int argc, char **argv)
     sdr_rcv_t *rcv;
     int prns[SDR_MAX_NCH], nch = 0, fmt = SDR_FMT_INT8X2;
     int IQ[SDR_MAX_RFCH] = {2, 2, 2, 2, 2, 2, 2, 2};
-    int dev_type = SDR_DEV_FILE, bus = -1, port = -1, nrow = 0;
+    int dev_type = SDR_DEV_FILE, nrow = 0, ndev = 0, nconf = 0;
+    int bus[SDR_MAX_NDEV] = {-1, -1, -1, -1};
+    int port[SDR_MAX_NDEV] = {-1, -1, -1, -1};
     double fs = 12.0, fo[SDR_MAX_RFCH] = {0}, toff = 0.0, tscale = 1.0;
-    double tint = 0.1;
+    double tint = 0.1, tspan = 0.0, tseg = 0.0, tovl = SEG_OVL;
+    int nproc = 0;
     const char *sig = "L1CA", *sigs[SDR_MAX_NCH];
-    const char *file = "", *fftw_wisdom = FFTW_WISDOM, *conf_file = "";
+    const char *file = "", *fftw_wisdom = FFTW_WISDOM, *cache = "";
+    int gpu = -1;
+    const char *conf_files[SDR_MAX_NDEV] = {"", "", "", ""};
     const char *paths[4] = {"", "", "", ""}, *debug_file = "";
+    char mode[16] = "", trace_file[1024] = "";
+    double thres = BENCH_BUFF;
+    int nev = 0, node_k = 0, node_n = 0;
+    const char *net = "";
     
     for (int i = 1; i < argc; i++) {
         if (!strcmp(argv[i], "-sig") && i + 1 < argc) {
@@ -230,6 +591,18 @@ int main(int argc, char **argv)
         else if (!strcmp(argv[i], "-tscale") && i + 1 < argc) {
             tscale = atof(argv[++i]);
         }
+        else if (!strcmp(argv[i], "-tspan") && i + 1 < argc) {
+            tspan = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-seg") && i + 1 < argc) {
+            sscanf(argv[++i], "%lf,%lf,%d", &tseg, &tovl, &nproc);
+        }
+        else if (!strcmp(argv[i], "-aff") && i + 1 < argc) {
+            char thread[16] = "", cpus[256] = "";
+            int pri = 0;
+            sscanf(argv[++i], "%15[^:]:%255[^:]:%d", thread, cpus, &pri);
+            if (!sdr_rcv_setaff(thread, cpus, pri)) exit(-1);
+        }
         else if (!strcmp(argv[i], "-fmt") && i + 1 < argc) {
             const char *format = argv[++i];
             if      (!strcmp(format, "INT8"  )) fmt = SDR_FMT_INT8;
@@ -237,6 +610,7 @@ int main(int argc, char **argv)
             else if (!strcmp(format, "RAW8"  )) fmt = SDR_FMT_RAW8;
             else if (!strcmp(format, "RAW16" )) fmt = SDR_FMT_RAW16;
             else if (!strcmp(format, "RAW16I")) fmt = SDR_FMT_RAW16I;
+            else if (!strcmp(format, "PACK"  )) fmt = SDR_FMT_PACK;
             else {
                 fprintf(stderr, "unrecognized format: %s\n", format);
                 exit(-1);
@@ -258,26 +632,55 @@ int main(int argc, char **argv)
             tint = atof(argv[++i]);
         }
         else if (!strcmp(argv[i], "-p") && i + 1 < argc) {
-            sscanf(argv[++i], "%d,%d", &bus, &port);
+            if (ndev < SDR_MAX_NDEV) {
+                sscanf(argv[++i], "%d,%d", bus + ndev, port + ndev);
+                ndev++;
+            }
+            else i++;
         }
         else if (!strcmp(argv[i], "-c") && i + 1 < argc) {
-            conf_file = argv[++i];
+            if (nconf < SDR_MAX_NDEV) {
+                conf_files[nconf++] = argv[++i];
+            }
+            else i++;
         }
         else if (!strcmp(argv[i], "-w") && i + 1 < argc) {
             fftw_wisdom = argv[++i];
         }
+        else if (!strcmp(argv[i], "-cache") && i + 1 < argc) {
+            cache = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-gpu") && i + 1 < argc) {
+            gpu = atoi(argv[++i]);
+        }
         else if (!strcmp(argv[i], "-log") && i + 1 < argc) {
-            paths[0] = argv[++i];
+            paths[2] = argv[++i];
         }
         else if (!strcmp(argv[i], "-nmea") && i + 1 < argc) {
-            paths[1] = argv[++i];
+            paths[0] = argv[++i];
         }
         else if (!strcmp(argv[i], "-rtcm") && i + 1 < argc) {
-            paths[2] = argv[++i];
+            paths[1] = argv[++i];
         }
         else if (!strcmp(argv[i], "-raw") && i + 1 < argc) {
             paths[3] = argv[++i];
         }
+        else if (!strcmp(argv[i], "-rawz") && i + 1 < argc) {
+            paths[3] = argv[++i];
+            sdr_rcv_setopt("raw_comp", 1);
+        }
+        else if (!strcmp(argv[i], "-bench") && i + 1 < argc) {
+            sscanf(argv[++i], "%15[^,],%lf", mode, &thres);
+        }
+        else if (!strcmp(argv[i], "-trace") && i + 1 < argc) {
+            sscanf(argv[++i], "%1023[^,],%d", trace_file, &nev);
+        }
+        else if (!strcmp(argv[i], "-net") && i + 1 < argc) {
+            net = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-node") && i + 1 < argc) {
+            sscanf(argv[++i], "%d/%d", &node_k, &node_n);
+        }
         else if (!strcmp(argv[i], "-debug") && i + 1 < argc) {
             debug_file = argv[++i];
         }
@@ -288,25 +691,66 @@ int main(int argc, char **argv)
             file = argv[i];
         }
     }
+    if (node_n > 0) { // channel subset of compute node
+        int n = 0;
+        for (int i = 0; i < nch; i++) {
+            if ((prns[i] % node_n + node_n) % node_n != node_k) continue;
+            sigs[n] = sigs[i];
+            prns[n++] = prns[i];
+        }
+        nch = n;
+    }
     if (*debug_file) {
         traceopen(debug_file);
         tracelevel(TRACE_LEVEL);
     }
+    if (*file && tseg > 0.0) {
+        return proc_seg(argc, argv, file, fmt, fs, toff, tseg, tovl, nproc,
+            paths[2]) ? 0 : -1;
+    }
     sdr_func_init(fftw_wisdom);
+    if (*cache) {
+        sdr_code_cache_open(cache);
+    }
+    if (gpu >= 0 && !sdr_set_acq_gpu(gpu)) {
+        fprintf(stderr, "GPU backend not available. Search signals by CPU.\n");
+    }
+    sdr_rcv_setopt("tspan", tspan);
     
     signal(SIGTERM, sig_func);
     signal(SIGINT, sig_func);
 #ifndef WIN32
     signal(SIGPIPE, SIG_IGN);
+    signal(SIGUSR1, sig_dump);
 #endif
+    if (*trace_file) {
+        sdr_trace_start(nev);
+    }
+    if (*file && *mode) {
+        bench_t bench = {sigs, prns, nch, fmt, fs, {0}, {0}, toff, thres, file,
+            paths};
+        memcpy(bench.fo, fo, sizeof(fo));
+        memcpy(bench.IQ, IQ, sizeof(IQ));
+        sdr_rcv_setopt("prof", 1);
+        sdr_rcv_setopt("shed", 0); // no load shedding for real-time capacity
+        sdr_rcv_setopt("tspan", tspan > 0.0 ? tspan : BENCH_TSPAN);
+        return proc_bench(&bench, mode, tscale) ? 0 : -1;
+    }
     uint32_t tt = sdr_get_tick();
     
-    if (*file) {
+    if (*net) {
+        rcv = sdr_rcv_open_net(sigs, prns, nch, net, paths);
+    }
+    else if (*file) {
         rcv = sdr_rcv_open_file(sigs, prns, nch, fmt, fs, fo, IQ, toff,
             tscale, file, paths);
     }
     else {
-        rcv = sdr_rcv_open_dev(sigs, prns, nch, bus, port, conf_file, paths);
+        for (int i = nconf; i > 0 && i < SDR_MAX_NDEV; i++) {
+            conf_files[i] = conf_files[nconf-1];
+        }
+        rcv = sdr_rcv_open_ndev(sigs, prns, nch, ndev > 0 ? ndev : 1, bus,
+            port, conf_files, paths);
     }
     if (!rcv) {
         return -1;
@@ -318,6 +762,10 @@ int main(int argc, char **argv)
         if (tint > 0.0) {
             nrow = print_rcv_stat(rcv, nrow);
         }
+        if (dump && *trace_file) {
+            sdr_trace_dump(trace_file);
+            dump = 0;
+        }
         sdr_sleep_msec(tint > 0.0 ? (int)(tint * 1000) : 100);
     }
     if (tint > 0.0) {
@@ -327,6 +775,10 @@ int main(int argc, char **argv)
     }
     sdr_rcv_close(rcv);
     
+    if (*trace_file) {
+        sdr_trace_stop();
+        sdr_trace_dump(trace_file);
+    }
     if (*debug_file) {
         traceclose();
     }
@@ -13,26 +13,31 @@ ifeq ($(OS),Windows_NT)
     CC = g++
     INSTALL = ../win32
     INCLUDE = -I$(SRC) -I../RTKLIB/src -I../cyusb
-    OPTIONS = -DWIN32 -DAVX2 -mavx2 -mfma
-    LDLIBS = -static ./librtk.a ./libfec.a ./libldpc.a -lfftw3f -lwinmm \
+    OPTIONS = -DWIN32 -DAVX2 -DAVX512
+    LDLIBS = -static ./librtk.a -lfftw3f -lwinmm \
              ../cyusb/CyAPI.a -lpthread -lsetupapi -lavrt -lwsock32
 else ifeq ($(shell uname -sm),Darwin arm64)
     CC = clang
     INSTALL = ../macos
     INCLUDE = -I$(SRC) -I../RTKLIB/src -I/opt/homebrew/include
     OPTIONS = -DMACOS -DNEON -Wno-deprecated
-    LDLIBS = -L/opt/homebrew/lib ./librtk.a ./libfec.a ./libldpc.a -lfftw3f \
-             -lusb-1.0 -lpthread
+    LDLIBS = -L/opt/homebrew/lib ./librtk.a -lfftw3f -lusb-1.0 -lpthread
 else
     CC = g++
     INSTALL = ../linux
     INCLUDE = -I$(SRC) -I../RTKLIB/src
-    OPTIONS = -DAVX2 -mavx2 -mfma
-    LDLIBS = ./librtk.a ./libfec.a ./libldpc.a -lfftw3f -lpthread -lusb-1.0 -lm \
-             -lpthread
+    OPTIONS = -DAVX2 -DAVX512
+    LDLIBS = ./librtk.a -lfftw3f -lpthread -lusb-1.0 -lm -lpthread
 endif
 ifeq ($(shell uname -m),aarch64)
     OPTIONS = -DNEON
+    #OPTIONS = -DNEON -DSVE2 -march=armv8-a+sve2
+endif
+
+ifdef CUDA # GPU backend for signal acquisition (make CUDA=1)
+    OPTIONS += -DCUDA
+    OBJ_GPU = sdr_gpu.o
+    LDLIBS += -L/usr/local/cuda/lib64 -lcudart -lcufft
 endif
 
 #CFLAGS = -Ofast -march=native $(INCLUDE) $(OPTIONS) -Wall -fPIC -g
@@ -40,7 +45,7 @@ CFLAGS = -Ofast $(INCLUDE) $(OPTIONS) -Wall -fPIC -g
 
 OBJ = sdr_cmn.o sdr_func.o sdr_code.o sdr_code_gal.o sdr_ch.o \
       sdr_nav.o sdr_pvt.o sdr_rcv.o sdr_fec.o sdr_ldpc.o sdr_nb_ldpc.o \
-      sdr_usb.o sdr_dev.o sdr_conf.o
+      sdr_usb.o sdr_dev.o sdr_conf.o sdr_ifz.o sdr_net.o $(OBJ_GPU)
 
 TARGET = libsdr.so libsdr.a
 
@@ -94,6 +99,15 @@ sdr_dev.o : $(SRC)/sdr_dev.c
 sdr_conf.o : $(SRC)/sdr_conf.c
 	$(CC) -c $(CFLAGS) $(SRC)/sdr_conf.c
 
+sdr_ifz.o : $(SRC)/sdr_ifz.c
+	$(CC) -c $(CFLAGS) $(SRC)/sdr_ifz.c
+
+sdr_net.o : $(SRC)/sdr_net.c
+	$(CC) -c $(CFLAGS) $(SRC)/sdr_net.c
+
+sdr_gpu.o : $(SRC)/sdr_gpu.cu
+	nvcc -c -O3 $(INCLUDE) -DCUDA -Xcompiler -fPIC $(SRC)/sdr_gpu.cu
+
 sdr_cmn.o  : $(SRC)/pocket_sdr.h
 sdr_func.o : $(SRC)/pocket_sdr.h
 sdr_code.o : $(SRC)/pocket_sdr.h
@@ -107,6 +121,9 @@ sdr_nb_ldpc.o: $(SRC)/pocket_sdr.h
 sdr_usb.o  : $(SRC)/pocket_sdr.h
 sdr_dev.o  : $(SRC)/pocket_sdr.h
 sdr_conf.o : $(SRC)/pocket_sdr.h
+sdr_ifz.o  : $(SRC)/pocket_sdr.h
+sdr_net.o  : $(SRC)/pocket_sdr.h
+sdr_gpu.o  : $(SRC)/pocket_sdr.h
 
 clean:
 	rm -f $(TARGET) *.o
@@ -7,6 +7,7 @@
 #
 #  History:
 #  2024-06-29  1.0  new
+#  2026-10-15  1.1  get receiver status by zero-copy view of libsdr
 #
 import os, platform, time, re
 from math import *
@@ -35,6 +36,9 @@ P2_COLOR   = '#888844'       # plot color 2
 SDR_N_CORR = (4+81)          # number of correlators
 SDR_N_HIST = 5000            # number of correlator history
 SDR_N_PSD  = 2048            # number FFT points for PSD
+SDR_MAX_NCH = 999            # max number of receiver channels
+SDR_VIEW_VER = 2             # version of receiver status view
+MIN_LOCK   = 2.0             # min lock time to show signal status (s)
 MAX_RCVLOG = 2000            # max receiver logs
 UD_CYCLE1  = 20              # update cycle (ms) RF channels/Correlator pages
 UD_CYCLE2  = 100             # update cycle (ms) other pages
@@ -76,6 +80,54 @@ except:
 # general object class ---------------------------------------------------------
 class Obj: pass
 
+# receiver status view (see sdr_rcv_view_t in pocket_sdr.h) --------------------
+sdr_ch_view_t = sdr_func.sdr_ch_view_t
+
+class sdr_rcv_view_t(Structure):
+    _fields_ = [('ver', c_uint32), ('size', c_uint32), ('seq', c_uint32),
+        ('nch', c_int32), ('corr_ch', c_int32), ('ncorr', c_int32),
+        ('nhist', c_int32), ('rf_ch', c_int32), ('npsd', c_int32),
+        ('resv', c_int32), ('corr_stat', c_double * 6),
+        ('hist_stat', c_double * 2), ('C', c_float * 2 * SDR_N_CORR),
+        ('pos', c_int32 * SDR_N_CORR), ('P', c_float * 2 * SDR_N_HIST),
+        ('psd', c_float * SDR_N_PSD), ('ch', sdr_ch_view_t * SDR_MAX_NCH)]
+
+rcv_views = {} # receiver status views wrapped as NumPy arrays
+
+# get receiver status view -----------------------------------------------------
+#  The arrays of the view share the memory with libsdr and are updated in place
+#  by update_view(). None is returned for libsdr without the view.
+def get_view(rcv):
+    if rcv in rcv_views:
+        return rcv_views[rcv]
+    if not hasattr(libsdr, 'sdr_rcv_view'):
+        return None
+    libsdr.sdr_rcv_view.argtypes = (c_void_p,)
+    libsdr.sdr_rcv_view.restype = POINTER(sdr_rcv_view_t)
+    p = libsdr.sdr_rcv_view(rcv)
+    if not p or p.contents.ver != SDR_VIEW_VER or \
+        p.contents.size != sizeof(sdr_rcv_view_t):
+        return None
+    view = Obj()
+    view.v = p.contents
+    view.C = ctypeslib.as_array(view.v.C).view('complex64').reshape(-1)
+    view.pos = ctypeslib.as_array(view.v.pos)
+    view.P = ctypeslib.as_array(view.v.P).view('complex64').reshape(-1)
+    view.psd = ctypeslib.as_array(view.v.psd)
+    view.ch = ctypeslib.as_array(view.v.ch)
+    rcv_views[rcv] = view
+    return view
+
+# update receiver status view --------------------------------------------------
+def update_view(rcv, ch=0, tspan=0.0, rf_ch=0, tave=0.0):
+    view = get_view(rcv)
+    if view:
+        libsdr.sdr_rcv_view_update.argtypes = (c_void_p, c_int32, c_double,
+            c_int32, c_double)
+        libsdr.sdr_rcv_view_update.restype = c_uint32
+        libsdr.sdr_rcv_view_update(rcv, ch, tspan, rf_ch, tave)
+    return view
+
 # get font ---------------------------------------------------------------------
 def get_font(add_size=0, weight='normal', mono=0):
     return (FONT[mono], FONT_SIZE[mono] + add_size, weight)
@@ -199,6 +251,7 @@ def qzss_no2prn(sig, no):
 
 # stop receiver ----------------------------------------------------------------
 def rcv_close(rcv):
+    rcv_views.pop(rcv, None)
     libsdr.sdr_rcv_close.argtypes = (c_void_p,)
     libsdr.sdr_rcv_close(rcv)
 
@@ -233,6 +286,23 @@ def get_ch_stat(rcv, sys, all=0):
 
 # get signal status ------------------------------------------------------------
 def get_sig_stat(rcv, sys):
+    view = update_view(rcv)
+    if view:
+        sys_ids = {'ALL': '', 'GPS': 'G', 'GLONASS': 'R', 'Galileo': 'E',
+            'QZSS': 'J', 'BeiDou': 'C', 'NavIC': 'I', 'SBAS': '1S'}
+        ch = view.ch[:view.v.nch]
+        ch = ch[(ch['state'] == 3) & (ch['lock'] >= MIN_LOCK)]
+        sig_stat = []
+        for c in ch:
+            sat = c['sat'].decode()
+            if sys != 'ALL' and sat[0] not in sys_ids[sys]:
+                continue
+            no = 'GREJCIS'.find(sat[0]) * 100 + int(sat[1:])
+            sig_stat.append([no, -c['cn0'], sat, c['sig'].decode(),
+                round(c['cn0'], 1)])
+        sig_stat = sorted(sig_stat)
+        return [s[2] for s in sig_stat], [s[3] for s in sig_stat], \
+            [s[4] for s in sig_stat]
     stat = get_ch_stat(rcv, sys)[2:]
     sig_stat = []
     for s in stat:
@@ -268,6 +338,10 @@ def get_rfch_stat(rcv, ch):
 
 # get RF channel PSD -----------------------------------------------------------
 def get_rfch_psd(rcv, ch, tave):
+    view = update_view(rcv, rf_ch=ch, tave=tave)
+    if view:
+        n = view.v.npsd
+        return view.psd[:n] if n > 0 else view.psd[:2]
     psd = np.zeros(SDR_N_PSD, dtype='float32')
     libsdr.sdr_rcv_rfch_psd.argtypes = (c_void_p, c_int32, c_double, c_int32,
         ctypeslib.ndpointer('float32'))
@@ -305,6 +379,11 @@ def set_sel_ch(rcv, ch):
 
 # get correlator status ---------------------------------------------------------
 def get_corr_stat(rcv, ch):
+    view = update_view(rcv, ch=ch)
+    if view and view.v.corr_ch == ch:
+        stat, n = view.v.corr_stat, view.v.ncorr
+        return int(stat[0]), stat[1], stat[2], stat[3], stat[4], stat[5], \
+            view.pos[:n], view.C[:n]
     stat = np.array([0, 24e6, 0, 0, 0, 0], dtype='float64')
     pos = np.zeros(SDR_N_CORR, dtype='int32')
     pos[4:7] = [-40, 0, 40]
@@ -319,6 +398,10 @@ def get_corr_stat(rcv, ch):
 
 # get correlator history --------------------------------------------------------
 def get_corr_hist(rcv, ch, tspan):
+    view = update_view(rcv, ch=ch, tspan=tspan)
+    if view and view.v.corr_ch == ch:
+        stat, n = view.v.hist_stat, view.v.nhist
+        return stat[0], stat[1], view.P[:n] if n > 0 else view.P[:2]
     stat = np.array([0, 1e-3], dtype='float64')
     P = np.zeros(SDR_N_HIST, dtype='complex64')
     libsdr.sdr_rcv_corr_hist.argtypes = (c_void_p, c_int32, c_double,
@@ -915,7 +998,8 @@ def update_corr_plot3(p, tt, T, P, rng):
 # generate Log page ------------------------------------------------------------
 def log_page_new(parent):
     filts = ('', '$TIME', '$LOG', '$CH', '$POS', '$OBS', '$LNAV', '$CNAV',
-        '$CNV2', '$GSTR', '$INAV', '$FNAV', '$L6FRM', '$BCNV', '$IRNV', '$SBAS')
+        '$CNV2', '$GSTR', '$INAV', '$FNAV', '$L6FRM', '$BCNV', '$IRNV', '$SBAS',
+        '$NET')
     p = Obj()
     p.parent = parent
     p.panel = Frame(parent, bg=BG_COLOR1)
@@ -14,6 +14,7 @@
 #  2023-12-28  1.3  change receiver channel status format
 #  2024-01-12  1.4  support multiple signals
 #  2024-02-06  1.5  separate plot functions to sdr_ch_plot.py
+#  2026-10-15  1.6  track signals by receiver channels of libsdr, add option -py
 #
 import sys, math, time, datetime
 import numpy as np
@@ -38,6 +39,8 @@ def read_data(fp, N, IQ, buff, ix):
     
     if len(raw) < N * IQ:
         return False
+    elif not isinstance(buff, np.ndarray): # IF data buffer of libsdr
+        buff_write(buff, ix, raw, IQ)
     elif IQ == 1: # I
         buff[ix:ix+N] = np.array(raw, dtype='complex64')
     else: # IQ (Q sign inverted in MAX2771)
@@ -61,6 +64,8 @@ def print_head(ch):
 
 # receiver channel sync status -------------------------------------------------
 def sync_stat(ch):
+    if ch.c:
+        return ch.sync
     return (('S' if ch.trk.sec_sync > 0 else '-') +
         ('B' if ch.nav.ssync > 0 else '-') +
         ('F' if ch.nav.fsync > 0 else '-') +
@@ -75,6 +80,8 @@ def print_stat(no, ch):
 
 # update receiver channel status -----------------------------------------------
 def update_stat(prns, ch, nrow):
+    for i in range(len(ch)):
+        sdr_ch.ch_stat(ch[i])
     for i in range(nrow):
         print('%s' % (ESC_UCUR), end='')
     n = 2
@@ -96,7 +103,7 @@ def cn0_bar(cn0):
 def show_usage():
     print('Usage: pocket_trk.py [-sig sig -prn prn[,...] ...] [-p] [-e] [-toff toff]')
     print('       [-f freq] [-fi freq] [-IQ] [-ti tint] [-ts tspan] [-yl ylim]')
-    print('       [-log path] [-q] [file]')
+    print('       [-log path] [-q] [-py] [file]')
     exit()
 
 #-------------------------------------------------------------------------------
@@ -105,7 +112,7 @@ def show_usage():
 # 
 #     pocket_trk.py [-sig sig -prn prn[,...] ...] [-p] [-e] [-toff toff]
 #         [-f freq] [-fi freq] [-IQ] [-ti tint] [-ts tspan] [-yl ylim]
-#         [-log path] [-q] [file]
+#         [-log path] [-q] [-py] [file]
 # 
 #   Description
 # 
@@ -175,6 +182,11 @@ def show_usage():
 #     -q
 #         Suppress showing signal tracking status.
 #
+#     -py
+#         Track signals by the receiver channels in Python instead of the ones
+#         in libsdr. The channels in Python are always used with the option -p,
+#         without libsdr or for the signals with different code cycles.
+#
 #     [file]
 #         A file path of the input digital IF data. The format should be a
 #         series of int8_t (signed byte) for real-sampling (I-sampling),
@@ -188,7 +200,7 @@ if __name__ == '__main__':
     sigs, prns = [], []
     fs, fi, IQ, toff, tint, tspan, ylim = 12e6, 0.0, 1, 0.0, 0.1, 1.0, 0.3
     ch = {}
-    file, log_file, log_lvl, quiet = '', '', 4, 0
+    file, log_file, log_lvl, quiet, py = '', '', 4, 0, False
     fig = None
     
     i = 1
@@ -232,6 +244,8 @@ if __name__ == '__main__':
             log_file = sys.argv[i]
         elif sys.argv[i] == '-q':
             quiet = 1
+        elif sys.argv[i] == '-py':
+            py = True
         elif sys.argv[i][0] == '-':
             show_usage()
         else:
@@ -254,20 +268,29 @@ if __name__ == '__main__':
             print('file open error: %s' % (file))
             exit()
     
+    # receiver channels of libsdr if available
+    use_c = not py and not plot and libsdr != None and \
+        all([sdr_code.code_cyc(s) == T for s in sigs])
+    
     for i in range(len(prns)):
         ncorr = NCORR_PLOT if plot and i == 0 else 0
-        ch[i] = sdr_ch.ch_new(sigs[i], prns[i], fs, fi, add_corr=ncorr)
-        ch[i].state = 'SRCH'
+        ch[i] = sdr_ch.ch_new_c(sigs[i], prns[i], fs, fi) if use_c else None
+        if ch[i] == None:
+            ch[i] = sdr_ch.ch_new(sigs[i], prns[i], fs, fi, add_corr=ncorr)
+        sdr_ch.ch_search(ch[i])
     
     if plot:
         fig = sdr_ch_plot.init(env, p3d, toff, tspan, ylim)
     
     if log_file != '':
-        log_open(log_file)
+        log_open(log_file, lib=use_c)
         log_level(log_lvl)
     
     N = int(T * fs)
-    buff = np.zeros(N * (MAX_BUFF + 1), dtype='complex64')
+    if use_c:
+        buff = buff_new(N * MAX_BUFF, IQ)
+    else:
+        buff = np.zeros(N * (MAX_BUFF + 1), dtype='complex64')
     ix = 0
     nrow = 0
     tt = time.time()
@@ -284,7 +307,7 @@ if __name__ == '__main__':
             
             if i == 0:
                 continue
-            elif i % MAX_BUFF == 0:
+            elif i % MAX_BUFF == 0 and not use_c:
                 buff[-N:] = buff[:N]
             
             # update receiver channel
@@ -295,8 +318,7 @@ if __name__ == '__main__':
             if i % int(CYC_SRCH / T) == 0:
                 for j in range(len(ch)):
                     ix = (ix + 1) % len(ch)
-                    if ch[ix].state == 'IDLE':
-                        ch[ix].state = 'SRCH'
+                    if sdr_ch.ch_search(ch[ix]):
                         break
             
             # update log
@@ -320,6 +342,8 @@ if __name__ == '__main__':
                     ch[0].sig, ch[0].prn, file, ch[0].time))
             
             for j in range(len(prns)):
+                if quiet:
+                    sdr_ch.ch_stat(ch[j])
                 if ch[j].state != 'LOCK':
                     continue
                 log(3, '$CH,%.3f,%s,%d,%d,%.1f,%.9f,%.3f,%.3f,%d,%d' %
@@ -338,6 +362,9 @@ if __name__ == '__main__':
     if fp != None:
         fp.close()
     
+    if use_c:
+        buff_free(buff)
+    
     if log_file != '':
         log_close()
     
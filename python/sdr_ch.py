@@ -8,6 +8,8 @@
 #  2021-12-24  1.0  new
 #  2022-01-13  1.1  support tracking of L6D, L6E
 #  2022-02-15  1.2  update ch state by external trigger
+#  2026-10-15  1.3  add receiver channel by libsdr, add API ch_new_c(),
+#                   ch_stat(), ch_search()
 #
 from math import *
 import numpy as np
@@ -75,8 +77,73 @@ def ch_new(sig, prn, fs, fi, max_dop=MAX_DOP, sp_corr=SP_CORR, add_corr=0,
     ch.acq = acq_new(ch.code, ch.T, fs, ch.N, max_dop)
     ch.trk = trk_new(ch.sig, ch.prn, ch.code, ch.T, fs, sp_corr, add_corr)
     ch.nav = sdr_nav.nav_new(nav_opt)
+    ch.c = None                     # receiver channel of libsdr
     return ch
 
+#-------------------------------------------------------------------------------
+#  Generate new receiver channel by libsdr. The channel is updated by
+#  ch_update() with IF data buffer of libsdr (see buff_new()) instead of
+#  complex64 ndarray. The status of the channel as the instance variables
+#  (state, time, sat, lock, cn0, coff, fd, adr, lost, nav.count, nav.nerr and
+#  sync) are refreshed by ch_stat().
+#
+#  args:
+#      sig      (I) Signal type as string ('L1CA', 'L1CB', 'L1CP', ....)
+#      prn      (I) PRN number
+#      fs       (I) Sampling frequency (Hz)
+#      fi       (I) IF frequency (Hz)
+#
+#  returns:
+#      ch       Receiver channel (None: libsdr not available)
+#
+def ch_new_c(sig, prn, fs, fi):
+    if not libsdr or not LIBSDR_ENA or not hasattr(libsdr, 'sdr_ch_get_view'):
+        return None
+    libsdr.sdr_ch_new.argtypes = (c_char_p, c_int32, c_double, c_double)
+    libsdr.sdr_ch_new.restype = c_void_p
+    c = libsdr.sdr_ch_new(sig.upper().encode(), prn, fs, fi)
+    if not c:
+        return None
+    ch = Obj()
+    ch.c = c
+    ch.sig = sig.upper()
+    ch.prn = prn
+    ch.T = sdr_code.code_cyc(sig)
+    ch.view = sdr_ch_view_t()
+    ch.nav = Obj()
+    ch_stat(ch)
+    return ch
+
+# refresh status of receiver channel by libsdr ---------------------------------
+def ch_stat(ch):
+    if not ch.c:
+        return
+    libsdr.sdr_ch_get_view.argtypes = (c_void_p, POINTER(sdr_ch_view_t))
+    libsdr.sdr_ch_get_view(ch.c, byref(ch.view))
+    v = ch.view
+    ch.state = ('IDLE', 'IDLE', 'SRCH', 'LOCK')[v.state]
+    ch.time = v.time
+    ch.sat = v.sat.decode()
+    ch.lock = int(v.lock / ch.T + 0.5)
+    ch.cn0, ch.coff, ch.fd, ch.adr = v.cn0, v.coff * 1e-3, v.fd, v.adr
+    ch.lost = v.lost
+    ch.sync = v.sync.decode()
+    ch.nav.count = [v.nnav, v.nerr]
+    ch.nav.nerr = v.fec
+
+# start signal search of IDLE receiver channel ---------------------------------
+def ch_search(ch):
+    if ch.c:
+        libsdr.sdr_ch_search.argtypes = (c_void_p,)
+        if not libsdr.sdr_ch_search(ch.c):
+            return False
+        ch.state = 'SRCH'
+    elif ch.state == 'IDLE':
+        ch.state = 'SRCH'
+    else:
+        return False
+    return True
+
 #-------------------------------------------------------------------------------
 #  Update a receiver channel. A receiver channel is a state machine which has
 #  the following internal states indicated as ch.state. By calling the function,
@@ -102,7 +169,10 @@ def ch_new(sig, prn, fs, fi, max_dop=MAX_DOP, sp_corr=SP_CORR, add_corr=0,
 #      None
 #
 def ch_update(ch, time, buff, ix):
-    if ch.state == 'SRCH':
+    if ch.c: # libsdr
+        libsdr.sdr_ch_update.argtypes = (c_void_p, c_double, c_void_p, c_int32)
+        libsdr.sdr_ch_update(ch.c, time, buff, ix)
+    elif ch.state == 'SRCH':
         search_sig(ch, time, buff, ix)
     elif ch.state == 'LOCK':
         track_sig(ch, time, buff, ix)
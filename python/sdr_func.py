@@ -16,6 +16,10 @@
 #                   support np.fromfile() without offset option
 #  2023-12-27  1.6  support API changes of sdr_func.c
 #  2024-04-04  1.7  support API changes of sdr_func.c
+#  2026-10-15  1.8  use external library for search_code()
+#                   add API search_code_multi(), buff_new(), buff_write(),
+#                   buff_free(), add type sdr_ch_view_t
+#                   output log by libsdr (log_open(..., lib=True))
 #
 from math import *
 from ctypes import *
@@ -47,10 +51,20 @@ else:
 DOP_STEP = 0.5     # Doppler frequency search step (* 1 / code cycle)
 LIBSDR_ENA = True  # enable flag of LIBSDR
 
+# receiver channel status view (see sdr_ch_view_t in pocket_sdr.h) ------------
+class sdr_ch_view_t(Structure):
+    _fields_ = [('no', c_int32), ('rf_ch', c_int32), ('prn', c_int32),
+        ('state', c_int32), ('sat', c_char * 8), ('sig', c_char * 8),
+        ('sync', c_char * 8), ('time', c_double), ('lock', c_double),
+        ('cn0', c_double), ('coff', c_double), ('fd', c_double),
+        ('adr', c_double), ('nnav', c_int32), ('nerr', c_int32),
+        ('lost', c_int32), ('fec', c_int32)]
+
 # global variable --------------------------------------------------------------
 carr_tbl = []      # carrier lookup table 
 log_lvl = 3        # log level
 log_str = None     # log stream
+log_lib = False    # output log by libsdr
 
 #-------------------------------------------------------------------------------
 #  Read digitalized IF (inter-frequency) data from file. Supported file format
@@ -101,6 +115,8 @@ def read_data(file, fs, IQ, T, toff=0.0):
 #
 def search_code(code_fft, T, buff, ix, fs, fi, fds):
     N = int(fs * T)
+    if libsdr and LIBSDR_ENA:
+        return search_code_multi([code_fft], T, buff, ix, fs, fi, fds)[0]
     P = np.zeros((len(fds), N), dtype='float32')
     
     for i in range(len(fds)):
@@ -108,6 +124,34 @@ def search_code(code_fft, T, buff, ix, fs, fi, fds):
         P[i] = np.abs(C) ** 2
     return P
 
+#-------------------------------------------------------------------------------
+#  Parallel code search of multiple codes in digitized IF data. The FFT of IF
+#  data is shared by the codes (e.g. all PRNs of a signal) with libsdr.
+#
+#  args:
+#      code_ffts (I) Code DFTs of codes (same length)
+#      T, ..., fds (I) Same as search_code()
+#
+#  returns:
+#      Ps       Correlation powers of codes (see search_code())
+#
+def search_code_multi(code_ffts, T, buff, ix, fs, fi, fds):
+    if not libsdr or not LIBSDR_ENA:
+        return [search_code(c, T, buff, ix, fs, fi, fds) for c in code_ffts]
+    N, M = int(fs * T), len(code_ffts[0])
+    code_ffts = [np.ascontiguousarray(c, dtype='complex64') for c in code_ffts]
+    Ps = [np.zeros((len(fds), M), dtype='float32') for c in code_ffts]
+    c_codes = (c_void_p * len(code_ffts))(*[c.ctypes.data for c in code_ffts])
+    c_Ps = (c_void_p * len(Ps))(*[P.ctypes.data for P in Ps])
+    libsdr.sdr_search_code_multi_cpx.argtypes = [POINTER(c_void_p), c_int32,
+        c_double, ctypeslib.ndpointer('complex64'), c_int32, c_int32, c_int32,
+        c_double, c_double, ctypeslib.ndpointer('float32'), c_int32,
+        POINTER(c_void_p)]
+    libsdr.sdr_search_code_multi_cpx(c_codes, len(code_ffts), T, buff,
+        len(buff), ix, M, fs, fi, np.array(fds, dtype='float32'), len(fds),
+        c_Ps)
+    return [P[:,:N] for P in Ps]
+
 # max correlation power and C/N0 -----------------------------------------------
 def corr_max(P, T):
     ix = np.unravel_index(np.argmax(P), P.shape)
@@ -168,6 +212,23 @@ def corr_fft(buff, ix, N, fs, fc, phi, code_fft):
         data = mix_carr(buff, ix, N, fs, fc, phi)
         return corr_fft_(data, code_fft)
 
+# new IF data buffer of libsdr -------------------------------------------------
+def buff_new(N, IQ):
+    libsdr.sdr_buff_new.argtypes = (c_int32, c_int32)
+    libsdr.sdr_buff_new.restype = c_void_p
+    return libsdr.sdr_buff_new(N, IQ)
+
+# write int8 IF data (I or IQ-sampling) to IF data buffer of libsdr ------------
+def buff_write(buff, ix, raw, IQ):
+    libsdr.sdr_buff_write_int8.argtypes = (c_void_p, c_int32,
+        ctypeslib.ndpointer('int8'), c_int32, c_int32)
+    libsdr.sdr_buff_write_int8(buff, ix, raw, len(raw) // IQ, IQ)
+
+# free IF data buffer of libsdr ------------------------------------------------
+def buff_free(buff):
+    libsdr.sdr_buff_free.argtypes = (c_void_p,)
+    libsdr.sdr_buff_free(buff)
+
 # mix carrier ------------------------------------------------------------------
 def mix_carr(buff, ix, N, fs, fc, phi):
     global carr_tbl
@@ -206,8 +267,12 @@ def psd(data, N, fs, IQ):
     return psd
 
 # open log ---------------------------------------------------------------------
-def log_open(path):
-    global log_str
+def log_open(path, lib=False):
+    global log_str, log_lib
+    if lib and libsdr: # log stream of libsdr shared with C functions
+        libsdr.sdr_log_open.argtypes = (c_char_p,)
+        log_lib = libsdr.sdr_log_open(path.encode()) != 0
+        return
     m = re.search(r'([^:]*):([^:]+)', path)
     if not m: # file
         log_str = sdr_rtk.stropen(sdr_rtk.STR_FILE, sdr_rtk.STR_MODE_W, path)
@@ -220,7 +285,11 @@ def log_open(path):
 
 # close log --------------------------------------------------------------------
 def log_close():
-    global log_str
+    global log_str, log_lib
+    if log_lib:
+        libsdr.sdr_log_close()
+        log_lib = False
+        return
     sdr_rtk.strclose(log_str)
     log_str = None
 
@@ -228,12 +297,18 @@ def log_close():
 def log_level(level):
     global log_lvl
     log_lvl = level
+    if log_lib:
+        libsdr.sdr_log_level.argtypes = (c_int32,)
+        libsdr.sdr_log_level(level)
 
 # output log -------------------------------------------------------------------
 def log(level, msg):
     global log_str, log_lvl
     if log_lvl == 0:
         print(msg)
+    elif log_lib and level <= log_lvl:
+        # variadic sdr_log() called without argtypes
+        libsdr.sdr_log(c_int32(level), c_char_p(b'%s'), c_char_p(msg.encode()))
     elif log_str and level <= log_lvl:
         buff = np.frombuffer((msg + '\r\n').encode(), dtype='uint8')
         sdr_rtk.strwrite(log_str, buff)
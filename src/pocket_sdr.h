@@ -17,12 +17,107 @@
 //  2024-04-28  1.9  update constants, types and API
 //  2024-05-28  1.10 update constants, types and APIs
 //  2024-07-01  1.11 import pocket_dev.h
+//  2026-10-14  1.12 add type sdr_hist_t
+//                   add API sdr_set_simd(), sdr_get_simd()
+//                   add API sdr_set_mix(), sdr_get_mix()
+//                   add API sdr_scratch_alloc(), sdr_scratch_free(),
+//                   sdr_scratch_release()
+//                   add API sdr_fftw_plan_opt(), sdr_search_code_multi()
+//                   add API sdr_buff_new_pack(), sdr_buff_get()
+//                   add packed IF data to sdr_buff_t
+//                   add type sdr_pacc_t
+//                   add API sdr_pacc_new(), sdr_pacc_free(),
+//                   sdr_search_code_pacc(), sdr_pacc_corr_max(),
+//                   sdr_pacc_fine_dop()
+//                   add type sdr_wk_t, add API sdr_get_ncpu()
+//                   add API sdr_cond_wait(), sdr_dev_wait()
+//                   add API sdr_buff_write_raw(), add type sdr_unpack_t
+//                   add API sdr_dev_view(), sdr_dev_release()
+//                   add API sdr_rcv_read_tag()
+//                   add API sdr_ch_suspend(), sdr_ch_resume()
+//                   add API sdr_malloc_huge(), sdr_free_huge(),
+//                   sdr_get_nnode(), sdr_buff_new_mem()
+//                   add API sdr_set_thread(), sdr_rcv_setaff()
+//                   add API sdr_corr_nco(), add code NCO to sdr_trk_t
+//                   add type sdr_sig_t, add API sdr_sig_desc()
+//                   reorder sdr_ch_t and sdr_trk_t to pack hot loop state
+//                   add API sdr_corr_fft_share()
+//                   add type sdr_vit_t, add streaming Viterbi to sdr_nav_t
+//                   add API sdr_vit_new(), sdr_vit_free(), sdr_vit_init(),
+//                   sdr_vit_update(), sdr_vit_decode(), sdr_encode_rs()
+//                   add packed nav symbols ring buffer to sdr_nav_t
+//                   add API sdr_nav_start(), sdr_nav_stop()
+//                   add nav_async to sdr_rcv_t
+//                   add PVT thread to sdr_rcv_t, add API sdr_pvt_wait()
+//                   modify API sdr_pvt_udsol()
+//                   add type sdr_obsr_t, sdr_obss_t, sdr_epoch_t
+//                   add observation slots of channels to sdr_pvt_t
+//                   add type sdr_satc_t, add satellite cache to sdr_pvt_t
+//                   add type sdr_str_t, add API sdr_str_async()
+//                   add raw data buffer overrun and transfer error counters
+//                   to sdr_dev_t, add API sdr_dev_get_stat()
+//                   add number and size of USB transfers to sdr_dev_t
+//                   modify API sdr_dev_start()
+//                   add start time to sdr_dev_t, add API sdr_get_clock()
+//                   support multiple SDR devices in sdr_rcv_t, add API
+//                   sdr_rcv_new_ndev(), sdr_rcv_open_ndev()
+//                   add IF data format SDR_FMT_PACK, add API sdr_pack_raw()
+//                   add type sdr_ifz_t, sdr_iff_t, add compressed IF data
+//                   encoder to sdr_str_t, add API sdr_ifz_new(),
+//                   sdr_ifz_write(), sdr_ifz_skip(), sdr_ifz_free(),
+//                   sdr_ifz_read_tag(),
+//                   sdr_iff_open(), sdr_iff_close(), sdr_iff_seek(),
+//                   sdr_iff_read(), sdr_str_ifz(), sdr_rcv_gen_tag()
+//                   add API sdr_iff_view(), sdr_iff_get()
+//                   add API sdr_fftw_plan()
+//                   add API sdr_gen_code_cache(), sdr_code_cache_open(),
+//                   sdr_code_cache_close(), sdr_code_cache_get()
+//                   add type sdr_ch_view_t, sdr_rcv_view_t, add API
+//                   sdr_rcv_view(), sdr_rcv_view_update()
+//                   add API sdr_buff_write_int8(), sdr_search_code_cpx(),
+//                   sdr_search_code_multi_cpx(), sdr_ch_search(),
+//                   sdr_ch_get_view(), add time to sdr_ch_view_t
+//                   add API sdr_dev_set_mask()
+//                   add type sdr_ddc_t, add API sdr_ddc_new(), sdr_ddc_proc(),
+//                   sdr_ddc_free(), add DDCs to sdr_rcv_t, add IF data buffer
+//                   of channel to sdr_ch_th_t
+//                   add API sdr_set_acq_gpu(), sdr_gpu_open(), sdr_gpu_close(),
+//                   sdr_gpu_data(), sdr_gpu_corr()
+//                   add type sdr_mon_t, add IF data monitors to sdr_rcv_t
+//                   add type sdr_sat_snap_t, sdr_rcv_snap_t, add status
+//                   snapshot to sdr_rcv_t, add API sdr_rcv_snapshot(),
+//                   sdr_rcv_snap_rcv_str(), sdr_rcv_snap_ch_str(),
+//                   sdr_rcv_snap_sat_str()
+//                   add type sdr_opt_t, add options to sdr_ch_t, sdr_pvt_t and
+//                   sdr_rcv_t, add API sdr_ch_new_opt(), sdr_rcv_defopt()
+//                   add type sdr_warm_t, add warm start state to sdr_rcv_t
+//                   add CPU time of stages to sdr_ch_t and sdr_rcv_t, add API
+//                   sdr_get_cputime(), sdr_rcv_cpu_time()
+//                   add CPU time of obs update and histogram of observation age
+//                   to sdr_ch_t, add type sdr_ch_prof_t, add channel profiles
+//                   to sdr_rcv_snap_t, add API sdr_rcv_snap_prof_str()
+//                   add API sdr_trace_start(), sdr_trace_stop(),
+//                   sdr_trace_begin(), sdr_trace_end(), sdr_trace_name(),
+//                   sdr_trace_dump()
+//                   add load shedding options, states and level to sdr_opt_t,
+//                   sdr_ch_t, sdr_rcv_t and sdr_rcv_snap_t
+//                   add handover between bands of satellite to sdr_acq_t,
+//                   add channel groups of satellites to sdr_rcv_t
+//                   add type sdr_net_t, add API sdr_net_open(),
+//                   sdr_net_close(), sdr_net_write(), sdr_net_read(),
+//                   sdr_net_tag(), sdr_net_stat(), sdr_rcv_open_net(),
+//                   add SDR device SDR_DEV_NET
+//                   add folded acquisition to sdr_acq_t, move sdr_buff_t and
+//                   sdr_ddc_t before sdr_acq_t
+//                   add incremental secondary code sync to sdr_trk_t
+//                   add type sdr_reader_t, add IF data reader to sdr_rcv_t
 //
 #ifndef POCKET_SDR_H
 #define POCKET_SDR_H
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
 #include <stdint.h>
 #include <time.h>
@@ -42,22 +137,42 @@ extern "C" {
 
 // constants and macros ------------------------------------------------------
 #define SDR_MAX_RFCH   8        // max number of RF channels in a SDR device
+#define SDR_MAX_NDEV   4        // max number of SDR devices in a SDR receiver
+#define SDR_MAX_NRF    (SDR_MAX_RFCH * SDR_MAX_NDEV) // max number of RF
+                                // channels in a SDR receiver
 #define SDR_MAX_REG    11       // max number of registers in a SDR device
-#define SDR_MAX_BUFF   96       // number of IF data buffer
-#define SDR_SIZE_BUFF  (1<<16)  // size of IF data buffer (bytes)
+#define SDR_MAX_BUFF   96       // default number of IF data buffer
+#define SDR_SIZE_BUFF  (1<<16)  // default size of IF data buffer (bytes)
+#define SDR_MAX_VIEW   (1<<18)  // max size of IF data view (bytes)
+#define SDR_MAX_TAG    1024     // max length of tag of IF data
+#define SDR_IFZ_CHUNK  0.1      // chunk length of compressed IF data (s)
+#define SDR_IFZ_NSLOT  8        // number of decoded chunk slots
+#define SDR_IFZ_MAX_TH 8        // max number of chunk decode threads
+#define SDR_MAX_GAP    64       // max number of gaps in output queue
+#define SDR_NET_PKT    8192     // default payload size of net data packets
+#define SDR_NET_MAX_PKT 60000   // max payload size of net data packets
 
 #define SDR_MAX_NPRN   256      // max number of PRNs
 #define SDR_MAX_NCH    999      // max number of receiver channels
+#define SDR_MAX_NWK    64       // max number of receiver worker threads
+#define SDR_MAX_NDDC   32       // max number of DDCs in a SDR receiver
 #define SDR_MAX_NSYM   2000     // max number of symbols
+#define SDR_NSYM_W     64       // number of words of packed nav symbols
 #define SDR_MAX_DATA   4096     // max length of navigation data
 #define SDR_N_CORR     (4+81)   // number of correlators
 #define SDR_N_HIST     5000     // number of P correlator history 
+#define SDR_N_PSD      2048     // max number of PSD points in status view
+#define SDR_VIEW_VER   2        // version of receiver status view
+#define SDR_SNAP_VER   2        // version of receiver status snapshot
+#define SDR_MAX_NSAT   128      // max number of satellites in snapshot
+#define SDR_N_LAT      10       // number of bins of observation age histogram
 #define SDR_CSCALE    (1/24.0f) // carrier scale (max(IQ)*sqrt(2)/scale<127)
 #define SDR_CYC        1e-3     // IF data processing cycle (s)
 #define PI 3.1415926535897932   // pi 
 
 #define SDR_DEV_FILE   1        // SDR device: file
 #define SDR_DEV_USB    2        // SDR device: USB device
+#define SDR_DEV_NET    3        // SDR device: network IF data stream
 
 #define SDR_DEV_NAME   "Pocket SDR" // SDR device name 
 #define SDR_DEV_VID    0x04B4   // SDR USB device vendor ID 
@@ -73,17 +188,31 @@ extern "C" {
 #define SDR_VR_STOP    0x45     // SDR USB vendor request: Stop bulk transfer
 #define SDR_VR_RESET   0x46     // SDR USB vendor request: Reset device
 #define SDR_VR_SAVE    0x47     // SDR USB vendor request: Save settings
+#define SDR_VR_CH_MASK 0x4C     // SDR USB vendor request: Set RF channel mask
 
 #define SDR_FMT_INT8   1        // SDR IF data format: int8 (I)
 #define SDR_FMT_INT8X2 2        // SDR IF data format: int8 x 2 complex (IQ)
 #define SDR_FMT_RAW8   3        // SDR IF data format: packed 8 bits raw  (2CH)
 #define SDR_FMT_RAW16  4        // SDR IF data format: packed 16 bits raw (4CH)
 #define SDR_FMT_RAW16I 5        // SDR IF data format: packed 16 bits raw (8CH)
+#define SDR_FMT_PACK   6        // SDR IF data format: packed 4 bits codes (2 x
+                                // 2 bits I/Q) of a RF channel (2 samples/byte)
 
 #define SDR_STATE_IDLE 1        // SDR channel state: idle
 #define SDR_STATE_SRCH 2        // SDR channel state: search
 #define SDR_STATE_LOCK 3        // SDR channel state: lock
 
+#define SDR_CORR_STD   0        // SDR correlator type: standard
+#define SDR_CORR_FFT   1        // SDR correlator type: FFT (L6D/E CSK)
+
+#define SDR_NAV_NONE   0        // SDR nav data type: none
+#define SDR_NAV_LNAV   1        // SDR nav data type: GPS/QZS LNAV
+#define SDR_NAV_GLO    2        // SDR nav data type: GLO NAV
+#define SDR_NAV_INAV   3        // SDR nav data type: GAL I/NAV
+#define SDR_NAV_FNAV   4        // SDR nav data type: GAL F/NAV
+#define SDR_NAV_BDS    5        // SDR nav data type: BDS D1/D2 NAV
+#define SDR_NAV_IRN    6        // SDR nav data type: NavIC NAV
+
 #define SDR_CPX8(re, im) (sdr_cpx8_t)(((int8_t)(im)<<4)|(((int8_t)((re)<<4)>>4)&0xF))
 #define SDR_CPX8_I(x)  ((int8_t)((x)<<4)>>4)
 #define SDR_CPX8_Q(x)  ((int8_t)((x)<<0)>>4)
@@ -106,37 +235,174 @@ typedef struct {                // SDR device type
     sdr_usb_t *usb;             // USB device
     int state;                  // state of USB event handler
     int64_t rp, wp;             // read/write pointer of raw data buffer
+    int64_t nerr, nover, ndrop; // number of transfer errors, overruns and
+                                // dropped bytes
+    int nwait;                  // waiting for raw data arrival
     uint8_t *buff;              // raw data buffer
+    int dma;                    // raw data buffer by libusb_dev_mem_alloc()
+    int nbuff, size;            // number and size of USB transfers (bytes)
+    int64_t len;                // size of raw data buffer (bytes)
+    uint32_t tick;              // time of last USB transfer completion (ms)
+    int lat;                    // max interval of USB transfer completions (ms)
+    double tstart;              // host time of start request (s)
 #ifndef WIN32
-    struct libusb_transfer *transfer[SDR_MAX_BUFF]; // USB transfers
+    struct libusb_transfer **transfer; // USB transfers
+    int64_t nsub;               // number of submitted USB transfers
 #endif
     pthread_t thread;           // USB event handler thread
     pthread_mutex_t mtx;        // lock flag
+    pthread_cond_t cond;        // raw data arrival condition
 } sdr_dev_t;
 
+typedef struct {                // compressed IF data encoder type
+    int lanes;                  // number of byte lanes (bytes of a sample)
+    int chunk;                  // size of chunk (bytes)
+    uint8_t *buff;              // IF data buffer of chunk
+    int len;                    // length of IF data in chunk (bytes)
+    uint8_t *out;               // encoded chunk buffer
+    uint32_t seq;               // sequence number of chunk
+    int64_t pos;                // output position (bytes)
+    uint8_t *idx;               // index entries of output chunks
+    int nidx, nmax;             // number of and allocated index entries
+    int (*write)(void *, const uint8_t *, int); // output function
+    void *arg;                  // argument of output function
+} sdr_ifz_t;
+
+typedef struct {                // IF data file type
+    FILE *fp;                   // file pointer
+    int comp;                   // compressed IF data file (0:no,1:yes)
+    char tag[SDR_MAX_TAG];      // tag of compressed IF data file
+    int chunk, lanes;           // size of chunk (bytes) and byte lanes
+    int nchunk;                 // number of chunks
+    int64_t *off;               // file offsets of chunks (-1: lost chunk)
+    int64_t size;               // size of IF data (bytes)
+    int64_t pos;                // read position of IF data (bytes)
+    uint8_t *data[SDR_IFZ_NSLOT]; // decoded chunk slots
+    int64_t seq[SDR_IFZ_NSLOT]; // chunks of slots
+    int stat[SDR_IFZ_NSLOT];    // states of slots (0:free,1:decode,2:ready)
+    int64_t next;               // next chunk to decode
+    int state;                  // state of decode threads (0:stop,1:run)
+    int nth;                    // number of decode threads
+    pthread_t thread[SDR_IFZ_MAX_TH]; // decode threads
+    pthread_mutex_t mtx;        // lock flag of slots
+    pthread_mutex_t fmtx;       // lock flag of file
+    pthread_cond_t cond;        // slot state change condition
+    const uint8_t *map;         // mapped plain IF data file (NULL: no map)
+    int64_t adv, rel;           // read-ahead and released positions of map
+} sdr_iff_t;
+
+typedef struct {                // output stream type
+    stream_t str;               // stream
+    sdr_ifz_t *ifz;             // compressed IF data encoder (NULL: none)
+    uint8_t *buff;              // output queue (NULL: synchronous write)
+    int size;                   // size of output queue (bytes)
+    int64_t wp, rp;             // write and read pointers of queue (bytes)
+    int64_t nout, ndrop;        // number of output and dropped bytes
+    int64_t gap[SDR_MAX_GAP][2]; // gaps of dropped IF data {pos,size} (bytes)
+    int ngap;                   // number of gaps
+    int state;                  // state of writer thread (0:stop,1:run)
+    pthread_t thread;           // writer thread
+    pthread_mutex_t mtx;        // lock flag of queue
+    pthread_cond_t cond;        // queue data arrival condition
+} sdr_str_t;
+
+typedef struct {                // network IF data stream type
+    int type;                   // stream type (1:TCP,2:UDP,3:shared memory)
+    int mode;                   // stream mode (0:send,1:receive)
+    stream_t str;               // stream of TCP or UDP
+    uint8_t *shm;               // mapped ring of shared memory (NULL: none)
+    int64_t shm_size;           // size of ring of shared memory (bytes)
+    int64_t rp;                 // read pointer of ring of shared memory
+    char name[256];             // name of shared memory
+    char tag[SDR_MAX_TAG];      // tag of IF data ("": not received)
+    int psize;                  // payload size of data packets (bytes)
+    uint32_t seq;               // sequence number of next data packet
+    int sync, skip;             // sequence synchronized and resync of packets
+    uint8_t *pkt;               // packet buffer (send) or input buffer (recv)
+    int npkt;                   // bytes in packet or input buffer
+    uint8_t *out;               // received IF data
+    int nout, size_out;         // size of received IF data and allocated size
+    int64_t stat[4];            // statistics (see sdr_net_stat())
+} sdr_net_t;
+
+typedef struct {                // history buffer type
+    uint8_t *data;              // data (mirrored ring buffer: 2 * len items)
+    int len;                    // length of history (items)
+    int size;                   // size of item (bytes)
+    int p;                      // index of oldest item
+} sdr_hist_t;
+
+typedef struct {                // compact correlation power accumulator type
+    uint16_t *P;                // quantized sum of powers (M x N)
+    float *scale;               // power scale of Doppler bins (M)
+    float *P_max;               // upper bound of sum of Doppler bins (M)
+    int N, M;                   // number of code offsets and Doppler bins
+} sdr_pacc_t;
+
+typedef struct {                // IF data buffer type
+    sdr_cpx8_t *data;           // IF data
+    int IQ, N;                  // sampling types (1:I,2:IQ) and buffer size
+    int pack;                   // packed 4-bit sample codes (0:off,1:on)
+    sdr_cpx8_t dec[16];         // decode table of packed sample codes
+    size_t msize;               // mapped memory size (0: sdr_malloc())
+} sdr_buff_t;
+
+typedef struct {                // digital down converter (DDC) type
+    int D;                      // decimation factor
+    int K;                      // half length of filter (samples)
+    int L;                      // number of filter taps (padded to 8x)
+    double fs, fc;              // input sampling rate and center freq (Hz)
+    double phi;                 // carrier phase at next input (cyc)
+    int16_t *h;                 // filter taps for I and Q (2 x 2L)
+    float scale;                // output scale by AGC (0: not set)
+} sdr_ddc_t;
+
 typedef struct {                // signal acquisition type 
     sdr_cpx_t *code_fft;        // code FFT 
     float *fds;                 // Doppler bins 
     int len_fds;                // length of Doppler bins 
     float fd_ext;               // Doppler external assist
+    int hand;                   // handover by other band of satellite (0/1)
+    double hand_rx, hand_tx;    // receive and transmit time of code start of
+                                // other band for handover (s)
+    double t_hand;              // time of last handover (s)
+    sdr_ddc_t *ddc;             // DDC of folded acquisition (NULL: no fold)
+    sdr_buff_t *buff;           // folded IF data buffer (2 code cycles)
     float *P_sum;               // sum of correlation powers 
+    sdr_pacc_t *P_acc;          // compact sum of correlation powers
     int n_sum;                  // number of sum 
 } sdr_acq_t;
 
 typedef struct {                // signal tracking type 
-    int npos;                   // number of correlator position
-    int pos[SDR_N_CORR];        // correlator positions 
-    sdr_cpx_t C[SDR_N_CORR];    // correlations 
-    sdr_cpx_t P[SDR_N_HIST];    // history of P correlations 
-    int sec_sync;               // secondary code sync status 
-    int sec_pol;                // secondary code polarity 
+    // hot loop state updated in every code cycle (keep at head)
     double err_phas;            // phase error (cyc) 
     double err_code;            // code error (chip) 
     double sumP, sumE, sumL, sumN; // sum of correlations 
+    int sec_sync;               // secondary code sync status 
+    int sec_pol;                // secondary code polarity 
+    float sec_sum;              // sum of P correlations in sec-code period
+    int npos;                   // number of correlator position
+    int nco;                    // code NCO correlator (0:code bank,1:NCO)
     sdr_cpx16_t *code;          // resampled code 
     sdr_cpx_t *code_fft;        // code FFT
+    uint64_t sec_hash;          // rolling hash of signs of P correlations
+    uint64_t *sec_bits;         // signs of P correlations (ring of sec-code
+                                // length bits)
+    int sec_n, sec_lock;        // number of signs in rolling hash and lock
+                                // count of last sign
+    void *sec_tbl;              // sync table of sec-code phases
+    sdr_hist_t *P;              // history of P correlations (SDR_N_HIST)
+    sdr_cpx_t C[SDR_N_CORR];    // correlations (C[0-3]: P,E,L,N) 
+    int pos[SDR_N_CORR];        // correlator positions 
 } sdr_trk_t;
 
+typedef struct {                // streaming Viterbi decoder type
+    int len;                    // length of decision history (steps)
+    int64_t n;                  // number of steps
+    uint32_t metric[64];        // path metrics of states
+    uint64_t *dec;              // decision history of states (len)
+} sdr_vit_t;
+
 typedef struct {                // SDR receiver navigation data type
     int ssync;                  // symbol sync time as lock count (0: no-sync)
     int fsync;                  // nav frame sync time as lock count (0: no-sync)
@@ -144,91 +410,358 @@ typedef struct {                // SDR receiver navigation data type
     int nerr;                   // number of error corrected
     int seq, type, stat;        // sequence number, type, update status
     double coff;                // code offset for L6D/E CSK
-    uint8_t syms[SDR_MAX_NSYM]; // nav symbols buffer
+    sdr_hist_t *syms;           // nav symbols buffer (SDR_MAX_NSYM)
+    int64_t nsym;               // number of nav symbols added
+    uint64_t psyms[SDR_NSYM_W]; // packed nav symbols ring buffer
+                                // (bit i % 64 of word i / 64 % SDR_NSYM_W:
+                                // symbol i)
+    int64_t nsym_vit;           // number of nav symbols input to Viterbi
+    sdr_vit_t *vit[2];          // streaming Viterbi decoders of symbol pairs
+                                // ending at even/odd symbol (NULL: no FEC)
+    struct sdr_nav_job_tag *job; // nav frame decode job (NULL: none)
     uint8_t data[SDR_MAX_DATA]; // navigation data buffer
     int count[2];               // navigation data count (OK, error)
 } sdr_nav_t;
 
-typedef struct {                // SDR receiver channel type 
-    int no;                     // channel number
-    int rf_ch;                  // RF channel
+typedef struct {                // SDR receiver options (see sdr_rcv_setopt())
+    double epoch, lag_epoch;    // PVT epoch interval and max lag (s)
+    double epoch_full;          // full PVT solution interval (s)
+    double el_mask;             // elevation mask (deg)
+    double sp_corr;             // correlator spacing (chip)
+    double t_acq, t_dll;        // integration time for acquisition and DLL (s)
+    double b_dll, b_pll;        // band-width of DLL and PLL filter (Hz)
+    double b_fll_w, b_fll_n;    // band-width of FLL filter (Hz) (wide/narrow)
+    double max_dop;             // max Doppler for acquisition (Hz)
+    double thres_cn0_l;         // C/N0 threshold (dB-Hz) (lock)
+    double thres_cn0_u;         // C/N0 threshold (dB-Hz) (lost)
+    int acq_pack;               // compact accumulator for acquisition
+    int acq_fold;               // folded acquisition for long codes
+    int trk_nco;                // code NCO correlator for tracking
+    int nwk, nacq;              // number of tracking and acquisition workers
+    int unpack_th;              // unpack IF data by RF channel threads
+    double tspan;               // time span to process IF data file (s)
+    int vis_ch;                 // suspend channels of invisible satellites
+    int nsrch;                  // max number of signal search channels
+    int max_buff;               // size of IF data buffer (* SDR_CYC)
+    int buff_huge, buff_numa;   // huge pages and NUMA nodes of IF data buffer
+    int nav_async, pvt_th;      // nav decode worker and PVT thread
+    int str_queue, raw_queue;   // output queue of NMEA/RTCM3 and IF data log
+                                // streams (MB)
+    int raw_comp;               // compress IF data log stream
+    int file_th;                // decode threads of compressed IF data file
+    int read_ahead;             // read-ahead of IF data file or network IF
+                                // data stream (ms)
+    int usb_nbuff, usb_size;    // number and size (KB) of USB transfers
+    int ddc;                    // decimation factor of DDCs (0: no DDC)
+    int mon;                    // IF data monitors of RF channels
+    int warm;                   // warm start by receiver state file
+    int prof;                   // CPU time of receiver stages
+    double shed;                // IF data buffer usage to shed load (%)
+    int shed_pol;               // priority policy of load shedding
+    char aff_cpus[4][256];      // CPU sets of threads {ingest,track,acq,pvt}
+    int aff_pri[4];             // scheduling priorities of threads
+} sdr_opt_t;
+
+struct sdr_ch_tag;
+
+typedef struct {                // signal descriptor type
+    const char *sig;            // signal ID ("": unknown signal)
+    int corr;                   // correlator type (SDR_CORR_???)
+    int nav;                    // nav data type for PVT (SDR_NAV_???)
+    uint8_t code;               // RINEX signal code (CODE_???, 0: unknown)
+    void (*decode)(struct sdr_ch_tag *ch); // nav data decoder (NULL: none)
+} sdr_sig_t;
+
+typedef struct sdr_ch_tag {     // SDR receiver channel type 
+    // hot loop state updated in every code cycle (keep at head)
     int state;                  // channel state 
+    int lock, lost;             // lock and lost counts 
+    int costas;                 // Costas PLL flag 
+    int N;                      // code cycle (samples) 
+    int week, tow;              // week number (week), TOW (ms)
     double time;                // receiver time 
+    double fd;                  // Doppler frequency (Hz) 
+    double coff;                // code offset (s) 
+    double adr;                 // accumurated Doppler range (cyc) 
+    double cn0;                 // C/N0 (dB-Hz) 
+    double T;                   // code cycle (s) 
+    double fc;                  // carrier frequency (Hz) 
+    double fs;                  // sampling rate (sps) 
+    double fi;                  // IF freqency (Hz) 
+    sdr_trk_t *trk;             // signal tracking 
+    const sdr_sig_t *desc;      // signal descriptor
+    // cold state
+    int no;                     // channel number
+    int rf_ch;                  // RF channel
     char sat[16];               // satellite ID 
     char sig[16];               // signal ID 
     int prn;                    // PRN number 
     const int8_t *code;         // primary code 
     const int8_t *sec_code;     // secondary code
     int len_code, len_sec_code;
-    double fc;                  // carrier frequency (Hz) 
-    double fs;                  // sampling rate (sps) 
-    double fi;                  // IF freqency (Hz) 
-    double T;                   // code cycle (s) 
-    int N;                      // code cycle (samples) 
-    double fd;                  // Doppler frequency (Hz) 
-    double coff;                // code offset (s) 
-    double adr;                 // accumurated Doppler range (cyc) 
-    double cn0;                 // C/N0 (dB-Hz) 
-    int week, tow;              // week number (week), TOW (ms)
     int tow_v;                  // TOW flag (0:invalid,1:valid,2:amb-unresolved)
-    int lock, lost;             // lock and lost counts 
-    int costas;                 // Costas PLL flag 
+    int susp;                   // suspended (0:no,1:yes)
     sdr_acq_t *acq;             // signal acquisition 
-    sdr_trk_t *trk;             // signal tracking 
     sdr_nav_t *nav;             // navigation decoder
+    const sdr_opt_t *opt;       // options
+    int shed;                   // load shedding (0:none,1:skip nav decoding,
+                                // 2:paused)
+    int64_t cpu[4];             // CPU time of tracking, acquisition, nav
+                                // decoding and obs update (ns) (option prof)
+    int64_t lat[SDR_N_LAT];     // histogram of observation age (<1, <2, <5,
+                                // <10, <20, <50, <100, <200, <500, >=500 ms)
+                                // (option prof)
     pthread_mutex_t mtx;        // lock flag
 } sdr_ch_t;
 
-typedef struct {                // IF data buffer type
-    sdr_cpx8_t *data;           // IF data
-    int IQ, N;                  // sampling types (1:I,2:IQ) and buffer size
-} sdr_buff_t;
-
 struct sdr_rcv_tag;
 
 typedef struct {                // SDR receiver channel thread type
     int state;                  // state (0:stop,1:run)
     sdr_ch_t *ch;               // SDR receiver channel
     int64_t ix;                 // IF data buffer read pointer (cyc)
+    sdr_buff_t *buff;           // IF data buffer of channel
+    int N;                      // IF data cycle of buffer (samples)
+    int lag;                    // lag of IF data buffer (cyc)
     struct sdr_rcv_tag *rcv;    // pointer to SDR receiver
-    pthread_t thread;           // SDR receiver channel thread
+    int busy;                   // channel task queued or running (0:no,1:yes)
 } sdr_ch_th_t;
 
-typedef struct {                // SDR PVT type
+typedef struct {                // SDR receiver worker thread type
+    int state;                  // state (0:stop,1:run)
+    int no;                     // worker number (0,1,...)
+    int *que;                   // channel task deque (channel indices)
+    int size;                   // size of channel task deque
+    int head, tail;             // deque head (steal) and tail (push/pop)
+    int acq;                    // acquisition worker (0:no,1:yes)
+    struct sdr_rcv_tag *rcv;    // pointer to SDR receiver
+    pthread_t thread;           // worker thread
+    pthread_mutex_t mtx;        // lock flag
+} sdr_wk_t;
+
+typedef struct {                // IF data unpack threads type
+    int state;                  // state (0:stop,1:run)
+    int nth;                    // number of started unpack threads
+    int64_t seq;                // sequence number of unpack request
+    int done;                   // number of RF channels unpacked
+    const uint8_t **raw;        // raw IF data of SDR devices to unpack
+    int i;                      // IF data buffer index to write
+    pthread_t thread[SDR_MAX_NRF]; // unpack threads (RF channel 1,2,...)
+    pthread_mutex_t mtx;        // lock flag
+    pthread_cond_t cond;        // unpack request and completion condition
+} sdr_unpack_t;
+
+typedef struct {                // IF data reader thread type
+    int state;                  // state (0:stop,1:run)
+    int depth, size;            // depth (cycles) and size of cycles (bytes) of
+                                // read-ahead queue
+    uint8_t *buff;              // read-ahead queue (depth x size)
+    int64_t wp, rp;             // write and read pointers (cycles)
+    int eof;                    // end of IF data (0:no,1:yes)
+    pthread_t thread;           // reader thread
+} sdr_reader_t;
+
+typedef struct {                // IF data monitor of RF channel type
+    int N;                      // FFT size of PSD
+    int nblk;                   // number of blocks in ring
+    int64_t cnt;                // number of blocks added
+    float *w;                   // window function (N)
+    float w_ave;                // average of window function
+    float *P;                   // power spectrums of blocks (nblk x N)
+    int32_t *hist;              // histograms of I/Q sample values of blocks
+                                // (nblk x 2 x 16, values -8 to 7)
+    pthread_mutex_t mtx;        // lock flag
+} sdr_mon_t;
+
+typedef struct {                // SDR observation record type
+    int64_t nep;                // epoch number of record (0: none)
+    double P, L, D;             // pseudorange (m), carrier phase (cyc) and
+                                // Doppler (Hz)
+    uint16_t SNR;               // signal strength (SNR_UNIT dBHz)
+    uint8_t LLI;                // loss of lock indicator
+} sdr_obsr_t;
+
+typedef struct {                // SDR observation slot type
+    int sat;                    // satellite number (0: no observation)
+    uint8_t code;               // signal code (CODE_???)
+    int iobs, idx;              // satellite index and signal index
+    sdr_obsr_t rec[2];          // records by parity of epoch number
+} sdr_obss_t;
+
+typedef struct {                // SDR PVT epoch type
     gtime_t time;               // epoch time
     int64_t ix;                 // epoch cycle (cyc)
-    int nsat, nch;              // number of satellites and updated channels
-    obs_t *obs;                 // observation data
+} sdr_epoch_t;
+
+typedef struct {                // SDR satellite state cache type
+    int valid;                  // valid flag (0: not cached)
+    gtime_t time;               // time of satellite states
+    double rs[6];               // satellite position and velocity (m, m/s)
+    double dts[2];              // satellite clock bias and drift (s, s/s)
+    double isb;                 // inter-system bias to solution clock (m)
+    double corr;                // iono, tropo and group delay corrections (m)
+} sdr_satc_t;
+
+typedef struct {                // SDR PVT type
+    sdr_epoch_t ep[2];          // epochs by parity of epoch number
+    int64_t nep;                // epoch number of open epoch (0: no epoch)
+    int64_t nrep[2];            // epoch number and number of channels updated
+                                // epoch (nep << 16 | number)
+    int nsat;                   // number of satellites
+    sdr_obss_t *slot;           // observation slots of channels
+    int nslot;                  // number of observation slots
+    int *iobs;                  // observation data index of satellites
+    obs_t *obs;                 // observation data of solution epoch
+    sdr_satc_t *satc;           // satellite state cache of satellites
+    gtime_t time_full;          // time of last full PVT solution
     nav_t *nav;                 // navigation data
     sol_t *sol;                 // PVT solution
     ssat_t *ssat;               // satellite status
     rtcm_t *rtcm;               // RTCM control
     int count[3];               // solution, OBS and NAV count
     struct sdr_rcv_tag *rcv;    // pointer to SDR receiver
-    pthread_mutex_t mtx;        // lock flag
+    const sdr_opt_t *opt;       // options
+    pthread_mutex_t mtx;        // lock flag of nav data and solution
+    pthread_mutex_t obs_mtx;    // lock flag of epoch and observation data
+    pthread_cond_t cond;        // epoch completion condition
 } sdr_pvt_t;
 
+typedef struct {                // channel status in view (fixed layout)
+    int32_t no, rf_ch, prn;     // channel no, RF channel and PRN
+    int32_t state;              // channel state (SDR_STATE_???)
+    char sat[8], sig[8];        // satellite ID and signal ID
+    char sync[8];               // sync status (secondary, bit, frame, reverse)
+    double time;                // channel time (s)
+    double lock, cn0;           // lock time (s) and C/N0 (dB-Hz)
+    double coff, fd, adr;       // code offset (ms), Doppler (Hz), ADR (cyc)
+    int32_t nnav, nerr;         // number of nav data and errors
+    int32_t lost, fec;          // number of loss-of-locks and FEC errors
+} sdr_ch_view_t;
+
+typedef struct {                // receiver status view (fixed layout)
+    uint32_t ver;               // version (SDR_VIEW_VER)
+    uint32_t size;              // size of view (bytes)
+    volatile uint32_t seq;      // update sequence (odd: being updated)
+    int32_t nch;                // number of channels in ch[]
+    int32_t corr_ch;            // channel of correlator status (0: none)
+    int32_t ncorr, nhist;       // number of correlators and history
+    int32_t rf_ch;              // RF channel of PSD (0: none)
+    int32_t npsd;               // number of PSD points
+    int32_t resv;               // reserved
+    double corr_stat[6];        // state, fs, lock, C/N0, coff, fd
+    double hist_stat[2];        // time and integration time of history (s)
+    sdr_cpx_t C[SDR_N_CORR];    // correlations
+    int32_t pos[SDR_N_CORR];    // correlator positions
+    sdr_cpx_t P[SDR_N_HIST];    // history of P correlations
+    float psd[SDR_N_PSD];       // PSD (dB/Hz)
+    sdr_ch_view_t ch[SDR_MAX_NCH]; // channel status
+} sdr_rcv_view_t;
+
+typedef struct {                // satellite status in snapshot
+    char sat[8];                // satellite ID
+    float az, el;               // azimuth and elevation (deg)
+    int32_t vs;                 // valid satellite flag
+} sdr_sat_snap_t;
+
+typedef struct {                // channel profile in snapshot (option prof)
+    double cpu[4];              // CPU time of tracking, acquisition, nav
+                                // decoding and obs update (s)
+    int64_t lat[SDR_N_LAT];     // histogram of observation age (see sdr_ch_t)
+} sdr_ch_prof_t;
+
+typedef struct {                // receiver status snapshot (fixed layout)
+    uint32_t ver;               // version (SDR_SNAP_VER)
+    uint32_t size;              // size of snapshot (bytes)
+    uint32_t seq;               // update sequence (odd: being updated)
+    int32_t state;              // receiver state (0:stop,1:run)
+    int32_t dev, fmt;           // SDR device type and IF data format
+    int32_t nbuff;              // number of IF data buffers (RF channels)
+    int32_t IQ[SDR_MAX_NRF];    // IF sampling types (I:1,I/Q:2)
+    int32_t shed;               // load shedding level (0:none,1-3)
+    double time;                // receiver time (s)
+    double fs;                  // IF data sampling rate (sps)
+    double fo[SDR_MAX_NRF];     // LO frequencies (Hz)
+    double data_rate, data_sum; // IF data rate (MB/s) and size (MB)
+    double buff_use;            // IF data buffer usage (%)
+    int64_t dev_stat[3];        // USB transfer errors, overruns and dropped
+                                // IF data (bytes) of SDR devices
+    double sol_time;            // time of solution or epoch (GPST s)
+    double pos[3];              // solution position {lat,lon (deg),hgt (m)}
+    int32_t sol_stat;           // solution status (0:none,1:fix)
+    int32_t ns, nsat;           // number of satellites in solution and epoch
+    int32_t count[3];           // solution, OBS and NAV count
+    int32_t nch, nch_trk;       // number of channels and tracking channels
+    int32_t ch_srch;            // signal search channel (0: none)
+    char sys[8];                // systems of tracking channels
+    int32_t nsv;                // number of satellites in sat[]
+    sdr_sat_snap_t sat[SDR_MAX_NSAT]; // satellites above horizon
+    sdr_ch_view_t ch[SDR_MAX_NCH]; // channel status
+    sdr_ch_prof_t prof[SDR_MAX_NCH]; // channel profiles
+} sdr_rcv_snap_t;
+
+typedef struct {                // warm start state type
+    gtime_t time;               // time of receiver start (GPST) (system clock)
+    double age;                 // age of receiver state (s)
+    double rr[3];               // receiver position (ECEF) (m)
+    double drift;               // receiver clock drift (s/s)
+    float fd[SDR_MAX_NCH];      // Doppler of channels (Hz) (0: none)
+    uint8_t srch[SDR_MAX_NCH];  // warm start search done of channels
+} sdr_warm_t;
+
 typedef struct sdr_rcv_tag {    // SDR receiver type
     int state;                  // state (0:stop,1:run)
     int dev;                    // SDR device type (SDR_DEV_???)
     void *dp;                   // SDR device pointer
+    int ndev;                   // number of SDR devices
+    void *dps[SDR_MAX_NDEV];    // SDR device pointers (dps[0] = dp)
+    sdr_opt_t opt;              // options (copied at generation)
     int fmt;                    // IF data format (SDR_FMT_???)
     double fs;                  // IF data sampling rate (sps) 
-    double fo[SDR_MAX_RFCH];    // LO frequencies (Hz)
-    int IQ[SDR_MAX_RFCH];       // IF sampling types (I:1,I/Q:2)
+    double fo[SDR_MAX_NRF];     // LO frequencies (Hz)
+    int IQ[SDR_MAX_NRF];        // IF sampling types (I:1,I/Q:2)
     int N;                      // IF data cycle (sample)
     int nch, nbuff;             // number of receiver channels and IF buffers
+    int max_buff;               // size of IF data buffers (* SDR_CYC)
     int ich;                    // signal search channel index
     sdr_ch_th_t *th[SDR_MAX_NCH]; // SDR receiver channel threads
-    sdr_buff_t *buff[SDR_MAX_RFCH]; // IF data buffers
+    int grp[SDR_MAX_NCH];       // next channel of same satellite (circular)
+    int nwk, nacq;              // number of tracking and acquisition workers
+    int nav_async;              // nav decode worker started (0:off,1:on)
+    int pvt_state;              // PVT thread state (0:stop,1:run)
+    pthread_t pvt_thread;       // PVT thread
+    sdr_wk_t *wk[SDR_MAX_NWK];  // worker threads
+    sdr_buff_t *buff[SDR_MAX_NRF]; // IF data buffers (RF channels of SDR
+                                // device 1, 2, ...)
+    sdr_unpack_t *up;           // IF data unpack threads (NULL: off)
+    sdr_reader_t *rd;           // IF data reader thread (NULL: off)
+    int nddc;                   // number of DDCs
+    sdr_ddc_t *ddc[SDR_MAX_NDDC]; // DDCs of narrowband channel groups
+    int ddc_rf[SDR_MAX_NDDC];   // RF channels of DDCs
+    sdr_buff_t *ddc_buff[SDR_MAX_NDDC]; // decimated IF data buffers of DDCs
+    sdr_mon_t *mon[SDR_MAX_NRF]; // IF data monitors of RF channels (NULL: off)
     int64_t ix;                 // IF data cycle count (cyc)
     double tscale;              // time scale to replay IF data file
     double data_rate, data_sum; // IF data rate (MB/s) and size (MB)
     double buff_use;            // buffer usage (%)
+    double buff_peak;           // peak buffer usage (%)
+    int64_t nlate;              // IF data cycles late to replay IF data file
+    int shed, shed_hold;        // load shedding level and recovery count
+    double shed_use;            // buffer usage at last load shedding (%)
+    double t_vis;               // time of last fix for channel visibility (s)
+    int ch_sel;                 // channel selected for correlators (0: none)
+    int64_t cpu[2];             // CPU time of ingest and PVT (ns) (option prof)
+    double *t_cyc;              // arrival time of IF data cycles (s) (option
+                                // prof)
     sdr_pvt_t *pvt;             // SDR PVT
-    stream_t *strs[4];          // NMEA, RTCM3 and IF data log streams
+    sdr_warm_t *warm;           // warm start state (NULL: cold start)
+    sdr_str_t *strs[4];         // NMEA, RTCM3 and IF data log streams
+    sdr_rcv_view_t *view;       // status view (NULL: not used)
+    sdr_rcv_snap_t *snap;       // status snapshot published by receiver
+    char *stat_buff;            // buffer of status strings
     pthread_t thread;           // SDR receiver thread
     pthread_mutex_t mtx;        // lock flag
+    pthread_cond_t cond;        // IF data cycle arrival condition
+    pthread_cond_t sync;        // channel tasks done condition (fast replay)
 } sdr_rcv_t;
 
 // function prototypes -------------------------------------------------------
@@ -238,7 +771,15 @@ void *sdr_malloc(size_t size);
 void sdr_free(void *p);
 void sdr_get_time(double *t);
 uint32_t sdr_get_tick(void);
+double sdr_get_clock(void);
+double sdr_get_cputime(void);
 void sdr_sleep_msec(int msec);
+int sdr_get_ncpu(void);
+void *sdr_malloc_huge(size_t size, int huge, int node, size_t *msize);
+void sdr_free_huge(void *p, size_t msize);
+int sdr_get_nnode(void);
+int sdr_set_thread(const char *cpus, int pri);
+int sdr_cond_wait(pthread_cond_t *cond, pthread_mutex_t *mtx, int msec);
 
 // sdr_usb.c
 sdr_usb_t *sdr_usb_open(int bus, int port, const uint16_t *vid,
@@ -250,44 +791,123 @@ int sdr_usb_req(sdr_usb_t *usb, int mode, uint8_t req, uint16_t val,
 // sdr_dev.c
 sdr_dev_t *sdr_dev_open(int bus, int port);
 void sdr_dev_close(sdr_dev_t *dev);
-int sdr_dev_start(sdr_dev_t *dev);
+int sdr_dev_start(sdr_dev_t *dev, int nbuff, int size);
 int sdr_dev_stop(sdr_dev_t *dev);
 int sdr_dev_read(sdr_dev_t *dev, uint8_t *buff, int size);
+int sdr_dev_wait(sdr_dev_t *dev, int size, int msec);
+int sdr_dev_get_stat(sdr_dev_t *dev, int64_t *nerr, int64_t *nover,
+    int64_t *ndrop);
+const uint8_t *sdr_dev_view(sdr_dev_t *dev, int size);
+void sdr_dev_release(sdr_dev_t *dev, int size);
 int sdr_dev_get_info(sdr_dev_t *dev, int *fmt, double *fs, double *fo, int *IQ);
 int sdr_dev_get_gain(sdr_dev_t *dev, int ch);
 int sdr_dev_set_gain(sdr_dev_t *dev, int ch, int gain);
+int sdr_dev_set_mask(sdr_dev_t *dev, int mask);
 
 // sdr_conf.c
 int sdr_conf_read(sdr_dev_t *dev, const char *file, int opt);
 int sdr_conf_write(sdr_dev_t *dev, const char *file, int opt);
 
+// sdr_ifz.c
+sdr_ifz_t *sdr_ifz_new(const char *tag, int fmt, int chunk,
+    int (*write)(void *, const uint8_t *, int), void *arg);
+int sdr_ifz_write(sdr_ifz_t *z, const uint8_t *data, int size);
+void sdr_ifz_skip(sdr_ifz_t *z, int64_t size);
+void sdr_ifz_free(sdr_ifz_t *z);
+int sdr_ifz_read_tag(const char *file, char *tag);
+sdr_iff_t *sdr_iff_open(const char *file, int nth);
+void sdr_iff_close(sdr_iff_t *iff);
+int sdr_iff_seek(sdr_iff_t *iff, int64_t off);
+int sdr_iff_read(sdr_iff_t *iff, uint8_t *data, int size);
+const uint8_t *sdr_iff_view(sdr_iff_t *iff, int size);
+int sdr_iff_get(sdr_iff_t *iff, int IQ, int64_t ix, int N, sdr_cpx8_t *data);
+
+// sdr_net.c
+sdr_net_t *sdr_net_open(const char *path, int mode, const char *tag,
+    int psize);
+void sdr_net_close(sdr_net_t *net);
+int sdr_net_write(sdr_net_t *net, const uint8_t *data, int size);
+int sdr_net_tag(sdr_net_t *net, char *tag, int msec);
+int sdr_net_read(sdr_net_t *net, uint8_t *data, int size, int msec);
+void sdr_net_stat(sdr_net_t *net, int64_t *stat);
+
+// sdr_gpu.cu
+int sdr_gpu_open(int dev);
+void sdr_gpu_close(void);
+int sdr_gpu_data(const sdr_cpx8_t *data, int N, const double *fc, int nb);
+int sdr_gpu_corr(const sdr_cpx_t *code_fft, const int *idx, int M, float *P);
+
 // sdr_func.c
 void sdr_func_init(const char *file);
+int sdr_set_simd(const char *name);
+const char *sdr_get_simd(void);
+int sdr_set_mix(const char *name);
+const char *sdr_get_mix(void);
+int sdr_set_acq_gpu(int dev);
 sdr_cpx_t *sdr_cpx_malloc(int N);
 void sdr_cpx_free(sdr_cpx_t *cpx);
+void *sdr_scratch_alloc(size_t size);
+void sdr_scratch_free(void *p);
+void sdr_scratch_release(void);
 float sdr_cpx_abs(sdr_cpx_t cpx);
 void sdr_cpx_mul(const sdr_cpx_t *a, const sdr_cpx_t *b, int N, float s,
     sdr_cpx_t *c);
 sdr_buff_t *sdr_buff_new(int N, int IQ);
+sdr_buff_t *sdr_buff_new_pack(int N, int IQ, const sdr_cpx8_t *dec);
+sdr_buff_t *sdr_buff_new_mem(int N, int IQ, const sdr_cpx8_t *dec, int huge,
+    int node);
 void sdr_buff_free(sdr_buff_t *buff);
+void sdr_buff_get(const sdr_buff_t *buff, int ix, int N, sdr_cpx8_t *data);
+void sdr_pack_raw(const uint8_t *raw, int N, int fmt, int ch, uint8_t *pk);
+void sdr_buff_write_int8(sdr_buff_t *buff, int ix, const int8_t *raw, int N,
+    int IQ);
+void sdr_buff_write_raw(sdr_buff_t *buff, int ix, const uint8_t *raw, int N,
+    int fmt, int ch);
+sdr_ddc_t *sdr_ddc_new(int D, double fs, double fc);
+void sdr_ddc_proc(sdr_ddc_t *ddc, const sdr_buff_t *in, int ix, int N,
+    sdr_buff_t *out, int ox);
+void sdr_ddc_free(sdr_ddc_t *ddc);
 sdr_buff_t *sdr_read_data(const char *file, double fs, int IQ, double T,
     double toff);
 void sdr_search_code(const sdr_cpx_t *code_fft, double T,
     const sdr_buff_t *buff, int ix, int N, double fs, double fi,
     const float *fds, int len_fds, float *P);
+void sdr_search_code_multi(const sdr_cpx_t *const *code_fft, int ncode,
+    double T, const sdr_buff_t *buff, int ix, int N, double fs, double fi,
+    const float *fds, int len_fds, float *const *P);
+void sdr_search_code_cpx(const sdr_cpx_t *code_fft, double T,
+    const sdr_cpx_t *buff, int len_buff, int ix, int N, double fs, double fi,
+    const float *fds, int len_fds, float *P);
+void sdr_search_code_multi_cpx(const sdr_cpx_t *const *code_fft, int ncode,
+    double T, const sdr_cpx_t *buff, int len_buff, int ix, int N, double fs,
+    double fi, const float *fds, int len_fds, float *const *P);
 float sdr_corr_max(const float *P, int N, int M, int Nmax, double T, int *ix);
 double sdr_fine_dop(const float *P, int N, const float *fds, int len_fds,
     const int *ix);
+sdr_pacc_t *sdr_pacc_new(int N, int M);
+void sdr_pacc_free(sdr_pacc_t *acc);
+void sdr_search_code_pacc(const sdr_cpx_t *code_fft, double T,
+    const sdr_buff_t *buff, int ix, int N, double fs, double fi,
+    const float *fds, int len_fds, sdr_pacc_t *acc);
+float sdr_pacc_corr_max(const sdr_pacc_t *acc, double T, int *ix);
+double sdr_pacc_fine_dop(const sdr_pacc_t *acc, const float *fds, int len_fds,
+    const int *ix);
 double sdr_shift_freq(const char *sig, int fcn, double fi);
 float *sdr_dop_bins(double T, float dop, float max_dop, int *len_fds);
 void sdr_corr_std(const sdr_buff_t *buff, int ix, int N, double fs, double fc,
     double phi, const sdr_cpx16_t *code, const int *pos, int n,
     sdr_cpx_t *corr);
+void sdr_corr_nco(const sdr_buff_t *buff, int ix, int N, double fs, double fc,
+    double phi, const int8_t *code, int len_code, double T, double coff,
+    const int *pos, int n, sdr_cpx_t *corr);
 void sdr_corr_std_cpx(const sdr_cpx_t *buff, int len_buff, int ix, int N,
     double fs, double fc, double phi, const float *code, const int *pos, int n,
     sdr_cpx_t *corr);
 void sdr_corr_fft(const sdr_buff_t *buff, int ix, int N, double fs, double fc,
     double phi, const sdr_cpx_t *code_fft, sdr_cpx_t *corr);
+void sdr_corr_fft_share(const sdr_buff_t *buff, int ix, int N, double fs,
+    double fc, double phi, double time, const sdr_cpx_t *code_fft,
+    sdr_cpx_t *corr);
 void sdr_corr_fft_cpx(const sdr_cpx_t *buff, int len_buff, int ix, int N,
     double fs, double fc, double phi, const sdr_cpx_t *code_fft,
     sdr_cpx_t *corr);
@@ -295,21 +915,38 @@ void sdr_mix_carr(const sdr_buff_t *buff, int ix, int N, double fs, double fc,
     double phi, sdr_cpx16_t *IQ);
 void sdr_psd_cpx(const sdr_cpx_t *buff, int len_buff, int N, double fs, int IQ,
     float *psd);
-stream_t *sdr_str_open(const char *path);
-void sdr_str_close(stream_t *str);
-int sdr_str_write(stream_t *str, uint8_t *data, int size);
+sdr_str_t *sdr_str_open(const char *path);
+void sdr_str_close(sdr_str_t *str);
+int sdr_str_async(sdr_str_t *str, int size);
+int sdr_str_ifz(sdr_str_t *str, const char *tag, int fmt, int chunk);
+int sdr_str_write(sdr_str_t *str, const uint8_t *data, int size);
 int sdr_log_open(const char *path);
 void sdr_log_close(void);
 void sdr_log_level(int level);
 void sdr_log(int level, const char *msg, ...);
 int sdr_get_log(char *buff, int size);
+void sdr_trace_start(int nev);
+void sdr_trace_stop(void);
+int64_t sdr_trace_begin(void);
+void sdr_trace_end(const char *cat, const char *name, int64_t arg, int64_t t0);
+void sdr_trace_name(const char *name);
+int sdr_trace_dump(const char *file);
 int sdr_parse_nums(const char *str, int *prns);
 void sdr_add_buff(void *buff, int len_buff, void *item, size_t size_item);
+sdr_hist_t *sdr_hist_new(int len, int size);
+void sdr_hist_free(sdr_hist_t *hist);
+void sdr_hist_clear(sdr_hist_t *hist);
+void sdr_hist_add(sdr_hist_t *hist, const void *item);
+void sdr_hist_back(sdr_hist_t *hist);
+void sdr_hist_set(sdr_hist_t *hist, int i, const void *item);
+void *sdr_hist_data(const sdr_hist_t *hist);
 void sdr_pack_bits(const uint8_t *data, int nbit, int nz, uint8_t *buff);
 void sdr_unpack_bits(const uint8_t *data, int nbit, uint8_t *buff);
 void sdr_unpack_data(uint32_t data, int nbit, uint8_t *buff);
 uint8_t sdr_xor_bits(uint32_t X);
 int sdr_gen_fftw_wisdom(const char *file, int N);
+int sdr_fftw_plan_opt(int max_plan, unsigned int flag);
+int sdr_fftw_plan(int N, fftwf_plan *plan);
 
 // sdr_code.c
 int8_t *sdr_gen_code(const char *sig, int prn, int *N);
@@ -323,12 +960,24 @@ void sdr_res_code(const int8_t *code, int len_code, double T, double coff,
     double fs, int N, int Nz, sdr_cpx16_t *code_res);
 void sdr_gen_code_fft(const int8_t *code, int len_code, double T, double coff,
     double fs, int N, int Nz, sdr_cpx_t *code_fft);
+int sdr_gen_code_cache(const char *file, const char **sigs, const int *prns,
+    int n, double fs);
+int sdr_code_cache_open(const char *file);
+void sdr_code_cache_close(void);
+const sdr_cpx_t *sdr_code_cache_get(const char *sig, int prn, double fs, int N,
+    int Nz);
 
 // sdr_ch.c
 sdr_ch_t *sdr_ch_new(const char *sig, int prn, double fs, double fi);
+sdr_ch_t *sdr_ch_new_opt(const char *sig, int prn, double fs, double fi,
+    const sdr_opt_t *opt);
 void sdr_ch_free(sdr_ch_t *ch);
+int sdr_ch_suspend(sdr_ch_t *ch);
+int sdr_ch_resume(sdr_ch_t *ch);
 void sdr_ch_update(sdr_ch_t *ch, double time, const sdr_buff_t *buff, int ix);
 void sdr_ch_set_corr(sdr_ch_t *ch, int npos);
+int sdr_ch_search(sdr_ch_t *ch);
+void sdr_ch_get_view(sdr_ch_t *ch, sdr_ch_view_t *view);
 int sdr_ch_corr_stat(sdr_ch_t *ch, double *stat, int *pos, sdr_cpx_t *C);
 int sdr_ch_corr_hist(sdr_ch_t *ch, double tspan, double *stat, sdr_cpx_t *P);
 
@@ -337,10 +986,20 @@ sdr_nav_t *sdr_nav_new(void);
 void sdr_nav_free(sdr_nav_t *nav);
 void sdr_nav_init(sdr_nav_t *nav);
 void sdr_nav_decode(sdr_ch_t *ch);
+int sdr_nav_start(void);
+void sdr_nav_stop(void);
+const sdr_sig_t *sdr_sig_desc(const char *sig);
 
 // sdr_fec.c
+sdr_vit_t *sdr_vit_new(int len);
+void sdr_vit_free(sdr_vit_t *vit);
+void sdr_vit_init(sdr_vit_t *vit, int state);
+void sdr_vit_update(sdr_vit_t *vit, uint8_t sym0, uint8_t sym1);
+int sdr_vit_decode(const sdr_vit_t *vit, int n, int tail, int state,
+    uint8_t *bits);
 void sdr_decode_conv(const uint8_t *data, int N, uint8_t *dec_data);
 int sdr_decode_rs(uint8_t *syms);
+void sdr_encode_rs(uint8_t *syms);
 
 // sdr_ldpc.c
 int sdr_decode_LDPC(const char *type, const uint8_t *syms, int N,
@@ -355,25 +1014,47 @@ sdr_pvt_t *sdr_pvt_new(sdr_rcv_t *rcv);
 void sdr_pvt_free(sdr_pvt_t *pvt);
 void sdr_pvt_udobs(sdr_pvt_t *pvt, int64_t ix, sdr_ch_t *ch);
 void sdr_pvt_udnav(sdr_pvt_t *pvt, sdr_ch_t *ch);
-void sdr_pvt_udsol(sdr_pvt_t *pvt, int64_t ix);
+int sdr_pvt_udsol(sdr_pvt_t *pvt, int64_t ix);
+void sdr_pvt_wait(sdr_pvt_t *pvt, int msec);
 void sdr_pvt_solstr(sdr_pvt_t *pvt, char *buff);
 
 // sdr_rcv.c
 sdr_rcv_t *sdr_rcv_new(const char **sigs, const int *prns, int n, int fmt,
     double fs, const double *fo, const int *IQ);
+sdr_rcv_t *sdr_rcv_new_ndev(const char **sigs, const int *prns, int n,
+    int ndev, int fmt, double fs, const double *fo, const int *IQ);
 void sdr_rcv_free(sdr_rcv_t *rcv);
 int sdr_rcv_start(sdr_rcv_t *rcv, int dev, void *dp, const char **paths);
 void sdr_rcv_stop(sdr_rcv_t *rcv);
 sdr_rcv_t *sdr_rcv_open_dev(const char **sigs, int *prns, int n, int bus,
     int port, const char *conf_file, const char **paths);
+sdr_rcv_t *sdr_rcv_open_ndev(const char **sigs, int *prns, int n, int ndev,
+    const int *bus, const int *port, const char **conf_files,
+    const char **paths);
 sdr_rcv_t *sdr_rcv_open_file(const char **sigs, int *prns, int n, int fmt,
     double fs, const double *fo, const int *IQ, double toff, double tscale,
     const char *file, const char **paths);
+int sdr_rcv_gen_tag(char *buff, int size, const char *prog, time_t time,
+    int fmt, double fs, const double *fo, const int *IQ, int nch);
+void sdr_rcv_read_tag(const char *file, int *fmt, double *fs, double *fo,
+    int *IQ);
+sdr_rcv_t *sdr_rcv_open_net(const char **sigs, int *prns, int n,
+    const char *path, const char **paths);
 void sdr_rcv_close(sdr_rcv_t *rcv);
 void sdr_rcv_setopt(const char *opt, double value);
+const sdr_opt_t *sdr_rcv_defopt(void);
+int sdr_rcv_setaff(const char *thread, const char *cpus, int pri);
+void sdr_rcv_cpu_time(sdr_rcv_t *rcv, double *cpu);
 char *sdr_rcv_rcv_stat(sdr_rcv_t *rcv);
 char *sdr_rcv_sat_stat(sdr_rcv_t *rcv, const char *sys);
 char *sdr_rcv_ch_stat(sdr_rcv_t *rcv, const char *sys, int all);
+int sdr_rcv_snapshot(sdr_rcv_t *rcv, sdr_rcv_snap_t *snap);
+int sdr_rcv_snap_rcv_str(const sdr_rcv_snap_t *snap, char *buff, int size);
+int sdr_rcv_snap_ch_str(const sdr_rcv_snap_t *snap, const char *sys, int all,
+    char *buff, int size);
+int sdr_rcv_snap_sat_str(const sdr_rcv_snap_t *snap, const char *sys,
+    char *buff, int size);
+int sdr_rcv_snap_prof_str(const sdr_rcv_snap_t *snap, char *buff, int size);
 void sdr_rcv_sel_ch(sdr_rcv_t *rcv, int ch);
 int sdr_rcv_corr_stat(sdr_rcv_t *rcv, int ch, double *stat, int *pos,
     sdr_cpx_t *C);
@@ -383,6 +1064,9 @@ int sdr_rcv_rfch_stat(sdr_rcv_t *rcv, int ch, double *stat);
 int sdr_rcv_rfch_psd(sdr_rcv_t *rcv, int ch, double tave, int N, float *psd);
 int sdr_rcv_rfch_hist(sdr_rcv_t *rcv, int ch, double tave, int *val,
     double *hist1, double *hist2);
+sdr_rcv_view_t *sdr_rcv_view(sdr_rcv_t *rcv);
+uint32_t sdr_rcv_view_update(sdr_rcv_t *rcv, int ch, double tspan, int rf_ch,
+    double tave);
 int sdr_rcv_get_gain(sdr_rcv_t *rcv, int ch);
 int sdr_rcv_set_gain(sdr_rcv_t *rcv, int ch, int gain);
 
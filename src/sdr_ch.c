@@ -15,46 +15,77 @@
 //  2024-04-28  1.7  modify API sdr_ch_new()
 //  2024-06-06  1.8  modify API sdr_ch_new()
 //  2024-06-10  1.9  add API sdr_ch_stat_req(), sdr_ch_stat_get()
+//  2026-10-14  1.10 use ring buffer for P correlator history
+//                   use scratch buffers for temporaries in tracking
+//                   add compact accumulator for acquisition (sdr_acq_pack)
+//                   add API sdr_ch_suspend(), sdr_ch_resume()
+//                   share code banks among channels by code bank cache
+//                   add code NCO correlator for tracking (sdr_trk_nco)
+//                   resolve signal descriptor at channel generation
+//                   share data spectrum of FFT correlator for L6D/E CSK
+//  2026-10-15  1.11 generate code banks lazily at first search or tracking
+//                   generate different code banks in parallel
+//                   use code FFT cache file for acquisition code bank
+//                   add API sdr_ch_search(), sdr_ch_get_view()
+//                   take tracking parameters from options of channel
+//                   add API sdr_ch_new_opt()
+//                   add CPU time of tracking, acquisition and nav decoding
+//                   trace spans of channel update and nav decoding
+//                   skip nav decoding and pause tracking by load shedding
+//                   start tracking by handover from other band of satellite
+//                   add folded acquisition for long codes (option acq_fold)
+//                   sync secondary code by rolling hash of signs
 //
 #include <ctype.h>
 #include <math.h>
 #include "pocket_sdr.h"
 
 // constants and macros --------------------------------------------------------
-#define SP_CORR    0.25     // correlator spacing (chip)
-#define T_ACQ      0.010    // non-coherent integration time for acquis. (s)
-#define T_DLL      0.010    // non-coherent integration time for DLL (s)
 #define T_CN0      1.0      // averaging time for C/N0 (s)
 #define T_FPULLIN  1.0      // frequency pullin time (s)
 #define T_NPULLIN  1.5      // navigation data pullin time (s)
-#define B_DLL      0.25     // band-width of DLL filter (Hz)
-#define B_PLL      5.0      // band-width of PLL filter (Hz)
-#define B_FLL_W    5.0      // band-width of FLL filter (Hz) (wide)
-#define B_FLL_N    2.0      // band-width of FLL filter (Hz) (narrow)
-#define MAX_DOP    5000.0   // max Doppler for acquisition (Hz)
-#define THRES_CN0_L 35.0    // C/N0 threshold (dB-Hz) (lock)
-#define THRES_CN0_U 32.0    // C/N0 threshold (dB-Hz) (lost)
 #define THRES_SYNC 0.02     // threshold for sec-code sync
 #define THRES_LOST 0.002    // threshold for sec-code lost
 #define N_CODE     10       // number of resampled code bank
 #define ADD_CORR   40       // number of additional correlators
+#define BANK_ACQ   0        // code bank type: code FFT for acquisition
+#define BANK_TRK   1        // code bank type: resampled codes for tracking
+#define BANK_TRK_FFT 2      // code bank type: code FFTs for tracking
+#define BANK_ACQ_FOLD 3     // code bank type: code FFT for folded acquisition
+#define BANK_SEC   4        // code bank type: sync table of secondary code
+#define MAX_FOLD   32       // max decimation factor of folded acquisition
+#define SEC_B      0x9E3779B97F4A7C15ull // base of rolling hash of signs
 
 #define DPI        (2.0 * PI)
 #define SQR(x)     ((x) * (x)) 
 #define MAX(x, y)  ((x) > (y) ? (x) : (y))
 #define MIN(x, y)  ((x) < (y) ? (x) : (y))
 
+// type definitions ------------------------------------------------------------
+typedef struct code_bank_tag {  // shared code bank type
+    char sig[16];               // signal ID
+    int prn;                    // PRN number
+    double fs;                  // sampling frequency (Hz)
+    int type;                   // code bank type (BANK_???)
+    int nref;                   // reference count
+    void *data;                 // code bank (NULL: being generated)
+    int ext;                    // code bank in code FFT cache (not freed)
+    struct code_bank_tag *next; // next code bank
+} code_bank_t;
+
+typedef struct {                // sync table of secondary code type
+    int N;                      // length of secondary code
+    int mask;                   // mask of hash table index (size - 1)
+    uint64_t pow;               // B^N of rolling hash
+    uint64_t ones;              // rolling hash of N one bits
+    uint64_t *hash;             // rolling hashes of code phases (size)
+    int *phase;                 // code phases of hashes (size) (-1: empty)
+} sec_tbl_t;
+
 // global variables ------------------------------------------------------------
-double sdr_sp_corr = SP_CORR;
-double sdr_t_acq   = T_ACQ;
-double sdr_t_dll   = T_DLL;
-double sdr_b_dll   = B_DLL;
-double sdr_b_pll   = B_PLL;
-double sdr_b_fll_w = B_FLL_W;
-double sdr_b_fll_n = B_FLL_N;
-double sdr_max_dop = MAX_DOP;
-double sdr_thres_cn0_l = THRES_CN0_L;
-double sdr_thres_cn0_u = THRES_CN0_U;
+static code_bank_t *code_banks = NULL; // code bank cache (process-wide)
+static pthread_mutex_t code_banks_mtx = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t code_banks_cond = PTHREAD_COND_INITIALIZER;
 
 // upper cases of signal string ------------------------------------------------
 static void sig_upper(const char *sig, char *Sig)
@@ -67,17 +98,238 @@ static void sig_upper(const char *sig, char *Sig)
     Sig[i] = '\0';
 }
 
+// decimation factor of folded acquisition ------------------------------------
+//  The largest factor folding the samples to 2 samples/chip or more, which
+//  divides the samples of the code cycle (1: no folding).
+//
+static int fold_fact(const sdr_ch_t *ch)
+{
+    if (!ch->opt->acq_fold) return 1;
+    int D = MIN((int)(ch->fs * ch->T / ch->len_code / 2.0), MAX_FOLD);
+    
+    while (D >= 2 && ch->N % D) D--;
+    return MAX(D, 1);
+}
+
+// slot of rolling hash in sync table of secondary code -----------------------
+static int sec_slot(const sec_tbl_t *tbl, uint64_t h)
+{
+    return (int)((h * SEC_B) >> 32) & tbl->mask;
+}
+
+// put code phase to sync table of secondary code ------------------------------
+static void sec_tbl_put(sec_tbl_t *tbl, uint64_t h, int phase)
+{
+    int i = sec_slot(tbl, h);
+    
+    for ( ; tbl->phase[i] >= 0; i = (i + 1) & tbl->mask) {
+        if (tbl->hash[i] == h) return; // keep first phase
+    }
+    tbl->hash[i] = h;
+    tbl->phase[i] = phase;
+}
+
+// get code phase from sync table of secondary code ----------------------------
+static int sec_tbl_get(const sec_tbl_t *tbl, uint64_t h)
+{
+    int i = sec_slot(tbl, h);
+    
+    for ( ; tbl->phase[i] >= 0; i = (i + 1) & tbl->mask) {
+        if (tbl->hash[i] == h) return tbl->phase[i];
+    }
+    return -1;
+}
+
+// generate sync table of secondary code ---------------------------------------
+//  The rolling hashes of the code signs (1: +1, 0: -1) of N chips ending at the
+//  code phases (0,...,N-1) are stored in an open-addressing hash table, so all
+//  code phases are tested by a lookup. The phase N-1 takes precedence over the
+//  other phases with the same signs.
+//
+static sec_tbl_t *sec_tbl_new(const int8_t *code, int N)
+{
+    int size = 4;
+    
+    while (size < 2 * N) size <<= 1;
+    sec_tbl_t *tbl = (sec_tbl_t *)sdr_malloc(sizeof(sec_tbl_t) +
+        (sizeof(uint64_t) + sizeof(int)) * size);
+    tbl->hash = (uint64_t *)(tbl + 1);
+    tbl->phase = (int *)(tbl->hash + size);
+    tbl->N = N;
+    tbl->mask = size - 1;
+    tbl->pow = 1;
+    for (int i = 0; i < size; i++) {
+        tbl->phase[i] = -1;
+    }
+    uint64_t h = 0;
+    for (int i = 0; i < N; i++) {
+        tbl->pow *= SEC_B;
+        tbl->ones = tbl->ones * SEC_B + 1;
+        h = h * SEC_B + (code[i] > 0);
+    }
+    sec_tbl_put(tbl, h, N - 1);
+    for (int i = 0; i < N - 1; i++) { // roll chip i from head to tail
+        uint64_t b = code[i] > 0;
+        h = h * SEC_B + b - b * tbl->pow;
+        sec_tbl_put(tbl, h, i);
+    }
+    return tbl;
+}
+
+// generate code bank ---------------------------------------------------------
+static void *gen_bank(const sdr_ch_t *ch, int type, int *ext)
+{
+    *ext = 0;
+    if (type == BANK_ACQ || type == BANK_ACQ_FOLD) { // zero-padded code FFT
+        int D = type == BANK_ACQ ? 1 : fold_fact(ch), N = ch->N / D;
+        const sdr_cpx_t *cache = sdr_code_cache_get(ch->sig, ch->prn,
+            ch->fs / D, N, N);
+        if (cache) {
+            *ext = 1;
+            return (void *)cache;
+        }
+        sdr_cpx_t *code_fft = sdr_cpx_malloc(2 * N);
+        sdr_gen_code_fft(ch->code, ch->len_code, ch->T, 0.0, ch->fs / D, N, N,
+            code_fft);
+        return code_fft;
+    }
+    else if (type == BANK_SEC) {
+        return sec_tbl_new(ch->sec_code, ch->len_sec_code);
+    }
+    else if (type == BANK_TRK_FFT) {
+        sdr_cpx_t *code_fft = sdr_cpx_malloc(ch->N * N_CODE);
+        for (int i = 0; i < N_CODE; i++) {
+            double coff = -i / ch->fs / N_CODE;
+            sdr_gen_code_fft(ch->code, ch->len_code, ch->T, coff, ch->fs,
+                ch->N, 0, code_fft + i * ch->N);
+        }
+        return code_fft;
+    }
+    sdr_cpx16_t *code = (sdr_cpx16_t *)sdr_malloc(sizeof(sdr_cpx16_t) * ch->N *
+        N_CODE);
+    for (int i = 0; i < N_CODE; i++) {
+        double coff = -i / ch->fs / N_CODE;
+        sdr_res_code(ch->code, ch->len_code, ch->T, coff, ch->fs, ch->N, 0,
+            code + i * ch->N);
+    }
+    return code;
+}
+
+// get code bank from code bank cache ------------------------------------------
+//  The code banks are shared by the channels with the same signal, PRN and
+//  sampling frequency. They are generated by the first channel and freed by
+//  the last channel released. They shall not be modified by the channels.
+//  A code bank is generated without the lock of the cache, so different code
+//  banks are generated in parallel. The other channels requesting the code
+//  bank being generated wait for it.
+//
+static void *get_bank(const sdr_ch_t *ch, int type)
+{
+    code_bank_t *bank;
+    
+    pthread_mutex_lock(&code_banks_mtx);
+    for (bank = code_banks; bank; bank = bank->next) {
+        if (bank->type == type && bank->prn == ch->prn && bank->fs == ch->fs &&
+            !strcmp(bank->sig, ch->sig)) break;
+    }
+    if (!bank) {
+        bank = (code_bank_t *)sdr_malloc(sizeof(code_bank_t));
+        snprintf(bank->sig, sizeof(bank->sig), "%s", ch->sig);
+        bank->prn = ch->prn;
+        bank->fs = ch->fs;
+        bank->type = type;
+        bank->nref = 1;
+        bank->next = code_banks;
+        code_banks = bank;
+        pthread_mutex_unlock(&code_banks_mtx);
+        
+        int ext;
+        void *data = gen_bank(ch, type, &ext);
+        
+        pthread_mutex_lock(&code_banks_mtx);
+        bank->data = data;
+        bank->ext = ext;
+        pthread_cond_broadcast(&code_banks_cond);
+    }
+    else {
+        bank->nref++;
+        while (!bank->data) {
+            pthread_cond_wait(&code_banks_cond, &code_banks_mtx);
+        }
+    }
+    void *data = bank->data;
+    pthread_mutex_unlock(&code_banks_mtx);
+    return data;
+}
+
+// release code bank to code bank cache ----------------------------------------
+static void release_bank(void *data)
+{
+    code_bank_t **p, *bank;
+    
+    if (!data) return;
+    pthread_mutex_lock(&code_banks_mtx);
+    for (p = &code_banks; (bank = *p); p = &bank->next) {
+        if (bank->data != data) continue;
+        if (--bank->nref <= 0) {
+            *p = bank->next;
+            if (!bank->ext) {
+                if (bank->type == BANK_TRK || bank->type == BANK_SEC) {
+                    sdr_free(bank->data);
+                }
+                else sdr_cpx_free((sdr_cpx_t *)bank->data);
+            }
+            sdr_free(bank);
+        }
+        break;
+    }
+    pthread_mutex_unlock(&code_banks_mtx);
+}
+
+// generate code FFT for signal acquisition ------------------------------------
+//  For the folded acquisition, the DDC and the folded IF data buffer are also
+//  generated.
+//
+static void acq_gen_code(sdr_acq_t *acq, const sdr_ch_t *ch)
+{
+    int D = fold_fact(ch);
+    
+    if (D >= 2) {
+        acq->code_fft = (sdr_cpx_t *)get_bank(ch, BANK_ACQ_FOLD);
+        acq->ddc = sdr_ddc_new(D, ch->fs, ch->fi);
+        acq->buff = sdr_buff_new(2 * ch->N / D, 2);
+    }
+    else {
+        acq->code_fft = (sdr_cpx_t *)get_bank(ch, BANK_ACQ);
+    }
+}
+
+// free code FFT for signal acquisition ----------------------------------------
+static void acq_free_code(sdr_acq_t *acq)
+{
+    release_bank(acq->code_fft);
+    sdr_ddc_free(acq->ddc);
+    sdr_buff_free(acq->buff);
+    acq->code_fft = NULL;
+    acq->ddc = NULL;
+    acq->buff = NULL;
+}
+
 // new signal acquisition ------------------------------------------------------
-static sdr_acq_t *acq_new(const int8_t *code, int len_code, double T, double fs,
-    int N)
+//  The code FFT is generated at the first signal search (see search_sig()).
+//
+static sdr_acq_t *acq_new(const sdr_ch_t *ch)
 {
     sdr_acq_t *acq = (sdr_acq_t *)sdr_malloc(sizeof(sdr_acq_t));
     
-    acq->code_fft = sdr_cpx_malloc(2 * N);
-    sdr_gen_code_fft(code, len_code, T, 0.0, fs, N, N, acq->code_fft);
     acq->fd_ext = 0.0;
-    acq->fds = sdr_dop_bins(T, 0.0, sdr_max_dop, &acq->len_fds);
+    acq->hand = 0;
+    acq->hand_rx = acq->hand_tx = acq->t_hand = 0.0;
+    acq->ddc = NULL;
+    acq->buff = NULL;
+    acq->fds = sdr_dop_bins(ch->T, 0.0, ch->opt->max_dop, &acq->len_fds);
     acq->P_sum = NULL;
+    acq->P_acc = NULL;
     acq->n_sum = 0;
     return acq;
 }
@@ -86,20 +338,36 @@ static sdr_acq_t *acq_new(const int8_t *code, int len_code, double T, double fs,
 static void acq_free(sdr_acq_t *acq)
 {
     if (!acq) return;
-    sdr_cpx_free(acq->code_fft);
+    acq_free_code(acq);
     sdr_free(acq->fds);
     sdr_free(acq->P_sum);
+    sdr_pacc_free(acq->P_acc);
     sdr_free(acq);
 }
 
+// generate resampled code or code FFT for signal tracking ---------------------
+//  No resampled code is generated for the code NCO correlator (trk->nco).
+//
+static void trk_gen_code(sdr_trk_t *trk, const sdr_ch_t *ch)
+{
+    if (ch->desc->corr == SDR_CORR_FFT) {
+        trk->code_fft = (sdr_cpx_t *)get_bank(ch, BANK_TRK_FFT);
+    }
+    else if (!trk->nco) {
+        trk->code = (sdr_cpx16_t *)get_bank(ch, BANK_TRK);
+    }
+}
+
 // new signal tracking ---------------------------------------------------------
-static sdr_trk_t *trk_new(const char *sig, int prn, const int8_t *code,
-    int len_code, double T, double fs)
+//  The resampled code or code FFT is generated at the start of tracking (see
+//  start_track()).
+//
+static sdr_trk_t *trk_new(const sdr_ch_t *ch)
 {
     sdr_trk_t *trk = (sdr_trk_t *)sdr_malloc(sizeof(sdr_trk_t));
     int i = 0, npos = (SDR_N_CORR - 5) / 2;
     
-    int pos = (int)(sdr_sp_corr * T / len_code * fs) + 1;
+    int pos = (int)(ch->opt->sp_corr * ch->T / ch->len_code * ch->fs) + 1;
     trk->pos[i++] = 0;    // P
     trk->pos[i++] = -pos; // E
     trk->pos[i++] = pos;  // L
@@ -108,25 +376,11 @@ static sdr_trk_t *trk_new(const char *sig, int prn, const int8_t *code,
         trk->pos[i++] = pos;
     }
     trk->npos = 4;
+    trk->nco = ch->opt->trk_nco;
     trk->sec_sync = trk->sec_pol = 0;
     trk->err_phas = 0.0;
     trk->sumP = trk->sumE = trk->sumL = trk->sumN = 0.0;
-    int N = (int)(fs * T);
-    if (!strcmp(sig, "L6D") || !strcmp(sig, "L6E")) {
-        trk->code_fft = sdr_cpx_malloc(N * N_CODE);
-        for (int i = 0; i < N_CODE; i++) {
-            double coff = -i / fs / N_CODE;
-            sdr_gen_code_fft(code, len_code, T, coff, fs, N, 0,
-                trk->code_fft + i * N);
-        }
-    }
-    else {
-        trk->code = (sdr_cpx16_t *)sdr_malloc(sizeof(sdr_cpx16_t) * N * N_CODE);
-        for (int i = 0; i < N_CODE; i++) {
-            double coff = -i / fs / N_CODE;
-            sdr_res_code(code, len_code, T, coff, fs, N, 0, trk->code + i * N);
-        }
-    }
+    trk->P = sdr_hist_new(SDR_N_HIST, sizeof(sdr_cpx_t));
     return trk;
 }
 
@@ -134,8 +388,11 @@ static sdr_trk_t *trk_new(const char *sig, int prn, const int8_t *code,
 static void trk_free(sdr_trk_t *trk)
 {
     if (!trk) return;
-    sdr_free(trk->code);
-    sdr_cpx_free(trk->code_fft);
+    sdr_hist_free(trk->P);
+    release_bank(trk->code);
+    release_bank(trk->code_fft);
+    release_bank(trk->sec_tbl);
+    sdr_free(trk->sec_bits);
     sdr_free(trk);
 }
 
@@ -147,17 +404,22 @@ static void trk_free(sdr_trk_t *trk)
 //      prn      (I)  PRN number
 //      fs       (I)  Sampling frequency (Hz)
 //      fi       (I)  IF carrier frequency (Hz)
+//      opt      (I)  Options (NULL: default options by sdr_rcv_setopt())
+//                    (referred by the channel while it is used)
 //
 //  return:
 //      Receiver channel (NULL: error)
 //
-sdr_ch_t *sdr_ch_new(const char *sig, int prn, double fs, double fi)
+sdr_ch_t *sdr_ch_new_opt(const char *sig, int prn, double fs, double fi,
+    const sdr_opt_t *opt)
 {
     sdr_ch_t *ch = (sdr_ch_t *)sdr_malloc(sizeof(sdr_ch_t));
     
+    ch->opt = opt ? opt : sdr_rcv_defopt();
     ch->state = SDR_STATE_IDLE;
     ch->time = 0.0;
     sig_upper(sig, ch->sig);
+    ch->desc = sdr_sig_desc(ch->sig);
     ch->prn = prn;
     sdr_sat_id(ch->sig, prn, ch->sat);
     if (!(ch->code = sdr_gen_code(sig, prn, &ch->len_code)) ||
@@ -172,14 +434,20 @@ sdr_ch_t *sdr_ch_new(const char *sig, int prn, double fs, double fi)
     ch->N = (int)(fs * ch->T);
     ch->fd = ch->coff = ch->adr = ch->cn0 = 0.0;
     ch->lock = ch->lost = 0;
-    ch->costas = strcmp(ch->sig, "L6D") && strcmp(ch->sig, "L6E");
-    ch->acq = acq_new(ch->code, ch->len_code, ch->T, fs, ch->N);
-    ch->trk = trk_new(ch->sig, ch->prn, ch->code, ch->len_code, ch->T, fs);
+    ch->costas = ch->desc->corr != SDR_CORR_FFT;
+    ch->acq = acq_new(ch);
+    ch->trk = trk_new(ch);
     ch->nav = sdr_nav_new();
     pthread_mutex_init(&ch->mtx, NULL);
     return ch;
 }
 
+// generate new receiver channel with default options -------------------------
+sdr_ch_t *sdr_ch_new(const char *sig, int prn, double fs, double fi)
+{
+    return sdr_ch_new_opt(sig, prn, fs, fi, NULL);
+}
+
 //------------------------------------------------------------------------------
 //  Free receiver channel.
 //
@@ -198,14 +466,127 @@ void sdr_ch_free(sdr_ch_t *ch)
     sdr_free(ch);
 }
 
+//------------------------------------------------------------------------------
+//  Suspend receiver channel. The code and the correlation buffers for signal
+//  acquisition and tracking of the IDLE channel are released until resumed by
+//  sdr_ch_resume(). The suspended channel shall be kept as IDLE.
+//
+//  args:
+//      ch       (I) Receiver channel
+//
+//  return:
+//      Status (1: suspended, 0: not IDLE or already suspended)
+//
+int sdr_ch_suspend(sdr_ch_t *ch)
+{
+    if (ch->state != SDR_STATE_IDLE || ch->susp) return 0;
+    
+    pthread_mutex_lock(&ch->mtx);
+    acq_free_code(ch->acq);
+    sdr_free(ch->acq->P_sum);
+    sdr_pacc_free(ch->acq->P_acc);
+    release_bank(ch->trk->code);
+    release_bank(ch->trk->code_fft);
+    release_bank(ch->trk->sec_tbl);
+    sdr_free(ch->trk->sec_bits);
+    ch->acq->P_sum = NULL;
+    ch->acq->P_acc = NULL;
+    ch->acq->n_sum = 0;
+    ch->trk->code = NULL;
+    ch->trk->code_fft = NULL;
+    ch->trk->sec_tbl = NULL;
+    ch->trk->sec_bits = NULL;
+    ch->susp = 1;
+    pthread_mutex_unlock(&ch->mtx);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//  Resume receiver channel suspended by sdr_ch_suspend(). Only the flag is
+//  cleared, so the caller (the receiver thread) is not blocked. The code banks
+//  and the code FFTs are generated again by the worker thread of the channel
+//  at the next signal search or tracking in sdr_ch_update().
+//
+//  args:
+//      ch       (I) Receiver channel
+//
+//  return:
+//      Status (1: resumed, 0: not suspended)
+//
+int sdr_ch_resume(sdr_ch_t *ch)
+{
+    if (!ch->susp) return 0;
+    
+    pthread_mutex_lock(&ch->mtx);
+    ch->susp = 0;
+    pthread_mutex_unlock(&ch->mtx);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//  Start signal search of IDLE receiver channel. The signal is searched at the
+//  following calls of sdr_ch_update().
+//
+//  args:
+//      ch       (I) Receiver channel
+//
+//  return:
+//      Status (1: search started, 0: not IDLE or suspended)
+//
+int sdr_ch_search(sdr_ch_t *ch)
+{
+    if (ch->state != SDR_STATE_IDLE || ch->susp) return 0;
+    ch->state = SDR_STATE_SRCH;
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//  Get receiver channel status as fixed layout view (see sdr_ch_view_t).
+//
+//  args:
+//      ch       (I) Receiver channel
+//      view     (O) Channel status view
+//
+//  return:
+//      none
+//
+void sdr_ch_get_view(sdr_ch_t *ch, sdr_ch_view_t *view)
+{
+    view->no = ch->no;
+    view->rf_ch = ch->rf_ch + 1;
+    view->prn = ch->prn;
+    view->state = ch->state;
+    memcpy(view->sat, ch->sat, sizeof(view->sat) - 1); // truncated
+    view->sat[sizeof(view->sat)-1] = '\0';
+    memcpy(view->sig, ch->sig, sizeof(view->sig) - 1);
+    view->sig[sizeof(view->sig)-1] = '\0';
+    view->sync[0] = ch->trk->sec_sync > 0 ? 'S' : '-';
+    view->sync[1] = ch->nav->ssync > 0 ? 'B' : '-';
+    view->sync[2] = ch->nav->fsync > 0 ? 'F' : '-';
+    view->sync[3] = ch->nav->rev ? 'R' : '-';
+    view->sync[4] = '\0';
+    view->time = ch->time;
+    view->lock = ch->lock * ch->T;
+    view->cn0 = ch->cn0;
+    view->coff = ch->coff * 1e3;
+    view->fd = ch->fd;
+    view->adr = ch->adr;
+    view->nnav = ch->nav->count[0];
+    view->nerr = ch->nav->count[1];
+    view->lost = ch->lost;
+    view->fec = ch->nav->nerr;
+}
+
 // initialize signal tracking --------------------------------------------------
 static void trk_init(sdr_trk_t *trk)
 {
     trk->err_phas = 0.0;
     trk->sec_sync = trk->sec_pol = 0;
+    trk->sec_sum = 0.0f;
+    trk->sec_n = 0;
     trk->sumP = trk->sumE = trk->sumL = trk->sumN = 0.0;
     memset(trk->C, 0, sizeof(sdr_cpx_t) * SDR_N_CORR);
-    memset(trk->P, 0, sizeof(sdr_cpx_t) * SDR_N_HIST);
+    sdr_hist_clear(trk->P);
 }
 
 // start tracking --------------------------------------------------------------
@@ -221,40 +602,135 @@ static void start_track(sdr_ch_t *ch, double time, double fd, double coff,
     ch->cn0 = cn0;
     ch->week = 0;
     ch->tow = -1;
+    if (!ch->trk->code && !ch->trk->code_fft) {
+        trk_gen_code(ch->trk, ch);
+    }
     trk_init(ch->trk);
     sdr_nav_init(ch->nav);
 }
 
+// start tracking by handover from other band of satellite ---------------------
+//  The code offset is given by the transmit time of the code start of the other
+//  band propagated with the code rate by the Doppler, as the code starts of all
+//  bands of the satellite are aligned to the system time. The residual delay
+//  between the bands is pulled in by DLL.
+static void hand_track(sdr_ch_t *ch, double time)
+{
+    double fd = ch->acq->fd_ext, rate = 1.0 + fd / ch->fc;
+    double tx = ch->acq->hand_tx + (time - ch->acq->hand_rx) * rate;
+    double coff = (ceil(tx / ch->T) * ch->T - tx) / rate;
+    
+    if (coff >= ch->T) coff -= ch->T;
+    ch->acq->hand = 0;
+    start_track(ch, time, fd, coff, ch->opt->thres_cn0_l);
+    sdr_log(4, "$LOG,%.3f,%s,%d,SIGNAL HANDOVER (%.1f,%.7f)", time, ch->sig,
+        ch->prn, fd, coff * 1e3);
+}
+
+// refine code offset of folded acquisition -----------------------------------
+//  The code offsets within +/-D samples around the peak of the folded
+//  acquisition are correlated at the full rate by the code NCO correlator with
+//  the IF data of the code cycle.
+//
+static double fold_coff(const sdr_ch_t *ch, const sdr_buff_t *buff, int ix,
+    double fd, int k)
+{
+    sdr_cpx_t corr[2*MAX_FOLD+1];
+    int D = MAX(MIN(ch->acq->ddc->D, MAX_FOLD), 1); // by fold_fact()
+    int pos[2*MAX_FOLD+1], n = 2 * D + 1, i_max = D;
+    float P_max = 0.0f;
+    
+    for (int i = 0; i < n; i++) {
+        pos[i] = i - D;
+    }
+    sdr_corr_nco(buff, (ix + k) % buff->N, ch->N, ch->fs, ch->fi + fd, 0.0,
+        ch->code, ch->len_code, ch->T, 0.0, pos, n, corr);
+    
+    for (int i = 0; i < n; i++) {
+        float P = SQR(corr[i][0]) + SQR(corr[i][1]);
+        if (P <= P_max) continue;
+        P_max = P;
+        i_max = i;
+    }
+    return ((k + pos[i_max] + ch->N) % ch->N) / ch->fs;
+}
+
 // search signal ---------------------------------------------------------------
+//  For the folded acquisition, the IF data of 2 code cycles are mixed with the
+//  carrier of the IF frequency and decimated to 2 samples/chip or more by the
+//  DDC, the code is searched in the folded IF data by the FFTs of the reduced
+//  size and the code offset is refined at the full rate (see fold_coff()).
+//
 static void search_sig(sdr_ch_t *ch, double time, const sdr_buff_t *buff,
     int ix)
 {
     float *fds = ch->acq->fds, fd_ext[3];
     int n = ch->acq->len_fds;
     
+    if (ch->acq->hand) { // handover by other band w/o search
+        hand_track(ch, time);
+        return;
+    }
     if (ch->acq->fd_ext != 0.0) { // assist by external Doppler
         for (n = 0; n < 3; n++) {
             fd_ext[n] = ch->acq->fd_ext + (n - 1) * 0.5 / ch->T;
         }
         fds = fd_ext;
     }
-    if (!ch->acq->P_sum) {
-        ch->acq->P_sum = (float *)sdr_malloc(sizeof(float) * 2 * ch->N * n);
+    if (!ch->acq->code_fft) {
+        acq_gen_code(ch->acq, ch);
+    }
+    const sdr_buff_t *buff_s = buff;
+    int ix_s = ix, D = 1;
+    double fi = ch->fi;
+    
+    if (ch->acq->ddc) { // fold IF data of 2 code cycles
+        D = ch->acq->ddc->D;
+        sdr_ddc_proc(ch->acq->ddc, buff, ix, 2 * ch->N, ch->acq->buff, 0);
+        buff_s = ch->acq->buff;
+        ix_s = 0;
+        fi = 0.0;
     }
+    int N = ch->N / D;
+    
     // parallel code search and non-coherent integration
-    sdr_search_code(ch->acq->code_fft, ch->T, buff, ix, 2 * ch->N, ch->fs,
-        ch->fi, fds, n, ch->acq->P_sum);
+    if (ch->opt->acq_pack) {
+        if (!ch->acq->P_acc) {
+            ch->acq->P_acc = sdr_pacc_new(N, n);
+        }
+        sdr_search_code_pacc(ch->acq->code_fft, ch->T, buff_s, ix_s, 2 * N,
+            ch->fs / D, fi, fds, n, ch->acq->P_acc);
+    }
+    else {
+        if (!ch->acq->P_sum) {
+            ch->acq->P_sum = (float *)sdr_malloc(sizeof(float) * 2 * N * n);
+        }
+        sdr_search_code(ch->acq->code_fft, ch->T, buff_s, ix_s, 2 * N,
+            ch->fs / D, fi, fds, n, ch->acq->P_sum);
+    }
     ch->acq->n_sum++;
     
-    if (ch->acq->n_sum * ch->T >= sdr_t_acq) {
-        int ix[2];
+    if (ch->acq->n_sum * ch->T >= ch->opt->t_acq) {
+        int idx[2];
+        double fd;
+        float cn0;
         
         // search max correlation power
-        float cn0 = sdr_corr_max(ch->acq->P_sum, 2 * ch->N, ch->N, n, ch->T, ix);
-        
-        if (cn0 >= sdr_thres_cn0_l) {
-            double fd = sdr_fine_dop(ch->acq->P_sum, 2 * ch->N, fds, n, ix);
-            double coff = ix[1] / ch->fs;
+        if (ch->acq->P_acc) {
+            cn0 = sdr_pacc_corr_max(ch->acq->P_acc, ch->T, idx);
+        }
+        else {
+            cn0 = sdr_corr_max(ch->acq->P_sum, 2 * N, N, n, ch->T, idx);
+        }
+        if (cn0 >= ch->opt->thres_cn0_l) {
+            if (ch->acq->P_acc) {
+                fd = sdr_pacc_fine_dop(ch->acq->P_acc, fds, n, idx);
+            }
+            else {
+                fd = sdr_fine_dop(ch->acq->P_sum, 2 * N, fds, n, idx);
+            }
+            double coff = D >= 2 ? fold_coff(ch, buff, ix, fd, idx[1] * D) :
+                idx[1] / ch->fs;
             start_track(ch, time, fd, coff, cn0);
             sdr_log(4, "$LOG,%.3f,%s,%d,SIGNAL FOUND (%.1f,%.1f,%.7f)", time,
                 ch->sig, ch->prn, cn0, fd, coff * 1e3);
@@ -266,43 +742,122 @@ static void search_sig(sdr_ch_t *ch, double time, const sdr_buff_t *buff,
                 ch->prn, cn0);
         }
         sdr_free(ch->acq->P_sum);
+        sdr_pacc_free(ch->acq->P_acc);
         ch->acq->P_sum = NULL;
+        ch->acq->P_acc = NULL;
         ch->acq->n_sum = 0;
     }
 }
 
+// add sign of P correlation to rolling hash ----------------------------------
+//  The signs of the last N P correlations are kept as a ring of bits and the
+//  rolling hash of them is updated in O(1). The hash is restarted at the gap
+//  of the lock count by the adjustment of the code offset.
+//
+static void sec_add_sign(sdr_ch_t *ch, int N, float I)
+{
+    sdr_trk_t *trk = ch->trk;
+    const sec_tbl_t *tbl = (const sec_tbl_t *)trk->sec_tbl;
+    uint64_t s = I >= 0.0f, *bits = trk->sec_bits;
+    
+    if (ch->lock != trk->sec_lock + 1) {
+        trk->sec_n = 0;
+        trk->sec_hash = 0;
+    }
+    int i = trk->sec_n % N;
+    trk->sec_hash = trk->sec_hash * SEC_B + s;
+    if (trk->sec_n >= N) {
+        trk->sec_hash -= ((bits[i/64] >> (i % 64)) & 1) * tbl->pow;
+    }
+    bits[i/64] = (bits[i/64] & ~(1ull << (i % 64))) | (s << (i % 64));
+    if (++trk->sec_n >= 2 * N) trk->sec_n -= N;
+    trk->sec_lock = ch->lock;
+}
+
+// find secondary code phase ---------------------------------------------------
+//  All code phases are tested by the lookup of the rolling hash and its
+//  complement in the sync table. The matched phase is verified by the signs and
+//  the mean of absolute P correlations (THRES_SYNC). The code phase of the last
+//  P correlation is returned (-1: not found).
+//
+static int sec_find(const sdr_ch_t *ch, int N, int *pol)
+{
+    const sdr_trk_t *trk = ch->trk;
+    const sec_tbl_t *tbl = (const sec_tbl_t *)trk->sec_tbl;
+    const sdr_cpx_t *hist = (const sdr_cpx_t *)sdr_hist_data(trk->P);
+    
+    if (trk->sec_n < N) return -1;
+    
+    for (int p = 0; p < 2; p++) {
+        int k = sec_tbl_get(tbl, p ? tbl->ones - trk->sec_hash : trk->sec_hash);
+        if (k < 0) continue;
+        float R = 0.0f;
+        int i;
+        for (i = 0; i < N; i++) {
+            int j = (trk->sec_n - N + i) % N;
+            int s = (trk->sec_bits[j/64] >> (j % 64)) & 1;
+            if (s != ((ch->sec_code[(k + 1 + i) % N] > 0) ^ p)) break;
+            R += fabsf(hist[SDR_N_HIST-N+i][0]) / N;
+        }
+        if (i < N || R < THRES_SYNC) continue;
+        *pol = p ? -1 : 1;
+        return k;
+    }
+    return -1;
+}
+
 // sync and remove secondary code ----------------------------------------------
+//  The secondary code is synced at any code phase by the rolling hash of the
+//  signs of P correlations (see sec_find()). At the sync, the code is also
+//  removed from the P correlations of the last code period. The sync is lost
+//  if the mean of P correlations of a code period drops under THRES_LOST.
+//
 static void sync_sec_code(sdr_ch_t *ch, int N)
 {
-    if (ch->trk->sec_sync == 0) {
-        float P = 0.0, R = 0.0;
-        for (int i = 0; i < N; i++) {
-            P += ch->trk->P[SDR_N_HIST-N+i][0] * ch->sec_code[i] / N;
-            R += fabsf(ch->trk->P[SDR_N_HIST-N+i][0]) / N;
-        }
-        if (fabsf(P) >= R && R >= THRES_SYNC) {
-            ch->trk->sec_sync = ch->lock;
-            ch->trk->sec_pol = (P > 0.0f) ? 1 : -1;
-        }
+    sdr_trk_t *trk = ch->trk;
+    const sdr_cpx_t *hist = (const sdr_cpx_t *)sdr_hist_data(trk->P);
+    int k, pol;
+    
+    if (!trk->sec_tbl) {
+        trk->sec_tbl = get_bank(ch, BANK_SEC);
+        trk->sec_bits = (uint64_t *)sdr_malloc(sizeof(uint64_t) *
+            ((N + 63) / 64));
     }
-    else if ((ch->lock - ch->trk->sec_sync) % N == 0) {
-        float P = 0.0;
-        for (int i = 0; i < N; i++) {
-            P += ch->trk->P[SDR_N_HIST-N+i][0] / N;
-        }
-        if (fabsf(P) < THRES_LOST) {
-            ch->trk->sec_sync = ch->trk->sec_pol = 0;
+    sec_add_sign(ch, N, hist[SDR_N_HIST-1][0]);
+    
+    if (trk->sec_sync == 0 && (k = sec_find(ch, N, &pol)) >= 0 &&
+        ch->lock > k + 1) {
+        trk->sec_sync = ch->lock - k - 1;
+        trk->sec_pol = pol;
+        trk->sec_sum = 0.0f;
+        for (int i = 0; i < N - 1; i++) {
+            int8_t C = ch->sec_code[(k + 1 + i) % N] * pol;
+            sdr_cpx_t P;
+            P[0] = hist[SDR_N_HIST-N+i][0] * C;
+            P[1] = hist[SDR_N_HIST-N+i][1] * C;
+            sdr_hist_set(trk->P, SDR_N_HIST - N + i, P);
+            if (i >= N - 1 - k) trk->sec_sum += P[0];
         }
     }
-    if (ch->trk->sec_sync > 0) {
-        int8_t C = ch->sec_code[(ch->lock - ch->trk->sec_sync - 1) % N] *
-            ch->trk->sec_pol;
-        for (int i = 0; i < ch->trk->npos; i++) {
-            ch->trk->C[i][0] *= C;
-            ch->trk->C[i][1] *= C;
+    if (trk->sec_sync > 0) {
+        int i = (ch->lock - trk->sec_sync - 1) % N;
+        int8_t C = ch->sec_code[i] * trk->sec_pol;
+        for (int j = 0; j < trk->npos; j++) {
+            trk->C[j][0] *= C;
+            trk->C[j][1] *= C;
+        }
+        sdr_cpx_t P1;
+        P1[0] = hist[SDR_N_HIST-1][0] * C;
+        P1[1] = hist[SDR_N_HIST-1][1] * C;
+        sdr_hist_set(trk->P, SDR_N_HIST - 1, P1);
+        trk->sec_sum += P1[0];
+        
+        if (i == N - 1) { // end of code period
+            if (fabsf(trk->sec_sum) / N < THRES_LOST) {
+                trk->sec_sync = trk->sec_pol = 0;
+            }
+            trk->sec_sum = 0.0f;
         }
-        ch->trk->P[SDR_N_HIST-1][0] *= C;
-        ch->trk->P[SDR_N_HIST-1][1] *= C;
     }
 }
 
@@ -310,14 +865,16 @@ static void sync_sec_code(sdr_ch_t *ch, int N)
 static void FLL(sdr_ch_t *ch)
 {
     if (ch->lock >= 2) {
-        double IP1 = ch->trk->P[SDR_N_HIST-1][0];
-        double QP1 = ch->trk->P[SDR_N_HIST-1][1];
-        double IP2 = ch->trk->P[SDR_N_HIST-2][0];
-        double QP2 = ch->trk->P[SDR_N_HIST-2][1];
+        const sdr_cpx_t *hist = (const sdr_cpx_t *)sdr_hist_data(ch->trk->P);
+        double IP1 = hist[SDR_N_HIST-1][0];
+        double QP1 = hist[SDR_N_HIST-1][1];
+        double IP2 = hist[SDR_N_HIST-2][0];
+        double QP2 = hist[SDR_N_HIST-2][1];
         double dot   = IP1 * IP2 + QP1 * QP2;
         double cross = IP1 * QP2 - QP1 * IP2;
         if (dot != 0.0) {
-            double B = ch->lock * ch->T < T_FPULLIN ? sdr_b_fll_w : sdr_b_fll_n;
+            double B = ch->lock * ch->T < T_FPULLIN ? ch->opt->b_fll_w :
+                ch->opt->b_fll_n;
             double err_freq = ch->costas ? atan(cross / dot) : atan2(cross, dot);
             ch->fd -= B / 0.25 * err_freq / DPI;
         }
@@ -331,7 +888,7 @@ static void PLL(sdr_ch_t *ch)
     double QP = ch->trk->C[0][1];
     if (IP != 0.0) {
         double err_phas = (ch->costas ? atan(QP / IP) : atan2(QP, IP)) / DPI;
-        double W = sdr_b_pll / 0.53;
+        double W = ch->opt->b_pll / 0.53;
         ch->fd += 1.4 * W * (err_phas - ch->trk->err_phas) +
             W * W * err_phas * ch->T;
         ch->trk->err_phas = err_phas;
@@ -341,7 +898,7 @@ static void PLL(sdr_ch_t *ch)
 // DLL -------------------------------------------------------------------------
 static void DLL(sdr_ch_t *ch)
 {
-    int N = MAX(1, (int)(sdr_t_dll / ch->T));
+    int N = MAX(1, (int)(ch->opt->t_dll / ch->T));
     ch->trk->sumE += sdr_cpx_abs(ch->trk->C[1]); // non-coherent sum 
     ch->trk->sumL += sdr_cpx_abs(ch->trk->C[2]);
     if (ch->lock % N == 0) {
@@ -349,7 +906,7 @@ static void DLL(sdr_ch_t *ch)
         double L = ch->trk->sumL;
         if (E + L > 0.0) {
             double err_code = (E - L) / (E + L) * 0.5f * ch->T / ch->len_code;
-            ch->coff -= sdr_b_dll / 0.25 * err_code * ch->T * N;
+            ch->coff -= ch->opt->b_dll / 0.25 * err_code * ch->T * N;
             ch->trk->err_code = err_code;
         }
         ch->trk->sumE = ch->trk->sumL = 0.0;
@@ -384,7 +941,7 @@ static void CSK(sdr_ch_t *ch, const sdr_cpx_t *corr)
 {
     double R = (double)ch->N / (ch->len_code / 2); // samples / chips 
     int n = (int)(280 * R);
-    sdr_cpx_t *C = sdr_cpx_malloc(2 * n);
+    sdr_cpx_t *C = (sdr_cpx_t *)sdr_scratch_alloc(sizeof(sdr_cpx_t) * 2 * n);
     memcpy(C, corr + ch->N - n, sizeof(sdr_cpx_t) * n);
     memcpy(C + n, corr, sizeof(sdr_cpx_t) * n);
     
@@ -401,13 +958,14 @@ static void CSK(sdr_ch_t *ch, const sdr_cpx_t *corr)
     }
     // add CSK symbol to buffer 
     uint8_t sym = (uint8_t)(255 - ix % 256);
-    sdr_add_buff(ch->nav->syms, SDR_MAX_NSYM, &sym, sizeof(sym));
+    sdr_hist_add(ch->nav->syms, &sym);
+    ch->nav->nsym++;
     
     // generate correlator outputs
     for (int i = 0; i < ch->trk->npos; i++) {
         interp_corr(C, n + ix * R + ch->trk->pos[i], ch->trk->C + i);
     }
-    sdr_cpx_free(C);
+    sdr_scratch_free(C);
 }
 
 // update TOW ------------------------------------------------------------------
@@ -417,6 +975,15 @@ static void update_tow(sdr_ch_t *ch, double sec)
     ch->tow = (ch->tow + (int)(sec / 1e-3)) % (86400 * 7 * 1000);
 }
 
+// reset signal tracking at loss of lock ---------------------------------------
+static void reset_trk(sdr_ch_t *ch)
+{
+    ch->state = SDR_STATE_IDLE;
+    ch->lock = 0;
+    ch->trk->sec_sync = ch->trk->sec_pol = 0;
+    ch->nav->ssync = ch->nav->fsync = ch->nav->rev = 0;
+}
+
 // track signal ----------------------------------------------------------------
 static void track_sig(sdr_ch_t *ch, double time, const sdr_buff_t *buff, int ix)
 {
@@ -431,32 +998,38 @@ static void track_sig(sdr_ch_t *ch, double time, const sdr_buff_t *buff, int ix)
         ch->coff -= ch->T;
         update_tow(ch, -ch->T);
         ch->lock--;
-        memmove(ch->trk->P + 1, ch->trk->P, sizeof(sdr_cpx_t) *
-            (SDR_N_HIST - 1));
+        sdr_hist_back(ch->trk->P);
     }
     else if (ch->coff < 0.0) {
         ch->coff += ch->T;
         update_tow(ch, ch->T);
         ch->lock++;
-        memmove(ch->trk->P, ch->trk->P + 1, sizeof(sdr_cpx_t) *
-            (SDR_N_HIST - 1));
+        const sdr_cpx_t *hist = (const sdr_cpx_t *)sdr_hist_data(ch->trk->P);
+        sdr_hist_add(ch->trk->P, hist + SDR_N_HIST - 1);
     }
     // code position (samples) and carrier phase (cyc) 
     int i = (int)(ch->coff * ch->fs);
     int j = (int)((ch->coff * ch->fs - i) * N_CODE); // code bank index
     double phi = ch->fi * tau + ch->adr + fc * i / ch->fs;
     
-    if (!strcmp(ch->sig, "L6D") || !strcmp(ch->sig, "L6E")) {
-        sdr_cpx_t *corr = sdr_cpx_malloc(ch->N);
+    if (ch->desc->corr == SDR_CORR_FFT) {
+        sdr_cpx_t *corr = (sdr_cpx_t *)sdr_scratch_alloc(sizeof(sdr_cpx_t) *
+            ch->N);
         
-        // FFT correlator 
-        sdr_corr_fft(buff, ix + i, ch->N, ch->fs, fc, phi,
+        // FFT correlator with data spectrum shared by L6D and L6E
+        sdr_corr_fft_share(buff, ix + i, ch->N, ch->fs, fc, phi, time,
             ch->trk->code_fft + j * ch->N, corr);
         
         // decode L6 CSK 
         CSK(ch, corr);
         
-        sdr_cpx_free(corr);
+        sdr_scratch_free(corr);
+    }
+    else if (ch->trk->nco) {
+        // standard correlator with code NCO
+        sdr_corr_nco(buff, ix + i, ch->N, ch->fs, fc, phi, ch->code,
+            ch->len_code, ch->T, -(ch->coff * ch->fs - i) / ch->fs,
+            ch->trk->pos, ch->trk->npos, ch->trk->C);
     }
     else {
         // standard correlator
@@ -464,7 +1037,7 @@ static void track_sig(sdr_ch_t *ch, double time, const sdr_buff_t *buff, int ix)
             ch->trk->code + j * ch->N, ch->trk->pos, ch->trk->npos, ch->trk->C);
     }
     // add P correlator outputs to history 
-    sdr_add_buff(ch->trk->P, SDR_N_HIST, ch->trk->C[0], sizeof(sdr_cpx_t));
+    sdr_hist_add(ch->trk->P, ch->trk->C[0]);
     update_tow(ch, ch->T);
     ch->lock++;
     
@@ -482,15 +1055,18 @@ static void track_sig(sdr_ch_t *ch, double time, const sdr_buff_t *buff, int ix)
     DLL(ch);
     CN0(ch);
     
-    // decode navigation data 
-    if (ch->lock * ch->T >= T_NPULLIN) {
+    // decode navigation data (skipped by load shedding after TOW resolved)
+    if (ch->lock * ch->T >= T_NPULLIN && !(ch->shed && ch->tow >= 0)) {
+        double t0 = ch->opt->prof ? sdr_get_cputime() : 0.0;
+        int64_t ts = sdr_trace_begin();
         sdr_nav_decode(ch);
+        sdr_trace_end("nav", ch->desc->sig, ch->no, ts);
+        if (ch->opt->prof) {
+            ch->cpu[2] += (int64_t)((sdr_get_cputime() - t0) * 1e9);
+        }
     }
-    if (ch->cn0 < sdr_thres_cn0_u) { // signal lost 
-        ch->state = SDR_STATE_IDLE;
-        ch->lock = 0;
-        ch->trk->sec_sync = ch->trk->sec_pol = 0;
-        ch->nav->ssync = ch->nav->fsync = ch->nav->rev = 0;
+    if (ch->cn0 < ch->opt->thres_cn0_u) { // signal lost 
+        reset_trk(ch);
         ch->lost++;
         sdr_log(4, "$LOG,%.3f,%s,%d,SIGNAL LOST (%s, %.1f)", ch->time, ch->sig,
             ch->prn, ch->sig, ch->cn0);
@@ -506,7 +1082,13 @@ static void track_sig(sdr_ch_t *ch, double time, const sdr_buff_t *buff, int ix)
 //  also accessed as object instance variables of the receiver channel after
 //  calling the function. The function should be called in the cycle of GNSS
 //  signal code with 2-cycle samples of digitized IF data (which are overlapped
-//  between previous and current). 
+//  between previous and current). If the option prof is set, the CPU time of
+//  the tracking, the acquisition and the nav decoding are accumulated to
+//  ch.cpu. The spans of the update are recorded while tracing (see
+//  sdr_trace_start()) with the signal ID and the channel number. If ch.shed is
+//  set by the load shedding of the receiver, the nav decoding is skipped
+//  after the TOW resolved (1) or the tracking is stopped and the channel is
+//  kept as IDLE (2).
 //
 //    SDR_STATE_SRCH : signal acquisition state
 //    SDR_STATE_LOCK : signal tracking state
@@ -523,13 +1105,31 @@ static void track_sig(sdr_ch_t *ch, double time, const sdr_buff_t *buff, int ix)
 //
 void sdr_ch_update(sdr_ch_t *ch, double time, const sdr_buff_t *buff, int ix)
 {
+    double t0 = ch->opt->prof ? sdr_get_cputime() : 0.0;
+    int64_t t_nav = ch->cpu[2], ts = sdr_trace_begin();
+    int stage = -1;
+    
+    if (ch->shed >= 2 && ch->state == SDR_STATE_LOCK) { // paused
+        pthread_mutex_lock(&ch->mtx);
+        reset_trk(ch);
+        pthread_mutex_unlock(&ch->mtx);
+    }
     if (ch->state == SDR_STATE_SRCH) {
         search_sig(ch, time, buff, ix);
+        stage = 1;
     }
     else if (ch->state == SDR_STATE_LOCK) {
         pthread_mutex_lock(&ch->mtx);
         track_sig(ch, time, buff, ix);
         pthread_mutex_unlock(&ch->mtx);
+        stage = 0;
+    }
+    if (stage >= 0) {
+        sdr_trace_end(stage ? "acq" : "track", ch->desc->sig, ch->no, ts);
+    }
+    if (ch->opt->prof && stage >= 0) { // CPU time w/o nav decoding
+        ch->cpu[stage] += (int64_t)((sdr_get_cputime() - t0) * 1e9) -
+            (ch->cpu[2] - t_nav);
     }
 }
 
@@ -565,7 +1165,8 @@ int sdr_ch_corr_hist(sdr_ch_t *ch, double tspan, double *stat, sdr_cpx_t *P)
     int n = MIN((int)(tspan / ch->T), SDR_N_HIST);
     stat[0] = ch->time;
     stat[1] = ch->T;
-    memcpy(P, ch->trk->P + SDR_N_HIST - n, sizeof(sdr_cpx_t) * n);
+    memcpy(P, (sdr_cpx_t *)sdr_hist_data(ch->trk->P) + SDR_N_HIST - n,
+        sizeof(sdr_cpx_t) * n);
     pthread_mutex_unlock(&ch->mtx);
     return n;
 }
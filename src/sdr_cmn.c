@@ -10,13 +10,38 @@
 //  2022-05-17  1.1  add API sdr_cpx_malloc(), sdr_cpx_free()
 //  2022-07-08  1.2  add API sdr_get_time()
 //                   move API sdr_cpx_malloc(), sdr_cpx_free() to sdr_func.c
+//  2026-10-14  1.3  add API sdr_get_ncpu(), sdr_cond_wait()
+//                   add API sdr_malloc_huge(), sdr_free_huge(), sdr_get_nnode()
+//                   add API sdr_set_thread()
+//                   add API sdr_get_clock()
+//  2026-10-15  1.4  add API sdr_get_cputime()
 //
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // for pthread_setaffinity_np()
+#endif
 #include "pocket_sdr.h"
 #ifndef WIN32
 #include <time.h>
+#include <unistd.h>
+#include <sched.h>
 #include <sys/time.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#endif
+#ifdef __linux__
+#include <sys/syscall.h>
 #endif
 
+// constants and macros --------------------------------------------------------
+#define PAGE_2M       ((size_t)1 << 21) // 2 MB huge page size
+#define PAGE_1G       ((size_t)1 << 30) // 1 GB huge page size
+#define MAX_NODE      64    // max number of NUMA nodes
+#define MPOL_PREF     1     // NUMA memory policy MPOL_PREFERRED
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#define ROUND_UP(x, n) (((x) + (n) - 1) / (n) * (n))
+
 //------------------------------------------------------------------------------
 //  Allocate memory. If no memory allocated, it exits the AP immediately with
 //  an error message.
@@ -52,6 +77,100 @@ void sdr_free(void *p)
     free(p);
 }
 
+#ifndef WIN32
+// map anonymous memory --------------------------------------------------------
+static void *map_mem(size_t size, int flag)
+{
+    void *p = mmap(NULL, size, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | flag, -1, 0);
+    return p == MAP_FAILED ? NULL : p;
+}
+#endif
+
+//------------------------------------------------------------------------------
+//  Allocate large memory backed by huge pages and bound to a NUMA node. The
+//  memory is zero-cleared. If the huge pages are not available, it falls back
+//  to the smaller huge pages and normal pages. If no memory allocated, it exits
+//  the AP immediately with an error message. Huge pages and NUMA binding are
+//  only supported on Linux.
+//
+//  args:
+//      size     (I)  memory size (bytes)
+//      huge     (I)  huge pages (0: off, 1: transparent huge pages (madvise),
+//                    2: 2 MB huge pages, 3: 1 GB huge pages (MAP_HUGETLB))
+//      node     (I)  NUMA node to bind memory (-1: no binding)
+//      msize    (O)  mapped memory size (bytes) (0: allocated by sdr_malloc())
+//
+//  return:
+//      memory pointer allocated. (free by sdr_free_huge())
+//
+void *sdr_malloc_huge(size_t size, int huge, int node, size_t *msize)
+{
+    void *p = NULL;
+    
+    *msize = 0;
+    if (huge <= 0 && node < 0) {
+        return sdr_malloc(size);
+    }
+#ifndef WIN32
+#ifdef MAP_HUGETLB
+    if (huge >= 3) { // 1 GB huge pages
+        *msize = ROUND_UP(size, PAGE_1G);
+        p = map_mem(*msize, MAP_HUGETLB | (30 << MAP_HUGE_SHIFT));
+    }
+    if (!p && huge >= 2) { // 2 MB huge pages
+        *msize = ROUND_UP(size, PAGE_2M);
+        p = map_mem(*msize, MAP_HUGETLB | (21 << MAP_HUGE_SHIFT));
+    }
+#endif
+    if (!p) {
+        *msize = ROUND_UP(size, PAGE_2M);
+        p = map_mem(*msize, 0);
+#ifdef MADV_HUGEPAGE
+        if (p && huge >= 1) { // transparent huge pages
+            madvise(p, *msize, MADV_HUGEPAGE);
+        }
+#endif
+    }
+#ifdef SYS_mbind
+    if (p && node >= 0 && node < MAX_NODE - 1) {
+        unsigned long mask = 1ul << node;
+        
+        // bind memory to NUMA node before first touch
+        if (syscall(SYS_mbind, p, *msize, MPOL_PREF, &mask, MAX_NODE, 0)) {
+            fprintf(stderr, "memory NUMA bind error node=%d\n", node);
+        }
+    }
+#endif
+#endif // WIN32
+    if (!p) {
+        *msize = 0;
+        return sdr_malloc(size);
+    }
+    return p;
+}
+
+//------------------------------------------------------------------------------
+//  Free memory allocated by sdr_malloc_huge()
+//  
+//  args:
+//      p        (I)  memory pointer allocated.
+//      msize    (I)  mapped memory size by sdr_malloc_huge() (bytes)
+//
+//  return:
+//      none
+//
+void sdr_free_huge(void *p, size_t msize)
+{
+    if (!msize) {
+        sdr_free(p);
+        return;
+    }
+#ifndef WIN32
+    munmap(p, msize);
+#endif
+}
+
 //------------------------------------------------------------------------------
 //  Get current time in UTC.
 //  
@@ -109,6 +228,59 @@ uint32_t sdr_get_tick(void)
 #endif
 }
 
+//------------------------------------------------------------------------------
+//  Get monotonic clock with sub-millisecond resolution.
+//  
+//  args:
+//      none
+//
+//  return:
+//      monotonic clock (s)
+//
+double sdr_get_clock(void)
+{
+#ifdef WIN32
+    LARGE_INTEGER freq, count;
+    
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart / freq.QuadPart;
+#else
+    struct timespec ts = {0, 0};
+    
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
+
+//------------------------------------------------------------------------------
+//  Get CPU time consumed by the calling thread.
+//  
+//  args:
+//      none
+//
+//  return:
+//      CPU time of the thread (s)
+//
+double sdr_get_cputime(void)
+{
+#ifdef WIN32
+    FILETIME t_create, t_exit, t_kernel, t_user;
+    
+    if (!GetThreadTimes(GetCurrentThread(), &t_create, &t_exit, &t_kernel,
+        &t_user)) {
+        return 0.0;
+    }
+    return (((uint64_t)t_kernel.dwHighDateTime << 32 | t_kernel.dwLowDateTime) +
+        ((uint64_t)t_user.dwHighDateTime << 32 | t_user.dwLowDateTime)) * 1e-7;
+#else
+    struct timespec ts = {0, 0};
+    
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
+
 //------------------------------------------------------------------------------
 //  Sleep for milli-seconds.
 //  
@@ -131,3 +303,139 @@ void sdr_sleep_msec(int msec)
 #endif
 }
 
+//------------------------------------------------------------------------------
+//  Get number of online CPU cores.
+//  
+//  args:
+//      none
+//
+//  return:
+//      number of CPU cores (>= 1)
+//
+int sdr_get_ncpu(void)
+{
+#ifdef WIN32
+    SYSTEM_INFO info;
+    
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
+
+//------------------------------------------------------------------------------
+//  Get number of NUMA nodes.
+//  
+//  args:
+//      none
+//
+//  return:
+//      number of NUMA nodes (>= 1)
+//
+int sdr_get_nnode(void)
+{
+    int n = 0;
+#ifdef __linux__
+    char path[64];
+    
+    for ( ; n < MAX_NODE; n++) {
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d", n);
+        if (access(path, F_OK)) break;
+    }
+#endif
+    return n > 0 ? n : 1;
+}
+
+//------------------------------------------------------------------------------
+//  Set CPU affinity and scheduling priority of the calling thread. The real-
+//  time priority may require the privilege (CAP_SYS_NICE on Linux).
+//  
+//  args:
+//      cpus     (I)  CPU numbers and ranges separated by "," (e.g. "0-3,8")
+//                    ("": no affinity)
+//      pri      (I)  scheduling priority
+//                      0     : default
+//                      1-99  : real-time priority (SCHED_RR)
+//                      -19--1: lower priority by nice value -pri
+//
+//  return:
+//      status (1: OK, 0: error)
+//
+int sdr_set_thread(const char *cpus, int pri)
+{
+    int cpu[SDR_MAX_NPRN], n = *cpus ? sdr_parse_nums(cpus, cpu) : 0, stat = 1;
+    
+#ifdef WIN32
+    DWORD_PTR mask = 0;
+    
+    for (int i = 0; i < n; i++) {
+        if (cpu[i] >= 0 && cpu[i] < 64) mask |= (DWORD_PTR)1 << cpu[i];
+    }
+    if (mask && !SetThreadAffinityMask(GetCurrentThread(), mask)) stat = 0;
+    if (pri && !SetThreadPriority(GetCurrentThread(), pri > 0 ?
+        THREAD_PRIORITY_TIME_CRITICAL : THREAD_PRIORITY_BELOW_NORMAL)) stat = 0;
+#else
+#ifdef __linux__
+    if (n > 0) {
+        cpu_set_t set;
+        
+        CPU_ZERO(&set);
+        for (int i = 0; i < n; i++) {
+            if (cpu[i] >= 0 && cpu[i] < CPU_SETSIZE) CPU_SET(cpu[i], &set);
+        }
+        if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set)) {
+            fprintf(stderr, "set thread affinity error cpus=%s\n", cpus);
+            stat = 0;
+        }
+    }
+#endif
+    if (pri > 0) {
+        struct sched_param param = {0};
+        
+        param.sched_priority = pri;
+        if (pthread_setschedparam(pthread_self(), SCHED_RR, &param)) {
+            fprintf(stderr, "set thread scheduling error pri=%d\n", pri);
+            stat = 0;
+        }
+    }
+#ifdef __linux__
+    else if (pri < 0) { // nice value of thread (Linux thread ID)
+        if (setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), -pri)) {
+            fprintf(stderr, "set thread priority error pri=%d\n", pri);
+            stat = 0;
+        }
+    }
+#endif
+#endif // WIN32
+    return stat;
+}
+
+//------------------------------------------------------------------------------
+//  Wait for condition variable with timeout. The mutex shall be locked by the
+//  caller. The caller shall check the condition after return since it may be
+//  returned by spurious wakeup.
+//  
+//  args:
+//      cond     (I)  condition variable
+//      mtx      (I)  mutex locked
+//      msec     (I)  timeout (ms)
+//
+//  return:
+//      status (1: signaled, 0: timeout or error)
+//
+int sdr_cond_wait(pthread_cond_t *cond, pthread_mutex_t *mtx, int msec)
+{
+    struct timespec ts = {0, 0};
+    
+    clock_gettime(CLOCK_REALTIME, &ts); // absolute time for timed wait
+    ts.tv_sec += msec / 1000;
+    ts.tv_nsec += (long)(msec % 1000) * 1000000;
+    if (ts.tv_nsec >= 1000000000) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000;
+    }
+    return !pthread_cond_timedwait(cond, mtx, &ts);
+}
+
@@ -65,9 +65,18 @@
 //  2024-01-07  1.12 add signal G1OCD, G1OCP, G2OCP
 //  2024-01-15  1.13 add API sdr_sat_id()
 //  2024-03-20  1.14 modify API sdr_res_code()
+//  2026-10-15  1.15 use FFTW plan cache in sdr_gen_code_fft() for concurrent
+//                   code FFTs
+//                   add API sdr_gen_code_cache(), sdr_code_cache_open(),
+//                   sdr_code_cache_close(), sdr_code_cache_get()
+//                   resample code by fixed-point DDA in sdr_res_code() and
+//                   sdr_gen_code_fft()
 //
 #include <ctype.h>
 #include "pocket_sdr.h"
+#ifndef WIN32
+#include <sys/mman.h>
+#endif
 
 // Galileo code HEX strings in sdr_code_gal.c ---------------------------------
 extern const char *code_gal_E1B[];
@@ -79,7 +88,48 @@ extern const char *code_gal_CS20;
 extern const char *code_gal_CS25;
 extern const char *code_gal_CS100[];
 
+// code FFT cache file --------------------------------------------------------
+//
+//  The code FFT cache file holds the zero-padded code FFTs of sdr_gen_code_fft()
+//  as arrays of sdr_cpx_t in native byte order. The file is memory-mapped read-
+//  only and can be shared among the processes on a host.
+//
+//    header : magic (8), version (4), byte order mark (4), size of sdr_cpx_t
+//             (4), number of entries (4), reserved (40)
+//    entries: {signal (16), PRN (4), N (4), Nz (4), reserved (4), sampling
+//             frequency (8), file offset of code FFT (8), reserved (16)} ...
+//    data   : code FFTs aligned to CACHE_ALIGN bytes
+//
+#define CACHE_MAGIC "PSDRCFFT"  // magic of code FFT cache file
+#define CACHE_VER   1           // version of code FFT cache file
+#define CACHE_BOM   0x01020304  // byte order mark
+#define CACHE_ALIGN 64          // alignment of code FFTs in file (bytes)
+#define MIN(x, y)   ((x) < (y) ? (x) : (y))
+
+typedef struct {                // code FFT cache file header type
+    char magic[8];              // magic
+    uint32_t ver, bom, size;    // version, byte order mark, size of sdr_cpx_t
+    uint32_t nent;              // number of entries
+    uint8_t resv[40];           // reserved
+} cache_head_t;
+
+typedef struct {                // code FFT cache entry type
+    char sig[16];               // signal ID
+    int32_t prn, N, Nz, resv1;  // PRN number, number of samples and zero-padding
+    double fs;                  // sampling frequency (Hz)
+    int64_t off;                // file offset of code FFT (bytes)
+    uint8_t resv2[16];          // reserved
+} cache_ent_t;
+
+static const uint8_t *code_cache = NULL; // mapped code FFT cache file
+static size_t code_cache_size = 0;       // size of code FFT cache file
+
 // constants ------------------------------------------------------------------
+#define RES_FRAC    32          // fraction bits of resampled code phase
+#define RES_BLK     4096        // samples to re-anchor resampled code phase
+#define RES_LANE    4           // lanes of resampled code phases
+#define RES_GUARD   ((uint32_t)1 << 12) // guard of chip boundary (2^-20 chip)
+
 static const int8_t CHIP[] = {-1, 1};
 
 // code caches ----------------------------------------------------------------
@@ -2538,6 +2588,61 @@ void sdr_sat_id(const char *sig, int prn, char *sat)
     }
 }
 
+// resample code --------------------------------------------------------------
+//  The code phase x(i) = (coff * fs + i) * dx (chip) is accumulated by a fixed-
+//  point DDA (digital differential analyzer) with the wrap by the code length
+//  instead of the floating-point multiplication and the integer modulo per
+//  sample. The phases of RES_LANE samples are accumulated independently and
+//  re-anchored to the floating-point one every RES_BLK samples. The phase
+//  close to a chip boundary within RES_GUARD (larger than the errors of the
+//  DDA and the floating-point phase) is evaluated by the floating-point one,
+//  so the output is identical to code[(int)x(i) % len_code].
+//
+static void res_code(const int8_t *code, int len_code, double T, double coff,
+    double fs, int N, int8_t *res)
+{
+    double dx = len_code / T / fs, x0 = coff * fs;
+    int64_t L = (int64_t)len_code << RES_FRAC, p[RES_LANE];
+    int64_t step = (int64_t)(dx * (double)((int64_t)1 << RES_FRAC) + 0.5);
+    int64_t step_n = step * RES_LANE % L;
+    int i = 0;
+    
+    for ( ; i < N && (x0 + i) * dx < 0.0; i++) { // negative code phase
+        res[i] = code[(int)((x0 + i) * dx) % len_code];
+    }
+    while (i < N) {
+        // anchor code phases of lanes
+        double x = (x0 + i) * dx;
+        int k = (int)x;
+        p[0] = ((int64_t)(k % len_code) << RES_FRAC) +
+            (int64_t)((x - k) * (double)((int64_t)1 << RES_FRAC));
+        for (int j = 1; j < RES_LANE; j++) {
+            p[j] = p[j-1] + step;
+            p[j] -= p[j] >= L ? L : 0;
+        }
+        int n = MIN(N, i + RES_BLK);
+        
+        for ( ; i + RES_LANE <= n; i += RES_LANE) {
+            for (int j = 0; j < RES_LANE; j++) {
+                res[i+j] = code[p[j] >> RES_FRAC];
+                if ((uint32_t)p[j] - RES_GUARD >= (uint32_t)-2 * RES_GUARD) {
+                    // close to chip boundary
+                    res[i+j] = code[(int)((x0 + (double)(i + j)) * dx) %
+                        len_code];
+                }
+                p[j] += step_n;
+                p[j] -= p[j] >= L ? L : 0;
+            }
+        }
+        for (int j = 0; i < n; i++, j++) {
+            res[i] = code[p[j] >> RES_FRAC];
+            if ((uint32_t)p[j] - RES_GUARD >= (uint32_t)-2 * RES_GUARD) {
+                res[i] = code[(int)((x0 + i) * dx) % len_code];
+            }
+        }
+    }
+}
+
 //------------------------------------------------------------------------------
 //  Generate resampled and zero-padded code.
 //
@@ -2558,14 +2663,14 @@ void sdr_sat_id(const char *sig, int prn, char *sat)
 void sdr_res_code(const int8_t *code, int len_code, double T, double coff,
     double fs, int N, int Nz, sdr_cpx16_t *code_res)
 {
-    double dx = len_code / T / fs;
-    
-    memset(code_res, 0, sizeof(sdr_cpx16_t) * (N + Nz));
+    int8_t *res = (int8_t *)sdr_scratch_alloc(N);
     
+    res_code(code, len_code, T, coff, fs, N, res);
+    memset(code_res + N, 0, sizeof(sdr_cpx16_t) * Nz);
     for (int i = 0; i < N; i++) {
-        int8_t c = code[(int)((coff * fs + i) * dx) % len_code];
-        code_res[i].I = code_res[i].Q = c;
+        code_res[i].I = code_res[i].Q = res[i];
     }
+    sdr_scratch_free(res);
 }
 
 //------------------------------------------------------------------------------
@@ -2588,28 +2693,20 @@ void sdr_res_code(const int8_t *code, int len_code, double T, double coff,
 void sdr_gen_code_fft(const int8_t *code, int len_code, double T, double coff,
     double fs, int N, int Nz, sdr_cpx_t *code_fft)
 {
-    static pthread_mutex_t mtx = PTHREAD_MUTEX_INITIALIZER;
-    static fftwf_plan plan = NULL;
-    static int N_plan = 0;
-    double dx = len_code / T / fs;
+    fftwf_plan plan[2];
+    
+    if (!sdr_fftw_plan(N + Nz, plan)) return;
+    
     sdr_cpx_t *code_res = sdr_cpx_malloc(N + Nz);
+    int8_t *res = (int8_t *)sdr_scratch_alloc(N);
     
+    res_code(code, len_code, T, coff, fs, N, res);
     memset(code_res, 0, sizeof(sdr_cpx_t) * (N + Nz));
     for (int i = 0; i < N; i++) {
-        code_res[i][0] = code[(int)((coff * fs + i) * dx) % len_code];
-    }
-    pthread_mutex_lock(&mtx);
-    if (N + Nz != N_plan) {
-        if (plan) {
-            fftwf_destroy_plan(plan);
-        }
-        plan = fftwf_plan_dft_1d(N + Nz, code_res, code_fft, FFTW_FORWARD,
-            FFTW_ESTIMATE);
-        N_plan = N + Nz;
+        code_res[i][0] = res[i];
     }
-    pthread_mutex_unlock(&mtx);
-    
-    fftwf_execute_dft(plan, code_res, code_fft);
+    sdr_scratch_free(res);
+    fftwf_execute_dft(plan[0], code_res, code_fft);
     
     // complex conjugate
     for (int i = 0; i < N + Nz; i++) {
@@ -2618,3 +2715,204 @@ void sdr_gen_code_fft(const int8_t *code, int len_code, double T, double coff,
     sdr_cpx_free(code_res);
 }
 
+
+//------------------------------------------------------------------------------
+//  Generate code FFT cache file. The zero-padded code FFTs (N = fs * T, Nz = N)
+//  for the signals and the PRNs are generated by sdr_gen_code_fft() and written
+//  to the code FFT cache file. The file is written via a temporary file and
+//  renamed, so the processes mapping the old file are not affected.
+//
+//  args:
+//      file     (I) Code FFT cache file
+//      sigs     (I) Signal IDs as string ('L1CA', 'L1CB', 'L1CP', ....)
+//      prns     (I) PRN numbers
+//      n        (I) Number of signals and PRNs
+//      fs       (I) Sampling frequency (Hz)
+//
+//  return:
+//      Number of code FFTs written (-1: error)
+//
+int sdr_gen_code_cache(const char *file, const char **sigs, const int *prns,
+    int n, double fs)
+{
+    cache_head_t head;
+    cache_ent_t *ent = (cache_ent_t *)sdr_malloc(sizeof(cache_ent_t) * n);
+    char tmp[1040];
+    FILE *fp;
+    int nent = 0;
+    
+    snprintf(tmp, sizeof(tmp), "%s.tmp", file);
+    if (!(fp = fopen(tmp, "wb"))) {
+        fprintf(stderr, "code cache open error: %s\n", tmp);
+        sdr_free(ent);
+        return -1;
+    }
+    static const uint8_t pad[CACHE_ALIGN] = {0};
+    int64_t off = sizeof(cache_head_t) + sizeof(cache_ent_t) * n;
+    
+    // reserve header and entries
+    for (int64_t i = 0; i < off; i += CACHE_ALIGN) {
+        fwrite(pad, 1, (size_t)MIN(off - i, CACHE_ALIGN), fp);
+    }
+    for (int i = 0; i < n; i++) {
+        int8_t *code;
+        int len_code;
+        double T = sdr_code_cyc(sigs[i]);
+        
+        if (T <= 0.0 || !(code = sdr_gen_code(sigs[i], prns[i], &len_code))) {
+            continue;
+        }
+        int N = (int)(fs * T), npad = (int)(-off & (CACHE_ALIGN - 1));
+        sdr_cpx_t *code_fft = sdr_cpx_malloc(2 * N);
+        sdr_gen_code_fft(code, len_code, T, 0.0, fs, N, N, code_fft);
+        
+        sig_upper(sigs[i], ent[nent].sig);
+        ent[nent].prn = prns[i];
+        ent[nent].N = ent[nent].Nz = N;
+        ent[nent].fs = fs;
+        ent[nent].off = off + npad;
+        int stat = fwrite(pad, 1, npad, fp) == (size_t)npad &&
+            fwrite(code_fft, sizeof(sdr_cpx_t), 2 * N, fp) == (size_t)(2 * N);
+        sdr_cpx_free(code_fft);
+        if (!stat) {
+            fclose(fp);
+            remove(tmp);
+            sdr_free(ent);
+            fprintf(stderr, "code cache write error: %s\n", tmp);
+            return -1;
+        }
+        off += npad + sizeof(sdr_cpx_t) * 2 * N;
+        nent++;
+    }
+    memset(&head, 0, sizeof(head));
+    memcpy(head.magic, CACHE_MAGIC, 8);
+    head.ver = CACHE_VER;
+    head.bom = CACHE_BOM;
+    head.size = sizeof(sdr_cpx_t);
+    head.nent = nent;
+    rewind(fp);
+    int stat = fwrite(&head, sizeof(head), 1, fp) == 1 &&
+        fwrite(ent, sizeof(cache_ent_t), nent, fp) == (size_t)nent;
+    stat = !fclose(fp) && stat;
+    sdr_free(ent);
+    
+    remove(file);
+    if (!stat || rename(tmp, file)) {
+        fprintf(stderr, "code cache write error: %s\n", file);
+        remove(tmp);
+        return -1;
+    }
+    return nent;
+}
+
+//------------------------------------------------------------------------------
+//  Open code FFT cache file. The file is memory-mapped read-only and used by
+//  sdr_code_cache_get() until sdr_code_cache_close(). A file of different
+//  version, byte order or type size is rejected.
+//
+//  args:
+//      file     (I) Code FFT cache file
+//
+//  return:
+//      Number of code FFTs in the file (-1: error)
+//
+int sdr_code_cache_open(const char *file)
+{
+    cache_head_t head;
+    FILE *fp;
+    
+    sdr_code_cache_close();
+    
+    if (!(fp = fopen(file, "rb"))) {
+        fprintf(stderr, "code cache open error: %s\n", file);
+        return -1;
+    }
+    fseek(fp, 0, SEEK_END);
+    size_t size = (size_t)ftell(fp);
+    rewind(fp);
+    
+    if (fread(&head, sizeof(head), 1, fp) < 1 ||
+        memcmp(head.magic, CACHE_MAGIC, 8) || head.ver != CACHE_VER ||
+        head.bom != CACHE_BOM || head.size != sizeof(sdr_cpx_t) ||
+        sizeof(head) + sizeof(cache_ent_t) * head.nent > size) {
+        fprintf(stderr, "code cache version error: %s\n", file);
+        fclose(fp);
+        return -1;
+    }
+#ifdef WIN32
+    uint8_t *data = (uint8_t *)sdr_malloc(size);
+    rewind(fp);
+    if (fread(data, 1, size, fp) < size) {
+        sdr_free(data);
+        data = NULL;
+    }
+#else
+    void *data = mmap(NULL, size, PROT_READ, MAP_SHARED, fileno(fp), 0);
+    if (data == MAP_FAILED) data = NULL;
+#endif
+    fclose(fp);
+    if (!data) {
+        fprintf(stderr, "code cache read error: %s\n", file);
+        return -1;
+    }
+    code_cache = (const uint8_t *)data;
+    code_cache_size = size;
+    return (int)head.nent;
+}
+
+//------------------------------------------------------------------------------
+//  Close code FFT cache file. The code FFTs got by sdr_code_cache_get() shall
+//  not be used after closed.
+//
+//  args:
+//      none
+//
+//  return:
+//      none
+//
+void sdr_code_cache_close(void)
+{
+    if (!code_cache) return;
+#ifdef WIN32
+    sdr_free((void *)code_cache);
+#else
+    munmap((void *)code_cache, code_cache_size);
+#endif
+    code_cache = NULL;
+    code_cache_size = 0;
+}
+
+//------------------------------------------------------------------------------
+//  Get zero-padded code FFT in code FFT cache file.
+//
+//  args:
+//      sig      (I) Signal ID as string ('L1CA', 'L1CB', 'L1CP', ....)
+//      prn      (I) PRN number
+//      fs       (I) Sampling frequency (Hz)
+//      N        (I) Number of samples
+//      Nz       (I) Number of zero-padding
+//
+//  return:
+//      Code FFT as same as sdr_gen_code_fft() (N + Nz) (NULL: not in cache)
+//
+const sdr_cpx_t *sdr_code_cache_get(const char *sig, int prn, double fs, int N,
+    int Nz)
+{
+    char Sig[16];
+    
+    if (!code_cache) return NULL;
+    
+    const cache_head_t *head = (const cache_head_t *)code_cache;
+    const cache_ent_t *ent = (const cache_ent_t *)(head + 1);
+    sig_upper(sig, Sig);
+    
+    for (int i = 0; i < (int)head->nent; i++) {
+        if (ent[i].prn != prn || ent[i].N != N || ent[i].Nz != Nz ||
+            ent[i].fs != fs || strcmp(ent[i].sig, Sig)) continue;
+        if (ent[i].off + sizeof(sdr_cpx_t) * (N + Nz) > code_cache_size) {
+            return NULL;
+        }
+        return (const sdr_cpx_t *)(code_cache + ent[i].off);
+    }
+    return NULL;
+}
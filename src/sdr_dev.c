@@ -17,15 +17,38 @@
 //  2024-05-28  1.6  delete API sdr_dev_info()
 //  2024-06-29  1.7  add API sdr_dev_get_info(), sdr_dev_set_gain(),
 //                   sdr_dev_get_gain()
+//  2026-10-14  1.8  add API sdr_dev_wait()
+//                   signal raw data arrival by condition variable
+//                   add API sdr_dev_view(), sdr_dev_release()
+//                   resubmit USB transfers after raw data released
+//                   allocate raw data buffer by libusb_dev_mem_alloc()
+//                   lock-free raw data buffer with overrun detection
+//                   add API sdr_dev_get_stat()
+//                   configurable number and size of USB transfers with
+//                   auto sizing by sampling rate and completion latency
+//                   modify API sdr_dev_start()
+//                   handle USB events of device context for multiple devices
+//                   record host time of start request
+//                   add API sdr_dev_set_mask()
+//                   support RF channel mask of Pocket SDR FE 4CH
 //
 #include "pocket_sdr.h"
 #ifdef WIN32
 #include <avrt.h>
+#elif defined(__linux__) && defined(LIBUSB_API_VERSION) && \
+    LIBUSB_API_VERSION >= 0x01000105
+#define DEV_MEM         // libusb_dev_mem_alloc() available
 #endif
 
 // constants and macros --------------------------------------------------------
-#define BUFF_SIZE       (SDR_SIZE_BUFF * SDR_MAX_BUFF)
 #define TO_TRANSFER     3000    // USB transfer timeout (ms)
+#define XFER_UNIT       (1<<14) // unit of USB transfer size (bytes)
+#define XFER_MAX        (1<<20) // max size of USB transfer (bytes)
+#define XFER_TIME       2e-3    // IF data time per USB transfer in auto (s)
+#define BUFF_TIME       0.25    // IF data time of raw data buffer in auto (s)
+#define LAT_MARGIN      4.0     // margin of completion latency in auto
+#define MIN_NBUFF       16      // min number of USB transfers
+#define MAX_NBUFF       1024    // max number of USB transfers
 
 // read MAX2771 status ---------------------------------------------------------
 static int read_MAX2771_stat(sdr_dev_t *dev, int ch, double fx, double *fs,
@@ -105,6 +128,29 @@ static int read_MAX2769B_stat(sdr_dev_t *dev, int ch, double fx, double *fs,
     return 1;
 }
 
+// publish raw data written ---------------------------------------------------
+//  The write pointer is published without lock. The waiting reader is
+//  notified only if it is waiting in sdr_dev_wait().
+static void publish_data(sdr_dev_t *dev, int64_t wp)
+{
+    __atomic_store_n(&dev->wp, wp, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&dev->nwait, __ATOMIC_SEQ_CST)) {
+        pthread_mutex_lock(&dev->mtx);
+        pthread_cond_broadcast(&dev->cond);
+        pthread_mutex_unlock(&dev->mtx);
+    }
+}
+
+// update max interval of USB transfer completions -----------------------------
+static void update_lat(sdr_dev_t *dev)
+{
+    uint32_t tick = sdr_get_tick();
+    int lat = (int)(tick - dev->tick);
+    
+    if (dev->tick && lat > dev->lat) dev->lat = lat;
+    dev->tick = tick;
+}
+
 #ifdef WIN32
 
 // rise process/thread priority ------------------------------------------------
@@ -146,9 +192,8 @@ static void *event_handler(void *arg)
 {
     sdr_dev_t *dev = (sdr_dev_t *)arg;
     CCyBulkEndPoint *ep;
-    uint8_t *ctx[SDR_MAX_BUFF] = {0};
-    OVERLAPPED ov[SDR_MAX_BUFF] = {{0,0,0,0,0}};
-    long len = SDR_SIZE_BUFF;
+    int n = dev->nbuff;
+    long len = dev->size;
     
     // rise process/thread priority
     rise_pri();
@@ -157,8 +202,10 @@ static void *event_handler(void *arg)
         fprintf(stderr, "bulk endpoint get error ep=0x%02X\n", SDR_DEV_EP);
         return 0;
     }
-    ep->SetXferSize(SDR_SIZE_BUFF);
-    for (int i = 0; i < SDR_MAX_BUFF; i++) {
+    uint8_t **ctx = (uint8_t **)sdr_malloc(sizeof(uint8_t *) * n);
+    OVERLAPPED *ov = (OVERLAPPED *)sdr_malloc(sizeof(OVERLAPPED) * n);
+    ep->SetXferSize(len);
+    for (int i = 0; i < n; i++) {
         ov[i].hEvent = CreateEvent(NULL, false, false, NULL);
         ctx[i] = ep->BeginDataXfer(dev->buff + len * i, len, &ov[i]); 
     }
@@ -169,18 +216,20 @@ static void *event_handler(void *arg)
         }
         if (!ep->FinishDataXfer(dev->buff + len * i, len, &ov[i], ctx[i])) {
             fprintf(stderr, "bulk transfer error\n");
+            __atomic_add_fetch(&dev->nerr, 1, __ATOMIC_RELAXED);
             break;
         }
         ctx[i] = ep->BeginDataXfer(dev->buff + len * i, len, &ov[i]);
-        pthread_mutex_lock(&dev->mtx);
-        dev->wp += len;
-        pthread_mutex_unlock(&dev->mtx);
-        i = (i + 1) % SDR_MAX_BUFF;
+        update_lat(dev);
+        publish_data(dev, dev->wp + len);
+        i = (i + 1) % n;
     }
-    for (int i = 0; i < SDR_MAX_BUFF; i++) {
+    for (int i = 0; i < n; i++) {
         ep->FinishDataXfer(dev->buff + len * i, len, &ov[i], ctx[i]);
         CloseHandle(ov[i].hEvent);
     }
+    sdr_free(ctx);
+    sdr_free(ov);
     return 0;
 }
 
@@ -191,14 +240,43 @@ static void transfer_cb(struct libusb_transfer *transfer)
 {
     sdr_dev_t *dev = (sdr_dev_t *)transfer->user_data;
     
+    if (transfer->status == LIBUSB_TRANSFER_CANCELLED) return;
+    
     if (transfer->status != LIBUSB_TRANSFER_COMPLETED) {
         fprintf(stderr, "libusb bulk transfer error (%d)\n", transfer->status);
+        __atomic_add_fetch(&dev->nerr, 1, __ATOMIC_RELAXED);
     }
-    pthread_mutex_lock(&dev->mtx);
-    dev->wp += SDR_SIZE_BUFF;
-    pthread_mutex_unlock(&dev->mtx);
+    if (transfer->status != LIBUSB_TRANSFER_COMPLETED ||
+        transfer->actual_length < dev->size) {
+        int len = transfer->status == LIBUSB_TRANSFER_COMPLETED ?
+            transfer->actual_length : 0;
+        __atomic_add_fetch(&dev->ndrop, dev->size - len, __ATOMIC_RELAXED);
+    }
+    int64_t wp = dev->wp + dev->size;
+    
+    update_lat(dev);
     
-    libusb_submit_transfer(transfer);
+    // no transfer in flight: the device FIFO overruns until resubmitted
+    if (wp >= __atomic_load_n(&dev->nsub, __ATOMIC_ACQUIRE) * dev->size) {
+        __atomic_add_fetch(&dev->nover, 1, __ATOMIC_RELAXED);
+    }
+    publish_data(dev, wp);
+    
+    // the transfer is resubmitted by sdr_dev_release() after read
+}
+
+// resubmit USB transfers of released raw data buffer --------------------------
+static void resubmit_transfer(sdr_dev_t *dev)
+{
+    while (dev->state &&
+        (dev->nsub - dev->nbuff + 1) * dev->size <= dev->rp) {
+        int i = (int)(dev->nsub % dev->nbuff), ret;
+        if ((ret = libusb_submit_transfer(dev->transfer[i]))) {
+            fprintf(stderr, "libusb_submit_transfer(%d) error (%d)\n", i, ret);
+            __atomic_add_fetch(&dev->nerr, 1, __ATOMIC_RELAXED);
+        }
+        __atomic_store_n(&dev->nsub, dev->nsub + 1, __ATOMIC_RELEASE);
+    }
 }
 
 // USB event handler thread ----------------------------------------------------
@@ -213,13 +291,91 @@ static void *event_handler(void *arg)
         fprintf(stderr, "set thread scheduling error\n");
     }
     while (dev->state) {
-        if (libusb_handle_events_timeout(NULL, &to)) continue;
+        if (libusb_handle_events_timeout(dev->usb->ctx, &to)) continue;
     }
     return NULL;
 }
 
 #endif // WIN32
 
+// free raw data buffer and USB transfers --------------------------------------
+static void free_buff(sdr_dev_t *dev)
+{
+#ifndef WIN32
+    for (int i = 0; dev->transfer && i < dev->nbuff; i++) {
+        libusb_free_transfer(dev->transfer[i]);
+    }
+    sdr_free(dev->transfer);
+    dev->transfer = NULL;
+#endif
+#ifdef DEV_MEM
+    if (dev->dma) {
+        libusb_dev_mem_free(dev->usb->h, dev->buff, dev->len + SDR_MAX_VIEW);
+        dev->buff = NULL;
+    }
+#endif
+    sdr_free(dev->buff);
+    dev->buff = NULL;
+    dev->dma = dev->nbuff = dev->size = 0;
+    dev->len = 0;
+}
+
+// allocate raw data buffer and USB transfers ----------------------------------
+static int alloc_buff(sdr_dev_t *dev, int nbuff, int size)
+{
+    if (dev->buff && dev->nbuff == nbuff && dev->size == size) return 1;
+    
+    free_buff(dev);
+    dev->nbuff = nbuff;
+    dev->size = size;
+    dev->len = (int64_t)nbuff * size;
+    
+    // raw data buffer with view wrap-around area
+#ifdef DEV_MEM
+    dev->buff = libusb_dev_mem_alloc(dev->usb->h, dev->len + SDR_MAX_VIEW);
+    dev->dma = dev->buff != NULL;
+#endif
+    if (!dev->buff) {
+        dev->buff = (uint8_t *)sdr_malloc(dev->len + SDR_MAX_VIEW);
+    }
+#ifndef WIN32
+    dev->transfer = (struct libusb_transfer **)sdr_malloc(
+        sizeof(struct libusb_transfer *) * nbuff);
+    for (int i = 0; i < nbuff; i++) {
+        if (!(dev->transfer[i] = libusb_alloc_transfer(0))) {
+            fprintf(stderr, "libusb_alloc_transfer(%d) error\n", i);
+            free_buff(dev);
+            return 0;
+        }
+    }
+#endif
+    return 1;
+}
+
+// auto number and size of USB transfers ---------------------------------------
+//  The transfer size is set to XFER_TIME of IF data and the raw data buffer to
+//  BUFF_TIME of IF data or LAT_MARGIN x max completion latency observed in
+//  the previous run if longer.
+static void auto_xfer(sdr_dev_t *dev, int *nbuff, int *size)
+{
+    double fs = 0.0, fo[SDR_MAX_RFCH], rate = SDR_SIZE_BUFF / XFER_TIME;
+    int fmt = SDR_FMT_RAW8, IQ[SDR_MAX_RFCH];
+    
+    if (sdr_dev_get_info(dev, &fmt, &fs, fo, IQ) && fs > 0.0) {
+        rate = fs * (fmt == SDR_FMT_PACK ? 0.5 : (fmt == SDR_FMT_RAW8 ? 1.0 :
+            2.0)); // bytes/s
+    }
+    if (*size <= 0) {
+        for (*size = XFER_UNIT; *size < XFER_MAX && *size < rate * XFER_TIME; ) {
+            *size *= 2;
+        }
+    }
+    if (*nbuff <= 0) {
+        double t = fmax(BUFF_TIME, dev->lat * 1e-3 * LAT_MARGIN);
+        *nbuff = (int)ceil(rate * t / *size);
+    }
+}
+
 //------------------------------------------------------------------------------
 //  Open a SDR device.
 //
@@ -242,19 +398,8 @@ sdr_dev_t *sdr_dev_open(int bus, int port)
         sdr_free(dev);
         return NULL;
     }
-    dev->buff = (uint8_t *)sdr_malloc(BUFF_SIZE);
-    
-#ifndef WIN32
-    for (int i = 0; i < SDR_MAX_BUFF; i++) {
-        if (!(dev->transfer[i] = libusb_alloc_transfer(0))) {
-            fprintf(stderr, "libusb_alloc_transfer(%d) error\n", i);
-            sdr_usb_close(dev->usb);
-            sdr_free(dev);
-            return NULL;
-        }
-    }
-#endif
     pthread_mutex_init(&dev->mtx, NULL);
+    pthread_cond_init(&dev->cond, NULL);
     return dev;
 }
 
@@ -269,34 +414,44 @@ sdr_dev_t *sdr_dev_open(int bus, int port)
 //
 void sdr_dev_close(sdr_dev_t *dev)
 {
+    free_buff(dev);
     sdr_usb_close(dev->usb);
-#ifndef WIN32
-    for (int i = 0; i < SDR_MAX_BUFF; i++) {
-        libusb_free_transfer(dev->transfer[i]);
-    }
-#endif
-    sdr_free(dev->buff);
+    pthread_cond_destroy(&dev->cond);
+    pthread_mutex_destroy(&dev->mtx);
     sdr_free(dev);
 }
 
 //------------------------------------------------------------------------------
-//  Start the SDR device.
+//  Start the SDR device. If the number or the size of USB transfers is 0, it
+//  is set automatically by the sampling rate and the IF data format of the
+//  device and the max completion latency of USB transfers observed in the
+//  previous run. The transfer size is rounded up to a multiple of 16 KB.
 //
 //  args:
 //      dev         (I)   USB device pointer
+//      nbuff       (I)   number of USB transfers (0: auto)
+//      size        (I)   size of USB transfer (bytes) (0: auto)
 //
 //  return
 //      status (1: OK, 0: error)
 //
-int sdr_dev_start(sdr_dev_t *dev)
+int sdr_dev_start(sdr_dev_t *dev, int nbuff, int size)
 {
     if (dev->state) return 0;
     
+    auto_xfer(dev, &nbuff, &size);
+    size = (size + XFER_UNIT - 1) / XFER_UNIT * XFER_UNIT;
+    size = size < XFER_MAX ? size : XFER_MAX;
+    nbuff = nbuff < MIN_NBUFF ? MIN_NBUFF : (nbuff > MAX_NBUFF ? MAX_NBUFF :
+        nbuff);
+    
+    if (!alloc_buff(dev, nbuff, size)) return 0;
+    
 #ifndef WIN32
-    for (int i = 0; i < SDR_MAX_BUFF; i++) {
+    for (int i = 0; i < dev->nbuff; i++) {
         int ret;
         libusb_fill_bulk_transfer(dev->transfer[i], dev->usb->h, SDR_DEV_EP,
-            dev->buff + SDR_SIZE_BUFF * i, SDR_SIZE_BUFF, transfer_cb, dev,
+            dev->buff + (int64_t)dev->size * i, dev->size, transfer_cb, dev,
             TO_TRANSFER);
         if ((ret = libusb_submit_transfer(dev->transfer[i]))) {
             fprintf(stderr, "libusb_submit_transfer(%d) error (%d)\n", i, ret);
@@ -304,10 +459,18 @@ int sdr_dev_start(sdr_dev_t *dev)
         }
     }
 #endif
+    double t0 = sdr_get_clock();
     sdr_usb_req(dev->usb, 0, SDR_VR_START, 0, NULL, 0);
+    dev->tstart = (t0 + sdr_get_clock()) * 0.5;
     
     dev->state = 1;
     dev->rp = dev->wp = 0;
+    dev->nerr = dev->nover = dev->ndrop = 0;
+    dev->tick = 0;
+    dev->lat = 0;
+#ifndef WIN32
+    dev->nsub = dev->nbuff;
+#endif
     pthread_create(&dev->thread, NULL, event_handler, dev);
     return 1;
 }
@@ -329,13 +492,29 @@ int sdr_dev_stop(sdr_dev_t *dev)
     pthread_join(dev->thread, NULL);
     sdr_usb_req(dev->usb, 0, SDR_VR_STOP, 0, NULL, 0);
 #ifndef WIN32
-    for (int i = 0; i < SDR_MAX_BUFF; i++) {
+    for (int i = 0; i < dev->nbuff; i++) {
         libusb_cancel_transfer(dev->transfer[i]);
     }
 #endif
     return 1;
 }
 
+// available raw data size with overrun check ---------------------------------
+//  If the reader is lapped by the writer (USB transfers resubmitted at
+//  completion on Windows), the overwritten IF data are skipped and counted.
+static int64_t avail_data(sdr_dev_t *dev)
+{
+    int64_t wp = __atomic_load_n(&dev->wp, __ATOMIC_ACQUIRE);
+    int64_t lost = wp - dev->rp - dev->len;
+    
+    if (lost > 0) {
+        __atomic_add_fetch(&dev->nover, 1, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&dev->ndrop, lost, __ATOMIC_RELAXED);
+        __atomic_store_n(&dev->rp, dev->rp + lost, __ATOMIC_RELEASE);
+    }
+    return wp - dev->rp;
+}
+
 //------------------------------------------------------------------------------
 //  Read of IF data (non-block). Immediately returned with return value 0 if
 //  insufficient data received.
@@ -350,26 +529,116 @@ int sdr_dev_stop(sdr_dev_t *dev)
 //
 int sdr_dev_read(sdr_dev_t *dev, uint8_t *buff, int size)
 {
-    pthread_mutex_lock(&dev->mtx);
-    int64_t wp = dev->wp;
-    pthread_mutex_unlock(&dev->mtx);
-    
-    if (wp < dev->rp + size) {
+    if (avail_data(dev) < size) {
         return 0;
     }
-    int rp = (int)(dev->rp % BUFF_SIZE);
+    int64_t len = dev->len, rp = dev->rp % len;
     
-    if (rp + size <= BUFF_SIZE) {
+    if (rp + size <= len) {
         memcpy(buff, dev->buff + rp, size);
     }
     else {
-        memcpy(buff, dev->buff + rp, BUFF_SIZE - rp);
-        memcpy(buff + BUFF_SIZE - rp, dev->buff, size - BUFF_SIZE + rp);
+        memcpy(buff, dev->buff + rp, len - rp);
+        memcpy(buff + len - rp, dev->buff, size - len + rp);
     }
-    dev->rp += size;
+    sdr_dev_release(dev, size);
     return size;
 }
 
+//------------------------------------------------------------------------------
+//  Get a read-only view of IF data in the raw data buffer (non-block) without
+//  copy. The IF data of the view are kept until released by sdr_dev_release().
+//  If the view wraps around the end of the raw data buffer, the wrapped data
+//  are copied after the end of the buffer.
+//
+//  args:
+//      dev         (I)   USB device pointer
+//      size        (I)   IF data size of view (bytes) (<= SDR_MAX_VIEW)
+//
+//  return
+//      pointer to IF data (NULL: insufficent data or size error)
+//
+const uint8_t *sdr_dev_view(sdr_dev_t *dev, int size)
+{
+    if (size > SDR_MAX_VIEW || avail_data(dev) < size) {
+        return NULL;
+    }
+    int64_t len = dev->len, rp = dev->rp % len;
+    
+    if (rp + size > len) {
+        memcpy(dev->buff + len, dev->buff, size - len + rp);
+    }
+    return dev->buff + rp;
+}
+
+//------------------------------------------------------------------------------
+//  Release IF data read by sdr_dev_view() and return the raw data buffer to
+//  the USB transfers (on Windows, the transfers are resubmitted at completion
+//  and the view is valid until the raw data buffer overrun).
+//
+//  args:
+//      dev         (I)   USB device pointer
+//      size        (I)   IF data size to be released (bytes)
+//
+//  return
+//      none
+//
+void sdr_dev_release(sdr_dev_t *dev, int size)
+{
+    __atomic_store_n(&dev->rp, dev->rp + size, __ATOMIC_RELEASE);
+#ifndef WIN32
+    resubmit_transfer(dev);
+#endif
+}
+
+//------------------------------------------------------------------------------
+//  Wait for IF data arrival. It is returned when the IF data of the size can
+//  be read by sdr_dev_read() or the timeout.
+//
+//  args:
+//      dev         (I)   USB device pointer
+//      size        (I)   IF data size to be read (bytes)
+//      msec        (I)   timeout (ms)
+//
+//  return
+//      status (1: IF data available, 0: timeout)
+//
+int sdr_dev_wait(sdr_dev_t *dev, int size, int msec)
+{
+    if (avail_data(dev) >= size) return 1;
+    
+    pthread_mutex_lock(&dev->mtx);
+    __atomic_store_n(&dev->nwait, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&dev->wp, __ATOMIC_SEQ_CST) < dev->rp + size) {
+        sdr_cond_wait(&dev->cond, &dev->mtx, msec);
+    }
+    __atomic_store_n(&dev->nwait, 0, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&dev->mtx);
+    return avail_data(dev) >= size;
+}
+
+//------------------------------------------------------------------------------
+//  Get raw data buffer statistics of SDR device.
+//
+//  args:
+//      dev         (I)   SDR device
+//      nerr        (O)   number of USB transfer errors
+//      nover       (O)   number of raw data buffer overruns (host too slow)
+//      ndrop       (O)   number of dropped IF data bytes
+//
+//  return
+//      status (1: OK, 0: error)
+//
+int sdr_dev_get_stat(sdr_dev_t *dev, int64_t *nerr, int64_t *nover,
+    int64_t *ndrop)
+{
+    if (!dev) return 0;
+    *nerr  = __atomic_load_n(&dev->nerr,  __ATOMIC_RELAXED);
+    *nover = __atomic_load_n(&dev->nover, __ATOMIC_RELAXED);
+    *ndrop = __atomic_load_n(&dev->ndrop, __ATOMIC_RELAXED);
+    return 1;
+}
+
 //------------------------------------------------------------------------------
 //  Get device info of SDR device.
 //
@@ -383,6 +652,11 @@ int sdr_dev_read(sdr_dev_t *dev, uint8_t *buff, int size)
 //  return
 //      number of RF channels (0: error)
 //
+//  notes:
+//      For Pocket SDR FE 4CH with RF channel mask, only the enabled RF channels
+//      are returned in fo and IQ and the IF data format is SDR_FMT_RAW8 for 2
+//      channels or SDR_FMT_PACK for 1 channel.
+//
 int sdr_dev_get_info(sdr_dev_t *dev, int *fmt, double *fs, double *fo, int *IQ)
 {
     double fss;
@@ -405,17 +679,55 @@ int sdr_dev_get_info(sdr_dev_t *dev, int *fmt, double *fs, double *fo, int *IQ)
         }
     }
     else { // Pocket SDR FE
-        int ver = data[0] >> 4;
+        int ver = data[0] >> 4, mask = (ver <= 2) ? 0x3 : (data[4] & 0xF);
+        if (mask == 0) mask = 0xF; // older firmware
         *fmt = (ver <= 2) ? SDR_FMT_RAW8 : SDR_FMT_RAW16; // 2CH : 4CH
-        nch = (ver <= 2) ? 2 : 4;
-        for (int i = 0; i < nch; i++) {
-            if (!read_MAX2771_stat(dev, i, fx, &fss, fo + i, IQ + i)) return 0;
+        if (mask != 0xF && ver > 2) { // FE 4CH with RF channel mask
+            *fmt = (mask & (mask - 1)) ? SDR_FMT_RAW8 : SDR_FMT_PACK;
+        }
+        for (int i = 0; i < ((ver <= 2) ? 2 : 4); i++) {
+            double foi;
+            int IQi;
+            if (!read_MAX2771_stat(dev, i, fx, &fss, &foi, &IQi)) return 0;
             if (i == 0) *fs = fss;
+            if (!(mask & (1 << i))) continue;
+            fo[nch] = foi;
+            IQ[nch++] = IQi;
         }
     }
     return nch;
 }
 
+//------------------------------------------------------------------------------
+//  Set RF channel mask of SDR device (Pocket SDR FE 4CH). Only the samples of
+//  the enabled RF channels are packed by the device and transferred. The new
+//  IF data format is obtained by sdr_dev_get_info(). The mask is reset to all
+//  RF channels at power-on of the device.
+//
+//  args:
+//      dev         (I)   SDR device
+//      mask        (I)   RF channel mask (bit0: CH1, bit1: CH2, ...)
+//                        (1, 2 or 4 RF channels shall be enabled)
+//
+//  return
+//      status (1: OK, 0: error)
+//
+int sdr_dev_set_mask(sdr_dev_t *dev, int mask)
+{
+    uint8_t data[6];
+    
+    if (dev->state) return 0;
+    
+    if (!sdr_usb_req(dev->usb, 0, SDR_VR_STAT, 0, data, 6)) {
+        return 0;
+    }
+    if (((data[3] >> 4) & 1) || data[0] < 0x31) { // Spider SDR or older FE
+        fprintf(stderr, "RF channel mask not supported\n");
+        return 0;
+    }
+    return sdr_usb_req(dev->usb, 0, SDR_VR_CH_MASK, mask & 0xF, NULL, 0);
+}
+
 //------------------------------------------------------------------------------
 //  Set LNA gain of SDR device.
 //
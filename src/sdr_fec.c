@@ -4,6 +4,7 @@
 //  References:
 //  [1] LIBFEC: Clone of Phil Karn's libfec with capability ot build on x86-64
 //      (https://github.com/quiet/libfec)
+//  [2] CCSDS 131.0-B-4, TM Synchronization and Channel Coding, April, 2022
 //
 //  Author:
 //  T.TAKASU
@@ -11,24 +12,185 @@
 //  History:
 //  2022-07-08  1.0  port sdr_fec.py to C
 //  2024-01-26  1.1  sdr_decode_rs() returns number of error bits
+//  2026-10-14  1.2  add streaming Viterbi decoder
+//                   add API sdr_vit_new(), sdr_vit_free(), sdr_vit_init(),
+//                   sdr_vit_update(), sdr_vit_decode()
+//                   sdr_decode_conv() uses streaming Viterbi decoder
+//                   replace RS decoder of LIBFEC by in-tree RS decoder
+//                   add API sdr_encode_rs()
 //
 #include "pocket_sdr.h"
 
-// function prototype of LIBFEC ([1]) ------------------------------------------
-#ifdef __cplusplus
-extern "C" {
-#endif
-int decode_rs_ccsds(uint8_t *data, int *eras_pos, int no_eras, int pad);
-void *create_viterbi27(int len);
-void set_viterbi27_polynomial(int polys[2]);
-int init_viterbi27(void *vp, int starting_state);
-int update_viterbi27_blk(void *vp, unsigned char sym[], int npairs);
-int chainback_viterbi27(void *vp, unsigned char *data, unsigned int nbits,
-    unsigned int endstate);
-void delete_viterbi27(void *vp);
-#ifdef __cplusplus
+// constants -------------------------------------------------------------------
+#define POLY_G1   0x4F          // convolutional code polynomial G1
+#define POLY_G2   0x6D          // convolutional code polynomial G2
+#define METRIC_INF 0x3FFFFFFF   // path metric of invalid state
+#define RS_NN     255           // RS code length (symbols)
+#define RS_NROOTS 32            // RS number of parity symbols
+#define RS_FCR    112           // RS first consecutive root ([2])
+#define RS_PRIM   11            // RS primitive element of roots ([2])
+#define RS_IPRIM  116           // RS_PRIM * RS_IPRIM = 1 mod RS_NN
+#define RS_GFPOLY 0x187         // RS field generator polynomial ([2])
+#define A0        RS_NN         // log of zero in GF(2^8)
+
+#define MIN(x, y) ((x) < (y) ? (x) : (y))
+
+// global variables ------------------------------------------------------------
+static uint8_t branch_tbl[128]; // encoded symbols of register (G1 | G2 << 1)
+static pthread_once_t branch_once = PTHREAD_ONCE_INIT;
+static uint8_t alpha_to[256];   // GF(2^8) power -> vector (alpha_to[A0] = 0)
+static uint8_t index_of[256];   // GF(2^8) vector -> power (index_of[0] = A0)
+static uint8_t genpoly[RS_NROOTS+1]; // RS generator polynomial (power)
+static uint8_t tal_tab[256];    // conventional -> dual basis ([2])
+static uint8_t tal1_tab[256];   // dual basis -> conventional ([2])
+static pthread_once_t rs_once = PTHREAD_ONCE_INIT;
+
+// parity of bits --------------------------------------------------------------
+static int parity(uint32_t x)
+{
+    x ^= x >> 4;
+    x ^= x >> 2;
+    x ^= x >> 1;
+    return x & 1;
+}
+
+// initialize encoded symbols table --------------------------------------------
+static void branch_init(void)
+{
+    for (int r = 0; r < 128; r++) {
+        branch_tbl[r] = (uint8_t)(parity(r & POLY_G1) |
+            (parity(r & POLY_G2) << 1));
+    }
+}
+
+//------------------------------------------------------------------------------
+//  Generate streaming Viterbi decoder of convolution code (K=7, R=1/2,
+//  Poly=G1:0x4F,G2:0x6D). The decoder keeps the path metrics and the decision
+//  history of the latest len steps, so the decoded bits of a sliding window can
+//  be generated by chainback without re-running the trellis.
+//
+//  args:
+//      len      (I) Length of decision history (steps)
+//
+//  return:
+//      Viterbi decoder
+//
+sdr_vit_t *sdr_vit_new(int len)
+{
+    sdr_vit_t *vit = (sdr_vit_t *)sdr_malloc(sizeof(sdr_vit_t));
+    
+    pthread_once(&branch_once, branch_init);
+    vit->len = len;
+    vit->dec = (uint64_t *)sdr_malloc(sizeof(uint64_t) * len);
+    sdr_vit_init(vit, -1);
+    return vit;
+}
+
+//------------------------------------------------------------------------------
+//  Free streaming Viterbi decoder.
+//
+//  args:
+//      vit      (I) Viterbi decoder
+//
+//  return:
+//      none
+//
+void sdr_vit_free(sdr_vit_t *vit)
+{
+    if (!vit) return;
+    sdr_free(vit->dec);
+    sdr_free(vit);
+}
+
+//------------------------------------------------------------------------------
+//  Initialize streaming Viterbi decoder.
+//
+//  args:
+//      vit      (I) Viterbi decoder
+//      state    (I) Starting state (0-63, -1: unknown)
+//
+//  return:
+//      none
+//
+void sdr_vit_init(sdr_vit_t *vit, int state)
+{
+    for (int i = 0; i < 64; i++) {
+        vit->metric[i] = (state < 0 || i == state) ? 0 : METRIC_INF;
+    }
+    vit->n = 0;
+}
+
+//------------------------------------------------------------------------------
+//  Update streaming Viterbi decoder by a pair of symbols (add-compare-select).
+//
+//  args:
+//      vit      (I) Viterbi decoder
+//      sym0     (I) Symbol of G1 (0 to 255 for soft-decision)
+//      sym1     (I) Symbol of G2 (0 to 255 for soft-decision)
+//
+//  return:
+//      none
+//
+void sdr_vit_update(sdr_vit_t *vit, uint8_t sym0, uint8_t sym1)
+{
+    uint32_t bm[4], metric[64], m_min = METRIC_INF;
+    uint64_t dec = 0;
+    
+    // branch metrics of encoded symbols (G1 | G2 << 1)
+    for (int i = 0; i < 4; i++) {
+        bm[i] = ((i & 1) ? 255 - sym0 : sym0) + ((i & 2) ? 255 - sym1 : sym1);
+    }
+    // new state s = (prev state << 1 | bit) & 63
+    for (int s = 0; s < 64; s++) {
+        uint32_t m0 = vit->metric[s >> 1] + bm[branch_tbl[s]];
+        uint32_t m1 = vit->metric[(s >> 1) | 32] + bm[branch_tbl[s | 64]];
+        int d = m1 < m0;
+        metric[s] = d ? m1 : m0;
+        dec |= (uint64_t)d << s;
+        if (metric[s] < m_min) m_min = metric[s];
+    }
+    for (int s = 0; s < 64; s++) { // normalize metrics
+        vit->metric[s] = metric[s] - m_min > METRIC_INF ? METRIC_INF :
+            metric[s] - m_min;
+    }
+    vit->dec[vit->n++ % vit->len] = dec;
+}
+
+//------------------------------------------------------------------------------
+//  Decode bits by chainback of streaming Viterbi decoder. The chainback starts
+//  from the best state (or specified end state) of the latest step and outputs
+//  decoded bits of steps [N - n - tail, N - tail) (N: number of steps).
+//
+//  args:
+//      vit      (I) Viterbi decoder
+//      n        (I) Number of decoded bits
+//      tail     (I) Number of latest steps excluded
+//      state    (I) End state (0-63, -1: best state)
+//      bits     (O) Decoded bits as uint8_t array (0 or 1) (n)
+//
+//  return:
+//      Status (1: OK, 0: not enough steps)
+//
+int sdr_vit_decode(const sdr_vit_t *vit, int n, int tail, int state,
+    uint8_t *bits)
+{
+    if (n <= 0 || n + tail > vit->len || n + tail > vit->n) return 0;
+    
+    if (state < 0) {
+        state = 0;
+        for (int s = 1; s < 64; s++) {
+            if (vit->metric[s] < vit->metric[state]) state = s;
+        }
+    }
+    for (int64_t t = vit->n - 1; t >= vit->n - n - tail; t--) {
+        int d = (int)((vit->dec[t % vit->len] >> state) & 1);
+        if (t < vit->n - tail) {
+            bits[t-(vit->n-n-tail)] = (uint8_t)(state & 1);
+        }
+        state = (state >> 1) | (d << 5);
+    }
+    return 1;
 }
-#endif
 
 //------------------------------------------------------------------------------
 //  Decode convolution code (K=7, R=1/2, Poly=G1:0x4F,G2:0x6D).
@@ -43,40 +205,200 @@ void delete_viterbi27(void *vp);
 //
 void sdr_decode_conv(const uint8_t *data, int N, uint8_t *dec_data)
 {
-    static int poly[] = {0x4F, 0x6D};
     int n = N / 2 - 6;
-    void *dec;
     
-    // initialize Viterbi decoder
-    if (n <= 0 || !(dec = create_viterbi27(n))) {
-        fprintf(stderr, "create_viterbi27() error n=%d\n", n);
+    if (n <= 0) {
+        fprintf(stderr, "sdr_decode_conv() error n=%d\n", n);
         return;
     }
-    // set polynomial
-    set_viterbi27_polynomial(poly);
+    sdr_vit_t *vit = sdr_vit_new(n + 6);
+    sdr_vit_init(vit, 0);
     
-    // update decoder with demodulated symbols
-    if (update_viterbi27_blk(dec, (unsigned char *)data, n + 6)) {
-        fprintf(stderr, "update_viterbi27_blk() error\n");
-        delete_viterbi27(dec);
-        return;
+    for (int i = 0; i < n + 6; i++) {
+        sdr_vit_update(vit, data[i*2], data[i*2+1]);
+    }
+    sdr_vit_decode(vit, n, 6, 0, dec_data);
+    sdr_vit_free(vit);
+}
+
+// modulo RS_NN ---------------------------------------------------------------
+static int modnn(int x)
+{
+    return x % RS_NN;
+}
+
+// initialize RS tables ([1], [2]) ---------------------------------------------
+static void rs_init(void)
+{
+    static const uint8_t tal[] = {
+        0x8d, 0xef, 0xec, 0x86, 0xfa, 0x99, 0xaf, 0x7b
+    };
+    int sr = 1;
+    
+    for (int i = 0; i < RS_NN; i++) {
+        index_of[sr] = (uint8_t)i;
+        alpha_to[i] = (uint8_t)sr;
+        sr <<= 1;
+        if (sr & 256) sr ^= RS_GFPOLY;
     }
-    uint8_t *bits = (uint8_t *)sdr_malloc((n + 7) / 8);
+    index_of[0] = A0;
+    alpha_to[A0] = 0;
     
-    // Viterbi chainback
-    if (chainback_viterbi27(dec, (unsigned char *)bits, n, 0)) {
-        fprintf(stderr, "chainback_viterbi27() error\n");
-        delete_viterbi27(dec);
-        sdr_free(bits);
-        return;
+    uint8_t g[RS_NROOTS+1] = {1};
+    for (int i = 0, root = RS_FCR * RS_PRIM; i < RS_NROOTS; i++,
+        root += RS_PRIM) {
+        g[i+1] = 1;
+        for (int j = i; j > 0; j--) {
+            g[j] = g[j] ? g[j-1] ^ alpha_to[modnn(index_of[g[j]] + root)] :
+                g[j-1];
+        }
+        g[0] = alpha_to[modnn(index_of[g[0]] + root)];
+    }
+    for (int i = 0; i <= RS_NROOTS; i++) {
+        genpoly[i] = index_of[g[i]];
+    }
+    for (int i = 0; i < 256; i++) {
+        int val = 0;
+        for (int j = 0; j < 8; j++) {
+            if (i & (1 << j)) val ^= tal[7-j];
+        }
+        tal_tab[i] = (uint8_t)val;
+        tal1_tab[val] = (uint8_t)i;
+    }
+}
+
+// encode RS(255,223) in conventional basis ([1]) ------------------------------
+static void encode_rs(const uint8_t *data, uint8_t *parity)
+{
+    memset(parity, 0, RS_NROOTS);
+    
+    for (int i = 0; i < RS_NN - RS_NROOTS; i++) {
+        int fb = index_of[data[i] ^ parity[0]];
+        if (fb != A0) {
+            for (int j = 1; j < RS_NROOTS; j++) {
+                parity[j] ^= alpha_to[modnn(fb + genpoly[RS_NROOTS-j])];
+            }
+        }
+        memmove(parity, parity + 1, RS_NROOTS - 1);
+        parity[RS_NROOTS-1] = fb != A0 ? alpha_to[modnn(fb + genpoly[0])] : 0;
+    }
+}
+
+// decode RS(255,223) in conventional basis ([1]) ------------------------------
+//  Berlekamp-Massey algorithm for error locator, Chien search for error
+//  positions and Forney algorithm for error values (no erasures).
+static int decode_rs(uint8_t *data)
+{
+    uint8_t s[RS_NROOTS], lambda[RS_NROOTS+1] = {1}, b[RS_NROOTS+1];
+    uint8_t t[RS_NROOTS+1], omega[RS_NROOTS+1], reg[RS_NROOTS+1];
+    int root[RS_NROOTS], loc[RS_NROOTS], count = 0, el = 0, deg_lambda = 0;
+    int nz = 0;
+    
+    // syndromes (power)
+    for (int i = 0; i < RS_NROOTS; i++) {
+        s[i] = data[0];
+    }
+    for (int j = 1; j < RS_NN; j++) {
+        for (int i = 0; i < RS_NROOTS; i++) {
+            s[i] = s[i] ? data[j] ^ alpha_to[modnn(index_of[s[i]] +
+                (RS_FCR + i) * RS_PRIM)] : data[j];
+        }
+    }
+    for (int i = 0; i < RS_NROOTS; i++) {
+        nz |= s[i];
+        s[i] = index_of[s[i]];
+    }
+    if (!nz) return 0; // no errors
+    
+    // error locator polynomial by Berlekamp-Massey
+    for (int i = 0; i <= RS_NROOTS; i++) {
+        b[i] = index_of[lambda[i]];
+    }
+    for (int r = 1; r <= RS_NROOTS; r++) {
+        int discr = 0;
+        for (int i = 0; i < r; i++) {
+            if (lambda[i] && s[r-i-1] != A0) {
+                discr ^= alpha_to[modnn(index_of[lambda[i]] + s[r-i-1])];
+            }
+        }
+        discr = index_of[discr];
+        if (discr == A0) {
+            memmove(b + 1, b, RS_NROOTS);
+            b[0] = A0;
+            continue;
+        }
+        t[0] = lambda[0];
+        for (int i = 0; i < RS_NROOTS; i++) {
+            t[i+1] = b[i] != A0 ? lambda[i+1] ^ alpha_to[modnn(discr + b[i])] :
+                lambda[i+1];
+        }
+        if (2 * el <= r - 1) {
+            el = r - el;
+            for (int i = 0; i <= RS_NROOTS; i++) {
+                b[i] = lambda[i] ? (uint8_t)modnn(index_of[lambda[i]] - discr +
+                    RS_NN) : A0;
+            }
+        }
+        else {
+            memmove(b + 1, b, RS_NROOTS);
+            b[0] = A0;
+        }
+        memcpy(lambda, t, RS_NROOTS + 1);
     }
-    // delete decoder
-    delete_viterbi27(dec);
+    for (int i = 0; i <= RS_NROOTS; i++) {
+        lambda[i] = index_of[lambda[i]];
+        if (lambda[i] != A0) deg_lambda = i;
+    }
+    // roots of error locator polynomial by Chien search
+    memcpy(reg + 1, lambda + 1, RS_NROOTS);
+    for (int i = 1, k = RS_IPRIM - 1; i <= RS_NN; i++,
+        k = modnn(k + RS_IPRIM)) {
+        int q = 1;
+        for (int j = deg_lambda; j > 0; j--) {
+            if (reg[j] != A0) {
+                reg[j] = (uint8_t)modnn(reg[j] + j);
+                q ^= alpha_to[reg[j]];
+            }
+        }
+        if (q) continue;
+        root[count] = i;
+        loc[count] = k;
+        if (++count == deg_lambda) break;
+    }
+    if (deg_lambda != count) return -1; // uncorrectable
     
-    for (int i = 0; i < n; i++) {
-        dec_data[i] = (bits[i / 8] >> (7 - i % 8)) & 1;
+    // error evaluator polynomial
+    int deg_omega = deg_lambda - 1;
+    for (int i = 0; i <= deg_omega; i++) {
+        int tmp = 0;
+        for (int j = i; j >= 0; j--) {
+            if (s[i-j] != A0 && lambda[j] != A0) {
+                tmp ^= alpha_to[modnn(s[i-j] + lambda[j])];
+            }
+        }
+        omega[i] = index_of[tmp];
     }
-    sdr_free(bits);
+    // error values by Forney algorithm
+    for (int j = count - 1; j >= 0; j--) {
+        int num1 = 0, num2 = alpha_to[modnn(root[j] * (RS_FCR - 1) + RS_NN)];
+        int den = 0;
+        for (int i = deg_omega; i >= 0; i--) {
+            if (omega[i] != A0) {
+                num1 ^= alpha_to[modnn(omega[i] + i * root[j])];
+            }
+        }
+        for (int i = MIN(deg_lambda, RS_NROOTS - 1) & ~1; i >= 0; i -= 2) {
+            if (lambda[i+1] != A0) {
+                den ^= alpha_to[modnn(lambda[i+1] + i * root[j])];
+            }
+        }
+        if (!den) return -1;
+        if (num1) {
+            data[loc[j]] ^= alpha_to[modnn(index_of[num1] + index_of[num2] +
+                RS_NN - index_of[den])];
+        }
+    }
+    return count;
 }
 
 // count bits of "1" -----------------------------------------------------------
@@ -104,17 +426,53 @@ int sdr_decode_rs(uint8_t *syms)
     uint8_t buff[255];
     int nerr = 0;
     
-    // save uncorrected symbols
-    memcpy(buff, syms, 255);
+    pthread_once(&rs_once, rs_init);
     
+    // dual basis to conventional ([2])
+    for (int i = 0; i < 255; i++) {
+        buff[i] = tal1_tab[syms[i]];
+    }
     // decode RS-CCSDS (RS(255,223))
-    if (decode_rs_ccsds(syms, NULL, 0, 0) < 0) {
+    int stat = decode_rs(buff);
+    if (stat < 0) {
         return -1;
     }
-    // number of error bits corrected
-    for (int i = 0; i < 255; i++) {
-        nerr += count_bits(syms[i] ^ buff[i]);
+    // conventional to dual basis and number of error bits corrected
+    for (int i = 0; i < 255 && stat > 0; i++) {
+        uint8_t sym = tal_tab[buff[i]];
+        nerr += count_bits(syms[i] ^ sym);
+        syms[i] = sym;
     }
     return nerr;
 }
 
+//------------------------------------------------------------------------------
+//  Encode Reed-Solomon RS(255,223) code.
+//
+//  args:
+//      syms     (IO) Data symbols as uint8_t array (length = 255).
+//                    syms[0:223] should be set by input data. syms[223:255] are
+//                    set by RS parity before returning the function.
+//
+//  return:
+//      none
+//
+void sdr_encode_rs(uint8_t *syms)
+{
+    uint8_t data[223], parity[RS_NROOTS];
+    
+    pthread_once(&rs_once, rs_init);
+    
+    // dual basis to conventional ([2])
+    for (int i = 0; i < 223; i++) {
+        data[i] = tal1_tab[syms[i]];
+    }
+    // encode RS-CCSDS (RS(255,223))
+    encode_rs(data, parity);
+    
+    // conventional to dual basis
+    for (int i = 0; i < RS_NROOTS; i++) {
+        syms[223+i] = tal_tab[parity[i]];
+    }
+}
+
@@ -25,6 +25,48 @@
 //                   support ARM and NEON
 //  2024-05-13  1.13 add API sdr_str_open(), sdr_str_close()
 //  2024-06-29  1.14 add API sdr_psd_cpx()
+//  2026-10-14  1.15 add API sdr_hist_new(), sdr_hist_free(), sdr_hist_clear(),
+//                   sdr_hist_add(), sdr_hist_back(), sdr_hist_set(),
+//                   sdr_hist_data()
+//                   fuse carrier mixing and correlators in sdr_corr_std()
+//                   add API sdr_set_simd(), sdr_get_simd()
+//                   select SIMD kernels at runtime (AVX2, AVX-512, SVE2)
+//                   add API sdr_scratch_alloc(), sdr_scratch_free(),
+//                   sdr_scratch_release()
+//                   add API sdr_fftw_plan_opt()
+//                   lock-free FFTW plan cache with wisdom-backed plans
+//                   shift Doppler frequency in spectrum in sdr_search_code()
+//                   add API sdr_search_code_multi()
+//                   add API sdr_set_mix(), sdr_get_mix()
+//                   add SIMD NCO carrier mixing kernels
+//                   add API sdr_buff_new_pack(), sdr_buff_get()
+//                   support packed 4-bit IF data buffer
+//                   add API sdr_pacc_new(), sdr_pacc_free(),
+//                   sdr_search_code_pacc(), sdr_pacc_corr_max(),
+//                   sdr_pacc_fine_dop()
+//                   add API sdr_buff_write_raw()
+//                   fix file path w/o ':' in sdr_str_open()
+//                   make CPU budget of signal search configurable
+//                   add API sdr_buff_new_mem()
+//                   correlate contiguous lags in a pass in sdr_corr_std()
+//                   add API sdr_corr_nco()
+//                   add API sdr_corr_fft_share()
+//                   add API sdr_str_async(), write streams by writer threads
+//                   log by per-thread lock-free rings and log writer thread
+//                   add API sdr_pack_raw(), support SDR_FMT_PACK in
+//                   sdr_buff_write_raw()
+//                   add API sdr_str_ifz(), read compressed IF data file by
+//                   sdr_read_data()
+//                   convert IF data w/o temporary buffer in sdr_read_data()
+//                   add API sdr_fftw_plan()
+//                   add API sdr_buff_write_int8(), sdr_search_code_cpx(),
+//                   sdr_search_code_multi_cpx()
+//                   add API sdr_ddc_new(), sdr_ddc_proc(), sdr_ddc_free()
+//                   add SIMD decimation filter kernels
+//                   add API sdr_set_acq_gpu(), search codes by GPU backend
+//                   add API sdr_trace_start(), sdr_trace_stop(),
+//                   sdr_trace_begin(), sdr_trace_end(), sdr_trace_name(),
+//                   sdr_trace_dump(), trace code search and FFTW plan creation
 //
 #include <math.h>
 #include <stdarg.h>
@@ -33,194 +75,1572 @@
 #if defined(WIN32)
 #include <io.h>
 #endif
-#if defined(AVX2)
+#if defined(AVX2) || defined(AVX512)
 #include <immintrin.h>
+#define X86_SIMD
+#define TARGET_AVX2   __attribute__((target("avx2,fma")))
+#define TARGET_AVX512 __attribute__((target("avx2,fma,avx512f,avx512bw")))
+#define TARGET_VNNI   __attribute__((target("avx2,fma,avx512f,avx512bw,avx512vnni")))
 #elif defined(NEON)
 #include <arm_neon.h>
+#if defined(SVE2)
+#include <arm_sve.h>
+#if defined(__linux__)
+#include <sys/auxv.h>
+#ifndef HWCAP2_SVE2
+#define HWCAP2_SVE2   (1 << 1)
+#endif
+#endif
+#endif
 #endif
 
 // constants and macros --------------------------------------------------------
 #define NTBL          256   // carrier-mixed-data LUT size
 #define DOP_STEP      0.5   // Doppler frequency search step (* 1 / code cycle)
-#define MAX_FFTW_PLAN 32    // max number of FFTW plans
+#define MAX_FFTW_PLAN 32    // default max number of FFTW plans
 #define MAX_LOG_BUFF  32768 // max sizeof log buffer
-#define FFTW_FLAG     FFTW_ESTIMATE // FFTW flag
+#define LOG_RING      262144 // size of per-thread log ring (bytes)
+#define MAX_LOG_RING  256   // max number of log rings
+#define MAX_LOG_STR   256   // max length of string argument of log
+#define LOG_CYC       10    // cycle of log writer thread (ms)
+#define TRACE_NEV     65536 // default size of per-thread trace ring (spans)
+#define MAX_TRACE_RING 256  // max number of trace rings
+#define FFTW_FLAG     FFTW_ESTIMATE // default FFTW flag without wisdom
+#define CORR_BLK      1024  // block size of standard correlator (samples)
+#define MAX_SCRATCH   48    // max number of scratch buffer size classes
+#define SCRATCH_HDR   64    // size of scratch buffer header (bytes)
+#define PACC_MAX      65535.0f // max quantized power of compact accumulator
+#define PACC_RESCALE  32768.0f // quantized max power after rescaling
+#define SRCH_NCORR    22    // number of correlations per CPU release in search
+#define MIN_LAGS      8     // min contiguous lags for multi-lag correlator
+#define SPEC_NCACHE   8     // number of shared data spectrums for FFT correlator
+#define SPEC_TOL_F    0.01  // frequency tolerance to share spectrum (cyc/N)
+#define DDC_NTAP      4     // half length of DDC filter (* decimation factor)
+#define DDC_HSCALE    16384.0 // scale of DDC filter taps
+#define DDC_RMS       1.5f  // RMS of DDC output (quantization step)
+#define DDC_AGC       0.05f // time constant of DDC AGC (1/cyc)
 
 #define SQR(x)        ((x) * (x))
 #define MIN(x, y)     ((x) < (y) ? (x) : (y))
+#define MAX(x, y)     ((x) > (y) ? (x) : (y))
 #define ROUND(x)      floor(x + 0.5)
 
+// type definitions ------------------------------------------------------------
+typedef struct {                // SIMD kernels type
+    const char *name;           // SIMD kernels name
+    int (*avail)(void);         // CPU support check (NULL: always)
+    void (*cpx_mul)(const sdr_cpx_t *a, const sdr_cpx_t *b, int N, float s,
+        sdr_cpx_t *c);          // complex multiplication
+    uint32_t (*mix_carr)(const uint8_t *data, int N, uint32_t p, uint32_t s,
+        sdr_cpx16_t *IQ);       // carrier mixing (LUT)
+    uint32_t (*mix_nco)(const uint8_t *data, int N, uint32_t p, uint32_t s,
+        sdr_cpx16_t *IQ);       // carrier mixing (NCO)
+    void (*dot_IQ_code)(const sdr_cpx16_t *IQ, const sdr_cpx16_t *code, int N,
+        float s, sdr_cpx_t *c); // inner product of IQ data and code
+    void (*cvt_IQ)(const sdr_cpx16_t *IQ, int N, float s,
+        sdr_cpx_t *cpx);        // IQ data to complex conversion
+    void (*unpack)(const uint8_t *pk, int N, const sdr_cpx8_t *dec,
+        sdr_cpx8_t *data);      // packed IF data unpacking
+    void (*pack_raw)(const uint8_t *raw, int N, int fmt, int ch,
+        uint8_t *pk);           // raw IF data to packed IF data of RF channel
+    void (*dot_IQ_code_lags)(const sdr_cpx16_t *IQ, const sdr_cpx16_t *code,
+        int N, int L, float s, sdr_cpx_t *c); // inner products of IQ data and
+                                // code of contiguous lags (NULL: by each lag)
+    void (*fir_dec)(const sdr_cpx16_t *IQ, int M, int D, const int16_t *h,
+        int L, int32_t *out);   // decimation filter
+} simd_func_t;
+
+typedef struct {                // code NCO type
+    const int8_t *code;         // code chips
+    int len_code;               // code length (chips)
+    double x0, dx;              // code phase of first sample and step (chips)
+} code_nco_t;
+
+typedef struct {                // FFTW plan cache entry type
+    int N;                      // FFT size (0: empty)
+    fftwf_plan plan[2];         // FFT and IFFT plans
+} fftw_plan_t;
+
+typedef struct {                // shared data spectrum type
+    const sdr_buff_t *buff;     // IF data buffer (NULL: empty)
+    double time;                // sampling time (s)
+    int ix, N;                  // index of IF data buffer and FFT size
+    double fs, fc, phi;         // sampling rate, IF carrier and phase
+    sdr_cpx_t *X;               // data spectrum (N)
+    int size;                   // allocated size of data spectrum
+} spec_t;
+
+typedef struct scratch_tag {    // scratch buffer header type
+    int cls;                    // size class (size = 2^cls bytes)
+    struct scratch_tag *next;   // next free buffer
+} scratch_t;
+
+typedef struct {                // log record header type
+    uint32_t size;              // size of record (bytes, 8-byte aligned)
+    int32_t level;              // log level
+    uint64_t seq;               // sequence number
+    const char *fmt;            // format (NULL: padding to ring end)
+} log_rec_t;                    // followed by packed arguments (8-byte units)
+
+typedef struct {                // per-thread log ring type
+    uint8_t buff[LOG_RING];     // ring buffer of log records
+    uint64_t wp;                // write pointer (bytes, written by owner)
+    uint8_t pad[56];            // padding to separate cache lines
+    uint64_t rp;                // read pointer (bytes, written by log writer)
+    int used;                   // used by thread (0: free)
+} log_ring_t;
+
+typedef struct {                // trace span record type
+    const char *cat, *name;     // category and name (static strings)
+    int64_t arg;                // argument
+    int64_t t0, t1;             // begin and end time (ns)
+} trace_ev_t;
+
+typedef struct {                // per-thread trace ring type
+    trace_ev_t *ev;             // ring buffer of spans (NULL: not allocated)
+    int nev;                    // size of ring buffer (spans)
+    int tid;                    // thread ID in trace
+    char name[16];              // thread name
+    uint64_t wp;                // write pointer (spans, written by owner)
+    int used;                   // used by thread (0: free)
+} trace_ring_t;
+
 // global variables ------------------------------------------------------------
-static sdr_cpx16_t mix_tbl[NTBL*256] = {{0,0}}; // carrier-mixed-data LUT
-static fftwf_plan fftw_plans[MAX_FFTW_PLAN][2] = {{0}}; // FFTW plan buffer
-static int fftw_size[MAX_FFTW_PLAN] = {0}; // FFTW plan sizes
+static sdr_cpx16_t mix_tbl[NTBL*256+1] = {{0,0}}; // carrier-mixed-data LUT
+                                  // (+1 for 32-bit gather of last entry)
+static fftw_plan_t *fftw_plans = NULL; // FFTW plan cache (hash table)
+static int fftw_nbit = 0;         // FFTW plan cache size (2^fftw_nbit)
+static int fftw_nplan = 0;        // number of FFTW plans
+static int fftw_max = MAX_FFTW_PLAN; // max number of FFTW plans
+static unsigned int fftw_flag = FFTW_FLAG; // FFTW flag without wisdom
+int sdr_srch_ncorr = SRCH_NCORR;  // CPU budget of signal search (number of
+                                  // correlations per 1 ms sleep, 0: no sleep)
+static int fftw_wisdom = 0;       // FFTW wisdom imported
+static int mix_nco = 0;           // carrier mixing (0: LUT, 1: NCO)
+static pthread_mutex_t fftw_mtx = PTHREAD_MUTEX_INITIALIZER;
 static int log_lvl = 3;           // log level
-static stream_t *log_str = NULL;  // log stream
+static sdr_str_t *log_str = NULL; // log stream
 static char log_buff[MAX_LOG_BUFF]; // log buffer
 static int log_buff_p = 0;        // log buffer pointer
 static pthread_mutex_t log_buff_mtx = PTHREAD_MUTEX_INITIALIZER;
+static log_ring_t *log_rings[MAX_LOG_RING]; // per-thread log rings
+static int log_nring = 0;         // number of log rings
+static uint64_t log_seq = 0;      // sequence number of log records
+static int64_t log_ndrop = 0;     // number of dropped log records
+static pthread_key_t log_key;     // thread-local log ring
+static pthread_once_t log_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t log_wr_mtx = PTHREAD_MUTEX_INITIALIZER;
+static int trace_on = 0;          // tracing (0:off,1:on)
+static int trace_nev = TRACE_NEV; // size of trace rings (spans)
+static int64_t trace_t0 = 0;      // start time of tracing (ns)
+static int trace_ntid = 0;        // number of thread IDs in trace
+static trace_ring_t *trace_rings[MAX_TRACE_RING]; // per-thread trace rings
+static int trace_nring = 0;       // number of trace rings
+static pthread_key_t trace_key;   // thread-local trace ring
+static pthread_once_t trace_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t trace_mtx = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t scratch_key; // thread-local scratch buffer lists
+static pthread_once_t scratch_once = PTHREAD_ONCE_INIT;
+static spec_t spec_cache[SPEC_NCACHE]; // shared data spectrums
+static int spec_next = 0;         // next entry of shared data spectrums
+static pthread_mutex_t spec_mtx = PTHREAD_MUTEX_INITIALIZER;
+static int acq_gpu = 0;           // GPU backend of code search (0:off,1:on)
+static pthread_mutex_t gpu_mtx = PTHREAD_MUTEX_INITIALIZER;
+
+// generic kernels -------------------------------------------------------------
+static void cpx_mul_c(const sdr_cpx_t *a, const sdr_cpx_t *b, int N, float s,
+    sdr_cpx_t *c)
+{
+    for (int i = 0; i < N; i++) {
+        float re = a[i][0] * b[i][0] - a[i][1] * b[i][1];
+        float im = a[i][0] * b[i][1] + a[i][1] * b[i][0];
+        c[i][0] = re * s;
+        c[i][1] = im * s;
+    }
+}
+
+static uint32_t mix_carr_c(const uint8_t *data, int N, uint32_t p, uint32_t s,
+    sdr_cpx16_t *IQ)
+{
+    for (int i = 0; i < N; i++, p += s) {
+        IQ[i] = mix_tbl[((int)data[i] << 8) + (p >> 24)];
+    }
+    return p;
+}
+
+// seed carrier phasors of n NCO lanes and phasor rotation of n samples --------
+static void nco_seed(uint32_t p, uint32_t s, int n, float *cI, float *cQ,
+    float *rot)
+{
+    double a = -2.0 * PI * p / 4294967296.0, b = -2.0 * PI * s / 4294967296.0;
+    double I = cos(a) / SDR_CSCALE, Q = sin(a) / SDR_CSCALE;
+    double rI = cos(b), rQ = sin(b);
+    
+    for (int k = 0; k < n; k++) {
+        double t = I * rI - Q * rQ;
+        cI[k] = (float)I;
+        cQ[k] = (float)Q;
+        Q = I * rQ + Q * rI;
+        I = t;
+    }
+    rot[0] = (float)cos(b * n);
+    rot[1] = (float)sin(b * n);
+}
+
+static uint32_t mix_nco_c(const uint8_t *data, int N, uint32_t p, uint32_t s,
+    sdr_cpx16_t *IQ)
+{
+    float cI, cQ, rot[2];
+    
+    nco_seed(p, s, 1, &cI, &cQ, rot);
+    
+    for (int i = 0; i < N; i++) {
+        float I = SDR_CPX8_I(data[i]), Q = SDR_CPX8_Q(data[i]), t;
+        IQ[i].I = (int8_t)lrintf(I * cI - Q * cQ);
+        IQ[i].Q = (int8_t)lrintf(I * cQ + Q * cI);
+        t  = cI * rot[0] - cQ * rot[1];
+        cQ = cI * rot[1] + cQ * rot[0];
+        cI = t;
+    }
+    return p + s * N;
+}
+
+static void dot_IQ_code_c(const sdr_cpx16_t *IQ, const sdr_cpx16_t *code,
+    int N, float s, sdr_cpx_t *c)
+{
+    int32_t sumI = 0, sumQ = 0;
+    
+    for (int i = 0; i < N; i++) {
+        sumI += IQ[i].I * code[i].I;
+        sumQ += IQ[i].Q * code[i].Q;
+    }
+    (*c)[0] = sumI * s * SDR_CSCALE;
+    (*c)[1] = sumQ * s * SDR_CSCALE;
+}
+
+static void cvt_IQ_c(const sdr_cpx16_t *IQ, int N, float s, sdr_cpx_t *cpx)
+{
+    for (int i = 0; i < N; i++) {
+        cpx[i][0] = IQ[i].I * s;
+        cpx[i][1] = IQ[i].Q * s;
+    }
+}
+
+static void fir_dec_c(const sdr_cpx16_t *IQ, int M, int D, const int16_t *h,
+    int L, int32_t *out)
+{
+    for (int i = 0; i < M; i++, IQ += D) {
+        int32_t sumI = 0, sumQ = 0;
+        for (int j = 0; j < L; j++) {
+            sumI += IQ[j].I * h[j*2];
+            sumQ += IQ[j].Q * h[j*2];
+        }
+        out[i*2  ] = sumI;
+        out[i*2+1] = sumQ;
+    }
+}
+
+static void unpack_c(const uint8_t *pk, int N, const sdr_cpx8_t *dec,
+    sdr_cpx8_t *data)
+{
+    int i = 0;
+    
+    for ( ; i < N - 1; i += 2, pk++) {
+        data[i  ] = dec[*pk & 0xF];
+        data[i+1] = dec[*pk >> 4];
+    }
+    if (i < N) {
+        data[i] = dec[*pk & 0xF];
+    }
+}
+
+// sample layout of raw IF data of RF channel: bytes per sample, byte offset,
+// bit shift and bit mask of sample code
+static void raw_layout(int fmt, int ch, int *ns, int *off, int *sft, int *msk)
+{
+    if (fmt == SDR_FMT_RAW8) { // packed 8 bits raw (2CH)
+        *ns = 1; *off = 0; *sft = ch % 2 * 4; *msk = 0xF;
+    }
+    else if (fmt == SDR_FMT_RAW16) { // packed 16 bits raw (4CH)
+        *ns = 2; *off = ch / 2; *sft = ch % 2 * 4; *msk = 0xF;
+    }
+    else { // packed 16 bits raw (8CH, I-sampling)
+        *ns = 2; *off = ch / 4; *sft = ch % 4 * 2; *msk = 0x3;
+    }
+}
+
+static void pack_raw_c(const uint8_t *raw, int N, int fmt, int ch,
+    uint8_t *pk)
+{
+    int ns, off, sft, msk, i = 0;
+    
+    raw_layout(fmt, ch, &ns, &off, &sft, &msk);
+    raw += off;
+    for ( ; i < N - 1; i += 2, raw += ns * 2) {
+        *pk++ = (uint8_t)(((raw[0] >> sft) & msk) |
+            (((raw[ns] >> sft) & msk) << 4));
+    }
+    if (i < N) {
+        *pk = (uint8_t)((raw[0] >> sft) & msk);
+    }
+}
+
+#if defined(X86_SIMD)
+// AVX2 kernels ----------------------------------------------------------------
+#define sum_s16(ymm, sum) { \
+    int16_t s[16]; \
+    _mm256_storeu_si256((__m256i *)s, ymm); \
+    ymm = _mm256_setzero_si256(); \
+    sum += s[0] + s[1] + s[2] + s[3] + s[4] + s[5] + s[6] + s[7] + s[8] + s[9] \
+        + s[10] + s[11] + s[12] + s[13] + s[14] + s[15]; \
+}
+
+TARGET_AVX2
+static void cpx_mul_avx2(const sdr_cpx_t *a, const sdr_cpx_t *b, int N,
+    float s, sdr_cpx_t *c)
+{
+    __m256 yr = _mm256_set_ps(-1, 1, -1, 1, -1, 1, -1, 1);
+    __m256 ys = _mm256_set1_ps(s);
+    int i = 0;
+    
+    for ( ; i < N - 3; i += 4) {
+         __m256 ya = _mm256_loadu_ps((float *)(a + i));
+         __m256 yb = _mm256_loadu_ps((float *)(b + i));
+         __m256 yc = _mm256_mul_ps(ya, _mm256_mul_ps(yb, yr));
+         __m256 yd = _mm256_mul_ps(ya, _mm256_permute_ps(yb, 0xB1));
+         __m256 ye = _mm256_permute_ps(_mm256_hadd_ps(yc, yd), 0xD8);
+         _mm256_storeu_ps((float *)(c + i), _mm256_mul_ps(ye, ys));
+    }
+    cpx_mul_c(a + i, b + i, N - i, s, c + i);
+}
+
+TARGET_AVX2
+static uint32_t mix_carr_avx2(const uint8_t *data, int N, uint32_t p,
+    uint32_t s, sdr_cpx16_t *IQ)
+{
+    __m256i yp = _mm256_set_epi32(p+s*7, p+s*6, p+s*5, p+s*4, p+s*3, p+s*2, p+s, p);
+    __m256i ys = _mm256_set1_epi32(s*8);
+    int i = 0;
+    
+    for ( ; i < N - 16; i += 8) {
+        int idx[8];
+        __m128i xdas = _mm_loadu_si128((__m128i *)(data + i));
+        __m256i ydat = _mm256_cvtepu8_epi32(xdas);
+        __m256i yidx = _mm256_add_epi32(_mm256_slli_epi32(ydat, 8),
+            _mm256_srli_epi32(yp, 24));
+        _mm256_storeu_si256((__m256i *)idx, yidx);
+        IQ[i  ] = mix_tbl[idx[0]];
+        IQ[i+1] = mix_tbl[idx[1]];
+        IQ[i+2] = mix_tbl[idx[2]];
+        IQ[i+3] = mix_tbl[idx[3]];
+        IQ[i+4] = mix_tbl[idx[4]];
+        IQ[i+5] = mix_tbl[idx[5]];
+        IQ[i+6] = mix_tbl[idx[6]];
+        IQ[i+7] = mix_tbl[idx[7]];
+        yp = _mm256_add_epi32(yp, ys);
+    }
+    return mix_carr_c(data + i, N - i, p + s * i, s, IQ + i);
+}
+
+TARGET_AVX2
+static uint32_t mix_nco_avx2(const uint8_t *data, int N, uint32_t p,
+    uint32_t s, sdr_cpx16_t *IQ)
+{
+    float cI[8], cQ[8], rot[2];
+    
+    nco_seed(p, s, 8, cI, cQ, rot);
+    __m256 ycI = _mm256_loadu_ps(cI), ycQ = _mm256_loadu_ps(cQ);
+    __m256 yrI = _mm256_set1_ps(rot[0]), yrQ = _mm256_set1_ps(rot[1]);
+    __m256i ymsk = _mm256_set1_epi32(0xFF);
+    int i = 0;
+    
+    for ( ; i < N - 7; i += 8) {
+        __m256i ydat = _mm256_cvtepu8_epi32(_mm_loadl_epi64((__m128i *)(data + i)));
+        __m256 yI = _mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_slli_epi32(ydat, 28), 28));
+        __m256 yQ = _mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_slli_epi32(ydat, 24), 28));
+        __m256i yoI = _mm256_cvtps_epi32(_mm256_fmsub_ps(yI, ycI, _mm256_mul_ps(yQ, ycQ)));
+        __m256i yoQ = _mm256_cvtps_epi32(_mm256_fmadd_ps(yI, ycQ, _mm256_mul_ps(yQ, ycI)));
+        __m256i yval = _mm256_or_si256(_mm256_and_si256(yoI, ymsk),
+            _mm256_slli_epi32(_mm256_and_si256(yoQ, ymsk), 8));
+        __m256i ypck = _mm256_permute4x64_epi64(_mm256_packus_epi32(yval, yval), 0x08);
+        _mm_storeu_si128((__m128i *)(IQ + i), _mm256_castsi256_si128(ypck));
+        __m256 yt = _mm256_fmsub_ps(ycI, yrI, _mm256_mul_ps(ycQ, yrQ));
+        ycQ = _mm256_fmadd_ps(ycI, yrQ, _mm256_mul_ps(ycQ, yrI));
+        ycI = yt;
+    }
+    return mix_nco_c(data + i, N - i, p + s * i, s, IQ + i);
+}
+
+TARGET_AVX2
+static void dot_IQ_code_avx2(const sdr_cpx16_t *IQ, const sdr_cpx16_t *code,
+    int N, float s, sdr_cpx_t *c)
+{
+    __m256i ysumI = _mm256_setzero_si256();
+    __m256i ysumQ = _mm256_setzero_si256();
+    __m256i yextI = _mm256_set_epi8(0,1,0,1,0,1,0,1, 0,1,0,1,0,1,0,1,
+        0,1,0,1,0,1,0,1, 0,1,0,1,0,1,0,1);
+    __m256i yextQ = _mm256_set_epi8(1,0,1,0,1,0,1,0, 1,0,1,0,1,0,1,0,
+        1,0,1,0,1,0,1,0, 1,0,1,0,1,0,1,0);
+    int32_t sumI = 0, sumQ = 0;
+    int i = 0;
+    
+    for ( ; i < N - 15; i += 16) {
+        __m256i ydata = _mm256_loadu_si256((__m256i *)(IQ + i));
+        __m256i ycode = _mm256_loadu_si256((__m256i *)(code + i)); // {-1,0,1}
+        __m256i ycorr = _mm256_sign_epi8(ydata, ycode); // IQ * code
+        ysumI = _mm256_add_epi16(ysumI, _mm256_maddubs_epi16(yextI, ycorr));
+        ysumQ = _mm256_add_epi16(ysumQ, _mm256_maddubs_epi16(yextQ, ycorr));
+        if (i % (16 * 256) == 0) {
+            sum_s16(ysumI, sumI)
+            sum_s16(ysumQ, sumQ)
+        }
+    }
+    sum_s16(ysumI, sumI)
+    sum_s16(ysumQ, sumQ)
+    for ( ; i < N; i++) {
+        sumI += IQ[i].I * code[i].I;
+        sumQ += IQ[i].Q * code[i].Q;
+    }
+    (*c)[0] = sumI * s * SDR_CSCALE;
+    (*c)[1] = sumQ * s * SDR_CSCALE;
+}
+
+// inner products of IQ data and code of lags 0,...,L-1 (code[i-l]) in a pass:
+// IQ data are loaded once for every 4 lags
+#define dot_lag_avx2(ydata, code, ysumI, ysumQ) { \
+    __m256i ycorr = _mm256_sign_epi8(ydata, \
+        _mm256_loadu_si256((__m256i *)(code))); /* IQ * code */ \
+    ysumI = _mm256_add_epi16(ysumI, _mm256_maddubs_epi16(yextI, ycorr)); \
+    ysumQ = _mm256_add_epi16(ysumQ, _mm256_maddubs_epi16(yextQ, ycorr)); \
+}
+
+TARGET_AVX2
+static void dot_IQ_code_lags_avx2(const sdr_cpx16_t *IQ,
+    const sdr_cpx16_t *code, int N, int L, float s, sdr_cpx_t *c)
+{
+    __m256i yextI = _mm256_set_epi8(0,1,0,1,0,1,0,1, 0,1,0,1,0,1,0,1,
+        0,1,0,1,0,1,0,1, 0,1,0,1,0,1,0,1);
+    __m256i yextQ = _mm256_set_epi8(1,0,1,0,1,0,1,0, 1,0,1,0,1,0,1,0,
+        1,0,1,0,1,0,1,0, 1,0,1,0,1,0,1,0);
+    int l = 0;
+    
+    for ( ; l < L - 3; l += 4) {
+        __m256i ysI0 = _mm256_setzero_si256(), ysQ0 = _mm256_setzero_si256();
+        __m256i ysI1 = _mm256_setzero_si256(), ysQ1 = _mm256_setzero_si256();
+        __m256i ysI2 = _mm256_setzero_si256(), ysQ2 = _mm256_setzero_si256();
+        __m256i ysI3 = _mm256_setzero_si256(), ysQ3 = _mm256_setzero_si256();
+        int32_t sumI[4] = {0}, sumQ[4] = {0};
+        const sdr_cpx16_t *cl = code - l;
+        int i = 0;
+        
+        for ( ; i < N - 15; i += 16) {
+            __m256i ydata = _mm256_loadu_si256((__m256i *)(IQ + i));
+            dot_lag_avx2(ydata, cl + i    , ysI0, ysQ0)
+            dot_lag_avx2(ydata, cl + i - 1, ysI1, ysQ1)
+            dot_lag_avx2(ydata, cl + i - 2, ysI2, ysQ2)
+            dot_lag_avx2(ydata, cl + i - 3, ysI3, ysQ3)
+            if (i % (16 * 256) == 16 * 255) {
+                sum_s16(ysI0, sumI[0]) sum_s16(ysQ0, sumQ[0])
+                sum_s16(ysI1, sumI[1]) sum_s16(ysQ1, sumQ[1])
+                sum_s16(ysI2, sumI[2]) sum_s16(ysQ2, sumQ[2])
+                sum_s16(ysI3, sumI[3]) sum_s16(ysQ3, sumQ[3])
+            }
+        }
+        sum_s16(ysI0, sumI[0]) sum_s16(ysQ0, sumQ[0])
+        sum_s16(ysI1, sumI[1]) sum_s16(ysQ1, sumQ[1])
+        sum_s16(ysI2, sumI[2]) sum_s16(ysQ2, sumQ[2])
+        sum_s16(ysI3, sumI[3]) sum_s16(ysQ3, sumQ[3])
+        
+        for (int j = 0; j < 4; j++) {
+            for (int k = i; k < N; k++) {
+                sumI[j] += IQ[k].I * cl[k-j].I;
+                sumQ[j] += IQ[k].Q * cl[k-j].Q;
+            }
+            c[l+j][0] = sumI[j] * s * SDR_CSCALE;
+            c[l+j][1] = sumQ[j] * s * SDR_CSCALE;
+        }
+    }
+    for ( ; l < L; l++) {
+        dot_IQ_code_avx2(IQ, code - l, N, s, c + l);
+    }
+}
+
+TARGET_AVX2
+static void cvt_IQ_avx2(const sdr_cpx16_t *IQ, int N, float s, sdr_cpx_t *cpx)
+{
+    __m256 ys = _mm256_set1_ps(s);
+    int i = 0;
+    
+    for ( ; i < N - 3; i += 4) {
+        __m256i ydat = _mm256_cvtepi8_epi32(_mm_loadl_epi64((__m128i *)(IQ + i)));
+        _mm256_storeu_ps((float *)(cpx + i),
+            _mm256_mul_ps(_mm256_cvtepi32_ps(ydat), ys));
+    }
+    cvt_IQ_c(IQ + i, N - i, s, cpx + i);
+}
+
+TARGET_AVX2
+static void fir_dec_avx2(const sdr_cpx16_t *IQ, int M, int D, const int16_t *h,
+    int L, int32_t *out)
+{
+    const int16_t *hI = h, *hQ = h + L * 2;
+    
+    for (int i = 0; i < M; i++, IQ += D) {
+        __m256i yI = _mm256_setzero_si256(), yQ = _mm256_setzero_si256();
+        for (int j = 0; j < L; j += 8) {
+            __m256i ydat = _mm256_cvtepi8_epi16(_mm_loadu_si128((__m128i *)(IQ + j)));
+            yI = _mm256_add_epi32(yI, _mm256_madd_epi16(ydat,
+                _mm256_loadu_si256((__m256i *)(hI + j * 2))));
+            yQ = _mm256_add_epi32(yQ, _mm256_madd_epi16(ydat,
+                _mm256_loadu_si256((__m256i *)(hQ + j * 2))));
+        }
+        __m256i ysum = _mm256_hadd_epi32(yI, yQ);
+        ysum = _mm256_hadd_epi32(ysum, ysum);
+        __m128i xsum = _mm_add_epi32(_mm256_castsi256_si128(ysum),
+            _mm256_extracti128_si256(ysum, 1));
+        out[i*2  ] = _mm_cvtsi128_si32(xsum);
+        out[i*2+1] = _mm_extract_epi32(xsum, 1);
+    }
+}
+
+TARGET_AVX2
+static void unpack_avx2(const uint8_t *pk, int N, const sdr_cpx8_t *dec,
+    sdr_cpx8_t *data)
+{
+    __m128i xdec = _mm_loadu_si128((__m128i *)dec);
+    __m128i xmsk = _mm_set1_epi8(0xF);
+    int i = 0;
+    
+    for ( ; i < N - 31; i += 32) {
+        __m128i xpk = _mm_loadu_si128((__m128i *)(pk + i / 2));
+        __m128i xlo = _mm_shuffle_epi8(xdec, _mm_and_si128(xpk, xmsk));
+        __m128i xhi = _mm_shuffle_epi8(xdec,
+            _mm_and_si128(_mm_srli_epi16(xpk, 4), xmsk));
+        _mm_storeu_si128((__m128i *)(data + i), _mm_unpacklo_epi8(xlo, xhi));
+        _mm_storeu_si128((__m128i *)(data + i + 16), _mm_unpackhi_epi8(xlo, xhi));
+    }
+    unpack_c(pk + i / 2, N - i, dec, data + i);
+}
+
+TARGET_AVX2
+static void pack_raw_avx2(const uint8_t *raw, int N, int fmt, int ch,
+    uint8_t *pk)
+{
+    int ns, off, sft, msk, i = 0;
+    
+    raw_layout(fmt, ch, &ns, &off, &sft, &msk);
+    
+    if (ns == 1) { // a pair of samples in 16 bits
+        __m128i xs0 = _mm_cvtsi32_si128(sft), xs1 = _mm_cvtsi32_si128(sft + 4);
+        __m256i ym0 = _mm256_set1_epi16(msk), ym1 = _mm256_set1_epi16(msk << 4);
+        for ( ; i < N - 31; i += 32) {
+            __m256i yraw = _mm256_loadu_si256((__m256i *)(raw + i));
+            __m256i ypk = _mm256_or_si256(
+                _mm256_and_si256(_mm256_srl_epi16(yraw, xs0), ym0),
+                _mm256_and_si256(_mm256_srl_epi16(yraw, xs1), ym1));
+            ypk = _mm256_permute4x64_epi64(_mm256_packus_epi16(ypk, ypk), 0x08);
+            _mm_storeu_si128((__m128i *)(pk + i / 2),
+                _mm256_castsi256_si128(ypk));
+        }
+    }
+    else { // a pair of samples in 32 bits
+        __m128i xs0 = _mm_cvtsi32_si128(off * 8 + sft);
+        __m128i xs1 = _mm_cvtsi32_si128(off * 8 + sft + 12);
+        __m256i ym0 = _mm256_set1_epi32(msk), ym1 = _mm256_set1_epi32(msk << 4);
+        __m256i yidx = _mm256_setr_epi32(0, 4, 0, 4, 0, 4, 0, 4);
+        for ( ; i < N - 15; i += 16) {
+            __m256i yraw = _mm256_loadu_si256((__m256i *)(raw + i * 2));
+            __m256i ypk = _mm256_or_si256(
+                _mm256_and_si256(_mm256_srl_epi32(yraw, xs0), ym0),
+                _mm256_and_si256(_mm256_srl_epi32(yraw, xs1), ym1));
+            ypk = _mm256_packus_epi32(ypk, ypk);
+            ypk = _mm256_packus_epi16(ypk, ypk);
+            ypk = _mm256_permutevar8x32_epi32(ypk, yidx);
+            _mm_storel_epi64((__m128i *)(pk + i / 2),
+                _mm256_castsi256_si128(ypk));
+        }
+    }
+    pack_raw_c(raw + i * ns, N - i, fmt, ch, pk + i / 2);
+}
+
+// AVX-512 kernels -------------------------------------------------------------
+#if defined(__GNUC__) && !defined(__clang__) // false warnings in GCC 12 headers
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+TARGET_AVX512
+static int32_t sum_s32(__m512i zmm)
+{
+    int32_t s[16], sum = 0;
+    _mm512_storeu_si512((__m512i *)s, zmm);
+    for (int i = 0; i < 16; i++) sum += s[i];
+    return sum;
+}
+
+TARGET_AVX512
+static void cpx_mul_avx512(const sdr_cpx_t *a, const sdr_cpx_t *b, int N,
+    float s, sdr_cpx_t *c)
+{
+    __m512 zs = _mm512_set1_ps(s);
+    int i = 0;
+    
+    for ( ; i < N - 7; i += 8) {
+        __m512 za = _mm512_loadu_ps((float *)(a + i));
+        __m512 zb = _mm512_loadu_ps((float *)(b + i));
+        __m512 zt = _mm512_mul_ps(_mm512_shuffle_ps(za, za, 0xB1),
+            _mm512_shuffle_ps(zb, zb, 0xF5)); // (a.Q * b.Q, a.I * b.Q)
+        __m512 zc = _mm512_fmaddsub_ps(za, _mm512_shuffle_ps(zb, zb, 0xA0), zt);
+        _mm512_storeu_ps((float *)(c + i), _mm512_mul_ps(zc, zs));
+    }
+    cpx_mul_c(a + i, b + i, N - i, s, c + i);
+}
+
+TARGET_AVX512
+static uint32_t mix_carr_avx512(const uint8_t *data, int N, uint32_t p,
+    uint32_t s, sdr_cpx16_t *IQ)
+{
+    __m512i zp = _mm512_add_epi32(_mm512_set1_epi32(p),
+        _mm512_mullo_epi32(_mm512_set_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7,
+        6, 5, 4, 3, 2, 1, 0), _mm512_set1_epi32(s)));
+    __m512i zs = _mm512_set1_epi32(s*16);
+    int i = 0;
+    
+    for ( ; i < N - 15; i += 16) {
+        __m512i zdat = _mm512_cvtepu8_epi32(_mm_loadu_si128((__m128i *)(data + i)));
+        __m512i zidx = _mm512_add_epi32(_mm512_slli_epi32(zdat, 8),
+            _mm512_srli_epi32(zp, 24));
+        __m512i zval = _mm512_i32gather_epi32(zidx, (const int *)mix_tbl, 2);
+        _mm256_storeu_si256((__m256i *)(IQ + i), _mm512_cvtepi32_epi16(zval));
+        zp = _mm512_add_epi32(zp, zs);
+    }
+    return mix_carr_c(data + i, N - i, p + s * i, s, IQ + i);
+}
+
+TARGET_AVX512
+static uint32_t mix_nco_avx512(const uint8_t *data, int N, uint32_t p,
+    uint32_t s, sdr_cpx16_t *IQ)
+{
+    float cI[16], cQ[16], rot[2];
+    
+    nco_seed(p, s, 16, cI, cQ, rot);
+    __m512 zcI = _mm512_loadu_ps(cI), zcQ = _mm512_loadu_ps(cQ);
+    __m512 zrI = _mm512_set1_ps(rot[0]), zrQ = _mm512_set1_ps(rot[1]);
+    __m512i zmsk = _mm512_set1_epi32(0xFF);
+    int i = 0;
+    
+    for ( ; i < N - 15; i += 16) {
+        __m512i zdat = _mm512_cvtepu8_epi32(_mm_loadu_si128((__m128i *)(data + i)));
+        __m512 zI = _mm512_cvtepi32_ps(_mm512_srai_epi32(_mm512_slli_epi32(zdat, 28), 28));
+        __m512 zQ = _mm512_cvtepi32_ps(_mm512_srai_epi32(_mm512_slli_epi32(zdat, 24), 28));
+        __m512i zoI = _mm512_cvtps_epi32(_mm512_fmsub_ps(zI, zcI, _mm512_mul_ps(zQ, zcQ)));
+        __m512i zoQ = _mm512_cvtps_epi32(_mm512_fmadd_ps(zI, zcQ, _mm512_mul_ps(zQ, zcI)));
+        __m512i zval = _mm512_or_si512(_mm512_and_si512(zoI, zmsk),
+            _mm512_slli_epi32(_mm512_and_si512(zoQ, zmsk), 8));
+        _mm256_storeu_si256((__m256i *)(IQ + i), _mm512_cvtepi32_epi16(zval));
+        __m512 zt = _mm512_fmsub_ps(zcI, zrI, _mm512_mul_ps(zcQ, zrQ));
+        zcQ = _mm512_fmadd_ps(zcI, zrQ, _mm512_mul_ps(zcQ, zrI));
+        zcI = zt;
+    }
+    return mix_nco_c(data + i, N - i, p + s * i, s, IQ + i);
+}
+
+TARGET_AVX512
+static void dot_IQ_code_avx512(const sdr_cpx16_t *IQ, const sdr_cpx16_t *code,
+    int N, float s, sdr_cpx_t *c)
+{
+    __m512i zsumI = _mm512_setzero_si512();
+    __m512i zsumQ = _mm512_setzero_si512();
+    __m512i zmskI = _mm512_set1_epi32(0x0000FFFF);
+    __m512i zmskQ = _mm512_set1_epi32((int)0xFFFF0000);
+    int i = 0;
+    
+    for ( ; i < N - 15; i += 16) {
+        __m512i zdata = _mm512_cvtepi8_epi16(_mm256_loadu_si256((__m256i *)(IQ + i)));
+        __m512i zcode = _mm512_cvtepi8_epi16(_mm256_loadu_si256((__m256i *)(code + i)));
+        zsumI = _mm512_add_epi32(zsumI, _mm512_madd_epi16(zdata,
+            _mm512_and_si512(zcode, zmskI)));
+        zsumQ = _mm512_add_epi32(zsumQ, _mm512_madd_epi16(zdata,
+            _mm512_and_si512(zcode, zmskQ)));
+    }
+    int32_t sumI = sum_s32(zsumI), sumQ = sum_s32(zsumQ);
+    for ( ; i < N; i++) {
+        sumI += IQ[i].I * code[i].I;
+        sumQ += IQ[i].Q * code[i].Q;
+    }
+    (*c)[0] = sumI * s * SDR_CSCALE;
+    (*c)[1] = sumQ * s * SDR_CSCALE;
+}
+
+TARGET_VNNI
+static void dot_IQ_code_vnni(const sdr_cpx16_t *IQ, const sdr_cpx16_t *code,
+    int N, float s, sdr_cpx_t *c)
+{
+    __m512i zsumI = _mm512_setzero_si512();
+    __m512i zsumQ = _mm512_setzero_si512();
+    __m512i zmskI = _mm512_set1_epi32(0x0000FFFF);
+    __m512i zmskQ = _mm512_set1_epi32((int)0xFFFF0000);
+    int i = 0;
+    
+    for ( ; i < N - 15; i += 16) {
+        __m512i zdata = _mm512_cvtepi8_epi16(_mm256_loadu_si256((__m256i *)(IQ + i)));
+        __m512i zcode = _mm512_cvtepi8_epi16(_mm256_loadu_si256((__m256i *)(code + i)));
+        zsumI = _mm512_dpwssd_epi32(zsumI, zdata, _mm512_and_si512(zcode, zmskI));
+        zsumQ = _mm512_dpwssd_epi32(zsumQ, zdata, _mm512_and_si512(zcode, zmskQ));
+    }
+    int32_t sumI = sum_s32(zsumI), sumQ = sum_s32(zsumQ);
+    for ( ; i < N; i++) {
+        sumI += IQ[i].I * code[i].I;
+        sumQ += IQ[i].Q * code[i].Q;
+    }
+    (*c)[0] = sumI * s * SDR_CSCALE;
+    (*c)[1] = sumQ * s * SDR_CSCALE;
+}
+
+TARGET_AVX512
+static void cvt_IQ_avx512(const sdr_cpx16_t *IQ, int N, float s,
+    sdr_cpx_t *cpx)
+{
+    __m512 zs = _mm512_set1_ps(s);
+    int i = 0;
+    
+    for ( ; i < N - 7; i += 8) {
+        __m512i zdat = _mm512_cvtepi8_epi32(_mm_loadu_si128((__m128i *)(IQ + i)));
+        _mm512_storeu_ps((float *)(cpx + i),
+            _mm512_mul_ps(_mm512_cvtepi32_ps(zdat), zs));
+    }
+    cvt_IQ_c(IQ + i, N - i, s, cpx + i);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+static int avail_avx2(void)
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+}
+
+static int avail_avx512(void)
+{
+    return avail_avx2() && __builtin_cpu_supports("avx512f") &&
+        __builtin_cpu_supports("avx512bw");
+}
+
+static int avail_vnni(void)
+{
+    return avail_avx512() && __builtin_cpu_supports("avx512vnni");
+}
+#endif // X86_SIMD
+
+#if defined(NEON)
+// NEON kernels ----------------------------------------------------------------
+#define sum_s16(ymm, sum) { \
+    int16_t s[8]; \
+    vst1q_s16(s, ymm); \
+    ymm = vdupq_n_s16(0); \
+    sum += s[0] + s[1] + s[2] + s[3] + s[4] + s[5] + s[6] + s[7]; \
+}
+
+static void dot_IQ_code_neon(const sdr_cpx16_t *IQ, const sdr_cpx16_t *code,
+    int N, float s, sdr_cpx_t *c)
+{
+    int16x8_t ysumI = vdupq_n_s16(0);
+    int16x8_t ysumQ = vdupq_n_s16(0);
+    int32_t sumI = 0, sumQ = 0;
+    int i = 0;
+    
+    for ( ; i < N - 7; i += 8) {
+        int8x8x2_t ydata = vld2_s8((int8_t *)(IQ + i));
+        int8x8x2_t ycode = vld2_s8((int8_t *)(code + i));
+        ysumI = vmlal_s8(ysumI, ydata.val[0], ycode.val[0]);
+        ysumQ = vmlal_s8(ysumQ, ydata.val[1], ycode.val[1]);
+        if (i % (8 * 256) == 0) {
+            sum_s16(ysumI, sumI)
+            sum_s16(ysumQ, sumQ)
+        }
+    }
+    sum_s16(ysumI, sumI)
+    sum_s16(ysumQ, sumQ)
+    for ( ; i < N; i++) {
+        sumI += IQ[i].I * code[i].I;
+        sumQ += IQ[i].Q * code[i].Q;
+    }
+    (*c)[0] = sumI * s * SDR_CSCALE;
+    (*c)[1] = sumQ * s * SDR_CSCALE;
+}
+
+static int avail_neon(void)
+{
+    return 1;
+}
+
+#if defined(SVE2)
+// SVE2 kernels ----------------------------------------------------------------
+static void cpx_mul_sve2(const sdr_cpx_t *a, const sdr_cpx_t *b, int N,
+    float s, sdr_cpx_t *c)
+{
+    for (int i = 0; i < N; i += (int)svcntw()) {
+        svbool_t pg = svwhilelt_b32_s32(i, N);
+        svfloat32x2_t va = svld2_f32(pg, (const float *)(a + i));
+        svfloat32x2_t vb = svld2_f32(pg, (const float *)(b + i));
+        svfloat32_t aI = svget2_f32(va, 0), aQ = svget2_f32(va, 1);
+        svfloat32_t bI = svget2_f32(vb, 0), bQ = svget2_f32(vb, 1);
+        svfloat32_t cI = svmls_f32_x(pg, svmul_f32_x(pg, aI, bI), aQ, bQ);
+        svfloat32_t cQ = svmla_f32_x(pg, svmul_f32_x(pg, aI, bQ), aQ, bI);
+        svst2_f32(pg, (float *)(c + i), svcreate2_f32(svmul_n_f32_x(pg, cI, s),
+            svmul_n_f32_x(pg, cQ, s)));
+    }
+}
+
+static uint32_t mix_carr_sve2(const uint8_t *data, int N, uint32_t p,
+    uint32_t s, sdr_cpx16_t *IQ)
+{
+    svuint32_t vi = svindex_u32(0, 1);
+    
+    for (int i = 0; i < N; i += (int)svcntw()) {
+        svbool_t pg = svwhilelt_b32_s32(i, N);
+        svuint32_t vp = svmla_n_u32_x(pg, svdup_n_u32(p + s * i), vi, s);
+        svuint32_t vdat = svld1ub_u32(pg, data + i);
+        svuint32_t vidx = svadd_u32_x(pg, svlsl_n_u32_x(pg, vdat, 8),
+            svlsr_n_u32_x(pg, vp, 24));
+        svst1h_u32(pg, (uint16_t *)(IQ + i),
+            svld1uh_gather_u32index_u32(pg, (const uint16_t *)mix_tbl, vidx));
+    }
+    return p + s * N;
+}
+
+static void dot_IQ_code_sve2(const sdr_cpx16_t *IQ, const sdr_cpx16_t *code,
+    int N, float s, sdr_cpx_t *c)
+{
+    const int8_t *data = (const int8_t *)IQ, *code8 = (const int8_t *)code;
+    svint8_t vmskI = svreinterpret_s8_s16(svdup_n_s16(0x00FF));
+    svint8_t vmskQ = svreinterpret_s8_s16(svdup_n_s16((int16_t)0xFF00));
+    svint32_t vsumI = svdup_n_s32(0), vsumQ = svdup_n_s32(0);
+    
+    for (int i = 0; i < N * 2; i += (int)svcntb()) {
+        svbool_t pg = svwhilelt_b8_s32(i, N * 2);
+        svint8_t vdata = svld1_s8(pg, data + i);
+        svint8_t vcode = svld1_s8(pg, code8 + i);
+        vsumI = svdot_s32(vsumI, vdata, svand_s8_x(pg, vcode, vmskI));
+        vsumQ = svdot_s32(vsumQ, vdata, svand_s8_x(pg, vcode, vmskQ));
+    }
+    (*c)[0] = svaddv_s32(svptrue_b32(), vsumI) * s * SDR_CSCALE;
+    (*c)[1] = svaddv_s32(svptrue_b32(), vsumQ) * s * SDR_CSCALE;
+}
+
+static void cvt_IQ_sve2(const sdr_cpx16_t *IQ, int N, float s, sdr_cpx_t *cpx)
+{
+    const int8_t *data = (const int8_t *)IQ;
+    float *out = (float *)cpx;
+    
+    for (int i = 0; i < N * 2; i += (int)svcntw()) {
+        svbool_t pg = svwhilelt_b32_s32(i, N * 2);
+        svfloat32_t v = svcvt_f32_s32_x(pg, svld1sb_s32(pg, data + i));
+        svst1_f32(pg, out + i, svmul_n_f32_x(pg, v, s));
+    }
+}
+
+static int avail_sve2(void)
+{
+#if defined(__linux__)
+    return (getauxval(AT_HWCAP2) & HWCAP2_SVE2) != 0;
+#else
+    return 0;
+#endif
+}
+#endif // SVE2
+#endif // NEON
+
+// SIMD kernel table (in order of preference) ----------------------------------
+static const simd_func_t simd_funcs[] = {
+#if defined(X86_SIMD)
+    {"avx512vnni", avail_vnni, cpx_mul_avx512, mix_carr_avx512,
+        mix_nco_avx512, dot_IQ_code_vnni, cvt_IQ_avx512, unpack_avx2,
+        pack_raw_avx2, dot_IQ_code_lags_avx2, fir_dec_avx2},
+    {"avx512", avail_avx512, cpx_mul_avx512, mix_carr_avx512,
+        mix_nco_avx512, dot_IQ_code_avx512, cvt_IQ_avx512, unpack_avx2,
+        pack_raw_avx2, dot_IQ_code_lags_avx2, fir_dec_avx2},
+    {"avx2", avail_avx2, cpx_mul_avx2, mix_carr_avx2, mix_nco_avx2,
+        dot_IQ_code_avx2, cvt_IQ_avx2, unpack_avx2, pack_raw_avx2,
+        dot_IQ_code_lags_avx2, fir_dec_avx2},
+#endif
+#if defined(NEON) && defined(SVE2)
+    {"sve2", avail_sve2, cpx_mul_sve2, mix_carr_sve2, mix_nco_c,
+        dot_IQ_code_sve2, cvt_IQ_sve2, unpack_c, pack_raw_c, NULL, fir_dec_c},
+#endif
+#if defined(NEON)
+    {"neon", avail_neon, cpx_mul_c, mix_carr_c, mix_nco_c, dot_IQ_code_neon,
+        cvt_IQ_c, unpack_c, pack_raw_c, NULL, fir_dec_c},
+#endif
+    {"none", NULL, cpx_mul_c, mix_carr_c, mix_nco_c, dot_IQ_code_c, cvt_IQ_c,
+        unpack_c, pack_raw_c, NULL, fir_dec_c}
+};
+static const simd_func_t *simd = simd_funcs + sizeof(simd_funcs) /
+    sizeof(simd_func_t) - 1; // selected SIMD kernels
+
+// enable escape sequence for Windows console ----------------------------------
+static void enable_console_esc(void)
+{
+#ifdef WIN32
+    HANDLE h = (HANDLE)_get_osfhandle(1); // stdout
+    DWORD mode = 0;
+    
+    if (!GetConsoleMode(h, &mode) ||
+        !SetConsoleMode(h, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING)) {
+        //fprintf(stderr, "SetConsoleMode() error (%ld)\n", GetLastError());
+    }
+#endif
+}
+
+// initialize GNSS SDR functions -----------------------------------------------
+void sdr_func_init(const char *file)
+{
+    // initilize log stream
+    strinitcom();
+    
+    // import FFTW wisdom 
+    if (*file && !(fftw_wisdom = fftwf_import_wisdom_from_filename(file))) {
+        fprintf(stderr, "FFTW wisdom import error %s\n", file);
+    }
+    // generate carrier-mixed-data LUT
+    for (int i = 0; i < NTBL; i++) {
+        int8_t carr_I = (int8_t)ROUND(cos(-2.0 * PI * i / NTBL) / SDR_CSCALE);
+        int8_t carr_Q = (int8_t)ROUND(sin(-2.0 * PI * i / NTBL) / SDR_CSCALE);
+        for (int j = 0; j < 256; j++) {
+            int8_t I = SDR_CPX8_I(j), Q = SDR_CPX8_Q(j);
+            mix_tbl[(j << 8) + i].I = I * carr_I - Q * carr_Q;
+            mix_tbl[(j << 8) + i].Q = I * carr_Q + Q * carr_I;
+        }
+    }
+    // select SIMD kernels
+    const char *env = getenv("POCKET_SDR_SIMD");
+    sdr_set_simd("auto");
+    if (env && *env && !sdr_set_simd(env)) {
+        fprintf(stderr, "SIMD kernels not supported %s\n", env);
+    }
+    // select carrier mixing
+    if ((env = getenv("POCKET_SDR_MIX")) && *env && !sdr_set_mix(env)) {
+        fprintf(stderr, "carrier mixing not supported %s\n", env);
+    }
+    // enable escape sequence for Windows console
+    enable_console_esc();
+}
+
+//------------------------------------------------------------------------------
+//  Select SIMD kernels. By default, sdr_func_init() selects the best kernels
+//  supported by the CPU. The selection can be overridden by the environment
+//  variable POCKET_SDR_SIMD for benchmark. It should be called before starting
+//  receiver or other threads.
+//
+//  args:
+//      name     (I)  SIMD kernels ("auto", "avx512vnni", "avx512", "avx2",
+//                    "sve2", "neon" or "none")
+//
+//  return:
+//      Status (1: OK, 0: not supported by the build or the CPU)
+//
+int sdr_set_simd(const char *name)
+{
+    int n = (int)(sizeof(simd_funcs) / sizeof(simd_func_t));
+    
+    for (int i = 0; i < n; i++) {
+        if (!strcmp(name, "auto") || !strcmp(name, simd_funcs[i].name)) {
+            if (simd_funcs[i].avail && !simd_funcs[i].avail()) continue;
+            simd = simd_funcs + i;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+//  Get selected SIMD kernels.
+//
+//  args:
+//      None
+//
+//  return:
+//      SIMD kernels name (see sdr_set_simd())
+//
+const char *sdr_get_simd(void)
+{
+    return simd->name;
+}
+
+//------------------------------------------------------------------------------
+//  Select carrier mixing. "lut" mixes carrier by the carrier-mixed-data LUT
+//  with NTBL carrier phases. "nco" generates carrier by the phase-rotator NCO
+//  in the SIMD lanes and rounds the mixed data to 8-bit without the carrier
+//  phase quantization. By default, "lut" is selected. The selection can be
+//  overridden by the environment variable POCKET_SDR_MIX to compare precision
+//  and throughput. It should be called before starting receiver or other
+//  threads.
+//
+//  args:
+//      name     (I)  Carrier mixing ("lut" or "nco")
+//
+//  return:
+//      Status (1: OK, 0: not supported)
+//
+int sdr_set_mix(const char *name)
+{
+    if (!strcmp(name, "lut")) mix_nco = 0;
+    else if (!strcmp(name, "nco")) mix_nco = 1;
+    else return 0;
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//  Get selected carrier mixing.
+//
+//  args:
+//      None
+//
+//  return:
+//      Carrier mixing name (see sdr_set_mix())
+//
+const char *sdr_get_mix(void)
+{
+    return mix_nco ? "nco" : "lut";
+}
+
+//------------------------------------------------------------------------------
+//  Select GPU backend for the parallel code search (sdr_search_code(),
+//  sdr_search_code_pacc() and sdr_search_code_multi()). The GPU backend is
+//  available in the library built with the option -DCUDA (see sdr_gpu.cu).
+//  The code search falls back to the CPU path if the GPU is used by another
+//  thread or on GPU errors.
+//
+//  args:
+//      dev      (I)  CUDA device number (-1: CPU only)
+//
+//  return:
+//      Status (1: OK, 0: GPU backend not available)
+//
+int sdr_set_acq_gpu(int dev)
+{
+    pthread_mutex_lock(&gpu_mtx);
+    acq_gpu = 0;
+#ifdef CUDA
+    sdr_gpu_close();
+    acq_gpu = dev >= 0 && sdr_gpu_open(dev);
+#endif
+    pthread_mutex_unlock(&gpu_mtx);
+    return dev < 0 || acq_gpu;
+}
+
+//------------------------------------------------------------------------------
+//  Allocate memory for complex array. If no memory allocated, it exits the AP
+//  immediately with an error message.
+//  
+//  args:
+//      N        (I)  Size of complex array
+//
+//  return:
+//      Complex array allocated.
+//
+sdr_cpx_t *sdr_cpx_malloc(int N)
+{
+    sdr_cpx_t *cpx;
+    
+    if (!(cpx = (sdr_cpx_t *)fftwf_malloc(sizeof(sdr_cpx_t) * N))) {
+        fprintf(stderr, "sdr_cpx_t memory allocation error N=%d\n", N);
+        exit(-1);
+    }
+    return cpx;
+}
+
+//------------------------------------------------------------------------------
+//  Free memory allocated by sdr_cpx_malloc().
+//  
+//  args:
+//      cpx      (I)  Complex array
+//
+//  return:
+//      None
+//
+void sdr_cpx_free(sdr_cpx_t *cpx)
+{
+    fftwf_free(cpx);
+}
+
+// free scratch buffer lists ---------------------------------------------------
+static void scratch_free_lists(scratch_t **lists)
+{
+    for (int i = 0; i < MAX_SCRATCH; i++) {
+        while (lists[i]) {
+            scratch_t *next = lists[i]->next;
+            fftwf_free(lists[i]);
+            lists[i] = next;
+        }
+    }
+}
+
+// free scratch buffers at thread exit -----------------------------------------
+static void scratch_exit(void *arg)
+{
+    scratch_free_lists((scratch_t **)arg);
+    sdr_free(arg);
+}
+
+static void scratch_key_init(void)
+{
+    pthread_key_create(&scratch_key, scratch_exit);
+}
+
+// scratch buffer lists of current thread --------------------------------------
+static scratch_t **scratch_lists(void)
+{
+    pthread_once(&scratch_once, scratch_key_init);
+    scratch_t **lists = (scratch_t **)pthread_getspecific(scratch_key);
+    if (!lists) {
+        lists = (scratch_t **)sdr_malloc(sizeof(scratch_t *) * MAX_SCRATCH);
+        pthread_setspecific(scratch_key, lists);
+    }
+    return lists;
+}
+
+//------------------------------------------------------------------------------
+//  Allocate scratch buffer for temporaries. Scratch buffers are kept in
+//  thread-local free lists by power-of-two size classes and reused by the
+//  following calls in the same thread, so the steady-state processing does no
+//  heap allocation. The buffer is aligned as sdr_cpx_malloc() and not
+//  initialized. It is released at exit of the thread or by
+//  sdr_scratch_release().
+//
+//  args:
+//      size     (I)  Size of scratch buffer (bytes)
+//
+//  return:
+//      Scratch buffer
+//
+void *sdr_scratch_alloc(size_t size)
+{
+    scratch_t **lists = scratch_lists(), *b;
+    int cls = 6;
+    
+    while (((size_t)1 << cls) < size && cls < MAX_SCRATCH - 1) cls++;
+    
+    if ((b = lists[cls]) != NULL) {
+        lists[cls] = b->next;
+    }
+    else if (!(b = (scratch_t *)fftwf_malloc(SCRATCH_HDR + ((size_t)1 << cls)))) {
+        fprintf(stderr, "scratch memory allocation error size=%d\n", (int)size);
+        exit(-1);
+    }
+    b->cls = cls;
+    b->next = NULL;
+    return (uint8_t *)b + SCRATCH_HDR;
+}
+
+//------------------------------------------------------------------------------
+//  Free scratch buffer allocated by sdr_scratch_alloc(). The buffer is returned
+//  to the free list of current thread.
+//
+//  args:
+//      p        (I)  Scratch buffer (NULL: no operation)
+//
+//  return:
+//      None
+//
+void sdr_scratch_free(void *p)
+{
+    if (!p) return;
+    scratch_t **lists = scratch_lists();
+    scratch_t *b = (scratch_t *)((uint8_t *)p - SCRATCH_HDR);
+    b->next = lists[b->cls];
+    lists[b->cls] = b;
+}
+
+//------------------------------------------------------------------------------
+//  Release all free scratch buffers of current thread.
+//
+//  args:
+//      None
+//
+//  return:
+//      None
+//
+void sdr_scratch_release(void)
+{
+    scratch_free_lists(scratch_lists());
+}
+
+//------------------------------------------------------------------------------
+//  Absolute value of a complex.
+//  
+//  args:
+//      cpx      (I)  Complex value
+//
+//  return:
+//      | cpx |
+//
+float sdr_cpx_abs(sdr_cpx_t cpx)
+{
+    return sqrtf(SQR(cpx[0]) + SQR(cpx[1]));
+}
+
+//------------------------------------------------------------------------------
+//  Multiplication of two complex arrays.
+//  
+//  args:
+//      a, b     (I)  Complex arrays
+//      N        (I)  Size of complex arrays
+//      s        (I)  Scale
+//      c        (O)  Multiplication of a and b (c[i] = a[i] * b[i] * s)
+//
+//  return:
+//      None
+//
+void sdr_cpx_mul(const sdr_cpx_t *a, const sdr_cpx_t *b, int N, float s,
+    sdr_cpx_t *c)
+{
+    simd->cpx_mul(a, b, N, s, c);
+}
+
+//------------------------------------------------------------------------------
+//  Generate a new IF data buffer.
+//
+//  args:
+//      N        (I)  Size of IF data buffer
+//      IQ       (I)  Sampling type (1: I-sampling, 2: IQ-sampling)
+//
+//  return:
+//      IF data buffer
+//
+sdr_buff_t *sdr_buff_new(int N, int IQ)
+{
+    return sdr_buff_new_mem(N, IQ, NULL, 0, -1);
+}
+
+//------------------------------------------------------------------------------
+//  Generate a new packed IF data buffer. The packed buffer stores two 4-bit
+//  sample codes in a byte (the lower nibble first), for example 2-bit I and
+//  2-bit Q of the MAX2771 raw data, to reduce the memory and the memory
+//  bandwidth of the correlators. The code is decoded to IF data by the decode
+//  table in mixing carrier.
+//
+//  args:
+//      N        (I)  Size of IF data buffer (samples)
+//      IQ       (I)  Sampling type (1: I-sampling, 2: IQ-sampling)
+//      dec      (I)  Decode table of 4-bit sample code to IF data (16)
+//
+//  return:
+//      IF data buffer
+//
+sdr_buff_t *sdr_buff_new_pack(int N, int IQ, const sdr_cpx8_t *dec)
+{
+    return sdr_buff_new_mem(N, IQ, dec, 0, -1);
+}
+
+//------------------------------------------------------------------------------
+//  Generate a new IF data buffer with memory options. Large IF data buffers
+//  can be backed by huge pages to reduce TLB misses and bound to the NUMA node
+//  of the threads accessing the buffer (see sdr_malloc_huge()).
+//
+//  args:
+//      N        (I)  Size of IF data buffer (samples)
+//      IQ       (I)  Sampling type (1: I-sampling, 2: IQ-sampling)
+//      dec      (I)  Decode table of 4-bit sample code to IF data (16)
+//                    (NULL: not packed)
+//      huge     (I)  Huge pages (0: off, 1: THP, 2: 2 MB, 3: 1 GB)
+//      node     (I)  NUMA node to bind buffer (-1: no binding)
+//
+//  return:
+//      IF data buffer
+//
+sdr_buff_t *sdr_buff_new_mem(int N, int IQ, const sdr_cpx8_t *dec, int huge,
+    int node)
+{
+    sdr_buff_t *buff = (sdr_buff_t *)sdr_malloc(sizeof(sdr_buff_t));
+    size_t size = dec ? (size_t)(N + 1) / 2 : sizeof(sdr_cpx8_t) * N;
+    buff->data = (sdr_cpx8_t *)sdr_malloc_huge(size, huge, node, &buff->msize);
+    buff->N = N;
+    buff->IQ = IQ;
+    if (dec) {
+        buff->pack = 1;
+        memcpy(buff->dec, dec, sizeof(buff->dec));
+    }
+    return buff;
+}
 
-// enable escape sequence for Windows console ----------------------------------
-static void enable_console_esc(void)
+// unpack IF data buffer (w/o IF buffer boundary) ------------------------------
+static void unpack_buff(const sdr_buff_t *buff, int ix, int N,
+    sdr_cpx8_t *data)
 {
-#ifdef WIN32
-    HANDLE h = (HANDLE)_get_osfhandle(1); // stdout
-    DWORD mode = 0;
+    const uint8_t *pk = buff->data + ix / 2;
     
-    if (!GetConsoleMode(h, &mode) ||
-        !SetConsoleMode(h, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING)) {
-        //fprintf(stderr, "SetConsoleMode() error (%ld)\n", GetLastError());
+    if (N > 0 && (ix & 1)) {
+        *data++ = buff->dec[*pk++ >> 4];
+        N--;
     }
-#endif
+    simd->unpack(pk, N, buff->dec, data);
 }
 
-// initialize GNSS SDR functions -----------------------------------------------
-void sdr_func_init(const char *file)
+//------------------------------------------------------------------------------
+//  Get IF data in IF data buffer. Packed IF data are unpacked.
+//
+//  args:
+//      buff     (I)  IF data buffer
+//      ix       (I)  Index of IF data
+//      N        (I)  Number of IF data
+//      data     (O)  IF data
+//
+//  return:
+//      none
+//
+void sdr_buff_get(const sdr_buff_t *buff, int ix, int N, sdr_cpx8_t *data)
 {
-    // initilize log stream
-    strinitcom();
-    
-    // import FFTW wisdom 
-    if (*file && !fftwf_import_wisdom_from_filename(file)) {
-        fprintf(stderr, "FFTW wisdom import error %s\n", file);
-    }
-    // generate carrier-mixed-data LUT
-    for (int i = 0; i < NTBL; i++) {
-        int8_t carr_I = (int8_t)ROUND(cos(-2.0 * PI * i / NTBL) / SDR_CSCALE);
-        int8_t carr_Q = (int8_t)ROUND(sin(-2.0 * PI * i / NTBL) / SDR_CSCALE);
-        for (int j = 0; j < 256; j++) {
-            int8_t I = SDR_CPX8_I(j), Q = SDR_CPX8_Q(j);
-            mix_tbl[(j << 8) + i].I = I * carr_I - Q * carr_Q;
-            mix_tbl[(j << 8) + i].Q = I * carr_Q + Q * carr_I;
+    for (int i = 0; i < N; ) {
+        int j = (ix + i) % buff->N, n = MIN(N - i, buff->N - j);
+        if (buff->pack) {
+            unpack_buff(buff, j, n, data + i);
         }
+        else {
+            memcpy(data + i, buff->data + j, n);
+        }
+        i += n;
     }
-    // enable escape sequence for Windows console
-    enable_console_esc();
 }
 
 //------------------------------------------------------------------------------
-//  Allocate memory for complex array. If no memory allocated, it exits the AP
-//  immediately with an error message.
-//  
+//  Extract the sample codes of a RF channel from raw IF data to packed 4 bits
+//  sample codes (SDR_FMT_PACK) by the SIMD kernels. The first sample is stored
+//  to the lower 4 bits of a byte.
+//
 //  args:
-//      N        (I)  Size of complex array
+//      raw      (I)  Raw IF data
+//      N        (I)  Number of IF data samples
+//      fmt      (I)  Raw IF data format (SDR_FMT_RAW8, SDR_FMT_RAW16,
+//                    SDR_FMT_RAW16I)
+//      ch       (I)  RF channel in raw IF data (0, 1, ...)
+//      pk       (O)  Packed sample codes ((N + 1) / 2 bytes)
 //
 //  return:
-//      Complex array allocated.
+//      none
 //
-sdr_cpx_t *sdr_cpx_malloc(int N)
+void sdr_pack_raw(const uint8_t *raw, int N, int fmt, int ch, uint8_t *pk)
 {
-    sdr_cpx_t *cpx;
+    simd->pack_raw(raw, N, fmt, ch, pk);
+}
+
+//------------------------------------------------------------------------------
+//  Write raw IF data of a RF channel to IF data buffer. The sample codes of the
+//  RF channel are extracted from the raw IF data by the SIMD kernels and stored
+//  to a packed buffer or decoded to a unpacked buffer by the decode table.
+//
+//  args:
+//      buff     (I)  IF data buffer (dec shall be set for unpacked buffer)
+//      ix       (I)  Index of IF data buffer (even for packed buffer)
+//      raw      (I)  Raw IF data
+//      N        (I)  Number of IF data samples (w/o IF buffer boundary)
+//      fmt      (I)  Raw IF data format (SDR_FMT_RAW8, SDR_FMT_RAW16,
+//                    SDR_FMT_RAW16I, SDR_FMT_PACK (N shall be even))
+//      ch       (I)  RF channel in raw IF data (0, 1, ...)
+//
+//  return:
+//      none
+//
+void sdr_buff_write_raw(sdr_buff_t *buff, int ix, const uint8_t *raw, int N,
+    int fmt, int ch)
+{
+    int ns = fmt == SDR_FMT_RAW8 ? 1 : 2;
     
-    if (!(cpx = (sdr_cpx_t *)fftwf_malloc(sizeof(sdr_cpx_t) * N))) {
-        fprintf(stderr, "sdr_cpx_t memory allocation error N=%d\n", N);
-        exit(-1);
+    if (fmt == SDR_FMT_PACK) { // packed sample codes
+        if (buff->pack) {
+            memcpy(buff->data + ix / 2, raw, N / 2);
+        }
+        else {
+            simd->unpack(raw, N, buff->dec, buff->data + ix);
+        }
+        return;
+    }
+    if (buff->pack) {
+        simd->pack_raw(raw, N, fmt, ch, buff->data + ix / 2);
+        return;
+    }
+    for (int i = 0; i < N; i += CORR_BLK) {
+        uint8_t pk[CORR_BLK/2];
+        int n = MIN(N - i, CORR_BLK);
+        simd->pack_raw(raw + i * ns, n, fmt, ch, pk);
+        simd->unpack(pk, n, buff->dec, buff->data + ix + i);
     }
-    return cpx;
 }
 
 //------------------------------------------------------------------------------
-//  Free memory allocated by sdr_cpx_malloc().
-//  
+//  Write int8 IF data to IF data buffer (not packed). The IF data are I-samples
+//  (int8) or IQ-samples (int8 x 2, Q sign inverted) as the IF data file.
+//
 //  args:
-//      cpx      (I)  Complex array
+//      buff     (I)  IF data buffer
+//      ix       (I)  Index of IF data buffer (wrapped by buffer size)
+//      raw      (I)  IF data (int8 or int8 x 2)
+//      N        (I)  Number of IF data samples
+//      IQ       (I)  Sampling type (1: I-sampling, 2: IQ-sampling)
 //
 //  return:
-//      None
+//      none
 //
-void sdr_cpx_free(sdr_cpx_t *cpx)
+void sdr_buff_write_int8(sdr_buff_t *buff, int ix, const int8_t *raw, int N,
+    int IQ)
 {
-    fftwf_free(cpx);
+    for (int i = 0, n; i < N; i += n) {
+        int j = (ix + i) % buff->N;
+        sdr_cpx8_t *data = buff->data + j;
+        n = MIN(N - i, buff->N - j);
+        if (IQ == 1) {
+            for (int k = 0; k < n; k++) {
+                data[k] = SDR_CPX8(raw[i+k], 0);
+            }
+        }
+        else {
+            for (int k = 0; k < n; k++) {
+                data[k] = SDR_CPX8(raw[(i+k)*2], -raw[(i+k)*2+1]);
+            }
+        }
+    }
 }
 
 //------------------------------------------------------------------------------
-//  Absolute value of a complex.
-//  
+//  Free IF data buffer. The shared data spectrums of the buffer (see
+//  sdr_corr_fft_share()) are invalidated, so a new buffer at the same address
+//  does not pick them up.
+//
 //  args:
-//      cpx      (I)  Complex value
+//      buff     (I)  IF data buffer
 //
 //  return:
-//      | cpx |
+//      none
 //
-float sdr_cpx_abs(sdr_cpx_t cpx)
+void sdr_buff_free(sdr_buff_t *buff)
 {
-    return sqrtf(SQR(cpx[0]) + SQR(cpx[1]));
+    if (!buff) return;
+    pthread_mutex_lock(&spec_mtx);
+    for (int i = 0; i < SPEC_NCACHE; i++) {
+        if (spec_cache[i].buff == buff) spec_cache[i].buff = NULL;
+    }
+    pthread_mutex_unlock(&spec_mtx);
+    sdr_free_huge(buff->data, buff->msize);
+    sdr_free(buff);
 }
 
 //------------------------------------------------------------------------------
-//  Multiplication of two complex arrays.
-//  
+//  Generate a new digital down converter (DDC). The DDC mixes the IF data with
+//  the carrier of the center frequency and decimates them by a low-pass FIR
+//  filter (Hamming-windowed sinc, cutoff fs / D / 2). Only the decimated
+//  outputs are computed as a polyphase filter. The filter is centered to the
+//  output sample, so the DDC output has no group delay to the input.
+//
 //  args:
-//      a, b     (I)  Complex arrays
-//      N        (I)  Size of complex arrays
-//      s        (I)  Scale
-//      c        (O)  Multiplication of a and b (c[i] = a[i] * b[i] * s)
+//      D        (I)  Decimation factor (>= 2)
+//      fs       (I)  Sampling rate of input IF data (Hz)
+//      fc       (I)  Center frequency of DDC in input IF data (Hz)
 //
 //  return:
-//      None
+//      DDC (NULL: error)
 //
-void sdr_cpx_mul(const sdr_cpx_t *a, const sdr_cpx_t *b, int N, float s,
-    sdr_cpx_t *c)
+sdr_ddc_t *sdr_ddc_new(int D, double fs, double fc)
 {
-    int i = 0;
-#if defined(AVX2)
-    __m256 yr = _mm256_set_ps(-1, 1, -1, 1, -1, 1, -1, 1);
-    __m256 ys = _mm256_set1_ps(s);
+    if (D < 2) return NULL;
+    sdr_ddc_t *ddc = (sdr_ddc_t *)sdr_malloc(sizeof(sdr_ddc_t));
+    ddc->D = D;
+    ddc->K = DDC_NTAP * D;
+    ddc->L = (2 * ddc->K + 1 + 7) / 8 * 8;
+    ddc->fs = fs;
+    ddc->fc = fc;
+    ddc->h = (int16_t *)sdr_malloc(sizeof(int16_t) * ddc->L * 4);
+    double *h = (double *)sdr_malloc(sizeof(double) * ddc->L), sum = 0.0;
     
-    for ( ; i < N - 3; i += 4) {
-         __m256 ya = _mm256_loadu_ps((float *)(a + i));
-         __m256 yb = _mm256_loadu_ps((float *)(b + i));
-         __m256 yc = _mm256_mul_ps(ya, _mm256_mul_ps(yb, yr));
-         __m256 yd = _mm256_mul_ps(ya, _mm256_permute_ps(yb, 0xB1));
-         __m256 ye = _mm256_permute_ps(_mm256_hadd_ps(yc, yd), 0xD8);
-         _mm256_storeu_ps((float *)(c + i), _mm256_mul_ps(ye, ys));
+    for (int i = 0; i <= 2 * ddc->K; i++) {
+        double t = (double)(i - ddc->K) / D;
+        double w = 0.54 + 0.46 * cos(PI * (i - ddc->K) / (ddc->K + 1));
+        h[i] = (t == 0.0 ? 1.0 : sin(PI * t) / (PI * t)) * w;
+        sum += h[i];
     }
-#endif
-    for ( ; i < N; i++) {
-        c[i][0] = (a[i][0] * b[i][0] - a[i][1] * b[i][1]) * s;
-        c[i][1] = (a[i][0] * b[i][1] + a[i][1] * b[i][0]) * s;
+    for (int i = 0; i <= 2 * ddc->K; i++) {
+        int16_t hi = (int16_t)floor(h[i] / sum * DDC_HSCALE + 0.5);
+        ddc->h[i*2] = ddc->h[ddc->L*2+i*2+1] = hi; // taps for I and Q
     }
+    sdr_free(h);
+    return ddc;
 }
 
 //------------------------------------------------------------------------------
-//  Generate a new IF data buffer.
+//  Process IF data by DDC. The input IF data samples buff[ix-K],...,
+//  buff[ix+N-K+L-1] are used for the filter (K: half length of filter). The
+//  output IF data are quantized to 4 bits (+/-3) with the AGC.
 //
 //  args:
-//      N        (I)  Size of IF data buffer
-//      IQ       (I)  Sampling type (1: I-sampling, 2: IQ-sampling)
+//      ddc      (I)  DDC
+//      in       (I)  Input IF data buffer
+//      ix       (I)  Index of input IF data buffer
+//      N        (I)  Number of input IF data samples (N % D == 0)
+//      out      (IO) Output IF data buffer (not packed, IQ-sampling)
+//      ox       (I)  Index of output IF data buffer
 //
 //  return:
-//      IF data buffer
+//      none
 //
-sdr_buff_t *sdr_buff_new(int N, int IQ)
+void sdr_ddc_proc(sdr_ddc_t *ddc, const sdr_buff_t *in, int ix, int N,
+    sdr_buff_t *out, int ox)
 {
-    sdr_buff_t *buff = (sdr_buff_t *)sdr_malloc(sizeof(sdr_buff_t));
-    buff->data = (sdr_cpx8_t *)sdr_malloc(sizeof(sdr_cpx8_t *) * N);
-    buff->N = N;
-    buff->IQ = IQ;
-    return buff;
+    int M = N / ddc->D, n = (M - 1) * ddc->D + ddc->L;
+    int i0 = ((ix - ddc->K) % in->N + in->N) % in->N;
+    double step = ddc->fc / ddc->fs;
+    sdr_cpx16_t *IQ = (sdr_cpx16_t *)sdr_scratch_alloc(sizeof(sdr_cpx16_t) * n);
+    int32_t *y = (int32_t *)sdr_scratch_alloc(sizeof(int32_t) * M * 2);
+    
+    for (int i = 0, m; i < n; i += m) { // mix carrier
+        int j = (i0 + i) % in->N;
+        m = MIN(n - i, in->N - j);
+        sdr_mix_carr(in, j, m, ddc->fs, ddc->fc, ddc->phi + step * (i - ddc->K),
+            IQ + i);
+    }
+    simd->fir_dec(IQ, M, ddc->D, ddc->h, ddc->L, y);
+    
+    double sum = 0.0;
+    for (int i = 0; i < M * 2; i++) {
+        sum += (double)y[i] * y[i];
+    }
+    if (sum > 0.0) { // AGC
+        float scale = DDC_RMS / (float)sqrt(sum / M);
+        ddc->scale = ddc->scale == 0.0f ? scale :
+            ddc->scale + (scale - ddc->scale) * DDC_AGC;
+    }
+    for (int i = 0; i < M; i++) {
+        int I = (int)floorf(y[i*2  ] * ddc->scale + 0.5f);
+        int Q = (int)floorf(y[i*2+1] * ddc->scale + 0.5f);
+        out->data[(ox + i) % out->N] = SDR_CPX8(MAX(-3, MIN(I, 3)),
+            MAX(-3, MIN(Q, 3)));
+    }
+    ddc->phi = fmod(ddc->phi + step * N, 1.0);
+    sdr_scratch_free(IQ);
+    sdr_scratch_free(y);
 }
 
 //------------------------------------------------------------------------------
-//  Free IF data buffer.
+//  Free DDC.
 //
 //  args:
-//      buff     (I)  IF data buffer
+//      ddc      (I)  DDC
 //
 //  return:
 //      none
 //
-void sdr_buff_free(sdr_buff_t *buff)
+void sdr_ddc_free(sdr_ddc_t *ddc)
 {
-    if (!buff) return;
-    sdr_free(buff->data);
-    sdr_free(buff);
+    if (!ddc) return;
+    sdr_free(ddc->h);
+    sdr_free(ddc);
 }
 
 //------------------------------------------------------------------------------
 //  Read digitalized IF (inter-frequency) data from file. Supported file format
 //  is signed byte (int8) for I-sampling (real-sampling) or interleaved singned
-//  byte for IQ-sampling (complex-sampling).
+//  byte for IQ-sampling (complex-sampling). The file can be a compressed IF
+//  data file of the formats (see sdr_ifz.c).
 //
 //  args:
 //      file     (I) Digitalized IF data file path
@@ -235,104 +1655,369 @@ void sdr_buff_free(sdr_buff_t *buff)
 sdr_buff_t *sdr_read_data(const char *file, double fs, int IQ, double T,
     double toff)
 {
-    size_t cnt = (T > 0.0) ? (size_t)(fs * T * IQ) : 0;
-    size_t off = (size_t)(fs * toff * IQ);
-    FILE *fp;
+    int64_t cnt = (T > 0.0) ? (int64_t)(fs * T * IQ) : 0;
+    int64_t off = (int64_t)(fs * toff * IQ);
+    sdr_iff_t *iff;
     
-    if (!(fp = fopen(file, "rb"))) {
+    if (!(iff = sdr_iff_open(file, SDR_IFZ_MAX_TH))) {
         fprintf(stderr, "data read error %s\n", file);
         return NULL;
     }
-    // get file size
-    fseek(fp, 0, SEEK_END);
-#if defined(WIN32) || defined(MACOS)
-    fpos_t pos = 0;
-    fgetpos(fp, &pos);
-    size_t size = (size_t)pos;
-#else
-    fpos_t pos;
-    fgetpos(fp, &pos);
-    size_t size = (size_t)(pos.__pos);
-#endif
-    rewind(fp);
-    
     if (cnt <= 0) {
-        cnt = size - off;
+        cnt = iff->size - off;
     }
-    if (size < off + cnt) {
-        fclose(fp);
+    if (cnt <= 0 || iff->size < off + cnt || cnt / IQ > INT32_MAX ||
+        !sdr_iff_seek(iff, off)) {
+        sdr_iff_close(iff);
         return NULL;
     }
-    int8_t *raw = (int8_t *)sdr_malloc(cnt);
-#if defined(WIN32) || defined(MACOS)
-    pos = (size_t)off;
-    fsetpos(fp, &pos);
-#else
-    pos.__pos = (__off_t)off;
-    fsetpos(fp, &pos);
-#endif
+    sdr_buff_t *buff = sdr_buff_new((int)(cnt / IQ), IQ);
+    
+    if (!sdr_iff_get(iff, IQ, off / IQ, buff->N, buff->data)) {
+        fprintf(stderr, "data read error %s\n", file);
+        sdr_buff_free(buff);
+        sdr_iff_close(iff);
+        return NULL;
+    }
+    sdr_iff_close(iff);
+    return buff;
+}
+
+// get FFTW plan ---------------------------------------------------------------
+static int get_fftw_plan(int N, fftwf_plan *plan);
+
+// parallel code search of multiple codes --------------------------------------
+static void search_code(const sdr_cpx_t *const *code_fft, int ncode, double T,
+    const sdr_buff_t *buff, int ix, int N, double fs, double fi,
+    const float *fds, int len_fds, float *const *P, sdr_pacc_t *const *acc);
+
+//------------------------------------------------------------------------------
+//  Generate a new compact correlation power accumulator. The accumulator keeps
+//  the sum of correlation powers of the code offsets in each Doppler bin as
+//  uint16 with a scale of the Doppler bin, instead of float arrays of the FFT
+//  size, to reduce the memory for the signal acquisition. The scale is updated
+//  and the powers are requantized when the sum exceeds the range.
+//
+//  args:
+//      N        (I)  Number of code offsets (N <= FFT size of code search)
+//      M        (I)  Number of Doppler bins
+//
+//  return:
+//      Compact correlation power accumulator
+//
+sdr_pacc_t *sdr_pacc_new(int N, int M)
+{
+    sdr_pacc_t *acc = (sdr_pacc_t *)sdr_malloc(sizeof(sdr_pacc_t));
+    acc->P = (uint16_t *)sdr_malloc(sizeof(uint16_t) * N * M);
+    acc->scale = (float *)sdr_malloc(sizeof(float) * M);
+    acc->P_max = (float *)sdr_malloc(sizeof(float) * M);
+    acc->N = N;
+    acc->M = M;
+    return acc;
+}
+
+//------------------------------------------------------------------------------
+//  Free compact correlation power accumulator.
+//
+//  args:
+//      acc      (I)  Compact correlation power accumulator
+//
+//  return:
+//      none
+//
+void sdr_pacc_free(sdr_pacc_t *acc)
+{
+    if (!acc) return;
+    sdr_free(acc->P);
+    sdr_free(acc->scale);
+    sdr_free(acc->P_max);
+    sdr_free(acc);
+}
+
+// add correlation powers to compact accumulator -------------------------------
+static void pacc_add(sdr_pacc_t *acc, int j, const float *P)
+{
+    uint16_t *Pj = acc->P + (size_t)j * acc->N;
+    float P_max = 0.0f;
+    
+    for (int i = 0; i < acc->N; i++) {
+        P_max = MAX(P_max, P[i]);
+    }
+    if (P_max <= 0.0f) return;
+    P_max += acc->P_max[j]; // upper bound of sum
+    
+    if (P_max > PACC_MAX * acc->scale[j]) { // rescale
+        float scale = P_max / PACC_RESCALE, r = acc->scale[j] / scale;
+        for (int i = 0; i < acc->N; i++) {
+            Pj[i] = (uint16_t)(Pj[i] * r + 0.5f);
+        }
+        acc->scale[j] = scale;
+    }
+    float s = 1.0f / acc->scale[j];
+    for (int i = 0; i < acc->N; i++) {
+        Pj[i] = (uint16_t)MIN(Pj[i] + P[i] * s + 0.5f, PACC_MAX);
+    }
+    acc->P_max[j] = P_max;
+}
+
+//------------------------------------------------------------------------------
+//  Parallel code search in digitized IF data. The IF data is transformed by
+//  FFT once for a set of Doppler frequencies with integer FFT bin offsets and
+//  the Doppler frequencies are searched by shifting the spectrum.
+//
+//  args:
+//      code_fft (I) Code DFT (with or w/o zero-padding) as complex array
+//      T        (I) Code cycle (period) (s)
+//      buff     (I) IF data buffer
+//      ix       (I) Index of sample data
+//      N        (I) length of sample data
+//      fs       (I) Sampling frequency (Hz)
+//      fi       (I) IF frequency (Hz)
+//      fds      (I) Doppler frequency bins as ndarray (Hz)
+//      len_fds  (I) length of Doppler frequency bins
+//      P        (IO) Correlation powers in the Doppler frequencies - Code offset
+//                   space as float 2D-array (N x len_fs, N = (int)(fs * T))
+//
+//  return:
+//      none
+//
+void sdr_search_code(const sdr_cpx_t *code_fft, double T,
+    const sdr_buff_t *buff, int ix, int N, double fs, double fi,
+    const float *fds, int len_fds, float *P)
+{
+    search_code(&code_fft, 1, T, buff, ix, N, fs, fi, fds, len_fds, &P, NULL);
+}
+
+//------------------------------------------------------------------------------
+//  Parallel code search in digitized IF data with compact correlation power
+//  accumulator (see sdr_pacc_new()).
+//
+//  args:
+//      code_fft, ..., len_fds (I) Same as sdr_search_code()
+//      acc      (IO) Compact correlation power accumulator (acc->M = len_fds)
+//
+//  return:
+//      none
+//
+void sdr_search_code_pacc(const sdr_cpx_t *code_fft, double T,
+    const sdr_buff_t *buff, int ix, int N, double fs, double fi,
+    const float *fds, int len_fds, sdr_pacc_t *acc)
+{
+    search_code(&code_fft, 1, T, buff, ix, N, fs, fi, fds, len_fds, NULL,
+        &acc);
+}
+
+//------------------------------------------------------------------------------
+//  Parallel code search of multiple codes in digitized IF data. The IF data
+//  spectrum is shared by all codes, so the FFT of IF data is done once per
+//  Doppler frequency set for all codes (e.g. all PRNs of a signal).
+//
+//  args:
+//      code_fft (I) Code DFTs of codes as complex arrays (code_fft[ncode])
+//      ncode    (I) Number of codes
+//      T, ..., len_fds (I) Same as sdr_search_code()
+//      P        (IO) Correlation powers of codes as float 2D-arrays
+//                   (P[ncode], see sdr_search_code())
+//
+//  return:
+//      none
+//
+void sdr_search_code_multi(const sdr_cpx_t *const *code_fft, int ncode,
+    double T, const sdr_buff_t *buff, int ix, int N, double fs, double fi,
+    const float *fds, int len_fds, float *const *P)
+{
+    search_code(code_fft, ncode, T, buff, ix, N, fs, fi, fds, len_fds, P,
+        NULL);
+}
+
+// new IF data buffer of complex IF data ---------------------------------------
+static sdr_buff_t *buff_new_cpx(const sdr_cpx_t *buff, int len_buff, int ix,
+    int N)
+{
+    sdr_buff_t *buff_cpx8 = sdr_buff_new(N, 2);
+    for (int i = 0, j = ix; i < N; i++, j = (j + 1) % len_buff) {
+        buff_cpx8->data[i] = SDR_CPX8((int8_t)buff[j][0], (int8_t)buff[j][1]);
+    }
+    return buff_cpx8;
+}
+
+//------------------------------------------------------------------------------
+//  Parallel code search in digitized IF data for complex input. The IF data are
+//  given as a complex array of sample values as sdr_corr_fft_cpx() (e.g.
+//  complex64 ndarray of NumPy), so the function can be called from Python
+//  without copying the IF data.
+//
+//  args:
+//      code_fft (I) Code DFT (with or w/o zero-padding) as complex array
+//      T        (I) Code cycle (period) (s)
+//      buff     (I) IF data as complex array
+//      len_buff (I) Length of IF data (wrapped as ring buffer)
+//      ix, ..., P (IO) Same as sdr_search_code()
+//
+//  return:
+//      none
+//
+void sdr_search_code_cpx(const sdr_cpx_t *code_fft, double T,
+    const sdr_cpx_t *buff, int len_buff, int ix, int N, double fs, double fi,
+    const float *fds, int len_fds, float *P)
+{
+    sdr_search_code_multi_cpx(&code_fft, 1, T, buff, len_buff, ix, N, fs, fi,
+        fds, len_fds, &P);
+}
+
+//------------------------------------------------------------------------------
+//  Parallel code search of multiple codes in digitized IF data for complex
+//  input (see sdr_search_code_cpx() and sdr_search_code_multi()).
+//
+void sdr_search_code_multi_cpx(const sdr_cpx_t *const *code_fft, int ncode,
+    double T, const sdr_cpx_t *buff, int len_buff, int ix, int N, double fs,
+    double fi, const float *fds, int len_fds, float *const *P)
+{
+    sdr_buff_t *buff_cpx8 = buff_new_cpx(buff, len_buff, ix, N);
+    search_code(code_fft, ncode, T, buff_cpx8, 0, N, fs, fi, fds, len_fds, P,
+        NULL);
+    sdr_buff_free(buff_cpx8);
+}
+
+// parallel code search of multiple codes by GPU backend -----------------------
+static int search_code_gpu(const sdr_cpx_t *const *code_fft, int ncode,
+    const sdr_buff_t *buff, int ix, int N, double fs, double fi,
+    const float *fds, int len_fds, float *const *P, sdr_pacc_t *const *acc)
+{
+    int c = 0;
+#ifdef CUDA
+    double df = fs / N; // FFT frequency bin spacing (Hz)
+    int nb = 0;
     
-    if (fread(raw, 1, cnt, fp) < cnt) {
-        fprintf(stderr, "data read error %s\n", file);
-        fclose(fp);
-        return NULL;
+    if (!acq_gpu || pthread_mutex_trylock(&gpu_mtx)) return 0; // GPU busy
+    if (!acq_gpu) {
+        pthread_mutex_unlock(&gpu_mtx);
+        return 0;
     }
-    sdr_buff_t *buff = sdr_buff_new(cnt / IQ, IQ);
+    sdr_cpx8_t *data = (sdr_cpx8_t *)sdr_scratch_alloc(N);
+    double *fc = (double *)sdr_scratch_alloc(sizeof(double) * len_fds);
+    int *idx = (int *)sdr_scratch_alloc(sizeof(int) * len_fds * 2);
+    float *Pc = (float *)sdr_scratch_alloc(sizeof(float) * len_fds * N);
     
-    if (IQ == 1) { // I-sampling
-        for (int i = 0; i < buff->N; i++) {
-            buff->data[i] = SDR_CPX8(raw[i], 0);
+    // base Doppler frequencies and FFT bin offsets of Doppler frequencies
+    for (int i = 0; i < len_fds; i++) {
+        idx[i*2] = -1;
+    }
+    for (int i = 0; i < len_fds; i++) {
+        if (idx[i*2] >= 0) continue;
+        for (int j = i; j < len_fds; j++) {
+            double k = (fds[j] - fds[i]) / df;
+            int m = (int)floor(k + 0.5);
+            if (idx[j*2] >= 0 || fabs(k - m) > 1e-3) continue;
+            idx[j*2] = nb;
+            idx[j*2+1] = (m % N + N) % N;
         }
+        fc[nb++] = (fi + fds[i]) / fs;
     }
-    else { // IQ-sampling
-        for (int i = 0; i < buff->N; i++) {
-            buff->data[i] = SDR_CPX8(raw[i*2], raw[i*2+1]);
+    sdr_buff_get(buff, ix, N, data);
+    
+    if (sdr_gpu_data(data, N, fc, nb)) {
+        for ( ; c < ncode && sdr_gpu_corr(code_fft[c], idx, len_fds, Pc); c++) {
+            for (int j = 0; j < len_fds; j++) {
+                const float *Pj = Pc + (size_t)j * N;
+                if (P) {
+                    float *Qj = P[c] + (size_t)j * N;
+                    for (int l = 0; l < N; l++) {
+                        Qj[l] += Pj[l];
+                    }
+                }
+                else {
+                    pacc_add(acc[c], j, Pj);
+                }
+            }
         }
     }
-    sdr_free(raw);
-    fclose(fp);
-    return buff;
+    pthread_mutex_unlock(&gpu_mtx);
+    sdr_scratch_free(data);
+    sdr_scratch_free(fc);
+    sdr_scratch_free(idx);
+    sdr_scratch_free(Pc);
+#endif
+    return c;
 }
 
-//------------------------------------------------------------------------------
-//  Parallel code search in digitized IF data.
-//
-//  args:
-//      code_fft (I) Code DFT (with or w/o zero-padding) as complex array
-//      T        (I) Code cycle (period) (s)
-//      buff     (I) IF data buffer
-//      ix       (I) Index of sample data
-//      N        (I) length of sample data
-//      fs       (I) Sampling frequency (Hz)
-//      fi       (I) IF frequency (Hz)
-//      fds      (I) Doppler frequency bins as ndarray (Hz)
-//      len_fds  (I) length of Doppler frequency bins
-//      P        (IO) Correlation powers in the Doppler frequencies - Code offset
-//                   space as float 2D-array (N x len_fs, N = (int)(fs * T))
-//
-//  return:
-//      none
-//
-void sdr_search_code(const sdr_cpx_t *code_fft, double T,
+// parallel code search of multiple codes --------------------------------------
+static void search_code(const sdr_cpx_t *const *code_fft, int ncode, double T,
     const sdr_buff_t *buff, int ix, int N, double fs, double fi,
-    const float *fds, int len_fds, float *P)
+    const float *fds, int len_fds, float *const *P, sdr_pacc_t *const *acc)
 {
-    sdr_cpx_t *C = sdr_cpx_malloc(N);
+    fftwf_plan plan[2];
+    double df = fs / N; // FFT frequency bin spacing (Hz)
+    int64_t t0 = sdr_trace_begin();
     
-    for (int i = 0; i < len_fds; i++) {
+    // codes searched by GPU backend, others by CPU
+    int c0 = search_code_gpu(code_fft, ncode, buff, ix, N, fs, fi, fds,
+        len_fds, P, acc);
+    if (c0 >= ncode) {
+        sdr_trace_end("acq", "search_code_gpu", (int64_t)ncode * len_fds, t0);
+        return;
+    }
+    code_fft += c0;
+    ncode -= c0;
+    P = P ? P + c0 : NULL;
+    acc = acc ? acc + c0 : NULL;
+    
+    if (!get_fftw_plan(N, plan)) return;
+    
+    sdr_cpx16_t *IQ = (sdr_cpx16_t *)sdr_scratch_alloc(sizeof(sdr_cpx16_t) * N);
+    sdr_cpx_t *X = (sdr_cpx_t *)sdr_scratch_alloc(sizeof(sdr_cpx_t) * N * 3);
+    sdr_cpx_t *Y = X + N, *C = X + N * 2;
+    uint8_t *done = (uint8_t *)sdr_scratch_alloc(len_fds);
+    memset(done, 0, len_fds);
+    
+    for (int i = 0, n = 0; i < len_fds; i++) {
+        if (done[i]) continue;
         
-        // FFT correlator
-        sdr_corr_fft(buff, ix, N, fs, fi + fds[i], 0.0, code_fft, C);
+        // FFT of IF data mixed with carrier of base Doppler frequency
+        sdr_mix_carr(buff, ix, N, fs, fi + fds[i], 0.0, IQ);
+        simd->cvt_IQ(IQ, N, SDR_CSCALE, Y);
+        fftwf_execute_dft(plan[0], Y, X);
         
-        // add correlation power
-        for (int j = 0; j < N; j++) {
-            P[i*N+j] += SQR(C[j][0]) + SQR(C[j][1]); // abs(C[j]) ** 2
-        }
-        if (i % 22 == 21) { // release cpu
-            sdr_sleep_msec(1);
+        // Doppler frequencies with integer bin offsets from base by shifting
+        // spectrum, others by the following base frequencies
+        for (int j = i; j < len_fds; j++) {
+            double k = (fds[j] - fds[i]) / df;
+            int m = (int)floor(k + 0.5);
+            if (done[j] || fabs(k - m) > 1e-3) continue;
+            m = (m % N + N) % N;
+            
+            for (int c = 0; c < ncode; c++) {
+                // ifft(shift(fft(data), m) * code_fft) / N^2
+                sdr_cpx_mul(X + m, code_fft[c], N - m, 1.0f / N / N, Y);
+                sdr_cpx_mul(X, code_fft[c] + N - m, m, 1.0f / N / N, Y + N - m);
+                fftwf_execute_dft(plan[1], Y, C);
+                
+                // add correlation power
+                if (P) {
+                    float *Pj = P[c] + (size_t)j * N;
+                    for (int l = 0; l < N; l++) {
+                        Pj[l] += SQR(C[l][0]) + SQR(C[l][1]); // abs(C[l])**2
+                    }
+                }
+                else {
+                    float *Pj = (float *)Y;
+                    for (int l = 0; l < acc[c]->N; l++) {
+                        Pj[l] = SQR(C[l][0]) + SQR(C[l][1]);
+                    }
+                    pacc_add(acc[c], j, Pj);
+                }
+                if (++n == sdr_srch_ncorr) { // release cpu
+                    sdr_sleep_msec(1);
+                    n = 0;
+                }
+            }
+            done[j] = 1;
         }
     }
-    sdr_cpx_free(C);
+    sdr_scratch_free(IQ);
+    sdr_scratch_free(X);
+    sdr_scratch_free(done);
+    sdr_trace_end("acq", "search_code", (int64_t)ncode * len_fds, t0);
 }
 
 // max correlation power and C/N0 ----------------------------------------------
@@ -354,6 +2039,42 @@ float sdr_corr_max(const float *P, int N, int Nmax, int M, double T, int *ix)
         (float)(10.0 * log10((P_max - P_ave) / P_ave / T)) : 0.0f;
 }
 
+//------------------------------------------------------------------------------
+//  Max correlation power and C/N0 in compact correlation power accumulator.
+//
+//  args:
+//      acc      (I)  Compact correlation power accumulator
+//      T        (I)  Code cycle (period) (s)
+//      ix       (O)  Indices of max power (Doppler bin, code offset)
+//
+//  return:
+//      C/N0 (dB-Hz)
+//
+float sdr_pacc_corr_max(const sdr_pacc_t *acc, double T, int *ix)
+{
+    double P_max = 0.0, P_ave = 0.0;
+    int n = 0;
+    
+    for (int i = 0; i < acc->M; i++) {
+        const uint16_t *Pi = acc->P + (size_t)i * acc->N;
+        double scale = acc->scale[i], sum = 0.0;
+        int max = 0;
+        for (int j = 0; j < acc->N; j++) {
+            sum += Pi[j];
+            if (Pi[j] <= max) continue;
+            max = Pi[j];
+            if (max * scale <= P_max) continue;
+            P_max = max * scale;
+            ix[0] = i; // index of doppler freq.
+            ix[1] = j; // index of code offset
+        }
+        n += acc->N;
+        P_ave += (sum * scale - P_ave * acc->N) / n;
+    }
+    return (P_ave > 0.0) ?
+        (float)(10.0 * log10((P_max - P_ave) / P_ave / T)) : 0.0f;
+}
+
 // polynomial fitting ----------------------------------------------------------
 static int poly_fit(const double *x, const double *y, int nx, int np, double *p)
 {
@@ -373,6 +2094,20 @@ static int poly_fit(const double *x, const double *y, int nx, int np, double *p)
     return !stat;
 }
 
+// fine Doppler frequency by quadratic fitting of 3 powers ---------------------
+static double fine_dop(const double *y, const float *fds, const int *ix)
+{
+    double x[3], p[3];
+    
+    for (int i = 0; i < 3; i++) {
+        x[i] = fds[ix[0]-1+i];
+    }
+    if (!poly_fit(x, y, 3, 3, p)) {
+        return fds[ix[0]];
+    }
+    return -p[1] / (2.0 * p[2]);
+}
+
 // fine Doppler frequency by quadratic fitting ---------------------------------
 double sdr_fine_dop(const float *P, int N, const float *fds, int len_fds,
     const int *ix)
@@ -380,16 +2115,40 @@ double sdr_fine_dop(const float *P, int N, const float *fds, int len_fds,
     if (ix[0] == 0 || ix[0] == len_fds - 1) {
         return fds[ix[0]];
     }
-    double x[3], y[3], p[3];
+    double y[3];
     
     for (int i = 0; i < 3; i++) {
-        x[i] = fds[ix[0]-1+i];
         y[i] = P[(ix[0]-1+i)*N+ix[1]];
     }
-    if (!poly_fit(x, y, 3, 3, p)) {
+    return fine_dop(y, fds, ix);
+}
+
+//------------------------------------------------------------------------------
+//  Fine Doppler frequency by quadratic fitting in compact correlation power
+//  accumulator.
+//
+//  args:
+//      acc      (I)  Compact correlation power accumulator
+//      fds      (I)  Doppler frequency bins (Hz)
+//      len_fds  (I)  Length of Doppler frequency bins
+//      ix       (I)  Indices of max power by sdr_pacc_corr_max()
+//
+//  return:
+//      Fine Doppler frequency (Hz)
+//
+double sdr_pacc_fine_dop(const sdr_pacc_t *acc, const float *fds, int len_fds,
+    const int *ix)
+{
+    if (ix[0] == 0 || ix[0] == len_fds - 1) {
         return fds[ix[0]];
     }
-    return -p[1] / (2.0 * p[2]);
+    double y[3];
+    
+    for (int i = 0; i < 3; i++) {
+        int j = ix[0] - 1 + i;
+        y[i] = acc->P[(size_t)j*acc->N+ix[1]] * (double)acc->scale[j];
+    }
+    return fine_dop(y, fds, ix);
 }
 
 // shift IF frequency for GLONASS FDMA -----------------------------------------
@@ -418,41 +2177,46 @@ float *sdr_dop_bins(double T, float dop, float max_dop, int *len_fds)
     return fds;
 }
 
-// mix carrier -----------------------------------------------------------------
-static void mix_carr(const sdr_buff_t *buff, int ix, int N, double phi,
-    double step, sdr_cpx16_t *IQ)
+// carrier phase and step for LUT (1/2^32 cyc) ---------------------------------
+static void carr_phase(double phi, double step, uint32_t *p, uint32_t *s)
 {
-    const uint8_t *data = buff->data + ix;
     double scale = (double)(1 << 24) * NTBL;
-    uint32_t p = (uint32_t)((phi - floor(phi)) * scale);
-    uint32_t s = (uint32_t)(int)(step * scale);
-    int i = 0;
-#if defined(AVX2)
-    __m256i yp = _mm256_set_epi32(p+s*7, p+s*6, p+s*5, p+s*4, p+s*3, p+s*2, p+s, p);
-    __m256i ys = _mm256_set1_epi32(s*8);
-    
-    for ( ; i < N - 16; i += 8) {
-        int idx[8];
-        __m128i xdas = _mm_loadu_si128((__m128i *)(data + i));
-        __m256i ydat = _mm256_cvtepu8_epi32(xdas);
-        __m256i yidx = _mm256_add_epi32(_mm256_slli_epi32(ydat, 8),
-            _mm256_srli_epi32(yp, 24));
-        _mm256_storeu_si256((__m256i *)idx, yidx);
-        IQ[i  ] = mix_tbl[idx[0]];
-        IQ[i+1] = mix_tbl[idx[1]];
-        IQ[i+2] = mix_tbl[idx[2]];
-        IQ[i+3] = mix_tbl[idx[3]];
-        IQ[i+4] = mix_tbl[idx[4]];
-        IQ[i+5] = mix_tbl[idx[5]];
-        IQ[i+6] = mix_tbl[idx[6]];
-        IQ[i+7] = mix_tbl[idx[7]];
-        yp = _mm256_add_epi32(yp, ys);
+    *p = (uint32_t)((phi - floor(phi)) * scale);
+    *s = (uint32_t)(int)(step * scale);
+}
+
+// mix carrier by selected kernel ----------------------------------------------
+static uint32_t mix_kern(const uint8_t *data, int N, uint32_t p, uint32_t s,
+    sdr_cpx16_t *IQ)
+{
+    return mix_nco ? simd->mix_nco(data, N, p, s, IQ) :
+        simd->mix_carr(data, N, p, s, IQ);
+}
+
+// mix carrier of IF data buffer (w/o IF buffer boundary) ----------------------
+static uint32_t mix_buff(const sdr_buff_t *buff, int ix, int N, uint32_t p,
+    uint32_t s, sdr_cpx16_t *IQ)
+{
+    if (!buff->pack) {
+        return mix_kern(buff->data + ix, N, p, s, IQ);
     }
-#endif
-    for (p += s * i; i < N; i++, p += s) {
-        int idx = ((int)data[i] << 8) + (p >> 24);
-        IQ[i] = mix_tbl[idx];
+    sdr_cpx8_t data[CORR_BLK]; // unpacked data block (on L1 cache)
+    
+    for (int i = 0; i < N; i += CORR_BLK) {
+        int n = MIN(CORR_BLK, N - i);
+        unpack_buff(buff, ix + i, n, data);
+        p = mix_kern(data, n, p, s, IQ + i);
     }
+    return p;
+}
+
+// mix carrier -----------------------------------------------------------------
+static void mix_carr(const sdr_buff_t *buff, int ix, int N, double phi,
+    double step, sdr_cpx16_t *IQ)
+{
+    uint32_t p, s;
+    carr_phase(phi, step, &p, &s);
+    mix_buff(buff, ix, N, p, s, IQ);
 }
 
 void sdr_mix_carr(const sdr_buff_t *buff, int ix, int N, double fs, double fc,
@@ -474,111 +2238,177 @@ void sdr_mix_carr(const sdr_buff_t *buff, int ix, int N, double fs, double fc,
 static void mix_carr_cpx(const sdr_cpx_t *buff, int len_buff, int ix, int N,
     double fs, double fc, double phi, sdr_cpx16_t *IQ)
 {
-    sdr_buff_t *buff_cpx8 = sdr_buff_new(N, 2);
-    for (int i = 0, j = ix; i < N; i++, j = (j + 1) % len_buff) {
-        buff_cpx8->data[i] = SDR_CPX8((int8_t)buff[j][0], (int8_t)buff[j][1]);
-    }
+    sdr_buff_t *buff_cpx8 = buff_new_cpx(buff, len_buff, ix, N);
     mix_carr(buff_cpx8, 0, N, phi, fc / fs, IQ);
     sdr_buff_free(buff_cpx8);
 }
 
-// sum of int16 fields ---------------------------------------------------------
-#if defined(AVX2)
-#define sum_s16(ymm, sum) { \
-    int16_t s[16]; \
-    _mm256_storeu_si256((__m256i *)s, ymm); \
-    ymm = _mm256_setzero_si256(); \
-    sum += s[0] + s[1] + s[2] + s[3] + s[4] + s[5] + s[6] + s[7] + s[8] + s[9] \
-        + s[10] + s[11] + s[12] + s[13] + s[14] + s[15]; \
+// standard correlator ---------------------------------------------------------
+static void corr_std(const sdr_cpx16_t *IQ, const sdr_cpx16_t *code, int N,
+    const int *pos, int n, sdr_cpx_t *corr)
+{
+    for (int i = 0; i < n; i++) {
+        if (pos[i] > 0) {
+            int M = N - pos[i];
+            simd->dot_IQ_code(IQ + pos[i], code, M, 1.0f / M, corr + i);
+        }
+        else if (pos[i] < 0) {
+            int M = N + pos[i];
+            simd->dot_IQ_code(IQ, code - pos[i], M, 1.0f / M, corr + i);
+        }
+        else {
+            simd->dot_IQ_code(IQ, code, N, 1.0f / N, corr + i);
+        }
+    }
 }
-#elif defined(NEON)
-#define sum_s16(ymm, sum) { \
-    int16_t s[8]; \
-    vst1q_s16(s, ymm); \
-    ymm = vdupq_n_s16(0); \
-    sum += s[0] + s[1] + s[2] + s[3] + s[4] + s[5] + s[6] + s[7]; \
+
+// accumulate correlator of block for samples k1,...,k2-1 ----------------------
+static void corr_blk(const sdr_cpx16_t *IQ, const sdr_cpx16_t *code, int k,
+    int k1, int k2, int pos, sdr_cpx_t *corr)
+{
+    if (k1 >= k2) return;
+    sdr_cpx_t c;
+    simd->dot_IQ_code(IQ + k1 - k, code + k1 - pos, k2 - k1, 1.0f, &c);
+    (*corr)[0] += c[0];
+    (*corr)[1] += c[1];
 }
-#endif
 
-// inner product of IQ data and code -------------------------------------------
-static void dot_IQ_code(const sdr_cpx16_t *IQ, const sdr_cpx16_t *code, int N,
-    float s, sdr_cpx_t *c)
+// accumulate correlators of block for contiguous lags -------------------------
+static void corr_lags(const sdr_cpx16_t *IQ, const sdr_cpx16_t *code, int k,
+    int M, int N, const int *pos, int L, sdr_cpx_t *corr)
 {
-    int i = 0;
-    (*c)[0] = (*c)[1] = 0.0f;
-#if defined(AVX2)
-    __m256i ysumI = _mm256_setzero_si256();
-    __m256i ysumQ = _mm256_setzero_si256();
-    __m256i yextI = _mm256_set_epi8(0,1,0,1,0,1,0,1, 0,1,0,1,0,1,0,1,
-        0,1,0,1,0,1,0,1, 0,1,0,1,0,1,0,1);
-    __m256i yextQ = _mm256_set_epi8(1,0,1,0,1,0,1,0, 1,0,1,0,1,0,1,0,
-        1,0,1,0,1,0,1,0, 1,0,1,0,1,0,1,0);
+    int k1 = MAX(k, pos[L-1]), k2 = MIN(k + M, N + pos[0]); // common range
+    sdr_cpx_t c[SDR_N_CORR];
     
-    for ( ; i < N - 15; i += 16) {
-        __m256i ydata = _mm256_loadu_si256((__m256i *)(IQ + i));
-        __m256i ycode = _mm256_loadu_si256((__m256i *)(code + i)); // {-1,0,1}
-        __m256i ycorr = _mm256_sign_epi8(ydata, ycode); // IQ * code
-        ysumI = _mm256_add_epi16(ysumI, _mm256_maddubs_epi16(yextI, ycorr));
-        ysumQ = _mm256_add_epi16(ysumQ, _mm256_maddubs_epi16(yextQ, ycorr));
-        if (i % (16 * 256) == 0) {
-            sum_s16(ysumI, (*c)[0])
-            sum_s16(ysumQ, (*c)[1])
+    if (k1 >= k2) {
+        for (int i = 0; i < L; i++) {
+            corr_blk(IQ, code, k, MAX(k, pos[i]), MIN(k + M, N + pos[i]),
+                pos[i], corr + i);
         }
+        return;
     }
-    sum_s16(ysumI, (*c)[0])
-    sum_s16(ysumQ, (*c)[1])
-#elif defined(NEON)
-    int16x8_t ysumI = vdupq_n_s16(0);
-    int16x8_t ysumQ = vdupq_n_s16(0);
-    
-    for ( ; i < N - 7; i += 8) {
-        int8x8x2_t ydata = vld2_s8((int8_t *)(IQ + i));
-        int8x8x2_t ycode = vld2_s8((int8_t *)(code + i));
-        ysumI = vmlal_s8(ysumI, ydata.val[0], ycode.val[0]);
-        ysumQ = vmlal_s8(ysumQ, ydata.val[1], ycode.val[1]);
-        if (i % (8 * 256) == 0) {
-            sum_s16(ysumI, (*c)[0])
-            sum_s16(ysumQ, (*c)[1])
-        }
+    // all lags in a pass for common range, each lag for the rest
+    simd->dot_IQ_code_lags(IQ + k1 - k, code + k1 - pos[0], k2 - k1, L, 1.0f,
+        c);
+    for (int i = 0; i < L; i++) {
+        corr[i][0] += c[i][0];
+        corr[i][1] += c[i][1];
+        corr_blk(IQ, code, k, MAX(k, pos[i]), k1, pos[i], corr + i);
+        corr_blk(IQ, code, k, k2, MIN(k + M, N + pos[i]), pos[i], corr + i);
     }
-    sum_s16(ysumI, (*c)[0])
-    sum_s16(ysumQ, (*c)[1])
-#endif
-    for ( ; i < N; i++) {
-        (*c)[0] += IQ[i].I * code[i].I;
-        (*c)[1] += IQ[i].Q * code[i].Q;
+}
+
+// generate code block by code NCO (code[a],...,code[b-1]) --------------------
+static void gen_code_nco(const code_nco_t *nco, int a, int b, sdr_cpx16_t *code)
+{
+    double x = nco->x0 + a * nco->dx; // code phase (chips)
+    x = fmod(x, nco->len_code);
+    if (x < 0.0) x += nco->len_code;
+    uint64_t p = (uint64_t)(x * 4294967296.0); // fixed-point phase (32.32)
+    uint64_t s = (uint64_t)(nco->dx * 4294967296.0);
+    uint64_t len = (uint64_t)nco->len_code << 32;
+    
+    for (int i = a; i < b; i++, p += s) {
+        if (p >= len) p -= len;
+        int8_t c = nco->code[p >> 32];
+        code[i].I = code[i].Q = c;
     }
-    (*c)[0] *= s * SDR_CSCALE;
-    (*c)[1] *= s * SDR_CSCALE;
 }
 
-// standard correlator ---------------------------------------------------------
-static void corr_std(const sdr_cpx16_t *IQ, const sdr_cpx16_t *code, int N,
+// mix carrier and standard correlator by resampled code or code NCO -----------
+static void corr_mix(const sdr_buff_t *buff, int ix, int N, double fs,
+    double fc, double phi, const sdr_cpx16_t *code, const code_nco_t *nco,
     const int *pos, int n, sdr_cpx_t *corr)
 {
+    sdr_cpx16_t IQ[CORR_BLK]; // carrier-mixed data block (on L1 cache)
+    sdr_cpx16_t *code_blk = NULL;
+    int pmin = 0, pmax = 0;
+    uint32_t p, s;
+    
+    carr_phase(phi, fc / fs, &p, &s);
+    
     for (int i = 0; i < n; i++) {
-        if (pos[i] > 0) {
-            int M = N - pos[i];
-            dot_IQ_code(IQ + pos[i], code, M, 1.0f / M, corr + i);
+        corr[i][0] = corr[i][1] = 0.0f;
+        pmin = MIN(pmin, pos[i]);
+        pmax = MAX(pmax, pos[i]);
+    }
+    if (nco) { // code block for correlator positions (on L1 cache)
+        code_blk = (sdr_cpx16_t *)sdr_scratch_alloc(sizeof(sdr_cpx16_t) *
+            (CORR_BLK + pmax - pmin));
+    }
+    for (int k = 0; k < N; k += CORR_BLK) {
+        int M = MIN(CORR_BLK, N - k);
+        
+        // mix carrier of block (across IF buffer boundary)
+        int j = (ix + k) % buff->N, m = MIN(M, buff->N - j);
+        p = mix_buff(buff, j, m, p, s, IQ);
+        if (m < M) {
+            p = mix_buff(buff, 0, M - m, p, s, IQ + m);
         }
-        else if (pos[i] < 0) {
-            int M = N + pos[i];
-            dot_IQ_code(IQ, code - pos[i], M, 1.0f / M, corr + i);
+        // generate code of block (code[k-pmax],...,code[k+M-pmin-1])
+        if (nco) {
+            gen_code_nco(nco, MAX(k - pmax, 0), MIN(k + M - pmin, N),
+                code_blk + pmax - k);
+            code = code_blk + pmax - k;
         }
-        else {
-            dot_IQ_code(IQ, code, N, 1.0f / N, corr + i);
+        // accumulate correlators of block (IQ[k] * code[k-pos])
+        for (int i = 0; i < n; ) {
+            int L = 1;
+            while (i + L < n && pos[i+L] == pos[i] + L) L++;
+            if (L >= MIN_LAGS && simd->dot_IQ_code_lags) {
+                corr_lags(IQ, code, k, M, N, pos + i, L, corr + i);
+                i += L;
+            }
+            else {
+                corr_blk(IQ, code, k, MAX(k, pos[i]), MIN(k + M, N + pos[i]),
+                    pos[i], corr + i);
+                i++;
+            }
         }
     }
+    for (int i = 0; i < n; i++) {
+        int M = N - abs(pos[i]);
+        corr[i][0] /= M;
+        corr[i][1] /= M;
+    }
+    sdr_scratch_free(code_blk);
 }
 
 // mix carrier and standard correlator -----------------------------------------
 void sdr_corr_std(const sdr_buff_t *buff, int ix, int N, double fs, double fc,
     double phi, const sdr_cpx16_t *code, const int *pos, int n, sdr_cpx_t *corr)
 {
-    sdr_cpx16_t *IQ = (sdr_cpx16_t *)sdr_malloc(sizeof(sdr_cpx16_t) * N);
-    sdr_mix_carr(buff, ix, N, fs, fc, phi, IQ);
-    corr_std(IQ, code, N, pos, n, corr);
-    sdr_free(IQ);
+    corr_mix(buff, ix, N, fs, fc, phi, code, NULL, pos, n, corr);
+}
+
+//------------------------------------------------------------------------------
+//  Mix carrier and standard correlator with code NCO. The code is generated
+//  from the code chips by a fixed-point code NCO in the correlator loop instead
+//  of the resampled code (see sdr_res_code()), so the code offset is not
+//  quantized and no resampled code bank is needed.
+//
+//  args:
+//      buff, ..., phi (I) Same as sdr_corr_std()
+//      code     (I)  Code as int8_t array (-1 or 1)
+//      len_code (I)  Length of code
+//      T        (I)  Code cycle (period) (s)
+//      coff     (I)  Code offset (s) (same as sdr_res_code())
+//      pos, ... (I)  Same as sdr_corr_std()
+//
+//  return:
+//      none
+//
+void sdr_corr_nco(const sdr_buff_t *buff, int ix, int N, double fs, double fc,
+    double phi, const int8_t *code, int len_code, double T, double coff,
+    const int *pos, int n, sdr_cpx_t *corr)
+{
+    code_nco_t nco;
+    
+    nco.code = code;
+    nco.len_code = len_code;
+    nco.dx = len_code / T / fs;
+    nco.x0 = coff * fs * nco.dx;
+    corr_mix(buff, ix, N, fs, fc, phi, NULL, &nco, pos, n, corr);
 }
 
 // mix carrier and standard correlator for complex buffer ----------------------
@@ -586,42 +2416,142 @@ void sdr_corr_std_cpx(const sdr_cpx_t *buff, int len_buff, int ix, int N,
     double fs, double fc, double phi, const float *code, const int *pos, int n,
     sdr_cpx_t *corr)
 {
-    sdr_cpx16_t *IQ = (sdr_cpx16_t *)sdr_malloc(sizeof(sdr_cpx16_t) * N * 2);
+    sdr_cpx16_t *IQ = (sdr_cpx16_t *)sdr_scratch_alloc(sizeof(sdr_cpx16_t) * N * 2);
     mix_carr_cpx(buff, len_buff, ix, N, fs, fc, phi, IQ);
     for (int i = 0; i < N; i++) {
         IQ[N+i].I = IQ[N+i].Q = (int8_t)code[i];
     }
     corr_std(IQ, IQ + N, N, pos, n, corr);
-    sdr_free(IQ);
+    sdr_scratch_free(IQ);
+}
+
+//------------------------------------------------------------------------------
+//  Set options of FFTW plan cache. It should be called before the first FFT
+//  correlation. FFTW plans are generated with FFTW_MEASURE from the imported
+//  FFTW wisdom (see sdr_gen_fftw_wisdom()) if available, otherwise with the
+//  flag specified.
+//
+//  args:
+//      max_plan (I)  Max number of FFTW plans (0: default)
+//      flag     (I)  FFTW planning flag without wisdom (FFTW_ESTIMATE,
+//                    FFTW_MEASURE, ...)
+//
+//  return:
+//      Status (1: OK, 0: error (plan cache already used))
+//
+int sdr_fftw_plan_opt(int max_plan, unsigned int flag)
+{
+    pthread_mutex_lock(&fftw_mtx);
+    int stat = !fftw_plans;
+    if (stat) {
+        fftw_max = max_plan > 0 ? max_plan : MAX_FFTW_PLAN;
+        fftw_flag = flag;
+    }
+    pthread_mutex_unlock(&fftw_mtx);
+    return stat;
+}
+
+// hash of FFT size ------------------------------------------------------------
+static int fftw_hash(int N, int nbit)
+{
+    return (int)(((uint32_t)N * 2654435761u) >> (32 - nbit));
+}
+
+// generate FFTW plan (called with fftw_mtx locked) ----------------------------
+static void gen_fftw_plan(int N, fftwf_plan *plan)
+{
+    sdr_cpx_t *cpx1 = sdr_cpx_malloc(N);
+    sdr_cpx_t *cpx2 = sdr_cpx_malloc(N);
+    plan[0] = plan[1] = NULL;
+    if (fftw_wisdom) {
+        unsigned int flag = FFTW_MEASURE | FFTW_WISDOM_ONLY;
+        plan[0] = fftwf_plan_dft_1d(N, cpx1, cpx2, FFTW_FORWARD,  flag);
+        plan[1] = fftwf_plan_dft_1d(N, cpx2, cpx1, FFTW_BACKWARD, flag);
+    }
+    if (!plan[0]) {
+        plan[0] = fftwf_plan_dft_1d(N, cpx1, cpx2, FFTW_FORWARD,  fftw_flag);
+    }
+    if (!plan[1]) {
+        plan[1] = fftwf_plan_dft_1d(N, cpx2, cpx1, FFTW_BACKWARD, fftw_flag);
+    }
+    sdr_cpx_free(cpx1);
+    sdr_cpx_free(cpx2);
+}
+
+// add FFTW plan to plan cache -------------------------------------------------
+static int add_fftw_plan(int N, fftwf_plan *plan)
+{
+    pthread_mutex_lock(&fftw_mtx);
+    
+    if (!fftw_plans) {
+        for (fftw_nbit = 1; (1 << fftw_nbit) < fftw_max * 2; fftw_nbit++) ;
+        fftw_plan_t *plans = (fftw_plan_t *)sdr_malloc(sizeof(fftw_plan_t) <<
+            fftw_nbit);
+        __atomic_store_n(&fftw_plans, plans, __ATOMIC_RELEASE);
+    }
+    int size = 1 << fftw_nbit, h = fftw_hash(N, fftw_nbit);
+    for (int i = 0; i < size; i++) {
+        fftw_plan_t *p = fftw_plans + ((h + i) & (size - 1));
+        if (p->N == N) {
+            plan[0] = p->plan[0];
+            plan[1] = p->plan[1];
+            pthread_mutex_unlock(&fftw_mtx);
+            return 1;
+        }
+        if (p->N == 0) {
+            if (fftw_nplan >= fftw_max) break;
+            int64_t t0 = sdr_trace_begin();
+            gen_fftw_plan(N, p->plan);
+            sdr_trace_end("fft", "fftw_plan", N, t0);
+            fftw_nplan++;
+            plan[0] = p->plan[0];
+            plan[1] = p->plan[1];
+            __atomic_store_n(&p->N, N, __ATOMIC_RELEASE); // publish plan
+            pthread_mutex_unlock(&fftw_mtx);
+            return 1;
+        }
+    }
+    fprintf(stderr, "fftw plan buffer overflow N=%d\n", N);
+    pthread_mutex_unlock(&fftw_mtx);
+    return 0;
 }
 
-// get FFTW plan ---------------------------------------------------------------
+// get FFTW plan (lock-free for cached plans) ----------------------------------
 static int get_fftw_plan(int N, fftwf_plan *plan)
 {
-    static pthread_mutex_t mtx = PTHREAD_MUTEX_INITIALIZER;
-    
-    pthread_mutex_lock(&mtx);
+    fftw_plan_t *plans = __atomic_load_n(&fftw_plans, __ATOMIC_ACQUIRE);
     
-    for (int i = 0; i < MAX_FFTW_PLAN; i++) {
-        if (fftw_size[i] == 0) {
-            sdr_cpx_t *cpx1 = sdr_cpx_malloc(N);
-            sdr_cpx_t *cpx2 = sdr_cpx_malloc(N);
-            fftw_plans[i][0] = fftwf_plan_dft_1d(N, cpx1, cpx2, FFTW_FORWARD,  FFTW_FLAG);
-            fftw_plans[i][1] = fftwf_plan_dft_1d(N, cpx2, cpx1, FFTW_BACKWARD, FFTW_FLAG);
-            fftw_size[i] = N;
-            sdr_cpx_free(cpx1);
-            sdr_cpx_free(cpx2);
-        }
-        if (fftw_size[i] == N) {
-            plan[0] = fftw_plans[i][0];
-            plan[1] = fftw_plans[i][1];
-            pthread_mutex_unlock(&mtx);
-            return 1;
+    if (plans) {
+        int size = 1 << fftw_nbit, h = fftw_hash(N, fftw_nbit);
+        for (int i = 0; i < size; i++) {
+            fftw_plan_t *p = plans + ((h + i) & (size - 1));
+            int n = __atomic_load_n(&p->N, __ATOMIC_ACQUIRE);
+            if (n == N) {
+                plan[0] = p->plan[0];
+                plan[1] = p->plan[1];
+                return 1;
+            }
+            if (n == 0) break;
         }
     }
-    fprintf(stderr, "fftw plan buffer overflow N=%d\n", N);
-    pthread_mutex_unlock(&mtx);
-    return 0;
+    return add_fftw_plan(N, plan);
+}
+
+//------------------------------------------------------------------------------
+//  Get FFTW plans from FFTW plan cache. The plans are for out-of-place FFT of
+//  sdr_cpx_t arrays allocated by sdr_cpx_malloc() and can be executed by
+//  fftwf_execute_dft() concurrently.
+//
+//  args:
+//      N        (I)  FFT size
+//      plan     (O)  FFTW plans {forward, backward}
+//
+//  return:
+//      Status (1: OK, 0: error)
+//
+int sdr_fftw_plan(int N, fftwf_plan *plan)
+{
+    return get_fftw_plan(N, plan);
 }
 
 // FFT correlator --------------------------------------------------------------
@@ -631,27 +2561,125 @@ static void corr_fft(const sdr_cpx16_t *IQ, const sdr_cpx_t *code_fft, int N,
     fftwf_plan plan[2];
     
     if (!get_fftw_plan(N, plan)) return;
-    sdr_cpx_t *cpx = sdr_cpx_malloc(N * 2);
-    for (int i = 0; i < N; i++) {
-        cpx[i][0] = IQ[i].I * SDR_CSCALE;
-        cpx[i][1] = IQ[i].Q * SDR_CSCALE;
-    }
+    sdr_cpx_t *cpx = (sdr_cpx_t *)sdr_scratch_alloc(sizeof(sdr_cpx_t) * N * 2);
+    simd->cvt_IQ(IQ, N, SDR_CSCALE, cpx);
     // ifft(fft(data) * code_fft) / N^2 
     fftwf_execute_dft(plan[0], cpx, cpx + N);
     sdr_cpx_mul(cpx + N, code_fft, N, 1.0f / N / N, cpx);
     fftwf_execute_dft(plan[1], cpx, corr);
     
-    sdr_cpx_free(cpx);
+    sdr_scratch_free(cpx);
 }
 
 // mix carrier and FFT correlator ----------------------------------------------
 void sdr_corr_fft(const sdr_buff_t *buff, int ix, int N, double fs, double fc,
     double phi, const sdr_cpx_t *code_fft, sdr_cpx_t *corr)
 {
-    sdr_cpx16_t *IQ = (sdr_cpx16_t *)sdr_malloc(sizeof(sdr_cpx16_t) * N);
+    sdr_cpx16_t *IQ = (sdr_cpx16_t *)sdr_scratch_alloc(sizeof(sdr_cpx16_t) * N);
     sdr_mix_carr(buff, ix, N, fs, fc, phi, IQ);
     corr_fft(IQ, code_fft, N, corr);
-    sdr_free(IQ);
+    sdr_scratch_free(IQ);
+}
+
+// search shared data spectrum -------------------------------------------------
+static spec_t *spec_search(const sdr_buff_t *buff, double time, int ix, int N,
+    double fs, double fc)
+{
+    for (int i = 0; i < SPEC_NCACHE; i++) {
+        spec_t *sp = spec_cache + i;
+        if (sp->buff == buff && sp->time == time && sp->ix == ix &&
+            sp->N == N && sp->fs == fs &&
+            fabs(sp->fc - fc) * N / fs < SPEC_TOL_F) {
+            return sp;
+        }
+    }
+    return NULL;
+}
+
+// add shared data spectrum ----------------------------------------------------
+static void spec_add(const sdr_buff_t *buff, double time, int ix, int N,
+    double fs, double fc, double phi, const sdr_cpx_t *X)
+{
+    spec_t *sp = spec_cache + spec_next;
+    spec_next = (spec_next + 1) % SPEC_NCACHE;
+    if (sp->size < N) {
+        sdr_cpx_free(sp->X);
+        sp->X = sdr_cpx_malloc(N);
+        sp->size = N;
+    }
+    memcpy(sp->X, X, sizeof(sdr_cpx_t) * N);
+    sp->buff = buff;
+    sp->time = time;
+    sp->ix = ix;
+    sp->N = N;
+    sp->fs = fs;
+    sp->fc = fc;
+    sp->phi = phi;
+}
+
+//------------------------------------------------------------------------------
+//  Mix carrier and FFT correlator with shared data spectrum. The spectrum of
+//  the carrier-mixed IF data is cached and reused by the other channels with
+//  the same IF data segment and the IF carrier within SPEC_TOL_F (e.g. L6D and
+//  L6E of the same satellite). The carrier phase difference to the cached
+//  spectrum is corrected in the correlation.
+//
+//  args:
+//      buff     (I) IF data buffer
+//      ix       (I) index of IF data buffer
+//      N        (I) number of samples (= FFT size)
+//      fs       (I) sampling frequency (Hz)
+//      fc       (I) IF carrier frequency (Hz)
+//      phi      (I) IF carrier phase (cyc)
+//      time     (I) sampling time of IF data buffer (s)
+//      code_fft (I) code FFT
+//      corr     (O) correlation (N)
+//
+//  return:
+//      none
+//
+void sdr_corr_fft_share(const sdr_buff_t *buff, int ix, int N, double fs,
+    double fc, double phi, double time, const sdr_cpx_t *code_fft,
+    sdr_cpx_t *corr)
+{
+    fftwf_plan plan[2];
+    
+    if (!get_fftw_plan(N, plan)) return;
+    sdr_cpx_t *cpx = (sdr_cpx_t *)sdr_scratch_alloc(sizeof(sdr_cpx_t) * N * 2);
+    double dphi = 0.0;
+    
+    pthread_mutex_lock(&spec_mtx);
+    spec_t *sp = spec_search(buff, time, ix, N, fs, fc);
+    if (sp) {
+        dphi = phi - sp->phi;
+        sdr_cpx_mul(sp->X, code_fft, N, 1.0f / N / N, cpx);
+    }
+    pthread_mutex_unlock(&spec_mtx);
+    
+    if (!sp) {
+        sdr_cpx16_t *IQ = (sdr_cpx16_t *)sdr_scratch_alloc(sizeof(sdr_cpx16_t) *
+            N);
+        sdr_mix_carr(buff, ix, N, fs, fc, phi, IQ);
+        simd->cvt_IQ(IQ, N, SDR_CSCALE, cpx);
+        sdr_scratch_free(IQ);
+        fftwf_execute_dft(plan[0], cpx, cpx + N);
+        pthread_mutex_lock(&spec_mtx);
+        spec_add(buff, time, ix, N, fs, fc, phi, cpx + N);
+        pthread_mutex_unlock(&spec_mtx);
+        sdr_cpx_mul(cpx + N, code_fft, N, 1.0f / N / N, cpx);
+    }
+    fftwf_execute_dft(plan[1], cpx, corr);
+    
+    if (dphi != 0.0) { // correct carrier phase difference
+        float c = (float)cos(2.0 * PI * dphi), s = (float)sin(2.0 * PI * dphi);
+        for (int i = 0; i < N; i++) {
+            float re = corr[i][0] * c + corr[i][1] * s;
+            float im = corr[i][1] * c - corr[i][0] * s;
+            corr[i][0] = re;
+            corr[i][1] = im;
+        }
+    }
+    sdr_scratch_free(cpx);
 }
 
 // mix carrier and FFT correlator for complex input ----------------------------
@@ -659,10 +2687,10 @@ void sdr_corr_fft_cpx(const sdr_cpx_t *buff, int len_buff, int ix, int N,
     double fs, double fc, double phi, const sdr_cpx_t *code_fft,
     sdr_cpx_t *corr)
 {
-    sdr_cpx16_t *IQ = (sdr_cpx16_t *)sdr_malloc(sizeof(sdr_cpx16_t) * N);
+    sdr_cpx16_t *IQ = (sdr_cpx16_t *)sdr_scratch_alloc(sizeof(sdr_cpx16_t) * N);
     mix_carr_cpx(buff, len_buff, ix, N, fs, fc, phi, IQ);
     corr_fft(IQ, code_fft, N, corr);
-    sdr_free(IQ);
+    sdr_scratch_free(IQ);
 }
 
 // hanning window function -----------------------------------------------------
@@ -740,21 +2768,21 @@ void sdr_psd_cpx(const sdr_cpx_t *buff, int len_buff, int N, double fs, int IQ,
 }
 
 // open stream -----------------------------------------------------------------
-stream_t *sdr_str_open(const char *path)
+sdr_str_t *sdr_str_open(const char *path)
 {
     if (!*path) return NULL;
     
-    stream_t *str = (stream_t *)sdr_malloc(sizeof(stream_t));
+    sdr_str_t *str = (sdr_str_t *)sdr_malloc(sizeof(sdr_str_t));
     const char *p = strchr(path, ':');
     int stat = 0, port = 0, str_opt[] = {30000, 30000, 1000, 1<<20, 0};
     
-    strinit(str);
+    strinit(&str->str);
     strsetopt(str_opt);
     if (p == path) { // TCP server (path = :port)
-        stat = stropen(str, STR_TCPSVR, STR_MODE_W, path);
+        stat = stropen(&str->str, STR_TCPSVR, STR_MODE_W, path);
     }
-    else if (sscanf(p, ":%d", &port) == 1) { // TCP client (path = addr:port)
-        stat = stropen(str, STR_TCPCLI, STR_MODE_W, path);
+    else if (p && sscanf(p, ":%d", &port) == 1) { // TCP client (addr:port)
+        stat = stropen(&str->str, STR_TCPCLI, STR_MODE_W, path);
     }
     else { // file (path = file[::opt...])
 #ifdef WIN32
@@ -763,7 +2791,7 @@ stream_t *sdr_str_open(const char *path)
         for (q = buff; *q; q++) if (*q == '/') *q = '\\';
         path = buff;
 #endif
-        stat = stropen(str, STR_FILE, STR_MODE_W, path);
+        stat = stropen(&str->str, STR_FILE, STR_MODE_W, path);
     }
     if (!stat) {
         sdr_free(str);
@@ -772,18 +2800,474 @@ stream_t *sdr_str_open(const char *path)
     return str;
 }
 
+// output compressed IF data to stream -----------------------------------------
+static int str_out_ifz(void *arg, const uint8_t *data, int size)
+{
+    return strwrite(&((sdr_str_t *)arg)->str, (uint8_t *)data, size);
+}
+
+//------------------------------------------------------------------------------
+//  Set compressed IF data encoder to stream. The IF data written to the stream
+//  are encoded as a compressed IF data file (see sdr_ifz.c). For asynchronous
+//  write, the IF data are encoded by the writer thread and the IF data dropped
+//  by the output queue are recorded as gaps to keep the time of the IF data.
+//
+//  args:
+//      str      (IO) stream
+//      tag      (I)  tag of IF data (text)
+//      fmt      (I)  IF data format (SDR_FMT_???)
+//      chunk    (I)  size of chunk (bytes)
+//
+//  returns:
+//      status (1: OK, 0: error)
+//
+int sdr_str_ifz(sdr_str_t *str, const char *tag, int fmt, int chunk)
+{
+    if (!str || str->ifz || str->nout > 0) return 0;
+    str->ifz = sdr_ifz_new(tag, fmt, chunk, str_out_ifz, str);
+    return str->ifz != NULL;
+}
+
 // close stream ----------------------------------------------------------------
-void sdr_str_close(stream_t *str)
+//  The data in the output queue are flushed before closing stream.
+void sdr_str_close(sdr_str_t *str)
 {
     if (!str) return;
-    strclose(str);
+    if (str->buff) {
+        pthread_mutex_lock(&str->mtx);
+        str->state = 0;
+        pthread_cond_signal(&str->cond);
+        pthread_mutex_unlock(&str->mtx);
+        pthread_join(str->thread, NULL);
+        pthread_mutex_destroy(&str->mtx);
+        pthread_cond_destroy(&str->cond);
+        if (str->ndrop > 0) {
+            fprintf(stderr, "stream %s: %lld bytes dropped\n", str->str.path,
+                (long long)str->ndrop);
+        }
+        sdr_free(str->buff);
+    }
+    sdr_ifz_free(str->ifz);
+    strclose(&str->str);
+    sdr_free(str);
+}
+
+// stream writer thread --------------------------------------------------------
+//  All data in the output queue are written in a batch. The queue space is
+//  released after writing, so the data are written without copy. The data up
+//  to a gap of dropped IF data are written before skipping the gap.
+static void *str_thread(void *arg)
+{
+    sdr_str_t *str = (sdr_str_t *)arg;
+    
+    pthread_mutex_lock(&str->mtx);
+    while (str->state || str->wp > str->rp || str->ngap > 0) {
+        if (str->ngap > 0 && str->gap[0][0] == str->rp) {
+            int64_t size = str->gap[0][1];
+            memmove(str->gap, str->gap + 1, sizeof(str->gap[0]) *
+                --str->ngap);
+            pthread_mutex_unlock(&str->mtx);
+            sdr_ifz_skip(str->ifz, size);
+            pthread_mutex_lock(&str->mtx);
+            continue;
+        }
+        if (str->wp <= str->rp) {
+            pthread_cond_wait(&str->cond, &str->mtx);
+            continue;
+        }
+        int64_t rp = str->rp;
+        int i = (int)(rp % str->size);
+        int n = (int)MIN(str->wp - rp, (int64_t)(str->size - i));
+        if (str->ngap > 0) {
+            n = (int)MIN((int64_t)n, str->gap[0][0] - rp);
+        }
+        pthread_mutex_unlock(&str->mtx);
+        
+        if (str->ifz) {
+            sdr_ifz_write(str->ifz, str->buff + i, n);
+        }
+        else {
+            strwrite(&str->str, str->buff + i, n);
+        }
+        
+        pthread_mutex_lock(&str->mtx);
+        str->rp = rp + n;
+    }
+    pthread_mutex_unlock(&str->mtx);
+    return NULL;
+}
+
+//------------------------------------------------------------------------------
+//  Set asynchronous write of stream. The data written to the stream by
+//  sdr_str_write() are queued to the bounded output queue and written to the
+//  stream by a writer thread, so the callers are not blocked by slow stream
+//  devices or clients. The data are dropped if the queue is full.
+//
+//  args:
+//      str      (IO) stream
+//      size     (I)  size of output queue (bytes)
+//
+//  returns:
+//      status (1: OK, 0: error)
+//
+int sdr_str_async(sdr_str_t *str, int size)
+{
+    if (!str || str->buff || size <= 0) return 0;
+    str->buff = (uint8_t *)sdr_malloc(size);
+    str->size = size;
+    str->wp = str->rp = 0;
+    str->state = 1;
+    pthread_mutex_init(&str->mtx, NULL);
+    pthread_cond_init(&str->cond, NULL);
+    if (pthread_create(&str->thread, NULL, str_thread, str)) {
+        fprintf(stderr, "stream writer thread create error\n");
+        pthread_mutex_destroy(&str->mtx);
+        pthread_cond_destroy(&str->cond);
+        sdr_free(str->buff);
+        str->buff = NULL;
+        return 0;
+    }
+    return 1;
 }
 
 // write stream ----------------------------------------------------------------
-int sdr_str_write(stream_t *str, uint8_t *data, int size)
+//  In case of asynchronous write, the data are queued as a whole or dropped
+//  if the queue is full. The writer thread is notified only if the queue was
+//  empty, so successive writes are batched. If no more gap can be recorded,
+//  the data queued after the last gap are dropped into it, so the zero fill of
+//  the compressed IF data file is kept at the time offsets of the gaps.
+int sdr_str_write(sdr_str_t *str, const uint8_t *data, int size)
+{
+    if (!str || size <= 0) return 0;
+    if (!str->buff) {
+        str->nout += size;
+        if (str->ifz) {
+            return sdr_ifz_write(str->ifz, data, size);
+        }
+        return strwrite(&str->str, (uint8_t *)data, size);
+    }
+    pthread_mutex_lock(&str->mtx);
+    if (str->wp - str->rp + size > str->size) {
+        str->ndrop += size;
+        if (str->ifz) { // record gap of dropped IF data
+            int n = str->ngap;
+            if (n >= SDR_MAX_GAP) { // gaps full: drop queued data after last
+                int64_t m = str->wp - str->gap[n-1][0];
+                str->wp -= m;
+                str->nout -= m;
+                str->ndrop += m;
+                str->gap[n-1][1] += m;
+            }
+            if (n > 0 && str->gap[n-1][0] == str->wp) {
+                str->gap[n-1][1] += size;
+            }
+            else {
+                str->gap[n][0] = str->wp;
+                str->gap[n][1] = size;
+                str->ngap++;
+            }
+        }
+        pthread_mutex_unlock(&str->mtx);
+        return 0;
+    }
+    int i = (int)(str->wp % str->size), n = MIN(size, str->size - i);
+    memcpy(str->buff + i, data, n);
+    memcpy(str->buff, data + n, size - n);
+    if (str->wp == str->rp) {
+        pthread_cond_signal(&str->cond);
+    }
+    str->wp += size;
+    str->nout += size;
+    pthread_mutex_unlock(&str->mtx);
+    return size;
+}
+
+// parse conversion spec of log format ----------------------------------------
+//  q points the next character of '%'. The function returns the pointer to the
+//  conversion character and the number of '*' and the length modifier
+//  (0: none/h/hh, 1: l, 2: ll/j/z/t, 3: L).
+static const char *log_spec(const char *q, int *nstar, int *lng)
+{
+    *nstar = *lng = 0;
+    for ( ; *q && strchr("-+ #0123456789.*", *q); q++) {
+        if (*q == '*') (*nstar)++;
+    }
+    for ( ; *q && strchr("hljztL", *q); q++) {
+        if      (*q == 'l') (*lng)++;
+        else if (*q == 'L') *lng = 3;
+        else if (*q != 'h') *lng = 2;
+    }
+    if (*lng > 3) *lng = 2;
+    return q;
+}
+
+// pack log arguments ----------------------------------------------------------
+static int pack_log(uint8_t *p, int size, const char *fmt, va_list ap)
+{
+    int n = 0, nstar, lng;
+    
+    for (const char *q = fmt; *q; q++) {
+        if (*q != '%' || *++q == '%') continue;
+        if (!*(q = log_spec(q, &nstar, &lng))) break;
+        if (n + 8 * (nstar + 1) > size) return -1;
+        for (int i = 0; i < nstar; i++, n += 8) {
+            *(int64_t *)(p + n) = va_arg(ap, int);
+        }
+        int64_t *v = (int64_t *)(p + n);
+        double *d = (double *)(p + n);
+        n += 8;
+        switch (*q) {
+            case 'd': case 'i': case 'c':
+                *v = lng == 0 ? va_arg(ap, int) : lng == 1 ? va_arg(ap, long) :
+                    va_arg(ap, long long);
+                break;
+            case 'o': case 'u': case 'x': case 'X':
+                *v = (int64_t)(lng == 0 ? va_arg(ap, unsigned int) : lng == 1 ?
+                    va_arg(ap, unsigned long) : va_arg(ap, unsigned long long));
+                break;
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+            case 'a': case 'A':
+                *d = lng == 3 ? (double)va_arg(ap, long double) :
+                    va_arg(ap, double);
+                break;
+            case 's': {
+                const char *str = va_arg(ap, const char *);
+                int len = str ? (int)strnlen(str, MAX_LOG_STR - 1) : 0;
+                n -= 8;
+                if (n + len + 1 > size) return -1;
+                memcpy(p + n, str, len);
+                p[n+len] = '\0';
+                n += (len + 8) & ~7;
+                break;
+            }
+            default: // p, n
+                *v = (int64_t)(intptr_t)va_arg(ap, void *);
+                break;
+        }
+    }
+    return n;
+}
+
+// format log record -----------------------------------------------------------
+static int format_log(char *buff, int size, const log_rec_t *rec)
+{
+    const uint8_t *p = (const uint8_t *)(rec + 1);
+    char spec[32];
+    int n = 0, nstar, lng, m, st[2] = {0};
+    
+    for (const char *q = rec->fmt; *q && n < size - 1; ) {
+        if (*q != '%') {
+            buff[n++] = *q++;
+            continue;
+        }
+        if (q[1] == '%') {
+            buff[n++] = '%';
+            q += 2;
+            continue;
+        }
+        const char *r = log_spec(q + 1, &nstar, &lng);
+        if (!*r || r - q > 16) break;
+        
+        // conversion spec with flags, width and precision
+        for (m = 0; q < r && !strchr("hljztL", *q); q++) spec[m++] = *q;
+        for (int i = 0; i < nstar; i++, p += 8) {
+            st[i&1] = (int)*(const int64_t *)p;
+        }
+        int64_t v = *(const int64_t *)p;
+        double d = *(const double *)p;
+        const char *str = (const char *)p;
+        p += 8;
+        if (strchr("dioxXu", *r)) spec[m++] = 'l', spec[m++] = 'l';
+        spec[m++] = *r;
+        spec[m] = '\0';
+        q = r + 1;
+        
+#define LOG_OUT(x) (nstar == 0 ? snprintf(buff + n, size - n, spec, x) : \
+    nstar == 1 ? snprintf(buff + n, size - n, spec, st[0], x) : \
+    snprintf(buff + n, size - n, spec, st[0], st[1], x))
+        
+        switch (*r) {
+            case 'c':
+                m = LOG_OUT((int)v);
+                break;
+            case 'd': case 'i':
+                m = LOG_OUT((long long)v);
+                break;
+            case 'o': case 'u': case 'x': case 'X':
+                m = LOG_OUT((unsigned long long)v);
+                break;
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+            case 'a': case 'A':
+                m = LOG_OUT(d);
+                break;
+            case 's':
+                m = LOG_OUT(str);
+                p = (const uint8_t *)str + ((strlen(str) + 8) & ~7);
+                break;
+            case 'p':
+                m = LOG_OUT((void *)(intptr_t)v);
+                break;
+            default:
+                m = 0;
+                break;
+        }
+#undef LOG_OUT
+        n += MAX(0, MIN(m, size - 1 - n));
+    }
+    buff[n] = '\0';
+    return n;
+}
+
+// output formatted log --------------------------------------------------------
+static void out_log(char *buff, int len)
+{
+    if (log_str) {
+        sprintf(buff + len, "\r\n");
+        sdr_str_write(log_str, (uint8_t *)buff, len + 2);
+        buff[len] = '\0';
+    }
+    pthread_mutex_lock(&log_buff_mtx);
+    if (log_buff_p + len + 1 < MAX_LOG_BUFF) {
+        log_buff_p += sprintf(log_buff + log_buff_p, "%s\n", buff);
+    }
+    pthread_mutex_unlock(&log_buff_mtx);
+}
+
+// peek oldest log record in ring ----------------------------------------------
+static const log_rec_t *peek_log(log_ring_t *ring)
+{
+    uint64_t rp = ring->rp, wp = __atomic_load_n(&ring->wp, __ATOMIC_ACQUIRE);
+    
+    while (rp < wp) {
+        int i = (int)(rp % LOG_RING);
+        const log_rec_t *rec = (const log_rec_t *)(ring->buff + i);
+        if (LOG_RING - i < (int)sizeof(log_rec_t)) { // implicit padding
+            rp += LOG_RING - i;
+        }
+        else if (!rec->fmt) { // padding to ring end
+            rp += rec->size;
+        }
+        else {
+            break;
+        }
+        __atomic_store_n(&ring->rp, rp, __ATOMIC_RELEASE);
+    }
+    return rp < wp ? (const log_rec_t *)(ring->buff + rp % LOG_RING) : NULL;
+}
+
+// drain log records of rings in sequence order --------------------------------
+//  Called with log_wr_mtx locked.
+static void drain_log(void)
+{
+    char buff[1024];
+    
+    while (1) {
+        int nring = __atomic_load_n(&log_nring, __ATOMIC_ACQUIRE);
+        log_ring_t *ring = NULL;
+        const log_rec_t *rec = NULL;
+        for (int i = 0; i < nring; i++) {
+            const log_rec_t *r = peek_log(log_rings[i]);
+            if (r && (!rec || r->seq < rec->seq)) {
+                rec = r;
+                ring = log_rings[i];
+            }
+        }
+        if (!rec) break;
+        out_log(buff, format_log(buff, (int)sizeof(buff) - 2, rec));
+        __atomic_store_n(&ring->rp, ring->rp + rec->size, __ATOMIC_RELEASE);
+    }
+}
+
+// log writer thread -----------------------------------------------------------
+static void *log_thread(void *arg)
+{
+    while (1) {
+        pthread_mutex_lock(&log_wr_mtx);
+        drain_log();
+        pthread_mutex_unlock(&log_wr_mtx);
+        sdr_sleep_msec(LOG_CYC);
+    }
+    return NULL;
+}
+
+// release log ring at thread exit ---------------------------------------------
+static void log_ring_exit(void *arg)
+{
+    __atomic_store_n(&((log_ring_t *)arg)->used, 0, __ATOMIC_RELEASE);
+}
+
+// initialize log rings and start log writer thread ----------------------------
+static void log_init(void)
+{
+    pthread_t thread;
+    pthread_key_create(&log_key, log_ring_exit);
+    if (!pthread_create(&thread, NULL, log_thread, NULL)) {
+        pthread_detach(thread);
+    }
+}
+
+// get log ring of thread ------------------------------------------------------
+//  The ring released at thread exit is reused by a new thread after drained.
+static log_ring_t *get_log_ring(void)
+{
+    pthread_once(&log_once, log_init);
+    log_ring_t *ring = (log_ring_t *)pthread_getspecific(log_key);
+    if (ring) return ring;
+    
+    pthread_mutex_lock(&log_wr_mtx);
+    for (int i = 0; i < log_nring && !ring; i++) {
+        log_ring_t *r = log_rings[i];
+        if (!__atomic_load_n(&r->used, __ATOMIC_ACQUIRE) && r->rp == r->wp) {
+            ring = r;
+        }
+    }
+    if (!ring && log_nring < MAX_LOG_RING) {
+        ring = (log_ring_t *)sdr_malloc(sizeof(log_ring_t));
+        log_rings[log_nring] = ring;
+        __atomic_store_n(&log_nring, log_nring + 1, __ATOMIC_RELEASE);
+    }
+    if (ring) {
+        ring->used = 1;
+        pthread_setspecific(log_key, ring);
+    }
+    pthread_mutex_unlock(&log_wr_mtx);
+    return ring;
+}
+
+// put log record to ring of thread --------------------------------------------
+//  The arguments are packed in binary with the format pointer and formatted
+//  later by the log writer thread. The record is dropped if the ring is full.
+static void put_log(int level, const char *fmt, va_list ap)
 {
-    if (!str) return 0;
-    return strwrite(str, data, size);
+    uint64_t rec[128];
+    log_rec_t *hdr = (log_rec_t *)rec;
+    log_ring_t *ring = get_log_ring();
+    int n;
+    
+    if (!ring || (n = pack_log((uint8_t *)(hdr + 1), (int)(sizeof(rec) -
+        sizeof(log_rec_t)), fmt, ap)) < 0) {
+        __atomic_add_fetch(&log_ndrop, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    int size = (int)sizeof(log_rec_t) + n;
+    uint64_t wp = ring->wp, rp = __atomic_load_n(&ring->rp, __ATOMIC_ACQUIRE);
+    int i = (int)(wp % LOG_RING), pad = LOG_RING - i < size ? LOG_RING - i : 0;
+    
+    if (wp + pad + size - rp > LOG_RING) {
+        __atomic_add_fetch(&log_ndrop, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    if (pad >= (int)sizeof(log_rec_t)) {
+        log_rec_t *p = (log_rec_t *)(ring->buff + i);
+        p->size = pad;
+        p->fmt = NULL;
+    }
+    hdr->size = size;
+    hdr->level = level;
+    hdr->seq = __atomic_fetch_add(&log_seq, 1, __ATOMIC_RELAXED);
+    hdr->fmt = fmt;
+    memcpy(ring->buff + (wp + pad) % LOG_RING, rec, size);
+    __atomic_store_n(&ring->wp, wp + pad + size, __ATOMIC_RELEASE);
 }
 
 // open log --------------------------------------------------------------------
@@ -791,18 +3275,30 @@ int sdr_log_open(const char *path)
 {
     if (!*path || log_str) return 0;
     
-    if (!(log_str = sdr_str_open(path))) {
+    sdr_str_t *str = sdr_str_open(path);
+    if (!str) {
         fprintf(stderr, "log stream open error %s\n", path);
         return 0;
     }
+    pthread_mutex_lock(&log_wr_mtx);
+    log_str = str;
+    pthread_mutex_unlock(&log_wr_mtx);
     return 1;
 }
 
 // close log -------------------------------------------------------------------
+//  The log records in the rings are flushed before closing log stream.
 void sdr_log_close(void)
 {
+    pthread_mutex_lock(&log_wr_mtx);
+    drain_log();
     sdr_str_close(log_str);
     log_str = NULL;
+    pthread_mutex_unlock(&log_wr_mtx);
+    if (log_ndrop > 0) {
+        fprintf(stderr, "log: %lld records dropped\n", (long long)log_ndrop);
+        log_ndrop = 0;
+    }
 }
 
 // set log level ---------------------------------------------------------------
@@ -812,28 +3308,20 @@ void sdr_log_level(int level)
 }
 
 // output log ------------------------------------------------------------------
+//  The log is written to the lock-free ring of the caller thread and output to
+//  the log stream and the log buffer by the log writer thread.
 void sdr_log(int level, const char *msg, ...)
 {
     va_list ap;
     
-    va_start(ap, msg);
+    if (log_lvl != 0 && level > log_lvl) return;
     
+    va_start(ap, msg);
     if (log_lvl == 0) {
         vprintf(msg, ap);
     }
-    else if (level <= log_lvl) {
-        char buff[1024];
-        int len = vsnprintf(buff, sizeof(buff) - 2, msg, ap);
-        len = MIN(len, (int)sizeof(buff) - 3);
-        if (log_str) {
-            sprintf(buff + len, "\r\n");
-            strwrite(log_str, (uint8_t *)buff, len + 2);
-        }
-        pthread_mutex_lock(&log_buff_mtx);
-        if (log_buff_p + len + 1 < MAX_LOG_BUFF) {
-            log_buff_p += sprintf(log_buff + log_buff_p, "%s\n", buff);
-        }
-        pthread_mutex_unlock(&log_buff_mtx);
+    else {
+        put_log(level, msg, ap);
     }
     va_end(ap);
 }
@@ -841,6 +3329,10 @@ void sdr_log(int level, const char *msg, ...)
 // get log buffer --------------------------------------------------------------
 int sdr_get_log(char *buff, int size)
 {
+    pthread_mutex_lock(&log_wr_mtx);
+    drain_log();
+    pthread_mutex_unlock(&log_wr_mtx);
+    
     pthread_mutex_lock(&log_buff_mtx);
     int out_size = snprintf(buff, size, "%s", log_buff);
     log_buff[0] = '\0';
@@ -849,6 +3341,156 @@ int sdr_get_log(char *buff, int size)
     return out_size <= size ? out_size : size;
 }
 
+// timeline tracing ------------------------------------------------------------
+//  The spans (begin and end time) of the receiver pipeline are recorded to the
+//  lock-free trace ring of the caller thread, which keeps the latest spans,
+//  and dumped as a Chrome trace JSON file (Trace Event Format) to be viewed by
+//  Perfetto UI or chrome://tracing. The span records are written only while
+//  tracing, so the overhead w/o tracing is a flag check.
+
+// time of trace (ns) ----------------------------------------------------------
+static int64_t trace_time(void)
+{
+    return (int64_t)(sdr_get_clock() * 1e9);
+}
+
+// release trace ring at thread exit -------------------------------------------
+static void trace_ring_exit(void *arg)
+{
+    __atomic_store_n(&((trace_ring_t *)arg)->used, 0, __ATOMIC_RELEASE);
+}
+
+// initialize trace rings ------------------------------------------------------
+static void trace_init(void)
+{
+    pthread_key_create(&trace_key, trace_ring_exit);
+}
+
+// get trace ring of thread (alloc: allocate ring buffer) ----------------------
+//  The ring released at thread exit is reused by a new thread with a new
+//  thread ID.
+static trace_ring_t *get_trace_ring(int alloc)
+{
+    pthread_once(&trace_once, trace_init);
+    trace_ring_t *ring = (trace_ring_t *)pthread_getspecific(trace_key);
+    if (ring && (ring->ev || !alloc)) return ring;
+    
+    pthread_mutex_lock(&trace_mtx);
+    for (int i = 0; i < trace_nring && !ring; i++) {
+        if (!__atomic_load_n(&trace_rings[i]->used, __ATOMIC_ACQUIRE)) {
+            ring = trace_rings[i];
+        }
+    }
+    if (!ring && trace_nring < MAX_TRACE_RING) {
+        ring = (trace_ring_t *)sdr_malloc(sizeof(trace_ring_t));
+        trace_rings[trace_nring++] = ring;
+    }
+    if (ring && !ring->used) {
+        ring->tid = ++trace_ntid;
+        ring->name[0] = '\0';
+        ring->wp = 0;
+        ring->used = 1;
+        pthread_setspecific(trace_key, ring);
+    }
+    if (ring && alloc && !ring->ev) {
+        ring->ev = (trace_ev_t *)sdr_malloc(sizeof(trace_ev_t) * trace_nev);
+        ring->nev = trace_nev;
+    }
+    pthread_mutex_unlock(&trace_mtx);
+    return ring;
+}
+
+// start tracing (nev: size of trace rings (spans), 0: default) ----------------
+//  The size is applied to the trace rings allocated after the first start.
+void sdr_trace_start(int nev)
+{
+    pthread_mutex_lock(&trace_mtx);
+    if (trace_nring == 0 && nev > 0) {
+        trace_nev = nev;
+    }
+    trace_t0 = trace_time();
+    pthread_mutex_unlock(&trace_mtx);
+    __atomic_store_n(&trace_on, 1, __ATOMIC_RELEASE);
+}
+
+// stop tracing ----------------------------------------------------------------
+void sdr_trace_stop(void)
+{
+    __atomic_store_n(&trace_on, 0, __ATOMIC_RELEASE);
+}
+
+// begin time of span (0: not tracing) -----------------------------------------
+int64_t sdr_trace_begin(void)
+{
+    return __atomic_load_n(&trace_on, __ATOMIC_RELAXED) ? trace_time() : 0;
+}
+
+// end span of category and name (static strings) with begin time -------------
+void sdr_trace_end(const char *cat, const char *name, int64_t arg, int64_t t0)
+{
+    trace_ring_t *ring;
+    
+    if (t0 <= 0 || !(ring = get_trace_ring(1))) return;
+    uint64_t wp = ring->wp;
+    trace_ev_t *ev = ring->ev + wp % ring->nev;
+    ev->cat = cat;
+    ev->name = name;
+    ev->arg = arg;
+    ev->t0 = t0;
+    ev->t1 = trace_time();
+    __atomic_store_n(&ring->wp, wp + 1, __ATOMIC_RELEASE);
+}
+
+// set thread name in trace ----------------------------------------------------
+void sdr_trace_name(const char *name)
+{
+    trace_ring_t *ring = get_trace_ring(0);
+    if (ring) {
+        snprintf(ring->name, sizeof(ring->name), "%s", name);
+    }
+}
+
+// dump trace as Chrome trace JSON file ----------------------------------------
+//  It can be called while tracing. The spans overwritten during the dump may
+//  be inconsistent. It returns the status (1:OK,0:file open error).
+int sdr_trace_dump(const char *file)
+{
+    FILE *fp;
+    int n = 0;
+    
+    if (!(fp = fopen(file, "w"))) {
+        fprintf(stderr, "trace file open error %s\n", file);
+        return 0;
+    }
+    fprintf(fp, "{\"traceEvents\":[\n");
+    fprintf(fp, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+        "\"args\":{\"name\":\"%s\"}}", SDR_DEV_NAME);
+    pthread_mutex_lock(&trace_mtx);
+    for (int i = 0; i < trace_nring; i++) {
+        trace_ring_t *ring = trace_rings[i];
+        uint64_t wp = __atomic_load_n(&ring->wp, __ATOMIC_ACQUIRE);
+        fprintf(fp, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+            "\"tid\":%d,\"args\":{\"name\":\"%s-%d\"}}", ring->tid,
+            *ring->name ? ring->name : "thread", ring->tid);
+        if (!ring->ev) continue;
+        for (uint64_t j = wp > (uint64_t)ring->nev ? wp - ring->nev : 0;
+            j < wp; j++) {
+            const trace_ev_t *ev = ring->ev + j % ring->nev;
+            if (ev->t0 < trace_t0 || ev->t1 < ev->t0) continue;
+            fprintf(fp, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\","
+                "\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,"
+                "\"args\":{\"arg\":%lld}}", ev->name, ev->cat, ring->tid,
+                (ev->t0 - trace_t0) * 1e-3, (ev->t1 - ev->t0) * 1e-3,
+                (long long)ev->arg);
+            n++;
+        }
+    }
+    pthread_mutex_unlock(&trace_mtx);
+    fprintf(fp, "\n],\"displayTimeUnit\":\"ms\"}\n");
+    fclose(fp);
+    return 1;
+}
+
 // parse numbers list and range ------------------------------------------------
 int sdr_parse_nums(const char *str, int *prns)
 {
@@ -881,6 +3523,76 @@ void sdr_add_buff(void *buff, int len_buff, void *item, size_t size_item)
     memcpy((uint8_t *)buff + size_item * (len_buff - 1), item, size_item);
 }
 
+//------------------------------------------------------------------------------
+//  Generate a new history buffer. The history buffer is a ring buffer with
+//  mirrored storage, so the last len items are always accessed as a contiguous
+//  array by sdr_hist_data() and adding an item is O(1) for any length.
+//
+//  args:
+//      len      (I)  Length of history (items)
+//      size     (I)  Size of item (bytes)
+//
+//  return:
+//      History buffer
+//
+sdr_hist_t *sdr_hist_new(int len, int size)
+{
+    sdr_hist_t *hist = (sdr_hist_t *)sdr_malloc(sizeof(sdr_hist_t));
+    hist->data = (uint8_t *)sdr_malloc((size_t)size * len * 2);
+    hist->len = len;
+    hist->size = size;
+    hist->p = 0;
+    return hist;
+}
+
+// free history buffer ---------------------------------------------------------
+void sdr_hist_free(sdr_hist_t *hist)
+{
+    if (!hist) return;
+    sdr_free(hist->data);
+    sdr_free(hist);
+}
+
+// clear history buffer --------------------------------------------------------
+void sdr_hist_clear(sdr_hist_t *hist)
+{
+    memset(hist->data, 0, (size_t)hist->size * hist->len * 2);
+    hist->p = 0;
+}
+
+// add item to history buffer (drop oldest item) -------------------------------
+void sdr_hist_add(sdr_hist_t *hist, const void *item)
+{
+    uint8_t *p = hist->data + (size_t)hist->size * hist->p;
+    memcpy(p, item, hist->size);
+    memcpy(p + (size_t)hist->size * hist->len, p, hist->size);
+    hist->p = (hist->p + 1) % hist->len;
+}
+
+// step back history buffer (drop newest item and duplicate oldest item) -------
+void sdr_hist_back(sdr_hist_t *hist)
+{
+    uint8_t *p0 = hist->data + (size_t)hist->size * hist->p;
+    hist->p = (hist->p + hist->len - 1) % hist->len;
+    uint8_t *p = hist->data + (size_t)hist->size * hist->p;
+    memcpy(p, p0, hist->size);
+    memcpy(p + (size_t)hist->size * hist->len, p, hist->size);
+}
+
+// set item in history buffer (i = 0: oldest, ..., len - 1: newest) ------------
+void sdr_hist_set(sdr_hist_t *hist, int i, const void *item)
+{
+    uint8_t *p = hist->data + (size_t)hist->size * ((hist->p + i) % hist->len);
+    memcpy(p, item, hist->size);
+    memcpy(p + (size_t)hist->size * hist->len, p, hist->size);
+}
+
+// history buffer data (oldest to newest, len items) ---------------------------
+void *sdr_hist_data(const sdr_hist_t *hist)
+{
+    return hist->data + (size_t)hist->size * hist->p;
+}
+
 // pack bit array to uint8_t array ---------------------------------------------
 void sdr_pack_bits(const uint8_t *data, int nbit, int nz, uint8_t *buff)
 {
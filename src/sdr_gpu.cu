@@ -0,0 +1,282 @@
+//
+//  Pocket SDR C Library - GPU Backend Functions for Signal Acquisition.
+//
+//  The GPU backend offloads the FFT correlations of the parallel code search
+//  (see sdr_search_code()) to a CUDA device with cuFFT. An IF data block is
+//  uploaded once, mixed with the carriers of the base Doppler frequencies and
+//  transformed by a batched FFT. The spectra are shared by all codes and all
+//  Doppler frequencies with integer FFT bin offsets from the base frequencies
+//  as the CPU path. The correlations of all Doppler frequencies of a code are
+//  computed by a batched inverse FFT and the correlation powers are returned
+//  to the host, so the peaks are searched by sdr_corr_max() and
+//  sdr_fine_dop() as the CPU path.
+//
+//  The backend is built with the option -DCUDA by nvcc and linked with
+//  -lcudart -lcufft. The device memory is allocated by cudaMallocManaged(),
+//  so no explicit copy is made between the host and the device memory on the
+//  devices with the memory shared by CPU and GPU (e.g. NVIDIA Jetson).
+//
+//  Author:
+//  T.TAKASU
+//
+//  History:
+//  2026-10-15  1.0  new
+//
+#include <cuda_runtime.h>
+#include <cufft.h>
+#include "pocket_sdr.h"
+
+// constants -------------------------------------------------------------------
+#define NTHREAD     256         // number of threads of a thread block
+
+#define MAX(x, y)   ((x) > (y) ? (x) : (y))
+
+// type definitions ------------------------------------------------------------
+typedef struct {                // GPU context type
+    int dev;                    // CUDA device number
+    int N, nb, M;               // FFT size, number of base Doppler frequencies
+                                // and number of Doppler frequencies
+    int nb_plan, M_plan;        // batch sizes of cuFFT plans
+    cufftHandle plan[2];        // cuFFT plans {forward, inverse}
+    uint8_t *data;              // IF data block (N)
+    uint32_t *step;             // carrier phase steps of base Doppler freq (nb)
+    int *idx;                   // base Doppler index and FFT bin offsets (M x 2)
+    cufftComplex *X;            // spectra of IF data (nb x N)
+    cufftComplex *code;         // code DFT (N)
+    cufftComplex *C;            // correlations (M x N)
+    float *P;                   // correlation powers (M x N)
+} gpu_t;
+
+// global variables ------------------------------------------------------------
+static gpu_t *gpu = NULL;       // GPU context
+
+// check CUDA error ------------------------------------------------------------
+static int chk_cuda(cudaError_t err, const char *func)
+{
+    if (err == cudaSuccess) return 1;
+    fprintf(stderr, "sdr_gpu: %s error (%s)\n", func, cudaGetErrorString(err));
+    return 0;
+}
+
+// check cuFFT error -----------------------------------------------------------
+static int chk_cufft(cufftResult err, const char *func)
+{
+    if (err == CUFFT_SUCCESS) return 1;
+    fprintf(stderr, "sdr_gpu: %s error (%d)\n", func, (int)err);
+    return 0;
+}
+
+// mix IF data with carriers of base Doppler frequencies -----------------------
+__global__ static void mix_kern(const uint8_t *data, int N,
+    const uint32_t *step, cufftComplex *X)
+{
+    int i = blockIdx.x * blockDim.x + threadIdx.x, b = blockIdx.y;
+    if (i >= N) return;
+    
+    uint32_t p = step[b] * (uint32_t)i; // carrier phase (2^-32 cyc)
+    float I = (float)SDR_CPX8_I(data[i]), Q = (float)SDR_CPX8_Q(data[i]);
+    float s, c;
+    sincospif((float)p * (2.0f / 4294967296.0f), &s, &c);
+    X[(size_t)b * N + i] = make_cuFloatComplex(I * c + Q * s, Q * c - I * s);
+}
+
+// multiply shifted spectra of IF data and code DFT ----------------------------
+__global__ static void mul_kern(const cufftComplex *X, const cufftComplex *code,
+    const int *idx, int N, float scale, cufftComplex *C)
+{
+    int i = blockIdx.x * blockDim.x + threadIdx.x, j = blockIdx.y;
+    if (i >= N) return;
+    
+    int k = i + idx[j*2+1];
+    cufftComplex x = X[(size_t)idx[j*2] * N + (k < N ? k : k - N)];
+    cufftComplex y = code[i];
+    C[(size_t)j * N + i] = make_cuFloatComplex((x.x * y.x - x.y * y.y) * scale,
+        (x.x * y.y + x.y * y.x) * scale);
+}
+
+// correlation powers ----------------------------------------------------------
+__global__ static void pow_kern(const cufftComplex *C, int N, float *P)
+{
+    int i = blockIdx.x * blockDim.x + threadIdx.x, j = blockIdx.y;
+    if (i >= N) return;
+    
+    cufftComplex c = C[(size_t)j * N + i];
+    P[(size_t)j * N + i] = c.x * c.x + c.y * c.y;
+}
+
+// free device memory ----------------------------------------------------------
+static void free_mem(gpu_t *g, int data)
+{
+    if (data) {
+        cudaFree(g->data); cudaFree(g->step); cudaFree(g->X); cudaFree(g->code);
+        g->data = NULL; g->step = NULL; g->X = NULL; g->code = NULL;
+        g->N = g->nb = 0;
+    }
+    cudaFree(g->idx); cudaFree(g->C); cudaFree(g->P);
+    g->idx = NULL; g->C = NULL; g->P = NULL;
+    g->M = 0;
+}
+
+// destroy cuFFT plans ---------------------------------------------------------
+static void free_plan(gpu_t *g, int i)
+{
+    int *n = i == 0 ? &g->nb_plan : &g->M_plan;
+    if (*n > 0) cufftDestroy(g->plan[i]);
+    *n = 0;
+}
+
+// update cuFFT plan for FFT size and batch size -------------------------------
+static int update_plan(gpu_t *g, int i, int N, int batch)
+{
+    int *n = i == 0 ? &g->nb_plan : &g->M_plan;
+    if (*n == batch && g->N == N) return 1;
+    free_plan(g, i);
+    if (!chk_cufft(cufftPlan1d(g->plan + i, N, CUFFT_C2C, batch),
+        "cufftPlan1d")) return 0;
+    *n = batch;
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//  Open GPU backend for signal acquisition.
+//
+//  args:
+//      dev      (I)  CUDA device number
+//
+//  return:
+//      Status (1: OK, 0: error or no CUDA device)
+//
+int sdr_gpu_open(int dev)
+{
+    int ndev = 0;
+    
+    if (gpu) return 1;
+    if (cudaGetDeviceCount(&ndev) != cudaSuccess || dev < 0 || dev >= ndev) {
+        fprintf(stderr, "sdr_gpu: no CUDA device dev=%d\n", dev);
+        return 0;
+    }
+    if (!chk_cuda(cudaSetDevice(dev), "cudaSetDevice")) return 0;
+    gpu = (gpu_t *)sdr_malloc(sizeof(gpu_t));
+    gpu->dev = dev;
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//  Close GPU backend for signal acquisition.
+//
+//  args:
+//      none
+//
+//  return:
+//      none
+//
+void sdr_gpu_close(void)
+{
+    if (!gpu) return;
+    free_plan(gpu, 0);
+    free_plan(gpu, 1);
+    free_mem(gpu, 1);
+    sdr_free(gpu);
+    gpu = NULL;
+}
+
+//------------------------------------------------------------------------------
+//  Upload IF data block to GPU, mix it with the carriers of the base Doppler
+//  frequencies and transform it by FFT. The spectra are kept in the device
+//  memory for the following sdr_gpu_corr().
+//
+//  args:
+//      data     (I)  IF data block (unpacked, N samples)
+//      N        (I)  FFT size (number of samples)
+//      fc       (I)  Carrier frequencies of base Doppler frequencies
+//                    (cyc/sample) (nb)
+//      nb       (I)  Number of base Doppler frequencies
+//
+//  return:
+//      Status (1: OK, 0: error)
+//
+int sdr_gpu_data(const sdr_cpx8_t *data, int N, const double *fc, int nb)
+{
+    if (!gpu) return 0;
+    cudaSetDevice(gpu->dev);
+    
+    if (N != gpu->N || nb > gpu->nb) {
+        free_mem(gpu, 1);
+        if (!chk_cuda(cudaMallocManaged(&gpu->data, N), "cudaMallocManaged") ||
+            !chk_cuda(cudaMallocManaged(&gpu->step, sizeof(uint32_t) * nb),
+            "cudaMallocManaged") ||
+            !chk_cuda(cudaMallocManaged(&gpu->X, sizeof(cufftComplex) * N * nb),
+            "cudaMallocManaged") ||
+            !chk_cuda(cudaMallocManaged(&gpu->code, sizeof(cufftComplex) * N),
+            "cudaMallocManaged")) {
+            free_mem(gpu, 1);
+            return 0;
+        }
+        free_plan(gpu, 1); // FFT size changed
+    }
+    if (!update_plan(gpu, 0, N, nb)) return 0;
+    gpu->N = N;
+    gpu->nb = MAX(gpu->nb, nb);
+    memcpy(gpu->data, data, N);
+    for (int i = 0; i < nb; i++) {
+        gpu->step[i] = (uint32_t)(int64_t)floor(fc[i] * 4294967296.0 + 0.5);
+    }
+    dim3 grid((N + NTHREAD - 1) / NTHREAD, nb);
+    mix_kern<<<grid, NTHREAD>>>(gpu->data, N, gpu->step, gpu->X);
+    
+    return chk_cufft(cufftExecC2C(gpu->plan[0], gpu->X, gpu->X, CUFFT_FORWARD),
+        "cufftExecC2C") && chk_cuda(cudaDeviceSynchronize(),
+        "cudaDeviceSynchronize");
+}
+
+//------------------------------------------------------------------------------
+//  Compute correlation powers of a code for Doppler frequencies by GPU with
+//  the spectra of IF data by sdr_gpu_data().
+//
+//  args:
+//      code_fft (I)  Code DFT as complex array (N)
+//      idx      (I)  Base Doppler frequency index and FFT bin offset (0 to N-1)
+//                    for each Doppler frequency (M x 2)
+//      M        (I)  Number of Doppler frequencies
+//      P        (O)  Correlation powers in the Doppler frequencies - Code
+//                    offset space as float 2D-array (N x M)
+//
+//  return:
+//      Status (1: OK, 0: error)
+//
+int sdr_gpu_corr(const sdr_cpx_t *code_fft, const int *idx, int M, float *P)
+{
+    int N;
+    
+    if (!gpu || (N = gpu->N) <= 0) return 0;
+    cudaSetDevice(gpu->dev);
+    
+    if (M > gpu->M) {
+        free_mem(gpu, 0);
+        if (!chk_cuda(cudaMallocManaged(&gpu->idx, sizeof(int) * M * 2),
+            "cudaMallocManaged") ||
+            !chk_cuda(cudaMallocManaged(&gpu->C, sizeof(cufftComplex) * N * M),
+            "cudaMallocManaged") ||
+            !chk_cuda(cudaMallocManaged(&gpu->P, sizeof(float) * N * M),
+            "cudaMallocManaged")) {
+            free_mem(gpu, 0);
+            return 0;
+        }
+        gpu->M = M;
+    }
+    if (!update_plan(gpu, 1, N, M)) return 0;
+    memcpy(gpu->code, code_fft, sizeof(cufftComplex) * N);
+    memcpy(gpu->idx, idx, sizeof(int) * M * 2);
+    
+    // ifft(shift(fft(data), m) * code_fft) / N^2
+    dim3 grid((N + NTHREAD - 1) / NTHREAD, M);
+    mul_kern<<<grid, NTHREAD>>>(gpu->X, gpu->code, gpu->idx, N,
+        1.0f / N / N, gpu->C);
+    if (!chk_cufft(cufftExecC2C(gpu->plan[1], gpu->C, gpu->C, CUFFT_INVERSE),
+        "cufftExecC2C")) return 0;
+    pow_kern<<<grid, NTHREAD>>>(gpu->C, N, gpu->P);
+    
+    if (!chk_cuda(cudaDeviceSynchronize(), "cudaDeviceSynchronize")) return 0;
+    memcpy(P, gpu->P, sizeof(float) * N * M);
+    return 1;
+}
@@ -0,0 +1,852 @@
+//
+//  Pocket SDR C Library - Compressed IF Data File Functions.
+//
+//  The compressed IF data file is a chunked container of IF data. The IF data
+//  are split into chunks of a fixed size (100 ms by default) and each chunk is
+//  losslessly compressed by an order-0 rANS (range asymmetric numeral system)
+//  entropy coder per byte lane (byte position in a sample). The 2 bits sample
+//  codes in raw or int8 IF data have a few symbols only, so the entropy coder
+//  removes the redundancy of the unused bits and levels. A chunk is stored
+//  without compression if the compression does not reduce the size.
+//
+//  file format (integers in little-endian):
+//
+//    header : "PSDRIFZ1" (8), chunk size (bytes) (4), byte lanes (4),
+//             tag length (4), tag (text as same as the tag file)
+//    chunk  : "IFZC" (4), seq (4), raw size (4), payload size (4),
+//             method (1) (0:stored,1:rANS), byte lanes (1), reserved (2),
+//             payload
+//    index  : entries {file offset of chunk (8), seq (4), raw size (4)} ...,
+//             number of entries (4), file offset of index (8), "IFZE" (4)
+//
+//  The index is written at the end of file. If the index does not exist (e.g.
+//  capture interrupted), the chunks are scanned to rebuild the index. The IF
+//  data of lost chunks (e.g. dropped by an output queue) are read as 0.
+//
+//  A plain IF data file is memory-mapped for reads if possible. The reads and
+//  views of the mapped IF data advise the kernel to read ahead the window
+//  after the read position and to release the pages before the window, so
+//  the IF data of a large file are not resident in memory as a whole.
+//
+//  Author:
+//  T.TAKASU
+//
+//  History:
+//  2026-10-15  1.0  new
+//  2026-10-15  1.1  memory-map plain IF data file
+//                   add API sdr_iff_view(), sdr_iff_get()
+//
+#include "pocket_sdr.h"
+#ifndef WIN32
+#include <sys/mman.h>
+#endif
+
+// constants and macros --------------------------------------------------------
+#define IFZ_MAGIC      "PSDRIFZ1" // magic of compressed IF data file
+#define IFZ_HEAD       20       // size of file header w/o tag (bytes)
+#define IFZ_CHUNK_HEAD 20       // size of chunk header (bytes)
+#define IFZ_IDX_SIZE   16       // size of index entry (bytes)
+#define IFZ_TAIL       16       // size of index tail (bytes)
+#define RANS_BITS      12       // rANS: bits of probability scale
+#define RANS_M         (1 << RANS_BITS) // rANS: probability scale
+#define RANS_L         (1u << 23) // rANS: lower bound of state
+#define RANS_HEAD      (256 * 2 + 4) // rANS: size of lane header (bytes)
+#define MAX_SEQ        0x7FFFFFF0 // max chunk sequence number
+#define MAP_AHEAD      ((int64_t)1 << 24) // read-ahead window of mapped file (bytes)
+#define MAP_PAGE       ((int64_t)1 << 16) // alignment of advised ranges (bytes)
+#define GET_BLK        65536    // block size to get IF data (bytes)
+
+#define MIN(x, y)      ((x) < (y) ? (x) : (y))
+#define MAX(x, y)      ((x) > (y) ? (x) : (y))
+
+#ifdef WIN32
+#define fseek64(fp, off) _fseeki64(fp, off, SEEK_SET)
+#define ftell64(fp)    _ftelli64(fp)
+#else
+#define fseek64(fp, off) fseeko(fp, (off_t)(off), SEEK_SET)
+#define ftell64(fp)    ((int64_t)ftello(fp))
+#endif
+
+// get and set little-endian integers ------------------------------------------
+static uint32_t get_u4(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static int64_t get_u8(const uint8_t *p)
+{
+    return (int64_t)(get_u4(p) | ((uint64_t)get_u4(p + 4) << 32));
+}
+
+static void set_u4(uint8_t *p, uint32_t val)
+{
+    p[0] = (uint8_t)val;
+    p[1] = (uint8_t)(val >> 8);
+    p[2] = (uint8_t)(val >> 16);
+    p[3] = (uint8_t)(val >> 24);
+}
+
+static void set_u8(uint8_t *p, int64_t val)
+{
+    set_u4(p, (uint32_t)val);
+    set_u4(p + 4, (uint32_t)((uint64_t)val >> 32));
+}
+
+// byte lanes of IF data format ------------------------------------------------
+static int fmt_lanes(int fmt)
+{
+    return (fmt == SDR_FMT_INT8X2 || fmt == SDR_FMT_RAW16 ||
+        fmt == SDR_FMT_RAW16I) ? 2 : 1;
+}
+
+// normalize symbol frequencies to rANS probability scale ----------------------
+static int norm_freq(const uint32_t *cnt, int n, uint16_t *freq)
+{
+    int sum = 0, imax = 0;
+    
+    for (int i = 0; i < 256; i++) {
+        freq[i] = cnt[i] ? (uint16_t)MAX(1, (int)((uint64_t)cnt[i] * RANS_M /
+            n)) : 0;
+        sum += freq[i];
+        if (cnt[i] > cnt[imax]) imax = i;
+    }
+    if (freq[imax] + RANS_M - sum < 1) return 0;
+    freq[imax] = (uint16_t)(freq[imax] + RANS_M - sum);
+    return 1;
+}
+
+// encode byte lane by rANS ----------------------------------------------------
+//  The symbols are encoded in reverse order from the end of the output buffer
+//  and moved after the lane header. It returns -1 if the output exceeds size.
+static int enc_lane(const uint8_t *data, int n, int step, uint8_t *out,
+    int size)
+{
+    uint32_t cnt[256] = {0}, start[256], x = RANS_L;
+    uint16_t freq[256];
+    
+    if (n <= 0) return 0;
+    if (size < RANS_HEAD + 4) return -1;
+    
+    for (int i = 0; i < n; i++) {
+        cnt[data[i * step]]++;
+    }
+    if (!norm_freq(cnt, n, freq)) return -1;
+    
+    for (int i = 0, s = 0; i < 256; s += freq[i++]) {
+        start[i] = s;
+    }
+    uint8_t *p = out + size, *lim = out + RANS_HEAD + 4;
+    
+    for (int i = n - 1; i >= 0; i--) {
+        uint8_t s = data[i * step];
+        uint32_t f = freq[s], x_max = ((RANS_L >> RANS_BITS) << 8) * f;
+        while (x >= x_max) {
+            if (p <= lim) return -1;
+            *--p = (uint8_t)x;
+            x >>= 8;
+        }
+        x = ((x / f) << RANS_BITS) + (x % f) + start[s];
+    }
+    p -= 4;
+    set_u4(p, x);
+    int len = (int)(out + size - p);
+    for (int i = 0; i < 256; i++) {
+        out[i*2] = (uint8_t)freq[i];
+        out[i*2+1] = (uint8_t)(freq[i] >> 8);
+    }
+    set_u4(out + 512, len);
+    memmove(out + RANS_HEAD, p, len);
+    return RANS_HEAD + len;
+}
+
+// decode byte lane by rANS ----------------------------------------------------
+static int dec_lane(const uint8_t *in, int size, uint8_t *data, int n,
+    int step)
+{
+    uint32_t start[256], sum = 0;
+    uint16_t freq[256];
+    uint8_t sym[RANS_M];
+    
+    if (n <= 0) return 0;
+    if (size < RANS_HEAD) return -1;
+    
+    for (int i = 0; i < 256; i++) {
+        freq[i] = in[i*2] | (in[i*2+1] << 8);
+        start[i] = sum;
+        if ((sum += freq[i]) > RANS_M) return -1;
+        memset(sym + start[i], i, freq[i]);
+    }
+    int len = (int)get_u4(in + 512);
+    if (sum != RANS_M || len < 4 || len > size - RANS_HEAD) return -1;
+    
+    const uint8_t *p = in + RANS_HEAD, *end = p + len;
+    uint32_t x = get_u4(p);
+    p += 4;
+    
+    for (int i = 0; i < n; i++) {
+        uint32_t m = x & (RANS_M - 1);
+        uint8_t s = sym[m];
+        data[i * step] = s;
+        x = freq[s] * (x >> RANS_BITS) + m - start[s];
+        while (x < RANS_L && p < end) {
+            x = (x << 8) | *p++;
+        }
+    }
+    return RANS_HEAD + len;
+}
+
+// encode chunk ----------------------------------------------------------------
+//  The output buffer shall have IFZ_CHUNK_HEAD + len bytes.
+static int enc_chunk(const uint8_t *data, int len, int lanes, uint32_t seq,
+    uint8_t *out)
+{
+    int n = IFZ_CHUNK_HEAD, method = 1;
+    
+    for (int i = 0; i < lanes && method; i++) {
+        int m = enc_lane(data + i, (len - i + lanes - 1) / lanes, lanes,
+            out + n, IFZ_CHUNK_HEAD + len - n);
+        if (m < 0) method = 0; else n += m;
+    }
+    if (!method) { // stored
+        memcpy(out + IFZ_CHUNK_HEAD, data, len);
+        n = IFZ_CHUNK_HEAD + len;
+    }
+    memcpy(out, "IFZC", 4);
+    set_u4(out + 4, seq);
+    set_u4(out + 8, len);
+    set_u4(out + 12, n - IFZ_CHUNK_HEAD);
+    out[16] = (uint8_t)method;
+    out[17] = (uint8_t)lanes;
+    out[18] = out[19] = 0;
+    return n;
+}
+
+// decode chunk payload --------------------------------------------------------
+static int dec_chunk(const uint8_t *in, int size, int method, int lanes,
+    uint8_t *data, int len)
+{
+    if (method == 0) { // stored
+        if (size != len) return 0;
+        memcpy(data, in, len);
+        return 1;
+    }
+    for (int i = 0, n = 0; i < lanes; i++) {
+        int m = dec_lane(in + n, size - n, data + i,
+            (len - i + lanes - 1) / lanes, lanes);
+        if (m < 0) return 0;
+        n += m;
+    }
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//  Generate a new compressed IF data encoder. The file header is output at the
+//  generation. An encoded chunk is output by a call of the output function, so
+//  a chunk dropped by an output queue is recorded as a lost chunk.
+//
+//  args:
+//      tag      (I)  tag of IF data as same as the tag file (text)
+//      fmt      (I)  IF data format (SDR_FMT_???)
+//      chunk    (I)  size of chunk (bytes)
+//      write    (I)  output function (returns output size)
+//      arg      (I)  argument of output function
+//
+//  return:
+//      compressed IF data encoder (NULL: error)
+//
+sdr_ifz_t *sdr_ifz_new(const char *tag, int fmt, int chunk,
+    int (*write)(void *, const uint8_t *, int), void *arg)
+{
+    int len = (int)strlen(tag), lanes = fmt_lanes(fmt);
+    
+    if (chunk < lanes || len >= SDR_MAX_TAG) return NULL;
+    
+    sdr_ifz_t *z = (sdr_ifz_t *)sdr_malloc(sizeof(sdr_ifz_t));
+    z->lanes = lanes;
+    z->chunk = chunk / lanes * lanes;
+    z->buff = (uint8_t *)sdr_malloc(z->chunk);
+    z->out = (uint8_t *)sdr_malloc(IFZ_CHUNK_HEAD + z->chunk);
+    z->write = write;
+    z->arg = arg;
+    
+    uint8_t head[IFZ_HEAD + SDR_MAX_TAG];
+    memcpy(head, IFZ_MAGIC, 8);
+    set_u4(head + 8, z->chunk);
+    set_u4(head + 12, z->lanes);
+    set_u4(head + 16, len);
+    memcpy(head + IFZ_HEAD, tag, len);
+    z->pos = z->write(z->arg, head, IFZ_HEAD + len);
+    return z;
+}
+
+// output chunk ----------------------------------------------------------------
+static void out_chunk(sdr_ifz_t *z)
+{
+    int n = enc_chunk(z->buff, z->len, z->lanes, z->seq, z->out);
+    int m = z->write(z->arg, z->out, n);
+    
+    if (m == n) { // add index entry
+        if (z->nidx >= z->nmax) {
+            z->nmax = MAX(z->nmax * 2, 1024);
+            uint8_t *idx = (uint8_t *)sdr_malloc(z->nmax * IFZ_IDX_SIZE);
+            memcpy(idx, z->idx, z->nidx * IFZ_IDX_SIZE);
+            sdr_free(z->idx);
+            z->idx = idx;
+        }
+        uint8_t *p = z->idx + z->nidx++ * IFZ_IDX_SIZE;
+        set_u8(p, z->pos);
+        set_u4(p + 8, z->seq);
+        set_u4(p + 12, z->len);
+    }
+    z->pos += m;
+    z->seq++;
+    z->len = 0;
+}
+
+//------------------------------------------------------------------------------
+//  Write IF data to compressed IF data encoder. The IF data are encoded and
+//  output by chunks.
+//
+//  args:
+//      z        (I)  compressed IF data encoder
+//      data     (I)  IF data
+//      size     (I)  size of IF data (bytes)
+//
+//  return:
+//      size of IF data written (bytes)
+//
+int sdr_ifz_write(sdr_ifz_t *z, const uint8_t *data, int size)
+{
+    if (!z) return 0;
+    for (int i = 0, n; i < size; i += n) {
+        n = MIN(size - i, z->chunk - z->len);
+        memcpy(z->buff + z->len, data + i, n);
+        if ((z->len += n) >= z->chunk) {
+            out_chunk(z);
+        }
+    }
+    return size;
+}
+
+//------------------------------------------------------------------------------
+//  Skip IF data in compressed IF data encoder to keep the time of the IF data
+//  for dropped IF data. The skipped chunks are recorded as lost chunks and the
+//  skipped IF data in a partial chunk are set to 0.
+//
+//  args:
+//      z        (I)  compressed IF data encoder
+//      size     (I)  size of IF data skipped (bytes)
+//
+//  return:
+//      none
+//
+void sdr_ifz_skip(sdr_ifz_t *z, int64_t size)
+{
+    if (!z) return;
+    while (size > 0) {
+        if (z->len == 0 && size >= z->chunk) { // lost chunk
+            z->seq++;
+            size -= z->chunk;
+            continue;
+        }
+        int n = (int)MIN(size, (int64_t)(z->chunk - z->len));
+        memset(z->buff + z->len, 0, n);
+        size -= n;
+        if ((z->len += n) >= z->chunk) {
+            out_chunk(z);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+//  Free compressed IF data encoder. The last chunk and the index are output
+//  before freeing.
+//
+//  args:
+//      z        (I)  compressed IF data encoder
+//
+//  return:
+//      none
+//
+void sdr_ifz_free(sdr_ifz_t *z)
+{
+    if (!z) return;
+    if (z->len > 0) {
+        out_chunk(z);
+    }
+    uint8_t tail[IFZ_TAIL];
+    set_u4(tail, z->nidx);
+    set_u8(tail + 4, z->pos);
+    memcpy(tail + 12, "IFZE", 4);
+    if (z->nidx > 0) {
+        z->write(z->arg, z->idx, z->nidx * IFZ_IDX_SIZE);
+    }
+    z->write(z->arg, tail, IFZ_TAIL);
+    sdr_free(z->idx);
+    sdr_free(z->buff);
+    sdr_free(z->out);
+    sdr_free(z);
+}
+
+// read header of compressed IF data file --------------------------------------
+static int read_head(FILE *fp, int *chunk, int *lanes, char *tag)
+{
+    uint8_t head[IFZ_HEAD];
+    
+    if (fread(head, IFZ_HEAD, 1, fp) < 1 || memcmp(head, IFZ_MAGIC, 8)) {
+        return 0;
+    }
+    *chunk = (int)get_u4(head + 8);
+    *lanes = (int)get_u4(head + 12);
+    int len = (int)get_u4(head + 16);
+    if (*chunk <= 0 || *lanes < 1 || *lanes > 2 || len < 0 ||
+        len >= SDR_MAX_TAG || fread(tag, 1, len, fp) < (size_t)len) {
+        return 0;
+    }
+    tag[len] = '\0';
+    return IFZ_HEAD + len;
+}
+
+//------------------------------------------------------------------------------
+//  Read the tag of compressed IF data file.
+//
+//  args:
+//      file     (I)  compressed IF data file
+//      tag      (O)  tag of IF data (text) (SDR_MAX_TAG bytes)
+//
+//  return:
+//      status (1: OK, 0: not compressed IF data file or error)
+//
+int sdr_ifz_read_tag(const char *file, char *tag)
+{
+    FILE *fp;
+    int chunk, lanes;
+    
+    if (!(fp = fopen(file, "rb"))) return 0;
+    int stat = read_head(fp, &chunk, &lanes, tag) > 0;
+    fclose(fp);
+    return stat;
+}
+
+// add chunk to index ----------------------------------------------------------
+//  The sequence number is bounded by max_seq (each chunk has a header in the
+//  file), so a broken header does not request a huge index.
+static int add_index(sdr_iff_t *iff, int64_t off, uint32_t seq, int len,
+    int64_t max_seq, int *nmax)
+{
+    if ((int64_t)seq > MIN(max_seq, (int64_t)MAX_SEQ) || len <= 0 ||
+        len > iff->chunk) {
+        return 0;
+    }
+    if ((int)seq >= *nmax) {
+        int n = (int)MIN(MAX((int64_t)*nmax * 2, (int64_t)seq + 1024),
+            (int64_t)MAX_SEQ + 1);
+        int64_t *p = (int64_t *)sdr_malloc(sizeof(int64_t) * n);
+        memcpy(p, iff->off, sizeof(int64_t) * iff->nchunk);
+        sdr_free(iff->off);
+        iff->off = p;
+        *nmax = n;
+    }
+    for (int i = iff->nchunk; i < (int)seq; i++) {
+        iff->off[i] = -1; // lost chunks
+    }
+    iff->off[seq] = off;
+    iff->nchunk = MAX(iff->nchunk, (int)seq + 1);
+    iff->size = MAX(iff->size, (int64_t)seq * iff->chunk + len);
+    return 1;
+}
+
+// read index of compressed IF data file ---------------------------------------
+static int read_index(sdr_iff_t *iff, int64_t fsize)
+{
+    uint8_t tail[IFZ_TAIL];
+    int nmax = 0;
+    
+    if (fsize < IFZ_TAIL || fseek64(iff->fp, fsize - IFZ_TAIL) ||
+        fread(tail, IFZ_TAIL, 1, iff->fp) < 1 || memcmp(tail + 12, "IFZE", 4)) {
+        return 0;
+    }
+    int nidx = (int)get_u4(tail);
+    int64_t pos = get_u8(tail + 4);
+    if (nidx < 0 || pos + (int64_t)nidx * IFZ_IDX_SIZE + IFZ_TAIL != fsize) {
+        return 0;
+    }
+    uint8_t *idx = (uint8_t *)sdr_malloc(MAX(nidx, 1) * IFZ_IDX_SIZE);
+    if (fseek64(iff->fp, pos) ||
+        fread(idx, IFZ_IDX_SIZE, nidx, iff->fp) < (size_t)nidx) {
+        sdr_free(idx);
+        return 0;
+    }
+    int stat = 1;
+    for (int i = 0; i < nidx && stat; i++) {
+        uint8_t *p = idx + i * IFZ_IDX_SIZE;
+        stat = add_index(iff, get_u8(p), get_u4(p + 8), (int)get_u4(p + 12),
+            fsize / IFZ_CHUNK_HEAD, &nmax);
+    }
+    sdr_free(idx);
+    return stat;
+}
+
+// scan chunks to rebuild index ------------------------------------------------
+static void scan_index(sdr_iff_t *iff, int64_t pos, int64_t fsize)
+{
+    uint8_t head[IFZ_CHUNK_HEAD];
+    int nmax = 0;
+    
+    sdr_free(iff->off);
+    iff->off = NULL;
+    iff->nchunk = 0;
+    iff->size = 0;
+    while (!fseek64(iff->fp, pos) &&
+        fread(head, IFZ_CHUNK_HEAD, 1, iff->fp) == 1 &&
+        !memcmp(head, "IFZC", 4)) {
+        if (!add_index(iff, pos, get_u4(head + 4), (int)get_u4(head + 8),
+            fsize / IFZ_CHUNK_HEAD, &nmax)) break;
+        pos += IFZ_CHUNK_HEAD + get_u4(head + 12);
+    }
+}
+
+// read and decode chunk -------------------------------------------------------
+//  The IF data of a lost or a broken chunk are set to 0. The payload size is
+//  limited by the max encoded size of a chunk (lane headers and IF data).
+static void read_chunk(sdr_iff_t *iff, int64_t seq, uint8_t *data)
+{
+    uint8_t head[IFZ_CHUNK_HEAD], *in = NULL;
+    int len = (int)MIN((int64_t)iff->chunk, iff->size - seq * iff->chunk);
+    int64_t max_size = (int64_t)iff->lanes * RANS_HEAD + iff->chunk;
+    int size = 0, stat = 0;
+    
+    pthread_mutex_lock(&iff->fmtx);
+    if (iff->off[seq] >= 0 && !fseek64(iff->fp, iff->off[seq]) &&
+        fread(head, IFZ_CHUNK_HEAD, 1, iff->fp) == 1 &&
+        (int)get_u4(head + 8) == len &&
+        (int64_t)get_u4(head + 12) <= max_size) {
+        size = (int)get_u4(head + 12);
+        in = (uint8_t *)sdr_malloc(MAX(size, 1));
+        stat = fread(in, 1, size, iff->fp) == (size_t)size;
+    }
+    pthread_mutex_unlock(&iff->fmtx);
+    
+    if (!stat || !dec_chunk(in, size, head[16], iff->lanes, data, len)) {
+        memset(data, 0, len);
+    }
+    sdr_free(in);
+}
+
+// chunk decode thread ---------------------------------------------------------
+//  The chunks within the window of the decoded chunk slots from the chunk of
+//  the read position are decoded ahead of the reads.
+static void *dec_thread(void *arg)
+{
+    sdr_iff_t *iff = (sdr_iff_t *)arg;
+    
+    pthread_mutex_lock(&iff->mtx);
+    while (iff->state) {
+        int64_t cur = iff->pos / iff->chunk, seq = MAX(iff->next, cur);
+        int k = (int)(seq % SDR_IFZ_NSLOT);
+    
+        if (seq >= iff->nchunk || seq >= cur + SDR_IFZ_NSLOT ||
+            iff->stat[k]) {
+            pthread_cond_wait(&iff->cond, &iff->mtx);
+            continue;
+        }
+        iff->next = seq + 1;
+        iff->seq[k] = seq;
+        iff->stat[k] = 1;
+        pthread_mutex_unlock(&iff->mtx);
+    
+        read_chunk(iff, seq, iff->data[k]);
+    
+        pthread_mutex_lock(&iff->mtx);
+        cur = iff->pos / iff->chunk;
+        iff->stat[k] = (seq >= cur && seq < cur + SDR_IFZ_NSLOT) ? 2 : 0;
+        pthread_cond_broadcast(&iff->cond);
+    }
+    pthread_mutex_unlock(&iff->mtx);
+    return NULL;
+}
+
+// memory-map plain IF data file -----------------------------------------------
+static void map_file(sdr_iff_t *iff)
+{
+#ifndef WIN32
+    if (iff->size <= 0 || (uint64_t)iff->size > (uint64_t)SIZE_MAX) return;
+    void *p = mmap(NULL, (size_t)iff->size, PROT_READ, MAP_SHARED,
+        fileno(iff->fp), 0);
+    if (p == MAP_FAILED) return;
+    madvise(p, (size_t)iff->size, MADV_SEQUENTIAL);
+    iff->map = (const uint8_t *)p;
+#endif
+}
+
+// advise read-ahead and release of mapped IF data -----------------------------
+static void advise_map(sdr_iff_t *iff, int64_t pos)
+{
+#ifndef WIN32
+    uint8_t *map = (uint8_t *)iff->map;
+    
+    if (pos < iff->rel || pos > iff->adv) { // random access
+        iff->rel = iff->adv = pos / MAP_PAGE * MAP_PAGE;
+    }
+    if (iff->adv - pos < MAP_AHEAD / 2 && iff->adv < iff->size) {
+        int64_t end = MIN((pos + MAP_AHEAD) / MAP_PAGE * MAP_PAGE, iff->size);
+        madvise(map + iff->adv, (size_t)(end - iff->adv), MADV_WILLNEED);
+        iff->adv = end;
+    }
+    if (pos - iff->rel >= MAP_AHEAD * 2) {
+        int64_t end = (pos - MAP_AHEAD) / MAP_PAGE * MAP_PAGE;
+        madvise(map + iff->rel, (size_t)(end - iff->rel), MADV_DONTNEED);
+        iff->rel = end;
+    }
+#endif
+}
+
+//------------------------------------------------------------------------------
+//  Open IF data file. A compressed IF data file or a plain IF data file is
+//  recognized by the file header. The chunks of the compressed IF data file
+//  are decoded by the decode threads ahead of the reads. A plain IF data file
+//  is memory-mapped if possible.
+//
+//  args:
+//      file     (I)  IF data file
+//      nth      (I)  number of decode threads (0: decode in reads)
+//
+//  return:
+//      IF data file (NULL: error)
+//
+sdr_iff_t *sdr_iff_open(const char *file, int nth)
+{
+    FILE *fp;
+    
+    if (!(fp = fopen(file, "rb"))) {
+        fprintf(stderr, "file open error: %s\n", file);
+        return NULL;
+    }
+    sdr_iff_t *iff = (sdr_iff_t *)sdr_malloc(sizeof(sdr_iff_t));
+    iff->fp = fp;
+    fseek(fp, 0, SEEK_END);
+    int64_t fsize = ftell64(fp);
+    rewind(fp);
+    
+    int head = read_head(fp, &iff->chunk, &iff->lanes, iff->tag);
+    if (head > 0) {
+        iff->comp = 1;
+        if (!read_index(iff, fsize)) {
+            scan_index(iff, head, fsize);
+        }
+        for (int i = 0; i < SDR_IFZ_NSLOT; i++) {
+            iff->data[i] = (uint8_t *)sdr_malloc(iff->chunk);
+        }
+    }
+    else {
+        iff->size = fsize;
+        iff->tag[0] = '\0';
+        rewind(fp);
+        map_file(iff);
+    }
+    pthread_mutex_init(&iff->mtx, NULL);
+    pthread_mutex_init(&iff->fmtx, NULL);
+    pthread_cond_init(&iff->cond, NULL);
+    iff->state = 1;
+    for (int i = 0; iff->comp && i < MIN(nth, SDR_IFZ_MAX_TH); i++) {
+        if (pthread_create(&iff->thread[i], NULL, dec_thread, iff)) break;
+        iff->nth++;
+    }
+    return iff;
+}
+
+//------------------------------------------------------------------------------
+//  Close IF data file.
+//
+//  args:
+//      iff      (I)  IF data file
+//
+//  return:
+//      none
+//
+void sdr_iff_close(sdr_iff_t *iff)
+{
+    if (!iff) return;
+    pthread_mutex_lock(&iff->mtx);
+    iff->state = 0;
+    pthread_cond_broadcast(&iff->cond);
+    pthread_mutex_unlock(&iff->mtx);
+    for (int i = 0; i < iff->nth; i++) {
+        pthread_join(iff->thread[i], NULL);
+    }
+    for (int i = 0; i < SDR_IFZ_NSLOT; i++) {
+        sdr_free(iff->data[i]);
+    }
+    pthread_cond_destroy(&iff->cond);
+    pthread_mutex_destroy(&iff->fmtx);
+    pthread_mutex_destroy(&iff->mtx);
+    sdr_free(iff->off);
+#ifndef WIN32
+    if (iff->map) munmap((void *)iff->map, (size_t)iff->size);
+#endif
+    fclose(iff->fp);
+    sdr_free(iff);
+}
+
+//------------------------------------------------------------------------------
+//  Seek IF data file.
+//
+//  args:
+//      iff      (I)  IF data file
+//      off      (I)  offset of IF data from the beginning (bytes)
+//
+//  return:
+//      status (1: OK, 0: error)
+//
+int sdr_iff_seek(sdr_iff_t *iff, int64_t off)
+{
+    if (off < 0 || off > iff->size) return 0;
+    
+    if (iff->map) {
+        iff->pos = off;
+        return 1;
+    }
+    if (!iff->comp) {
+        pthread_mutex_lock(&iff->fmtx);
+        int stat = !fseek64(iff->fp, off);
+        pthread_mutex_unlock(&iff->fmtx);
+        if (stat) iff->pos = off;
+        return stat;
+    }
+    pthread_mutex_lock(&iff->mtx);
+    iff->pos = off;
+    iff->next = off / iff->chunk;
+    for (int i = 0; i < SDR_IFZ_NSLOT; i++) {
+        if (iff->stat[i] == 2) iff->stat[i] = 0;
+    }
+    pthread_cond_broadcast(&iff->cond);
+    pthread_mutex_unlock(&iff->mtx);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//  Read IF data from IF data file.
+//
+//  args:
+//      iff      (I)  IF data file
+//      data     (O)  IF data
+//      size     (I)  size of IF data to read (bytes)
+//
+//  return:
+//      size of IF data read (bytes) (< size: end of file)
+//
+int sdr_iff_read(sdr_iff_t *iff, uint8_t *data, int size)
+{
+    int n = 0;
+    
+    if (iff->map && iff->pos + size <= iff->size) { // mapped file
+        memcpy(data, iff->map + iff->pos, size);
+        iff->pos += size;
+        advise_map(iff, iff->pos);
+        return size;
+    }
+    if (!iff->comp) {
+        pthread_mutex_lock(&iff->fmtx);
+        if (iff->map) fseek64(iff->fp, iff->pos);
+        n = (int)fread(data, 1, size, iff->fp);
+        pthread_mutex_unlock(&iff->fmtx);
+        iff->pos += n;
+        return n;
+    }
+    pthread_mutex_lock(&iff->mtx);
+    while (n < size && iff->pos < iff->size) {
+        int64_t seq = iff->pos / iff->chunk;
+        int k = (int)(seq % SDR_IFZ_NSLOT);
+    
+        if (iff->stat[k] == 2 && iff->seq[k] == seq) { // decoded chunk
+            int i = (int)(iff->pos - seq * iff->chunk);
+            int m = (int)MIN((int64_t)size - n, MIN((int64_t)iff->chunk - i,
+                iff->size - iff->pos));
+            memcpy(data + n, iff->data[k] + i, m);
+            n += m;
+            iff->pos += m;
+            if (iff->pos / iff->chunk != seq) {
+                iff->stat[k] = 0;
+                pthread_cond_broadcast(&iff->cond);
+            }
+        }
+        else if (!iff->stat[k]) { // decode chunk in read
+            iff->seq[k] = seq;
+            iff->stat[k] = 1;
+            iff->next = MAX(iff->next, seq + 1);
+            pthread_mutex_unlock(&iff->mtx);
+    
+            read_chunk(iff, seq, iff->data[k]);
+    
+            pthread_mutex_lock(&iff->mtx);
+            iff->stat[k] = 2;
+            pthread_cond_broadcast(&iff->cond);
+        }
+        else { // wait for chunk decoded by decode thread
+            pthread_cond_wait(&iff->cond, &iff->mtx);
+        }
+    }
+    pthread_mutex_unlock(&iff->mtx);
+    return n;
+}
+
+//------------------------------------------------------------------------------
+//  Get a view of IF data in memory-mapped IF data file without copy. The view
+//  is valid until the IF data file is closed.
+//
+//  args:
+//      iff      (I)  IF data file
+//      size     (I)  size of IF data to view (bytes)
+//
+//  return:
+//      view of IF data (NULL: no mapped IF data or end of file)
+//
+const uint8_t *sdr_iff_view(sdr_iff_t *iff, int size)
+{
+    if (!iff->map || iff->pos + size > iff->size) return NULL;
+    const uint8_t *data = iff->map + iff->pos;
+    iff->pos += size;
+    advise_map(iff, iff->pos);
+    return data;
+}
+
+//------------------------------------------------------------------------------
+//  Get IF data samples in IF data file as complex. The int8 I or IQ samples
+//  are converted block by block from the mapped IF data or the read buffer.
+//
+//  args:
+//      iff      (I)  IF data file
+//      IQ       (I)  sampling type (1: I-sampling, 2: IQ-sampling)
+//      ix       (I)  index of first sample
+//      N        (I)  number of samples
+//      data     (O)  IF data samples
+//
+//  return:
+//      status (1: OK, 0: error or end of file)
+//
+int sdr_iff_get(sdr_iff_t *iff, int IQ, int64_t ix, int N, sdr_cpx8_t *data)
+{
+    uint8_t buff[GET_BLK];
+    
+    if (!sdr_iff_seek(iff, ix * IQ)) return 0;
+    
+    for (int i = 0, n; i < N; i += n) {
+        n = MIN(N - i, GET_BLK / IQ);
+        const int8_t *raw = (const int8_t *)sdr_iff_view(iff, n * IQ);
+        if (!raw) {
+            if (sdr_iff_read(iff, buff, n * IQ) < n * IQ) return 0;
+            raw = (const int8_t *)buff;
+        }
+        if (IQ == 1) { // I-sampling
+            for (int j = 0; j < n; j++) {
+                data[i+j] = SDR_CPX8(raw[j], 0);
+            }
+        }
+        else { // IQ-sampling
+            for (int j = 0; j < n; j++) {
+                data[i+j] = SDR_CPX8(raw[j*2], raw[j*2+1]);
+            }
+        }
+    }
+    return 1;
+}
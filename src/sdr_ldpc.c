@@ -24,39 +24,35 @@
 //  2023-01-07  1.1  support IRNV1_SF2 and IRNV1_SF3 in decode_LDPC()
 //  2023-01-09  1.2  support BCNV1_SF2, BCNV1_SF3, BCNV2, BCNV3 in decode_LDPC()
 //  2023-01-16  1.3  fix memory leak and unable decoding of LDPC
+//  2026-10-14  1.4  replace probability propagation of LDPC-codes by layered
+//                   normalized min-sum decoder for binary LDPC
+//                   generate H-matrices once and thread-safely
 //
+#include <math.h>
 #include "pocket_sdr.h"
 
 // constants -------------------------------------------------------------------
-#define MAX_ITER  250
-#define ERR_PROB  1e-5
+#define MAX_ITER  50            // max number of iterations
+#define ERR_PROB  1e-5          // error probability of input codes
+#define ALPHA     0.75f         // normalization factor of min-sum
+#define MAX_DEG   32            // max row degree of H-matrix
 
-// function prototypes of LDPC-codes ([1],[2]) ---------------------------------
-#ifdef __cplusplus
-extern "C" {
-#endif
-extern int max_iter;
-void *mod2sparse_allocate(int, int);
-void *mod2sparse_insert(void *, int, int);
-void mod2sparse_free(void *);
-void prprp_decode_setup(void);
-unsigned int prprp_decode(void *, double *, char *, char *, double *);
-int check(void *, char *, char *);
-double changed(double *, char *, int);
-#ifdef __cplusplus
-}
-#endif
+#define MIN(x, y) ((x) < (y) ? (x) : (y))
+#define MAX(x, y) ((x) > (y) ? (x) : (y))
 
-// global variables ------------------------------------------------------------
-static const double RATIO[] = {
-    (1.0 - ERR_PROB) / ERR_PROB, ERR_PROB / (1.0 - ERR_PROB)
-};
+// type definitions ------------------------------------------------------------
+typedef struct {                // binary LDPC H-matrix type
+    int m, n;                   // rows and columns
+    int *row;                   // CSR index of row edges (m + 1)
+    int *col;                   // CSR columns of row edges
+} ldpc_H_t;
 
 // LDPC H-matrix cache ---------------------------------------------------------
-static void *H_CNV2_SF2  = NULL;
-static void *H_CNV2_SF3  = NULL;
-static void *H_IRNV1_SF2 = NULL;
-static void *H_IRNV1_SF3 = NULL;
+static ldpc_H_t *H_CNV2_SF2  = NULL;
+static ldpc_H_t *H_CNV2_SF3  = NULL;
+static ldpc_H_t *H_IRNV1_SF2 = NULL;
+static ldpc_H_t *H_IRNV1_SF3 = NULL;
+static pthread_mutex_t H_mtx = PTHREAD_MUTEX_INITIALIZER;
 
 // CNAV-2 LDPC H-matrix table ([3]) --------------------------------------------
 
@@ -2192,105 +2188,164 @@ static const uint16_t H_IRNV1_SF3_T[][2] = { // [7] table 41
     {179,179}, {212,189}, {200,200}, {233,210}, {221,221}, {234,234}
 };
 
+// compare H-matrix entries ----------------------------------------------------
+static int cmp_entry(const void *p1, const void *p2)
+{
+    const int *a = (const int *)p1, *b = (const int *)p2;
+    return a[0] != b[0] ? a[0] - b[0] : a[1] - b[1];
+}
+
+// add H-matrix entries --------------------------------------------------------
+static int add_entry(int *ent, int ne, const uint16_t H[][2], int nh, int i0,
+    int j0)
+{
+    for (int i = 0; i < nh; i++, ne++) {
+        ent[ne*2  ] = i0 + H[i][0] - 1;
+        ent[ne*2+1] = j0 + H[i][1] - 1;
+    }
+    return ne;
+}
+
 // generate binary LDPC parity check matrix ------------------------------------
-static void *gen_B_LDPC_H(int m, int n, int g, const uint16_t H_A[][2],
+static ldpc_H_t *gen_B_LDPC_H(int m, int n, int g, const uint16_t H_A[][2],
     const uint16_t H_B[][2], const uint16_t H_C[][2], const uint16_t H_D[][2],
     const uint16_t H_E[][2], const uint16_t H_T[][2], int na, int nb, int nc,
     int nd, int ne, int nt)
 {
-    void *H = mod2sparse_allocate(m, n);
+    int *ent = (int *)sdr_malloc(sizeof(int) * 2 * (na + nb + nc + nd + ne +
+        nt));
+    int k = 0;
     
-    for (int i = 0; i < na; i++) {
-        mod2sparse_insert(H, H_A[i][0] - 1, H_A[i][1] - 1);
-    }
-    for (int i = 0; i < nb; i++) {
-        mod2sparse_insert(H, H_B[i][0] - 1, m + H_B[i][1] - 1);
-    }
-    for (int i = 0; i < nc; i++) {
-        mod2sparse_insert(H, m - g + H_C[i][0] - 1, H_C[i][1] - 1);
-    }
-    for (int i = 0; i < nd; i++) {
-        mod2sparse_insert(H, m - g + H_D[i][0] - 1, m + H_D[i][1] - 1);
-    }
-    for (int i = 0; i < ne; i++) {
-        mod2sparse_insert(H, m - g + H_E[i][0] - 1, m + g + H_E[i][1] - 1);
+    k = add_entry(ent, k, H_A, na, 0, 0);
+    k = add_entry(ent, k, H_B, nb, 0, m);
+    k = add_entry(ent, k, H_C, nc, m - g, 0);
+    k = add_entry(ent, k, H_D, nd, m - g, m);
+    k = add_entry(ent, k, H_E, ne, m - g, m + g);
+    k = add_entry(ent, k, H_T, nt, 0, m + g);
+    qsort(ent, k, sizeof(int) * 2, cmp_entry);
+    
+    ldpc_H_t *H = (ldpc_H_t *)sdr_malloc(sizeof(ldpc_H_t));
+    H->m = m;
+    H->n = n;
+    H->row = (int *)sdr_malloc(sizeof(int) * (m + 1));
+    H->col = (int *)sdr_malloc(sizeof(int) * k);
+    for (int i = 0; i < k; i++) {
+        if (i > 0 && !cmp_entry(ent + i * 2, ent + i * 2 - 2)) continue;
+        H->col[H->row[m]++] = ent[i*2+1]; // H->row[m]: number of edges
+        H->row[ent[i*2]+1] = H->row[m];
     }
-    for (int i = 0; i < nt; i++) {
-        mod2sparse_insert(H, H_T[i][0] - 1, m + g + H_T[i][1] - 1);
+    for (int i = 1; i < m; i++) { // rows without edges
+        H->row[i] = MAX(H->row[i], H->row[i-1]);
     }
+    sdr_free(ent);
     return H;
 }
 
-// free binary LDPC parity check matrix ----------------------------------------
-#if 0
-static void free_B_LDPC_H(void *H)
+// get binary LDPC parity check matrix -----------------------------------------
+static const ldpc_H_t *get_B_LDPC_H(ldpc_H_t **H, int m, int n, int g,
+    const uint16_t H_A[][2], const uint16_t H_B[][2], const uint16_t H_C[][2],
+    const uint16_t H_D[][2], const uint16_t H_E[][2], const uint16_t H_T[][2],
+    int na, int nb, int nc, int nd, int ne, int nt)
 {
-    mod2sparse_free(H);
+    pthread_mutex_lock(&H_mtx);
+    if (!*H) {
+        *H = gen_B_LDPC_H(m, n, g, H_A, H_B, H_C, H_D, H_E, H_T, na, nb, nc,
+            nd, ne, nt);
+    }
+    pthread_mutex_unlock(&H_mtx);
+    return *H;
 }
-#endif
 
-// decode binary LDPC ----------------------------------------------------------
-static int decode_B_LDPC(void *H, int m, int n, const uint8_t *syms,
+// parity check of binary LDPC -----------------------------------------------
+static int check_parity(const ldpc_H_t *H, const float *L)
+{
+    for (int i = 0; i < H->m; i++) {
+        int s = 0;
+        for (int j = H->row[i]; j < H->row[i+1]; j++) {
+            s ^= L[H->col[j]] < 0.0f;
+        }
+        if (s) return 0;
+    }
+    return 1;
+}
+
+// decode binary LDPC by layered normalized min-sum ----------------------------
+static int decode_B_LDPC(const ldpc_H_t *H, const uint8_t *syms,
     uint8_t *syms_dec)
 {
-    double *lratio = (double *)sdr_malloc(sizeof(double) * n);
-    char   *dblk   = (char   *)sdr_malloc(sizeof(char)   * n);
-    char   *pchk   = (char   *)sdr_malloc(sizeof(char)   * n);
-    double *bitpr  = (double *)sdr_malloc(sizeof(double) * n);
+    int m = H->m, n = H->n, ne = H->row[m], nerr = -1;
+    float *L = (float *)sdr_scratch_alloc(sizeof(float) * (n + ne + MAX_DEG));
+    float *R = L + n, *Q = R + ne;
+    float L0 = (float)log((1.0 - ERR_PROB) / ERR_PROB);
     
     for (int i = 0; i < n; i++) {
-        lratio[i] = RATIO[syms[i]];
+        L[i] = syms[i] ? -L0 : L0;
     }
-    // setup decoder
-    max_iter = MAX_ITER;
-    prprp_decode_setup();
-    
-    // decode LDPC by probability propagation
-    prprp_decode(H, lratio, dblk, pchk, bitpr);
-    int valid = check(H, dblk, pchk) == 0;
-    int nerr = (int)changed(lratio, dblk, n);
-    
-    memcpy(syms_dec, dblk, m);
+    memset(R, 0, sizeof(float) * ne);
     
-    sdr_free(lratio);
-    sdr_free(dblk);
-    sdr_free(pchk);
-    sdr_free(bitpr);
-    return valid ? nerr : -1;
+    for (int iter = 0; iter <= MAX_ITER; iter++) {
+        // parity check
+        if (check_parity(H, L)) {
+            nerr = 0;
+            for (int i = 0; i < n; i++) {
+                uint8_t sym = L[i] < 0.0f;
+                if (i < m) syms_dec[i] = sym;
+                if (sym != syms[i]) nerr++;
+            }
+            break;
+        }
+        if (iter == MAX_ITER) break;
+        
+        // update check nodes layer by layer
+        for (int i = 0; i < m; i++) {
+            int j0 = H->row[i], deg = MIN(H->row[i+1] - j0, MAX_DEG);
+            float min1 = 1e30f, min2 = 1e30f, sgn = 1.0f;
+            for (int k = 0; k < deg; k++) {
+                float a = fabsf(Q[k] = L[H->col[j0+k]] - R[j0+k]);
+                min2 = a < min1 ? min1 : MIN(min2, a);
+                min1 = MIN(min1, a);
+                sgn *= Q[k] < 0.0f ? -1.0f : 1.0f;
+            }
+            for (int k = 0; k < deg; k++) {
+                float a = fabsf(Q[k]) == min1 ? min2 : min1;
+                float s = Q[k] < 0.0f ? -sgn : sgn;
+                R[j0+k] = ALPHA * s * a;
+                L[H->col[j0+k]] = Q[k] + R[j0+k];
+            }
+        }
+    }
+    sdr_scratch_free(L);
+    return nerr;
 }
 
 // decode LDPC(1200,600) of CNAV-2 subframe 2 ----------------------------------
 static int decode_LDPC_CNV2_SF2(const uint8_t *syms, uint8_t *syms_dec)
 {
-    if (!H_CNV2_SF2) {
-        int na = (int)sizeof(H_CNV2_SF2_A) / 4;
-        int nb = (int)sizeof(H_CNV2_SF2_B) / 4;
-        int nc = (int)sizeof(H_CNV2_SF2_C) / 4;
-        int nd = (int)sizeof(H_CNV2_SF2_D) / 4;
-        int ne = (int)sizeof(H_CNV2_SF2_E) / 4;
-        int nt = (int)sizeof(H_CNV2_SF2_T) / 4;
-        H_CNV2_SF2 = gen_B_LDPC_H(600, 1200, 1, H_CNV2_SF2_A, H_CNV2_SF2_B,
-            H_CNV2_SF2_C, H_CNV2_SF2_D, H_CNV2_SF2_E, H_CNV2_SF2_T, na, nb, nc,
-            nd, ne, nt);
-    }
-    return decode_B_LDPC(H_CNV2_SF2, 600, 1200, syms, syms_dec);
+    int na = (int)sizeof(H_CNV2_SF2_A) / 4;
+    int nb = (int)sizeof(H_CNV2_SF2_B) / 4;
+    int nc = (int)sizeof(H_CNV2_SF2_C) / 4;
+    int nd = (int)sizeof(H_CNV2_SF2_D) / 4;
+    int ne = (int)sizeof(H_CNV2_SF2_E) / 4;
+    int nt = (int)sizeof(H_CNV2_SF2_T) / 4;
+    const ldpc_H_t *H = get_B_LDPC_H(&H_CNV2_SF2, 600, 1200, 1, H_CNV2_SF2_A,
+        H_CNV2_SF2_B, H_CNV2_SF2_C, H_CNV2_SF2_D, H_CNV2_SF2_E, H_CNV2_SF2_T,
+        na, nb, nc, nd, ne, nt);
+    return decode_B_LDPC(H, syms, syms_dec);
 }
 
 // decode LDPC(548,274) of CNAV-2 subframe 3 -----------------------------------
 static int decode_LDPC_CNV2_SF3(const uint8_t *syms, uint8_t *syms_dec)
 {
-    if (!H_CNV2_SF3) {
-        int na = (int)sizeof(H_CNV2_SF3_A) / 4;
-        int nb = (int)sizeof(H_CNV2_SF3_B) / 4;
-        int nc = (int)sizeof(H_CNV2_SF3_C) / 4;
-        int nd = (int)sizeof(H_CNV2_SF3_D) / 4;
-        int ne = (int)sizeof(H_CNV2_SF3_E) / 4;
-        int nt = (int)sizeof(H_CNV2_SF3_T) / 4;
-        H_CNV2_SF3 = gen_B_LDPC_H(274, 548, 1, H_CNV2_SF3_A, H_CNV2_SF3_B,
-            H_CNV2_SF3_C, H_CNV2_SF3_D, H_CNV2_SF3_E, H_CNV2_SF3_T, na, nb, nc,
-            nd, ne, nt);
-    }
-    return decode_B_LDPC(H_CNV2_SF3, 274, 548, syms, syms_dec);
+    int na = (int)sizeof(H_CNV2_SF3_A) / 4;
+    int nb = (int)sizeof(H_CNV2_SF3_B) / 4;
+    int nc = (int)sizeof(H_CNV2_SF3_C) / 4;
+    int nd = (int)sizeof(H_CNV2_SF3_D) / 4;
+    int ne = (int)sizeof(H_CNV2_SF3_E) / 4;
+    int nt = (int)sizeof(H_CNV2_SF3_T) / 4;
+    const ldpc_H_t *H = get_B_LDPC_H(&H_CNV2_SF3, 274, 548, 1, H_CNV2_SF3_A,
+        H_CNV2_SF3_B, H_CNV2_SF3_C, H_CNV2_SF3_D, H_CNV2_SF3_E, H_CNV2_SF3_T,
+        na, nb, nc, nd, ne, nt);
+    return decode_B_LDPC(H, syms, syms_dec);
 }
 
 // decode NB-LDPC(200,100) of B-CNAV1 subframe 2 -------------------------------
@@ -2333,35 +2388,31 @@ static int decode_LDPC_BCNV3(const uint8_t *syms, uint8_t *syms_dec)
 // decode LDPC(1200,600) of NavIC L1-SPS NAV subframe 2 ------------------------
 static int decode_LDPC_IRNV1_SF2(const uint8_t *syms, uint8_t *syms_dec)
 {
-    if (!H_IRNV1_SF2) {
-        int na = (int)sizeof(H_IRNV1_SF2_A) / 4;
-        int nb = (int)sizeof(H_IRNV1_SF2_B) / 4;
-        int nc = (int)sizeof(H_IRNV1_SF2_C) / 4;
-        int nd = (int)sizeof(H_IRNV1_SF2_D) / 4;
-        int ne = (int)sizeof(H_IRNV1_SF2_E) / 4;
-        int nt = (int)sizeof(H_IRNV1_SF2_T) / 4;
-        H_IRNV1_SF2 = gen_B_LDPC_H(600, 1200, 50, H_IRNV1_SF2_A, H_IRNV1_SF2_B,
-            H_IRNV1_SF2_C, H_IRNV1_SF2_D, H_IRNV1_SF2_E, H_IRNV1_SF2_T, na, nb,
-            nc, nd, ne, nt);
-    }
-    return decode_B_LDPC(H_IRNV1_SF2, 600, 1200, syms, syms_dec);
+    int na = (int)sizeof(H_IRNV1_SF2_A) / 4;
+    int nb = (int)sizeof(H_IRNV1_SF2_B) / 4;
+    int nc = (int)sizeof(H_IRNV1_SF2_C) / 4;
+    int nd = (int)sizeof(H_IRNV1_SF2_D) / 4;
+    int ne = (int)sizeof(H_IRNV1_SF2_E) / 4;
+    int nt = (int)sizeof(H_IRNV1_SF2_T) / 4;
+    const ldpc_H_t *H = get_B_LDPC_H(&H_IRNV1_SF2, 600, 1200, 50,
+        H_IRNV1_SF2_A, H_IRNV1_SF2_B, H_IRNV1_SF2_C, H_IRNV1_SF2_D,
+        H_IRNV1_SF2_E, H_IRNV1_SF2_T, na, nb, nc, nd, ne, nt);
+    return decode_B_LDPC(H, syms, syms_dec);
 }
 
 // decode LDPC(548,274) of NavIC L1-SPS NAV subframe 3 -------------------------
 static int decode_LDPC_IRNV1_SF3(const uint8_t *syms, uint8_t *syms_dec)
 {
-    if (!H_IRNV1_SF3) {
-        int na = (int)sizeof(H_IRNV1_SF3_A) / 4;
-        int nb = (int)sizeof(H_IRNV1_SF3_B) / 4;
-        int nc = (int)sizeof(H_IRNV1_SF3_C) / 4;
-        int nd = (int)sizeof(H_IRNV1_SF3_D) / 4;
-        int ne = (int)sizeof(H_IRNV1_SF3_E) / 4;
-        int nt = (int)sizeof(H_IRNV1_SF3_T) / 4;
-        H_IRNV1_SF3 = gen_B_LDPC_H(274, 548, 23, H_IRNV1_SF3_A, H_IRNV1_SF3_B,
-            H_IRNV1_SF3_C, H_IRNV1_SF3_D, H_IRNV1_SF3_E, H_IRNV1_SF3_T, na, nb,
-            nc, nd, ne, nt);
-    }
-    return decode_B_LDPC(H_IRNV1_SF3, 274, 548, syms, syms_dec);
+    int na = (int)sizeof(H_IRNV1_SF3_A) / 4;
+    int nb = (int)sizeof(H_IRNV1_SF3_B) / 4;
+    int nc = (int)sizeof(H_IRNV1_SF3_C) / 4;
+    int nd = (int)sizeof(H_IRNV1_SF3_D) / 4;
+    int ne = (int)sizeof(H_IRNV1_SF3_E) / 4;
+    int nt = (int)sizeof(H_IRNV1_SF3_T) / 4;
+    const ldpc_H_t *H = get_B_LDPC_H(&H_IRNV1_SF3, 274, 548, 23,
+        H_IRNV1_SF3_A, H_IRNV1_SF3_B, H_IRNV1_SF3_C, H_IRNV1_SF3_D,
+        H_IRNV1_SF3_E, H_IRNV1_SF3_T, na, nb, nc, nd, ne, nt);
+    return decode_B_LDPC(H, syms, syms_dec);
 }
 
 //------------------------------------------------------------------------------
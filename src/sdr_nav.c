@@ -48,12 +48,23 @@
 //  2024-01-12  1.3  support B1CD, B2AD, B2BI
 //  2024-01-19  1.4  support G1OCD
 //  2024-05-22  1.5  support tow update for pseudorange generation
+//  2026-10-14  1.6  use ring buffer for nav symbols and P correlator history
+//                   dispatch nav data decoder by signal descriptor table
+//                   decode FEC of frame search by streaming Viterbi decoders
+//                   match preambles by packed nav symbols and popcount
+//                   decode LDPC nav frames by nav decode worker thread
+//                   add API sdr_sig_desc()
+//                   add CPU time of nav frame decode job to channel
+//                   trace spans of nav frame decode jobs
 //
 #include "pocket_sdr.h"
 
 // constants -------------------------------------------------------------------
 #define THRES_SYNC  0.02      // threshold for symbol sync
 #define THRES_LOST  0.002     // threshold for symbol lost
+#define MAX_VIT     1024      // max steps of streaming Viterbi decoder
+#define MAX_JOB_SYMS 1872     // max symbols of nav frame decode job
+#define MAX_JOB     SDR_MAX_NCH // max number of queued nav frame decode jobs
 #define GPST_OFF_W  2048      // GPST offset (week) (2019-4-7 ~ 2038-11-20)
 #define GPST_GST_W  1024      // GPST - GST (week)
 #define GPST_BDT_W  1356      // GPST - BDT (week)
@@ -102,18 +113,90 @@ static uint32_t BCH_CORR_TBL[] = {
 };
 
 // code caches -----------------------------------------------------------------
-static uint8_t *CNV2_SF1  [400] = {NULL};
-static uint8_t *BCNV1_SF1A[ 63] = {NULL};
-static uint8_t *BCNV1_SF1B[200] = {NULL};
-static uint8_t *IRNV1_SF1 [400] = {NULL};
+//  (packed as bit i: symbol i)
+static uint64_t CNV2_SF1  [400];
+static uint64_t BCNV1_SF1A[ 63];
+static uint64_t BCNV1_SF1B[200];
+static uint64_t IRNV1_SF1 [400];
+static pthread_once_t CNV2_once  = PTHREAD_ONCE_INIT;
+static pthread_once_t BCNV1_once = PTHREAD_ONCE_INIT;
+static pthread_once_t IRNV1_once = PTHREAD_ONCE_INIT;
+
+// nav symbols buffer ----------------------------------------------------------
+static uint8_t *nav_syms(const sdr_ch_t *ch)
+{
+    return (uint8_t *)sdr_hist_data(ch->nav->syms);
+}
+
+// add nav symbol to buffer ----------------------------------------------------
+static void add_sym(sdr_ch_t *ch, uint8_t sym)
+{
+    sdr_nav_t *nav = ch->nav;
+    uint64_t *w = nav->psyms + (nav->nsym >> 6) % SDR_NSYM_W;
+    uint64_t b = (uint64_t)1 << (nav->nsym & 63);
+    
+    sdr_hist_add(nav->syms, &sym);
+    *w = (sym & 1) ? (*w | b) : (*w & ~b);
+    nav->nsym++;
+}
+
+// decode 1/2 FEC of latest nav symbols ----------------------------------------
+//  The latest N symbols are decoded to N / 2 - 6 bits as sdr_decode_conv(). The
+//  symbols added after the last call are input to the streaming Viterbi
+//  decoders, so the search of frames every symbol does not re-run the trellis
+//  over the sliding window. swap: swap G1 and G2 symbols.
+//
+static void decode_conv_syms(sdr_ch_t *ch, int N, int swap, uint8_t *bits)
+{
+    sdr_nav_t *nav = ch->nav;
+    const uint8_t *data = nav_syms(ch);
+    int64_t n = nav->nsym - nav->nsym_vit; // number of new symbols
+    
+    if (!nav->vit[0]) {
+        nav->vit[0] = sdr_vit_new(MAX_VIT);
+        nav->vit[1] = sdr_vit_new(MAX_VIT);
+        n = N + 1;
+    }
+    if (n > N) { // restart decoders
+        sdr_vit_init(nav->vit[0], -1);
+        sdr_vit_init(nav->vit[1], -1);
+        n = N + 1;
+    }
+    for (int64_t i = nav->nsym - n; i < nav->nsym; i++) {
+        int j = SDR_MAX_NSYM - (int)(nav->nsym - i); // index of symbol i
+        if (j < 1) continue;
+        uint8_t sym0 = data[j-1] * 255, sym1 = data[j] * 255;
+        sdr_vit_update(nav->vit[i & 1], swap ? sym1 : sym0, swap ? sym0 : sym1);
+    }
+    nav->nsym_vit = nav->nsym;
+    
+    // chainback from best state of decoder with symbol pairs ending at latest
+    if (!sdr_vit_decode(nav->vit[(nav->nsym - 1) & 1], N / 2 - 6, 6, -1,
+        bits)) {
+        uint8_t *buff = (uint8_t *)sdr_scratch_alloc(N);
+        for (int i = 0; i < N; i += 2) {
+            buff[i  ] = data[SDR_MAX_NSYM-N+i+(swap ? 1 : 0)] * 255;
+            buff[i+1] = data[SDR_MAX_NSYM-N+i+(swap ? 0 : 1)] * 255;
+        }
+        sdr_decode_conv(buff, N, bits);
+        sdr_scratch_free(buff);
+    }
+}
+
+// P correlator history --------------------------------------------------------
+static const sdr_cpx_t *corr_hist(const sdr_ch_t *ch)
+{
+    return (const sdr_cpx_t *)sdr_hist_data(ch->trk->P);
+}
 
 // average of IP correlation ---------------------------------------------------
 static float mean_IP(const sdr_ch_t *ch, int N)
 {
     float P = 0.0;
+    const sdr_cpx_t *hist = corr_hist(ch);
     
     for (int i = 0; i < N; i++) {
-        P += (ch->trk->P[SDR_N_HIST-N+i][0] - P) / (i + 1);
+        P += (hist[SDR_N_HIST-N+i][0] - P) / (i + 1);
     }
     return P;
 }
@@ -122,12 +205,13 @@ static float mean_IP(const sdr_ch_t *ch, int N)
 static int sync_symb(sdr_ch_t *ch, int N)
 {
     if (ch->nav->ssync == 0) {
+        const sdr_cpx_t *hist = corr_hist(ch);
         float P = 0.0, R = 0.0;
         int n = (N <= 2) ? 1 : N - 1;
         for (int i = 0; i < 2 * n; i++) {
             int8_t code = (i < n) ? -1 : 1;
-            P += ch->trk->P[SDR_N_HIST-2*n+i][0] * code / (2 * n);
-            R += fabsf(ch->trk->P[SDR_N_HIST-2*n+i][0]) / (2 * n);
+            P += hist[SDR_N_HIST-2*n+i][0] * code / (2 * n);
+            R += fabsf(hist[SDR_N_HIST-2*n+i][0]) / (2 * n);
         }
         if (fabsf(P) >= R && R >= THRES_SYNC) {
             ch->nav->ssync = ch->lock - n;
@@ -139,7 +223,7 @@ static int sync_symb(sdr_ch_t *ch, int N)
         float P = mean_IP(ch, N);
         if (fabsf(P) >= THRES_LOST) {
             uint8_t sym = (P >= 0.0) ? 1 : 0;
-            sdr_add_buff(ch->nav->syms, SDR_MAX_NSYM, &sym, sizeof(sym));
+            add_sym(ch, sym);
             return 1;
         }
         else {
@@ -161,41 +245,67 @@ static int sync_sec_code(sdr_ch_t *ch)
         return 0;
     }
     uint8_t sym = (mean_IP(ch, N) >= 0.0) ? 1 : 0;
-    sdr_add_buff(ch->nav->syms, SDR_MAX_NSYM, &sym, sizeof(sym));
+    add_sym(ch, sym);
     return 1;
 }
 
-// match bits normal -----------------------------------------------------------
-static int bmatch_n(const uint8_t *bits0, const uint8_t *bits1, int n, int m)
+// pack bits to word (bit i: bits[i], n <= 64) ---------------------------------
+static uint64_t pack_word(const uint8_t *bits, int n)
 {
-    for (int i = 0, nerr = 0; i < n; i++) {
-        if (bits0[i] != bits1[i] && ++nerr > m) return 0;
+    uint64_t word = 0;
+    for (int i = 0; i < n; i++) {
+        word |= (uint64_t)(bits[i] & 1) << i;
     }
-    return 1;
+    return word;
 }
 
-// match bits reverse ----------------------------------------------------------
-static int bmatch_r(const uint8_t *bits0, const uint8_t *bits1, int n, int m)
+// load bits as packed word (bit i: bits[i], n <= 64) --------------------------
+//  The bits in nav symbols buffer are extracted from packed nav symbols.
+static uint64_t load_word(const sdr_ch_t *ch, const uint8_t *bits, int n)
 {
-    for (int i = 0, nerr = 0; i < n; i++) {
-        if (bits0[i] == bits1[i] && ++nerr > m) return 0;
+    const sdr_nav_t *nav = ch->nav;
+    const uint8_t *syms = nav_syms(ch);
+    
+    if (bits < syms || bits + n > syms + SDR_MAX_NSYM) {
+        return pack_word(bits, n);
     }
-    return 1;
+    int64_t i = nav->nsym - SDR_MAX_NSYM + (bits - syms); // symbol index
+    if (i < 0) return pack_word(bits, n);
+    int off = (int)(i & 63);
+    uint64_t word = nav->psyms[(i >> 6) % SDR_NSYM_W] >> off;
+    if (off > 0) {
+        word |= nav->psyms[((i >> 6) + 1) % SDR_NSYM_W] << (64 - off);
+    }
+    return n < 64 ? word & (((uint64_t)1 << n) - 1) : word;
+}
+
+// number of unmatched bits of packed words ------------------------------------
+static int nerr_word(uint64_t word0, uint64_t word1, int n)
+{
+    uint64_t mask = n < 64 ? ((uint64_t)1 << n) - 1 : ~(uint64_t)0;
+    return __builtin_popcountll((word0 ^ word1) & mask);
+}
+
+// match bits by number of unmatched bits (0: normal, 1: reverse, -1: error) ---
+static int bmatch(int nerr, int n, int m)
+{
+    return nerr <= m ? 0 : (n - nerr <= m ? 1 : -1);
 }
 
 // sync nav frame by 2 preambles -----------------------------------------------
 static int sync_frame(sdr_ch_t *ch, const uint8_t *preamb, int n, int m,
     const uint8_t *bits, int N)
 {
-    if (bmatch_n(preamb, bits, n, m) && bmatch_n(preamb, bits + N, n, m)) {
-        sdr_log(4, "$LOG,%.3f,%s,%d,FRAME SYNC (N)", ch->time, ch->sig, ch->prn);
-        return 0; // normal
-    }
-    if (bmatch_r(preamb, bits, n, m) && bmatch_r(preamb, bits + N, n, m)) {
-        sdr_log(4, "$LOG,%.3f,%s,%d,FRAME SYNC (R)", ch->time, ch->sig, ch->prn);
-        return 1; // reversed
+    uint64_t P = pack_word(preamb, n);
+    int rev = bmatch(nerr_word(P, load_word(ch, bits, n), n), n, m);
+    
+    if (rev < 0 ||
+        bmatch(nerr_word(P, load_word(ch, bits + N, n), n), n, m) != rev) {
+        return -1;
     }
-    return -1;
+    sdr_log(4, "$LOG,%.3f,%s,%d,FRAME SYNC (%s)", ch->time, ch->sig, ch->prn,
+        rev ? "R" : "N");
+    return rev;
 }
 
 // test CRC24Q -----------------------------------------------------------------
@@ -252,16 +362,221 @@ static void unsync_nav(sdr_ch_t *ch)
     ch->tow_v = 0;
 }
 
+// nav frame decode job --------------------------------------------------------
+//  A nav frame decoder with LDPC is run by the nav decode worker thread if it
+//  is started. The decoder is called with a copy of the channel and the nav
+//  data (shadow) and the frame symbols at the time of frame sync. The results
+//  are applied to the channel by the tracking thread at the next call of
+//  sdr_nav_decode().
+//
+typedef void (*frame_dec_t)(sdr_ch_t *ch, const uint8_t *syms, int rev,
+    int seq);
+
+typedef struct sdr_nav_job_tag { // nav frame decode job type
+    int state;                  // state (0: idle, 1: queued, 2: done)
+    frame_dec_t decode;         // nav frame decoder
+    int rev, seq;               // polarity and sequence number of frame
+    int ok;                     // decode status (1: OK, 0: error)
+    int64_t nsym;               // number of nav symbols at frame sync
+    int64_t cpu;                // CPU time of decoding (ns) (option prof)
+    sdr_ch_t ch;                // shadow of channel
+    sdr_nav_t nav;              // shadow of nav data
+    uint8_t syms[MAX_JOB_SYMS]; // frame symbols
+} sdr_nav_job_t;
+
+static pthread_mutex_t job_mtx = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t job_cond = PTHREAD_COND_INITIALIZER;
+static sdr_nav_job_t *job_que[MAX_JOB]; // nav frame decode job queue
+static int job_head = 0, job_tail = 0; // head and tail of job queue
+static int job_nref = 0;        // reference count of nav decode worker
+static int job_run = 0;         // nav decode worker state (0: stop, 1: run)
+static pthread_t job_thread;    // nav decode worker thread
+
+// run nav frame decode job ----------------------------------------------------
+static void run_job(sdr_nav_job_t *job)
+{
+    int count = job->nav.count[0];
+    double t0 = job->ch.opt->prof ? sdr_get_cputime() : 0.0;
+    int64_t ts = sdr_trace_begin();
+    job->decode(&job->ch, job->syms, job->rev, job->seq);
+    sdr_trace_end("nav", job->ch.desc->sig, job->ch.no, ts);
+    job->ok = job->nav.count[0] > count;
+    job->cpu = job->ch.opt->prof ? (int64_t)((sdr_get_cputime() - t0) * 1e9) :
+        0;
+    __atomic_store_n(&job->state, 2, __ATOMIC_RELEASE);
+}
+
+// nav decode worker thread ----------------------------------------------------
+static void *job_worker(void *arg)
+{
+    sdr_trace_name("nav");
+    
+    pthread_mutex_lock(&job_mtx);
+    while (job_run || job_head != job_tail) { // drain jobs at stop
+        if (job_head == job_tail) {
+            pthread_cond_wait(&job_cond, &job_mtx);
+            continue;
+        }
+        sdr_nav_job_t *job = job_que[job_head];
+        job_head = (job_head + 1) % MAX_JOB;
+        pthread_mutex_unlock(&job_mtx);
+        run_job(job);
+        pthread_mutex_lock(&job_mtx);
+    }
+    pthread_mutex_unlock(&job_mtx);
+    sdr_scratch_release();
+    return NULL;
+}
+
+// post nav frame decode job ---------------------------------------------------
+//  The frame is decoded in place if the worker is not started or the queue is
+//  full. Otherwise the frame sync is assumed until the result is applied.
+static void post_frame(sdr_ch_t *ch, frame_dec_t decode, const uint8_t *syms,
+    int N, int rev, int seq)
+{
+    sdr_nav_t *nav = ch->nav;
+    sdr_nav_job_t *job = nav->job;
+    
+    if (job && __atomic_load_n(&job->state, __ATOMIC_ACQUIRE)) {
+        return; // previous frame being decoded
+    }
+    pthread_mutex_lock(&job_mtx);
+    int full = (job_tail + 1) % MAX_JOB == job_head;
+    if (!job_run || full) {
+        pthread_mutex_unlock(&job_mtx);
+        decode(ch, syms, rev, seq);
+        return;
+    }
+    if (!job) {
+        job = nav->job = (sdr_nav_job_t *)sdr_malloc(sizeof(sdr_nav_job_t));
+    }
+    job->decode = decode;
+    job->rev = rev;
+    job->seq = seq;
+    job->nsym = nav->nsym;
+    job->ch = *ch;
+    job->nav = *nav;
+    job->ch.nav = &job->nav;
+    memcpy(job->syms, syms, N);
+    job->state = 1;
+    job_que[job_tail] = job;
+    job_tail = (job_tail + 1) % MAX_JOB;
+    pthread_cond_signal(&job_cond);
+    pthread_mutex_unlock(&job_mtx);
+    
+    nav->fsync = ch->lock; // frame sync assumed
+    nav->rev = rev;
+}
+
+// apply result of nav frame decode job ----------------------------------------
+static void apply_job(sdr_ch_t *ch)
+{
+    sdr_nav_t *nav = ch->nav;
+    sdr_nav_job_t *job = nav->job;
+    
+    if (!job || __atomic_load_n(&job->state, __ATOMIC_ACQUIRE) != 2) return;
+    job->state = 0;
+    ch->cpu[2] += job->cpu;
+    
+    // discard result if signal lost or nav data initialized after frame sync
+    if (ch->lost != job->ch.lost || nav->nsym < job->nsym) return;
+    
+    if (job->ok) {
+        nav->ssync = job->nav.ssync;
+        nav->fsync = job->nav.fsync;
+        nav->rev = job->nav.rev;
+        nav->seq = job->nav.seq;
+        nav->nerr = job->nav.nerr;
+        nav->type = job->nav.type;
+        memcpy(nav->data, job->nav.data, SDR_MAX_DATA);
+        nav->stat = 1;
+        nav->count[0]++;
+        ch->week = job->ch.week;
+        ch->tow = job->ch.tow;
+        ch->tow_v = job->ch.tow_v;
+        if (ch->tow >= 0) { // advance tow to current cycle
+            ch->tow = (int)((ch->tow + (int64_t)(ch->lock - job->ch.lock) *
+                (int)(ch->T / 1e-3)) % (86400 * 7 * 1000));
+        }
+    }
+    else {
+        unsync_nav(ch);
+        nav->count[1]++;
+    }
+}
+
+//------------------------------------------------------------------------------
+//  Start nav decode worker thread. The frame decoders with LDPC (CNAV-2,
+//  B-CNAV1 and NavIC L1-SPS NAV) are run by the worker instead of the tracking
+//  threads after started. The worker is shared by the callers and reference
+//  counted.
+//
+//  args:
+//      none
+//
+//  returns:
+//      Status (1:OK, 0:error)
+//
+int sdr_nav_start(void)
+{
+    int stat = 1;
+    
+    pthread_mutex_lock(&job_mtx);
+    if (job_nref++ == 0) {
+        job_run = 1;
+        if (pthread_create(&job_thread, NULL, job_worker, NULL)) {
+            job_run = 0;
+            job_nref = 0;
+            stat = 0;
+        }
+    }
+    pthread_mutex_unlock(&job_mtx);
+    return stat;
+}
+
+//------------------------------------------------------------------------------
+//  Stop nav decode worker thread. The queued jobs are decoded before stop.
+//
+//  args:
+//      none
+//
+//  returns:
+//      none
+//
+void sdr_nav_stop(void)
+{
+    pthread_mutex_lock(&job_mtx);
+    if (job_nref <= 0 || --job_nref > 0) {
+        pthread_mutex_unlock(&job_mtx);
+        return;
+    }
+    job_run = 0;
+    pthread_cond_signal(&job_cond);
+    pthread_mutex_unlock(&job_mtx);
+    pthread_join(job_thread, NULL);
+}
+
 // new nav data ----------------------------------------------------------------
 sdr_nav_t *sdr_nav_new(void)
 {
-    return (sdr_nav_t *)sdr_malloc(sizeof(sdr_nav_t));
+    sdr_nav_t *nav = (sdr_nav_t *)sdr_malloc(sizeof(sdr_nav_t));
+    nav->syms = sdr_hist_new(SDR_MAX_NSYM, sizeof(uint8_t));
+    return nav;
 }
 
 // free nav data ---------------------------------------------------------------
 void sdr_nav_free(sdr_nav_t *nav)
 {
     if (!nav) return;
+    if (nav->job) { // wait for nav frame decode job
+        while (__atomic_load_n(&nav->job->state, __ATOMIC_ACQUIRE) == 1) {
+            sdr_sleep_msec(1);
+        }
+        sdr_free(nav->job);
+    }
+    sdr_hist_free(nav->syms);
+    sdr_vit_free(nav->vit[0]);
+    sdr_vit_free(nav->vit[1]);
     sdr_free(nav);
 }
 
@@ -271,27 +586,24 @@ void sdr_nav_init(sdr_nav_t *nav)
     nav->ssync = nav->fsync = nav->rev = nav->seq = nav->type = nav->stat = 0;
     nav->nerr = 0;
     nav->coff = 0.0;
-    memset(nav->syms, 0, SDR_MAX_NSYM);
+    sdr_hist_clear(nav->syms);
+    nav->nsym = nav->nsym_vit = 0;
+    memset(nav->psyms, 0, sizeof(nav->psyms));
     memset(nav->data, 0, SDR_MAX_DATA);
 }
 
 // sync SBAS message -----------------------------------------------------------
 static int sync_SBAS_msgs(const uint8_t *bits, int N)
 {
-    static const uint8_t preamb[][8] = {
-        {0, 1, 0, 1, 0, 0, 1, 1}, {1, 0, 0, 1, 1, 0, 1, 0},
-        {1, 1, 0, 0, 0, 1, 1, 0}
+    static const uint64_t preamb[] = { // {01010011}, {10011010}, {11000110}
+        0xCA, 0x59, 0x63
     };
+    uint64_t word = pack_word(bits, 8) | (pack_word(bits + N, 8) << 8);
+    
     for (int i = 0; i < 3; i++) {
-        int j = (i + 1) % 3;
-        if (bmatch_n(bits, preamb[i], 8, 0) &&
-            bmatch_n(bits + N, preamb[j], 8, 0)) {
-            return 0;
-        }
-        if (bmatch_r(bits, preamb[i], 8, 0) &&
-            bmatch_r(bits + N, preamb[j], 8, 0)) {
-            return 1;
-        }
+        uint64_t P = preamb[i] | (preamb[(i + 1) % 3] << 8);
+        int rev = bmatch(nerr_word(word, P, 16), 16, 0);
+        if (rev >= 0) return rev;
     }
     return -1;
 }
@@ -330,13 +642,10 @@ static void decode_SBAS_msgs(sdr_ch_t *ch, const uint8_t *bits, int rev)
 // search SBAS message ---------------------------------------------------------
 static void search_SBAS_msgs(sdr_ch_t *ch)
 {
-    uint8_t syms[544], bits[266];
+    uint8_t bits[266];
     
     // decode 1/2 FEC (544 syms -> 258 + 8 bits)
-    for (int i = 0; i < 544; i++) {
-        syms[i] = ch->nav->syms[SDR_MAX_NSYM-544+i] * 255;
-    }
-    sdr_decode_conv(syms, 544, bits);
+    decode_conv_syms(ch, 544, 0, bits);
     
     // search and decode SBAS message
     int rev = sync_SBAS_msgs(bits, 250);
@@ -435,7 +744,7 @@ static void decode_L1CA(sdr_ch_t *ch)
     if (!sync_symb(ch, 20)) { // sync symbol
         return;
     }
-    uint8_t *syms = ch->nav->syms + SDR_MAX_NSYM - 308;
+    uint8_t *syms = nav_syms(ch) + SDR_MAX_NSYM - 308;
     
     if (ch->nav->fsync > 0) { // sync LNAV subframe
         if (ch->lock == ch->nav->fsync + 6000) {
@@ -469,36 +778,34 @@ static void decode_L1CB(sdr_ch_t *ch)
     decode_L1CA(ch);
 }
 
-// sync CNAV-2 frame by subframe 1 symbols ([12]) ------------------------------
-static int sync_CNV2_frame(sdr_ch_t *ch, const uint8_t *syms, int toi)
+// generate CNAV-2 subframe 1 symbols ([12]) -----------------------------------
+static void gen_CNV2_SF1(void)
 {
-    // generate CNAV-2 subframe 1 symbols
-    if (!CNV2_SF1[0]) {
-        for (int t = 0; t < 400; t++) {
-            CNV2_SF1[t] = (uint8_t *)sdr_malloc(52);
-            int8_t *code = LFSR(51, rev_reg(t & 0xFF, 8), 0x9F, 8);
-            uint8_t bit9 = (uint8_t)((t >> 8) & 1);
-            CNV2_SF1[t][0] = bit9;
-            for (int i = 1; i < 52; i++) {
-                CNV2_SF1[t][i] = (uint8_t)((code[i-1] + 1) / 2) ^ bit9;
-            }
-            sdr_free(code);
+    for (int t = 0; t < 400; t++) {
+        int8_t *code = LFSR(51, rev_reg(t & 0xFF, 8), 0x9F, 8);
+        uint64_t bit9 = (uint64_t)((t >> 8) & 1);
+        CNV2_SF1[t] = bit9;
+        for (int i = 1; i < 52; i++) {
+            CNV2_SF1[t] |= ((uint64_t)((code[i-1] + 1) / 2) ^ bit9) << i;
         }
+        sdr_free(code);
     }
-    uint8_t *SF1 = CNV2_SF1[toi];
-    uint8_t *SFn = CNV2_SF1[(toi + 1) % 400];
+}
+
+// sync CNAV-2 frame by subframe 1 symbols ([12]) ------------------------------
+static int sync_CNV2_frame(sdr_ch_t *ch, const uint8_t *syms, int toi)
+{
+    pthread_once(&CNV2_once, gen_CNV2_SF1);
     
-    if (bmatch_n(syms, SF1, 52, 2) && bmatch_n(syms + 1800, SFn, 52, 2)) {
-        sdr_log(4, "$LOG,%.3f,%s,%d,FRAME SYNC (N) TOI=%d", ch->time, ch->sig,
-            ch->prn, toi);
-        return 1; // normal
+    int rev = bmatch(nerr_word(load_word(ch, syms, 52), CNV2_SF1[toi], 52),
+        52, 2);
+    if (rev < 0 || bmatch(nerr_word(load_word(ch, syms + 1800, 52),
+        CNV2_SF1[(toi + 1) % 400], 52), 52, 2) != rev) {
+        return -1;
     }
-    if (bmatch_r(syms, SF1, 52, 2) && bmatch_r(syms + 1800, SFn, 52, 2)) {
-        sdr_log(4, "$LOG,%.3f,%s,%d,FRAME SYNC (R) TOI=%d", ch->time, ch->sig,
-            ch->prn, toi);
-        return 0; // reversed
-    }
-    return -1;
+    sdr_log(4, "$LOG,%.3f,%s,%d,FRAME SYNC (%s) TOI=%d", ch->time, ch->sig,
+        ch->prn, rev ? "R" : "N", toi);
+    return !rev; // 1: normal, 0: reversed
 }
 
 // decode CNAV-2 frame ([12]) --------------------------------------------------
@@ -547,9 +854,9 @@ static void decode_CNV2(sdr_ch_t *ch, const uint8_t *syms, int rev, int toi)
 static void decode_L1CD(sdr_ch_t *ch)
 {
     // add symbol buffer
-    uint8_t sym = ch->trk->P[SDR_N_HIST-1][0] >= 0.0 ? 1 : 0;
-    sdr_add_buff(ch->nav->syms, SDR_MAX_NSYM, &sym, sizeof(sym));
-    uint8_t *syms = ch->nav->syms + SDR_MAX_NSYM - 1852;
+    uint8_t sym = corr_hist(ch)[SDR_N_HIST-1][0] >= 0.0 ? 1 : 0;
+    add_sym(ch, sym);
+    uint8_t *syms = nav_syms(ch) + SDR_MAX_NSYM - 1852;
     
     if (ch->nav->fsync > 0) { // sync CNAV-2 frame
         if (ch->lock == ch->nav->fsync + 1800) {
@@ -557,7 +864,7 @@ static void decode_L1CD(sdr_ch_t *ch)
             int rev = sync_CNV2_frame(ch, syms, toi);
             uint8_t sym = syms[52]; // WN MSB in SF2
             if (rev == ch->nav->rev && (sym ^ rev)) {
-                decode_CNV2(ch, syms, rev, toi);
+                post_frame(ch, decode_CNV2, syms, 1852, rev, toi);
             }
         }
         else if (ch->lock > ch->nav->fsync + 1800) {
@@ -570,7 +877,7 @@ static void decode_L1CD(sdr_ch_t *ch)
             int rev = sync_CNV2_frame(ch, syms, toi);
             uint8_t sym = syms[52];
             if (rev >= 0 && (sym ^ rev)) {
-                decode_CNV2(ch, syms, rev, toi);
+                post_frame(ch, decode_CNV2, syms, 1852, rev, toi);
                 break;
             }
         }
@@ -628,13 +935,10 @@ static void decode_CNAV(sdr_ch_t *ch, const uint8_t *bits, int rev)
 static void search_CNAV_frame(sdr_ch_t *ch)
 {
     static const uint8_t preamb[] = {1, 0, 0, 0, 1, 0, 1, 1};
-    uint8_t buff[644], bits[316];
+    uint8_t bits[316];
     
     // decode 1/2 FEC (644 syms -> 308 + 8 bits)
-    for (int i = 0; i < 644; i++) {
-        buff[i] = ch->nav->syms[SDR_MAX_NSYM-644+i] * 255;
-    }
-    sdr_decode_conv(buff, 644, bits);
+    decode_conv_syms(ch, 644, 0, bits);
     
     // search and decode CNAV subframe
     int rev = sync_frame(ch, preamb, 8, 0, bits, 300);
@@ -647,8 +951,8 @@ static void search_CNAV_frame(sdr_ch_t *ch)
 static void decode_L2CM(sdr_ch_t *ch)
 {
     // add symbol buffer
-    uint8_t sym = (ch->trk->P[SDR_N_HIST-1][0] >= 0.0) ? 1 : 0;
-    sdr_add_buff(ch->nav->syms, SDR_MAX_NSYM, &sym, sizeof(sym));
+    uint8_t sym = (corr_hist(ch)[SDR_N_HIST-1][0] >= 0.0) ? 1 : 0;
+    add_sym(ch, sym);
     
     if (ch->nav->fsync > 0) { // sync CNAV subframe
         if (ch->lock == ch->nav->fsync + 600) {
@@ -666,24 +970,21 @@ static void decode_L2CM(sdr_ch_t *ch)
 // sync L5 SBAS message --------------------------------------------------------
 static int sync_L5_SBAS_msgs(const uint8_t *bits, int N)
 {
-    static const uint8_t preamb[][8] = {
-        {0, 1, 0, 1}, {1, 1, 0, 0}, {0, 1, 1, 0}, {1, 0, 0, 1}, {0, 0, 1, 1},
-        {1, 0, 1, 0}
+    static const uint64_t preamb[] = { // {0101}, {1100}, {0110}, {1001},
+        0xA, 0x3, 0x6, 0x9, 0xC, 0x5   // {0011}, {1010}
     };
+    uint64_t word = 0;
+    
+    for (int i = 0; i < 4; i++) {
+        word |= pack_word(bits + i * N, 4) << (i * 4);
+    }
     for (int i = 0; i < 6; i++) {
-        int j = (i + 1) % 6, k = (i + 2) % 6, m = (i + 3) % 6;
-        if (bmatch_n(bits, preamb[i], 4, 0) &&
-            bmatch_n(bits + N, preamb[j], 4, 0) &&
-            bmatch_n(bits + 2 * N, preamb[k], 4, 0) &&
-            bmatch_n(bits + 3 * N, preamb[m], 4, 0)) {
-            return 0;
-        }
-        if (bmatch_r(bits, preamb[i], 4, 0) &&
-            bmatch_r(bits + N, preamb[j], 4, 0) &&
-            bmatch_r(bits + 2 * N, preamb[k], 4, 0) &&
-            bmatch_r(bits + 3 * N, preamb[m], 4, 0)) {
-            return 1;
+        uint64_t P = 0;
+        for (int j = 0; j < 4; j++) {
+            P |= preamb[(i + j) % 6] << (j * 4);
         }
+        int rev = bmatch(nerr_word(word, P, 16), 16, 0);
+        if (rev >= 0) return rev;
     }
     return -1;
 }
@@ -691,13 +992,10 @@ static int sync_L5_SBAS_msgs(const uint8_t *bits, int N)
 // search L5 SBAS message ------------------------------------------------------
 static void search_L5_SBAS_msgs(sdr_ch_t *ch)
 {
-    uint8_t syms[1546], bits[766];
+    uint8_t bits[766];
     
     // decode 1/2 FEC (1546 syms -> 758 + 8 bits)
-    for (int i = 0; i < 1546; i++) {
-        syms[i] = ch->nav->syms[SDR_MAX_NSYM-1546+i] * 255;
-    }
-    sdr_decode_conv(syms, 1546, bits);
+    decode_conv_syms(ch, 1546, 0, bits);
     
     // search and decode SBAS message
     int rev = sync_L5_SBAS_msgs(bits, 250);
@@ -842,7 +1140,7 @@ static void decode_L6_frame(sdr_ch_t *ch, const uint8_t *syms, int N)
 // decode L6D nav data ([5]) ---------------------------------------------------
 static void decode_L6D(sdr_ch_t *ch)
 {
-    uint8_t *syms = ch->nav->syms + SDR_MAX_NSYM - 255;
+    uint8_t *syms = nav_syms(ch) + SDR_MAX_NSYM - 255;
     
     if (ch->nav->fsync > 0) { // sync L6 frame
         if (ch->lock == ch->nav->fsync + 250) {
@@ -915,7 +1213,7 @@ static void decode_G1CA(sdr_ch_t *ch)
     if (!sync_symb(ch, 10)) { // sync symbol
         return;
     }
-    uint8_t *syms = ch->nav->syms + SDR_MAX_NSYM - 230;
+    uint8_t *syms = nav_syms(ch) + SDR_MAX_NSYM - 230;
     
     if (ch->nav->fsync > 0) { // sync GLONASS nav string
         if (ch->lock == ch->nav->fsync + 2000) {
@@ -977,15 +1275,10 @@ static void decode_glo_L1OCD_str(sdr_ch_t *ch, const uint8_t *bits, int rev)
 static void search_glo_L1OCD_str(sdr_ch_t *ch)
 {
     static uint8_t preamb[] = {0, 1, 0, 1, 1, 1, 1, 1, 0, 0, 0, 1};
-    uint8_t syms[668], bits[328];
+    uint8_t bits[328];
     
-    // swap convolutional code G1 and G2
-    for (int i = 0; i < 552; i += 2) {
-        syms[i  ] = ch->nav->syms[SDR_MAX_NSYM-552+i+1] * 255;
-        syms[i+1] = ch->nav->syms[SDR_MAX_NSYM-552+i  ] * 255;
-    }
-    // decode 1/2 FEC (552 syms -> 262 + 8 bits)
-    sdr_decode_conv(syms, 552, bits);
+    // decode 1/2 FEC (552 syms -> 262 + 8 bits) with G1 and G2 swapped
+    decode_conv_syms(ch, 552, 1, bits);
     
     // search and decode GLONASS L1OCD nav string
     int rev = sync_frame(ch, preamb, 12, 0, bits, 250);
@@ -1055,15 +1348,10 @@ static void search_glo_L3OCD_str(sdr_ch_t *ch)
     static uint8_t preamb[] = {
         0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 0, 1, 0, 1, 0, 0, 1, 1, 1, 0
     };
-    uint8_t syms[668], bits[328];
+    uint8_t bits[328];
     
-    // swap convolutional code G1 and G2
-    for (int i = 0; i < 668; i += 2) {
-        syms[i  ] = ch->nav->syms[SDR_MAX_NSYM-668+i+1] * 255;
-        syms[i+1] = ch->nav->syms[SDR_MAX_NSYM-668+i  ] * 255;
-    }
-    // decode 1/2 FEC (668 syms -> 320 + 8 bits)
-    sdr_decode_conv(syms, 668, bits);
+    // decode 1/2 FEC (668 syms -> 320 + 8 bits) with G1 and G2 swapped
+    decode_conv_syms(ch, 668, 1, bits);
     
     // search and decode GLONASS L3OCD nav string
     int rev = sync_frame(ch, preamb, 20, 1, bits, 300);
@@ -1174,9 +1462,9 @@ static void decode_E1B(sdr_ch_t *ch)
     static const uint8_t preamb[] = {0, 1, 0, 1, 1, 0, 0, 0, 0, 0};
     
     // add symbol buffer
-    uint8_t sym = (ch->trk->P[SDR_N_HIST-1][0] >= 0.0) ? 1 : 0;
-    sdr_add_buff(ch->nav->syms, SDR_MAX_NSYM, &sym, sizeof(sym));
-    uint8_t *syms = ch->nav->syms + SDR_MAX_NSYM - 510;
+    uint8_t sym = (corr_hist(ch)[SDR_N_HIST-1][0] >= 0.0) ? 1 : 0;
+    add_sym(ch, sym);
+    uint8_t *syms = nav_syms(ch) + SDR_MAX_NSYM - 510;
     
     if (ch->nav->fsync > 0) { // sync frame
         if (ch->lock == ch->nav->fsync + 500) {
@@ -1261,7 +1549,7 @@ static void decode_E5AI(sdr_ch_t *ch)
     if (!sync_sec_code(ch)) { // sync secondary code
         return;
     }
-    uint8_t *syms = ch->nav->syms + SDR_MAX_NSYM - 512;
+    uint8_t *syms = nav_syms(ch) + SDR_MAX_NSYM - 512;
     
     if (ch->nav->fsync > 0) { // sync Galileo F/NAV page
         if (ch->lock == ch->nav->fsync + 10000) {
@@ -1304,7 +1592,7 @@ static void decode_E5BI(sdr_ch_t *ch)
     if (!sync_sec_code(ch)) { // sync secondary code
         return;
     }
-    uint8_t *syms = ch->nav->syms + SDR_MAX_NSYM - 510;
+    uint8_t *syms = nav_syms(ch) + SDR_MAX_NSYM - 510;
     
     if (ch->nav->fsync > 0) { // sync frame
         if (ch->lock == ch->nav->fsync + 2000) {
@@ -1379,9 +1667,9 @@ static void decode_E6B(sdr_ch_t *ch)
         1, 0, 1, 1, 0, 1, 1, 1, 0, 1, 1, 1, 0, 0, 0, 0
     };
     // add symbol buffer
-    uint8_t sym = (ch->trk->P[SDR_N_HIST-1][0] >= 0.0) ? 1 : 0;
-    sdr_add_buff(ch->nav->syms, SDR_MAX_NSYM, &sym, sizeof(sym));
-    uint8_t *syms = ch->nav->syms + SDR_MAX_NSYM - 1016;
+    uint8_t sym = (corr_hist(ch)[SDR_N_HIST-1][0] >= 0.0) ? 1 : 0;
+    add_sym(ch, sym);
+    uint8_t *syms = nav_syms(ch) + SDR_MAX_NSYM - 1016;
     
     if (ch->nav->fsync > 0) { // sync Galileo C/NAV page
         if (ch->lock == ch->nav->fsync + 1000) {
@@ -1497,7 +1785,7 @@ static void decode_B1I_D1(sdr_ch_t *ch)
     if (!sync_sec_code(ch)) { // sync secondary code
         return;
     }
-    uint8_t *syms = ch->nav->syms + SDR_MAX_NSYM - 311;
+    uint8_t *syms = nav_syms(ch) + SDR_MAX_NSYM - 311;
     
     if (ch->nav->fsync > 0) { // sync frame
         if (ch->lock == ch->nav->fsync + 6000) {
@@ -1527,7 +1815,7 @@ static void decode_B1I_D2(sdr_ch_t *ch)
     if (!sync_symb(ch, 2)) { // sync symbol
         return;
     }
-    uint8_t *syms = ch->nav->syms + SDR_MAX_NSYM - 311;
+    uint8_t *syms = nav_syms(ch) + SDR_MAX_NSYM - 311;
     
     if (ch->nav->fsync > 0) { // sync frame
         if (ch->lock == ch->nav->fsync + 600) {
@@ -1560,45 +1848,45 @@ static void decode_B1I(sdr_ch_t *ch)
     }
 }
 
-// sync B1CD B-CNAV1 frame by subframe 1 symbols -------------------------------
-static int sync_BCNV1_frame(sdr_ch_t *ch, const uint8_t *syms, int soh)
+// generate B-CNAV1 subframe 1 symbols ([8]) -----------------------------------
+static void gen_BCNV1_SF1(void)
 {
-    // generate CNAV-1 subframe 1 symbols
-    if (!BCNV1_SF1A[ch->prn-1]) {
-        BCNV1_SF1A[ch->prn-1] = (uint8_t *)sdr_malloc(21);
-        int8_t *code = LFSR(21, rev_reg(ch->prn, 6), 0x17, 6);
+    for (int prn = 1; prn <= 63; prn++) {
+        int8_t *code = LFSR(21, rev_reg(prn, 6), 0x17, 6);
         for (int i = 0; i < 21; i++) {
-            BCNV1_SF1A[ch->prn-1][i] = (code[i] + 1) / 2;
+            BCNV1_SF1A[prn-1] |= (uint64_t)((code[i] + 1) / 2) << i;
         }
         sdr_free(code);
     }
-    if (!BCNV1_SF1B[0]) {
-        for (int soh = 0; soh < 200; soh++) {
-            BCNV1_SF1B[soh] = (uint8_t *)sdr_malloc(51);
-            int8_t *code = LFSR(51, rev_reg(soh, 8), 0x9F, 8);
-            for (int i = 0; i < 51; i++) {
-                BCNV1_SF1B[soh][i] = (code[i] + 1) / 2;
-            }
-            sdr_free(code);
+    for (int soh = 0; soh < 200; soh++) {
+        int8_t *code = LFSR(51, rev_reg(soh, 8), 0x9F, 8);
+        for (int i = 0; i < 51; i++) {
+            BCNV1_SF1B[soh] |= (uint64_t)((code[i] + 1) / 2) << i;
         }
+        sdr_free(code);
     }
-    uint8_t SF1[72], SFn[72];
-    memcpy(SF1, BCNV1_SF1A[ch->prn-1], 21);
-    memcpy(SFn, BCNV1_SF1A[ch->prn-1], 21);
-    memcpy(SF1 + 21, BCNV1_SF1B[soh], 51);
-    memcpy(SFn + 21, BCNV1_SF1B[(soh + 1) % 200], 51);
+}
+
+// sync B1CD B-CNAV1 frame by subframe 1 symbols -------------------------------
+static int sync_BCNV1_frame(sdr_ch_t *ch, const uint8_t *syms, int soh)
+{
+    pthread_once(&BCNV1_once, gen_BCNV1_SF1);
     
-    if (bmatch_n(syms, SF1, 72, 3) && bmatch_n(syms + 1800, SFn, 72, 3)) {
-        sdr_log(4, "$LOG,%.3f,%s,%d,FRAME SYNC (N) SOH=%d", ch->time, ch->sig,
-            ch->prn, soh);
-        return 1; // normal
-    }
-    if (bmatch_r(syms, SF1, 72, 3) && bmatch_r(syms + 1800, SFn, 72, 3)) {
-        sdr_log(4, "$LOG,%.3f,%s,%d,FRAME SYNC (R) SOH=%d", ch->time, ch->sig,
-            ch->prn, soh);
-        return 0; // reversed
+    // subframe 1 symbols: PRN (21 syms) + SOH (51 syms)
+    uint64_t SF1A = BCNV1_SF1A[ch->prn-1];
+    int nerr1 = nerr_word(load_word(ch, syms, 21), SF1A, 21) +
+        nerr_word(load_word(ch, syms + 21, 51), BCNV1_SF1B[soh], 51);
+    int nerr2 = nerr_word(load_word(ch, syms + 1800, 21), SF1A, 21) +
+        nerr_word(load_word(ch, syms + 1821, 51), BCNV1_SF1B[(soh + 1) % 200],
+        51);
+    int rev = bmatch(nerr1, 72, 3);
+    
+    if (rev < 0 || bmatch(nerr2, 72, 3) != rev) {
+        return -1;
     }
-    return -1;
+    sdr_log(4, "$LOG,%.3f,%s,%d,FRAME SYNC (%s) SOH=%d", ch->time, ch->sig,
+        ch->prn, rev ? "R" : "N", soh);
+    return !rev; // 1: normal, 0: reversed
 }
 
 // decode B1CD B-CNAV1 frame ([8]) ---------------------------------------------
@@ -1656,16 +1944,16 @@ static void decode_BCNV1(sdr_ch_t *ch, const uint8_t *syms, int rev, int soh)
 static void decode_B1CD(sdr_ch_t *ch)
 {
     // add symbol buffer
-    uint8_t sym = (ch->trk->P[SDR_N_HIST-1][0] >= 0.0) ? 1 : 0;
-    sdr_add_buff(ch->nav->syms, SDR_MAX_NSYM, &sym, sizeof(sym));
-    uint8_t *syms = ch->nav->syms + SDR_MAX_NSYM - 1872;
+    uint8_t sym = (corr_hist(ch)[SDR_N_HIST-1][0] >= 0.0) ? 1 : 0;
+    add_sym(ch, sym);
+    uint8_t *syms = nav_syms(ch) + SDR_MAX_NSYM - 1872;
     
     if (ch->nav->fsync > 0) { // sync B-CNAV1 frame
         if (ch->lock == ch->nav->fsync + 1800) {
             int soh = (ch->nav->seq + 1) % 200;
             int rev = sync_BCNV1_frame(ch, syms, soh);
             if (rev == ch->nav->rev) {
-                decode_BCNV1(ch, syms, rev, soh);
+                post_frame(ch, decode_BCNV1, syms, 1872, rev, soh);
             }
         }
         else if (ch->lock > ch->nav->fsync + 1800) {
@@ -1677,7 +1965,7 @@ static void decode_B1CD(sdr_ch_t *ch)
         for (int soh = 0; soh < 200; soh++) {
             int rev = sync_BCNV1_frame(ch, syms, soh);
             if (rev >= 0) {
-                decode_BCNV1(ch, syms, rev, soh);
+                post_frame(ch, decode_BCNV1, syms, 1872, rev, soh);
                 break;
             }
         }
@@ -1749,7 +2037,7 @@ static void decode_B2AD(sdr_ch_t *ch)
     if (!sync_sec_code(ch)) { // sync secondary code
         return;
     }
-    uint8_t *syms = ch->nav->syms + SDR_MAX_NSYM - 624;
+    uint8_t *syms = nav_syms(ch) + SDR_MAX_NSYM - 624;
     
     if (ch->nav->fsync > 0) { // sync frame
         if (ch->lock == ch->nav->fsync + 3000) {
@@ -1834,9 +2122,9 @@ static void decode_B2BI(sdr_ch_t *ch)
     uint8_t preamb[] = {1, 1, 1, 0, 1, 0, 1, 1, 1, 0, 0, 1, 0, 0, 0, 0};
     
     // add symbol buffer
-    uint8_t sym = (ch->trk->P[SDR_N_HIST-1][0] >= 0.0) ? 1 : 0;
-    sdr_add_buff(ch->nav->syms, SDR_MAX_NSYM, &sym, sizeof(sym));
-    uint8_t *syms = ch->nav->syms + SDR_MAX_NSYM - 1016;
+    uint8_t sym = (corr_hist(ch)[SDR_N_HIST-1][0] >= 0.0) ? 1 : 0;
+    add_sym(ch, sym);
+    uint8_t *syms = nav_syms(ch) + SDR_MAX_NSYM - 1016;
     
     if (ch->nav->fsync > 0) { // sync frame
         if (ch->lock == ch->nav->fsync + 1000) {
@@ -1864,34 +2152,32 @@ static void decode_B3I(sdr_ch_t *ch)
     decode_B1I(ch);
 }
 
-// sync I1SD NavIC L1-SPS NAV frame by subframe 1 symbols ([17]) --------------
-static int sync_IRNV1_frame(sdr_ch_t *ch, const uint8_t *syms, int toi)
+// generate NavIC L1-SPS subframe 1 symbols ([17]) -----------------------------
+static void gen_IRNV1_SF1(void)
 {
-    // generate NavIC L1-SPS subframe 1 symbols
-    if (!IRNV1_SF1[0]) {
-        for (int t = 0; t < 400; t++) {
-            IRNV1_SF1[t] = (uint8_t *)sdr_malloc(52);
-            int8_t *code = LFSR(52, rev_reg(t+1, 9), 0x1BF, 9);
-            for (int i = 0; i < 52; i++) {
-                IRNV1_SF1[t][i] = (uint8_t)((code[i] + 1) / 2);
-            }
-            sdr_free(code);
+    for (int t = 0; t < 400; t++) {
+        int8_t *code = LFSR(52, rev_reg(t+1, 9), 0x1BF, 9);
+        for (int i = 0; i < 52; i++) {
+            IRNV1_SF1[t] |= (uint64_t)((code[i] + 1) / 2) << i;
         }
+        sdr_free(code);
     }
-    uint8_t *SF1 = IRNV1_SF1[toi];
-    uint8_t *SFn = IRNV1_SF1[(toi + 1) % 400];
+}
+
+// sync I1SD NavIC L1-SPS NAV frame by subframe 1 symbols ([17]) --------------
+static int sync_IRNV1_frame(sdr_ch_t *ch, const uint8_t *syms, int toi)
+{
+    pthread_once(&IRNV1_once, gen_IRNV1_SF1);
     
-    if (bmatch_n(syms, SF1, 52, 2) && bmatch_n(syms + 1800, SFn, 52, 2)) {
-        sdr_log(4, "$LOG,%.3f,%s,%d,FRAME SYNC (N) TOI=%d", ch->time, ch->sig,
-            ch->prn, toi+1);
-        return 1; // normal
+    int rev = bmatch(nerr_word(load_word(ch, syms, 52), IRNV1_SF1[toi], 52),
+        52, 2);
+    if (rev < 0 || bmatch(nerr_word(load_word(ch, syms + 1800, 52),
+        IRNV1_SF1[(toi + 1) % 400], 52), 52, 2) != rev) {
+        return -1;
     }
-    if (bmatch_r(syms, SF1, 52, 2) && bmatch_r(syms + 1800, SFn, 52, 2)) {
-        sdr_log(4, "$LOG,%.3f,%s,%d,FRAME SYNC (R) TOI=%d", ch->time, ch->sig,
-            ch->prn, toi+1);
-        return 0; // reversed
-    }
-    return -1;
+    sdr_log(4, "$LOG,%.3f,%s,%d,FRAME SYNC (%s) TOI=%d", ch->time, ch->sig,
+        ch->prn, rev ? "R" : "N", toi+1);
+    return !rev; // 1: normal, 0: reversed
 }
 
 // decode I1SD NavIC L1-SPS NAV frame ([17]) -----------------------------------
@@ -1939,16 +2225,16 @@ static void decode_IRNV1(sdr_ch_t *ch, const uint8_t *syms, int rev, int toi)
 static void decode_I1SD(sdr_ch_t *ch)
 {
     // add symbol buffer
-    uint8_t sym = ch->trk->P[SDR_N_HIST-1][0] >= 0.0 ? 1 : 0;
-    sdr_add_buff(ch->nav->syms, SDR_MAX_NSYM, &sym, sizeof(sym));
-    uint8_t *syms = ch->nav->syms + SDR_MAX_NSYM - 1852;
+    uint8_t sym = corr_hist(ch)[SDR_N_HIST-1][0] >= 0.0 ? 1 : 0;
+    add_sym(ch, sym);
+    uint8_t *syms = nav_syms(ch) + SDR_MAX_NSYM - 1852;
     
     if (ch->nav->fsync > 0) { // sync NavIC L1-SPS NAV frame
         if (ch->lock == ch->nav->fsync + 1800) {
             int toi = (ch->nav->seq + 1) % 400;
             int rev = sync_IRNV1_frame(ch, syms, toi);
             if (rev == ch->nav->rev) {
-                decode_IRNV1(ch, syms, rev, toi);
+                post_frame(ch, decode_IRNV1, syms, 1852, rev, toi);
             }
         }
         else if (ch->lock > ch->nav->fsync + 1800) {
@@ -1960,7 +2246,7 @@ static void decode_I1SD(sdr_ch_t *ch)
         for (int toi = 0; toi < 400; toi++) {
             int rev = sync_IRNV1_frame(ch, syms, toi);
             if (rev >= 0) {
-                decode_IRNV1(ch, syms, rev, toi);
+                post_frame(ch, decode_IRNV1, syms, 1852, rev, toi);
                 break;
             }
         }
@@ -2022,7 +2308,7 @@ static void decode_I5S(sdr_ch_t *ch)
     if (!sync_symb(ch, 20)) { // sync symbol
         return;
     }
-    uint8_t *syms = ch->nav->syms + SDR_MAX_NSYM - 616;
+    uint8_t *syms = nav_syms(ch) + SDR_MAX_NSYM - 616;
     
     if (ch->nav->fsync > 0) { // sync IRNSS SPS NAV subframe
         if (ch->lock == ch->nav->fsync + 12000) {
@@ -2050,6 +2336,74 @@ static void decode_ISS(sdr_ch_t *ch)
     decode_I5S(ch);
 }
 
+// signal descriptor table -----------------------------------------------------
+static const sdr_sig_t sig_tbl[] = {
+    {"L1CA" , SDR_CORR_STD, SDR_NAV_LNAV, CODE_L1C, decode_L1CA },
+    {"L1S"  , SDR_CORR_STD, SDR_NAV_NONE, CODE_L1Z, decode_L1S  },
+    {"L1CB" , SDR_CORR_STD, SDR_NAV_LNAV, CODE_L1E, decode_L1CB },
+    {"L1CP" , SDR_CORR_STD, SDR_NAV_NONE, CODE_L1L, decode_L1CP },
+    {"L1CD" , SDR_CORR_STD, SDR_NAV_NONE, CODE_L1S, decode_L1CD },
+    {"L2CM" , SDR_CORR_STD, SDR_NAV_NONE, CODE_L2S, decode_L2CM },
+    {"L2CL" , SDR_CORR_STD, SDR_NAV_NONE, CODE_L2L, NULL        },
+    {"L5I"  , SDR_CORR_STD, SDR_NAV_NONE, CODE_L5I, decode_L5I  },
+    {"L5Q"  , SDR_CORR_STD, SDR_NAV_NONE, CODE_L5Q, decode_L5Q  },
+    {"L5SI" , SDR_CORR_STD, SDR_NAV_NONE, CODE_L5D, decode_L5SI },
+    {"L5SQ" , SDR_CORR_STD, SDR_NAV_NONE, CODE_L5P, decode_L5SQ },
+    {"L5SIV", SDR_CORR_STD, SDR_NAV_NONE, CODE_L5D, decode_L5SIV},
+    {"L5SQV", SDR_CORR_STD, SDR_NAV_NONE, CODE_L5P, decode_L5SQV},
+    {"L6D"  , SDR_CORR_FFT, SDR_NAV_NONE, CODE_L6S, decode_L6D  },
+    {"L6E"  , SDR_CORR_FFT, SDR_NAV_NONE, CODE_L6E, decode_L6E  },
+    {"G1CA" , SDR_CORR_STD, SDR_NAV_GLO , CODE_L1C, decode_G1CA },
+    {"G2CA" , SDR_CORR_STD, SDR_NAV_GLO , CODE_L2C, decode_G2CA },
+    {"G1OCD", SDR_CORR_STD, SDR_NAV_NONE, CODE_L4A, decode_G1OCD},
+    {"G1OCP", SDR_CORR_STD, SDR_NAV_NONE, CODE_L4B, decode_G1OCP},
+    {"G2OCP", SDR_CORR_STD, SDR_NAV_NONE, CODE_L6B, NULL        },
+    {"G3OCD", SDR_CORR_STD, SDR_NAV_NONE, CODE_L3I, decode_G3OCD},
+    {"G3OCP", SDR_CORR_STD, SDR_NAV_NONE, CODE_L3Q, decode_G3OCP},
+    {"E1B"  , SDR_CORR_STD, SDR_NAV_INAV, CODE_L1B, decode_E1B  },
+    {"E1C"  , SDR_CORR_STD, SDR_NAV_NONE, CODE_L1C, decode_E1C  },
+    {"E5AI" , SDR_CORR_STD, SDR_NAV_FNAV, CODE_L5I, decode_E5AI },
+    {"E5AQ" , SDR_CORR_STD, SDR_NAV_NONE, CODE_L5Q, decode_E5AQ },
+    {"E5BI" , SDR_CORR_STD, SDR_NAV_INAV, CODE_L7I, decode_E5BI },
+    {"E5BQ" , SDR_CORR_STD, SDR_NAV_NONE, CODE_L7Q, decode_E5BQ },
+    {"E6B"  , SDR_CORR_STD, SDR_NAV_NONE, CODE_L6B, decode_E6B  },
+    {"E6C"  , SDR_CORR_STD, SDR_NAV_NONE, CODE_L6C, decode_E6C  },
+    {"B1I"  , SDR_CORR_STD, SDR_NAV_BDS , CODE_L2I, decode_B1I  },
+    {"B1CD" , SDR_CORR_STD, SDR_NAV_NONE, CODE_L1D, decode_B1CD },
+    {"B1CP" , SDR_CORR_STD, SDR_NAV_NONE, CODE_L1P, decode_B1CP },
+    {"B2I"  , SDR_CORR_STD, SDR_NAV_BDS , CODE_L7I, decode_B2I  },
+    {"B2AD" , SDR_CORR_STD, SDR_NAV_NONE, CODE_L5D, decode_B2AD },
+    {"B2AP" , SDR_CORR_STD, SDR_NAV_NONE, CODE_L5P, decode_B2AP },
+    {"B2BI" , SDR_CORR_STD, SDR_NAV_NONE, CODE_L7D, decode_B2BI },
+    {"B3I"  , SDR_CORR_STD, SDR_NAV_BDS , CODE_L6I, decode_B3I  },
+    {"I1SD" , SDR_CORR_STD, SDR_NAV_NONE, CODE_L1D, decode_I1SD },
+    {"I1SP" , SDR_CORR_STD, SDR_NAV_NONE, CODE_L1P, decode_I1SP },
+    {"I5S"  , SDR_CORR_STD, SDR_NAV_IRN , CODE_L5A, decode_I5S  },
+    {"ISS"  , SDR_CORR_STD, SDR_NAV_IRN , CODE_L9A, decode_ISS  },
+    {""     , SDR_CORR_STD, SDR_NAV_NONE, 0       , NULL        }
+};
+
+//------------------------------------------------------------------------------
+//  Get signal descriptor. The descriptor is resolved once at the channel
+//  generation and stored in ch->desc to dispatch the correlator, the nav data
+//  decoder and the RINEX signal code without string comparisons.
+//
+//  args:
+//      sig      (I) signal ID
+//
+//  returns:
+//      signal descriptor (descriptor with sig = "" for unknown signal)
+//
+const sdr_sig_t *sdr_sig_desc(const char *sig)
+{
+    int i;
+    
+    for (i = 0; *sig_tbl[i].sig; i++) {
+        if (!strcmp(sig, sig_tbl[i].sig)) break;
+    }
+    return sig_tbl + i;
+}
+
 //------------------------------------------------------------------------------
 //  Decode navigation data in the correlation history of the tracking GNSS
 //  signals. The decoded subframe or message in the navigation data are saved to
@@ -2063,125 +2417,10 @@ static void decode_ISS(sdr_ch_t *ch)
 //
 void sdr_nav_decode(sdr_ch_t *ch)
 {
-    if (!strcmp(ch->sig, "L1CA")) {
-        decode_L1CA(ch);
-    }
-    else if (!strcmp(ch->sig, "L1S")) {
-        decode_L1S(ch);
-    }
-    else if (!strcmp(ch->sig, "L1CB")) {
-        decode_L1CB(ch);
-    }
-    else if (!strcmp(ch->sig, "L1CD")) {
-        decode_L1CD(ch);
-    }
-    else if (!strcmp(ch->sig, "L1CP")) {
-        decode_L1CP(ch);
-    }
-    else if (!strcmp(ch->sig, "L2CM")) {
-        decode_L2CM(ch);
-    }
-    else if (!strcmp(ch->sig, "L5I")) {
-        decode_L5I(ch);
-    }
-    else if (!strcmp(ch->sig, "L5Q")) {
-        decode_L5Q(ch);
-    }
-    else if (!strcmp(ch->sig, "L6D")) {
-        decode_L6D(ch);
-    }
-    else if (!strcmp(ch->sig, "L6E")) {
-        decode_L6E(ch);
-    }
-    else if (!strcmp(ch->sig, "L5SI")) {
-        decode_L5SI(ch);
-    }
-    else if (!strcmp(ch->sig, "L5SQ")) {
-        decode_L5SQ(ch);
-    }
-    else if (!strcmp(ch->sig, "L5SIV")) {
-        decode_L5SIV(ch);
-    }
-    else if (!strcmp(ch->sig, "L5SQV")) {
-        decode_L5SQV(ch);
-    }
-    else if (!strcmp(ch->sig, "G1CA")) {
-        decode_G1CA(ch);
-    }
-    else if (!strcmp(ch->sig, "G2CA")) {
-        decode_G2CA(ch);
-    }
-    else if (!strcmp(ch->sig, "G1OCD")) {
-        decode_G1OCD(ch);
-    }
-    else if (!strcmp(ch->sig, "G1OCP")) {
-        decode_G1OCP(ch);
-    }
-    else if (!strcmp(ch->sig, "G3OCD")) {
-        decode_G3OCD(ch);
-    }
-    else if (!strcmp(ch->sig, "G3OCP")) {
-        decode_G3OCP(ch);
-    }
-    else if (!strcmp(ch->sig, "E1B")) {
-        decode_E1B(ch);
-    }
-    else if (!strcmp(ch->sig, "E1C")) {
-        decode_E1C(ch);
-    }
-    else if (!strcmp(ch->sig, "E5AI")) {
-        decode_E5AI(ch);
-    }
-    else if (!strcmp(ch->sig, "E5AQ")) {
-        decode_E5AQ(ch);
-    }
-    else if (!strcmp(ch->sig, "E5BI")) {
-        decode_E5BI(ch);
-    }
-    else if (!strcmp(ch->sig, "E5BQ")) {
-        decode_E5BQ(ch);
-    }
-    else if (!strcmp(ch->sig, "E6B")) {
-        decode_E6B(ch);
-    }
-    else if (!strcmp(ch->sig, "E6C")) {
-        decode_E6C(ch);
-    }
-    else if (!strcmp(ch->sig, "B1I")) {
-        decode_B1I(ch);
-    }
-    else if (!strcmp(ch->sig, "B1CD")) {
-        decode_B1CD(ch);
-    }
-    else if (!strcmp(ch->sig, "B1CP")) {
-        decode_B1CP(ch);
-    }
-    else if (!strcmp(ch->sig, "B2I")) {
-        decode_B2I(ch);
-    }
-    else if (!strcmp(ch->sig, "B2AD")) {
-        decode_B2AD(ch);
-    }
-    else if (!strcmp(ch->sig, "B2AP")) {
-        decode_B2AP(ch);
-    }
-    else if (!strcmp(ch->sig, "B2BI")) {
-        decode_B2BI(ch);
-    }
-    else if (!strcmp(ch->sig, "B3I")) {
-        decode_B3I(ch);
-    }
-    else if (!strcmp(ch->sig, "I1SD")) {
-        decode_I1SD(ch);
-    }
-    else if (!strcmp(ch->sig, "I1SP")) {
-        decode_I1SP(ch);
-    }
-    else if (!strcmp(ch->sig, "I5S")) {
-        decode_I5S(ch);
-    }
-    else if (!strcmp(ch->sig, "ISS")) {
-        decode_ISS(ch);
+    apply_job(ch);
+    
+    if (ch->desc->decode) {
+        ch->desc->decode(ch);
     }
 }
 
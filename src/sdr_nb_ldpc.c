@@ -12,6 +12,8 @@
 //
 //  History:
 //  2024-01-25  1.0  port sdr_nb_ldpc.py to C
+//  2026-10-14  1.1  build decoder graph once per H-matrix with CSR adjacency
+//                   pool message storage and select EMS candidates partially
 //
 #include <math.h>
 #include "pocket_sdr.h"
@@ -26,6 +28,22 @@
 #define MAX_H_M     128         // max rows of H-matrix
 #define MAX_H_N     256         // max columns of H-matrix
 #define MAX_EDGE    1024        // max number of Tanner graph edges
+#define MAX_GRAPH   8           // max number of cached decoder graphs
+
+// type definitions -------------------------------------------------------------
+typedef struct {                // NB-LDPC decoder graph type
+    const uint8_t (*H_idx)[4];  // H-matrix indices (NULL: empty)
+    int m, n, ne;               // rows, columns and number of edges
+    int ie[MAX_EDGE], je[MAX_EDGE]; // row and column of edges
+    uint8_t he[MAX_EDGE];       // H-matrix elements of edges
+    int cn_ptr[MAX_H_M+1];      // CSR index of CN edges (m + 1)
+    int vn_ptr[MAX_H_N+1];      // CSR index of VN edges (n + 1)
+    int vn_edge[MAX_EDGE];      // CSR VN edges (ascending edge order)
+} nb_graph_t;
+
+// global variables -------------------------------------------------------------
+static nb_graph_t *nb_graph[MAX_GRAPH] = {NULL}; // decoder graph cache
+static pthread_mutex_t nb_graph_mtx = PTHREAD_MUTEX_INITIALIZER;
 
 // GF(q) tables -----------------------------------------------------------------
 static const uint8_t GF_VEC[Q_GF] = { // power -> vector ([1])
@@ -52,24 +70,19 @@ static int argmin(const float *L, int n)
     return j;
 }
 
-// swap index ------------------------------------------------------------------
-static void swap_idx(int *idx, int i, int j)
-{
-    int idx_tmp = idx[i];
-    idx[i] = idx[j];
-    idx[j] = idx_tmp;
-}
-
-// get index of sorted array ---------------------------------------------------
-static void argsort(const float *L, int n, int *idx)
+// get indices of NM_EMS smallest values (same order as stable sort) ---------
+static void argsort_ems(const float *L, int *idx)
 {
-    for (int i = 0; i < n; i++) {
-        idx[i] = i;
-    }
-    for (int i = 0; i < n - 1; i++) { // bubble sort
-        for (int j = n - 2; j >= i; j--) {
-            if (L[idx[j]] > L[idx[j+1]]) swap_idx(idx, j, j + 1);
+    uint64_t sel = 0;
+    
+    for (int k = 0; k < NM_EMS; k++) {
+        int j = -1;
+        for (int i = 0; i < Q_GF; i++) {
+            if (((sel >> i) & 1) || (j >= 0 && L[i] >= L[j])) continue;
+            j = i;
         }
+        sel |= (uint64_t)1 << j;
+        idx[k] = j;
     }
 }
 
@@ -108,20 +121,58 @@ static void gf2bin(const uint8_t *code, int n, uint8_t *syms)
     }
 }
 
-// Tanner graph edges ----------------------------------------------------------
-static int graph_edge(const uint8_t H_idx[][4], const uint8_t H_ele[][4], int m,
-    int *ie, int *je, uint8_t *he)
+// generate decoder graph of Tanner graph edges -------------------------------
+static nb_graph_t *gen_graph(const uint8_t H_idx[][4], const uint8_t H_ele[][4],
+    int m, int n)
 {
-    int ne = 0;
+    nb_graph_t *g = (nb_graph_t *)sdr_malloc(sizeof(nb_graph_t));
+    int cnt[MAX_H_N+1] = {0};
     
+    g->H_idx = H_idx;
+    g->m = m;
+    g->n = n;
     for (int i = 0; i < m; i++) {
-        for (int j = 0; j < 4 && ne < MAX_EDGE; j++) {
-            ie[ne] = i;
-            je[ne] = H_idx[i][j];
-            he[ne++] = H_ele[i][j];
+        g->cn_ptr[i] = g->ne;
+        for (int j = 0; j < 4 && g->ne < MAX_EDGE; j++) {
+            g->ie[g->ne] = i;
+            g->je[g->ne] = H_idx[i][j];
+            g->he[g->ne++] = H_ele[i][j];
         }
     }
-    return ne;
+    g->cn_ptr[m] = g->ne;
+    for (int i = 0; i < g->ne; i++) {
+        cnt[g->je[i]+1]++;
+    }
+    for (int i = 0; i < n; i++) {
+        g->vn_ptr[i+1] = g->vn_ptr[i] + cnt[i+1];
+        cnt[i+1] = g->vn_ptr[i];
+    }
+    for (int i = 0; i < g->ne; i++) {
+        g->vn_edge[cnt[g->je[i]+1]++] = i;
+    }
+    return g;
+}
+
+// get decoder graph (NULL: cache full) ---------------------------------------
+static const nb_graph_t *get_graph(const uint8_t H_idx[][4],
+    const uint8_t H_ele[][4], int m, int n)
+{
+    nb_graph_t *g = NULL;
+    int i;
+    
+    pthread_mutex_lock(&nb_graph_mtx);
+    for (i = 0; i < MAX_GRAPH && nb_graph[i]; i++) {
+        if (nb_graph[i]->H_idx == H_idx && nb_graph[i]->m == m &&
+            nb_graph[i]->n == n) {
+            g = nb_graph[i];
+            break;
+        }
+    }
+    if (!g && i < MAX_GRAPH) {
+        g = nb_graph[i] = gen_graph(H_idx, H_ele, m, n);
+    }
+    pthread_mutex_unlock(&nb_graph_mtx);
+    return g;
 }
 
 // copy LLR (L1 = L2.copy()) ---------------------------------------------------
@@ -151,7 +202,8 @@ static void norm_LLR(float *L)
 }
 
 // initialize LLR --------------------------------------------------------------
-static void init_LLR(const uint8_t *code, int n, float err_prob, float **L)
+static void init_LLR(const uint8_t *code, int n, float err_prob,
+    float (*L)[Q_GF])
 {
     for (int i = 0; i < n; i++) {
         for (int j = 0; j < Q_GF; j++) {
@@ -199,14 +251,14 @@ static void permute_C2V(uint8_t h, const float *C2V, float *C2V_p)
 static void ext_min_sum(float *L1, const float *L2)
 {
     float Ls[Q_GF], maxL;
-    int idx1[Q_GF], idx2[Q_GF];
+    int idx1[NM_EMS], idx2[NM_EMS];
     
     if (L1[0] < 0.0) { // first sum
         copy_LLR(L1, L2);
         return;
     }
-    argsort(L1, Q_GF, idx1);
-    argsort(L2, Q_GF, idx2);
+    argsort_ems(L1, idx1);
+    argsort_ems(L2, idx2);
     maxL = L1[idx1[NM_EMS-1]] + L2[idx2[NM_EMS-1]];
     
     for (int i = 0; i < Q_GF; i++) {
@@ -223,13 +275,31 @@ static void ext_min_sum(float *L1, const float *L2)
     copy_LLR(L1, Ls);
 }
 
-// decode NB-LDPC --------------------------------------------------------------
+//------------------------------------------------------------------------------
+//  Decode NB-LDPC (non-binary LDPC) codes over GF(64) by extended-min-sum (EMS)
+//  algorithm. The decoder graph with CSR adjacency lists of check nodes (CN)
+//  and variable nodes (VN) is generated once per H-matrix and cached. The
+//  messages are allocated in a pooled scratch buffer of the thread. The
+//  decoding terminates by the parity check at each iteration.
+//
+//  args:
+//      H_idx    (I) H-matrix column indices (m x 4)
+//      H_ele    (I) H-matrix elements (m x 4)
+//      m, n     (I) rows and columns of H-matrix
+//      syms     (I) binary codes with parity as uint8_t array (n * 6)
+//      syms_dec (O) decoded binary codes w/o parity as uint8_t array (m * 6)
+//
+//  returns:
+//      Number of corrected error bits (-1: Unable error correction)
+//
 int sdr_decode_NB_LDPC(const uint8_t H_idx[][4], const uint8_t H_ele[][4],
     int m, int n, const uint8_t *syms, uint8_t *syms_dec)
 {
-    float *V2C[MAX_EDGE], *C2V[MAX_EDGE], *L[MAX_H_N], Ls[Q_GF];
-    uint8_t code[MAX_H_N], he[MAX_EDGE];
-    int iter, ne, ie[MAX_EDGE], je[MAX_EDGE], nerr = -1;
+    const nb_graph_t *g;
+    nb_graph_t *g_tmp = NULL;
+    float Ls[Q_GF];
+    uint8_t code[MAX_H_N];
+    int nerr = -1;
     
     // initialize GF(q) tables
     init_table();
@@ -237,22 +307,25 @@ int sdr_decode_NB_LDPC(const uint8_t H_idx[][4], const uint8_t H_ele[][4],
     // convert binary codes to GF(q) codes
     bin2gf(syms, n, code);
     
-    // Tanner graph edges
-    ne = graph_edge(H_idx, H_ele, m, ie, je, he);
-    for (int i = 0; i < ne; i++) {
-        V2C[i] = (float *)sdr_malloc(sizeof(float) * Q_GF);
-        C2V[i] = (float *)sdr_malloc(sizeof(float) * Q_GF);
+    // decoder graph
+    if (!(g = get_graph(H_idx, H_ele, m, n))) {
+        g = g_tmp = gen_graph(H_idx, H_ele, m, n);
     }
+    const int ne = g->ne, *ie = g->ie, *je = g->je;
+    const uint8_t *he = g->he;
+    
+    // pooled messages (VN->CN, CN->VN and LLR)
+    float (*V2C)[Q_GF] = (float (*)[Q_GF])sdr_scratch_alloc(sizeof(float) *
+        Q_GF * (ne * 2 + n));
+    float (*C2V)[Q_GF] = V2C + ne;
+    float (*L)[Q_GF] = C2V + ne;
+    
     // initialize LLR and VN->CN messages
-    for (int i = 0; i < n; i++) {
-        L[i] = (float *)sdr_malloc(sizeof(float) * Q_GF);
-    }
     init_LLR(code, n, ERR_PROB, L);
-    
     for (int i = 0; i < ne; i++) {
         permute_V2C(he[i], L[je[i]], V2C[i]);
     }
-    for (iter = 0; iter < MAX_ITER; iter++) {
+    for (int iter = 0; iter < MAX_ITER; iter++) {
         // parity check
         if (check_parity(ie, je, he, ne, m, code)) {
             nerr = 0;
@@ -264,45 +337,37 @@ int sdr_decode_NB_LDPC(const uint8_t H_idx[][4], const uint8_t H_ele[][4],
             break;
         }
         // update check nodes
-        for (int i = 0; i < ne; i++) {
-            Ls[0] = -1.0; // initial LLR
-            for (int j = 0; j < ne; j++) {
-                if (ie[i] == ie[j] && i != j) {
-                    ext_min_sum(Ls, V2C[j]);
+        for (int c = 0; c < m; c++) {
+            for (int i = g->cn_ptr[c]; i < g->cn_ptr[c+1]; i++) {
+                Ls[0] = -1.0; // initial LLR
+                for (int j = g->cn_ptr[c]; j < g->cn_ptr[c+1]; j++) {
+                    if (i != j) ext_min_sum(Ls, V2C[j]);
                 }
+                norm_LLR(Ls);
+                permute_C2V(he[i], Ls, C2V[i]);
             }
-            norm_LLR(Ls);
-            permute_C2V(he[i], Ls, C2V[i]);
         }
-        // update variable nodes
-        for (int i = 0; i < ne; i++) {
-            copy_LLR(Ls, L[je[i]]);
-            for (int j = 0; j < ne; j++) {
-                if (je[i] == je[j] && i != j) {
-                    add_LLR(Ls, C2V[j]);
+        // update variable nodes, LLR and GF(q) codes
+        for (int v = 0; v < n; v++) {
+            const int *e = g->vn_edge + g->vn_ptr[v];
+            int ne_v = g->vn_ptr[v+1] - g->vn_ptr[v];
+            
+            for (int k = 0; k < ne_v; k++) {
+                copy_LLR(Ls, L[v]);
+                for (int j = 0; j < ne_v; j++) {
+                    if (j != k) add_LLR(Ls, C2V[e[j]]);
                 }
+                norm_LLR(Ls);
+                permute_V2C(he[e[k]], Ls, V2C[e[k]]);
             }
-            norm_LLR(Ls);
-            permute_V2C(he[i], Ls, V2C[i]);
-        }
-        // update LLR and GF(q) codes
-        for (int i = 0; i < n; i++) {
-            for (int j = 0; j < ne; j++) {
-                if (i == je[j]) {
-                    add_LLR(L[i], C2V[j]);
-                }
+            for (int j = 0; j < ne_v; j++) {
+                add_LLR(L[v], C2V[e[j]]);
             }
-            norm_LLR(L[i]);
-            code[i] = (uint8_t)argmin(L[i], Q_GF);
+            norm_LLR(L[v]);
+            code[v] = (uint8_t)argmin(L[v], Q_GF);
         }
     }
-    for (int i = 0; i < ne; i++) {
-        sdr_free(V2C[i]);
-        sdr_free(C2V[i]);
-    }
-    for (int i = 0; i < n; i++) {
-        sdr_free(L[i]);
-    }
+    sdr_scratch_free(V2C);
+    sdr_free(g_tmp);
     return nerr;
 }
-
@@ -0,0 +1,523 @@
+//
+//  Pocket SDR C Library - Network IF Data Stream Functions.
+//
+//  The network IF data stream carries the IF data of a SDR device (e.g. raw
+//  RAW8/RAW16 data of a Pocket SDR FE device) from a capture node to compute
+//  nodes over TCP, UDP or shared memory. The IF data are split into data
+//  packets of a fixed payload size with sequence numbers. The tag of the IF
+//  data (as same as the tag file) is sent as a tag packet at the start and in
+//  every NET_TAG_CYC data packets, so a node subscribing to the stream later
+//  gets the IF data format, the sampling rate, the LO frequencies and the
+//  sampling types.
+//
+//  packet format (integers in little-endian):
+//
+//    header : "PSDN" (4), type (1) ('T':tag,'D':data), version (1),
+//             payload size (2), sequence number of data packet (4)
+//    payload: tag (text) or IF data
+//
+//  The lost data packets detected by the gaps of the sequence numbers are
+//  filled with 0 to keep the time of the IF data and accounted in the
+//  statistics. If the gap exceeds NET_MAX_GAP packets (e.g. reconnected
+//  stream), the sequence numbers are synchronized again without filling and
+//  logged as "$NET,path,RESYNC SEQ=seq LOST=n" (no receiver time, signal and
+//  PRN as $LOG). The packets are resynchronized by the header after corrupted
+//  bytes.
+//
+//  stream paths:
+//
+//    send   : tcp://:port      TCP server (multiple compute nodes connected)
+//             udp://addr:port  UDP to address (unicast or broadcast)
+//             shm://name       ring buffer in shared memory (POSIX only)
+//    receive: tcp://addr:port  TCP client
+//             udp://:port      UDP server
+//             shm://name       ring buffer in shared memory (POSIX only)
+//
+//  Author:
+//  T.TAKASU
+//
+//  History:
+//  2026-10-15  1.0  new
+//
+#include "pocket_sdr.h"
+#ifndef WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// constants and macros --------------------------------------------------------
+#define NET_MAGIC     "PSDN"    // magic of packet
+#define NET_VER       1         // version of packet format
+#define NET_HEAD      12        // size of packet header (bytes)
+#define NET_TAG_CYC   1024      // cycle of tag packets (data packets)
+#define NET_MAX_GAP   4096      // max lost packets filled with 0 (packets)
+#define NET_IN_SIZE   ((SDR_NET_MAX_PKT + NET_HEAD) * 4) // size of input buffer
+#define NET_MAX_OUT   (1 << 26) // max size of received IF data (bytes)
+#define NET_SOCK_BUFF (1 << 22) // size of socket buffers (bytes)
+#define NET_SHM_MAGIC "PSDNSHM1" // magic of shared memory ring
+#define NET_SHM_HEAD  64        // size of shared memory ring header (bytes)
+#define NET_SHM_SIZE  ((int64_t)1 << 26) // size of shared memory ring (bytes)
+
+#define NET_TCP       1         // stream type: TCP
+#define NET_UDP       2         // stream type: UDP
+#define NET_SHM       3         // stream type: shared memory
+
+#define MIN(x, y)     ((x) < (y) ? (x) : (y))
+
+// get and set little-endian integers ------------------------------------------
+static uint32_t get_u4(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void set_u4(uint8_t *p, uint32_t val)
+{
+    p[0] = (uint8_t)val;
+    p[1] = (uint8_t)(val >> 8);
+    p[2] = (uint8_t)(val >> 16);
+    p[3] = (uint8_t)(val >> 24);
+}
+
+// set packet header -----------------------------------------------------------
+static void set_head(uint8_t *p, int type, int size, uint32_t seq)
+{
+    memcpy(p, NET_MAGIC, 4);
+    p[4] = (uint8_t)type;
+    p[5] = NET_VER;
+    p[6] = (uint8_t)size;
+    p[7] = (uint8_t)(size >> 8);
+    set_u4(p + 8, seq);
+}
+
+// stream type and address of path ---------------------------------------------
+static int net_type(const char *path, const char **addr)
+{
+    static const char *pre[] = {"tcp://", "udp://", "shm://"};
+    
+    for (int i = 0; i < 3; i++) {
+        if (!strncmp(path, pre[i], 6)) {
+            *addr = path + 6;
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+// open shared memory ring -----------------------------------------------------
+static int shm_open_ring(sdr_net_t *net, const char *name)
+{
+#ifdef WIN32
+    fprintf(stderr, "sdr_net: shared memory not supported\n");
+    return 0;
+#else
+    struct stat st;
+    int64_t size = NET_SHM_HEAD + NET_SHM_SIZE;
+    int fd;
+    
+    snprintf(net->name, sizeof(net->name), "/%s", name);
+    
+    if (net->mode == 0) { // send
+        if ((fd = shm_open(net->name, O_CREAT | O_RDWR, 0644)) < 0 ||
+            ftruncate(fd, (off_t)size) < 0) {
+            fprintf(stderr, "sdr_net: shared memory open error %s\n", name);
+            if (fd >= 0) close(fd);
+            return 0;
+        }
+    }
+    else if ((fd = shm_open(net->name, O_RDONLY, 0)) < 0 ||
+        fstat(fd, &st) < 0 || (size = (int64_t)st.st_size) <= NET_SHM_HEAD) {
+        fprintf(stderr, "sdr_net: shared memory open error %s\n", name);
+        if (fd >= 0) close(fd);
+        return 0;
+    }
+    void *p = mmap(NULL, (size_t)size, net->mode == 0 ? PROT_READ | PROT_WRITE :
+        PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        fprintf(stderr, "sdr_net: shared memory map error %s\n", name);
+        return 0;
+    }
+    net->shm = (uint8_t *)p;
+    net->shm_size = size - NET_SHM_HEAD;
+    int64_t *wp = (int64_t *)(net->shm + 16);
+    
+    if (net->mode == 0) {
+        memcpy(net->shm, NET_SHM_MAGIC, 8);
+        memcpy(net->shm + 8, &net->shm_size, 8);
+        __atomic_store_n(wp, 0, __ATOMIC_RELEASE);
+    }
+    else if (memcmp(net->shm, NET_SHM_MAGIC, 8)) {
+        fprintf(stderr, "sdr_net: shared memory format error %s\n", name);
+        munmap(net->shm, (size_t)size);
+        net->shm = NULL;
+        return 0;
+    }
+    else { // start reading at the write pointer
+        net->rp = __atomic_load_n(wp, __ATOMIC_ACQUIRE);
+    }
+    return 1;
+#endif
+}
+
+// close shared memory ring ----------------------------------------------------
+static void shm_close_ring(sdr_net_t *net)
+{
+#ifndef WIN32
+    if (!net->shm) return;
+    munmap(net->shm, (size_t)(net->shm_size + NET_SHM_HEAD));
+    if (net->mode == 0) {
+        shm_unlink(net->name);
+    }
+    net->shm = NULL;
+#endif
+}
+
+// write shared memory ring ----------------------------------------------------
+static void shm_write(sdr_net_t *net, const uint8_t *data, int size)
+{
+    int64_t *wp = (int64_t *)(net->shm + 16), w = *wp;
+    uint8_t *ring = net->shm + NET_SHM_HEAD;
+    int i = (int)(w % net->shm_size), n = (int)MIN(size, net->shm_size - i);
+    
+    memcpy(ring + i, data, n);
+    memcpy(ring, data + n, size - n);
+    __atomic_store_n(wp, w + size, __ATOMIC_RELEASE);
+}
+
+// read shared memory ring -----------------------------------------------------
+//  The bytes overwritten by the writer during the read are discarded and the
+//  read pointer is moved to the write pointer.
+static int shm_read(sdr_net_t *net, uint8_t *data, int size)
+{
+    int64_t *wp = (int64_t *)(net->shm + 16);
+    int64_t w = __atomic_load_n(wp, __ATOMIC_ACQUIRE), rp = net->rp;
+    const uint8_t *ring = net->shm + NET_SHM_HEAD;
+    
+    if (w < rp || w - rp > net->shm_size) { // overrun or writer restarted
+        net->rp = w;
+        net->stat[2]++;
+        return 0;
+    }
+    int n = (int)MIN(w - rp, (int64_t)size);
+    int i = (int)(rp % net->shm_size), m = (int)MIN(n, net->shm_size - i);
+    memcpy(data, ring + i, m);
+    memcpy(data + m, ring, n - m);
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    
+    if (__atomic_load_n(wp, __ATOMIC_RELAXED) - rp > net->shm_size) {
+        net->rp = __atomic_load_n(wp, __ATOMIC_ACQUIRE);
+        net->stat[2]++;
+        return 0;
+    }
+    net->rp = rp + n;
+    return n;
+}
+
+//------------------------------------------------------------------------------
+//  Open a network IF data stream.
+//
+//  args:
+//      path     (I)  stream path (see the head of the file)
+//      mode     (I)  stream mode (0:send,1:receive)
+//      tag      (I)  tag of IF data (send) (NULL: receive)
+//      psize    (I)  payload size of data packets (bytes) (send) (0: default)
+//
+//  return:
+//      network IF data stream (NULL: error)
+//
+sdr_net_t *sdr_net_open(const char *path, int mode, const char *tag, int psize)
+{
+    const char *addr = "";
+    int type = net_type(path, &addr), stat = 0;
+    int opt[] = {10000, 3000, 1000, NET_SOCK_BUFF, 0};
+    
+    if (!type) {
+        fprintf(stderr, "sdr_net: stream path error %s\n", path);
+        return NULL;
+    }
+    sdr_net_t *net = (sdr_net_t *)sdr_malloc(sizeof(sdr_net_t));
+    net->type = type;
+    net->mode = mode;
+    net->psize = psize > 0 ? MIN(psize, SDR_NET_MAX_PKT) : SDR_NET_PKT;
+    if (mode == 0 && tag) {
+        snprintf(net->tag, sizeof(net->tag), "%s", tag);
+    }
+    if (type == NET_SHM) {
+        stat = shm_open_ring(net, addr);
+    }
+    else {
+        strinit(&net->str);
+        strsetopt(opt);
+        int str_type = type == NET_TCP ? (mode ? STR_TCPCLI : STR_TCPSVR) :
+            (mode ? STR_UDPSVR : STR_UDPCLI);
+        stat = stropen(&net->str, str_type, mode ? STR_MODE_R : STR_MODE_W,
+            addr);
+        if (!stat) {
+            fprintf(stderr, "sdr_net: stream open error %s\n", path);
+        }
+    }
+    if (!stat) {
+        sdr_free(net);
+        return NULL;
+    }
+    net->pkt = (uint8_t *)sdr_malloc(mode ? NET_IN_SIZE : NET_HEAD +
+        net->psize);
+    return net;
+}
+
+//------------------------------------------------------------------------------
+//  Close a network IF data stream. The IF data in the packet buffer less than
+//  a packet are discarded.
+//
+//  args:
+//      net      (I)  network IF data stream
+//
+//  return:
+//      none
+//
+void sdr_net_close(sdr_net_t *net)
+{
+    if (!net) return;
+    if (net->type == NET_SHM) {
+        shm_close_ring(net);
+    }
+    else {
+        strclose(&net->str);
+    }
+    sdr_free(net->pkt);
+    sdr_free(net->out);
+    sdr_free(net);
+}
+
+// output packet ---------------------------------------------------------------
+static void out_pkt(sdr_net_t *net, const uint8_t *pkt, int size)
+{
+    if (net->type == NET_SHM) {
+        shm_write(net, pkt, size);
+    }
+    else {
+        strwrite(&net->str, (uint8_t *)pkt, size);
+    }
+}
+
+// send tag packet -------------------------------------------------------------
+static void send_tag(sdr_net_t *net)
+{
+    uint8_t pkt[NET_HEAD + SDR_MAX_TAG];
+    int size = (int)strlen(net->tag);
+    
+    set_head(pkt, 'T', size, net->seq);
+    memcpy(pkt + NET_HEAD, net->tag, size);
+    out_pkt(net, pkt, NET_HEAD + size);
+}
+
+//------------------------------------------------------------------------------
+//  Write IF data to a network IF data stream. The IF data are sent by data
+//  packets of the payload size and the remainder is kept to the next write.
+//
+//  args:
+//      net      (I)  network IF data stream (send)
+//      data     (I)  IF data
+//      size     (I)  size of IF data (bytes)
+//
+//  return:
+//      number of data packets sent
+//
+int sdr_net_write(sdr_net_t *net, const uint8_t *data, int size)
+{
+    int npkt = 0;
+    
+    if (!net || net->mode != 0) return 0;
+    
+    for (int n; size > 0; data += n, size -= n) {
+        n = MIN(size, net->psize - net->npkt);
+        memcpy(net->pkt + NET_HEAD + net->npkt, data, n);
+        if ((net->npkt += n) < net->psize) continue;
+        if (net->seq % NET_TAG_CYC == 0) {
+            send_tag(net);
+        }
+        set_head(net->pkt, 'D', net->psize, net->seq++);
+        out_pkt(net, net->pkt, NET_HEAD + net->psize);
+        net->stat[0]++;
+        net->npkt = 0;
+        npkt++;
+    }
+    return npkt;
+}
+
+// append received IF data -----------------------------------------------------
+static void add_out(sdr_net_t *net, const uint8_t *data, int size)
+{
+    if (net->nout + size > NET_MAX_OUT) { // IF data not read
+        net->stat[3] += size;
+        return;
+    }
+    if (net->nout + size > net->size_out) {
+        int n = net->nout + size + (net->nout + size) / 2;
+        uint8_t *out = (uint8_t *)sdr_malloc(n);
+        memcpy(out, net->out, net->nout);
+        sdr_free(net->out);
+        net->out = out;
+        net->size_out = n;
+    }
+    if (data) {
+        memcpy(net->out + net->nout, data, size);
+    }
+    else {
+        memset(net->out + net->nout, 0, size);
+    }
+    net->nout += size;
+}
+
+// receive data packet ---------------------------------------------------------
+static void recv_data(sdr_net_t *net, uint32_t seq, const uint8_t *data,
+    int size)
+{
+    if (!*net->tag) return; // IF data before tag discarded
+    
+    if (net->sync) {
+        uint32_t n = seq - net->seq;
+        if (n >= 0x80000000u) { // late or duplicated packet
+            net->stat[2]++;
+            return;
+        }
+        net->stat[1] += n;
+        net->stat[3] += (int64_t)n * size;
+        if (n > NET_MAX_GAP) {
+            sdr_log(3, "$NET,%s,RESYNC SEQ=%u LOST=%u", net->type == 3 ?
+                net->name : net->str.path, seq, n);
+        }
+        else {
+            add_out(net, NULL, (int)n * size);
+        }
+    }
+    add_out(net, data, size);
+    net->seq = seq + 1;
+    net->sync = 1;
+    net->stat[0]++;
+}
+
+// parse packets in input buffer -----------------------------------------------
+static void parse_pkt(sdr_net_t *net)
+{
+    int i = 0;
+    
+    while (net->npkt - i >= NET_HEAD) {
+        const uint8_t *p = net->pkt + i;
+        int size = p[6] | (p[7] << 8);
+        if (memcmp(p, NET_MAGIC, 4) || p[5] != NET_VER ||
+            (p[4] != 'T' && p[4] != 'D') || size > SDR_NET_MAX_PKT ||
+            (p[4] == 'T' && size >= SDR_MAX_TAG)) {
+            if (!net->skip && net->sync) net->stat[2]++;
+            net->skip = 1;
+            i++;
+            continue;
+        }
+        if (net->npkt - i < NET_HEAD + size) break; // incomplete packet
+        if (p[4] == 'T') {
+            memcpy(net->tag, p + NET_HEAD, size);
+            net->tag[size] = '\0';
+        }
+        else {
+            recv_data(net, get_u4(p + 8), p + NET_HEAD, size);
+        }
+        net->skip = 0;
+        i += NET_HEAD + size;
+    }
+    memmove(net->pkt, net->pkt + i, net->npkt - i);
+    net->npkt -= i;
+}
+
+// receive packets -------------------------------------------------------------
+static int recv_pkt(sdr_net_t *net)
+{
+    int n, size = NET_IN_SIZE - net->npkt;
+    
+    if (net->type == NET_SHM) {
+        n = shm_read(net, net->pkt + net->npkt, size);
+    }
+    else {
+        n = strread(&net->str, net->pkt + net->npkt, size);
+    }
+    if (n <= 0) return 0;
+    net->npkt += n;
+    parse_pkt(net);
+    return n;
+}
+
+//------------------------------------------------------------------------------
+//  Wait for the tag of IF data from a network IF data stream. The IF data
+//  received before the tag are discarded.
+//
+//  args:
+//      net      (I)  network IF data stream (receive)
+//      tag      (O)  tag of IF data (SDR_MAX_TAG bytes)
+//      msec     (I)  timeout (ms)
+//
+//  return:
+//      status (1: OK, 0: timeout)
+//
+int sdr_net_tag(sdr_net_t *net, char *tag, int msec)
+{
+    uint32_t tick = sdr_get_tick();
+    
+    if (!net || net->mode != 1) return 0;
+    
+    while (!*net->tag) {
+        if (recv_pkt(net)) continue;
+        if ((int)(sdr_get_tick() - tick) >= msec) return 0;
+        sdr_sleep_msec(1);
+    }
+    snprintf(tag, SDR_MAX_TAG, "%s", net->tag);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//  Read IF data from a network IF data stream. The IF data of the lost data
+//  packets are read as 0.
+//
+//  args:
+//      net      (I)  network IF data stream (receive)
+//      data     (O)  IF data
+//      size     (I)  size of IF data (bytes)
+//      msec     (I)  timeout (ms)
+//
+//  return:
+//      size of IF data read (0: timeout)
+//
+int sdr_net_read(sdr_net_t *net, uint8_t *data, int size, int msec)
+{
+    uint32_t tick = sdr_get_tick();
+    
+    if (!net || net->mode != 1) return 0;
+    
+    while (net->nout < size) {
+        if (recv_pkt(net)) continue;
+        if ((int)(sdr_get_tick() - tick) >= msec) return 0;
+        sdr_sleep_msec(1);
+    }
+    memcpy(data, net->out, size);
+    memmove(net->out, net->out + size, net->nout - size);
+    net->nout -= size;
+    return size;
+}
+
+//------------------------------------------------------------------------------
+//  Get statistics of a network IF data stream.
+//
+//  args:
+//      net      (I)  network IF data stream
+//      stat     (O)  statistics {data packets sent or received, lost data
+//                    packets, packet errors, lost IF data (bytes)}
+//
+//  return:
+//      none
+//
+void sdr_net_stat(sdr_net_t *net, int64_t *stat)
+{
+    for (int i = 0; i < 4; i++) {
+        stat[i] = net ? net->stat[i] : 0;
+    }
+}
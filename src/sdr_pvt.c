@@ -6,22 +6,25 @@
 //
 //  History:
 //  2024-04-28  1.0  new
+//  2026-10-14  1.1  use signal descriptor for signal code and nav data type
+//                   solve PVT out of observation data lock for PVT thread
+//                   add API sdr_pvt_wait()
+//                   update observation data by per-channel slots w/o lock
+//                   add high-rate PVT solution by cached satellite states
+//                   take PVT parameters from options of receiver
 //
 #include "pocket_sdr.h"
 
 // constants and macros --------------------------------------------------------
-#define SDR_EPOCH      1.0      // epoch time interval (s)
-#define LAG_EPOCH      0.05     // max PVT epoch lag (s)
-#define EL_MASK        15.0     // elavation mask (deg)
+#define MAX_ITR_HR     4        // max iterations of high-rate solution
+#define MAX_RES_HR     30.0     // max RMS residual of high-rate solution (m)
+#define MAX_GDOP_HR    30.0     // max GDOP of high-rate solution
+#define GM_EARTH       3.986004418E14 // earth gravitational constant (m^3/s^2)
 #define FILE_NAV       ".pocket_navdata.csv" // navigation data file
+#define NREP_BITS      16       // bits of number of channels in pvt->nrep
 
 #define ROUND(x)   (int)floor((x) + 0.5)
 
-// global variable -------------------------------------------------------------
-double sdr_epoch     = SDR_EPOCH;
-double sdr_lag_epoch = LAG_EPOCH;
-double sdr_el_mask   = EL_MASK;
-
 // system index ----------------------------------------------------------------
 static int sys_idx(int sat)
 {
@@ -37,31 +40,6 @@ static int sys_idx(int sat)
     return -1;
 }
 
-// signal ID to signal code -----------------------------------------------------
-static uint8_t sig2code(const char *sig)
-{
-    static const char *sigs[] = {
-        "L1CA" , "L1S"  , "L1CB" , "L1CP" , "L1CD" , "L2CM" , "L2CL" ,
-        "L5I"  , "L5Q"  , "L5SI" , "L5SQ" , "L5SIV", "L5SQV", "L6D"  ,
-        "L6E"  , "G1CA" , "G2CA" , "G1OCD", "G1OCP", "G2OCP", "G3OCD",
-        "G3OCP", "E1B"  , "E1C"  , "E5AI" , "E5AQ" , "E5BI" , "E5BQ" ,
-        "E6B"  , "E6C"  , "B1I"  , "B1CD" , "B1CP" , "B2I"  , "B2AD" ,
-        "B2AP" , "B2BI" , "B3I"  , "I1SD" , "I1SP" , "I5S"  , "ISS"  , NULL
-    };
-    static const uint8_t codes[] = {
-        CODE_L1C, CODE_L1Z, CODE_L1E, CODE_L1L, CODE_L1S, CODE_L2S, CODE_L2L,
-        CODE_L5I, CODE_L5Q, CODE_L5D, CODE_L5P, CODE_L5D, CODE_L5P, CODE_L6S,
-        CODE_L6E, CODE_L1C, CODE_L2C, CODE_L4A, CODE_L4B, CODE_L6B, CODE_L3I,
-        CODE_L3Q, CODE_L1B, CODE_L1C, CODE_L5I, CODE_L5Q, CODE_L7I, CODE_L7Q,
-        CODE_L6B, CODE_L6C, CODE_L2I, CODE_L1D, CODE_L1P, CODE_L7I, CODE_L5D,
-        CODE_L5P, CODE_L7D, CODE_L6I, CODE_L1D, CODE_L1P, CODE_L5A, CODE_L9A
-    };
-    for (int i = 0; sigs[i]; i++) {
-        if (!strcmp(sig, sigs[i])) return codes[i];
-    }
-    return 0;
-}
-
 //------------------------------------------------------------------------------
 //  Output log $OBS.
 //
@@ -120,7 +98,7 @@ static void out_log_pos(double time, const sol_t *sol, int nsat)
 }
 
 // output NMEA RMC, GGA, GSA and GSV -------------------------------------------
-static void out_nmea(const sol_t *sol, const ssat_t *ssat, stream_t *str)
+static void out_nmea(const sol_t *sol, const ssat_t *ssat, sdr_str_t *str)
 {
     uint8_t buff[4096];
     int n = 0;
@@ -150,7 +128,7 @@ static int num_sigs(int idx, const obs_t *obs)
 }
 
 // output RTCM3 observation data -----------------------------------------------
-static void out_rtcm3_obs(rtcm_t *rtcm, const obs_t *obs, stream_t *str)
+static void out_rtcm3_obs(rtcm_t *rtcm, const obs_t *obs, sdr_str_t *str)
 {
     // RTCM3 MSM message types
     static const int msgs[] = {1077, 1087, 1097, 1117, 1127, 1137, 1107, 0};
@@ -185,7 +163,7 @@ static void out_rtcm3_obs(rtcm_t *rtcm, const obs_t *obs, stream_t *str)
 
 // output RTCM3 navigation data ------------------------------------------------
 static void out_rtcm3_nav(rtcm_t *rtcm, int sat, int type, const nav_t *nav,
-    stream_t *str)
+    sdr_str_t *str)
 {
     // RTCM3 navigation message types
     static const int msgs[] = {1019, 1020, 1046, 1044, 1042, 1041, 0, 0};
@@ -205,6 +183,43 @@ static void out_rtcm3_nav(rtcm_t *rtcm, int sat, int type, const nav_t *nav,
     }
 }
 
+// initialize observation slots of channels ------------------------------------
+//  The satellite and the signal index in observation data are assigned to the
+//  slot of each channel (slot[ch->no-1]) by the satellite and the signal code.
+static void init_slots(sdr_obss_t *slot, const sdr_rcv_t *rcv)
+{
+    int nsat = 0;
+    
+    for (int i = 0; i < rcv->nch; i++) {
+        const sdr_ch_t *ch = rcv->th[i]->ch;
+        sdr_obss_t *s = slot + ch->no - 1;
+        int sat, j, k;
+        
+        if (strstr(ch->sat, "R-") || strstr(ch->sat, "R+")) continue;
+        if (!(sat = satid2no(ch->sat)) || !ch->desc->code) continue;
+        
+        for (j = 0; j < i; j++) { // satellite index
+            const sdr_obss_t *s2 = slot + rcv->th[j]->ch->no - 1;
+            if (s2->sat == sat) break;
+        }
+        s->iobs = j < i ? slot[rcv->th[j]->ch->no-1].iobs : nsat++;
+        
+        // signal index (code index or extended obs index if used)
+        for (s->idx = code2idx(satsys(sat, NULL), ch->desc->code), k = NFREQ;
+            s->idx >= 0; ) {
+            for (j = 0; j < i; j++) {
+                const sdr_obss_t *s2 = slot + rcv->th[j]->ch->no - 1;
+                if (s2->sat == sat && s2->idx == s->idx) break;
+            }
+            if (j >= i) break;
+            s->idx = k < NFREQ + NEXOBS ? k++ : -1;
+        }
+        if (s->idx < 0) continue;
+        s->sat = sat;
+        s->code = ch->desc->code;
+    }
+}
+
 //------------------------------------------------------------------------------
 //  Generate a new SDR PVT.
 //
@@ -220,6 +235,11 @@ sdr_pvt_t *sdr_pvt_new(sdr_rcv_t *rcv)
     pvt->obs = (obs_t *)sdr_malloc(sizeof(obs_t));
     pvt->obs->data = (obsd_t *)sdr_malloc(sizeof(obsd_t) * MAXSAT);
     pvt->obs->nmax = MAXSAT;
+    pvt->satc = (sdr_satc_t *)sdr_malloc(sizeof(sdr_satc_t) * MAXSAT);
+    pvt->nslot = rcv->nch;
+    pvt->slot = (sdr_obss_t *)sdr_malloc(sizeof(sdr_obss_t) * (rcv->nch + 1));
+    pvt->iobs = (int *)sdr_malloc(sizeof(int) * (rcv->nch + 1));
+    init_slots(pvt->slot, rcv);
     pvt->nav = (nav_t *)sdr_malloc(sizeof(nav_t));
     pvt->nav->eph = (eph_t *)sdr_malloc(sizeof(eph_t) * MAXSAT * 4);
     pvt->nav->n = pvt->nav->nmax = MAXSAT * 4;
@@ -230,7 +250,10 @@ sdr_pvt_t *sdr_pvt_new(sdr_rcv_t *rcv)
     pvt->rtcm = (rtcm_t *)sdr_malloc(sizeof(rtcm_t));
     init_rtcm(pvt->rtcm);
     pvt->rcv = rcv;
+    pvt->opt = &rcv->opt;
     pthread_mutex_init(&pvt->mtx, NULL);
+    pthread_mutex_init(&pvt->obs_mtx, NULL);
+    pthread_cond_init(&pvt->cond, NULL);
     readnav(FILE_NAV, pvt->nav); // load navigation data
     return pvt;
 }
@@ -248,8 +271,14 @@ void sdr_pvt_free(sdr_pvt_t *pvt)
 {
     if (!pvt) return;
     savenav(FILE_NAV, pvt->nav); // save navigation data
+    pthread_mutex_destroy(&pvt->mtx);
+    pthread_mutex_destroy(&pvt->obs_mtx);
+    pthread_cond_destroy(&pvt->cond);
     sdr_free(pvt->obs->data);
     sdr_free(pvt->obs);
+    sdr_free(pvt->satc);
+    sdr_free(pvt->slot);
+    sdr_free(pvt->iobs);
     sdr_free(pvt->nav->eph);
     sdr_free(pvt->nav->geph);
     sdr_free(pvt->nav);
@@ -260,25 +289,50 @@ void sdr_pvt_free(sdr_pvt_t *pvt)
     sdr_free(pvt);
 }
 
-// initialize epoch time and cycle ---------------------------------------------
-static void init_epoch(sdr_pvt_t *pvt, int64_t ix, sdr_ch_t *ch)
+// open epoch ------------------------------------------------------------------
+//  The epoch is published to the channels by the epoch number pvt->nep. The
+//  epoch and the records of the channels are double-buffered by the parity of
+//  the epoch number. Called with pvt->obs_mtx locked.
+static void open_epoch(sdr_pvt_t *pvt, int64_t nep, gtime_t time, int64_t ix)
 {
-    if (!ch->week) return;
-    double tow = floor(ch->tow * 1e-3 / sdr_epoch) * sdr_epoch + sdr_epoch;
-    pvt->time = gpst2time(ch->week, tow);
-    pvt->ix = ix + ROUND((tow - ch->tow * 1e-3 - 0.07) / SDR_CYC);
-    pvt->ix = (pvt->ix / 20) * 20; // round by 20 ms
+    pvt->ep[nep & 1].time = time;
+    pvt->ep[nep & 1].ix = ix;
+    __atomic_store_n(&pvt->nrep[nep & 1], nep << NREP_BITS, __ATOMIC_RELAXED);
+    __atomic_store_n(&pvt->nep, nep, __ATOMIC_RELEASE);
 }
 
-// get observation data index --------------------------------------------------
-static int data_idx(int sat, obsd_t *data, uint8_t code)
+// number of channels updated epoch --------------------------------------------
+static int num_report(sdr_pvt_t *pvt, int64_t nep)
 {
-    int i = code2idx(satsys(sat, NULL), code);
-    if (!data->code[i]) return i;
-    for (i = NFREQ; i < NFREQ + NEXOBS; i++) {
-        if (!data->code[i]) return i;
-    }
-    return -1;
+    int64_t val = __atomic_load_n(&pvt->nrep[nep & 1], __ATOMIC_ACQUIRE);
+    
+    return (val >> NREP_BITS) == nep ?
+        (int)(val & ((1 << NREP_BITS) - 1)) : 0;
+}
+
+// add channel updated epoch ---------------------------------------------------
+//  The counter keeps the epoch number, so a late report of the epoch after the
+//  slot reopened for the epoch nep + 2 is skipped.
+static int add_report(sdr_pvt_t *pvt, int64_t nep)
+{
+    int64_t *p = &pvt->nrep[nep & 1];
+    int64_t val = __atomic_load_n(p, __ATOMIC_ACQUIRE);
+    
+    do {
+        if ((val >> NREP_BITS) != nep) return 0;
+    } while (!__atomic_compare_exchange_n(p, &val, val + 1, 1,
+        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+    return (int)((val + 1) & ((1 << NREP_BITS) - 1));
+}
+
+// initialize epoch time and cycle ---------------------------------------------
+static void init_epoch(sdr_pvt_t *pvt, int64_t ix, sdr_ch_t *ch)
+{
+    if (!ch->week) return;
+    double T = pvt->opt->epoch;
+    double tow = floor(ch->tow * 1e-3 / T) * T + T;
+    ix += ROUND((tow - ch->tow * 1e-3 - 0.07) / SDR_CYC);
+    open_epoch(pvt, 1, gpst2time(ch->week, tow), (ix / 20) * 20); // 20 ms
 }
 
 // generate pseudorange --------------------------------------------------------
@@ -302,43 +356,61 @@ static double gen_prng(gtime_t time, const sdr_ch_t *ch)
     return CLIGHT * tau;
 }
 
-// update observation data -----------------------------------------------------
-static void update_obs(gtime_t time, obs_t *obs, sdr_ch_t *ch)
+// update observation record ---------------------------------------------------
+static void update_rec(gtime_t time, sdr_obsr_t *rec, int64_t nep,
+    const sdr_ch_t *ch)
 {
-    uint8_t code = sig2code(ch->sig);
-    int i, j, sat;
-    
-    if (strstr(ch->sat, "R-") || strstr(ch->sat, "R+")) return;
-    if (!(sat = satid2no(ch->sat))) return;
-    
-    for (i = 0; i < obs->n; i++) {
-        if (sat == obs->data[i].sat) break;
-    }
-    if (i >= obs->n) {
-        memset(obs->data + i, 0, sizeof(obsd_t));
-        obs->data[i].time = time;
-        obs->data[i].sat = sat;
-        obs->data[i].rcv = 1;
-        obs->n++;
-    }
-    double P = gen_prng(time, ch);
-    if (P > 0.0 && (j = data_idx(sat, obs->data + i, code)) >= 0) {
-        obs->data[i].code[j] = code;
-        obs->data[i].P[j] = P;
-        obs->data[i].L[j] = -ch->adr + (ch->nav->rev ? 0.5 : 0.0);
-        obs->data[i].D[j] = ch->fd;
-        obs->data[i].SNR[j] = (uint16_t)(ch->cn0 / SNR_UNIT + 0.5);
-        if (ch->lock * ch->T <= 2.0 || fabs(ch->trk->err_phas) > 0.2) {
-            obs->data[i].LLI[j] |= 1; // PLL unlock
+    rec->P = gen_prng(time, ch);
+    rec->L = -ch->adr + (ch->nav->rev ? 0.5 : 0.0);
+    rec->D = ch->fd;
+    rec->SNR = (uint16_t)(ch->cn0 / SNR_UNIT + 0.5);
+    rec->LLI = 0;
+    if (ch->lock * ch->T <= 2.0 || fabs(ch->trk->err_phas) > 0.2) {
+        rec->LLI |= 1; // PLL unlock
+    }
+    if (ch->nav->fsync <= 0 && ch->trk->sec_sync <= 0) {
+        rec->LLI |= 2; // half-cyc-amb unresolved
+    }
+    __atomic_store_n(&rec->nep, nep, __ATOMIC_RELEASE); // publish record
+}
+
+// collect observation data of epoch from slots --------------------------------
+static void collect_obs(sdr_pvt_t *pvt, int64_t nep, gtime_t time, obs_t *obs)
+{
+    obs->n = 0;
+    for (int i = 0; i < pvt->nslot; i++) {
+        pvt->iobs[i] = -1;
+    }
+    for (int i = 0; i < pvt->nslot; i++) {
+        const sdr_obss_t *s = pvt->slot + i;
+        const sdr_obsr_t *rec = s->rec + (nep & 1);
+        
+        if (!s->sat || __atomic_load_n(&rec->nep, __ATOMIC_ACQUIRE) != nep) {
+            continue;
         }
-        if (ch->nav->fsync <= 0 && ch->trk->sec_sync <= 0) {
-            obs->data[i].LLI[j] |= 2; // half-cyc-amb unresolved
+        int j = pvt->iobs[s->iobs];
+        if (j < 0) {
+            j = pvt->iobs[s->iobs] = obs->n++;
+            memset(obs->data + j, 0, sizeof(obsd_t));
+            obs->data[j].time = time;
+            obs->data[j].sat = s->sat;
+            obs->data[j].rcv = 1;
+        }
+        if (rec->P > 0.0) {
+            obs->data[j].code[s->idx] = s->code;
+            obs->data[j].P[s->idx] = rec->P;
+            obs->data[j].L[s->idx] = rec->L;
+            obs->data[j].D[s->idx] = (float)rec->D;
+            obs->data[j].SNR[s->idx] = rec->SNR;
+            obs->data[j].LLI[s->idx] = rec->LLI;
         }
     }
 }
 
 //------------------------------------------------------------------------------
-//  Update observation data.
+//  Update observation data. The observation record of the channel is written
+//  to the slot of the channel without lock if the channel cycle matches the
+//  open epoch.
 //
 //  args:
 //      pvt      (IO) SDR PVT
@@ -350,19 +422,32 @@ static void update_obs(gtime_t time, obs_t *obs, sdr_ch_t *ch)
 //
 void sdr_pvt_udobs(sdr_pvt_t *pvt, int64_t ix, sdr_ch_t *ch)
 {
-    pthread_mutex_lock(&pvt->mtx);
+    int64_t nep = __atomic_load_n(&pvt->nep, __ATOMIC_ACQUIRE);
     
-    if (pvt->ix <= 0) { // initialize epoch time and cycle
-        init_epoch(pvt, ix, ch);
+    if (nep <= 0) { // initialize epoch time and cycle
+        pthread_mutex_lock(&pvt->obs_mtx);
+        if (pvt->nep <= 0) init_epoch(pvt, ix, ch);
+        pthread_mutex_unlock(&pvt->obs_mtx);
+        return;
     }
-    if (ix == pvt->ix) { // update observation data
-        if (ch->state == SDR_STATE_LOCK && ch->tow >= 0 && ch->tow_v > 0 &&
-            (ch->nav->fsync > 0 || ch->trk->sec_sync > 0)) {
-            update_obs(pvt->time, pvt->obs, ch);
-        }
-        pvt->nch++;
+    const sdr_epoch_t *ep = pvt->ep + (nep & 1);
+    gtime_t time = ep->time;
+    if (ix != ep->ix || __atomic_load_n(&pvt->nep, __ATOMIC_ACQUIRE) != nep) {
+        return;
+    }
+    // update observation record
+    if (ch->no >= 1 && ch->no <= pvt->nslot && pvt->slot[ch->no-1].sat &&
+        ch->state == SDR_STATE_LOCK && ch->tow >= 0 && ch->tow_v > 0 &&
+        (ch->nav->fsync > 0 || ch->trk->sec_sync > 0)) {
+        sdr_obss_t *s = pvt->slot + ch->no - 1;
+        update_rec(time, s->rec + (nep & 1), nep, ch);
+    }
+    // notify epoch completed
+    if (add_report(pvt, nep) == pvt->rcv->nch) {
+        pthread_mutex_lock(&pvt->obs_mtx);
+        pthread_cond_signal(&pvt->cond);
+        pthread_mutex_unlock(&pvt->obs_mtx);
     }
-    pthread_mutex_unlock(&pvt->mtx);
 }
 
 //------------------------------------------------------------------------------
@@ -384,7 +469,7 @@ void sdr_pvt_udnav(sdr_pvt_t *pvt, sdr_ch_t *ch)
     
     pthread_mutex_lock(&pvt->mtx);
     
-    if (!strcmp(ch->sig, "L1CA") || !strcmp(ch->sig, "L1CB")) { // GPS/QZS LNAV
+    if (ch->desc->nav == SDR_NAV_LNAV) { // GPS/QZS LNAV
         if (ch->nav->type == 3 &&
             decode_frame(data, pvt->nav->eph + sat - 1, NULL, NULL, NULL)) {
             pvt->nav->eph[sat-1].sat = sat;
@@ -395,8 +480,9 @@ void sdr_pvt_udnav(sdr_pvt_t *pvt, sdr_ch_t *ch)
             decode_frame(data, NULL, NULL, pvt->nav->ion_gps, NULL);
         }
     }
-    else if (!strcmp(ch->sig, "G1CA") || !strcmp(ch->sig, "G2CA")) { // GLO NAV
-        pvt->nav->geph[prn-1].tof = pvt->time;
+    else if (ch->desc->nav == SDR_NAV_GLO) { // GLO NAV
+        int64_t nep = __atomic_load_n(&pvt->nep, __ATOMIC_ACQUIRE);
+        pvt->nav->geph[prn-1].tof = pvt->ep[nep & 1].time;
         if (ch->nav->type == 3 &&
             decode_glostr(data, pvt->nav->geph + prn - 1, NULL)) {
             pvt->nav->geph[prn-1].sat = sat;
@@ -405,7 +491,7 @@ void sdr_pvt_udnav(sdr_pvt_t *pvt, sdr_ch_t *ch)
             pvt->count[2]++;
         }
     }
-    else if (!strcmp(ch->sig, "E1B") || !strcmp(ch->sig, "E5BI")) { // GAL I/NAV
+    else if (ch->desc->nav == SDR_NAV_INAV) { // GAL I/NAV
         if (ch->nav->type == 4 &&
             decode_gal_inav(data, pvt->nav->eph + sat - 1, NULL, NULL)) {
             pvt->nav->eph[sat-1].sat = sat;
@@ -413,7 +499,7 @@ void sdr_pvt_udnav(sdr_pvt_t *pvt, sdr_ch_t *ch)
             pvt->count[2]++;
         }
     }
-    else if (!strcmp(ch->sig, "E5AI")) { // GAL F/NAV
+    else if (ch->desc->nav == SDR_NAV_FNAV) { // GAL F/NAV
         if (ch->nav->type == 4 &&
             decode_gal_fnav(data, pvt->nav->eph + MAXSAT + sat - 1, NULL,
                 NULL)) {
@@ -422,8 +508,7 @@ void sdr_pvt_udnav(sdr_pvt_t *pvt, sdr_ch_t *ch)
             pvt->count[2]++;
         }
     }
-    else if (!strcmp(ch->sig, "B1I") || !strcmp(ch->sig, "B2I") ||
-             !strcmp(ch->sig, "B3I")) {
+    else if (ch->desc->nav == SDR_NAV_BDS) {
         if (ch->prn >= 6 && ch->prn <= 58) { // BDS D1 NAV
             if (ch->nav->type == 5 &&
                 decode_bds_d1(data, pvt->nav->eph + sat - 1, NULL, NULL)) {
@@ -441,7 +526,7 @@ void sdr_pvt_udnav(sdr_pvt_t *pvt, sdr_ch_t *ch)
             }
         }
     }
-    else if (!strcmp(ch->sig, "I5S") || !strcmp(ch->sig, "ISS")) { // NavIC NAV
+    else if (ch->desc->nav == SDR_NAV_IRN) { // NavIC NAV
         if (ch->nav->type == 2 &&
             decode_irn_nav(data, pvt->nav->eph + sat - 1, NULL, NULL)) {
             pvt->nav->eph[sat-1].sat = sat;
@@ -466,38 +551,205 @@ static void corr_sol_time(sol_t *sol)
     }
 }
 
+// update satellite state cache by full PVT solution ---------------------------
+//  The satellite states and the corrections of the satellites used for the
+//  solution are cached. The corrections are separated from the post-fit
+//  residuals, so the high-rate solution uses the same models as pntpos().
+static void update_satc(sdr_pvt_t *pvt, const obs_t *obs, double dtr0)
+{
+    double rs[6*MAXSAT], dts[2*MAXSAT], var[MAXSAT];
+    int svh[MAXSAT];
+    const sol_t *sol = pvt->sol;
+    
+    for (int i = 0; i < MAXSAT; i++) {
+        pvt->satc[i].valid = 0;
+    }
+    satposs(obs->data[0].time, obs->data, obs->n, pvt->nav, EPHOPT_BRDC, rs,
+        dts, var, svh);
+    
+    for (int i = 0; i < obs->n; i++) {
+        const obsd_t *data = obs->data + i;
+        const ssat_t *ssat = pvt->ssat + data->sat - 1;
+        sdr_satc_t *satc = pvt->satc + data->sat - 1;
+        double e[3], r, clk;
+        int k;
+        
+        if (!ssat->vs || data->P[0] <= 0.0 ||
+            (r = geodist(rs + i * 6, sol->rr, e)) <= 0.0) {
+            continue;
+        }
+        switch (satsys(data->sat, NULL)) {
+            case SYS_GLO: k = 1; break;
+            case SYS_GAL: k = 2; break;
+            case SYS_CMP: k = 3; break;
+            case SYS_IRN: k = 4; break;
+            default     : k = 0; break;
+        }
+        clk = CLIGHT * (dtr0 + (k ? sol->dtr[k] : 0.0));
+        satc->time = data->time;
+        memcpy(satc->rs, rs + i * 6, sizeof(double) * 6);
+        memcpy(satc->dts, dts + i * 2, sizeof(double) * 2);
+        satc->isb = clk - CLIGHT * sol->dtr[0];
+        satc->corr = data->P[0] - r - clk + CLIGHT * dts[i*2] - ssat->resp[0];
+        satc->valid = 1;
+    }
+}
+
+// extrapolate satellite position and velocity in ECEF -------------------------
+static void extrap_sat(const double *rs0, double dt, double *rs)
+{
+    double r = norm(rs0, 3), a[3];
+    
+    // gravity, centrifugal and coriolis accelerations
+    for (int i = 0; i < 3; i++) {
+        a[i] = -GM_EARTH * rs0[i] / (r * r * r);
+    }
+    a[0] += OMGE * OMGE * rs0[0] + 2.0 * OMGE * rs0[4];
+    a[1] += OMGE * OMGE * rs0[1] - 2.0 * OMGE * rs0[3];
+    
+    for (int i = 0; i < 3; i++) {
+        rs[i] = rs0[i] + rs0[i+3] * dt + 0.5 * a[i] * dt * dt;
+        rs[i+3] = rs0[i+3] + a[i] * dt;
+    }
+}
+
+// high-rate PVT solution by satellite state cache -----------------------------
+//  The receiver position and clock bias are solved with the satellite states
+//  extrapolated from the cache, the cached corrections and the fixed
+//  inter-system biases. The previous solution propagated by the velocity is
+//  used as the initial guess. The velocity is updated with Doppler.
+static int update_sol_hr(sdr_pvt_t *pvt, const obs_t *obs)
+{
+    double rs[6*MAXSAT], dts[2*MAXSAT], y[MAXSAT], v[MAXSAT];
+    double H[4*MAXSAT];
+    int idx[MAXSAT];
+    sol_t *sol = pvt->sol;
+    gtime_t time = obs->data[0].time;
+    double x[4], dx[4], Q[16], e[3], tt, rms = 0.0;
+    int i, j, n = 0, nv = 0, iter;
+    
+    // satellite states extrapolated from cache
+    for (i = 0; i < obs->n; i++) {
+        const obsd_t *data = obs->data + i;
+        const sdr_satc_t *satc = pvt->satc + data->sat - 1;
+        if (!satc->valid || data->P[0] <= 0.0) continue;
+        double dt = timediff(time, satc->time);
+        extrap_sat(satc->rs, dt, rs + n * 6);
+        dts[n*2] = satc->dts[0] + satc->dts[1] * dt;
+        dts[1+n*2] = satc->dts[1];
+        y[n] = data->P[0] - satc->isb - satc->corr + CLIGHT * dts[n*2];
+        idx[n++] = i;
+    }
+    if (n < 5) return 0;
+    
+    // propagate previous solution as initial guess
+    tt = timediff(time, timeadd(sol->time, sol->dtr[0]));
+    for (j = 0; j < 3; j++) {
+        x[j] = sol->rr[j] + sol->rr[j+3] * tt;
+    }
+    x[3] = CLIGHT * sol->dtr[0];
+    
+    for (iter = 0; iter < MAX_ITR_HR; iter++) {
+        for (i = 0; i < n; i++) {
+            v[i] = y[i] - geodist(rs + i * 6, x, e) - x[3];
+            for (j = 0; j < 3; j++) H[j+i*4] = -e[j];
+            H[3+i*4] = 1.0;
+        }
+        if (lsq(H, v, 4, n, dx, Q)) return 0;
+        for (j = 0; j < 4; j++) x[j] += dx[j];
+        if (norm(dx, 4) < 1e-4) break;
+    }
+    if (iter >= MAX_ITR_HR || sqrt(Q[0] + Q[5] + Q[10] + Q[15]) > MAX_GDOP_HR) {
+        return 0;
+    }
+    
+    // validate post-fit residuals
+    for (i = 0; i < n; i++) {
+        v[i] = y[i] - geodist(rs + i * 6, x, e) - x[3];
+        rms += v[i] * v[i];
+    }
+    if (sqrt(rms / n) > MAX_RES_HR) return 0;
+    
+    sol->time = timeadd(time, -x[3] / CLIGHT);
+    sol->dtr[0] = x[3] / CLIGHT;
+    for (j = 0; j < 3; j++) sol->rr[j] = x[j];
+    sol->type = 0;
+    sol->stat = SOLQ_SINGLE;
+    sol->ns = (uint8_t)n;
+    
+    // update velocity with Doppler
+    for (i = 0; i < n; i++) {
+        const obsd_t *data = obs->data + idx[i];
+        double freq = sat2freq(data->sat, data->code[0], pvt->nav);
+        if (data->D[0] == 0.0 || freq <= 0.0) continue;
+        geodist(rs + i * 6, x, e);
+        y[nv] = -CLIGHT / freq * data->D[0] - dot(e, rs + 3 + i * 6, 3) +
+            CLIGHT * dts[1+i*2];
+        for (j = 0; j < 3; j++) H[j+nv*4] = -e[j];
+        H[3+nv*4] = 1.0;
+        nv++;
+    }
+    if (nv >= 5 && !lsq(H, y, 4, nv, dx, Q)) {
+        for (j = 0; j < 3; j++) sol->rr[j+3] = dx[j];
+    }
+    return 1;
+}
+
 // update PVT solution ---------------------------------------------------------
-static void update_sol(sdr_pvt_t *pvt)
+//  The full PVT solution by pntpos() is computed every epoch_full (s) of the
+//  options and the high-rate solutions by the satellite state cache are
+//  computed between the full solutions (epoch_full = 0: full solution every
+//  epoch).
+static void update_sol(sdr_pvt_t *pvt, const obs_t *obs, int64_t ix)
 {
     prcopt_t opt = prcopt_default;
     opt.navsys |= SYS_GLO | SYS_GAL | SYS_QZS | SYS_CMP | SYS_IRN;
     opt.err[1] = opt.err[2] = 0.03;
     opt.ionoopt = IONOOPT_BRDC;
     opt.tropopt = TROPOPT_SAAS;
-    opt.elmin = sdr_el_mask * D2R;
+    opt.elmin = pvt->opt->el_mask * D2R;
 #if 0 // RAIM-FDE on
     opt.posopt[4] = 1;
 #endif
-    double time = pvt->ix * SDR_CYC;
+    double time = ix * SDR_CYC, T_full = pvt->opt->epoch_full;
     char msg[128] = "";
     
+    // high-rate solution between full solutions
+    if (T_full > 0.0 && obs->n > 0 && pvt->sol->stat &&
+        timediff(obs->data[0].time, pvt->time_full) < T_full - 1e-6 &&
+        update_sol_hr(pvt, obs)) {
+        
+        // output log $POS and NMEA RMC, GGA, GSA and GSV
+        out_log_pos(time, pvt->sol, obs->n);
+        out_nmea(pvt->sol, pvt->ssat, pvt->rcv->strs[0]);
+        pvt->count[0]++;
+        pvt->nsat = obs->n;
+        return;
+    }
     // point positioning with L1 pseudorange
-    if (pntpos(pvt->obs->data, pvt->obs->n, pvt->nav, &opt, pvt->sol, NULL,
-             pvt->ssat, msg)) {
+    if (pntpos(obs->data, obs->n, pvt->nav, &opt, pvt->sol, NULL, pvt->ssat,
+             msg)) {
+        double dtr0 = pvt->sol->dtr[0];
         
         // correct solution time
         corr_sol_time(pvt->sol);
         
+        // update satellite state cache for high-rate solution
+        if (T_full > 0.0) {
+            update_satc(pvt, obs, dtr0);
+            pvt->time_full = obs->data[0].time;
+        }
         // output log $POS and NMEA RMC, GGA, GSA and GSV
-        out_log_pos(time, pvt->sol, pvt->obs->n);
+        out_log_pos(time, pvt->sol, obs->n);
         out_nmea(pvt->sol, pvt->ssat, pvt->rcv->strs[0]);
         pvt->count[0]++;
     }
     else {
         pvt->sol->ns = 0;
+        pvt->time_full.time = 0;
         sdr_log(3, "$LOG,%.3f,PNTPOS ERROR,%s", time, msg);
     }
-    pvt->nsat = pvt->obs->n;
+    pvt->nsat = obs->n;
     
 #if 1 // for debug
     double pos[3];
@@ -548,48 +800,89 @@ static void res_obs_amb(obs_t *obs, int sys, uint8_t code, double sec)
 }
 
 //------------------------------------------------------------------------------
-//  Update PVT solution.
+//  Update PVT solution. The observation data of the epoch are closed if all
+//  channels are updated or the epoch lag exceeds the limit. The observation
+//  data are handed off to the solution buffer and the next epoch is opened
+//  before solving PVT, so the channels updating observation data are not
+//  blocked by the computation of PVT and outputs. The function is called by
+//  the PVT thread or the receiver thread.
 //
 //  args:
 //      pvt      (IO) SDR PVT
 //      ix       (I)  received IF data cycle (cyc)
 //
 //  returns:
-//      none
+//      Status (1: epoch solved, 0: epoch not closed)
 //
-void sdr_pvt_udsol(sdr_pvt_t *pvt, int64_t ix)
+int sdr_pvt_udsol(sdr_pvt_t *pvt, int64_t ix)
 {
+    pthread_mutex_lock(&pvt->obs_mtx);
+    
+    int64_t nep = pvt->nep;
+    sdr_epoch_t ep = pvt->ep[nep & 1];
+    double T = pvt->opt->epoch;
+    double lag = fmin(pvt->opt->lag_epoch, T * 0.5); // lag within epoch
+    if (nep <= 0 || (num_report(pvt, nep) < pvt->rcv->nch &&
+        ix < ep.ix + (int)(lag / SDR_CYC))) {
+        pthread_mutex_unlock(&pvt->obs_mtx);
+        return 0;
+    }
+    // open next epoch
+    open_epoch(pvt, nep + 1, timeadd(ep.time, T), ep.ix + (int)(T / SDR_CYC));
+    pthread_mutex_unlock(&pvt->obs_mtx);
+    
     pthread_mutex_lock(&pvt->mtx);
     
-    if (pvt->ix > 0 && (pvt->nch >= pvt->rcv->nch ||
-        ix >= pvt->ix + (int)(sdr_lag_epoch / SDR_CYC))) {
-        
-        // resolve msec ambiguity in pseudorange
-        res_obs_amb(pvt->obs, SYS_GPS | SYS_QZS, CODE_L5Q, 20e-3); // L5Q
-        res_obs_amb(pvt->obs, SYS_QZS, CODE_L5P, 20e-3); // L5SQ, L5SQV
-        res_obs_amb(pvt->obs, SYS_GLO, CODE_L3Q, 10e-3); // G3OCP
-        res_obs_amb(pvt->obs, SYS_SBS, CODE_L5Q, 2e-3);  // L5Q SBAS
-        
-        // output log $OBS and RTCM3 observation data
-        out_log_obs(pvt->ix * SDR_CYC, pvt->obs);
-        out_rtcm3_obs(pvt->rtcm, pvt->obs, pvt->rcv->strs[1]);
-        if (pvt->obs->n > 0) pvt->count[1]++;
-        
-        // update PVT solution
-        update_sol(pvt);
-        
-        // set next epoch time and cycle
-        pvt->time = timeadd(pvt->time, sdr_epoch);
-        pvt->ix += (int)(sdr_epoch / SDR_CYC);
-        pvt->nch = pvt->obs->n = 0; 
-        
-        // adjust epoch cycle within 20 ms
-        if (pvt->sol->stat) {
-            double dtr = ROUND(pvt->sol->dtr[0] / 0.02) * 0.02;
-            pvt->ix += (int)(dtr / SDR_CYC);
+    // collect observation data of closed epoch
+    obs_t *obs = pvt->obs;
+    collect_obs(pvt, nep, ep.time, obs);
+    int64_t ix_sol = ep.ix;
+    
+    // resolve msec ambiguity in pseudorange
+    res_obs_amb(obs, SYS_GPS | SYS_QZS, CODE_L5Q, 20e-3); // L5Q
+    res_obs_amb(obs, SYS_QZS, CODE_L5P, 20e-3); // L5SQ, L5SQV
+    res_obs_amb(obs, SYS_GLO, CODE_L3Q, 10e-3); // G3OCP
+    res_obs_amb(obs, SYS_SBS, CODE_L5Q, 2e-3);  // L5Q SBAS
+    
+    // output log $OBS and RTCM3 observation data
+    out_log_obs(ix_sol * SDR_CYC, obs);
+    out_rtcm3_obs(pvt->rtcm, obs, pvt->rcv->strs[1]);
+    if (obs->n > 0) pvt->count[1]++;
+    
+    // update PVT solution
+    update_sol(pvt, obs, ix_sol);
+    double dtr = pvt->sol->stat ? ROUND(pvt->sol->dtr[0] / 0.02) * 0.02 : 0.0;
+    pthread_mutex_unlock(&pvt->mtx);
+    
+    // adjust epoch cycle within 20 ms by reopening next epoch
+    if (dtr != 0.0) {
+        pthread_mutex_lock(&pvt->obs_mtx);
+        if (pvt->nep == nep + 1) {
+            ep = pvt->ep[(nep + 1) & 1];
+            open_epoch(pvt, nep + 2, ep.time, ep.ix + (int)(dtr / SDR_CYC));
         }
+        pthread_mutex_unlock(&pvt->obs_mtx);
     }
-    pthread_mutex_unlock(&pvt->mtx);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//  Wait for observation data of the epoch updated by all channels.
+//
+//  args:
+//      pvt      (I)  SDR PVT
+//      msec     (I)  max wait time (ms)
+//
+//  returns:
+//      none
+//
+void sdr_pvt_wait(sdr_pvt_t *pvt, int msec)
+{
+    pthread_mutex_lock(&pvt->obs_mtx);
+    if (pvt->nep <= 0 || num_report(pvt, pvt->nep) < pvt->rcv->nch) {
+        sdr_cond_wait(&pvt->cond, &pvt->obs_mtx, msec);
+    }
+    pthread_mutex_unlock(&pvt->obs_mtx);
 }
 
 //------------------------------------------------------------------------------
@@ -616,7 +909,9 @@ void sdr_pvt_solstr(sdr_pvt_t *pvt, char *buff)
         stat = pvt->sol->stat;
     }
     else {
-        time2str(pvt->time, tstr, 3);
+        pthread_mutex_lock(&pvt->obs_mtx);
+        time2str(pvt->ep[pvt->nep & 1].time, tstr, 3);
+        pthread_mutex_unlock(&pvt->obs_mtx);
     }
     pthread_mutex_unlock(&pvt->mtx);
     
@@ -13,41 +13,191 @@
 //  2024-06-21  1.5  add API sdr_rcv_open_dev(), sdr_rcv_open_file()
 //                   sdr_rcv_close()
 //  2024-06-28  1.6  modify API sdr_rcv_open_file()
+//  2026-10-14  1.7  release scratch buffers at exit of threads
+//                   pack IF data buffers for RAW8 and RAW16
+//                   add option acq_pack, nworker to sdr_rcv_setopt()
+//                   process channels by worker thread pool with work stealing
+//                   wake up workers and receiver by condition variables
+//                   publish IF data buffer pointer by atomic operations
+//                   unpack raw IF data by SIMD kernels, support RAW16I
+//                   add option unpack_th to sdr_rcv_setopt()
+//                   unpack IF data from view of USB raw data buffer
+//                   replay IF data file as fast as possible (tscale = 0)
+//                   add API sdr_rcv_read_tag(), add option tspan
+//                   suspend channels of invisible satellites (option vis_ch)
+//                   search signals of multiple channels by priority
+//                   add option nsrch, srch_ncorr to sdr_rcv_setopt()
+//                   add option max_buff, buff_huge, buff_numa to
+//                   sdr_rcv_setopt()
+//                   add API sdr_rcv_setaff(), add option nacq
+//                   search signals by acquisition worker threads
+//                   add option trk_nco to sdr_rcv_setopt()
+//                   decode nav frames by nav decode worker (option nav_async)
+//                   solve PVT by PVT thread (option pvt_th, affinity pvt)
+//                   add option epoch_full for high-rate PVT solution
+//                   write output streams by writer threads (option
+//                   str_queue, raw_queue)
+//                   add USB transfer errors, overruns and dropped IF data to
+//                   sdr_rcv_rcv_stat()
+//                   add option usb_nbuff, usb_size for USB transfers
+//                   aggregate multiple SDR devices into a receiver, add API
+//                   sdr_rcv_new_ndev(), sdr_rcv_open_ndev()
+//                   support IF data format SDR_FMT_PACK
+//                   support compressed IF data file for input and IF data log
+//                   stream, add option raw_comp, file_th
+//                   add API sdr_rcv_gen_tag()
+//                   read IF data file by views of mapped file
+//                   add API sdr_rcv_view(), sdr_rcv_view_update()
+//                   assign RF channels of FE 2CH or RF channel mask by LO
+//                   frequencies
+//                   track narrowband signals by decimated IF data of DDCs
+//                   (option ddc)
+//                   get PSD and histogram of RF channel by streaming IF data
+//                   monitors (option mon)
+//                   publish receiver status snapshot by seqlock, add API
+//                   sdr_rcv_snapshot(), sdr_rcv_snap_rcv_str(),
+//                   sdr_rcv_snap_ch_str(), sdr_rcv_snap_sat_str()
+//                   move options and status string buffers to receiver for
+//                   multiple receivers in a process, add API sdr_rcv_defopt()
+//                   warm start by receiver state file (option warm)
+//                   CPU time of receiver stages (option prof), peak buffer
+//                   usage and late IF data cycles, add API sdr_rcv_cpu_time()
+//                   CPU time of obs update and histogram of observation age by
+//                   channels (option prof), output profiles by signal types to
+//                   log, add API sdr_rcv_snap_prof_str()
+//                   trace spans of receiver cycles, IF data buffer writes and
+//                   PVT updates, set thread names in trace
+//                   shed load by IF data buffer usage and channel priority
+//                   policy, add option shed, shed_pol to sdr_rcv_setopt()
+//                   hand over code start of locked band to other bands of
+//                   satellite, assist acquisition by channel groups of
+//                   satellites
+//                   input IF data from network IF data stream (SDR_DEV_NET),
+//                   add API sdr_rcv_open_net()
+//                   folded acquisition for long codes (option acq_fold)
+//                   read IF data file or network IF data stream ahead by
+//                   reader thread (option read_ahead)
 //
 #include "pocket_sdr.h"
 
 // constants and macros ---------------------------------------------------------
-#define MAX_BUFF   8000         // max number of IF data buffer (* SDR_CYC)
+#define MAX_BUFF   8000         // default size of IF data buffer (* SDR_CYC)
+#define MIN_BUFF   1000         // min size of IF data buffer (* SDR_CYC)
+#define MAX_BUFF_N (1 << 30)    // max size of IF data buffer (samples)
 #define LOG_CYC    1000         // receiver channel log cycle (* SDR_CYC)
-#define TH_CYC     10           // receiver channel thread cycle (ms)
+#define TH_CYC     10           // max wait for IF data of threads (ms)
 #define TO_REACQ   60.0         // re-acquisition timeout (s)
 #define MIN_LOCK   2.0          // min lock time to show channel status (s)
+#define TO_HAND    10.0         // timeout to retry handover of bands (s)
 #define NUM_COL    110          // number of channel status columns
 #define MAX_ACQ    4e-3         // max code length w/o acqusition assist (s)
 #define MAX_BUFF_USE 90         // max buffer usage rate (%)
+#define VIS_CYC    10000        // update cycle of channel visibility (* SDR_CYC)
+#define MIN_EL_VIS -5.0         // min elevation angle of visible satellite (deg)
+#define TO_VIS     60.0         // timeout to resume channels w/o fix (s)
+#define DDC_BW     0.6          // max signal bandwidth by DDC (* output rate)
+#define DDC_MIN_NCH 2           // min number of channels sharing DDC
+#define MON_CYC    5            // snapshot cycle of IF data monitor (* SDR_CYC)
+#define MAX_LATE   100          // max delay to replay IF data file (* SDR_CYC)
+#define SNAP_CYC   100          // publish cycle of status snapshot (* SDR_CYC)
+#define SHED_CYC   100          // update cycle of load shedding (* SDR_CYC)
+#define SHED_HOLD  20           // hold to recover load shedding (* SHED_CYC)
+#define SHED_SYS   "GECJRIS"    // system priority of load shedding
+#define FILE_STATE ".pocket_state.csv" // receiver state file for warm start
+#define MAX_AGE_WARM 14400.0    // max age of receiver state for warm start (s)
+#define TO_WARM    60.0         // timeout of warm start acquisition (s)
+#define TO_NET_TAG 10000        // timeout to receive tag of net stream (ms)
+#define SIZE_RCV_STAT 2048      // size of receiver status string buffer
+#define SIZE_SAT_STAT 1024      // size of satellite status string buffer
+#define SIZE_CH_STAT (120 * (SDR_MAX_NCH + 2)) // size of channel status string
+                                // buffer
+#define MON_NBLK   40           // number of blocks of IF data monitor
+#define MAX_PROF_SIG 64         // max number of signal types in profiles
 
 #define MIN(x, y)  ((x) < (y) ? (x) : (y))
+#define MAX(x, y)  ((x) > (y) ? (x) : (y))
 
 // global variables ------------------------------------------------------------
-static char rcv_rcv_stat_buff[2048];
-static char rcv_ch_stat_buff[120 * (SDR_MAX_NCH + 2)];
-static char rcv_sat_stat_buff[1024];
+static pthread_mutex_t rcv_view_mtx = PTHREAD_MUTEX_INITIALIZER; // view lock
+static const char *rcv_aff_name[] = {"ingest", "track", "acq", "pvt", NULL};
+static const double lat_edge[SDR_N_LAT-1] = { // bin edges of observation age
+    1.0, 2.0, 5.0, 10.0, 20.0, 50.0, 100.0, 200.0, 500.0 // histogram (ms)
+};
+static sdr_opt_t rcv_opt = {    // default options of SDR receivers
+    1.0, 0.05, 0.0,             // epoch, lag_epoch, epoch_full (s)
+    15.0,                       // el_mask (deg)
+    0.25,                       // sp_corr (chip)
+    0.010, 0.010,               // t_acq, t_dll (s)
+    0.25, 5.0, 5.0, 2.0,        // b_dll, b_pll, b_fll_w, b_fll_n (Hz)
+    5000.0,                     // max_dop (Hz)
+    35.0, 32.0,                 // thres_cn0_l, thres_cn0_u (dB-Hz)
+    0, 0,                       // acq_pack, acq_fold (0:off,1:on)
+    0,                          // trk_nco (0:off,1:on)
+    0,                          // nwk (0: CPU cores)
+    0,                          // nacq (0: CPUs of acq placement or no worker)
+    0,                          // unpack_th (0:off)
+    0.0,                        // tspan (s) (0: all)
+    1,                          // vis_ch (0:off,1:on)
+    0,                          // nsrch (0: acquisition workers or half of
+                                // workers)
+    0,                          // max_buff (* SDR_CYC) (0: default)
+    0, 0,                       // buff_huge (0:off,1:THP,2:2MB,3:1GB),
+                                // buff_numa (0:off)
+    1, 1,                       // nav_async, pvt_th (0: receiver thread)
+    1, 64,                      // str_queue, raw_queue (MB) (0: synchronous)
+    0,                          // raw_comp (0:off,1:on)
+    2,                          // file_th
+    256,                        // read_ahead (ms) (0: receiver thread)
+    SDR_MAX_BUFF, SDR_SIZE_BUFF >> 10, // usb_nbuff, usb_size (KB) (0: auto)
+    0,                          // ddc (0: no DDC)
+    1,                          // mon (0:off,1:on)
+    1,                          // warm (0:off,1:on)
+    0,                          // prof (0:off,1:on)
+    50.0, 431,                  // shed (%) (0:off), shed_pol
+    {"", "", "", ""}, {0}       // aff_cpus, aff_pri
+};
+
+// IF data buffer pointer protocol ---------------------------------------------
+//  The IF data buffer pointer rcv->ix (cyc) is written only by the receiver
+//  thread (single producer) after the IF data of the cycle are written to the
+//  IF data buffers, with release semantics. The worker threads and the status
+//  functions (multiple consumers) read it with acquire semantics, so the IF
+//  data up to the pointer are visible to them without the lock. rcv->mtx and
+//  rcv->cond are only used to wait for the pointer updated.
 
 // get IF data buffer pointer --------------------------------------------------
 static int64_t get_buff_ix(sdr_rcv_t *rcv)
 {
+    return __atomic_load_n(&rcv->ix, __ATOMIC_ACQUIRE);
+}
+
+// set IF data buffer pointer and wake up waiting workers ----------------------
+static void set_buff_ix(sdr_rcv_t *rcv, int64_t ix)
+{
+    __atomic_store_n(&rcv->ix, ix, __ATOMIC_RELEASE);
     pthread_mutex_lock(&rcv->mtx);
-    int64_t ix = rcv->ix;
+    pthread_cond_broadcast(&rcv->cond);
     pthread_mutex_unlock(&rcv->mtx);
-    return ix;
 }
 
-// set IF data buffer pointer --------------------------------------------------
-static void set_buff_ix(sdr_rcv_t *rcv, int64_t ix)
+// wait for IF data buffer pointer updated -------------------------------------
+static int64_t wait_buff_ix(sdr_rcv_t *rcv, int64_t ix, int msec)
 {
+    if (get_buff_ix(rcv) > ix) {
+        return get_buff_ix(rcv);
+    }
     pthread_mutex_lock(&rcv->mtx);
-    rcv->ix = ix;
+    if (get_buff_ix(rcv) <= ix) {
+        sdr_cond_wait(&rcv->cond, &rcv->mtx, msec);
+    }
     pthread_mutex_unlock(&rcv->mtx);
+    return get_buff_ix(rcv);
+}
+
+// replay IF data file as fast as possible ? -----------------------------------
+static int fast_replay(sdr_rcv_t *rcv)
+{
+    return rcv->dev == SDR_DEV_FILE && rcv->tscale <= 0.0;
 }
 
 // C/N0 bar --------------------------------------------------------------------
@@ -60,14 +210,6 @@ static void cn0_bar(float cn0, char *bar)
     }
 }
 
-// SDR receiver channel sync status --------------------------------------------
-static void sync_stat(sdr_ch_t *ch, char *stat)
-{
-    sprintf(stat, "%s%s%s%s", (ch->trk->sec_sync > 0) ? "S" : "-",
-        (ch->nav->ssync > 0) ? "B" : "-", (ch->nav->fsync > 0) ? "F" : "-",
-        (ch->nav->rev) ? "R" : "-");
-}
-
 // get number of tracking channels ---------------------------------------------
 static int get_nch_trk(sdr_rcv_t *rcv, char *sys)
 {
@@ -84,22 +226,59 @@ static int get_nch_trk(sdr_rcv_t *rcv, char *sys)
     return nch;
 }
 
+// get USB transfer errors, overruns and dropped IF data of SDR devices --------
+//  For the network IF data stream, the packet errors, the lost data packets and
+//  the lost IF data are taken instead.
+static int get_dev_stat(sdr_rcv_t *rcv, int64_t *stat)
+{
+    if (rcv->dev == SDR_DEV_NET) {
+        int64_t s[4];
+        sdr_net_stat((sdr_net_t *)rcv->dp, s);
+        stat[0] += s[2];
+        stat[1] += s[1];
+        stat[2] += s[3];
+        return 1;
+    }
+    if (rcv->dev != SDR_DEV_USB) return 0;
+    
+    for (int i = 0; i < rcv->ndev; i++) {
+        int64_t nerr, nover, ndrop;
+        if (!sdr_dev_get_stat((sdr_dev_t *)rcv->dps[i], &nerr, &nover,
+            &ndrop)) {
+            continue;
+        }
+        stat[0] += nerr;
+        stat[1] += nover;
+        stat[2] += ndrop;
+    }
+    return 1;
+}
+
+// solution string of status snapshot (see sdr_pvt_solstr()) -----------------
+static void snap_solstr(const sdr_rcv_snap_t *snap, char *buff)
+{
+    gtime_t time = {0};
+    char tstr[32];
+    
+    time.time = (time_t)floor(snap->sol_time);
+    time.sec = snap->sol_time - (double)time.time;
+    time2str(time, tstr, 3);
+    tstr[4] = tstr[7] = '-';
+    sprintf(buff, "%23s %11.7f %12.7f %8.2f %2d/%2d %s", tstr, snap->pos[0],
+        snap->pos[1], snap->pos[2], snap->ns, snap->nsat,
+        snap->sol_stat ? "FIX" : "---");
+}
+
 // print SDR receiver status header --------------------------------------------
-static int print_head(char *buff, sdr_rcv_t *rcv)
+static int print_head(char *buff, const sdr_rcv_snap_t *snap)
 {
-    char *p = buff, solstr[128] = "", sys[16] = "";
-    int nch_bb = 0, nch_trk = 0, ch_srch = 0;
-    double buff_use = 0.0;
+    char *p = buff, solstr[128] = "";
     
-    if (rcv) {
-        nch_bb = rcv->nch;
-        nch_trk = get_nch_trk(rcv, sys);
-        ch_srch = rcv->ich + 1;
-        buff_use = rcv->buff_use;
-        sdr_pvt_solstr(rcv->pvt, solstr);
+    if (snap->seq > 0) { // published by receiver
+        snap_solstr(snap, solstr);
     }
     p += sprintf(p, " %-*s BUFF:%3.0f%% SRCH:%3d LOCK:%3d/%3d\n", NUM_COL - 38,
-        solstr, buff_use, ch_srch, nch_trk, nch_bb);
+        solstr, snap->buff_use, snap->ch_srch, snap->nch_trk, snap->nch);
     p += sprintf(p, "%3s %2s %4s %5s %3s %8s %4s %-12s %11s %7s %11s %4s %5s "
         "%4s %4s %3s\n", "CH", "RF", "SAT", "SIG", "PRN", "LOCK(s)", "C/N0",
         "(dB-Hz)", "COFF(ms)", "DOP(Hz)", "ADR(cyc)", "SYNC", "#NAV", "#ERR",
@@ -108,19 +287,26 @@ static int print_head(char *buff, sdr_rcv_t *rcv)
 }
 
 // print SDR receiver channel status -------------------------------------------
-static int print_ch_stat(char *buff, sdr_ch_t *ch)
+static int print_ch_stat(char *buff, const sdr_ch_view_t *ch)
 {
-    char *p = buff, bar[16], stat[16];
-    cn0_bar(ch->cn0, bar);
-    sync_stat(ch, stat);
+    char *p = buff, bar[16];
+    cn0_bar((float)ch->cn0, bar);
     p += sprintf(p, "%3d %2d %4s %5s %3d %8.2f %4.1f %-13s%11.7f %7.1f %11.1f"
-        " %s %5d %4d %4d %3d\n", ch->no, ch->rf_ch + 1, ch->sat, ch->sig,
-        ch->prn, ch->lock * ch->T, ch->cn0, bar, ch->coff * 1e3, ch->fd,
-        ch->adr, stat, ch->nav->count[0], ch->nav->count[1], ch->lost,
-        ch->nav->nerr);
+        " %s %5d %4d %4d %3d\n", ch->no, ch->rf_ch, ch->sat, ch->sig,
+        ch->prn, ch->lock, ch->cn0, bar, ch->coff, ch->fd, ch->adr, ch->sync,
+        ch->nnav, ch->nerr, ch->lost, ch->fec);
     return (int)(p - buff);
 }
 
+// append string to buffer (the string not fit in the buffer is dropped) -------
+static int append_str(char *buff, int len, int size, const char *str)
+{
+    int n = (int)strlen(str);
+    if (len + n >= size) return len;
+    memcpy(buff + len, str, n + 1);
+    return len + n;
+}
+
 // satellite selection ---------------------------------------------------------
 static int sat_select(const char *sat, const char *sys)
 {
@@ -135,96 +321,435 @@ static int sat_select(const char *sat, const char *sys)
     return 0;
 }
 
+// update PVT status of status snapshot ----------------------------------------
+static void snap_pvt(sdr_pvt_t *pvt, sdr_rcv_snap_t *snap)
+{
+    gtime_t time;
+    
+    pthread_mutex_lock(&pvt->mtx);
+    
+    snap->pos[0] = snap->pos[1] = snap->pos[2] = 0.0;
+    snap->sol_stat = 0;
+    if (norm(pvt->sol->rr, 3) > 1e-6) {
+        time = pvt->sol->time;
+        ecef2pos(pvt->sol->rr, snap->pos);
+        snap->pos[0] *= R2D;
+        snap->pos[1] *= R2D;
+        snap->sol_stat = pvt->sol->stat;
+    }
+    else {
+        pthread_mutex_lock(&pvt->obs_mtx);
+        time = pvt->ep[pvt->nep & 1].time;
+        pthread_mutex_unlock(&pvt->obs_mtx);
+    }
+    snap->sol_time = (double)time.time + time.sec;
+    snap->ns = pvt->sol->ns;
+    snap->nsat = pvt->nsat;
+    for (int i = 0; i < 3; i++) {
+        snap->count[i] = pvt->count[i];
+    }
+    snap->nsv = 0;
+    for (int i = 0; i < MAXSAT && snap->nsv < SDR_MAX_NSAT; i++) {
+        ssat_t *ssat = pvt->ssat + i;
+        if (ssat->azel[1] <= 0.0) continue;
+        sdr_sat_snap_t *sat = snap->sat + snap->nsv++;
+        satno2id(i + 1, sat->sat);
+        sat->az = (float)(ssat->azel[0] * R2D);
+        sat->el = (float)(ssat->azel[1] * R2D);
+        sat->vs = ssat->vs;
+    }
+    pthread_mutex_unlock(&pvt->mtx);
+}
+
+// channel profile in snapshot (option prof) ----------------------------------
+static void snap_prof(const sdr_ch_t *ch, sdr_ch_prof_t *prof)
+{
+    for (int i = 0; i < 4; i++) {
+        prof->cpu[i] = __atomic_load_n(&ch->cpu[i], __ATOMIC_RELAXED) * 1e-9;
+    }
+    for (int i = 0; i < SDR_N_LAT; i++) {
+        prof->lat[i] = __atomic_load_n(&ch->lat[i], __ATOMIC_RELAXED);
+    }
+}
+
+// publish status snapshot -----------------------------------------------------
+//  The snapshot is written by the receiver thread only. The sequence is odd
+//  while being written, so the readers copy it without locking the receiver
+//  and retry if the sequence is odd or changed during the copy (seqlock).
+static void snap_update(sdr_rcv_t *rcv)
+{
+    sdr_rcv_snap_t *snap = rcv->snap;
+    uint32_t seq = snap->seq;
+    
+    __atomic_store_n(&snap->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    
+    snap->state = rcv->state;
+    snap->dev = rcv->dev;
+    snap->fmt = rcv->fmt;
+    snap->nbuff = rcv->nbuff;
+    memcpy(snap->IQ, rcv->IQ, sizeof(snap->IQ));
+    snap->shed = rcv->shed;
+    memcpy(snap->fo, rcv->fo, sizeof(snap->fo));
+    snap->time = get_buff_ix(rcv) * SDR_CYC;
+    snap->fs = rcv->fs;
+    snap->data_rate = rcv->data_rate;
+    snap->data_sum = rcv->data_sum;
+    snap->buff_use = rcv->buff_use;
+    memset(snap->dev_stat, 0, sizeof(snap->dev_stat));
+    get_dev_stat(rcv, snap->dev_stat);
+    snap_pvt(rcv->pvt, snap);
+    memset(snap->sys, 0, sizeof(snap->sys));
+    snap->nch = rcv->nch;
+    snap->nch_trk = get_nch_trk(rcv, snap->sys);
+    snap->ch_srch = rcv->ich + 1;
+    for (int i = 0; i < rcv->nch; i++) {
+        sdr_ch_get_view(rcv->th[i]->ch, snap->ch + i);
+        if (rcv->opt.prof) {
+            snap_prof(rcv->th[i]->ch, snap->prof + i);
+        }
+    }
+    __atomic_store_n(&snap->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+// copy status snapshot (ch: copy channel status) ------------------------------
+static void snap_copy(sdr_rcv_t *rcv, sdr_rcv_snap_t *snap, int ch)
+{
+    const sdr_rcv_snap_t *src = rcv ? rcv->snap : NULL;
+    size_t size = offsetof(sdr_rcv_snap_t, ch);
+    
+    if (!src) {
+        memset(snap, 0, size);
+        snap->ver = SDR_SNAP_VER;
+        snap->size = (uint32_t)sizeof(sdr_rcv_snap_t);
+        return;
+    }
+    for (int i = 0; ; i++) {
+        uint32_t seq = __atomic_load_n(&src->seq, __ATOMIC_ACQUIRE);
+        if (!(seq & 1)) {
+            memcpy(snap, src, size);
+            int nch = ch ? MAX(MIN(snap->nch, SDR_MAX_NCH), 0) : 0;
+            memcpy(snap->ch, src->ch, sizeof(sdr_ch_view_t) * nch);
+            memcpy(snap->prof, src->prof, sizeof(sdr_ch_prof_t) * nch);
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(&src->seq, __ATOMIC_RELAXED) == seq) break;
+        }
+        if (i >= 10) sdr_sleep_msec(1);
+    }
+}
+
 //------------------------------------------------------------------------------
-//  Get SDR receiver channel status as string.
+//  Get SDR receiver status snapshot. The snapshot of the receiver, PVT and
+//  channel status is published by the receiver thread in every SNAP_CYC
+//  cycles and copied to the caller-owned structure with the seqlock
+//  consistency. It is safe to be called by multiple threads for multiple
+//  receivers. Only snap->nch entries of snap->ch and snap->prof are copied.
+//  snap->prof is set only with the option prof.
 //
 //  args:
-//      rcv       (I)  SDR receiver
-//      sys       (I)  system
-//      all       (I)  all channel including IDLE channel
+//      rcv       (I)  SDR receiver (NULL: no receiver)
+//      snap      (O)  status snapshot
 //
 //  returns:
-//      channel status string
+//      status (1: OK, 0: no receiver)
 //
-char *sdr_rcv_ch_stat(sdr_rcv_t *rcv, const char *sys, int all)
+int sdr_rcv_snapshot(sdr_rcv_t *rcv, sdr_rcv_snap_t *snap)
 {
-    char *p = rcv_ch_stat_buff;
-    
-    p += print_head(p, rcv);
-    for (int i = 0; rcv && i < rcv->nch; i++) {
-        sdr_ch_t *ch = rcv->th[i]->ch;
-        if (!sat_select(ch->sat, sys)) continue;
-        if (all || (ch->state == SDR_STATE_LOCK &&
-            ch->lock * ch->T >= MIN_LOCK)) {
-            p += print_ch_stat(p, ch);
-        }
-    }
-    return rcv_ch_stat_buff;
+    snap_copy(rcv, snap, 1);
+    return rcv != NULL;
 }
 
-// get receiver status as sting ------------------------------------------------
-char *sdr_rcv_rcv_stat(sdr_rcv_t *rcv)
+//------------------------------------------------------------------------------
+//  Format receiver status of status snapshot as comma-separated string.
+//
+//  args:
+//      snap      (I)  status snapshot
+//      buff      (O)  receiver status string
+//      size      (I)  size of buffer (bytes)
+//
+//  returns:
+//      length of string (bytes)
+//
+int sdr_rcv_snap_rcv_str(const sdr_rcv_snap_t *snap, char *buff, int size)
 {
     static const char *src_str[] = {"---", "IF Data", "RF Frontend"};
-    static const char *fmt_str[] = {"---", "INT8", "INT8X2", "RAW8", "RAW16"};
+    static const char *fmt_str[] = {"---", "INT8", "INT8X2", "RAW8", "RAW16",
+        "RAW16I", "PACK"};
     static const char *IQ_str[] = {"---", "I", "IQ"};
-    char *p = rcv_rcv_stat_buff;
+    char str[1024], *p = str;
+    
+    if (size <= 0) return 0;
     
-    if (rcv && rcv->state) {
-        char solstr[128] = "", sys[16] = "";
-        int nch_trk = get_nch_trk(rcv, sys);
-        sdr_pvt_solstr(rcv->pvt, solstr);
+    if (snap->state) {
+        char solstr[128];
+        snap_solstr(snap, solstr);
         p += sprintf(p, "%.3f,%s,%s,%d,%.3f/%.3f,%.3f/%.3f,%s/%s/%s/%s,%.3f,"
-            "%d/%d,%.3f,%.1f,", get_buff_ix(rcv) * SDR_CYC, src_str[rcv->dev],
-            fmt_str[rcv->fmt], rcv->nbuff, rcv->fo[0] * 1e-6, rcv->fo[1] * 1e-6,
-            rcv->fo[2] * 1e-6, rcv->fo[3] * 1e-6, IQ_str[rcv->IQ[0]],
-            IQ_str[rcv->IQ[1]], IQ_str[rcv->IQ[2]], IQ_str[rcv->IQ[3]],
-            rcv->fs * 1e-6, nch_trk, rcv->nch, rcv->data_rate * 1e-6,
-            rcv->buff_use);
+            "%d/%d,%.3f,%.1f,", snap->time, src_str[snap->dev],
+            fmt_str[snap->fmt], snap->nbuff, snap->fo[0] * 1e-6,
+            snap->fo[1] * 1e-6, snap->fo[2] * 1e-6, snap->fo[3] * 1e-6,
+            IQ_str[snap->IQ[0]], IQ_str[snap->IQ[1]], IQ_str[snap->IQ[2]],
+            IQ_str[snap->IQ[3]], snap->fs * 1e-6, snap->nch_trk, snap->nch,
+            snap->data_rate * 1e-6, snap->buff_use);
         p += sprintf(p, "%.21s,%.3s,%.11s,%.12s,%.8s,%s,%.5s,,%d,%d/%d,%.1f,",
-            solstr, solstr + 64, solstr + 24, solstr + 36, solstr + 49, sys,
-            solstr + 58, rcv->pvt->count[0], rcv->pvt->count[1],
-            rcv->pvt->count[2], rcv->data_sum);
-       }
+            solstr, solstr + 64, solstr + 24, solstr + 36, solstr + 49,
+            snap->sys, solstr + 58, snap->count[0], snap->count[1],
+            snap->count[2], snap->data_sum);
+        p += sprintf(p, "%lld/%lld/%.1f,", (long long)snap->dev_stat[0],
+            (long long)snap->dev_stat[1], snap->dev_stat[2] * 1e-6);
+    }
     else {
         p += sprintf(p, "%.3f,---,---,%d,%.3f/%.3f,%.3f/%.3f,---/---/---/---,"
             "%.3f,%d/%d,%.3f,%.1f,", 0.0, 0, 0.0, 0.0, 0.0, 0.0, 0.0, 0, 0, 0.0,
             0.0);
         p += sprintf(p, "1970-01-01 00:00:00.0,---,%.7f,%.7f,%.2f,,%d/%d,,%d,"
             "%d/%d,%.1f,", 0.0, 0.0, 0.0, 0, 0, 0, 0, 0, 0.0);
+        p += sprintf(p, "0/0/%.1f,", 0.0);
     }
-    return rcv_rcv_stat_buff;
+    *buff = '\0';
+    return append_str(buff, 0, size, str);
 }
 
-// get satellite status as sting -----------------------------------------------
-char *sdr_rcv_sat_stat(sdr_rcv_t *rcv, const char *sys)
+//------------------------------------------------------------------------------
+//  Format channel status of status snapshot as string. The channel status
+//  lines not fit in the buffer are dropped.
+//
+//  args:
+//      snap      (I)  status snapshot
+//      sys       (I)  system
+//      all       (I)  all channel including IDLE channel
+//      buff      (O)  channel status string
+//      size      (I)  size of buffer (bytes)
+//
+//  returns:
+//      length of string (bytes)
+//
+int sdr_rcv_snap_ch_str(const sdr_rcv_snap_t *snap, const char *sys, int all,
+    char *buff, int size)
 {
-    char *p = rcv_sat_stat_buff;
+    char str[512];
+    int len = 0;
     
-    *p = '\0';
-    if (rcv) {
-        pthread_mutex_lock(&rcv->pvt->mtx);
-        
-        for (int i = 0; i < MAXSAT; i++) {
-            char sat[16];
-            satno2id(i+1, sat);
-            if (!sat_select(sat, sys)) continue;
-            ssat_t *ssat = rcv->pvt->ssat + i;
-            if (ssat->azel[1] <= 0.0) continue;
-            p += sprintf(p, "%s %.1f %.1f %d\n", sat, ssat->azel[0] * R2D,
-                ssat->azel[1] * R2D, ssat->vs);
+    if (size <= 0) return 0;
+    *buff = '\0';
+    print_head(str, snap);
+    len = append_str(buff, len, size, str);
+    
+    for (int i = 0; i < snap->nch; i++) {
+        const sdr_ch_view_t *ch = snap->ch + i;
+        if (!sat_select(ch->sat, sys)) continue;
+        if (all || (ch->state == SDR_STATE_LOCK && ch->lock >= MIN_LOCK)) {
+            print_ch_stat(str, ch);
+            len = append_str(buff, len, size, str);
         }
-        pthread_mutex_unlock(&rcv->pvt->mtx);
     }
-    return rcv_sat_stat_buff;
+    return len;
+}
+
+//------------------------------------------------------------------------------
+//  Format satellite status of status snapshot as string.
+//
+//  args:
+//      snap      (I)  status snapshot
+//      sys       (I)  system
+//      buff      (O)  satellite status string
+//      size      (I)  size of buffer (bytes)
+//
+//  returns:
+//      length of string (bytes)
+//
+int sdr_rcv_snap_sat_str(const sdr_rcv_snap_t *snap, const char *sys,
+    char *buff, int size)
+{
+    char str[64];
+    int len = 0;
+    
+    if (size <= 0) return 0;
+    *buff = '\0';
+    for (int i = 0; i < snap->nsv; i++) {
+        const sdr_sat_snap_t *sat = snap->sat + i;
+        if (!sat_select(sat->sat, sys)) continue;
+        sprintf(str, "%s %.1f %.1f %d\n", sat->sat, sat->az, sat->el, sat->vs);
+        len = append_str(buff, len, size, str);
+    }
+    return len;
+}
+
+// aggregate channel profiles in snapshot by signal types ----------------------
+static int prof_sig(const sdr_rcv_snap_t *snap, const char **sig, int *nch,
+    sdr_ch_prof_t *prof)
+{
+    int n = 0;
+    
+    for (int i = 0; i < snap->nch; i++) {
+        int j;
+        for (j = 0; j < n; j++) {
+            if (!strcmp(sig[j], snap->ch[i].sig)) break;
+        }
+        if (j >= n) {
+            if (n >= MAX_PROF_SIG) continue;
+            sig[n] = snap->ch[i].sig;
+            nch[n] = 0;
+            memset(prof + n, 0, sizeof(sdr_ch_prof_t));
+            n++;
+        }
+        nch[j]++;
+        for (int k = 0; k < 4; k++) {
+            prof[j].cpu[k] += snap->prof[i].cpu[k];
+        }
+        for (int k = 0; k < SDR_N_LAT; k++) {
+            prof[j].lat[k] += snap->prof[i].lat[k];
+        }
+    }
+    return n;
+}
+
+// percentile of observation age by histogram (ms) -----------------------------
+//  The upper edge of the bin is returned (the lower edge for the last bin).
+static double lat_pct(const int64_t *lat, double p)
+{
+    int64_t n = 0, sum = 0;
+    
+    for (int i = 0; i < SDR_N_LAT; i++) {
+        n += lat[i];
+    }
+    if (n <= 0) return 0.0;
+    for (int i = 0; i < SDR_N_LAT - 1; i++) {
+        if ((sum += lat[i]) >= p * n) return lat_edge[i];
+    }
+    return lat_edge[SDR_N_LAT-2];
+}
+
+//------------------------------------------------------------------------------
+//  Format channel profiles of status snapshot aggregated by signal types as
+//  string. The CPU time of tracking, acquisition, nav decoding and obs update
+//  are shown as the CPU load (% of a core) in the receiver time. The 50% and
+//  99% percentiles of the observation age, the wall-clock time from the
+//  arrival of the last IF data cycle to the obs update of the locked channels,
+//  are shown as the upper edges of the histogram bins. The profiles are valid
+//  only with the option prof.
+//
+//  args:
+//      snap      (I)  status snapshot
+//      buff      (O)  profile string
+//      size      (I)  size of buffer (bytes)
+//
+//  returns:
+//      length of string (bytes)
+//
+int sdr_rcv_snap_prof_str(const sdr_rcv_snap_t *snap, char *buff, int size)
+{
+    const char *sig[MAX_PROF_SIG];
+    int nch[MAX_PROF_SIG], len = 0;
+    sdr_ch_prof_t *prof;
+    char str[128];
+    
+    if (size <= 0) return 0;
+    *buff = '\0';
+    prof = (sdr_ch_prof_t *)sdr_malloc(sizeof(sdr_ch_prof_t) * MAX_PROF_SIG);
+    int n = prof_sig(snap, sig, nch, prof);
+    double scale = snap->time > 0.0 ? 100.0 / snap->time : 0.0;
+    
+    sprintf(str, "%-8s %4s %7s %7s %7s %7s %6s %6s\n", "SIG", "NCH", "TRK(%)",
+        "ACQ(%)", "NAV(%)", "OBS(%)", "AGE50", "AGE99");
+    len = append_str(buff, len, size, str);
+    for (int i = 0; i < n; i++) {
+        sprintf(str, "%-8.8s %4d %7.2f %7.2f %7.2f %7.2f %6.0f %6.0f\n",
+            sig[i], nch[i], prof[i].cpu[0] * scale, prof[i].cpu[1] * scale,
+            prof[i].cpu[2] * scale, prof[i].cpu[3] * scale,
+            lat_pct(prof[i].lat, 0.5), lat_pct(prof[i].lat, 0.99));
+        len = append_str(buff, len, size, str);
+    }
+    sdr_free(prof);
+    return len;
+}
+
+// get status string buffer (type: 0:receiver,1:satellite,2:channel) ----------
+//  The buffers are allocated in the receiver at the first call.
+static char *get_stat_buff(sdr_rcv_t *rcv, int type, int *size)
+{
+    static char buff_nul[SIZE_RCV_STAT]; // buffer w/o receiver
+    const int sizes[] = {SIZE_RCV_STAT, SIZE_SAT_STAT, SIZE_CH_STAT};
+    
+    if (!rcv) {
+        *size = (int)sizeof(buff_nul);
+        return buff_nul;
+    }
+    pthread_mutex_lock(&rcv_view_mtx);
+    if (!rcv->stat_buff) {
+        rcv->stat_buff = (char *)sdr_malloc(sizes[0] + sizes[1] + sizes[2]);
+    }
+    pthread_mutex_unlock(&rcv_view_mtx);
+    *size = sizes[type];
+    return rcv->stat_buff + (type >= 1 ? sizes[0] : 0) +
+        (type >= 2 ? sizes[1] : 0);
+}
+
+//------------------------------------------------------------------------------
+//  Get SDR receiver channel status as string. The string is formatted by
+//  sdr_rcv_snap_ch_str() to the buffer in the receiver and valid until the
+//  next call for the receiver. Use sdr_rcv_snapshot() and
+//  sdr_rcv_snap_ch_str() to get the status by multiple threads.
+//
+//  args:
+//      rcv       (I)  SDR receiver
+//      sys       (I)  system
+//      all       (I)  all channel including IDLE channel
+//
+//  returns:
+//      channel status string
+//
+char *sdr_rcv_ch_stat(sdr_rcv_t *rcv, const char *sys, int all)
+{
+    sdr_rcv_snap_t *snap = (sdr_rcv_snap_t *)sdr_malloc(sizeof(sdr_rcv_snap_t));
+    
+    int n;
+    char *buff = get_stat_buff(rcv, 2, &n);
+    
+    snap_copy(rcv, snap, 1);
+    sdr_rcv_snap_ch_str(snap, sys, all, buff, n);
+    sdr_free(snap);
+    return buff;
+}
+
+// get receiver status as sting ------------------------------------------------
+char *sdr_rcv_rcv_stat(sdr_rcv_t *rcv)
+{
+    size_t size = offsetof(sdr_rcv_snap_t, ch); // w/o channel status
+    sdr_rcv_snap_t *snap = (sdr_rcv_snap_t *)sdr_malloc(size);
+    
+    int n;
+    char *buff = get_stat_buff(rcv, 0, &n);
+    
+    snap_copy(rcv, snap, 0);
+    sdr_rcv_snap_rcv_str(snap, buff, n);
+    sdr_free(snap);
+    return buff;
+}
+
+// get satellite status as sting -----------------------------------------------
+char *sdr_rcv_sat_stat(sdr_rcv_t *rcv, const char *sys)
+{
+    size_t size = offsetof(sdr_rcv_snap_t, ch); // w/o channel status
+    sdr_rcv_snap_t *snap = (sdr_rcv_snap_t *)sdr_malloc(size);
+    
+    int n;
+    char *buff = get_stat_buff(rcv, 1, &n);
+    
+    snap_copy(rcv, snap, 0);
+    sdr_rcv_snap_sat_str(snap, sys, buff, n);
+    sdr_free(snap);
+    return buff;
 }
 
 // select channel for correlator status ----------------------------------------
 void sdr_rcv_sel_ch(sdr_rcv_t *rcv, int ch)
 {
     if (!rcv || !rcv->state) return;
-    for (int i = 0; i < rcv->nch; i++) {
-        sdr_ch_set_corr(rcv->th[i]->ch, i + 1 == ch ? SDR_N_CORR : 4);
+    rcv->ch_sel = ch;
+    for (int i = 0; i < rcv->nch; i++) { // no additional correlators by load
+                                         // shedding
+        sdr_ch_set_corr(rcv->th[i]->ch, i + 1 == ch && !rcv->shed ?
+            SDR_N_CORR : 4);
     }
 }
 
@@ -256,38 +781,115 @@ int sdr_rcv_rfch_stat(sdr_rcv_t *rcv, int ch, double *stat)
     return 1;
 }
 
+// sum blocks of IF data monitor ----------------------------------------------
+static int mon_sum(sdr_mon_t *mon, double tave, float *P, int32_t *hist)
+{
+    int nb = (int)ceil(tave / (MON_CYC * SDR_CYC) - 1e-6);
+    
+    pthread_mutex_lock(&mon->mtx);
+    nb = (int)MIN(MAX(nb, 1), MIN(mon->cnt, mon->nblk));
+    for (int i = 0; i < nb; i++) {
+        int k = (int)((mon->cnt - 1 - i) % mon->nblk);
+        if (P) {
+            const float *Pk = mon->P + (size_t)k * mon->N;
+            for (int j = 0; j < mon->N; j++) {
+                P[j] += Pk[j];
+            }
+        }
+        if (hist) {
+            for (int j = 0; j < 32; j++) {
+                hist[j] += mon->hist[k*32+j];
+            }
+        }
+    }
+    pthread_mutex_unlock(&mon->mtx);
+    return nb;
+}
+
+// RF channel PSD by IF data monitor -------------------------------------------
+static int mon_psd(sdr_rcv_t *rcv, int ch, double tave, float *psd)
+{
+    sdr_mon_t *mon = rcv->mon[ch-1];
+    int N = mon->N, IQ = rcv->buff[ch-1]->IQ;
+    float *P = (float *)sdr_malloc(sizeof(float) * N);
+    int M = mon_sum(mon, tave, P, NULL);
+    
+    // scale complies with matplotlib.psd() (see sdr_psd_cpx())
+    float scale = 1.333 / N / M / mon->w_ave / rcv->fs;
+    
+    if (IQ == 1) { // I
+        for (int i = 0; i < N / 2; i++) {
+            psd[i] = 10.0f * log10f(P[i] * scale * 2.0);
+        }
+    }
+    else { // IQ
+        for (int i = 0; i < N; i++) {
+            psd[i] = 10.0f * log10f(P[(i+N/2)%N] * scale);
+        }
+    }
+    sdr_free(P);
+    return IQ == 1 ? N / 2 : N;
+}
+
 // get RF channel PSD ----------------------------------------------------------
+//  The PSD is taken from the IF data monitor if the FFT size is the same as the
+//  monitor. In this case, the averaging time is limited to the monitor span
+//  (MON_NBLK * MON_CYC * SDR_CYC) and the PSD is averaged over the snapshots.
 int sdr_rcv_rfch_psd(sdr_rcv_t *rcv, int ch, double tave, int N, float *psd)
 {
     if (!rcv || !rcv->state || ch < 1 || ch > rcv->nbuff) return 0;
+    sdr_mon_t *mon = rcv->mon[ch-1];
+    if (mon && N == mon->N) {
+        return __atomic_load_n(&mon->cnt, __ATOMIC_ACQUIRE) > 0 ?
+            mon_psd(rcv, ch, tave, psd) : 0;
+    }
     int n = (int)(rcv->fs * tave);
     int64_t ix = get_buff_ix(rcv);
     if (ix * rcv->N < n) return 0;
     sdr_cpx_t *buff = sdr_cpx_malloc(n);
+    sdr_cpx8_t *data = (sdr_cpx8_t *)sdr_malloc(n);
+    sdr_buff_get(rcv->buff[ch-1], (int)((ix * rcv->N - n) %
+        rcv->buff[ch-1]->N), n, data);
     for (int i = 0; i < n; i++) {
-        int j = (int)((ix * rcv->N - n + i) % rcv->buff[ch-1]->N);
-        sdr_cpx8_t data = rcv->buff[ch-1]->data[j];
-        buff[i][0] = SDR_CPX8_I(data);
-        buff[i][1] = SDR_CPX8_Q(data);
+        buff[i][0] = SDR_CPX8_I(data[i]);
+        buff[i][1] = SDR_CPX8_Q(data[i]);
     }
     sdr_psd_cpx(buff, n, N, rcv->fs, rcv->buff[ch-1]->IQ, psd);
     sdr_cpx_free(buff);
+    sdr_free(data);
     return rcv->buff[ch-1]->IQ == 1 ? N / 2 : N; // PSD size
 }
 
 // get RF channel histgram -----------------------------------------------------
+//  The histogram is taken from the IF data monitor if it is enabled (see
+//  sdr_rcv_rfch_psd()).
 int sdr_rcv_rfch_hist(sdr_rcv_t *rcv, int ch, double tave, int *val,
     double *hist1, double *hist2)
 {
     if (!rcv || !rcv->state || ch < 1 || ch > rcv->nbuff) return 0;
     int n = (int)(rcv->fs * tave), cnt[2][256] = {{0}}, sum[2] = {0}, nval = 0;
-    int64_t ix = get_buff_ix(rcv);
-    if (ix * rcv->N < n) return 0;
-    for (int i = 0; i < n; i++) {
-        int j = (int)((ix * rcv->N - n + i) % rcv->buff[ch-1]->N);
-        sdr_cpx8_t data = rcv->buff[ch-1]->data[j];
-        cnt[0][SDR_CPX8_I(data)+128]++;
-        cnt[1][SDR_CPX8_Q(data)+128]++;
+    sdr_mon_t *mon = rcv->mon[ch-1];
+    
+    if (mon) {
+        int32_t hist[32] = {0};
+        if (__atomic_load_n(&mon->cnt, __ATOMIC_ACQUIRE) <= 0) return 0;
+        mon_sum(mon, tave, NULL, hist);
+        for (int i = 0; i < 16; i++) {
+            cnt[0][i+120] = hist[i];
+            cnt[1][i+120] = hist[16+i];
+        }
+    }
+    else {
+        int64_t ix = get_buff_ix(rcv);
+        if (ix * rcv->N < n) return 0;
+        sdr_cpx8_t *data = (sdr_cpx8_t *)sdr_malloc(n);
+        sdr_buff_get(rcv->buff[ch-1], (int)((ix * rcv->N - n) %
+            rcv->buff[ch-1]->N), n, data);
+        for (int i = 0; i < n; i++) {
+            cnt[0][SDR_CPX8_I(data[i])+128]++;
+            cnt[1][SDR_CPX8_Q(data[i])+128]++;
+        }
+        sdr_free(data);
     }
     for (int i = 0; i < 256; i++) {
         sum[0] += cnt[0][i];
@@ -303,6 +905,23 @@ int sdr_rcv_rfch_hist(sdr_rcv_t *rcv, int ch, double tave, int *val,
     }
     return nval;
 }
+
+// output log of USB transfer errors and overruns ------------------------------
+static void out_log_dev(sdr_rcv_t *rcv, double time, int64_t *stat)
+{
+    int64_t s[3] = {0};
+    
+    if (!get_dev_stat(rcv, s) ||
+        (s[0] == stat[0] && s[1] == stat[1] && s[2] == stat[2])) {
+        return;
+    }
+    sdr_log(3, "$LOG,%.3f,%s,%d,IF DATA ERROR ERR=%lld OVERRUN=%lld DROP=%lld",
+        time, "", 0, (long long)s[0], (long long)s[1], (long long)s[2]);
+    for (int i = 0; i < 3; i++) {
+        stat[i] = s[i];
+    }
+}
+
 // output log $TIME ------------------------------------------------------------
 static void out_log_time(double time)
 {
@@ -312,6 +931,30 @@ static void out_log_time(double time)
        t[2], t[3], t[4], t[5]);
 }
 
+// output log $LOG of profiles by signal types (option prof) -------------------
+//  It is called by the receiver thread just after the snapshot updated.
+static void out_log_prof(sdr_rcv_t *rcv, double time)
+{
+    const char *sig[MAX_PROF_SIG];
+    int nch[MAX_PROF_SIG];
+    sdr_ch_prof_t *prof;
+    
+    if (!rcv->opt.prof) return;
+    prof = (sdr_ch_prof_t *)sdr_malloc(sizeof(sdr_ch_prof_t) * MAX_PROF_SIG);
+    int n = prof_sig(rcv->snap, sig, nch, prof);
+    
+    for (int i = 0; i < n; i++) {
+        char str[256], *p = str;
+        for (int j = 0; j < SDR_N_LAT; j++) {
+            p += sprintf(p, "%s%lld", j ? "/" : "", (long long)prof[i].lat[j]);
+        }
+        sdr_log(3, "$LOG,%.3f,%s,%d,PROF NCH=%d TRK=%.3f ACQ=%.3f NAV=%.3f "
+            "OBS=%.3f AGE=%s", time, sig[i], 0, nch[i], prof[i].cpu[0],
+            prof[i].cpu[1], prof[i].cpu[2], prof[i].cpu[3], str);
+    }
+    sdr_free(prof);
+}
+
 // output log $CH --------------------------------------------------------------
 static void out_log_ch(sdr_ch_t *ch)
 {
@@ -326,7 +969,7 @@ static sdr_ch_th_t *ch_th_new(const char *sig, int prn, double fi, double fs,
 {
     sdr_ch_th_t *th = (sdr_ch_th_t *)sdr_malloc(sizeof(sdr_ch_th_t));
     
-    if (!(th->ch = sdr_ch_new(sig, prn, fs, fi))) {
+    if (!(th->ch = sdr_ch_new_opt(sig, prn, fs, fi, &rcv->opt))) {
         sdr_free(th);
         return NULL;
     }
@@ -342,37 +985,60 @@ static void ch_th_free(sdr_ch_th_t *th)
     sdr_free(th);
 }
 
-// SDR receiver channel thread ------------------------------------------------
-static void *ch_thread(void *arg)
+// profile obs update and observation age (option prof) ------------------------
+//  The observation age is the wall-clock time from the arrival of the last IF
+//  data cycle used by the channel to the obs update.
+static void prof_obs(sdr_ch_th_t *th, double t0, int64_t ix)
 {
-    sdr_ch_th_t *th = (sdr_ch_th_t *)arg;
     sdr_ch_t *ch = th->ch;
-    int n = ch->N / th->rcv->N;
-    
-    while (th->state) {
-        int64_t ix = get_buff_ix(th->rcv);
-        for ( ; th->ix + 2 * n <= ix && th->state; th->ix += n) {
-            
-            // update SDR receiver channel
-            sdr_ch_update(ch, th->ix * SDR_CYC, th->rcv->buff[ch->rf_ch],
-                th->rcv->N * (int)(th->ix % MAX_BUFF));
-            
-            // update navigation data
-            if (ch->nav->stat) {
-                sdr_pvt_udnav(th->rcv->pvt, ch);
-                ch->nav->stat = 0;
-            }
-            // update observation data
-            sdr_pvt_udobs(th->rcv->pvt, th->ix, ch);
-            
-            // output channel log
-            if (ch->state == SDR_STATE_LOCK && th->ix % LOG_CYC == 0) {
-                out_log_ch(ch);
-            }
+    const double *t_cyc = th->rcv->t_cyc;
+    int i = 0;
+    
+    ch->cpu[3] += (int64_t)((sdr_get_cputime() - t0) * 1e9);
+    if (ch->state != SDR_STATE_LOCK || !t_cyc) return;
+    double age = (sdr_get_clock() - t_cyc[ix % th->rcv->max_buff]) * 1e3;
+    while (i < SDR_N_LAT - 1 && age >= lat_edge[i]) i++;
+    ch->lat[i]++;
+}
+
+// SDR receiver channel task ---------------------------------------------------
+static void ch_task(sdr_ch_th_t *th)
+{
+    sdr_ch_t *ch = th->ch;
+    int n = ch->N / th->N;
+    int64_t ix = get_buff_ix(th->rcv) - th->lag;
+    
+    for ( ; th->ix + 2 * n <= ix && th->state; th->ix += n) {
+        
+        // update SDR receiver channel
+        sdr_ch_update(ch, th->ix * SDR_CYC, th->buff,
+            th->N * (int)(th->ix % th->rcv->max_buff));
+        
+        // update navigation data
+        if (ch->nav->stat) {
+            sdr_pvt_udnav(th->rcv->pvt, ch);
+            ch->nav->stat = 0;
+        }
+        // update observation data
+        double t0 = ch->opt->prof ? sdr_get_cputime() : 0.0;
+        sdr_pvt_udobs(th->rcv->pvt, th->ix, ch);
+        if (ch->opt->prof) {
+            prof_obs(th, t0, th->ix + 2 * n - 1);
+        }
+        
+        // output channel log
+        if (ch->state == SDR_STATE_LOCK && th->ix % LOG_CYC == 0) {
+            out_log_ch(ch);
         }
-        sdr_sleep_msec(TH_CYC);
     }
-    return NULL;
+    __atomic_store_n(&th->busy, 0, __ATOMIC_RELEASE);
+    
+    // notify channel task done to receiver in fast replay
+    if (fast_replay(th->rcv)) {
+        pthread_mutex_lock(&th->rcv->mtx);
+        pthread_cond_broadcast(&th->rcv->sync);
+        pthread_mutex_unlock(&th->rcv->mtx);
+    }
 }
 
 // start SDR receiver channel ----------------------------------------------------
@@ -380,7 +1046,8 @@ static int ch_th_start(sdr_ch_th_t *th)
 {
     if (th->state) return 0;
     th->state = 1;
-    return !pthread_create(&th->thread, NULL, ch_thread, th);
+    th->busy = 0;
+    return 1;
 }
 
 // stop SDR receiver channel ---------------------------------------------------
@@ -389,36 +1056,337 @@ static void ch_th_stop(sdr_ch_th_t *th)
     th->state = 0;
 }
 
-// set RF channel and IF frequency ---------------------------------------------
-static int set_rfch(int fmt, double fs, const double *fo, const int *IQ,
-    const char *sig, double *fi)
+// push channel task to deque tail ---------------------------------------------
+static void que_push(sdr_wk_t *wk, int i)
 {
-    double freq = sdr_sig_freq(sig);
-    int rfch = 0;
+    pthread_mutex_lock(&wk->mtx);
+    wk->que[wk->tail++ % wk->size] = i;
+    pthread_mutex_unlock(&wk->mtx);
+}
+
+// pop channel task from deque tail (head: steal) ------------------------------
+static int que_pop(sdr_wk_t *wk, int steal)
+{
+    int i = -1;
     
-    if (fmt == SDR_FMT_RAW8) { // FE 2CH
-        rfch = freq > 1.4e9 ? 0 : 1;
+    pthread_mutex_lock(&wk->mtx);
+    if (wk->tail > wk->head) {
+        i = steal ? wk->que[wk->head++ % wk->size] :
+            wk->que[--wk->tail % wk->size];
     }
-    else if (fmt == SDR_FMT_RAW16) { // FE 4CH
-        for (int i = 1; i < 4; i++) {
-            if (fabs(freq - fo[i]) < fabs(freq - fo[rfch])) rfch = i;
-        }
+    if (wk->tail <= wk->head) {
+        wk->head = wk->tail = 0;
     }
-    *fi = fo[rfch] > 0.0 ? freq - fo[rfch] : (IQ[rfch] == 1 ? fs * 0.5 : 0.0);
-    return rfch;
+    pthread_mutex_unlock(&wk->mtx);
+    return i;
 }
 
-//------------------------------------------------------------------------------
-//  Generate a new SDR receiver.
-//
-//  args:
-//      sigs      (I)  signal types as a string array {sig1, sig2, ..., sign}
-//      prns      (I)  PRN numbers as int array {prn1, prn2, ..., prnn}
-//      n         (I)  number of sigs and prns
-//      fmt       (I)  IF data format (SDR_FMT_???)
-//      fs        (I)  sampling rate (sps)
-//      fo        (I)  LO frequency for each RFCH (Hz)
-//      IQ        (I)  sampling type for each RFCH (1:I, 2:IQ)
+// steal channel task from other workers ---------------------------------------
+static int que_steal(sdr_rcv_t *rcv, const sdr_wk_t *wk)
+{
+    int k0 = wk->acq ? rcv->nwk : 0, nk = wk->acq ? rcv->nacq : rcv->nwk;
+    
+    for (int k = 1; k < nk; k++) {
+        int i = que_pop(rcv->wk[k0 + (wk->no - k0 + k) % nk], 1);
+        if (i >= 0) return i;
+    }
+    return -1;
+}
+
+// add CPU time of receiver stage (option prof) --------------------------------
+static void add_cpu(const sdr_rcv_t *rcv, int64_t *cpu, double t0)
+{
+    if (!rcv->opt.prof) return;
+    __atomic_fetch_add(cpu, (int64_t)((sdr_get_cputime() - t0) * 1e9),
+        __ATOMIC_RELAXED);
+}
+
+// set CPU affinity and priority of receiver thread ----------------------------
+static void set_thread(const sdr_rcv_t *rcv, int type)
+{
+    const sdr_opt_t *opt = &rcv->opt;
+    sdr_trace_name(rcv_aff_name[type]);
+    if (!*opt->aff_cpus[type] && !opt->aff_pri[type]) return;
+    sdr_set_thread(opt->aff_cpus[type], opt->aff_pri[type]);
+}
+
+// SDR receiver worker thread --------------------------------------------------
+static void *wk_thread(void *arg)
+{
+    sdr_wk_t *wk = (sdr_wk_t *)arg;
+    sdr_rcv_t *rcv = wk->rcv;
+    int i0 = wk->acq ? wk->no - rcv->nwk : wk->no;
+    int nk = wk->acq ? rcv->nacq : rcv->nwk;
+    
+    set_thread(wk->rcv, wk->acq ? 2 : 1);
+    
+    while (wk->state) {
+        int64_t ix = get_buff_ix(rcv);
+        
+        // push ready tasks of channels owned by worker (searching channels
+        // owned by acquisition workers if any)
+        for (int i = i0; i < rcv->nch; i += nk) {
+            sdr_ch_th_t *th = rcv->th[i];
+            int n = th->ch->N / th->N;
+            int srch = th->ch->state == SDR_STATE_SRCH;
+            if (th->ix + 2 * n > ix - th->lag || (rcv->nacq > 0 && srch != wk->acq) ||
+                __atomic_load_n(&th->busy, __ATOMIC_ACQUIRE)) continue;
+            th->busy = 1;
+            que_push(wk, i);
+        }
+        // run own tasks, then steal tasks of other workers
+        int i;
+        while (wk->state && ((i = que_pop(wk, 0)) >= 0 ||
+            (i = que_steal(rcv, wk)) >= 0)) {
+            ch_task(rcv->th[i]);
+        }
+        // wait for next IF data cycle
+        wait_buff_ix(rcv, ix, TH_CYC);
+    }
+    sdr_scratch_release();
+    return NULL;
+}
+
+// new SDR receiver worker thread ----------------------------------------------
+static sdr_wk_t *wk_new(sdr_rcv_t *rcv, int no)
+{
+    sdr_wk_t *wk = (sdr_wk_t *)sdr_malloc(sizeof(sdr_wk_t));
+    
+    wk->no = no;
+    wk->size = rcv->nch > 0 ? rcv->nch : 1;
+    wk->que = (int *)sdr_malloc(sizeof(int) * wk->size);
+    wk->rcv = rcv;
+    pthread_mutex_init(&wk->mtx, NULL);
+    return wk;
+}
+
+// free SDR receiver worker thread ---------------------------------------------
+static void wk_free(sdr_wk_t *wk)
+{
+    if (!wk) return;
+    pthread_mutex_destroy(&wk->mtx);
+    sdr_free(wk->que);
+    sdr_free(wk);
+}
+
+// start SDR receiver worker threads -------------------------------------------
+static void wk_start(sdr_rcv_t *rcv)
+{
+    int cpu[SDR_MAX_NPRN];
+    
+    rcv->nwk = rcv->opt.nwk > 0 ? rcv->opt.nwk : sdr_get_ncpu();
+    rcv->nwk = MIN(MIN(rcv->nwk, rcv->nch), SDR_MAX_NWK);
+    rcv->nacq = rcv->opt.nacq > 0 ? rcv->opt.nacq :
+        sdr_parse_nums(rcv->opt.aff_cpus[2], cpu);
+    rcv->nacq = MIN(MIN(rcv->nacq, rcv->nch), SDR_MAX_NWK - rcv->nwk);
+    
+    for (int i = 0; i < rcv->nwk + rcv->nacq; i++) {
+        rcv->wk[i] = wk_new(rcv, i);
+        rcv->wk[i]->acq = i >= rcv->nwk;
+    }
+    for (int i = 0; i < rcv->nwk + rcv->nacq; i++) {
+        rcv->wk[i]->state = 1;
+        if (pthread_create(&rcv->wk[i]->thread, NULL, wk_thread, rcv->wk[i])) {
+            fprintf(stderr, "worker thread create error\n");
+            rcv->wk[i]->state = 0;
+        }
+    }
+}
+
+// stop SDR receiver worker threads --------------------------------------------
+static void wk_stop(sdr_rcv_t *rcv)
+{
+    for (int i = 0; i < rcv->nwk + rcv->nacq; i++) {
+        if (!rcv->wk[i]->state) continue;
+        rcv->wk[i]->state = 0;
+        pthread_join(rcv->wk[i]->thread, NULL);
+    }
+    for (int i = 0; i < rcv->nwk + rcv->nacq; i++) {
+        wk_free(rcv->wk[i]);
+        rcv->wk[i] = NULL;
+    }
+    rcv->nwk = rcv->nacq = 0;
+}
+
+// set RF channel and IF frequency ---------------------------------------------
+static int set_rfch(int fmt, double fs, const double *fo, const int *IQ,
+    int nbuff, const char *sig, double *fi)
+{
+    double freq = sdr_sig_freq(sig);
+    int rfch = 0;
+    
+    if (fmt == SDR_FMT_RAW8 && nbuff <= 2 && (fo[0] <= 0.0 || fo[1] <= 0.0)) {
+        // FE 2CH without LO frequencies
+        rfch = freq > 1.4e9 ? 0 : 1;
+    }
+    else if (fmt == SDR_FMT_RAW8 || fmt == SDR_FMT_RAW16 ||
+        fmt == SDR_FMT_RAW16I) { // FE 2CH, 4CH, 8CH, masked or multiple FEs
+        for (int i = 1; i < nbuff; i++) {
+            if (fabs(freq - fo[i]) < fabs(freq - fo[rfch])) rfch = i;
+        }
+    }
+    *fi = fo[rfch] > 0.0 ? freq - fo[rfch] : (IQ[rfch] == 1 ? fs * 0.5 : 0.0);
+    return rfch;
+}
+
+// bandwidth of narrowband signal by DDC (Hz) (0: not supported) --------------
+static double ddc_sig_bw(const char *sig)
+{
+    static const char *sigs[] = {
+        "L1CA", "L1S", "L2CM", "G1CA", "G2CA", "B1I", "B2I", "I5S", "ISS", NULL
+    };
+    static const double bw[] = {
+        2.046e6, 2.046e6, 2.046e6, 1.022e6, 1.022e6, 4.092e6, 4.092e6, 2.046e6,
+        2.046e6
+    };
+    for (int i = 0; sigs[i]; i++) {
+        if (!strcmp(sig, sigs[i])) return bw[i];
+    }
+    return 0.0;
+}
+
+// assign channels to DDCs by RF channel and carrier frequency -----------------
+static void set_ddc(sdr_rcv_t *rcv, const char **sigs, const int *prns, int n,
+    const int *rfch, const double *fi, int *ddc, int nnode)
+{
+    double fc[SDR_MAX_NDDC];
+    int rf[SDR_MAX_NDDC], nch[SDR_MAX_NDDC] = {0}, no[SDR_MAX_NDDC], ng = 0;
+    int D = rcv->opt.ddc;
+    
+    for (int i = 0; i < n; i++) {
+        double bw = ddc_sig_bw(sigs[i]);
+        double f = sdr_shift_freq(sigs[i], prns[i], fi[i]);
+        int j = 0;
+        ddc[i] = -1;
+        if (D < 2 || rcv->N % D || bw <= 0.0 || bw > DDC_BW * rcv->fs / D) {
+            continue;
+        }
+        while (j < ng && (rf[j] != rfch[i] || fabs(fc[j] - f) >= 1.0)) j++;
+        if (j >= ng) {
+            if (ng >= SDR_MAX_NDDC) continue;
+            rf[ng] = rfch[i];
+            fc[ng++] = f;
+        }
+        ddc[i] = j;
+        nch[j]++;
+    }
+    for (int j = 0; j < ng; j++) {
+        no[j] = -1;
+        if (nch[j] < DDC_MIN_NCH) continue;
+        int k = rcv->nddc++;
+        int node = nnode > 1 ? rf[j] % nnode : -1;
+        rcv->ddc[k] = sdr_ddc_new(D, rcv->fs, fc[j]);
+        rcv->ddc_rf[k] = rf[j];
+        rcv->ddc_buff[k] = sdr_buff_new_mem(rcv->N / D * rcv->max_buff, 2,
+            NULL, rcv->opt.buff_huge, node);
+        no[j] = k;
+    }
+    for (int i = 0; i < n; i++) {
+        if (ddc[i] >= 0) ddc[i] = no[ddc[i]];
+    }
+}
+
+// new IF data monitor --------------------------------------------------------
+static sdr_mon_t *mon_new(int N, int nblk)
+{
+    sdr_mon_t *mon = (sdr_mon_t *)sdr_malloc(sizeof(sdr_mon_t));
+    mon->N = N;
+    mon->nblk = nblk;
+    mon->w = (float *)sdr_malloc(sizeof(float) * N);
+    mon->P = (float *)sdr_malloc(sizeof(float) * N * nblk);
+    mon->hist = (int32_t *)sdr_malloc(sizeof(int32_t) * 32 * nblk);
+    for (int i = 0; i < N; i++) { // Hann window
+        mon->w[i] = 0.5 + 0.5 * cos(2.0 * PI * (i - 0.5 * (N - 1)) / (N - 1));
+        mon->w_ave += mon->w[i] / N;
+    }
+    pthread_mutex_init(&mon->mtx, NULL);
+    return mon;
+}
+
+// free IF data monitor --------------------------------------------------------
+static void mon_free(sdr_mon_t *mon)
+{
+    if (!mon) return;
+    pthread_mutex_destroy(&mon->mtx);
+    sdr_free(mon->w);
+    sdr_free(mon->P);
+    sdr_free(mon->hist);
+    sdr_free(mon);
+}
+
+// add snapshot of IF data to IF data monitor ----------------------------------
+static void mon_add(sdr_mon_t *mon, const sdr_buff_t *buff, int ix)
+{
+    fftwf_plan plan[2];
+    int N = mon->N;
+    
+    if (!sdr_fftw_plan(N, plan)) return;
+    sdr_cpx8_t *data = (sdr_cpx8_t *)sdr_scratch_alloc(N);
+    sdr_cpx_t *cpx = (sdr_cpx_t *)sdr_scratch_alloc(sizeof(sdr_cpx_t) * N * 2);
+    int32_t hist[32] = {0};
+    
+    sdr_buff_get(buff, ix, N, data);
+    for (int i = 0; i < N; i++) {
+        int I = SDR_CPX8_I(data[i]), Q = SDR_CPX8_Q(data[i]);
+        cpx[i][0] = I * mon->w[i];
+        cpx[i][1] = Q * mon->w[i];
+        hist[I+8]++;
+        hist[Q+24]++;
+    }
+    fftwf_execute_dft(plan[0], cpx, cpx + N);
+    
+    pthread_mutex_lock(&mon->mtx);
+    int k = (int)(mon->cnt % mon->nblk);
+    float *P = mon->P + (size_t)k * N;
+    for (int i = 0; i < N; i++) {
+        P[i] = cpx[N+i][0] * cpx[N+i][0] + cpx[N+i][1] * cpx[N+i][1];
+    }
+    memcpy(mon->hist + k * 32, hist, sizeof(hist));
+    __atomic_store_n(&mon->cnt, mon->cnt + 1, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&mon->mtx);
+    
+    sdr_scratch_free(data);
+    sdr_scratch_free(cpx);
+}
+
+// generate decode table of packed raw data ------------------------------------
+static void gen_dec(int IQ, sdr_cpx8_t *dec)
+{
+    static const int8_t valI[] = {1, 3, -1, -3}, valQ[] = {-1, -3, 1, 3};
+    
+    for (int i = 0; i < 16; i++) {
+        dec[i] = SDR_CPX8(valI[i & 0x3], IQ == 1 ? 0 : valQ[(i>>2) & 0x3]);
+    }
+}
+
+// set channel groups of satellites --------------------------------------------
+//  The channels of a satellite are linked as a circular list by rcv->grp in the
+//  order of the channels to look up the other bands of the satellite.
+static void set_grp(sdr_rcv_t *rcv)
+{
+    for (int i = 0; i < rcv->nch; i++) {
+        rcv->grp[i] = i;
+        for (int j = 1; j < rcv->nch; j++) {
+            int k = (i + j) % rcv->nch;
+            if (!strcmp(rcv->th[i]->ch->sat, rcv->th[k]->ch->sat)) {
+                rcv->grp[i] = k;
+                break;
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+//  Generate a new SDR receiver.
+//
+//  args:
+//      sigs      (I)  signal types as a string array {sig1, sig2, ..., sign}
+//      prns      (I)  PRN numbers as int array {prn1, prn2, ..., prnn}
+//      n         (I)  number of sigs and prns
+//      fmt       (I)  IF data format (SDR_FMT_???)
+//      fs        (I)  sampling rate (sps)
+//      fo        (I)  LO frequency for each RFCH (Hz)
+//      IQ        (I)  sampling type for each RFCH (1:I, 2:IQ)
 //
 //  returns:
 //      SDR receiver (NULL: error)
@@ -426,34 +1394,135 @@ static int set_rfch(int fmt, double fs, const double *fo, const int *IQ,
 sdr_rcv_t *sdr_rcv_new(const char **sigs, const int *prns, int n, int fmt,
     double fs, const double *fo, const int *IQ)
 {
+    return sdr_rcv_new_ndev(sigs, prns, n, 1, fmt, fs, fo, IQ);
+}
+
+//------------------------------------------------------------------------------
+//  Generate a new SDR receiver for multiple SDR devices. The SDR devices shall
+//  have the same packed raw IF data format and the same sampling rate with a
+//  shared reference clock. The RF channels of the devices are numbered in the
+//  order of the devices (RF channels 1-4 of device 1, RF channels 5-8 of device
+//  2, ... for RAW16) and the signals are assigned to the RF channels by the
+//  nearest LO frequencies. If the option ddc is set, the narrowband signals of
+//  the same RF channel and the same carrier frequency are tracked by the IF
+//  data decimated by a shared DDC (see sdr_ddc_new()).
+//
+//  args:
+//      sigs      (I)  signal types as a string array {sig1, sig2, ..., sign}
+//      prns      (I)  PRN numbers as int array {prn1, prn2, ..., prnn}
+//      n         (I)  number of sigs and prns
+//      ndev      (I)  number of SDR devices (1 - SDR_MAX_NDEV)
+//      fmt       (I)  IF data format (SDR_FMT_???)
+//      fs        (I)  sampling rate (sps)
+//      fo        (I)  LO frequency for each RFCH of each device (Hz)
+//                     (fo[i*SDR_MAX_RFCH+j]: RFCH j+1 of device i+1)
+//      IQ        (I)  sampling type for each RFCH of each device (1:I, 2:IQ)
+//                     (IQ[i*SDR_MAX_RFCH+j]: RFCH j+1 of device i+1)
+//
+//  returns:
+//      SDR receiver (NULL: error)
+//
+sdr_rcv_t *sdr_rcv_new_ndev(const char **sigs, const int *prns, int n,
+    int ndev, int fmt, double fs, const double *fo, const int *IQ)
+{
+    int nrf = fmt == SDR_FMT_RAW16I ? 8 : (fmt == SDR_FMT_RAW16 ? 4 :
+        (fmt == SDR_FMT_RAW8 ? 2 : 1));
+    
+    if (ndev < 1 || ndev > SDR_MAX_NDEV || (ndev > 1 && nrf <= 1)) {
+        fprintf(stderr, "SDR devices error: ndev=%d fmt=%d\n", ndev, fmt);
+        return NULL;
+    }
     sdr_rcv_t *rcv = (sdr_rcv_t *)sdr_malloc(sizeof(sdr_rcv_t));
     
+    rcv->opt = rcv_opt;
     rcv->fmt = fmt;
     rcv->fs = fs;
-    for (int i = 0; i < SDR_MAX_RFCH; i++) {
-        rcv->fo[i] = fo[i];
-        rcv->IQ[i] = IQ[i];
+    rcv->ndev = ndev;
+    for (int i = 0; i < ndev; i++) {
+        for (int j = 0; j < (ndev > 1 ? nrf : SDR_MAX_RFCH); j++) {
+            rcv->fo[i*nrf+j] = fo[i*SDR_MAX_RFCH+j];
+            rcv->IQ[i*nrf+j] = IQ[i*SDR_MAX_RFCH+j];
+        }
     }
     rcv->N = (int)(SDR_CYC * fs);
+    if (fmt == SDR_FMT_PACK && rcv->N % 2) {
+        fprintf(stderr, "sampling rate error for PACK format: fs=%.0f\n", fs);
+        sdr_free(rcv);
+        return NULL;
+    }
+    rcv->nbuff = nrf * ndev;
+    rcv->max_buff = rcv->opt.max_buff > 0 ? MAX(rcv->opt.max_buff, MIN_BUFF) :
+        MAX_BUFF;
+    if (rcv->max_buff > MAX_BUFF_N / rcv->N) { // sample index in int
+        fprintf(stderr, "IF data buffer size limited: max_buff=%d -> %d\n",
+            rcv->max_buff, MAX_BUFF_N / rcv->N);
+        rcv->max_buff = MAX_BUFF_N / rcv->N;
+    }
+    int nnode = rcv->opt.buff_numa ? sdr_get_nnode() : 1;
+    
+    for (int i = 0; i < rcv->nbuff; i++) {
+        int size = rcv->N * rcv->max_buff;
+        int node = nnode > 1 ? i % nnode : -1; // RF channels interleaved
+        
+        if (fmt == SDR_FMT_INT8 || fmt == SDR_FMT_INT8X2) {
+            rcv->buff[i] = sdr_buff_new_mem(size, rcv->IQ[i], NULL,
+                rcv->opt.buff_huge, node);
+            continue;
+        }
+        sdr_cpx8_t dec[16];
+        gen_dec(fmt == SDR_FMT_RAW16I ? 1 : rcv->IQ[i], dec);
+        if (rcv->N % 2 == 0) {
+            rcv->buff[i] = sdr_buff_new_mem(size, rcv->IQ[i], dec,
+                rcv->opt.buff_huge, node);
+        }
+        else {
+            rcv->buff[i] = sdr_buff_new_mem(size, rcv->IQ[i], NULL,
+                rcv->opt.buff_huge, node);
+            memcpy(rcv->buff[i]->dec, dec, sizeof(dec));
+        }
+    }
+    for (int i = 0; i < rcv->nbuff && rcv->opt.mon; i++) {
+        rcv->mon[i] = mon_new(SDR_N_PSD, MON_NBLK);
+    }
+    rcv->snap = (sdr_rcv_snap_t *)sdr_malloc(sizeof(sdr_rcv_snap_t));
+    rcv->snap->ver = SDR_SNAP_VER;
+    if (rcv->opt.prof) {
+        rcv->t_cyc = (double *)sdr_malloc(sizeof(double) * rcv->max_buff);
+    }
+    rcv->snap->size = (uint32_t)sizeof(sdr_rcv_snap_t);
+    int m = MAX(n, 1);
+    int *rfch = (int *)sdr_malloc(sizeof(int) * m * 2), *ddc = rfch + m;
+    double *fi = (double *)sdr_malloc(sizeof(double) * m);
+    
+    for (int i = 0; i < n; i++) {
+        rfch[i] = set_rfch(fmt, fs, rcv->fo, rcv->IQ, rcv->nbuff, sigs[i],
+            fi + i);
+    }
+    set_ddc(rcv, sigs, prns, n, rfch, fi, ddc, nnode);
+    
     for (int i = 0; i < n && rcv->nch < SDR_MAX_NCH; i++) {
-        double fi = 0.0;
-        int rfch = set_rfch(fmt, fs, fo, IQ, sigs[i], &fi);
-        sdr_ch_th_t *th = ch_th_new(sigs[i], prns[i], fi, fs, rcv);
+        int k = ddc[i], D = k >= 0 ? rcv->ddc[k]->D : 1;
+        double f = k >= 0 ? fi[i] - rcv->ddc[k]->fc : fi[i];
+        sdr_ch_th_t *th = ch_th_new(sigs[i], prns[i], f, fs / D, rcv);
         if (th) {
             th->ch->no = rcv->nch + 1;
-            th->ch->rf_ch = rfch;
+            th->ch->rf_ch = rfch[i];
+            th->buff = k >= 0 ? rcv->ddc_buff[k] : rcv->buff[rfch[i]];
+            th->N = rcv->N / D;
+            th->lag = k >= 0 ? 1 : 0; // DDC output delayed by a cycle
             rcv->th[rcv->nch++] = th;
         }
         else {
             fprintf(stderr, "signal / prn error: %s / %d\n", sigs[i], prns[i]);
         }
     }
-    rcv->nbuff = fmt == SDR_FMT_RAW16 ? 4 : (fmt == SDR_FMT_RAW8 ? 2 : 1);
-    for (int i = 0; i < rcv->nbuff; i++) {
-        rcv->buff[i] = sdr_buff_new(rcv->N * MAX_BUFF, rcv->IQ[i]);
-    }
+    sdr_free(rfch);
+    sdr_free(fi);
+    set_grp(rcv);
     rcv->ich = -1;
     pthread_mutex_init(&rcv->mtx, NULL);
+    pthread_cond_init(&rcv->cond, NULL);
+    pthread_cond_init(&rcv->sync, NULL);
     return rcv;
 }
 
@@ -475,143 +1544,804 @@ void sdr_rcv_free(sdr_rcv_t *rcv)
     }
     for (int i = 0; i < rcv->nbuff; i++) {
         sdr_buff_free(rcv->buff[i]);
+        mon_free(rcv->mon[i]);
+    }
+    for (int i = 0; i < rcv->nddc; i++) {
+        sdr_ddc_free(rcv->ddc[i]);
+        sdr_buff_free(rcv->ddc_buff[i]);
     }
+    pthread_cond_destroy(&rcv->sync);
+    pthread_cond_destroy(&rcv->cond);
+    pthread_mutex_destroy(&rcv->mtx);
+    sdr_free(rcv->view);
+    sdr_free(rcv->snap);
+    sdr_free(rcv->t_cyc);
+    sdr_free(rcv->stat_buff);
     sdr_free(rcv);
 }
 
-// read IF data ----------------------------------------------------------------
-static int read_data(sdr_rcv_t *rcv, uint8_t *raw, int N)
+// read IF data of SDR device -------------------------------------------------
+static int read_data(sdr_rcv_t *rcv, int dev, uint8_t *raw,
+    const uint8_t **data, int N)
 {
-    if (rcv->dev == SDR_DEV_FILE) { // file input
-        if (fread(raw, N, 1, (FILE *)rcv->dp) < 1) {
-            return 0; // end of file
+    sdr_dev_t *dp = (sdr_dev_t *)rcv->dps[dev];
+    *data = raw;
+    
+    if (rcv->dev == SDR_DEV_FILE) { // file input (view of mapped file)
+        if (!(*data = sdr_iff_view((sdr_iff_t *)rcv->dp, N))) {
+            *data = raw;
+            if (sdr_iff_read((sdr_iff_t *)rcv->dp, raw, N) < N) {
+                return 0; // end of file
+            }
+        }
+    }
+    else if (rcv->dev == SDR_DEV_NET) { // network IF data stream
+        while (!sdr_net_read((sdr_net_t *)rcv->dp, raw, N, TH_CYC)) {
+            if (!rcv->state) return 0;
+        }
+    }
+    else if (N <= SDR_MAX_VIEW) { // USB device (view of raw data buffer)
+        while (!(*data = sdr_dev_view(dp, N))) {
+            if (!rcv->state) return 0;
+            sdr_dev_wait(dp, N, TH_CYC);
         }
     }
     else { // USB device
-        while (!sdr_dev_read((sdr_dev_t *)rcv->dp, raw, N)) {
+        while (!sdr_dev_read(dp, raw, N)) {
             if (!rcv->state) return 0;
-            sdr_sleep_msec(1);
+            sdr_dev_wait(dp, N, TH_CYC);
         }
     }
     return N;
 }
 
-// generate lookup table -------------------------------------------------------
-static void gen_LUT(sdr_buff_t **buff, int nbuff, sdr_cpx8_t LUT[][256])
+// release IF data of SDR device -----------------------------------------------
+static void release_data(sdr_rcv_t *rcv, int dev, const uint8_t *raw,
+    const uint8_t *data, int N)
 {
-    static const int8_t valI[] = {1, 3, -1, -3}, valQ[] = {-1, -3, 1, 3};
+    if (rcv->rd) { // free cycle of read-ahead queue
+        __atomic_store_n(&rcv->rd->rp, rcv->rd->rp + 1, __ATOMIC_RELEASE);
+    }
+    else if (rcv->dev == SDR_DEV_USB && data != raw) {
+        sdr_dev_release((sdr_dev_t *)rcv->dps[dev], N);
+    }
+}
+
+// skip IF data of SDR device --------------------------------------------------
+static void skip_data(sdr_rcv_t *rcv, int dev, int64_t size)
+{
+    sdr_dev_t *dp = (sdr_dev_t *)rcv->dps[dev];
     
-    for (int i = 0; i < 256; i++) {
-        int8_t I[] = {valI[(i>>0) & 0x3], valI[(i>>4) & 0x3]};
-        int8_t Q[] = {valQ[(i>>2) & 0x3], valQ[(i>>6) & 0x3]};
-        for (int j = 0; j < nbuff; j++) {
-            LUT[j][i] = SDR_CPX8(I[j%2], buff[j]->IQ == 1 ? 0 : Q[j%2]);
+    for (int n; size > 0 && rcv->state; size -= n) {
+        n = (int)MIN(size, SDR_SIZE_BUFF);
+        while (!sdr_dev_wait(dp, n, TH_CYC)) {
+            if (!rcv->state) return;
         }
+        sdr_dev_release(dp, n);
     }
 }
 
-// write IF data buffer ---------------------------------------------------------
-static void write_buff(sdr_rcv_t *rcv, const uint8_t *raw, int64_t ix)
+// IF data reader thread -------------------------------------------------------
+//  The IF data file or the network IF data stream is read ahead of the receiver
+//  thread into the read-ahead queue, so the page faults of the mapped file, the
+//  waits for the chunks decoded by the decode threads of the compressed file
+//  and for the network packets do not stall the receiver thread. The queue is
+//  a ring of IF data cycles with a single producer and a single consumer, and
+//  the write and read pointers are published by the atomics without locks.
+static void *rd_thread(void *arg)
 {
-    static sdr_cpx8_t LUT[4][256] = {{0}};
-    int i = rcv->N * (int)(ix % MAX_BUFF);
+    sdr_rcv_t *rcv = (sdr_rcv_t *)arg;
+    sdr_reader_t *rd = rcv->rd;
+    
+    set_thread(rcv, 0);
     
-    if (!LUT[0][0] && (rcv->fmt == SDR_FMT_RAW8 || rcv->fmt == SDR_FMT_RAW16)) {
-        gen_LUT(rcv->buff, rcv->nbuff, LUT);
+    while (rd->state) {
+        int64_t wp = rd->wp;
+        if (wp - __atomic_load_n(&rd->rp, __ATOMIC_ACQUIRE) >= rd->depth) {
+            sdr_sleep_msec(1); // queue full
+            continue;
+        }
+        uint8_t *raw = rd->buff + (size_t)(wp % rd->depth) * rd->size;
+        const uint8_t *data;
+        if (!read_data(rcv, 0, raw, &data, rd->size)) break;
+        if (data != raw) {
+            memcpy(raw, data, rd->size);
+        }
+        __atomic_store_n(&rd->wp, wp + 1, __ATOMIC_RELEASE);
     }
+    __atomic_store_n(&rd->eof, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+// start IF data reader thread -------------------------------------------------
+static void rd_start(sdr_rcv_t *rcv, int size)
+{
+    if (rcv->opt.read_ahead <= 0 || rcv->ndev > 1 ||
+        (rcv->dev != SDR_DEV_FILE && rcv->dev != SDR_DEV_NET)) return;
+    
+    sdr_reader_t *rd = (sdr_reader_t *)sdr_malloc(sizeof(sdr_reader_t));
+    rd->state = 1;
+    rd->depth = MAX((int)(rcv->opt.read_ahead * 1e-3 / SDR_CYC), 2);
+    rd->size = size;
+    rd->buff = (uint8_t *)sdr_malloc((size_t)rd->depth * size);
+    rcv->rd = rd;
+    pthread_create(&rd->thread, NULL, rd_thread, rcv);
+}
+
+// stop IF data reader thread --------------------------------------------------
+static void rd_stop(sdr_rcv_t *rcv)
+{
+    sdr_reader_t *rd = rcv->rd;
+    
+    if (!rd) return;
+    rd->state = 0;
+    pthread_join(rd->thread, NULL);
+    sdr_free(rd->buff);
+    sdr_free(rd);
+    rcv->rd = NULL;
+}
+
+// read IF data cycle from read-ahead queue ------------------------------------
+static int rd_read(sdr_rcv_t *rcv, const uint8_t **data)
+{
+    sdr_reader_t *rd = rcv->rd;
+    int64_t rp = rd->rp;
+    
+    while (__atomic_load_n(&rd->wp, __ATOMIC_ACQUIRE) <= rp) {
+        if (__atomic_load_n(&rd->eof, __ATOMIC_ACQUIRE) &&
+            __atomic_load_n(&rd->wp, __ATOMIC_ACQUIRE) <= rp) {
+            return 0; // end of IF data
+        }
+        if (!rcv->state) return 0;
+        sdr_sleep_msec(1); // queue empty
+    }
+    *data = rd->buff + (size_t)(rp % rd->depth) * rd->size;
+    return rd->size;
+}
+
+// start SDR devices and align IF data ------------------------------------------
+//  The sampling of the SDR devices sharing a reference clock are aligned by the
+//  offsets of the host times of the start requests. The accuracy is limited by
+//  the latency of the USB control requests.
+static void start_dev(sdr_rcv_t *rcv)
+{
+    int ns = rcv->fmt == SDR_FMT_RAW8 ? 1 : 2;
+    double tmax = 0.0;
+    
+    for (int i = 0; i < rcv->ndev; i++) {
+        sdr_dev_t *dp = (sdr_dev_t *)rcv->dps[i];
+        sdr_dev_start(dp, rcv->opt.usb_nbuff, rcv->opt.usb_size << 10);
+        tmax = MAX(tmax, dp->tstart);
+    }
+    for (int i = 0; rcv->ndev > 1 && i < rcv->ndev; i++) {
+        double toff = tmax - ((sdr_dev_t *)rcv->dps[i])->tstart;
+        int64_t skip = (int64_t)floor(toff * rcv->fs + 0.5);
+        sdr_log(3, "$LOG,%.3f,%s,%d,DEVICE ALIGN DEV=%d OFFSET=%.6f SKIP=%lld",
+            0.0, "", 0, i + 1, toff, (long long)skip);
+        skip_data(rcv, i, skip * ns);
+    }
+}
+
+// write IF data buffer of RF channel ------------------------------------------
+static void write_buff_ch(sdr_rcv_t *rcv, const uint8_t **raw, int i, int ch)
+{
+    int nrf = rcv->nbuff / rcv->ndev;
+    sdr_buff_write_raw(rcv->buff[ch], i, raw[ch / nrf], rcv->N, rcv->fmt,
+        ch % nrf);
+}
+
+// IF data unpack thread -------------------------------------------------------
+static void *up_thread(void *arg)
+{
+    sdr_rcv_t *rcv = (sdr_rcv_t *)arg;
+    sdr_unpack_t *up = rcv->up;
+    int ch = __atomic_add_fetch(&up->nth, 1, __ATOMIC_SEQ_CST);
+    int64_t seq = 0;
+    
+    set_thread(rcv, 0);
+    
+    pthread_mutex_lock(&up->mtx);
+    while (up->state) {
+        if (up->seq == seq) {
+            pthread_cond_wait(&up->cond, &up->mtx);
+            continue;
+        }
+        seq = up->seq;
+        const uint8_t **raw = up->raw;
+        int i = up->i;
+        pthread_mutex_unlock(&up->mtx);
+        
+        double t0 = rcv->opt.prof ? sdr_get_cputime() : 0.0;
+        write_buff_ch(rcv, raw, i, ch);
+        add_cpu(rcv, &rcv->cpu[0], t0);
+        
+        pthread_mutex_lock(&up->mtx);
+        up->done++;
+        pthread_cond_broadcast(&up->cond);
+    }
+    pthread_mutex_unlock(&up->mtx);
+    return NULL;
+}
+
+// start IF data unpack threads ------------------------------------------------
+static void up_start(sdr_rcv_t *rcv)
+{
+    if (!rcv->opt.unpack_th || rcv->nbuff <= 1) return;
+    
+    sdr_unpack_t *up = (sdr_unpack_t *)sdr_malloc(sizeof(sdr_unpack_t));
+    up->state = 1;
+    pthread_mutex_init(&up->mtx, NULL);
+    pthread_cond_init(&up->cond, NULL);
+    rcv->up = up;
+    for (int i = 1; i < rcv->nbuff; i++) {
+        pthread_create(&up->thread[i], NULL, up_thread, rcv);
+    }
+}
+
+// stop IF data unpack threads -------------------------------------------------
+static void up_stop(sdr_rcv_t *rcv)
+{
+    sdr_unpack_t *up = rcv->up;
+    
+    if (!up) return;
+    pthread_mutex_lock(&up->mtx);
+    up->state = 0;
+    pthread_cond_broadcast(&up->cond);
+    pthread_mutex_unlock(&up->mtx);
+    for (int i = 1; i < rcv->nbuff; i++) {
+        pthread_join(up->thread[i], NULL);
+    }
+    pthread_cond_destroy(&up->cond);
+    pthread_mutex_destroy(&up->mtx);
+    sdr_free(up);
+    rcv->up = NULL;
+}
+
+// unpack raw IF data by RF channel threads ------------------------------------
+static void write_buff_th(sdr_rcv_t *rcv, const uint8_t **raw, int i)
+{
+    sdr_unpack_t *up = rcv->up;
+    
+    pthread_mutex_lock(&up->mtx);
+    up->raw = raw;
+    up->i = i;
+    up->done = 0;
+    up->seq++;
+    pthread_cond_broadcast(&up->cond);
+    pthread_mutex_unlock(&up->mtx);
+    
+    write_buff_ch(rcv, raw, i, 0);
+    
+    pthread_mutex_lock(&up->mtx);
+    while (up->done < rcv->nbuff - 1) {
+        pthread_cond_wait(&up->cond, &up->mtx);
+    }
+    pthread_mutex_unlock(&up->mtx);
+}
+
+// write IF data buffer ---------------------------------------------------------
+static void write_buff(sdr_rcv_t *rcv, const uint8_t **raw, int64_t ix)
+{
+    int i = rcv->N * (int)(ix % rcv->max_buff);
+    
     if (rcv->fmt == SDR_FMT_INT8) { // int8
-        for (int j = 0; j < rcv->N; i++, j++) {
-            rcv->buff[0]->data[i] = SDR_CPX8(raw[j], 0);
+        sdr_buff_write_int8(rcv->buff[0], i, (const int8_t *)raw[0], rcv->N, 1);
+    }
+    else if (rcv->fmt == SDR_FMT_INT8X2) { // int8 x 2 complex
+        sdr_buff_write_int8(rcv->buff[0], i, (const int8_t *)raw[0], rcv->N, 2);
+    }
+    else if (rcv->up) { // packed raw split by RF channels
+        write_buff_th(rcv, raw, i);
+    }
+    else { // packed raw
+        for (int ch = 0; ch < rcv->nbuff; ch++) {
+            write_buff_ch(rcv, raw, i, ch);
+        }
+    }
+    if (ix > 0) { // DDCs for previous cycle (filter spans next cycle)
+        int j = (int)((ix - 1) % rcv->max_buff);
+        for (int k = 0; k < rcv->nddc; k++) {
+            sdr_ddc_t *ddc = rcv->ddc[k];
+            sdr_ddc_proc(ddc, rcv->buff[rcv->ddc_rf[k]], rcv->N * j, rcv->N,
+                rcv->ddc_buff[k], rcv->N / ddc->D * j);
+        }
+    }
+    if (ix % MON_CYC == 0) { // snapshots of IF data monitors
+        for (int ch = 0; ch < rcv->nbuff; ch++) {
+            sdr_buff_t *buff = rcv->buff[ch];
+            if (!rcv->mon[ch] || (ix + 1) * rcv->N < rcv->mon[ch]->N) continue;
+            mon_add(rcv->mon[ch], buff, (i + rcv->N - rcv->mon[ch]->N +
+                buff->N) % buff->N);
+        }
+    }
+    set_buff_ix(rcv, ix); // update IF data buffer write pointer
+}
+
+// re-acquisition --------------------------------------------------------------
+static int re_acq(sdr_rcv_t *rcv, sdr_ch_t *ch)
+{
+    if (ch->lock * ch->T >= MIN_LOCK &&
+        get_buff_ix(rcv) * SDR_CYC < ch->time + TO_REACQ) {
+        ch->acq->fd_ext = ch->fd;
+        return 1;
+    }
+    return 0;
+}
+
+// geometric Doppler and elevation of channel signal ---------------------------
+static int geo_dop(sdr_pvt_t *pvt, gtime_t time, const double *rr,
+    const sdr_ch_t *ch, double *fd, double *el)
+{
+    double rs[6], dts[2], var, e[3], pos[3], azel[2];
+    int svh, sat = satid2no(ch->sat);
+    
+    if (!sat || !satpos(time, time, sat, EPHOPT_BRDC, pvt->nav, rs, dts, &var,
+        &svh) || geodist(rs, rr, e) <= 0.0) {
+        return 0;
+    }
+    ecef2pos(rr, pos);
+    *el = satazel(pos, e, azel);
+    *fd = -(dot(e, rs + 3, 3) - CLIGHT * dts[1]) * ch->fc / CLIGHT;
+    return 1;
+}
+
+// save receiver state for warm start ------------------------------------------
+//  The clock drift is estimated by the Doppler frequencies of the locked
+//  channels against the geometric ones at the last fix.
+static void save_state(sdr_rcv_t *rcv)
+{
+    sdr_pvt_t *pvt = rcv->pvt;
+    double sum = 0.0, fd, el;
+    int n = 0, week;
+    FILE *fp;
+    
+    if (rcv->dev != SDR_DEV_USB || !rcv->opt.warm ||
+        pvt->sol->stat == SOLQ_NONE || norm(pvt->sol->rr, 3) <= 0.0) {
+        return;
+    }
+    for (int i = 0; i < rcv->nch; i++) {
+        sdr_ch_t *ch = rcv->th[i]->ch;
+        if (ch->state != SDR_STATE_LOCK || ch->lock * ch->T < MIN_LOCK ||
+            !geo_dop(pvt, pvt->sol->time, pvt->sol->rr, ch, &fd, &el)) {
+            continue;
+        }
+        sum += (ch->fd - fd) / ch->fc;
+        n++;
+    }
+    if (!(fp = fopen(FILE_STATE, "w"))) {
+        fprintf(stderr, "receiver state file open error: %s\n", FILE_STATE);
+        return;
+    }
+    double tow = time2gpst(pvt->sol->time, &week);
+    fprintf(fp, "$STATE,%d,%.3f,%.4f,%.4f,%.4f,%.6e\n", week, tow,
+        pvt->sol->rr[0], pvt->sol->rr[1], pvt->sol->rr[2],
+        n > 0 ? sum / n : 0.0);
+    for (int i = 0; i < rcv->nch; i++) {
+        sdr_ch_t *ch = rcv->th[i]->ch;
+        if (ch->state != SDR_STATE_LOCK || ch->lock * ch->T < MIN_LOCK) {
+            continue;
+        }
+        fprintf(fp, "$CH,%s,%d,%.2f,%.9f\n", ch->sig, ch->prn, ch->fd,
+            ch->coff);
+    }
+    fclose(fp);
+}
+
+// load receiver state for warm start ------------------------------------------
+//  The channels of the satellites invisible at the saved position are
+//  suspended until the first fix or TO_VIS without a fix (see
+//  update_vis_ch()).
+static void load_state(sdr_rcv_t *rcv)
+{
+    char buff[256], sig[16];
+    double tow, rr[3], drift, fd, coff, el;
+    int week, prn, stat = 0;
+    FILE *fp;
+    
+    if (rcv->dev != SDR_DEV_USB || !rcv->opt.warm ||
+        !(fp = fopen(FILE_STATE, "r"))) {
+        return;
+    }
+    sdr_warm_t *warm = (sdr_warm_t *)sdr_malloc(sizeof(sdr_warm_t));
+    warm->time = utc2gpst(timeget());
+    
+    while (fgets(buff, sizeof(buff), fp)) {
+        if (sscanf(buff, "$STATE,%d,%lf,%lf,%lf,%lf,%lf", &week, &tow, rr,
+            rr + 1, rr + 2, &drift) == 6) {
+            warm->age = timediff(warm->time, gpst2time(week, tow));
+            matcpy(warm->rr, rr, 3, 1);
+            warm->drift = drift;
+            stat = 1;
+        }
+        else if (sscanf(buff, "$CH,%15[^,],%d,%lf,%lf", sig, &prn, &fd,
+            &coff) == 4) {
+            for (int i = 0; i < rcv->nch; i++) {
+                sdr_ch_t *ch = rcv->th[i]->ch;
+                if (!strcmp(ch->sig, sig) && ch->prn == prn) {
+                    warm->fd[i] = (float)fd;
+                }
+            }
+        }
+    }
+    fclose(fp);
+    
+    if (!stat || warm->age < -TO_WARM || warm->age > MAX_AGE_WARM) {
+        sdr_free(warm);
+        return;
+    }
+    for (int i = 0; i < rcv->nch && rcv->opt.vis_ch; i++) {
+        sdr_ch_t *ch = rcv->th[i]->ch;
+        if (geo_dop(rcv->pvt, warm->time, warm->rr, ch, &fd, &el) &&
+            el * R2D < MIN_EL_VIS) {
+            sdr_ch_suspend(ch);
+        }
+    }
+    sdr_log(3, "$LOG,%.3f,%s,%d,WARM START AGE=%.0f", 0.0, "", 0, warm->age);
+    rcv->warm = warm;
+}
+
+// warm start acquisition ------------------------------------------------------
+//  The Doppler frequency is predicted by the navigation data at the saved
+//  position with the saved clock drift, or taken from the saved one for a
+//  quick restart without the navigation data. The search is started once per
+//  channel within TO_WARM after the start of the receiver.
+static int warm_acq(sdr_rcv_t *rcv, sdr_ch_t *ch)
+{
+    sdr_warm_t *warm = rcv->warm;
+    double time = get_buff_ix(rcv) * SDR_CYC, fd, el;
+    int i = ch->no - 1, stat;
+    
+    if (!warm || warm->srch[i] || time > TO_WARM) return 0;
+    
+    if (pthread_mutex_trylock(&rcv->pvt->mtx)) { // PVT being solved
+        return 0;
+    }
+    stat = geo_dop(rcv->pvt, timeadd(warm->time, time), warm->rr, ch, &fd,
+        &el);
+    pthread_mutex_unlock(&rcv->pvt->mtx);
+    
+    if (stat) {
+        fd += warm->drift * ch->fc;
+    }
+    else if (warm->fd[i] != 0.0f && warm->age + time < TO_REACQ) {
+        fd = warm->fd[i];
+    }
+    else {
+        return 0;
+    }
+    warm->srch[i] = 1;
+    ch->acq->fd_ext = fd;
+    return 1;
+}
+
+// cold acquisition of short code cycle with full Doppler search ---------------
+static int cold_acq(sdr_ch_t *ch)
+{
+    if (ch->T > MAX_ACQ) return 0;
+    ch->acq->fd_ext = 0.0;
+    return 1;
+}
+
+// handover from other band of satellite ---------------------------------------
+//  The code start and the Doppler of a locked band of the satellite with the
+//  resolved TOW are handed over to the channel, which starts tracking without
+//  signal search (see hand_track() in sdr_ch.c). The handover is not retried
+//  within TO_HAND for the channel.
+static int handover(sdr_rcv_t *rcv, int i)
+{
+    sdr_ch_t *ch = rcv->th[i]->ch;
+    double time = get_buff_ix(rcv) * SDR_CYC;
+    
+    if (ch->acq->t_hand > 0.0 && time < ch->acq->t_hand + TO_HAND) return 0;
+    
+    for (int j = rcv->grp[i]; j != i; j = rcv->grp[j]) {
+        sdr_ch_t *ch_j = rcv->th[j]->ch;
+        if (ch_j->state != SDR_STATE_LOCK || ch_j->lock * ch_j->T < MIN_LOCK) {
+            continue;
+        }
+        pthread_mutex_lock(&ch_j->mtx);
+        int stat = ch_j->state == SDR_STATE_LOCK && ch_j->week > 0 &&
+            ch_j->tow >= 0;
+        if (stat) {
+            ch->acq->hand_rx = ch_j->time + ch_j->coff;
+            ch->acq->hand_tx = ch_j->tow * 1e-3;
+            ch->acq->fd_ext = ch_j->fd * ch->fc / ch_j->fc;
+        }
+        pthread_mutex_unlock(&ch_j->mtx);
+        if (!stat) continue;
+        ch->acq->hand = 1;
+        ch->acq->t_hand = time;
+        return 1;
+    }
+    return 0;
+}
+
+// assisted acquisition --------------------------------------------------------
+static int assist_acq(sdr_rcv_t *rcv, int i)
+{
+    sdr_ch_t *ch = rcv->th[i]->ch;
+    
+    for (int j = rcv->grp[i]; j != i; j = rcv->grp[j]) {
+        sdr_ch_t *ch_j = rcv->th[j]->ch;
+        if (ch_j->state != SDR_STATE_LOCK || ch_j->lock * ch_j->T < MIN_LOCK) {
+            continue;
+        }
+        ch->acq->fd_ext = ch_j->fd * ch->fc / ch_j->fc;
+        return 1;
+    }
+    return 0;
+}
+
+// update IF data rate ---------------------------------------------------------
+static uint32_t update_data_rate(sdr_rcv_t *rcv, uint32_t tick, int sum_size)
+{
+    uint32_t tick_a = sdr_get_tick();
+    if (tick_a == tick) return tick;
+    rcv->data_rate = (double)sum_size / ((tick_a - tick) * 1e-3);
+    return tick_a;
+}
+
+// update IF data buffer usage rate --------------------------------------------
+static void update_buff_use(sdr_rcv_t *rcv)
+{
+    rcv->buff_use = 0.0;
+    int64_t ix = get_buff_ix(rcv);
+    for (int i = 0; i < rcv->nch; i++) {
+        double use = (ix - rcv->th[i]->ix) * 100.0 / rcv->max_buff;
+        if (use > rcv->buff_use) rcv->buff_use = use;
+    }
+    if (rcv->buff_use > rcv->buff_peak) rcv->buff_peak = rcv->buff_use;
+}
+
+// update channels by satellite visibility -------------------------------------
+//  Without a fix for TO_VIS, all suspended channels are resumed as visible, so
+//  the channels suspended by a stale position of the receiver state file or by
+//  a lost fix do not wait for a fix which may never come.
+static void update_vis_ch(sdr_rcv_t *rcv)
+{
+    sdr_pvt_t *pvt = rcv->pvt;
+    double pos[3], rs[6], dts[2], var, e[3], azel[2];
+    double time = get_buff_ix(rcv) * SDR_CYC;
+    int svh;
+    
+    if (!rcv->opt.vis_ch) return;
+    
+    if (pthread_mutex_trylock(&pvt->mtx)) { // PVT being solved
+        return;
+    }
+    if (pvt->sol->stat == SOLQ_NONE || norm(pvt->sol->rr, 3) <= 0.0) {
+        pthread_mutex_unlock(&pvt->mtx);
+        if (time - rcv->t_vis < TO_VIS) return;
+        for (int i = 0; i < rcv->nch; i++) {
+            sdr_ch_t *ch = rcv->th[i]->ch;
+            if (sdr_ch_resume(ch)) {
+                sdr_log(3, "$LOG,%.3f,%s,%d,CHANNEL RESUMED (NO FIX)", time,
+                    ch->sig, ch->prn);
+            }
+        }
+        return;
+    }
+    rcv->t_vis = time;
+    ecef2pos(pvt->sol->rr, pos);
+    
+    for (int i = 0; i < rcv->nch; i++) {
+        sdr_ch_t *ch = rcv->th[i]->ch;
+        int sat = satid2no(ch->sat);
+        
+        // satellite w/o ephemeris assumed as visible
+        if (!sat || !satpos(pvt->sol->time, pvt->sol->time, sat, EPHOPT_BRDC,
+            pvt->nav, rs, dts, &var, &svh) ||
+            geodist(rs, pvt->sol->rr, e) <= 0.0 ||
+            satazel(pos, e, azel) * R2D >= MIN_EL_VIS) {
+            if (sdr_ch_resume(ch)) {
+                sdr_log(3, "$LOG,%.3f,%s,%d,CHANNEL RESUMED", time, ch->sig,
+                    ch->prn);
+            }
+        }
+        else if (sdr_ch_suspend(ch)) {
+            sdr_log(3, "$LOG,%.3f,%s,%d,CHANNEL SUSPENDED (EL=%.1f)", time,
+                ch->sig, ch->prn, azel[1] * R2D);
+        }
+    }
+    pthread_mutex_unlock(&pvt->mtx);
+}
+
+// update signal search channels -----------------------------------------------
+//  IDLE channels are started to search signals up to the max number of signal
+//  search channels in the order of priority: (1) re-acquisition, (2) handover
+//  from other band, assisted or warm start acquisition and (3) cold search of
+//  short code cycle. The channels of same priority are scanned in round-robin
+//  from the last started channel. The other bands of the satellite are looked
+//  up in the channel group of the satellite.
+//
+static void update_srch_ch(sdr_rcv_t *rcv)
+{
+    int nsrch = 0, ich = rcv->ich;
+    int max_srch = rcv->opt.nsrch > 0 ? rcv->opt.nsrch :
+        (rcv->nacq > 0 ? rcv->nacq : rcv->nwk / 2);
+    
+    if (rcv->buff_use > MAX_BUFF_USE || rcv->shed) { // IF data buffer full
+        return;                                      // or load shedding ?
+    }
+    for (int i = 0; i < rcv->nch; i++) {
+        sdr_ch_t *ch = rcv->th[i]->ch;
+        if (ch->state == SDR_STATE_SRCH) {
+            nsrch++;
+        }
+    }
+    if (max_srch < 1) max_srch = 1;
+    
+    for (int pri = 0; pri < 3 && nsrch < max_srch; pri++) {
+        for (int i = 1; i <= rcv->nch && nsrch < max_srch; i++) {
+            int j = (ich + i + rcv->nch) % rcv->nch;
+            sdr_ch_t *ch = rcv->th[j]->ch;
+            if (ch->state != SDR_STATE_IDLE || ch->susp || ch->shed >= 2) {
+                continue;
+            }
+            if ((pri == 0 && re_acq(rcv, ch)) ||
+                (pri == 1 && (handover(rcv, j) || assist_acq(rcv, j) ||
+                warm_acq(rcv, ch))) || (pri == 2 && cold_acq(ch))) {
+                ch->state = SDR_STATE_SRCH;
+                rcv->ich = j;
+                nsrch++;
+            }
+        }
+    }
+}
+
+// channel value for load shedding by priority policy -------------------------
+//  The policy is given as the decimal digits of the priority keys from the
+//  most significant one (1: constellation, 2: signal order in the channels of
+//  the satellite, 3: C/N0, 4: satellite used in PVT).
+static double shed_value(sdr_rcv_t *rcv, int i, const uint8_t *vs)
+{
+    sdr_ch_t *ch = rcv->th[i]->ch;
+    const char *q;
+    char pol[16];
+    double val = 0.0;
+    
+    sprintf(pol, "%d", rcv->opt.shed_pol);
+    for (const char *p = pol; *p; p++) {
+        double key = 0.0;
+        if (*p == '1') {
+            q = strchr(SHED_SYS, ch->sat[0]);
+            key = q ? 99 - (q - SHED_SYS) * 10 : 0;
         }
-    }
-    else if (rcv->fmt == SDR_FMT_INT8X2) { // int8 x 2 complex
-        for (int j = 0; j < rcv->N * 2; i++, j += 2) {
-            rcv->buff[0]->data[i] = SDR_CPX8(raw[j], -raw[j+1]);
+        else if (*p == '2') {
+            int n = 0;
+            for (int j = 0; j < i; j++) {
+                if (!strcmp(rcv->th[j]->ch->sat, ch->sat)) n++;
+            }
+            key = MAX(99 - n * 10, 0);
         }
-    }
-    else if (rcv->fmt == SDR_FMT_RAW8) { // packed 8 bit raw (2CH)
-        for (int j = 0; j < rcv->N; i++, j++) {
-            rcv->buff[0]->data[i] = LUT[0][raw[j]];
-            rcv->buff[1]->data[i] = LUT[1][raw[j]];
+        else if (*p == '3') {
+            key = MIN(ch->cn0, 99.0);
         }
-    }
-    else if (rcv->fmt == SDR_FMT_RAW16) { // packed 16 bit raw (4CH)
-        for (int j = 0; j < rcv->N * 2; i++, j += 2) {
-            rcv->buff[0]->data[i] = LUT[0][raw[j  ]];
-            rcv->buff[1]->data[i] = LUT[1][raw[j  ]];
-            rcv->buff[2]->data[i] = LUT[2][raw[j+1]];
-            rcv->buff[3]->data[i] = LUT[3][raw[j+1]];
+        else if (*p == '4') {
+            key = vs[i] ? 99 : 0;
         }
+        val = val * 100.0 + key;
     }
-    set_buff_ix(rcv, ix); // update IF data buffer write pointer
+    return val;
 }
 
-// re-acquisition --------------------------------------------------------------
-static int re_acq(sdr_rcv_t *rcv, sdr_ch_t *ch)
+// pause or resume channel by load shedding ------------------------------------
+//  The tracking channel of the lowest value (the most lagging in the same
+//  value) is paused, or the paused channel of the highest value is resumed.
+//  It returns 1 if a channel paused or resumed, 0 if no channel to pause or
+//  resume and -1 if PVT being solved.
+static int shed_ch(sdr_rcv_t *rcv, int resume, double time)
 {
-    if (ch->lock * ch->T >= MIN_LOCK &&
-        get_buff_ix(rcv) * SDR_CYC < ch->time + TO_REACQ) {
-        ch->acq->fd_ext = ch->fd;
-        return 1;
+    sdr_pvt_t *pvt = rcv->pvt;
+    uint8_t vs[SDR_MAX_NCH] = {0};
+    double val_k = 0.0;
+    int64_t ix = get_buff_ix(rcv), lag_k = 0;
+    int k = -1;
+    
+    if (pthread_mutex_trylock(&pvt->mtx)) { // PVT being solved
+        return -1;
     }
-    return 0;
+    for (int i = 0; i < rcv->nch; i++) {
+        int sat = satid2no(rcv->th[i]->ch->sat);
+        vs[i] = sat ? (uint8_t)pvt->ssat[sat-1].vs : 0;
+    }
+    pthread_mutex_unlock(&pvt->mtx);
+    
+    for (int i = 0; i < rcv->nch; i++) {
+        sdr_ch_t *ch = rcv->th[i]->ch;
+        if (resume ? ch->shed < 2 :
+            ch->shed >= 2 || ch->state != SDR_STATE_LOCK) continue;
+        double val = shed_value(rcv, i, vs);
+        int64_t lag = ix - rcv->th[i]->ix;
+        if (k < 0 || (resume ? val > val_k : val < val_k ||
+            (val == val_k && lag > lag_k))) {
+            k = i;
+            val_k = val;
+            lag_k = lag;
+        }
+    }
+    if (k < 0) return 0;
+    sdr_ch_t *ch = rcv->th[k]->ch;
+    __atomic_store_n(&ch->shed, resume ? (rcv->shed >= 2 ? 1 : 0) : 2,
+        __ATOMIC_RELAXED);
+    sdr_log(3, "$LOG,%.3f,%s,%d,CHANNEL %s (LOAD SHEDDING BUFF=%.1f)", time,
+        ch->sig, ch->prn, resume ? "RESUMED" : "PAUSED", rcv->buff_use);
+    return 1;
 }
 
-// assisted acquisition --------------------------------------------------------
-static int assist_acq(sdr_rcv_t *rcv, sdr_ch_t *ch)
+// set load shedding level -----------------------------------------------------
+//  (1) no signal search and no additional correlators, (2) + nav decoding
+//  skipped after TOW resolved, (3) + channels paused by the priority policy
+static void set_shed(sdr_rcv_t *rcv, int level, double time)
 {
+    rcv->shed = level;
     for (int i = 0; i < rcv->nch; i++) {
-        sdr_ch_t *ch_i = rcv->th[i]->ch;
-        if (strcmp(ch->sat, ch_i->sat) || ch_i->state != SDR_STATE_LOCK ||
-            ch_i->lock * ch_i->T < MIN_LOCK) continue;
-        ch->acq->fd_ext = ch_i->fd * ch->fc / ch_i->fc;
-        return 1;
+        sdr_ch_t *ch = rcv->th[i]->ch;
+        if (ch->shed >= 2) continue;
+        __atomic_store_n(&ch->shed, level >= 2 ? 1 : 0, __ATOMIC_RELAXED);
     }
-    return 0;
+    sdr_rcv_sel_ch(rcv, rcv->ch_sel);
+    sdr_log(3, "$LOG,%.3f,%s,%d,LOAD SHEDDING LEVEL=%d BUFF=%.1f", time, "", 0,
+        level, rcv->buff_use);
 }
 
-// update IF data rate ---------------------------------------------------------
-static uint32_t update_data_rate(sdr_rcv_t *rcv, uint32_t tick, int sum_size)
+// update load shedding --------------------------------------------------------
+//  The load shedding level is raised while the IF data buffer usage (max lag
+//  of channels) exceeds the option shed and is not decreasing. At the max
+//  level, the channels are paused one by one. After the usage is kept under
+//  half of shed for SHED_HOLD, the paused channels are resumed one by one and
+//  then the level is lowered.
+static void update_shed(sdr_rcv_t *rcv, double time)
 {
-    uint32_t tick_a = sdr_get_tick();
-    if (tick_a == tick) return tick;
-    rcv->data_rate = (double)sum_size / ((tick_a - tick) * 1e-3);
-    return tick_a;
+    double thres = rcv->opt.shed, use_p = rcv->shed_use;
+    
+    if (thres <= 0.0) return;
+    update_buff_use(rcv);
+    rcv->shed_use = rcv->buff_use;
+    
+    if (rcv->buff_use > thres) {
+        rcv->shed_hold = 0;
+        if (rcv->buff_use < use_p) return; // recovering
+        if (rcv->shed < 3) {
+            set_shed(rcv, rcv->shed + 1, time);
+        }
+        else {
+            shed_ch(rcv, 0, time);
+        }
+    }
+    else if (rcv->buff_use < thres * 0.5 && rcv->shed > 0) {
+        if (++rcv->shed_hold < SHED_HOLD) return;
+        rcv->shed_hold = 0;
+        if (!shed_ch(rcv, 1, time)) {
+            set_shed(rcv, rcv->shed - 1, time);
+        }
+    }
+    else {
+        rcv->shed_hold = 0;
+    }
 }
 
-// update IF data buffer usage rate --------------------------------------------
-static void update_buff_use(sdr_rcv_t *rcv)
+// all channels processed IF data up to buffer pointer ? -----------------------
+static int ch_synced(sdr_rcv_t *rcv, int64_t ix)
 {
-    rcv->buff_use = 0.0;
-    int64_t ix = get_buff_ix(rcv);
     for (int i = 0; i < rcv->nch; i++) {
-        double use = (ix - rcv->th[i]->ix) * 100.0 / MAX_BUFF;
-        if (use > rcv->buff_use) rcv->buff_use = use;
+        sdr_ch_th_t *th = rcv->th[i];
+        int n = th->ch->N / th->N;
+        if (!th->state) continue;
+        if (__atomic_load_n(&th->busy, __ATOMIC_ACQUIRE) ||
+            th->ix + 2 * n <= ix - th->lag) return 0;
     }
+    return 1;
 }
 
-// update signal search channel ------------------------------------------------
-static void update_srch_ch(sdr_rcv_t *rcv)
+// wait for channels processed IF data (backpressure of fast replay) -----------
+static void wait_ch_sync(sdr_rcv_t *rcv, int64_t ix)
 {
-    if (rcv->buff_use > MAX_BUFF_USE) { // IF data buffer full ?
-        return;
-    }
-    // signal search channel busy ?
-    if (rcv->ich >= 0 && rcv->th[rcv->ich]->ch->state == SDR_STATE_SRCH) {
-        return;
-    }
-    for (int i = 0; i < rcv->nch; i++) {
-        // search next IDLE channel
-        rcv->ich = (rcv->ich + 1) % rcv->nch;
-        sdr_ch_t *ch = rcv->th[rcv->ich]->ch;
-        if (ch->state != SDR_STATE_IDLE) continue;
-        
-        // re-acquisition, assisted-acquisition or short code cycle
-        if (re_acq(rcv, ch) || assist_acq(rcv, ch) || ch->T <= MAX_ACQ) {
-            ch->state = SDR_STATE_SRCH;
-            break;
-        }
+    pthread_mutex_lock(&rcv->mtx);
+    while (rcv->state && !ch_synced(rcv, ix)) {
+        sdr_cond_wait(&rcv->sync, &rcv->mtx, TH_CYC);
     }
+    pthread_mutex_unlock(&rcv->mtx);
 }
 
 // SDR receiver thread ---------------------------------------------------------
@@ -619,58 +2349,161 @@ static void *rcv_thread(void *arg)
 {
     sdr_rcv_t *rcv = (sdr_rcv_t *)arg;
     int ns = (rcv->fmt == SDR_FMT_INT8 || rcv->fmt == SDR_FMT_RAW8) ? 1 : 2;
-    int size, sum_size = 0;
-    uint8_t *raw = (uint8_t *)sdr_malloc(ns * rcv->N);
+    int size = rcv->fmt == SDR_FMT_PACK ? rcv->N / 2 : ns * rcv->N;
+    int sum_size = 0;
+    uint8_t *raw = (uint8_t *)sdr_malloc(size * rcv->ndev);
+    const uint8_t *data[SDR_MAX_NDEV];
     uint32_t tick = sdr_get_tick(), tick_r = tick;
+    int64_t dev_stat[3] = {0};
+    
+    set_thread(rcv, 0);
     
     sdr_log(3, "$LOG,%.3f,%s,%d,START NCH=%d FMT=%d", 0.0, "", 0, rcv->nch,
         rcv->fmt);
     
     if (rcv->dev == SDR_DEV_USB) {
-        sdr_dev_start((sdr_dev_t *)rcv->dp);
+        start_dev(rcv);
     }
+    rd_start(rcv, size);
     rcv->data_sum = 0.0;
     
     for (int64_t ix = 0; rcv->state; ix++) {
+        double t0 = rcv->opt.prof ? sdr_get_cputime() : 0.0;
+        int64_t ts = sdr_trace_begin();
+        
+        if (ix % VIS_CYC == 0) {
+            update_vis_ch(rcv);
+        }
+        if (ix % SNAP_CYC == 0) {
+            snap_update(rcv);
+        }
+        if (ix % SHED_CYC == 0) {
+            update_shed(rcv, ix * SDR_CYC);
+        }
         if (ix % LOG_CYC == 0) {
             update_buff_use(rcv);
             tick_r = update_data_rate(rcv, tick_r, sum_size);
             sum_size = 0;
             out_log_time(ix * SDR_CYC);
+            out_log_dev(rcv, ix * SDR_CYC, dev_stat);
+            out_log_prof(rcv, ix * SDR_CYC);
         }
-        // read IF data
-        if (!(size = read_data(rcv, raw, ns * rcv->N))) {
+        // read IF data of SDR devices
+        int ndev = 0;
+        if (!(rcv->dev == SDR_DEV_FILE && rcv->opt.tspan > 0.0 &&
+            ix * SDR_CYC >= rcv->opt.tspan)) {
+            for ( ; ndev < rcv->ndev; ndev++) {
+                if (!(rcv->rd ? rd_read(rcv, data + ndev) : read_data(rcv,
+                    ndev, raw + size * ndev, data + ndev, size))) break;
+            }
+        }
+        if (ndev < rcv->ndev) {
+            for (int i = 0; i < ndev; i++) {
+                release_data(rcv, i, raw + size * i, data[i], size);
+            }
             sdr_sleep_msec(500);
             rcv->state = 0;
             continue;
         }
-        sum_size += size;
+        sum_size += size * ndev;
+        if (rcv->t_cyc) { // arrival time of IF data cycle
+            rcv->t_cyc[ix % rcv->max_buff] = sdr_get_clock();
+        }
         
         // write IF data buffer
-        write_buff(rcv, raw, ix);
+        int64_t tw = sdr_trace_begin();
+        write_buff(rcv, data, ix);
+        sdr_trace_end("rcv", "write_buff", ix, tw);
         
-        // write IF data log stream
-        rcv->data_sum += sdr_str_write(rcv->strs[3], raw, size) * 1e-6;
+        // write IF data log stream (IF data of the first SDR device)
+        rcv->data_sum += sdr_str_write(rcv->strs[3], (uint8_t *)data[0],
+            size) * 1e-6;
+        for (int i = 0; i < ndev; i++) {
+            release_data(rcv, i, raw + size * i, data[i], size);
+        }
         
         // update signal search channel
         update_srch_ch(rcv);
         
-        // update PVT solution
-        sdr_pvt_udsol(rcv->pvt, ix);
+        add_cpu(rcv, &rcv->cpu[0], t0);
+        
+        // update PVT solution w/o PVT thread
+        if (!rcv->pvt_state) {
+            t0 = rcv->opt.prof ? sdr_get_cputime() : 0.0;
+            int64_t tp = sdr_trace_begin();
+            if (sdr_pvt_udsol(rcv->pvt, ix)) {
+                sdr_trace_end("pvt", "pvt_udsol", 1, tp);
+            }
+            add_cpu(rcv, &rcv->cpu[1], t0);
+        }
+        sdr_trace_end("rcv", "rcv_cycle", ix, ts);
         
-        // sleep if reading file
-        if (rcv->dev == SDR_DEV_FILE) {
-            sdr_sleep_msec((int)(ix - (sdr_get_tick() - tick) * rcv->tscale));
+        // wait for channels or sleep if reading file
+        if (fast_replay(rcv)) {
+            wait_ch_sync(rcv, ix);
+        }
+        else if (rcv->dev == SDR_DEV_FILE) {
+            int wait = (int)(ix - (sdr_get_tick() - tick) * rcv->tscale);
+            if (wait < -MAX_LATE) { // IF data to be dropped by SDR device
+                rcv->nlate++;
+            }
+            sdr_sleep_msec(wait);
         }
     }
-    if (rcv->dev == SDR_DEV_USB) {
-        sdr_dev_stop((sdr_dev_t *)rcv->dp);
+    for (int i = 0; rcv->dev == SDR_DEV_USB && i < rcv->ndev; i++) {
+        sdr_dev_stop((sdr_dev_t *)rcv->dps[i]);
+    }
+    rd_stop(rcv);
+    if (fast_replay(rcv)) {
+        double t = get_buff_ix(rcv) * SDR_CYC;
+        double tt = (sdr_get_tick() - tick) * 1e-3;
+        sdr_log(3, "$LOG,%.3f,%s,%d,REPLAY TIME=%.3f SPEED=%.2f", t, "", 0,
+            tt, tt > 0.0 ? t / tt : 0.0);
+        fprintf(stderr, "replay: %.3f s IF data in %.3f s (x %.2f realtime)\n",
+            t, tt, tt > 0.0 ? t / tt : 0.0);
     }
+    snap_update(rcv);
     sdr_log(3, "$LOG,%.3f,%s,%d,STOP", get_buff_ix(rcv) * SDR_CYC, "", 0);
     sdr_free(raw);
+    sdr_scratch_release();
+    return NULL;
+}
+
+// SDR PVT thread --------------------------------------------------------------
+static void *pvt_thread(void *arg)
+{
+    sdr_rcv_t *rcv = (sdr_rcv_t *)arg;
+    
+    set_thread(rcv, 3);
+    
+    while (rcv->pvt_state) {
+        // solve PVT of closed epochs and wait for next epoch completed
+        double t0 = rcv->opt.prof ? sdr_get_cputime() : 0.0;
+        int64_t ts = sdr_trace_begin(), n = 0;
+        while (sdr_pvt_udsol(rcv->pvt, get_buff_ix(rcv))) n++;
+        if (n > 0) {
+            sdr_trace_end("pvt", "pvt_udsol", n, ts);
+        }
+        add_cpu(rcv, &rcv->cpu[1], t0);
+        sdr_pvt_wait(rcv->pvt, TH_CYC);
+    }
+    sdr_scratch_release();
     return NULL;
 }
 
+// set compressed IF data encoder to IF data log stream ------------------------
+static void raw_str_ifz(sdr_rcv_t *rcv, sdr_str_t *str)
+{
+    int ns = (rcv->fmt == SDR_FMT_INT8 || rcv->fmt == SDR_FMT_RAW8) ? 1 : 2;
+    int size = rcv->fmt == SDR_FMT_PACK ? rcv->N / 2 : ns * rcv->N;
+    int nrf = rcv->nbuff / rcv->ndev;
+    char tag[SDR_MAX_TAG];
+    
+    sdr_rcv_gen_tag(tag, sizeof(tag), "pocket_sdr", time(NULL), rcv->fmt,
+        rcv->fs, rcv->fo, rcv->IQ, nrf);
+    sdr_str_ifz(str, tag, rcv->fmt, (int)(SDR_IFZ_CHUNK / SDR_CYC) * size);
+}
+
 //------------------------------------------------------------------------------
 //  Start a SDR receiver.
 //
@@ -694,14 +2527,36 @@ int sdr_rcv_start(sdr_rcv_t *rcv, int dev, void *dp, const char **paths)
     sdr_log_open(paths[2]);
     
     for (int i = 0; i < rcv->nch; i++) {
+        rcv->th[i]->ch->shed = 0;
         ch_th_start(rcv->th[i]);
     }
+    rcv->shed = rcv->shed_hold = 0;
+    if (rcv->opt.nav_async) {
+        rcv->nav_async = sdr_nav_start();
+    }
+    wk_start(rcv);
+    up_start(rcv);
     rcv->dev = dev;
-    rcv->dp = dp;
+    rcv->dp = rcv->dps[0] = dp;
     rcv->pvt = sdr_pvt_new(rcv);
+    load_state(rcv);
+    if (rcv->opt.pvt_th) {
+        rcv->pvt_state = 1;
+        if (pthread_create(&rcv->pvt_thread, NULL, pvt_thread, rcv)) {
+            fprintf(stderr, "PVT thread create error\n");
+            rcv->pvt_state = 0;
+        }
+    }
     for (int i = 0; i < 4; i++) {
         if (i != 2 && *paths[i] && !(rcv->strs[i] = sdr_str_open(paths[i]))) {
-            fprintf(stderr, "stream open error: %s", paths[i+1]);
+            fprintf(stderr, "stream open error: %s\n", paths[i]);
+        }
+        if (i == 3 && rcv->strs[i] && rcv->opt.raw_comp) {
+            raw_str_ifz(rcv, rcv->strs[i]);
+        }
+        int size = (i < 3 ? rcv->opt.str_queue : rcv->opt.raw_queue) << 20;
+        if (rcv->strs[i] && size > 0) {
+            sdr_str_async(rcv->strs[i], size);
         }
     }
     rcv->state = 1;
@@ -722,29 +2577,121 @@ void sdr_rcv_stop(sdr_rcv_t *rcv)
     for (int i = 0; i < rcv->nch; i++) {
         ch_th_stop(rcv->th[i]);
     }
-    for (int i = 0; i < rcv->nch; i++) {
-        pthread_join(rcv->th[i]->thread, NULL);
+    wk_stop(rcv);
+    if (rcv->nav_async) {
+        sdr_nav_stop();
+        rcv->nav_async = 0;
     }
     rcv->state = 0;
     pthread_join(rcv->thread, NULL);
+    up_stop(rcv);
+    if (rcv->pvt_state) {
+        rcv->pvt_state = 0;
+        pthread_join(rcv->pvt_thread, NULL);
+    }
     for (int i = 0; i < 4; i++) {
         sdr_str_close(rcv->strs[i]);
+        rcv->strs[i] = NULL;
     }
+    save_state(rcv);
+    sdr_free(rcv->warm);
+    rcv->warm = NULL;
     sdr_pvt_free(rcv->pvt);
     sdr_log_close();
 }
 
+//------------------------------------------------------------------------------
+//  Get SDR receiver status view. The status view is a fixed layout structure
+//  owned by the receiver and updated in place by sdr_rcv_view_update(). It is
+//  intended to be wrapped once as arrays by the clients (e.g. NumPy views in
+//  Python) and read without copying and parsing the status strings.
+//
+//  args:
+//      rcv       (I)  SDR receiver
+//
+//  returns:
+//      status view (NULL: error)
+//
+sdr_rcv_view_t *sdr_rcv_view(sdr_rcv_t *rcv)
+{
+    if (!rcv) return NULL;
+    
+    pthread_mutex_lock(&rcv_view_mtx);
+    if (!rcv->view) {
+        rcv->view = (sdr_rcv_view_t *)sdr_malloc(sizeof(sdr_rcv_view_t));
+        rcv->view->ver = SDR_VIEW_VER;
+        rcv->view->size = (uint32_t)sizeof(sdr_rcv_view_t);
+    }
+    pthread_mutex_unlock(&rcv_view_mtx);
+    return rcv->view;
+}
+
+//------------------------------------------------------------------------------
+//  Update SDR receiver status view. The channel status of all channels are
+//  always updated. The sequence of the view is odd while being updated and
+//  incremented to even after the update. A reader can detect a torn snapshot
+//  by the sequence changed or odd.
+//
+//  args:
+//      rcv       (I)  SDR receiver
+//      ch        (I)  channel of correlator status and history (0: none)
+//      tspan     (I)  time span of correlator history (s)
+//      rf_ch     (I)  RF channel of PSD (0: none)
+//      tave      (I)  averaging time of PSD (s)
+//
+//  returns:
+//      sequence of view after update (0: error)
+//
+uint32_t sdr_rcv_view_update(sdr_rcv_t *rcv, int ch, double tspan, int rf_ch,
+    double tave)
+{
+    sdr_rcv_view_t *v = sdr_rcv_view(rcv);
+    
+    if (!v) return 0;
+    
+    pthread_mutex_lock(&rcv_view_mtx);
+    __atomic_fetch_add(&v->seq, 1, __ATOMIC_ACQ_REL);
+    
+    v->nch = rcv->state ? rcv->nch : 0;
+    for (int i = 0; i < v->nch; i++) {
+        sdr_ch_get_view(rcv->th[i]->ch, v->ch + i);
+    }
+    v->corr_ch = v->ncorr = v->nhist = 0;
+    if (rcv->state && ch >= 1 && ch <= rcv->nch) {
+        v->corr_ch = ch;
+        v->ncorr = sdr_ch_corr_stat(rcv->th[ch-1]->ch, v->corr_stat, v->pos,
+            v->C);
+        v->nhist = sdr_ch_corr_hist(rcv->th[ch-1]->ch, tspan, v->hist_stat,
+            v->P);
+    }
+    v->rf_ch = v->npsd = 0;
+    if (rf_ch > 0) {
+        v->npsd = sdr_rcv_rfch_psd(rcv, rf_ch, tave, SDR_N_PSD, v->psd);
+        v->rf_ch = v->npsd > 0 ? rf_ch : 0;
+    }
+    uint32_t seq = __atomic_add_fetch(&v->seq, 1, __ATOMIC_ACQ_REL);
+    pthread_mutex_unlock(&rcv_view_mtx);
+    return seq;
+}
+
 // get and set LNA gain of RF frontend -----------------------------------------
+//  The RF channels of the multiple SDR devices are numbered in the order of
+//  the devices.
 int sdr_rcv_get_gain(sdr_rcv_t *rcv, int ch)
 {
-    if (!rcv || !rcv->state || rcv->dev != SDR_DEV_USB) return -1;
-    return sdr_dev_get_gain((sdr_dev_t *)rcv->dp, ch);
+    if (!rcv || !rcv->state || rcv->dev != SDR_DEV_USB || ch < 0) return -1;
+    int nrf = rcv->nbuff / rcv->ndev, dev = rcv->ndev > 1 ? ch / nrf : 0;
+    if (dev >= rcv->ndev) return -1;
+    return sdr_dev_get_gain((sdr_dev_t *)rcv->dps[dev], ch - dev * nrf);
 }
 
 int sdr_rcv_set_gain(sdr_rcv_t *rcv, int ch, int gain)
 {
-    if (!rcv || !rcv->state || rcv->dev != SDR_DEV_USB) return -1;
-    return sdr_dev_set_gain((sdr_dev_t *)rcv->dp, ch, gain);
+    if (!rcv || !rcv->state || rcv->dev != SDR_DEV_USB || ch < 0) return -1;
+    int nrf = rcv->nbuff / rcv->ndev, dev = rcv->ndev > 1 ? ch / nrf : 0;
+    if (dev >= rcv->ndev) return -1;
+    return sdr_dev_set_gain((sdr_dev_t *)rcv->dps[dev], ch - dev * nrf,
+        gain);
 }
 
 //------------------------------------------------------------------------------
@@ -765,42 +2712,144 @@ int sdr_rcv_set_gain(sdr_rcv_t *rcv, int ch, int gain)
 sdr_rcv_t *sdr_rcv_open_dev(const char **sigs, int *prns, int n, int bus,
     int port, const char *conf_file, const char **paths)
 {
-    sdr_dev_t *dev;
-    double fs, fo[SDR_MAX_RFCH] = {0};
-    int fmt, nch, IQ[SDR_MAX_RFCH] = {0};
+    return sdr_rcv_open_ndev(sigs, prns, n, 1, &bus, &port, &conf_file, paths);
+}
+
+// close SDR devices -----------------------------------------------------------
+static void close_dev(sdr_dev_t **dev, int ndev)
+{
+    for (int i = 0; i < ndev; i++) {
+        sdr_dev_close(dev[i]);
+    }
+}
+
+//------------------------------------------------------------------------------
+//  Generate a new SDR receiver by multiple SDR devices and start receiver. The
+//  SDR devices shall share a reference clock (e.g. a common TCXO) and have the
+//  same IF data format and sampling rate. The IF data of the devices are
+//  aligned by the offsets of the start times of the devices. The IF data log
+//  stream records the IF data of the first device.
+//
+//  args:
+//      sigs      (I)  signal types as a string array {sig1, sig2, ..., sign}
+//      prns      (I)  PRN numbers as int array {prn1, prn2, ..., prnn}
+//      n         (I)  number of sigs and prns
+//      ndev      (I)  number of SDR devices (1 - SDR_MAX_NDEV)
+//      bus       (I)  USB bus numbers of SDR devices (-1:any)
+//      port      (I)  USB port numbers of SDR devices (-1:any)
+//      conf_files (I) configration files for SDR devices ("": no config)
+//      paths     (I)  output stream paths as same as sdr_rcv_start()
+//
+//  returns:
+//      SDR receiver (NULL: error)
+//
+sdr_rcv_t *sdr_rcv_open_ndev(const char **sigs, int *prns, int n, int ndev,
+    const int *bus, const int *port, const char **conf_files,
+    const char **paths)
+{
+    sdr_dev_t *dev[SDR_MAX_NDEV];
+    double fs = 0.0, fo[SDR_MAX_NRF] = {0};
+    int fmt = 0, IQ[SDR_MAX_NRF] = {0};
     
-    if (!(dev = sdr_dev_open(bus, port))) {
+    if (ndev < 1 || ndev > SDR_MAX_NDEV) {
+        fprintf(stderr, "number of SDR devices error: %d\n", ndev);
         return NULL;
     }
-    if (*conf_file) {
-        if (!sdr_conf_write(dev, conf_file, 0)) {
-            sdr_dev_close(dev);
+    for (int i = 0; i < ndev; i++) {
+        double fs_i;
+        int fmt_i;
+        
+        if (!(dev[i] = sdr_dev_open(bus[i], port[i]))) {
+            close_dev(dev, i);
             return NULL;
         }
-        sdr_sleep_msec(50);
+        if (*conf_files[i]) {
+            if (!sdr_conf_write(dev[i], conf_files[i], 0)) {
+                close_dev(dev, i + 1);
+                return NULL;
+            }
+            sdr_sleep_msec(50);
+        }
+        if (!sdr_dev_get_info(dev[i], &fmt_i, &fs_i, fo + i * SDR_MAX_RFCH,
+            IQ + i * SDR_MAX_RFCH)) {
+            close_dev(dev, i + 1);
+            return NULL;
+        }
+        if (i > 0 && (fmt_i != fmt || fs_i != fs)) {
+            fprintf(stderr, "SDR device mismatch: DEV=%d FMT=%d FS=%.0f\n",
+                i + 1, fmt_i, fs_i);
+            close_dev(dev, i + 1);
+            return NULL;
+        }
+        fmt = fmt_i;
+        fs = fs_i;
     }
-    if (!(nch = sdr_dev_get_info(dev, &fmt, &fs, fo, IQ))) {
-        sdr_dev_close(dev);
+    sdr_rcv_t *rcv = sdr_rcv_new_ndev(sigs, prns, n, ndev, fmt, fs, fo, IQ);
+    if (!rcv) {
+        close_dev(dev, ndev);
         return NULL;
     }
-    sdr_rcv_t *rcv = sdr_rcv_new(sigs, prns, n, fmt, fs, fo, IQ);
-    sdr_rcv_start(rcv, SDR_DEV_USB, (void *)dev, paths);
+    for (int i = 1; i < ndev; i++) {
+        rcv->dps[i] = dev[i];
+    }
+    sdr_rcv_start(rcv, SDR_DEV_USB, (void *)dev[0], paths);
     
     return rcv;
 }
 
-// read tag for IF data dump file ----------------------------------------------
-static void read_tag(const char *file, int *fmt, double *fs, double *fo,
-    int *IQ)
+//------------------------------------------------------------------------------
+//  Generate the tag of IF data as same as the tag file.
+//
+//  args:
+//      buff      (O)  tag of IF data (text)
+//      size      (I)  size of buffer (bytes)
+//      prog      (I)  program name
+//      time      (I)  time of IF data
+//      fmt       (I)  IF data format (SDR_FMT_???)
+//      fs        (I)  sampling rate (sps)
+//      fo        (I)  LO frequency for each RFCH (Hz)
+//      IQ        (I)  sampling type for each RFCH (1:I, 2:IQ)
+//      nch       (I)  number of RF channels
+//
+//  returns:
+//      length of tag (bytes)
+//
+int sdr_rcv_gen_tag(char *buff, int size, const char *prog, time_t time,
+    int fmt, double fs, const double *fo, const int *IQ, int nch)
 {
-    FILE *fp;
-    char path[1024+4], buff[256], *p;
+    static const char *fstr[] = {
+        "-", "INT8", "INT8X2", "RAW8", "RAW16", "RAW16I", "PACK"
+    };
+    char tstr[32];
+    int n = 0;
     
-    snprintf(path, sizeof(path), "%s.tag", file);
+    strftime(tstr, sizeof(tstr), "%Y-%m-%dT%H:%M:%SZ", gmtime(&time));
+    nch = MAX(MIN(nch, SDR_MAX_RFCH), 1);
     
-    if (!(fp = fopen(path, "r"))) return;
+    n += snprintf(buff + n, size - n, "PROG = %s\n", prog);
+    n += snprintf(buff + n, size - n, "TIME = %s\n", tstr);
+    n += snprintf(buff + n, size - n, "FMT  = %s\n", fstr[fmt]);
+    n += snprintf(buff + n, size - n, "F_S  = %.6g\n", fs * 1e-6);
+    n += snprintf(buff + n, size - n, "F_LO = ");
+    for (int j = 0; j < nch; j++) {
+        n += snprintf(buff + n, size - n, "%.6g%s", fo[j] * 1e-6,
+            j < nch - 1 ? "," : "\n");
+    }
+    n += snprintf(buff + n, size - n, "IQ   = ");
+    for (int j = 0; j < nch; j++) {
+        n += snprintf(buff + n, size - n, "%d%s", IQ[j], j < nch - 1 ? "," :
+            "\n");
+    }
+    return MIN(n, size - 1);
+}
+
+// parse tag of IF data --------------------------------------------------------
+static void parse_tag(char *tag, int *fmt, double *fs, double *fo, int *IQ)
+{
+    char *p, *q;
     
-    while (fgets(buff, sizeof(buff), fp)) {
+    for (char *buff = tag; *buff; buff = q) {
+        if ((q = strchr(buff, '\n'))) *q++ = '\0'; else q = buff + strlen(buff);
         if (!(p = strchr(buff, '='))) continue;
         if (strstr(buff, "FMT") == buff) {
             if      (!strncmp(p + 2, "INT8X2", 6)) *fmt = SDR_FMT_INT8X2;
@@ -808,6 +2857,7 @@ static void read_tag(const char *file, int *fmt, double *fs, double *fo,
             else if (!strncmp(p + 2, "RAW16I", 6)) *fmt = SDR_FMT_RAW16I;
             else if (!strncmp(p + 2, "RAW16" , 5)) *fmt = SDR_FMT_RAW16;
             else if (!strncmp(p + 2, "RAW8"  , 4)) *fmt = SDR_FMT_RAW8;
+            else if (!strncmp(p + 2, "PACK"  , 4)) *fmt = SDR_FMT_PACK;
         }
         else if (strstr(buff, "F_S") == buff) {
             if (sscanf(p + 2, "%lf", fs)) *fs *= 1e6;
@@ -822,13 +2872,44 @@ static void read_tag(const char *file, int *fmt, double *fs, double *fo,
                 IQ + 4, IQ + 5, IQ + 6, IQ + 7);
         }
     }
-    int nch = (*fmt == SDR_FMT_INT8 || *fmt == SDR_FMT_INT8X2) ? 1 :
+    int nch = (*fmt == SDR_FMT_INT8 || *fmt == SDR_FMT_INT8X2 ||
+        *fmt == SDR_FMT_PACK) ? 1 :
         (*fmt == SDR_FMT_RAW8 ? 2 : (*fmt == SDR_FMT_RAW16 ? 4 : 8));
     for (int i = nch; i < SDR_MAX_RFCH; i++) {
         fo[i] = 0.0;
         IQ[i] = 0;
     }
-    fclose(fp);
+}
+
+//------------------------------------------------------------------------------
+//  Read the tag file <file>.tag of IF data file and update the IF data format,
+//  the sampling rate, the LO frequencies and the sampling types by the tag.
+//  For a compressed IF data file, the tag in the file header is used instead
+//  of the tag file. The parameters are unchanged if the tag does not exist.
+//
+//  args:
+//      file      (I)  IF data file
+//      fmt       (IO) IF data format (SDR_FMT_???)
+//      fs        (IO) sampling rate (sps)
+//      fo        (IO) LO frequency for each RFCH (Hz)
+//      IQ        (IO) sampling type for each RFCH (1:I, 2:IQ)
+//
+//  returns:
+//      none
+//
+void sdr_rcv_read_tag(const char *file, int *fmt, double *fs, double *fo,
+    int *IQ)
+{
+    FILE *fp;
+    char path[1024+4], tag[SDR_MAX_TAG];
+    
+    if (!sdr_ifz_read_tag(file, tag)) {
+        snprintf(path, sizeof(path), "%s.tag", file);
+        if (!(fp = fopen(path, "r"))) return;
+        tag[fread(tag, 1, sizeof(tag) - 1, fp)] = '\0';
+        fclose(fp);
+    }
+    parse_tag(tag, fmt, fs, fo, IQ);
 }
 
 //------------------------------------------------------------------------------
@@ -843,7 +2924,8 @@ static void read_tag(const char *file, int *fmt, double *fs, double *fo,
 //      fo        (I)  LO frequency for each RFCH (Hz)
 //      IQ        (I)  sampling type for each RFCH (1:I, 2:IQ)
 //      toff      (I)  time offset of IF data file (s)
-//      tscale    (I)  time scale of replay IF data file
+//      tscale    (I)  time scale of replay IF data file (0: as fast as
+//                     possible without loss of IF data)
 //      file      (I)  IF data file
 //      paths     (I)  output stream paths as same as sdr_rcv_start()
 //
@@ -852,38 +2934,93 @@ static void read_tag(const char *file, int *fmt, double *fs, double *fo,
 //
 //  notes:
 //      If the tag file exists, fmt, fs, fo, IQ are obtained from the tag file.
-//
+//      A compressed IF data file is decoded by the decode threads ahead of
+//      the IF data processing.
 //
 sdr_rcv_t *sdr_rcv_open_file(const char **sigs, int *prns, int n, int fmt,
     double fs, const double *fo, const int *IQ, double toff, double tscale,
     const char *file, const char **paths)
 {
-    FILE *fp;
+    sdr_iff_t *iff;
     double fo_t[SDR_MAX_RFCH] = {0};
     int IQ_t[SDR_MAX_RFCH] = {0};
     
-    if (!(fp = fopen(file, "rb"))) {
-        fprintf(stderr, "file open error: %s\n", file);
+    if (!(iff = sdr_iff_open(file, rcv_opt.file_th))) {
         return NULL;
     }
     // read tag file
     memcpy(fo_t, fo, sizeof(double) * SDR_MAX_RFCH);
     memcpy(IQ_t, IQ, sizeof(int) * SDR_MAX_RFCH);
-    read_tag(file, &fmt, &fs, fo_t, IQ_t);
-    
-    int ns = (fmt == SDR_FMT_INT8 || fmt == SDR_FMT_RAW8) ? 1 : 2;
-    fseek(fp, (long)(toff * fs * ns), SEEK_SET);
+    sdr_rcv_read_tag(file, &fmt, &fs, fo_t, IQ_t);
     
+    double ns = (fmt == SDR_FMT_INT8 || fmt == SDR_FMT_RAW8) ? 1.0 :
+        (fmt == SDR_FMT_PACK ? 0.5 : 2.0);
+    if (!sdr_iff_seek(iff, (int64_t)(toff * fs * ns))) {
+        fprintf(stderr, "file seek error: %s toff=%.3f\n", file, toff);
+        sdr_iff_close(iff);
+        return NULL;
+    }
     sdr_rcv_t *rcv = sdr_rcv_new(sigs, prns, n, fmt, fs, fo_t, IQ_t);
+    if (!rcv) {
+        sdr_iff_close(iff);
+        return NULL;
+    }
     rcv->tscale = tscale;
-    sdr_rcv_start(rcv, SDR_DEV_FILE, (void *)fp, paths);
+    sdr_rcv_start(rcv, SDR_DEV_FILE, (void *)iff, paths);
     
     return rcv;
 }
 
 //------------------------------------------------------------------------------
-//  Stop and free SDR receiver opened by sdr_rcv_open_dev() or
-//  sdr_rcv_open_file().
+//  Generate a new SDR receiver by network IF data stream and start receiver.
+//  The IF data format, the sampling rate, the LO frequencies and the sampling
+//  types are given by the tag received from the stream. Several receivers
+//  (e.g. on different compute nodes) can subscribe to the same stream with
+//  disjoint channels.
+//
+//  args:
+//      sigs      (I)  signal types as a string array {sig1, sig2, ..., sign}
+//      prns      (I)  PRN numbers as int array {prn1, prn2, ..., prnn}
+//      n         (I)  number of sigs and prns
+//      path      (I)  network IF data stream path (see sdr_net.c)
+//      paths     (I)  output stream paths as same as sdr_rcv_start()
+//
+//  returns:
+//      SDR receiver (NULL: error)
+//
+sdr_rcv_t *sdr_rcv_open_net(const char **sigs, int *prns, int n,
+    const char *path, const char **paths)
+{
+    sdr_net_t *net;
+    char tag[SDR_MAX_TAG];
+    double fs = 0.0, fo[SDR_MAX_RFCH] = {0};
+    int fmt = 0, IQ[SDR_MAX_RFCH] = {0};
+    
+    if (!(net = sdr_net_open(path, 1, NULL, 0))) {
+        return NULL;
+    }
+    if (!sdr_net_tag(net, tag, TO_NET_TAG)) {
+        fprintf(stderr, "no tag received from net stream: %s\n", path);
+        sdr_net_close(net);
+        return NULL;
+    }
+    parse_tag(tag, &fmt, &fs, fo, IQ);
+    
+    sdr_rcv_t *rcv = fmt > 0 && fs > 0.0 ? sdr_rcv_new(sigs, prns, n, fmt, fs,
+        fo, IQ) : NULL;
+    if (!rcv) {
+        fprintf(stderr, "tag error of net stream: %s\n", path);
+        sdr_net_close(net);
+        return NULL;
+    }
+    sdr_rcv_start(rcv, SDR_DEV_NET, (void *)net, paths);
+    
+    return rcv;
+}
+
+//------------------------------------------------------------------------------
+//  Stop and free SDR receiver opened by sdr_rcv_open_dev(), sdr_rcv_open_file()
+//  or sdr_rcv_open_net().
 //
 //  args:
 //      rcv       (I)  SDR receiver
@@ -898,16 +3035,92 @@ void sdr_rcv_close(sdr_rcv_t *rcv)
     sdr_rcv_stop(rcv);
     
     if (rcv->dev == SDR_DEV_USB) {
-        sdr_dev_close((sdr_dev_t *)rcv->dp);
+        close_dev((sdr_dev_t **)rcv->dps, rcv->ndev);
+    }
+    else if (rcv->dev == SDR_DEV_NET) {
+        sdr_net_close((sdr_net_t *)rcv->dp);
     }
     else {
-        fclose((FILE *)rcv->dp);
+        sdr_iff_close((sdr_iff_t *)rcv->dp);
     }
     sdr_rcv_free(rcv);
 }
 
 //------------------------------------------------------------------------------
-//  Set SDR receiver options.
+//  Set CPU affinity and scheduling priority of SDR receiver threads. The
+//  settings are applied to the threads of the SDR receivers generated by
+//  sdr_rcv_new() after the setting. If the CPUs of the acquisition threads are
+//  set, the signal searches are run by the acquisition worker threads (one per
+//  CPU unless the option nacq set) instead of the tracking worker threads, so
+//  the tracking loops are not delayed by heavy signal searches.
+//
+//  args:
+//      thread    (I)  receiver threads
+//                       "ingest": receiver thread, unpack threads and
+//                                 reader thread
+//                       "track" : tracking worker threads
+//                       "acq"   : acquisition worker threads
+//                       "pvt"   : PVT thread
+//      cpus      (I)  CPU numbers and ranges separated by "," (e.g. "0-3,8")
+//                     ("": no affinity)
+//      pri       (I)  scheduling priority (see sdr_set_thread())
+//
+//  returns:
+//      Status (1:OK, 0:error)
+//
+int sdr_rcv_setaff(const char *thread, const char *cpus, int pri)
+{
+    for (int i = 0; rcv_aff_name[i]; i++) {
+        if (strcmp(thread, rcv_aff_name[i])) continue;
+        snprintf(rcv_opt.aff_cpus[i], sizeof(rcv_opt.aff_cpus[i]), "%s", cpus);
+        rcv_opt.aff_pri[i] = pri;
+        return 1;
+    }
+    fprintf(stderr, "sdr_rcv_setaff error thread=%s\n", thread);
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+//  Set SDR receiver options. The options are the default options copied to the
+//  SDR receivers generated by sdr_rcv_new() after setting the options, so the
+//  receivers in a process can be run with different options. The option
+//  srch_ncorr is shared by the receivers in a process. For high-rate PVT
+//  solutions, set epoch to a multiple of 20 ms (e.g. 0.02, 0.04 or 0.1) and
+//  epoch_full to the interval of full solutions (e.g. 1.0). The epoch lag is
+//  limited within half of the epoch interval. The number and the size of USB
+//  transfers (usb_nbuff and usb_size) are set automatically by the sampling
+//  rate of the device if 0. If raw_comp is set, the IF data log stream is
+//  written as a compressed IF data file (see sdr_ifz.c). If ddc is set to a
+//  decimation factor (>= 2), the narrowband signals (L1CA, L1S, L2CM, G1CA,
+//  G2CA, B1I, B2I, I5S and ISS) sharing the RF channel and the carrier
+//  frequency are tracked by the IF data decimated by a DDC. If mon is set, the
+//  PSD and the histogram of RF channels are taken from the IF data monitors fed
+//  by the snapshots of IF data (see sdr_rcv_rfch_psd()). If warm is set, the
+//  last fix, the clock drift and the Doppler frequencies of the receiver with
+//  an SDR device are saved to the receiver state file at sdr_rcv_stop() and
+//  the signals are searched in the narrow Doppler windows predicted by the
+//  state and the navigation data after the next sdr_rcv_start(). If prof is
+//  set, the CPU time of the receiver stages are accumulated (see
+//  sdr_rcv_cpu_time()) and the CPU time and the observation age of channels
+//  are profiled (see sdr_rcv_snap_prof_str()). If shed is set (%), the load is
+//  shed while the IF data buffer usage exceeds it: the signal searches and the
+//  additional correlators are stopped, the nav decoding is skipped after the
+//  TOW resolved and the tracking channels of the lowest priority are paused
+//  step by step, until the usage drops under half of shed. The priority is
+//  given by shed_pol as decimal digits of the keys from the most significant
+//  one (1: constellation in order of GECJRIS, 2: signal order in the channels
+//  of the satellite, 3: C/N0, 4: satellite used in PVT) (e.g. 431). If
+//  acq_fold is set, the signals are searched in the IF data folded to about 2
+//  samples/chip by the FFTs of the reduced size and the code offsets are
+//  refined at the full rate, to reduce the CPU time of the acquisition of long
+//  codes (e.g. E1C, L1CP and B1CP) at high sampling rates. If read_ahead is
+//  set (ms), the IF data file or the network IF data stream is read ahead by a
+//  reader thread into a queue of the IF data cycles, so the file I/O and the
+//  network latency are taken off the receiver thread. The IF data buffer size
+//  max_buff is limited to 2^30 samples per RF channel. If buff_numa is set,
+//  the IF data buffers of the RF channels are interleaved over the NUMA nodes
+//  to spread the memory bandwidth. The threads are not bound to the nodes by
+//  the option (see sdr_rcv_setaff() to place them).
 //
 //  args:
 //      opt       (I)  option string
@@ -918,22 +3131,96 @@ void sdr_rcv_close(sdr_rcv_t *rcv)
 //
 void sdr_rcv_setopt(const char *opt, double value)
 {
-    extern double sdr_epoch, sdr_lag_epoch, sdr_el_mask, sdr_sp_corr, sdr_t_acq;
-    extern double sdr_t_dll, sdr_b_dll, sdr_b_pll, sdr_b_fll_w, sdr_b_fll_n;
-    extern double sdr_max_dop, sdr_thres_cn0_l, sdr_thres_cn0_u;
-    if      (!strcmp(opt, "epoch"      )) sdr_epoch       = value;
-    else if (!strcmp(opt, "lag_epoch"  )) sdr_lag_epoch   = value;
-    else if (!strcmp(opt, "el_mask"    )) sdr_el_mask     = value;
-    else if (!strcmp(opt, "sp_corr"    )) sdr_sp_corr     = value;
-    else if (!strcmp(opt, "t_acq"      )) sdr_t_acq       = value;
-    else if (!strcmp(opt, "t_dll"      )) sdr_t_dll       = value;
-    else if (!strcmp(opt, "b_dll"      )) sdr_b_dll       = value;
-    else if (!strcmp(opt, "b_pll"      )) sdr_b_pll       = value;
-    else if (!strcmp(opt, "b_fll_w"    )) sdr_b_fll_w     = value;
-    else if (!strcmp(opt, "b_fll_n"    )) sdr_b_fll_n     = value;
-    else if (!strcmp(opt, "max_dop"    )) sdr_max_dop     = value;
-    else if (!strcmp(opt, "thres_cn0_l")) sdr_thres_cn0_l = value;
-    else if (!strcmp(opt, "thres_cn0_u")) sdr_thres_cn0_u = value;
+    extern int sdr_srch_ncorr;
+    if      (!strcmp(opt, "epoch"      )) rcv_opt.epoch       = value;
+    else if (!strcmp(opt, "lag_epoch"  )) rcv_opt.lag_epoch   = value;
+    else if (!strcmp(opt, "epoch_full" )) rcv_opt.epoch_full  = value;
+    else if (!strcmp(opt, "el_mask"    )) rcv_opt.el_mask     = value;
+    else if (!strcmp(opt, "sp_corr"    )) rcv_opt.sp_corr     = value;
+    else if (!strcmp(opt, "t_acq"      )) rcv_opt.t_acq       = value;
+    else if (!strcmp(opt, "t_dll"      )) rcv_opt.t_dll       = value;
+    else if (!strcmp(opt, "b_dll"      )) rcv_opt.b_dll       = value;
+    else if (!strcmp(opt, "b_pll"      )) rcv_opt.b_pll       = value;
+    else if (!strcmp(opt, "b_fll_w"    )) rcv_opt.b_fll_w     = value;
+    else if (!strcmp(opt, "b_fll_n"    )) rcv_opt.b_fll_n     = value;
+    else if (!strcmp(opt, "max_dop"    )) rcv_opt.max_dop     = value;
+    else if (!strcmp(opt, "thres_cn0_l")) rcv_opt.thres_cn0_l = value;
+    else if (!strcmp(opt, "thres_cn0_u")) rcv_opt.thres_cn0_u = value;
+    else if (!strcmp(opt, "acq_pack"   )) rcv_opt.acq_pack    = (int)value;
+    else if (!strcmp(opt, "acq_fold"   )) rcv_opt.acq_fold    = (int)value;
+    else if (!strcmp(opt, "nworker"    )) rcv_opt.nwk         = (int)value;
+    else if (!strcmp(opt, "unpack_th"  )) rcv_opt.unpack_th   = (int)value;
+    else if (!strcmp(opt, "tspan"      )) rcv_opt.tspan       = value;
+    else if (!strcmp(opt, "vis_ch"     )) rcv_opt.vis_ch      = (int)value;
+    else if (!strcmp(opt, "nsrch"      )) rcv_opt.nsrch       = (int)value;
+    else if (!strcmp(opt, "srch_ncorr" )) sdr_srch_ncorr      = (int)value;
+    else if (!strcmp(opt, "max_buff"   )) rcv_opt.max_buff    = (int)value;
+    else if (!strcmp(opt, "buff_huge"  )) rcv_opt.buff_huge   = (int)value;
+    else if (!strcmp(opt, "buff_numa"  )) rcv_opt.buff_numa   = (int)value;
+    else if (!strcmp(opt, "nacq"       )) rcv_opt.nacq        = (int)value;
+    else if (!strcmp(opt, "trk_nco"    )) rcv_opt.trk_nco     = (int)value;
+    else if (!strcmp(opt, "nav_async"  )) rcv_opt.nav_async   = (int)value;
+    else if (!strcmp(opt, "pvt_th"     )) rcv_opt.pvt_th      = (int)value;
+    else if (!strcmp(opt, "str_queue"  )) rcv_opt.str_queue   = (int)value;
+    else if (!strcmp(opt, "raw_queue"  )) rcv_opt.raw_queue   = (int)value;
+    else if (!strcmp(opt, "raw_comp"   )) rcv_opt.raw_comp    = (int)value;
+    else if (!strcmp(opt, "file_th"    )) rcv_opt.file_th     = (int)value;
+    else if (!strcmp(opt, "read_ahead" )) rcv_opt.read_ahead  = (int)value;
+    else if (!strcmp(opt, "usb_nbuff"  )) rcv_opt.usb_nbuff   = (int)value;
+    else if (!strcmp(opt, "usb_size"   )) rcv_opt.usb_size    = (int)value;
+    else if (!strcmp(opt, "ddc"        )) rcv_opt.ddc         = (int)value;
+    else if (!strcmp(opt, "mon"        )) rcv_opt.mon         = (int)value;
+    else if (!strcmp(opt, "warm"       )) rcv_opt.warm        = (int)value;
+    else if (!strcmp(opt, "prof"       )) rcv_opt.prof        = (int)value;
+    else if (!strcmp(opt, "shed"       )) rcv_opt.shed        = value;
+    else if (!strcmp(opt, "shed_pol"   )) rcv_opt.shed_pol    = (int)value;
     else fprintf(stderr, "sdr_rcv_setopt error opt=%s\n", opt);
 }
 
+//------------------------------------------------------------------------------
+//  Get default options of SDR receivers set by sdr_rcv_setopt() and
+//  sdr_rcv_setaff().
+//
+//  args:
+//      none
+//
+//  returns:
+//      default options
+//
+const sdr_opt_t *sdr_rcv_defopt(void)
+{
+    return &rcv_opt;
+}
+
+//------------------------------------------------------------------------------
+//  Get CPU time of SDR receiver stages accumulated with the option prof. The
+//  ingest includes the IF data input, the unpacking and the receiver control
+//  by the receiver thread. The tracking, the acquisition and the nav decoding
+//  are summed up over the channels. The PVT includes the obs update of the
+//  channels.
+//
+//  args:
+//      rcv       (I)  SDR receiver
+//      cpu       (O)  CPU time of stages {ingest, tracking, acquisition, nav
+//                     decoding, PVT} (s)
+//
+//  returns:
+//      none
+//
+void sdr_rcv_cpu_time(sdr_rcv_t *rcv, double *cpu)
+{
+    int64_t t[5] = {0};
+    
+    t[0] = __atomic_load_n(&rcv->cpu[0], __ATOMIC_RELAXED);
+    t[4] = __atomic_load_n(&rcv->cpu[1], __ATOMIC_RELAXED);
+    for (int i = 0; i < rcv->nch; i++) {
+        for (int j = 0; j < 4; j++) {
+            t[j < 3 ? j + 1 : 4] += __atomic_load_n(&rcv->th[i]->ch->cpu[j],
+                __ATOMIC_RELAXED);
+        }
+    }
+    for (int i = 0; i < 5; i++) {
+        cpu[i] = t[i] * 1e-9;
+    }
+}
+
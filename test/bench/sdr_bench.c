@@ -0,0 +1,415 @@
+//
+//  benchmark driver for GNSS SDR kernels
+//
+//  The kernels are timed by repeating them for the min measurement time and
+//  reported in ns/sample, GB/s of the input data and cycles/sample for each
+//  SIMD kernels supported by the build and the CPU (see sdr_set_simd()). The
+//  cycles are counted by TSC on x86 (reference cycles) or converted from the
+//  time by the CPU clock given by -ghz. The results are written as JSON with
+//  -json to compare kernel changes and hardware.
+//
+//  usage: sdr_bench [-fs fs[,...]] [-T T[,...]] [-nc n[,...]]
+//             [-simd name[,...]] [-k kernel[,...]] [-t msec] [-ghz ghz]
+//             [-json file]
+//
+//      -fs fs[,...]      sampling frequencies (MHz) [12,24,48]
+//      -T T[,...]        integration times (ms) [1,4,10]
+//      -nc n[,...]       numbers of correlators of sdr_corr_std() [3,9,33]
+//      -simd name[,...]  SIMD kernels [all supported]
+//      -k kernel[,...]   kernels [all]
+//      -t msec           min measurement time of a kernel (ms) [200]
+//      -ghz ghz          CPU clock for cycles/sample w/o TSC (GHz) [0: none]
+//      -json file        output JSON file
+//
+#include <math.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "pocket_sdr.h"
+
+// constants -------------------------------------------------------------------
+#define SIG_CODE    "L1CA"      // signal for code generation
+#define NDOP        21          // number of Doppler bins of sdr_search_code()
+#define NSYM_VIT    1200        // number of symbols of Viterbi decoder
+#define NSYM_LDPC   1200        // number of symbols of LDPC decoders
+#define RATE_ERR    0.02        // symbol error rate of LDPC decoders
+#define MAX_LIST    16          // max number of list options
+#define MAX_RES     4096        // max number of results
+
+// type definitions ------------------------------------------------------------
+typedef struct {                // benchmark data type
+    double fs, T;               // sampling frequency (Hz) and time (s)
+    int N, nc;                  // number of samples and correlators
+    sdr_buff_t *buff, *buff_dec; // IF data buffer and buffer with decode table
+    uint8_t *raw;               // raw IF data (RAW16)
+    int8_t *code;               // code
+    int len_code;               // code length
+    sdr_cpx16_t *code_res;      // resampled code (N)
+    sdr_cpx_t *code_fft;        // code DFT (N)
+    sdr_cpx_t *code_fft2;       // zero-padded code DFT (2N)
+    sdr_cpx16_t *IQ;            // carrier-mixed data (N)
+    sdr_cpx_t *corr;            // correlations (N)
+    float *fds, *P;             // Doppler bins and correlation powers
+    int pos[64];                // correlator positions
+    uint8_t *syms, *syms_vit, *dec; // symbols and decoded data
+} bench_t;
+
+typedef struct {                // kernel type
+    const char *name;           // kernel name
+    int type;                   // type (0:IF data,1:correlators,2:decoder)
+    double bytes;               // bytes of input data per sample
+    void (*func)(bench_t *b);   // kernel function
+    int (*nsamp)(const bench_t *b); // number of samples per call
+} kern_t;
+
+typedef struct {                // benchmark result type
+    const char *kern, *simd;    // kernel and SIMD kernels
+    double fs;                  // sampling frequency (Hz) (0: n/a)
+    int N, nc;                  // number of samples and correlators (0: n/a)
+    double ns, gbs, cyc;        // ns/sample, GB/s, cycles/sample (0: n/a)
+} result_t;
+
+// kernel functions ------------------------------------------------------------
+static void k_mix_carr(bench_t *b)
+{
+    sdr_mix_carr(b->buff, 0, b->N, b->fs, 1e3, 0.3, b->IQ);
+}
+
+static void k_corr_std(bench_t *b)
+{
+    sdr_corr_std(b->buff, 0, b->N, b->fs, 1e3, 0.3, b->code_res, b->pos,
+        b->nc, b->corr);
+}
+
+static void k_corr_fft(bench_t *b)
+{
+    sdr_corr_fft(b->buff, 0, b->N, b->fs, 1e3, 0.3, b->code_fft, b->corr);
+}
+
+static void k_search_code(bench_t *b)
+{
+    sdr_search_code(b->code_fft2, b->T, b->buff, 0, 2 * b->N, b->fs, 0.0,
+        b->fds, NDOP, b->P);
+}
+
+static void k_unpack_raw8(bench_t *b)
+{
+    sdr_buff_write_raw(b->buff_dec, 0, b->raw, b->N, SDR_FMT_RAW8, 0);
+}
+
+static void k_unpack_raw16(bench_t *b)
+{
+    sdr_buff_write_raw(b->buff_dec, 0, b->raw, b->N, SDR_FMT_RAW16, 0);
+}
+
+static void k_res_code(bench_t *b)
+{
+    sdr_res_code(b->code, b->len_code, b->T, 1e-4, b->fs, b->N, 0,
+        b->code_res);
+}
+
+static void k_viterbi(bench_t *b)
+{
+    sdr_decode_conv(b->syms_vit, NSYM_VIT, b->dec);
+}
+
+static void k_ldpc(bench_t *b)
+{
+    sdr_decode_LDPC("CNV2_SF2", b->syms, NSYM_LDPC, b->dec);
+}
+
+static void k_nb_ldpc(bench_t *b)
+{
+    sdr_decode_LDPC("BCNV1_SF2", b->syms, NSYM_LDPC, b->dec);
+}
+
+// number of samples per call --------------------------------------------------
+static int n_samp(const bench_t *b)
+{
+    return b->N;
+}
+
+static int n_samp2(const bench_t *b)
+{
+    return 2 * b->N;
+}
+
+static int n_vit(const bench_t *b)
+{
+    return NSYM_VIT;
+}
+
+static int n_ldpc(const bench_t *b)
+{
+    return NSYM_LDPC;
+}
+
+// kernels ---------------------------------------------------------------------
+static const kern_t kerns[] = {
+    {"mix_carr"    , 0, 1.0, k_mix_carr    , n_samp },
+    {"corr_std"    , 1, 1.0, k_corr_std    , n_samp },
+    {"corr_fft"    , 0, 1.0, k_corr_fft    , n_samp },
+    {"search_code" , 0, 1.0, k_search_code , n_samp2},
+    {"unpack_raw8" , 0, 1.0, k_unpack_raw8 , n_samp },
+    {"unpack_raw16", 0, 2.0, k_unpack_raw16, n_samp },
+    {"res_code"    , 0, 2.0, k_res_code    , n_samp },
+    {"viterbi"     , 2, 1.0, k_viterbi     , n_vit  },
+    {"ldpc"        , 2, 1.0, k_ldpc        , n_ldpc },
+    {"nb_ldpc"     , 2, 1.0, k_nb_ldpc     , n_ldpc },
+    {0}
+};
+
+// SIMD kernels ----------------------------------------------------------------
+static const char *simds[] = {
+    "none", "neon", "sve2", "avx2", "avx512", "avx512vnni", NULL
+};
+
+// global variables ------------------------------------------------------------
+static result_t res[MAX_RES];   // benchmark results
+static int nres = 0;            // number of benchmark results
+
+// read cycle counter ----------------------------------------------------------
+static uint64_t read_cyc(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// parse comma-separated list --------------------------------------------------
+static int parse_list(char *str, const char **list)
+{
+    int n = 0;
+    
+    for (char *p = strtok(str, ","); p && n < MAX_LIST; p = strtok(NULL, ",")) {
+        list[n++] = p;
+    }
+    list[n] = NULL;
+    return n;
+}
+
+// test item in list -----------------------------------------------------------
+static int in_list(const char *item, const char **list)
+{
+    if (!list[0]) return 1;
+    for (int i = 0; list[i]; i++) {
+        if (!strcmp(item, list[i])) return 1;
+    }
+    return 0;
+}
+
+// generate random IF data buffer ----------------------------------------------
+static sdr_buff_t *gen_data(int N)
+{
+    static const int8_t val[] = {-3, -1, 1, 3};
+    
+    sdr_buff_t *buff = sdr_buff_new(N, 2);
+    
+    for (int i = 0; i < N; i++) {
+        buff->data[i] = SDR_CPX8(val[rand() % 4], val[rand() % 4]);
+    }
+    return buff;
+}
+
+// new benchmark data ----------------------------------------------------------
+static bench_t *bench_new(double fs, double T)
+{
+    bench_t *b = (bench_t *)sdr_malloc(sizeof(bench_t));
+    sdr_cpx8_t dec[16];
+    
+    b->fs = fs;
+    b->T = T;
+    b->N = (int)(fs * T);
+    b->buff = gen_data(2 * b->N);
+    for (int i = 0; i < 16; i++) {
+        dec[i] = SDR_CPX8((i & 1) ? 3 : 1, (i & 4) ? -1 : 1);
+    }
+    b->buff_dec = sdr_buff_new_mem(b->N, 2, dec, 0, -1);
+    b->raw = (uint8_t *)sdr_malloc(2 * b->N);
+    for (int i = 0; i < 2 * b->N; i++) {
+        b->raw[i] = (uint8_t)rand();
+    }
+    int8_t *code = sdr_gen_code(SIG_CODE, 1, &b->len_code);
+    int n = (int)(T / sdr_code_cyc(SIG_CODE) + 0.5);
+    b->code = (int8_t *)sdr_malloc(b->len_code * n);
+    for (int i = 0; i < n; i++) { // repeat code cycles for integration time
+        memcpy(b->code + b->len_code * i, code, b->len_code);
+    }
+    b->len_code *= n;
+    b->code_res = (sdr_cpx16_t *)sdr_malloc(sizeof(sdr_cpx16_t) * b->N);
+    sdr_res_code(b->code, b->len_code, T, 0.0, fs, b->N, 0, b->code_res);
+    b->code_fft = sdr_cpx_malloc(b->N);
+    sdr_gen_code_fft(b->code, b->len_code, T, 0.0, fs, b->N, 0, b->code_fft);
+    b->code_fft2 = sdr_cpx_malloc(2 * b->N);
+    sdr_gen_code_fft(b->code, b->len_code, T, 0.0, fs, b->N, b->N,
+        b->code_fft2);
+    b->IQ = (sdr_cpx16_t *)sdr_malloc(sizeof(sdr_cpx16_t) * b->N);
+    b->corr = sdr_cpx_malloc(b->N);
+    b->fds = (float *)sdr_malloc(sizeof(float) * NDOP);
+    for (int i = 0; i < NDOP; i++) {
+        b->fds[i] = (float)((i - NDOP / 2) * 0.5 / T);
+    }
+    b->P = (float *)sdr_malloc(sizeof(float) * 2 * b->N * NDOP);
+    b->syms = (uint8_t *)sdr_malloc(NSYM_LDPC);
+    for (int i = 0; i < NSYM_LDPC; i++) { // zero codeword with errors
+        b->syms[i] = rand() < RATE_ERR * RAND_MAX ? 1 : 0;
+    }
+    b->syms_vit = (uint8_t *)sdr_malloc(NSYM_VIT);
+    for (int i = 0; i < NSYM_VIT; i++) {
+        b->syms_vit[i] = (uint8_t)rand();
+    }
+    b->dec = (uint8_t *)sdr_malloc(NSYM_LDPC);
+    return b;
+}
+
+// free benchmark data ---------------------------------------------------------
+static void bench_free(bench_t *b)
+{
+    sdr_buff_free(b->buff);
+    sdr_buff_free(b->buff_dec);
+    sdr_free(b->raw);
+    sdr_free(b->code);
+    sdr_free(b->code_res);
+    sdr_cpx_free(b->code_fft);
+    sdr_cpx_free(b->code_fft2);
+    sdr_free(b->IQ);
+    sdr_cpx_free(b->corr);
+    sdr_free(b->fds);
+    sdr_free(b->P);
+    sdr_free(b->syms);
+    sdr_free(b->syms_vit);
+    sdr_free(b->dec);
+    sdr_free(b);
+}
+
+// benchmark a kernel ----------------------------------------------------------
+static void bench_kern(const kern_t *k, bench_t *b, const char *simd, int tmin,
+    double ghz)
+{
+    int n = 0;
+    
+    if (nres >= MAX_RES) return;
+    
+    k->func(b); // warm-up
+    uint32_t tick = sdr_get_tick(), t;
+    uint64_t cyc = read_cyc();
+    do {
+        k->func(b);
+        n++;
+    } while ((t = sdr_get_tick() - tick) < (uint32_t)tmin || t == 0);
+    cyc = read_cyc() - cyc;
+    
+    double nsamp = (double)n * k->nsamp(b);
+    result_t *r = res + nres++;
+    r->kern = k->name;
+    r->simd = simd;
+    r->fs = k->type == 2 ? 0.0 : b->fs;
+    r->N = k->nsamp(b);
+    r->nc = k->type == 1 ? b->nc : 0;
+    r->ns = t * 1e6 / nsamp;
+    r->gbs = k->bytes / r->ns;
+    r->cyc = ghz > 0.0 ? r->ns * ghz : cyc / nsamp;
+    printf("%-12s %-10s %7.1f %8d %4d %10.3f %8.3f %9.2f\n", r->kern, r->simd,
+        r->fs * 1e-6, r->N, r->nc, r->ns, r->gbs, r->cyc);
+    fflush(stdout);
+}
+
+// output results as JSON ------------------------------------------------------
+static void out_json(const char *file)
+{
+    FILE *fp;
+    
+    if (!(fp = fopen(file, "w"))) {
+        fprintf(stderr, "file open error %s\n", file);
+        return;
+    }
+    fprintf(fp, "{\"mix\": \"%s\", \"results\": [\n", sdr_get_mix());
+    for (int i = 0; i < nres; i++) {
+        result_t *r = res + i;
+        fprintf(fp, "  {\"kernel\": \"%s\", \"simd\": \"%s\", \"fs\": %.0f, "
+            "\"N\": %d, \"ncorr\": %d, \"ns_sample\": %.4f, \"gb_s\": %.4f, "
+            "\"cyc_sample\": %.3f}%s\n", r->kern, r->simd, r->fs, r->N, r->nc,
+            r->ns, r->gbs, r->cyc, i < nres - 1 ? "," : "");
+    }
+    fprintf(fp, "]}\n");
+    fclose(fp);
+}
+
+// main ------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    const char *list_simd[MAX_LIST+1] = {0}, *list_kern[MAX_LIST+1] = {0};
+    const char *json = "";
+    int fs[MAX_LIST] = {12, 24, 48}, T[MAX_LIST] = {1, 4, 10};
+    int nc[MAX_LIST] = {3, 9, 33}, nfs = 3, nT = 3, nnc = 3, tmin = 200;
+    double ghz = 0.0;
+    
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-fs") && i + 1 < argc) {
+            nfs = sdr_parse_nums(argv[++i], fs);
+        }
+        else if (!strcmp(argv[i], "-T") && i + 1 < argc) {
+            nT = sdr_parse_nums(argv[++i], T);
+        }
+        else if (!strcmp(argv[i], "-nc") && i + 1 < argc) {
+            nnc = sdr_parse_nums(argv[++i], nc);
+        }
+        else if (!strcmp(argv[i], "-simd") && i + 1 < argc) {
+            parse_list(argv[++i], list_simd);
+        }
+        else if (!strcmp(argv[i], "-k") && i + 1 < argc) {
+            parse_list(argv[++i], list_kern);
+        }
+        else if (!strcmp(argv[i], "-t") && i + 1 < argc) {
+            tmin = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-ghz") && i + 1 < argc) {
+            ghz = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-json") && i + 1 < argc) {
+            json = argv[++i];
+        }
+        else {
+            fprintf(stderr, "usage: sdr_bench [-fs fs[,...]] [-T T[,...]] "
+                "[-nc n[,...]] [-simd name[,...]] [-k kernel[,...]] [-t msec] "
+                "[-ghz ghz] [-json file]\n");
+            return -1;
+        }
+    }
+    sdr_func_init("../../python/fftw_wisdom.txt");
+    
+    printf("%-12s %-10s %7s %8s %4s %10s %8s %9s\n", "KERNEL", "SIMD",
+        "FS(MHz)", "N", "NC", "NS/SAMPLE", "GB/S", "CYC/SAMP");
+    
+    for (int i = 0; simds[i]; i++) {
+        if (!in_list(simds[i], list_simd) || !sdr_set_simd(simds[i])) continue;
+    
+        for (int j = 0; j < nfs; j++) {
+            for (int m = 0; m < nT; m++) {
+                bench_t *b = bench_new(fs[j] * 1e6, T[m] * 1e-3);
+    
+                for (int k = 0; kerns[k].name; k++) {
+                    const kern_t *kern = kerns + k;
+                    if (!in_list(kern->name, list_kern)) continue;
+                    if (kern->type == 2 && (j > 0 || m > 0)) continue;
+                    if (kern->type != 1) {
+                        bench_kern(kern, b, simds[i], tmin, ghz);
+                        continue;
+                    }
+                    for (int n = 0; n < nnc; n++) {
+                        b->nc = nc[n] < 64 ? nc[n] : 63;
+                        for (int p = 0; p < b->nc; p++) {
+                            b->pos[p] = p - b->nc / 2;
+                        }
+                        bench_kern(kern, b, simds[i], tmin, ghz);
+                    }
+                }
+                bench_free(b);
+            }
+        }
+    }
+    if (*json) out_json(json);
+    return 0;
+}
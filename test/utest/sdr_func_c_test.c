@@ -6,6 +6,7 @@
 
 #define CSCALE  10.0f
 #define SQR(x)  ((x) * (x))
+#define MAX(x, y) ((x) > (y) ? (x) : (y))
 
 // generate data ---------------------------------------------------------------
 static sdr_buff_t *gen_data(int N)
@@ -186,6 +187,32 @@ static void test_03(void)
                 //exit(-1);
             }
         }
+        // code NCO correlator (same code as resampled code except chip edges)
+        sdr_corr_nco(buff, ix[i], N[i], fs[i], fc[i], phi[i], code, len_code,
+            4e-3, 1.345, pos, 4, C);
+        for (int j = 0; j < 4; j++) {
+            if (fabs(C[j][0] - C_ref[j][0]) > 0.01 || fabs(C[j][1] - C_ref[j][1]) > 0.01) {
+                printf("sdr_corr_nco() error C[%d]=%9.6f/%9.6f : %9.6f/%9.6f\n", j,
+                    C[j][0], C[j][1], C_ref[j][0], C_ref[j][1]);
+                exit(-1);
+            }
+        }
+        // code NCO correlator with negative fractional code offset (wrapped
+        // to the same code phase as the offset shifted by a code cycle)
+        double coff = -0.37 / fs[i];
+        sdr_res_code(code, len_code, 4e-3, coff + 4e-3, fs[i], N[i], 0,
+            code_res);
+        sdr_corr_std(buff, ix[i], N[i], fs[i], fc[i], phi[i], code_res, pos, 4,
+            C_ref);
+        sdr_corr_nco(buff, ix[i], N[i], fs[i], fc[i], phi[i], code, len_code,
+            4e-3, coff, pos, 4, C);
+        for (int j = 0; j < 4; j++) {
+            if (fabs(C[j][0] - C_ref[j][0]) > 0.01 || fabs(C[j][1] - C_ref[j][1]) > 0.01) {
+                printf("sdr_corr_nco() error C[%d]=%9.6f/%9.6f : %9.6f/%9.6f\n", j,
+                    C[j][0], C[j][1], C_ref[j][0], C_ref[j][1]);
+                exit(-1);
+            }
+        }
         sdr_buff_free(buff);
         sdr_free(code_res);
         
@@ -197,20 +224,241 @@ static void test_03(void)
 // test sdr_corr_fft() ---------------------------------------------------------
 static void test_04(void)
 {
+    int N = 4000, len_code;
+    double fs = 1e6, fc = 1234.5, phi[] = {0.123, -0.456, 7.89};
+    int8_t *code = sdr_gen_code("L6D", 194, &len_code);
+    sdr_cpx_t *code_fft = sdr_cpx_malloc(N);
+    sdr_cpx_t *C = sdr_cpx_malloc(N), *C_ref = sdr_cpx_malloc(N);
+    sdr_gen_code_fft(code, len_code, 4e-3, 0.0, fs, N, 0, code_fft);
+    sdr_buff_t *buff = gen_data(N * 2);
+    
+    // shared data spectrum with carrier phase difference
+    for (int i = 0; i < 3; i++) {
+        sdr_corr_fft(buff, 123, N, fs, fc, phi[i], code_fft, C_ref);
+        sdr_corr_fft_share(buff, 123, N, fs, fc, phi[i], 1.0, code_fft, C);
+        double err = 0.0, P = 0.0;
+        for (int j = 0; j < N; j++) {
+            err = MAX(err, fabs(C[j][0] - C_ref[j][0]));
+            err = MAX(err, fabs(C[j][1] - C_ref[j][1]));
+            P = MAX(P, sdr_cpx_abs(C_ref[j]));
+        }
+        if (err > 0.05 * P) {
+            printf("sdr_corr_fft_share() error phi=%.3f err=%.4f P=%.4f\n",
+                phi[i], err, P);
+            exit(-1);
+        }
+        printf("test_04: sdr_corr_fft_share() phi=%6.3f OK\n", phi[i]);
+    }
+    sdr_buff_free(buff);
+    sdr_cpx_free(code_fft);
+    sdr_cpx_free(C);
+    sdr_cpx_free(C_ref);
     printf("test_04: OK\n");
 }
 
-// test performance: sdr_mix_carr(), sdr_corr_std(), sdr_corr_fft() ------------
+// test SIMD kernels -----------------------------------------------------------
 static void test_05(void)
+{
+    static const char *simd[] = {
+        "avx512vnni", "avx512", "avx2", "sve2", "neon", ""
+    };
+    int N = 24000, pos[SDR_N_CORR] = {0, -3, 3, -80};
+    double fs = 24e6, fc = -4999.9, phi = 0.234;
+    sdr_cpx16_t IQ[N], IQ_ref[N];
+    sdr_cpx_t *a = sdr_cpx_malloc(N), *b = sdr_cpx_malloc(N);
+    sdr_cpx_t *c = sdr_cpx_malloc(N), *c_ref = sdr_cpx_malloc(N);
+    sdr_cpx_t C[SDR_N_CORR], C_ref[SDR_N_CORR];
+    int len_code;
+    
+    for (int i = 4; i < SDR_N_CORR; i++) { // additional correlators
+        pos[i] = i - 4 - (SDR_N_CORR - 5) / 2;
+    }
+    
+    int8_t *code = sdr_gen_code("L6D", 194, &len_code);
+    sdr_cpx16_t *code_res = (sdr_cpx16_t *)sdr_malloc(sizeof(sdr_cpx16_t) * N);
+    sdr_res_code(code, len_code, 4e-3, 1.345, fs, N, 0, code_res);
+    sdr_buff_t *buff = gen_data(N * 2);
+    for (int i = 0; i < N; i++) {
+        a[i][0] = (rand() % 1000) / 100.0f;
+        a[i][1] = (rand() % 1000) / 100.0f;
+        b[i][0] = (rand() % 1000) / 100.0f;
+        b[i][1] = (rand() % 1000) / 100.0f;
+    }
+    const char *simd_sel = sdr_get_simd();
+    
+    sdr_set_simd("none");
+    sdr_cpx_mul(a, b, N, 0.5f, c_ref);
+    sdr_mix_carr(buff, 12345, N, fs, fc, phi, IQ_ref);
+    sdr_corr_std(buff, 12345, N, fs, fc, phi, code_res, pos, SDR_N_CORR, C_ref);
+    
+    for (int i = 0; *simd[i]; i++) {
+        if (!sdr_set_simd(simd[i])) continue;
+        sdr_cpx_mul(a, b, N, 0.5f, c);
+        sdr_mix_carr(buff, 12345, N, fs, fc, phi, IQ);
+        sdr_corr_std(buff, 12345, N, fs, fc, phi, code_res, pos, SDR_N_CORR, C);
+        
+        for (int j = 0; j < N; j++) {
+            if (SQR(c[j][0] - c_ref[j][0]) + SQR(c[j][1] - c_ref[j][1]) > 1e-6) {
+                printf("sdr_cpx_mul() error %s c[%d]=%.3f/%.3f : %.3f/%.3f\n",
+                    simd[i], j, c[j][0], c[j][1], c_ref[j][0], c_ref[j][1]);
+                exit(-1);
+            }
+            if (IQ[j].I != IQ_ref[j].I || IQ[j].Q != IQ_ref[j].Q) {
+                printf("sdr_mix_carr() error %s IQ[%d]=%d/%d : %d/%d\n",
+                    simd[i], j, IQ[j].I, IQ[j].Q, IQ_ref[j].I, IQ_ref[j].Q);
+                exit(-1);
+            }
+        }
+        for (int j = 0; j < SDR_N_CORR; j++) {
+            if (fabs(C[j][0] - C_ref[j][0]) > 1e-4 ||
+                fabs(C[j][1] - C_ref[j][1]) > 1e-4) {
+                printf("sdr_corr_std() error %s C[%d]=%9.6f/%9.6f : %9.6f/%9.6f\n",
+                    simd[i], j, C[j][0], C[j][1], C_ref[j][0], C_ref[j][1]);
+                exit(-1);
+            }
+        }
+        printf("test_05: SIMD kernels %-10s OK\n", simd[i]);
+    }
+    // NCO carrier mixing (within 1 LSB of reference mixing by double)
+    sdr_set_mix("nco");
+    for (int i = 0; i < 6; i++) {
+        const char *name = *simd[i] ? simd[i] : "none";
+        if (!sdr_set_simd(name)) continue;
+        sdr_mix_carr(buff, 12345, N, fs, fc, phi, IQ);
+        
+        for (int j = 0; j < N; j++) {
+            uint8_t d = buff->data[12345 + j];
+            double I = SDR_CPX8_I(d), Q = SDR_CPX8_Q(d);
+            double carr = -2.0 * PI * (phi + fc / fs * j);
+            double I_ref = (I * cos(carr) - Q * sin(carr)) / SDR_CSCALE;
+            double Q_ref = (I * sin(carr) + Q * cos(carr)) / SDR_CSCALE;
+            if (fabs(IQ[j].I - I_ref) > 1.0 || fabs(IQ[j].Q - Q_ref) > 1.0) {
+                printf("sdr_mix_carr() NCO error %s IQ[%d]=%d/%d : %.2f/%.2f\n",
+                    name, j, IQ[j].I, IQ[j].Q, I_ref, Q_ref);
+                exit(-1);
+            }
+        }
+        printf("test_05: NCO mixing   %-10s OK\n", name);
+    }
+    sdr_set_mix("lut");
+    
+    // packed IF data buffer (across IF buffer boundary)
+    static const int8_t val[] = {-3, -1, 1, 3};
+    sdr_cpx8_t dec[16];
+    for (int i = 0; i < 16; i++) {
+        dec[i] = SDR_CPX8(val[i & 0x3], val[i >> 2]);
+    }
+    sdr_buff_t *buff_pk = sdr_buff_new_pack(N * 2, 2, dec);
+    sdr_buff_t *buff_up = sdr_buff_new(N * 2, 2);
+    for (int i = 0; i < N * 2; i++) {
+        int k = rand() % 16;
+        buff_pk->data[i / 2] |= (uint8_t)(k << (i % 2 * 4));
+        buff_up->data[i] = dec[k];
+    }
+    for (int i = 0; i < 6; i++) {
+        const char *name = *simd[i] ? simd[i] : "none";
+        if (!sdr_set_simd(name)) continue;
+        sdr_mix_carr(buff_up, N * 2 - 1001, N, fs, fc, phi, IQ_ref);
+        sdr_mix_carr(buff_pk, N * 2 - 1001, N, fs, fc, phi, IQ);
+        sdr_corr_std(buff_up, N * 2 - 1001, N, fs, fc, phi, code_res, pos, 4,
+            C_ref);
+        sdr_corr_std(buff_pk, N * 2 - 1001, N, fs, fc, phi, code_res, pos, 4, C);
+        
+        for (int j = 0; j < N; j++) {
+            if (IQ[j].I != IQ_ref[j].I || IQ[j].Q != IQ_ref[j].Q) {
+                printf("sdr_mix_carr() packed error %s IQ[%d]=%d/%d : %d/%d\n",
+                    name, j, IQ[j].I, IQ[j].Q, IQ_ref[j].I, IQ_ref[j].Q);
+                exit(-1);
+            }
+        }
+        for (int j = 0; j < 4; j++) {
+            if (C[j][0] != C_ref[j][0] || C[j][1] != C_ref[j][1]) {
+                printf("sdr_corr_std() packed error %s C[%d]=%9.6f/%9.6f : %9.6f/%9.6f\n",
+                    name, j, C[j][0], C[j][1], C_ref[j][0], C_ref[j][1]);
+                exit(-1);
+            }
+        }
+        printf("test_05: packed data  %-10s OK\n", name);
+    }
+    sdr_buff_free(buff_pk);
+    sdr_buff_free(buff_up);
+    
+    // raw IF data to IF data buffer (RAW8, RAW16, RAW16I)
+    static const int fmts[] = {SDR_FMT_RAW8, SDR_FMT_RAW16, SDR_FMT_RAW16I};
+    static const int nchs[] = {2, 4, 8};
+    uint8_t *raw = (uint8_t *)sdr_malloc(N * 2);
+    for (int i = 0; i < N * 2; i++) {
+        raw[i] = (uint8_t)rand();
+    }
+    for (int i = 0; i < 16; i++) {
+        dec[i] = SDR_CPX8(i, 0);
+    }
+    buff_pk = sdr_buff_new_pack(N, 2, dec);
+    buff_up = sdr_buff_new(N, 2);
+    memcpy(buff_up->dec, dec, sizeof(dec));
+    for (int i = 0; i < 6; i++) {
+        const char *name = *simd[i] ? simd[i] : "none";
+        if (!sdr_set_simd(name)) continue;
+        for (int j = 0; j < 3; j++) {
+            for (int ch = 0; ch < nchs[j]; ch++) {
+                int ns = fmts[j] == SDR_FMT_RAW8 ? 1 : 2, n = N / 2 - 1;
+                sdr_buff_write_raw(buff_pk, 2, raw, n, fmts[j], ch);
+                sdr_buff_write_raw(buff_up, 1, raw, n, fmts[j], ch);
+                for (int k = 0; k < n; k++) {
+                    uint8_t b = raw[k * ns + (fmts[j] == SDR_FMT_RAW8 ? 0 :
+                        (fmts[j] == SDR_FMT_RAW16 ? ch / 2 : ch / 4))];
+                    int ref = fmts[j] == SDR_FMT_RAW16I ?
+                        (b >> (ch % 4 * 2)) & 0x3 : (b >> (ch % 2 * 4)) & 0xF;
+                    int pk = (buff_pk->data[1 + k / 2] >> (k % 2 * 4)) & 0xF;
+                    if (pk != ref || buff_up->data[1 + k] != dec[ref]) {
+                        printf("sdr_buff_write_raw() error %s fmt=%d ch=%d "
+                            "k=%d: %d/%d : %d\n", name, fmts[j], ch, k, pk,
+                            buff_up->data[1 + k], ref);
+                        exit(-1);
+                    }
+                }
+            }
+        }
+        // packed sample codes (PACK) to IF data buffer
+        uint8_t *pk = (uint8_t *)sdr_malloc(N / 2);
+        sdr_pack_raw(raw, N, SDR_FMT_RAW16, 1, pk);
+        sdr_buff_write_raw(buff_up, 0, pk, N, SDR_FMT_PACK, 0);
+        for (int k = 0; k < N; k++) {
+            int ref = (raw[k * 2] >> 4) & 0xF;
+            if (buff_up->data[k] != dec[ref]) {
+                printf("sdr_buff_write_raw() error %s fmt=%d k=%d: %d : %d\n",
+                    name, SDR_FMT_PACK, k, buff_up->data[k], ref);
+                exit(-1);
+            }
+        }
+        sdr_free(pk);
+        printf("test_05: raw data     %-10s OK\n", name);
+    }
+    sdr_buff_free(buff_pk);
+    sdr_buff_free(buff_up);
+    sdr_free(raw);
+    sdr_set_simd(simd_sel);
+    
+    sdr_cpx_free(a);
+    sdr_cpx_free(b);
+    sdr_cpx_free(c);
+    sdr_cpx_free(c_ref);
+    sdr_free(code_res);
+    sdr_buff_free(buff);
+    printf("test_05: OK\n");
+}
+
+// test performance: sdr_mix_carr(), sdr_corr_std(), sdr_corr_fft() ------------
+static void test_06(void)
 {
     int n = 10000;
     double fs = 12e6, fc = 13500.0, coff = 1.345, phi = 3.456;
     int pos[] = {0, -3, 3, -80};
     int N[] = {12000, 16000, 24000, 32000, 32768, 48000, 65536, 96000, 0};
     
-    printf("test_05: performance\n");
+    printf("test_06: performance\n");
     
-    printf("%6s %9s%9s%6s (ms)\n", "", "", "C+AVX2+FFTW3", "");
+    printf("%6s %9s%9s%6s (ms)\n", "", "C+", sdr_get_simd(), "+FFTW3");
     printf("%6s  %8s %8s %8s\n", "", "mix_carr", "corr_std", "corr_fft");
     
     for (int i = 0; N[i]; i++) {
@@ -255,7 +503,526 @@ static void test_05(void)
         sdr_cpx_free(C1);
         sdr_buff_free(buff);
     }
-    printf("test_05: OK\n");
+    printf("test_06: OK\n");
+}
+
+// output compressed IF data to file -------------------------------------------
+static int write_file(void *arg, const uint8_t *data, int size)
+{
+    return (int)fwrite(data, 1, size, (FILE *)arg);
+}
+
+// test sdr_read_data() of compressed IF data file -----------------------------
+static void test_07(void)
+{
+    static const int8_t val[] = {-3, -1, 1, 3};
+    const char *file = "test_07.ifz";
+    int N = 250000, off = 15625;
+    double fs = 1e6;
+    int8_t *raw = (int8_t *)sdr_malloc(N * 2);
+    
+    for (int i = 0; i < N * 2; i++) {
+        raw[i] = val[rand() % 4];
+    }
+    FILE *fp = fopen(file, "wb");
+    sdr_ifz_t *z = sdr_ifz_new("FMT  = INT8X2\n", SDR_FMT_INT8X2, 20000,
+        write_file, fp);
+    for (int i = 0; i < N * 2; i += 3000) {
+        sdr_ifz_write(z, (uint8_t *)raw + i, i + 3000 < N * 2 ? 3000 :
+            N * 2 - i);
+    }
+    sdr_ifz_free(z);
+    int size = (int)ftell(fp);
+    fclose(fp);
+    
+    sdr_buff_t *buff = sdr_read_data(file, fs, 2, 0.0, off / fs);
+    if (!buff || buff->N != N - off) {
+        printf("sdr_read_data() error N=%d\n", buff ? buff->N : 0);
+        exit(-1);
+    }
+    for (int i = 0; i < buff->N; i++) {
+        sdr_cpx8_t ref = SDR_CPX8(raw[(off+i)*2], raw[(off+i)*2+1]);
+        if (buff->data[i] != ref) {
+            printf("sdr_read_data() error i=%d: %d : %d\n", i, buff->data[i],
+                ref);
+            exit(-1);
+        }
+    }
+    sdr_buff_free(buff);
+    
+    // corrupted payload size of chunk 2 and sequence number of index entry 3
+    // (chunk 2 lost and index rebuilt by scanning chunks)
+    fp = fopen(file, "rb");
+    uint8_t *bin = (uint8_t *)sdr_malloc(size);
+    size = (int)fread(bin, 1, size, fp);
+    fclose(fp);
+    for (int k = 0; k < 2; k++) {
+        uint8_t *p = bin + size;
+        if (k == 0) {
+            for (int i = 0, n = 0; i < size - 4 && p == bin + size; i++) {
+                if (!memcmp(bin + i, "IFZC", 4) && ++n == 2) p = bin + i + 12;
+            }
+        }
+        else {
+            p = bin + size - 16 - 16 * (int)(N * 2 / 20000) + 2 * 16 + 8;
+        }
+        uint8_t save[4];
+        memcpy(save, p, 4);
+        memset(p, 0xFF, 4);
+        fp = fopen(file, "wb");
+        fwrite(bin, 1, size, fp);
+        fclose(fp);
+        sdr_iff_t *iff = sdr_iff_open(file, 0);
+        sdr_cpx8_t *data = (sdr_cpx8_t *)sdr_malloc(N);
+        if (!iff || !sdr_iff_get(iff, 2, 0, N, data)) {
+            printf("sdr_iff_get() corrupted file error k=%d\n", k);
+            exit(-1);
+        }
+        for (int i = 0; i < N; i++) {
+            sdr_cpx8_t ref = (k == 0 && i >= 10000 && i < 20000) ? 0 :
+                SDR_CPX8(raw[i*2], raw[i*2+1]);
+            if (data[i] != ref) {
+                printf("sdr_iff_get() corrupted file error k=%d i=%d\n", k,
+                    i);
+                exit(-1);
+            }
+        }
+        sdr_iff_close(iff);
+        sdr_free(data);
+        memcpy(p, save, 4);
+    }
+    sdr_free(bin);
+    remove(file);
+    
+    // plain IF data file (memory-mapped)
+    file = "test_07.bin";
+    fp = fopen(file, "wb");
+    fwrite(raw, 1, N * 2, fp);
+    fclose(fp);
+    sdr_iff_t *iff = sdr_iff_open(file, 0);
+    sdr_cpx8_t *data = (sdr_cpx8_t *)sdr_malloc(N);
+    if (!iff || !sdr_iff_get(iff, 2, off, N - off, data) ||
+        sdr_iff_get(iff, 2, off, N - off + 1, data)) {
+        printf("sdr_iff_get() error\n");
+        exit(-1);
+    }
+    for (int i = 0; i < N - off; i++) {
+        if (data[i] != SDR_CPX8(raw[(off+i)*2], raw[(off+i)*2+1])) {
+            printf("sdr_iff_get() error i=%d\n", i);
+            exit(-1);
+        }
+    }
+    sdr_iff_close(iff);
+    printf("test_07: size=%d/%d OK\n", size, N * 2);
+    sdr_free(data);
+    sdr_free(raw);
+    remove(file);
+}
+
+// test code FFT cache file ----------------------------------------------------
+static void test_08(void)
+{
+    const char *file = "test_08.bin", *sigs[] = {"L1CA", "L1CA", "E1B"};
+    int prns[] = {1, 2, 3}, len_code, N = 4000;
+    double fs = 4e6;
+    
+    if (sdr_gen_code_cache(file, sigs, prns, 3, fs) != 3 ||
+        sdr_code_cache_open(file) != 3) {
+        printf("sdr_gen_code_cache() error\n");
+        exit(-1);
+    }
+    int8_t *code = sdr_gen_code("L1CA", 2, &len_code);
+    sdr_cpx_t *code_fft = sdr_cpx_malloc(2 * N);
+    sdr_gen_code_fft(code, len_code, 1e-3, 0.0, fs, N, N, code_fft);
+    const sdr_cpx_t *cache = sdr_code_cache_get("L1CA", 2, fs, N, N);
+    
+    if (!cache || memcmp(cache, code_fft, sizeof(sdr_cpx_t) * 2 * N) ||
+        sdr_code_cache_get("L1CA", 3, fs, N, N) ||
+        sdr_code_cache_get("L1CA", 2, fs * 2, N, N)) {
+        printf("sdr_code_cache_get() error\n");
+        exit(-1);
+    }
+    printf("test_08: OK\n");
+    sdr_cpx_free(code_fft);
+    sdr_code_cache_close();
+    remove(file);
+}
+
+// test sdr_res_code() ---------------------------------------------------------
+static void test_09(void)
+{
+    static const char *sigs[] = {"L1CA", "L1CP", "E1B", "L5I"};
+    static const double fss[] = {12e6, 24.5e6, 3.001e6};
+    
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 3; j++) {
+            int len_code;
+            int8_t *code = sdr_gen_code(sigs[i], 1, &len_code);
+            double T = sdr_code_cyc(sigs[i]), fs = fss[j], dx = len_code / T / fs;
+            int N = (int)(fs * T);
+            sdr_cpx16_t *code_res = (sdr_cpx16_t *)sdr_malloc(sizeof(sdr_cpx16_t) * N);
+            
+            for (int k = 0; k < 15; k++) { // coff * fs: non-integer
+                double coff = k < 5 ? -k / fs / 10 : (k < 10 ? T * k / 13 :
+                    (k * 1001 + 0.377) / fs);
+                sdr_res_code(code, len_code, T, coff, fs, N, 0, code_res);
+                for (int m = 0; m < N; m++) {
+                    int8_t c = code[(int)((coff * fs + m) * dx) % len_code];
+                    if (code_res[m].I != c || code_res[m].Q != c) {
+                        printf("sdr_res_code() error %s fs=%.0f coff=%.9f m=%d\n",
+                            sigs[i], fs, coff, m);
+                        exit(-1);
+                    }
+                }
+            }
+            sdr_free(code_res);
+        }
+    }
+    printf("test_09: OK\n");
+}
+
+// test sdr_ddc_proc() ---------------------------------------------------------
+static void test_10(void)
+{
+    int N = 12000, D = 6, M = N / D, ncyc = 10;
+    double fs = 12e6, fc = 3.1e6, df = 123.4e3;
+    sdr_buff_t *buff = sdr_buff_new(N * ncyc, 2);
+    sdr_buff_t *out = sdr_buff_new(M * ncyc, 2);
+    sdr_buff_t *out_ref = sdr_buff_new(M * ncyc, 2);
+    const char *simd_sel = sdr_get_simd();
+    
+    for (int i = 0; i < N * ncyc; i++) {
+        double phi = 2.0 * PI * (fc + df) * i / fs;
+        buff->data[i] = SDR_CPX8((int8_t)floor(3.0 * cos(phi) + 0.5),
+            (int8_t)floor(3.0 * sin(phi) + 0.5));
+    }
+    for (int k = 0; k < 2; k++) {
+        sdr_set_simd(k == 0 ? "none" : simd_sel);
+        sdr_ddc_t *ddc = sdr_ddc_new(D, fs, fc);
+        for (int i = 0; i < ncyc; i++) {
+            sdr_ddc_proc(ddc, buff, N * i, N, k == 0 ? out_ref : out, M * i);
+        }
+        sdr_ddc_free(ddc);
+    }
+    if (memcmp(out->data, out_ref->data, M * ncyc)) {
+        printf("sdr_ddc_proc() error %s\n", simd_sel);
+        exit(-1);
+    }
+    double sumI = 0.0, sumQ = 0.0, dphi = 2.0 * PI * df * D / fs;
+    
+    for (int i = M; i < M * (ncyc - 1); i++) { // rotation of output
+        int8_t I1 = SDR_CPX8_I(out->data[i-1]), Q1 = SDR_CPX8_Q(out->data[i-1]);
+        int8_t I2 = SDR_CPX8_I(out->data[i  ]), Q2 = SDR_CPX8_Q(out->data[i  ]);
+        sumI += I2 * I1 + Q2 * Q1;
+        sumQ += Q2 * I1 - I2 * Q1;
+    }
+    if (fabs(atan2(sumQ, sumI) - dphi) > 0.01) {
+        printf("sdr_ddc_proc() error dphi=%.4f : %.4f\n", atan2(sumQ, sumI),
+            dphi);
+        exit(-1);
+    }
+    sdr_buff_free(buff);
+    sdr_buff_free(out);
+    sdr_buff_free(out_ref);
+    printf("test_10: OK\n");
+}
+
+// trace spans of thread -------------------------------------------------------
+static void *trace_thread(void *arg)
+{
+    sdr_trace_name((const char *)arg);
+    for (int i = 0; i < 10; i++) {
+        int64_t t0 = sdr_trace_begin();
+        sdr_sleep_msec(1);
+        sdr_trace_end("test", "span", i, t0);
+    }
+    return NULL;
+}
+
+// test sdr_trace_dump() -------------------------------------------------------
+static void test_11(void)
+{
+    const char *file = "test_trace.json";
+    pthread_t thread[2];
+    char buff[256];
+    int nspan = 0, nname = 0;
+    
+    sdr_trace_end("test", "span", 0, sdr_trace_begin()); // not tracing
+    sdr_trace_start(8);
+    pthread_create(thread + 0, NULL, trace_thread, (void *)"th1");
+    pthread_create(thread + 1, NULL, trace_thread, (void *)"th2");
+    pthread_join(thread[0], NULL);
+    pthread_join(thread[1], NULL);
+    sdr_trace_stop();
+    
+    if (!sdr_trace_dump(file)) {
+        printf("sdr_trace_dump() error\n");
+        exit(-1);
+    }
+    FILE *fp = fopen(file, "r");
+    while (fp && fgets(buff, sizeof(buff), fp)) {
+        if (strstr(buff, "\"name\":\"span\"")) nspan++;
+        if (strstr(buff, "\"args\":{\"name\":\"th")) nname++;
+    }
+    if (fp) fclose(fp);
+    remove(file);
+    if (nspan != 16 || nname != 2) { // latest 8 spans of 2 threads
+        printf("sdr_trace_dump() error nspan=%d nname=%d\n", nspan, nname);
+        exit(-1);
+    }
+    printf("test_11: OK\n");
+}
+
+// test sdr_net_write(), sdr_net_read() ----------------------------------------
+static void test_12(void)
+{
+#ifndef WIN32
+    uint8_t data[4000], out[4000];
+    char tag[SDR_MAX_TAG];
+    int64_t stat[4];
+    
+    sdr_net_t *tx = sdr_net_open("shm://pocket_sdr_test", 0, "FMT  = RAW8\n",
+        1000);
+    sdr_net_t *rx = sdr_net_open("shm://pocket_sdr_test", 1, NULL, 0);
+    if (!tx || !rx) {
+        printf("sdr_net_open() error\n");
+        exit(-1);
+    }
+    for (int i = 0; i < 4000; i++) data[i] = (uint8_t)(i * 7 + 1);
+    
+    sdr_net_write(tx, data, 2500); // 2 packets + 500 bytes kept
+    sdr_net_write(tx, data + 2500, 1500);
+    if (!sdr_net_tag(rx, tag, 100) || strcmp(tag, "FMT  = RAW8\n") ||
+        sdr_net_read(rx, out, 4000, 100) != 4000 || memcmp(data, out, 4000)) {
+        printf("sdr_net_read() error\n");
+        exit(-1);
+    }
+    tx->seq += 2; // 2 packets lost
+    sdr_net_write(tx, data, 1000);
+    if (sdr_net_read(rx, out, 3000, 100) != 3000 || out[0] || out[1999] ||
+        memcmp(data, out + 2000, 1000)) {
+        printf("sdr_net_read() lost packets error\n");
+        exit(-1);
+    }
+    sdr_net_stat(rx, stat);
+    if (stat[0] != 5 || stat[1] != 2 || stat[3] != 2000 ||
+        sdr_net_read(rx, out, 1, 10)) {
+        printf("sdr_net_stat() error %lld %lld %lld\n", (long long)stat[0],
+            (long long)stat[1], (long long)stat[3]);
+        exit(-1);
+    }
+    sdr_net_close(rx);
+    sdr_net_close(tx);
+#endif
+    printf("test_12: OK\n");
+}
+
+// read HEX string to bits ----------------------------------------------------
+static int read_hex(const char *str, uint8_t *bits)
+{
+    int n = 0;
+    
+    for (const char *p = str; *p; p++) {
+        int val = *p <= '9' ? *p - '0' : *p - 'A' + 10;
+        for (int i = 3; i >= 0; i--) {
+            bits[n++] = (uint8_t)((val >> i) & 1);
+        }
+    }
+    return n;
+}
+
+// test sdr_decode_LDPC() ------------------------------------------------------
+//  Frames with LDPC parity (test/sdr_ldpc_test.py, bits of binary LDPC
+//  inverted) with random error bits.
+static void test_13(void)
+{
+    static const struct {
+        const char *type, *hex;
+        int inv, nerr;
+    } frames[] = {
+        {"CNV2_SF2",
+         "B837CF639FB181CFF7BFF6AD1D729800DFF35B4257A6CC3BA3"
+         "510127BD93346DCC27E2FA8E80E74086F1FF32006A805DE07F"
+         "D6B4FFE804034AA2FC009CB600041FFFFB000200381BD4DC40"
+         "2C7DDDAA8037AD9BA778E9CFA211D9C223C21311A84C0286F6"
+         "1BE4603E6EA954EE60F98564FC54690FAF92E09F7D4BF3E4EF"
+         "4C5B5ECBF02FE678EEDFF38C7BB0C89B3B0726B874F9287092", 1, 24},
+        {"IRNV1_SF3",
+         "FD555555555555555555555555555555555555555555555555"
+         "5555555555554601CE1A297425A2EB11C5D1891FB31895EE56"
+         "E776EC3249CC5FC6D9369B16D21E07040554B", 1, 10},
+        {"BCNV2",
+         "5CA92F4075A0006DDCC02A522FFD64695BB0008809750F4B6C"
+         "0087B26E469E3B6FD2C19F13FAD5D6C360E72ED54C2607B594"
+         "A4CF0EDB258BBD81AFDF27A700E0BB872ACAA9B0A73B", 0, 10}
+    };
+    uint8_t bits[1200], syms[1200], dec[600];
+    
+    for (int k = 0; k < (int)(sizeof(frames) / sizeof(frames[0])); k++) {
+        int N = read_hex(frames[k].hex, bits), nerr = 0;
+        
+        for (int i = 0; i < N; i++) {
+            syms[i] = bits[i] ^= (uint8_t)frames[k].inv;
+        }
+        while (nerr < frames[k].nerr) {
+            int i = rand() % N;
+            if (syms[i] != bits[i]) continue;
+            syms[i] ^= 1;
+            nerr++;
+        }
+        int stat = sdr_decode_LDPC(frames[k].type, syms, N, dec);
+        if (stat != nerr || memcmp(dec, bits, N / 2)) {
+            printf("sdr_decode_LDPC() error type=%s nerr=%d stat=%d\n",
+                frames[k].type, nerr, stat);
+            exit(-1);
+        }
+    }
+    printf("test_13: OK\n");
+}
+
+// encode convolution code (K=7, R=1/2, Poly=G1:0x4F,G2:0x6D) -----------------
+static void encode_conv(const uint8_t *bits, int N, uint8_t *syms)
+{
+    uint32_t R = 0;
+    
+    for (int i = 0; i < N + 6; i++) {
+        R = (R << 1) | (i < N ? bits[i] : 0);
+        syms[i*2  ] = (uint8_t)(__builtin_popcount(R & 0x4F) & 1);
+        syms[i*2+1] = (uint8_t)(__builtin_popcount(R & 0x6D) & 1);
+    }
+}
+
+// test sdr_decode_conv() and streaming Viterbi decoder ------------------------
+static void test_14(void)
+{
+    int N = 1000, n = 200, tail = 32;
+    uint8_t *bits = (uint8_t *)sdr_malloc(N + 6);
+    uint8_t *syms = (uint8_t *)sdr_malloc((N + 6) * 2);
+    uint8_t *dec = (uint8_t *)sdr_malloc(N);
+    
+    for (int i = 0; i < N; i++) {
+        bits[i] = (uint8_t)(rand() % 2);
+    }
+    encode_conv(bits, N, syms);
+    for (int i = 0; i < (N + 6) * 2; i++) { // soft-decision symbols
+        syms[i] = syms[i] ? 255 : 0;
+    }
+    for (int i = 0; i + 30 < (N + 6) * 2; i += 30) { // symbol errors
+        syms[i+rand()%10] ^= 255;
+    }
+    sdr_decode_conv(syms, (N + 6) * 2, dec);
+    if (memcmp(dec, bits, N)) {
+        printf("sdr_decode_conv() error\n");
+        exit(-1);
+    }
+    // streaming decoder of unknown start state and sliding window
+    sdr_vit_t *vit = sdr_vit_new(N + 6);
+    sdr_vit_init(vit, -1);
+    for (int i = 0; i < N + 6; i++) {
+        sdr_vit_update(vit, syms[i*2], syms[i*2+1]);
+        if (i < n + tail + 100 || i % 100) continue;
+        if (!sdr_vit_decode(vit, n, tail, -1, dec) ||
+            memcmp(dec, bits + i + 1 - n - tail, n)) {
+            printf("sdr_vit_decode() error i=%d\n", i);
+            exit(-1);
+        }
+    }
+    if (!sdr_vit_decode(vit, N - 100, 6, 0, dec) ||
+        memcmp(dec, bits + 100, N - 100)) {
+        printf("sdr_vit_decode() tail error\n");
+        exit(-1);
+    }
+    sdr_vit_free(vit);
+    sdr_free(bits);
+    sdr_free(syms);
+    sdr_free(dec);
+    printf("test_14: OK\n");
+}
+
+// test sdr_encode_rs() and sdr_decode_rs() ------------------------------------
+static void test_15(void)
+{
+    uint8_t data[255], syms[255];
+    
+    for (int nerr = 0; nerr <= 17; nerr++) {
+        for (int i = 0; i < 223; i++) {
+            data[i] = (uint8_t)(rand() % 256);
+        }
+        sdr_encode_rs(data);
+        memcpy(syms, data, 255);
+        int nbit = 0;
+        for (int i = 0; i < nerr; i++) { // symbol errors at distinct positions
+            int j = (i * 15 + rand() % 15) % 255;
+            uint8_t err = (uint8_t)(rand() % 255 + 1);
+            syms[j] ^= err;
+            nbit += __builtin_popcount(err);
+        }
+        int stat = sdr_decode_rs(syms);
+        if (nerr <= 16 ? stat != nbit || memcmp(syms, data, 255) :
+            stat >= 0 && !memcmp(syms, data, 255)) {
+            printf("sdr_decode_rs() error nerr=%d stat=%d\n", nerr, stat);
+            exit(-1);
+        }
+    }
+    printf("test_15: OK\n");
+}
+
+// generate LNAV subframe with parity (prev D29*, D30* = 0) --------------------
+static void gen_LNAV_subframe(uint8_t *syms)
+{
+    static const uint32_t mask[] = {
+        0x2EC7CD2, 0x1763E69, 0x2BB1F34, 0x15D8F9A, 0x1AEC7CD, 0x22DEA27
+    };
+    uint32_t prev = 0;
+    
+    for (int i = 0; i < 10; i++) {
+        uint32_t d = (uint32_t)rand() & 0xFFFFFF;
+        if (i == 0) d = (0x8Bu << 16) | (d & 0xFFFF); // preamble
+        uint32_t buff = (prev << 30) | (d << 6);
+        for (int j = 0; j < 6; j++) {
+            buff |= (uint32_t)(__builtin_popcount((buff >> 6) & mask[j]) & 1) <<
+                (5 - j);
+        }
+        uint32_t word = (buff & 0x3FFFFFFF) ^ ((prev & 1) ? 0x3FFFFFC0 : 0);
+        for (int j = 0; j < 30; j++) {
+            syms[i*30+j] = (uint8_t)((word >> (29 - j)) & 1);
+        }
+        prev = word & 3;
+    }
+}
+
+// test LNAV frame sync with preamble across packed nav symbol words -----------
+static void test_16(void)
+{
+    int s = 64 * 6 - 4, N = s + 300 * 3; // preamble: symbols 380-387
+    uint8_t *syms = (uint8_t *)sdr_malloc(N);
+    
+    for (int inv = 0; inv < 2; inv++) {
+        sdr_ch_t *ch = sdr_ch_new("L1CA", 1, 12e6, 0.0);
+        memset(syms, 0, s);
+        for (int i = 0; i < 3; i++) {
+            gen_LNAV_subframe(syms + s + i * 300);
+        }
+        ch->nav->ssync = 1;
+        int nsym = 0;
+        for (int lock = 2; (lock - 2) / 20 < N && !nsym; lock++) {
+            sdr_cpx_t P = {0};
+            P[0] = (syms[(lock-2)/20] ^ inv) ? 0.5f : -0.5f;
+            sdr_hist_add(ch->trk->P, P);
+            ch->lock = lock;
+            ch->time = lock * 1e-3;
+            sdr_nav_decode(ch);
+            if (ch->nav->count[0] > 0) nsym = (int)ch->nav->nsym;
+        }
+        if (nsym != s + 308 || ch->nav->rev != inv) {
+            printf("LNAV frame sync error inv=%d nsym=%d rev=%d\n", inv, nsym,
+                ch->nav->rev);
+            exit(-1);
+        }
+        sdr_ch_free(ch);
+    }
+    sdr_free(syms);
+    printf("test_16: OK\n");
 }
 
 // test main --------------------------------------------------------------------
@@ -268,6 +1035,17 @@ int main(int argc, char **argv)
     test_03();
     test_04();
     test_05();
+    test_06();
+    test_07();
+    test_08();
+    test_09();
+    test_10();
+    test_11();
+    test_12();
+    test_13();
+    test_14();
+    test_15();
+    test_16();
     return 0;
 }
 